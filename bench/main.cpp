@@ -0,0 +1,41 @@
+// DesktopLUT - bench/main.cpp
+// Portable microbenchmarks (benchcore.h) as a standalone executable:
+//   desktoplut_bench [out.json] [--filter name]
+
+#include "benchcore.h"
+#include "alloctrack.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+    std::string outPath = "desktoplut-bench.json";
+    std::string filter;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            outPath = argv[i];
+        }
+    }
+
+    std::vector<BenchFixture> fixtures;
+    AddPortableBenchmarks(fixtures);
+    int allocating = 0;
+    std::vector<BenchResult> results = RunBenchmarkFixtures(fixtures, filter, allocating);
+
+    FILE* f = fopen(outPath.c_str(), "w");
+    if (!f) {
+        std::cerr << "Benchmark: cannot write " << outPath << std::endl;
+        return 1;
+    }
+    WriteBenchmarkJson(f, results);
+    fclose(f);
+    std::cout << "Wrote " << results.size() << " results to " << outPath << std::endl;
+    if (!DESKTOPLUT_ALLOC_TRACKING) {
+        std::cout << "Steady-state allocation check skipped (configure with -DDESKTOPLUT_ALLOC_TRACKING=ON)" << std::endl;
+    }
+    return allocating ? 1 : 0;
+}
@@ -0,0 +1,127 @@
+// DesktopLUT - alloctrack.cpp
+// Heap allocation counting for steady-state verification (developer instrumentation)
+
+#include "alloctrack.h"
+
+#if DESKTOPLUT_ALLOC_TRACKING
+
+#include <cstdlib>
+#include <new>
+#include <iostream>
+#include <iomanip>
+#ifdef _MSC_VER
+#include <malloc.h>     // _aligned_malloc
+#endif
+
+// Per-thread counters (trivial types - no dynamic TLS initialization, safe inside operator new)
+static thread_local uint64_t t_allocCount = 0;
+static thread_local uint64_t t_allocBytes = 0;
+
+// Every replaceable form is counted - an uncounted overload (nothrow, aligned) would under-report
+static void* CountedAlloc(size_t size) {
+    t_allocCount++;
+    t_allocBytes += size;
+    return malloc(size ? size : 1);
+}
+
+static void* CountedAlignedAlloc(size_t size, std::align_val_t align) {
+    t_allocCount++;
+    t_allocBytes += size;
+    size_t a = (size_t)align;
+#ifdef _MSC_VER
+    return _aligned_malloc(size ? size : 1, a);
+#else
+    return std::aligned_alloc(a, (size + a - 1) / a * a + (size ? 0 : a));   // Size must be a multiple
+#endif
+}
+
+static void AlignedFree(void* p) {
+#ifdef _MSC_VER
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+void* operator new(size_t size) {
+    if (void* p = CountedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    if (void* p = CountedAlloc(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAlloc(size); }
+
+void* operator new(size_t size, std::align_val_t align) {
+    if (void* p = CountedAlignedAlloc(size, align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size, std::align_val_t align) {
+    if (void* p = CountedAlignedAlloc(size, align)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return CountedAlignedAlloc(size, align);
+}
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept {
+    return CountedAlignedAlloc(size, align);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { AlignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { AlignedFree(p); }
+
+uint64_t AllocThreadCount() { return t_allocCount; }
+uint64_t AllocThreadBytes() { return t_allocBytes; }
+
+void AllocProbeBegin(AllocProbe& p) {
+    p.startCount = t_allocCount;
+    p.startBytes = t_allocBytes;
+}
+
+void AllocProbeEnd(AllocProbe& p) {
+    uint64_t n = t_allocCount - p.startCount;
+    p.allocs += n;
+    p.bytes += t_allocBytes - p.startBytes;
+    p.units++;
+    if (n > p.worstUnit) p.worstUnit = n;
+
+    auto now = std::chrono::steady_clock::now();
+    if (p.lastReport.time_since_epoch().count() == 0) {
+        p.lastReport = now;
+        return;
+    }
+    if (std::chrono::duration_cast<std::chrono::milliseconds>(now - p.lastReport).count() < ALLOC_REPORT_INTERVAL_MS) {
+        return;
+    }
+
+    // Logging allocates - happens after this unit was accounted and before the next Begin
+    std::cout << "Alloc tracking: " << p.label << " " << std::fixed << std::setprecision(2)
+              << (double)p.allocs / (double)p.units << " allocs/unit ("
+              << p.allocs << " allocs, " << p.bytes << " bytes over " << p.units
+              << " units, worst " << p.worstUnit << ")" << std::defaultfloat << std::endl;
+    p.units = 0;
+    p.allocs = 0;
+    p.bytes = 0;
+    p.worstUnit = 0;
+    p.lastReport = now;
+}
+
+#else
+
+uint64_t AllocThreadCount() { return 0; }
+uint64_t AllocThreadBytes() { return 0; }
+
+#endif
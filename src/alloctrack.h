@@ -0,0 +1,42 @@
+// DesktopLUT - alloctrack.h
+// Heap allocation counting for steady-state verification (developer instrumentation)
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Build with DESKTOPLUT_ALLOC_TRACKING=1 (Preprocessor Definitions) to replace global
+// operator new/delete (every form: array, nothrow, aligned) with per-thread counting versions.
+// Probes around the render pass and whitelist poll then log allocations per unit of work to the
+// console. Steady state (static desktop, no settings changes) should report 0; tests/test_alloctrack
+// and --benchmark enforce that for the per-frame paths.
+#ifndef DESKTOPLUT_ALLOC_TRACKING
+#define DESKTOPLUT_ALLOC_TRACKING 0
+#endif
+
+constexpr int ALLOC_REPORT_INTERVAL_MS = 5000;
+
+// Accumulates allocations over repeated units of work on one thread
+struct AllocProbe {
+    const char* label;                                    // Unit name for log output
+    uint64_t startCount = 0;                              // Thread count at AllocProbeBegin
+    uint64_t startBytes = 0;
+    uint64_t units = 0;                                   // Units since last report
+    uint64_t allocs = 0;                                  // Allocations since last report
+    uint64_t bytes = 0;
+    uint64_t worstUnit = 0;                               // Most allocations in a single unit
+    std::chrono::steady_clock::time_point lastReport{};
+};
+
+// Allocations made by the calling thread (always 0 when tracking is compiled out)
+uint64_t AllocThreadCount();
+uint64_t AllocThreadBytes();
+
+#if DESKTOPLUT_ALLOC_TRACKING
+void AllocProbeBegin(AllocProbe& p);
+void AllocProbeEnd(AllocProbe& p);  // Logs every ALLOC_REPORT_INTERVAL_MS
+#else
+inline void AllocProbeBegin(AllocProbe&) {}
+inline void AllocProbeEnd(AllocProbe&) {}
+#endif
@@ -5,18 +5,30 @@
 #include "globals.h"
 #include "shader.h"
 #include "render.h"
+#include "settings.h"
+#include "analysisring.h"
+#include "scopes.h"
+#include "gpu.h"
+#include "analysissched.h"
 #include <iostream>
-#include <iomanip>
-#include <sstream>
 #include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdarg>
+#include <algorithm>
+#include <cstring>
 
 // Window class name for analysis overlay
 static const wchar_t* g_analysisClassName = L"DesktopLUT_Analysis";
 
-// Timing constants
-static const int ANALYSIS_DISPATCH_INTERVAL = 30;  // Dispatch every 30 frames (~0.5 sec at 60Hz)
-static const int ANALYSIS_READBACK_DELAY = 2;      // Read back 2 frames after dispatch
+// Timing constants (the dispatch cadence is the scheduler's, see analysissched.h)
+static const int ANALYSIS_READBACK_DELAY = 2;      // Read back 2 frames after dispatch (readback ring latency)
+
+// Which monitors analyze on each render loop pass (render thread only)
+static AnalysisScheduler g_analysisScheduler;
+
+// Monitor the overlay is showing (set when it is shown, read on the render thread)
+static std::atomic<HMONITOR> g_analysisOverlayMonitor{ nullptr };
 
 // Custom message for async UI update (offloads formatting from render thread)
 static const UINT WM_UPDATE_ANALYSIS = WM_USER + 1;
@@ -24,6 +36,7 @@ static const UINT WM_UPDATE_ANALYSIS = WM_USER + 1;
 // Data passed to UI thread for formatting
 struct AnalysisDisplayData {
     AnalysisResult result;
+    int monitorIndex;          // Shown in the title when several monitors are processed (-1: one)
     bool isHDR;
     float targetPeak;
     float sessionMaxCLL;
@@ -40,6 +53,217 @@ struct AnalysisDisplayData {
 static AnalysisDisplayData g_pendingAnalysis = {};
 static std::atomic<bool> g_analysisDataReady{false};
 
+// Scope counts handed to the UI thread (render thread fills only after the UI consumed the last set)
+static uint32_t g_pendingScopeBins[SCOPE_BIN_COUNT] = {};
+static bool g_pendingScopesHDR = false;
+static std::atomic<bool> g_scopesDataReady{false};
+
+// Scope images (UI thread only): one BGRA pixel per bin, same layout as the bins
+static uint32_t g_scopePixels[SCOPE_BIN_COUNT] = {};
+static bool g_scopesValid = false;
+static bool g_scopesHDR = false;
+static int g_scopesTop = 0;    // Panel y offset below the text
+
+// Scope panel placement within the 260px overlay
+static const int SCOPE_PANEL_HEIGHT = 240;
+static const int SCOPE_WAVEFORM_RECT[4] = { 10, 4, 240, 100 };     // x, y (from panel top), w, h
+static const int SCOPE_VECTOR_RECT[4] = { 10, 112, 115, 115 };
+static const int SCOPE_CIE_RECT[4] = { 135, 112, 115, 115 };
+
+// Formatted overlay text (UI thread only - fixed capacity, no per-update allocation)
+static const size_t ANALYSIS_TEXT_CAPACITY = 2048;
+static wchar_t g_analysisText[ANALYSIS_TEXT_CAPACITY] = {};
+static size_t g_analysisTextLen = 0;
+
+// Fixed-capacity text builder (truncates instead of growing)
+struct TextBuffer {
+    wchar_t* data;
+    size_t capacity;
+    size_t len;
+};
+
+static void AppendText(TextBuffer& tb, const wchar_t* fmt, ...) {
+    if (tb.len + 1 >= tb.capacity) return;
+    va_list args;
+    va_start(args, fmt);
+    int written = _vsnwprintf_s(tb.data + tb.len, tb.capacity - tb.len, _TRUNCATE, fmt, args);
+    va_end(args);
+    tb.len = (written >= 0) ? tb.len + written : tb.capacity - 1;
+}
+
+static void AppendFrameTiming(TextBuffer& tb, const FrameTimingStats& timing) {
+    AppendText(tb, L"\n");
+    AppendText(tb, L" FRAME TIMING\n");
+    AppendText(tb, L"   FPS:   %6.1f\n", timing.fps);
+    AppendText(tb, L"   Cur:   %6.2f ms\n", timing.currentMs);
+    AppendText(tb, L"   Avg:   %6.2f ms\n", timing.avgMs);
+    AppendText(tb, L"   Min:   %6.2f ms\n", timing.minMs);
+    AppendText(tb, L"   Max:   %6.2f ms\n", timing.maxMs);
+    AppendText(tb, L"   Jit:   %6.2f ms\n", timing.varianceMs);
+    AppendText(tb, L"   Sync:  %ls\n", timing.compositorClockAvailable ? L"CompClock" : L"DwmFlush");
+    AppendText(tb, L"   Wake:  %6.1f /s %ls\n", timing.wakeupsPerSecond, IdleStateName((IdleState)timing.idleState));
+    if (!timing.presentStatsAvailable) {
+        AppendText(tb, L"   Pres:  n/a\n");
+        return;
+    }
+    AppendText(tb, L"   Shown: %6llu\n", (unsigned long long)timing.presentsDisplayed);
+    AppendText(tb, L"   Late:  %6llu (%llu missed)\n", (unsigned long long)timing.presentsLate,
+               (unsigned long long)timing.refreshesMissed);
+    AppendText(tb, L"   Dup:   %6llu\n", (unsigned long long)timing.presentsDuplicate);
+    AppendText(tb, L"   Lat:   %5.1f / %5.1f ms\n", timing.presentLatencyAvgMs, timing.presentLatencyMaxMs);
+    AppendText(tb, L"   Dist:  %2.0f/%2.0f/%2.0f/%2.0f%%\n", timing.presentLatencyPct[0],
+               timing.presentLatencyPct[1], timing.presentLatencyPct[2], timing.presentLatencyPct[3]);
+}
+
+// Substring search within a line that isn't NUL-terminated at its end
+static int LineFind(const wchar_t* line, int len, const wchar_t* token) {
+    int tokenLen = (int)wcslen(token);
+    for (int i = 0; i + tokenLen <= len; i++) {
+        if (wcsncmp(line + i, token, tokenLen) == 0) return i;
+    }
+    return -1;
+}
+
+static bool LineContains(const wchar_t* line, int len, const wchar_t* token) {
+    return LineFind(line, len, token) >= 0;
+}
+
+// ============================================================================
+// Scopes (UI thread)
+// ============================================================================
+
+static uint32_t ScopePixel(uint8_t i, float r, float g, float b) {
+    return ((uint32_t)(i * r) << 16) | ((uint32_t)(i * g) << 8) | (uint32_t)(i * b);
+}
+
+// Approximate display color of a CIE xy bin (for tinting the chromaticity plot)
+static void ChromaticityColor(int cx, int cy, float& r, float& g, float& b) {
+    float x = (cx + 0.5f) / SCOPE_CIE_SIZE * SCOPE_CIE_MAX_X;
+    float y = (SCOPE_CIE_SIZE - 1 - cy + 0.5f) / SCOPE_CIE_SIZE * SCOPE_CIE_MAX_Y;
+    float X = x / y, Z = (1.0f - x - y) / y;
+    r = (std::max)(0.0f, 3.2406f * X - 1.5372f - 0.4986f * Z);
+    g = (std::max)(0.0f, -0.9689f * X + 1.8758f + 0.0415f * Z);
+    b = (std::max)(0.0f, 0.0557f * X - 0.2040f + 1.0570f * Z);
+    float m = (std::max)(r, (std::max)(g, b));
+    if (m <= 0.0f) { r = g = b = 1.0f; return; }
+    r = sqrtf(r / m); g = sqrtf(g / m); b = sqrtf(b / m);  // Rough gamma so mixes aren't dark
+}
+
+// Normalize pending counts into BGRA images
+static void BuildScopeImages(const uint32_t* bins) {
+    uint8_t intensity[SCOPE_BIN_COUNT];
+    NormalizeScopeBins(bins + SCOPE_WAVEFORM_OFFSET, SCOPE_WAVEFORM_WIDTH * SCOPE_WAVEFORM_HEIGHT,
+                       intensity + SCOPE_WAVEFORM_OFFSET);
+    NormalizeScopeBins(bins + SCOPE_VECTOR_OFFSET, SCOPE_VECTOR_SIZE * SCOPE_VECTOR_SIZE,
+                       intensity + SCOPE_VECTOR_OFFSET);
+    NormalizeScopeBins(bins + SCOPE_CIE_OFFSET, SCOPE_CIE_SIZE * SCOPE_CIE_SIZE,
+                       intensity + SCOPE_CIE_OFFSET);
+
+    for (int i = SCOPE_WAVEFORM_OFFSET; i < SCOPE_VECTOR_OFFSET; i++) {
+        g_scopePixels[i] = ScopePixel(intensity[i], 0.55f, 1.0f, 0.55f);
+    }
+    for (int i = SCOPE_VECTOR_OFFSET; i < SCOPE_CIE_OFFSET; i++) {
+        g_scopePixels[i] = ScopePixel(intensity[i], 1.0f, 1.0f, 1.0f);
+    }
+    for (int cy = 0; cy < SCOPE_CIE_SIZE; cy++) {
+        for (int cx = 0; cx < SCOPE_CIE_SIZE; cx++) {
+            int i = SCOPE_CIE_OFFSET + cy * SCOPE_CIE_SIZE + cx;
+            float r, g, b;
+            ChromaticityColor(cx, cy, r, g, b);
+            g_scopePixels[i] = ScopePixel(intensity[i], r, g, b);
+        }
+    }
+}
+
+static void DrawScopeImage(HDC dc, int top, const int* rect, const uint32_t* pixels, int width, int height) {
+    BITMAPINFO bmi = {};
+    bmi.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+    bmi.bmiHeader.biWidth = width;
+    bmi.bmiHeader.biHeight = -height;  // Top-down
+    bmi.bmiHeader.biPlanes = 1;
+    bmi.bmiHeader.biBitCount = 32;
+    bmi.bmiHeader.biCompression = BI_RGB;
+    SetStretchBltMode(dc, COLORONCOLOR);
+    StretchDIBits(dc, rect[0], top + rect[1], rect[2], rect[3], 0, 0, width, height,
+                  pixels, &bmi, DIB_RGB_COLORS, SRCCOPY);
+}
+
+// Map a CIE xy coordinate into the CIE plot rectangle
+static POINT CiePoint(int top, float x, float y) {
+    POINT p;
+    p.x = SCOPE_CIE_RECT[0] + (LONG)(x / SCOPE_CIE_MAX_X * SCOPE_CIE_RECT[2]);
+    p.y = top + SCOPE_CIE_RECT[1] + SCOPE_CIE_RECT[3] - (LONG)(y / SCOPE_CIE_MAX_Y * SCOPE_CIE_RECT[3]);
+    return p;
+}
+
+static void DrawGamutTriangle(HDC dc, int top, const float* xy, COLORREF color) {
+    HPEN pen = CreatePen(PS_SOLID, 1, color);
+    HPEN oldPen = (HPEN)SelectObject(dc, pen);
+    POINT pts[4] = { CiePoint(top, xy[0], xy[1]), CiePoint(top, xy[2], xy[3]),
+                     CiePoint(top, xy[4], xy[5]), CiePoint(top, xy[0], xy[1]) };
+    Polyline(dc, pts, 4);
+    SelectObject(dc, oldPen);
+    DeleteObject(pen);
+}
+
+static void DrawScopes(HDC dc, int top) {
+    DrawScopeImage(dc, top, SCOPE_WAVEFORM_RECT, g_scopePixels + SCOPE_WAVEFORM_OFFSET,
+                   SCOPE_WAVEFORM_WIDTH, SCOPE_WAVEFORM_HEIGHT);
+    DrawScopeImage(dc, top, SCOPE_VECTOR_RECT, g_scopePixels + SCOPE_VECTOR_OFFSET,
+                   SCOPE_VECTOR_SIZE, SCOPE_VECTOR_SIZE);
+    DrawScopeImage(dc, top, SCOPE_CIE_RECT, g_scopePixels + SCOPE_CIE_OFFSET,
+                   SCOPE_CIE_SIZE, SCOPE_CIE_SIZE);
+
+    // Graticules
+    HPEN gridPen = CreatePen(PS_DOT, 1, RGB(90, 90, 90));
+    HPEN oldPen = (HPEN)SelectObject(dc, gridPen);
+    HBRUSH oldBrush = (HBRUSH)SelectObject(dc, GetStockObject(NULL_BRUSH));
+
+    // Waveform: SDR 0/50/100%, HDR (PQ) 100/203/1000 nits
+    const int* w = SCOPE_WAVEFORM_RECT;
+    const float sdrLevels[] = { 0.0f, 0.5f, 1.0f };
+    const float hdrLevels[] = { 0.5081f, 0.5806f, 0.7518f };
+    const float* levels = g_scopesHDR ? hdrLevels : sdrLevels;
+    for (int i = 0; i < 3; i++) {
+        int y = top + w[1] + w[3] - 1 - (int)(levels[i] * (w[3] - 1));
+        MoveToEx(dc, w[0], y, nullptr);
+        LineTo(dc, w[0] + w[2], y);
+    }
+
+    // Vectorscope: axes and 75% saturation ring
+    const int* v = SCOPE_VECTOR_RECT;
+    int cx = v[0] + v[2] / 2, cy = top + v[1] + v[3] / 2;
+    MoveToEx(dc, v[0], cy, nullptr);
+    LineTo(dc, v[0] + v[2], cy);
+    MoveToEx(dc, cx, top + v[1], nullptr);
+    LineTo(dc, cx, top + v[1] + v[3]);
+    int ring = (int)(v[2] * 0.75f * 0.5f);
+    Ellipse(dc, cx - ring, cy - ring, cx + ring, cy + ring);
+    SelectObject(dc, oldPen);
+    SelectObject(dc, oldBrush);
+    DeleteObject(gridPen);
+
+    // CIE: Rec.709, P3-D65 and Rec.2020 triangles
+    static const float rec709[6] = { 0.640f, 0.330f, 0.300f, 0.600f, 0.150f, 0.060f };
+    static const float p3[6] = { 0.680f, 0.320f, 0.265f, 0.690f, 0.150f, 0.060f };
+    static const float rec2020[6] = { 0.708f, 0.292f, 0.170f, 0.797f, 0.131f, 0.046f };
+    DrawGamutTriangle(dc, top, rec2020, RGB(110, 110, 110));
+    DrawGamutTriangle(dc, top, p3, RGB(200, 160, 60));
+    DrawGamutTriangle(dc, top, rec709, RGB(220, 220, 220));
+
+    // Frames
+    HPEN framePen = CreatePen(PS_SOLID, 1, RGB(80, 80, 80));
+    oldPen = (HPEN)SelectObject(dc, framePen);
+    oldBrush = (HBRUSH)SelectObject(dc, GetStockObject(NULL_BRUSH));
+    const int* rects[3] = { SCOPE_WAVEFORM_RECT, SCOPE_VECTOR_RECT, SCOPE_CIE_RECT };
+    for (const int* r : rects) {
+        Rectangle(dc, r[0] - 1, top + r[1] - 1, r[0] + r[2] + 1, top + r[1] + r[3] + 1);
+    }
+    SelectObject(dc, oldPen);
+    SelectObject(dc, oldBrush);
+    DeleteObject(framePen);
+}
+
 // Analysis overlay window procedure
 static LRESULT CALLBACK AnalysisWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     switch (msg) {
@@ -70,9 +294,8 @@ static LRESULT CALLBACK AnalysisWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPAR
         SelectObject(memDC, oldBrush);
         DeleteObject(borderPen);
 
-        // Get stored text from window property
-        wchar_t* text = (wchar_t*)GetProp(hwnd, L"AnalysisText");
-        if (text) {
+        // Draw formatted text (fixed buffer owned by this window's thread)
+        if (g_analysisTextLen > 0) {
             // Draw text
             SetBkMode(memDC, TRANSPARENT);
             HFONT font = CreateFont(16, 0, 0, 0, FW_NORMAL, FALSE, FALSE, FALSE,
@@ -86,59 +309,64 @@ static LRESULT CALLBACK AnalysisWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPAR
             textRc.top += 8;
             textRc.right -= 10;
 
-            // Split text by newlines and draw with appropriate colors
-            std::wstring str(text);
-            std::wistringstream stream(str);
-            std::wstring line;
+            // Walk text by newlines in place and draw with appropriate colors
+            const wchar_t* line = g_analysisText;
+            const wchar_t* textEnd = g_analysisText + g_analysisTextLen;
             int lineHeight = 18;
 
-            while (std::getline(stream, line)) {
+            while (line < textEnd) {
+                const wchar_t* eol = wcschr(line, L'\n');
+                int len = eol ? (int)(eol - line) : (int)(textEnd - line);
+
                 // Section headers in gray
-                if (line.find(L"ANALYSIS") != std::wstring::npos ||
-                    line.find(L"GAMUT") != std::wstring::npos ||
-                    line.find(L"HISTOGRAM") != std::wstring::npos ||
-                    line.find(L"CLIPPING") != std::wstring::npos ||
-                    line.find(L"SESSION") != std::wstring::npos ||
-                    line.find(L"FRAME TIMING") != std::wstring::npos ||
-                    line.find(L"---") != std::wstring::npos) {
+                if (LineContains(line, len, L"ANALYSIS") ||
+                    LineContains(line, len, L"GAMUT") ||
+                    LineContains(line, len, L"HISTOGRAM") ||
+                    LineContains(line, len, L"CLIPPING") ||
+                    LineContains(line, len, L"SESSION") ||
+                    LineContains(line, len, L"FRAME TIMING") ||
+                    LineContains(line, len, L"---")) {
                     SetTextColor(memDC, RGB(180, 180, 180));
-                    DrawText(memDC, line.c_str(), -1, &textRc, DT_LEFT | DT_SINGLELINE);
-                } else if (line.find(L"TM: ~") != std::wstring::npos ||
-                           line.find(L"TM: <") != std::wstring::npos) {
+                    DrawText(memDC, line, len, &textRc, DT_LEFT | DT_SINGLELINE);
+                } else if (LineContains(line, len, L"TM: ~") ||
+                           LineContains(line, len, L"TM: <")) {
                     // Line with TM indicator - draw Peak part white, TM part colored
-                    size_t tmPos = line.find(L"TM:");
-                    if (tmPos != std::wstring::npos) {
+                    int tmPos = LineFind(line, len, L"TM:");
+                    if (tmPos >= 0) {
                         // Draw first part (Peak) in white
-                        std::wstring peakPart = line.substr(0, tmPos);
                         SetTextColor(memDC, RGB(255, 255, 255));
-                        DrawText(memDC, peakPart.c_str(), -1, &textRc, DT_LEFT | DT_SINGLELINE);
+                        DrawText(memDC, line, tmPos, &textRc, DT_LEFT | DT_SINGLELINE);
 
                         // Calculate width of first part to offset TM part
                         SIZE textSize;
-                        GetTextExtentPoint32(memDC, peakPart.c_str(), (int)peakPart.length(), &textSize);
+                        GetTextExtentPoint32(memDC, line, tmPos, &textSize);
 
                         // Draw TM part in appropriate color
-                        std::wstring tmPart = line.substr(tmPos);
                         RECT tmRc = textRc;
                         tmRc.left += textSize.cx;
-                        if (line.find(L"TM: ~") != std::wstring::npos) {
+                        if (LineContains(line, len, L"TM: ~")) {
                             SetTextColor(memDC, RGB(255, 200, 100));  // Yellow - compressing
                         } else {
                             SetTextColor(memDC, RGB(100, 255, 100));  // Green - below threshold
                         }
-                        DrawText(memDC, tmPart.c_str(), -1, &tmRc, DT_LEFT | DT_SINGLELINE);
+                        DrawText(memDC, line + tmPos, len - tmPos, &tmRc, DT_LEFT | DT_SINGLELINE);
                     }
                 } else {
                     SetTextColor(memDC, RGB(255, 255, 255));
-                    DrawText(memDC, line.c_str(), -1, &textRc, DT_LEFT | DT_SINGLELINE);
+                    DrawText(memDC, line, len, &textRc, DT_LEFT | DT_SINGLELINE);
                 }
                 textRc.top += lineHeight;
+                line += len + 1;
             }
 
             SelectObject(memDC, oldFont);
             DeleteObject(font);
         }
 
+        if (g_scopesValid && g_analysisScopes.load()) {
+            DrawScopes(memDC, g_scopesTop);
+        }
+
         // Blit to screen in one operation
         BitBlt(hdc, 0, 0, rc.right, rc.bottom, memDC, 0, 0, SRCCOPY);
 
@@ -157,154 +385,120 @@ static LRESULT CALLBACK AnalysisWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPAR
         AnalysisDisplayData data = g_pendingAnalysis;  // Copy
         g_analysisDataReady.store(false);
 
-        std::wstringstream ss;
+        TextBuffer tb = { g_analysisText, ANALYSIS_TEXT_CAPACITY, 0 };
+        g_analysisText[0] = 0;
 
         if (data.isHDR) {
-            ss << L" ANALYSIS (HDR)\n";
-            ss << L"--------------------\n";
-            ss << std::fixed << std::setprecision(1);
+            AppendText(tb, data.monitorIndex >= 0 ? L" ANALYSIS (HDR) #%d\n" : L" ANALYSIS (HDR)\n", data.monitorIndex + 1);
+            AppendText(tb, L"--------------------\n");
             float totalF = (float)data.result.totalPixels;
             // Format TM indicator based on tonemap state
             // Colors: Off=white, <threshold=green, ~compressing=yellow
-            std::wstring tmStr;
             if (!data.tonemapEnabled) {
-                tmStr = L"Off";
+                AppendText(tb, L" Peak: %7.1f  TM: Off\n", data.result.peakNits);
             } else if (!data.tonemapDynamic) {
                 // Static mode: show source peak, color based on content vs source
-                std::wstringstream tmss;
-                tmss << std::fixed << std::setprecision(0);
+                // Content exceeds configured source - clipping (~ prefix, yellow)
+                // Content within range (< prefix, green)
                 if (data.result.peakNits > data.tonemapSourcePeak) {
-                    // Content exceeds configured source - clipping (~ prefix, yellow)
-                    tmss << L"~" << data.tonemapSourcePeak;
+                    AppendText(tb, L" Peak: %7.1f  TM: ~%.0f\n", data.result.peakNits, data.tonemapSourcePeak);
                 } else {
-                    // Content within range (< prefix, green)
-                    tmss << L"<" << data.tonemapSourcePeak;
+                    AppendText(tb, L" Peak: %7.1f  TM: <%.0f\n", data.result.peakNits, data.tonemapSourcePeak);
                 }
-                tmStr = tmss.str();
             } else {
                 // Dynamic mode: show detected peak or target threshold
-                std::wstringstream tmss;
-                tmss << std::fixed << std::setprecision(0);
+                // Above threshold - compressing (~ prefix, yellow)
+                // Below threshold - passing through (< prefix, green)
                 if (data.detectedPeak > data.tonemapTargetPeak) {
-                    // Above threshold - compressing (~ prefix, yellow)
-                    tmss << L"~" << data.detectedPeak;
+                    AppendText(tb, L" Peak: %7.1f  TM: ~%.0f\n", data.result.peakNits, data.detectedPeak);
                 } else {
-                    // Below threshold - passing through (< prefix, green)
-                    tmss << L"<" << data.tonemapTargetPeak;
+                    AppendText(tb, L" Peak: %7.1f  TM: <%.0f\n", data.result.peakNits, data.tonemapTargetPeak);
                 }
-                tmStr = tmss.str();
             }
-            ss << L" Peak: " << std::setw(7) << data.result.peakNits << L"  TM: " << tmStr << L"\n";
             // Show Min>0 (if all pixels were black, show 0)
             float minNonZero = (data.result.minNonZeroNits < 99999.0f) ? data.result.minNonZeroNits : 0.0f;
-            ss << L" Avg:  " << std::setw(7) << data.result.avgNits << L"  Min>0:" << std::setprecision(3) << std::setw(6) << minNonZero << L"\n";
-            ss << std::setprecision(1);
+            AppendText(tb, L" Avg:  %7.1f  Min>0:%6.3f\n", data.result.avgNits, minNonZero);
             // APL relative to target peak
             float apl = (data.result.avgNits / data.targetPeak) * 100.0f;
-            ss << L" APL:  " << std::setw(6) << apl << L"%  Min:  " << std::setprecision(3) << std::setw(6) << data.result.minNits << L"\n";
-            ss << std::setprecision(1);
-            ss << L"\n";
-            ss << L" GAMUT\n";
+            AppendText(tb, L" APL:  %6.1f%%  Min:  %6.3f\n", apl, data.result.minNits);
+            AppendText(tb, L"\n");
+            AppendText(tb, L" GAMUT\n");
             if (totalF > 0) {
-                ss << L"   Rec.709:  " << std::setw(5) << (data.result.pixelsRec709 / totalF * 100.0f) << L"%\n";
-                ss << L"   P3-D65:   " << std::setw(5) << (data.result.pixelsP3Only / totalF * 100.0f) << L"%\n";
-                ss << L"   Rec.2020: " << std::setw(5) << (data.result.pixelsRec2020Only / totalF * 100.0f) << L"%\n";
-                ss << L"   Out:      " << std::setw(5) << (data.result.pixelsOutOfGamut / totalF * 100.0f) << L"%\n";
+                AppendText(tb, L"   Rec.709:  %5.1f%%\n", data.result.pixelsRec709 / totalF * 100.0f);
+                AppendText(tb, L"   P3-D65:   %5.1f%%\n", data.result.pixelsP3Only / totalF * 100.0f);
+                AppendText(tb, L"   Rec.2020: %5.1f%%\n", data.result.pixelsRec2020Only / totalF * 100.0f);
+                AppendText(tb, L"   Out:      %5.1f%%\n", data.result.pixelsOutOfGamut / totalF * 100.0f);
             }
-            ss << L"\n";
-            ss << L" HISTOGRAM\n";
+            AppendText(tb, L"\n");
+            AppendText(tb, L" HISTOGRAM\n");
             if (totalF > 0) {
-                ss << L"   0-203:    " << std::setw(5) << (data.result.histogram[0] / totalF * 100.0f) << L"%\n";
-                ss << L"   203-1k:   " << std::setw(5) << (data.result.histogram[1] / totalF * 100.0f) << L"%\n";
-                ss << L"   1k-2k:    " << std::setw(5) << (data.result.histogram[2] / totalF * 100.0f) << L"%\n";
-                ss << L"   2k-4k:    " << std::setw(5) << (data.result.histogram[3] / totalF * 100.0f) << L"%\n";
-                ss << L"   4000+:    " << std::setw(5) << (data.result.histogram[4] / totalF * 100.0f) << L"%\n";
+                AppendText(tb, L"   0-203:    %5.1f%%\n", data.result.histogram[0] / totalF * 100.0f);
+                AppendText(tb, L"   203-1k:   %5.1f%%\n", data.result.histogram[1] / totalF * 100.0f);
+                AppendText(tb, L"   1k-2k:    %5.1f%%\n", data.result.histogram[2] / totalF * 100.0f);
+                AppendText(tb, L"   2k-4k:    %5.1f%%\n", data.result.histogram[3] / totalF * 100.0f);
+                AppendText(tb, L"   4000+:    %5.1f%%\n", data.result.histogram[4] / totalF * 100.0f);
             }
-            ss << L"\n";
-            ss << L" SESSION\n";
-            ss << L"   MaxCLL:  " << std::setw(6) << (int)data.sessionMaxCLL << L" nits\n";
-            ss << L"   MaxFALL: " << std::setw(6) << (int)data.sessionMaxFALL << L" nits\n";
+            AppendText(tb, L"\n");
+            AppendText(tb, L" SESSION\n");
+            AppendText(tb, L"   MaxCLL:  %6d nits\n", (int)data.sessionMaxCLL);
+            AppendText(tb, L"   MaxFALL: %6d nits\n", (int)data.sessionMaxFALL);
             if (g_showFrameTiming.load()) {
-                ss << L"\n";
-                ss << L" FRAME TIMING\n";
-                ss << std::setprecision(1);
-                ss << L"   FPS:   " << std::setw(6) << data.frameTiming.fps << L"\n";
-                ss << std::setprecision(2);
-                ss << L"   Cur:   " << std::setw(6) << data.frameTiming.currentMs << L" ms\n";
-                ss << L"   Avg:   " << std::setw(6) << data.frameTiming.avgMs << L" ms\n";
-                ss << L"   Min:   " << std::setw(6) << data.frameTiming.minMs << L" ms\n";
-                ss << L"   Max:   " << std::setw(6) << data.frameTiming.maxMs << L" ms\n";
-                ss << L"   Jit:   " << std::setw(6) << data.frameTiming.varianceMs << L" ms\n";
-                ss << L"   Sync:  " << (data.frameTiming.compositorClockAvailable ? L"CompClock" : L"DwmFlush") << L"\n";
+                AppendFrameTiming(tb, data.frameTiming);
             }
         } else {
-            ss << L" ANALYSIS (SDR)\n";
-            ss << L"--------------------\n";
-            ss << std::fixed << std::setprecision(0);
+            AppendText(tb, data.monitorIndex >= 0 ? L" ANALYSIS (SDR) #%d\n" : L" ANALYSIS (SDR)\n", data.monitorIndex + 1);
+            AppendText(tb, L"--------------------\n");
             // Convert to 8-bit values for SDR display
             int peak8 = (int)(data.result.peakNits / 80.0f * 255.0f);
             int min8 = (int)(data.result.minNits / 80.0f * 255.0f);
             int avg8 = (int)(data.result.avgNits / 80.0f * 255.0f);
-            ss << L" Peak: " << std::setw(3) << peak8 << L" (" << std::setprecision(2) << (data.result.peakNits / 80.0f) << L")\n";
-            ss << std::setprecision(0);
-            ss << L" Min:  " << std::setw(3) << min8 << L" (" << std::setprecision(2) << (data.result.minNits / 80.0f) << L")\n";
-            ss << std::setprecision(0);
-            ss << L" Avg:  " << std::setw(3) << avg8 << L" (" << std::setprecision(2) << (data.result.avgNits / 80.0f) << L")\n";
-            ss << L"\n";
-            ss << L" CLIPPING\n";
+            AppendText(tb, L" Peak: %3d (%.2f)\n", peak8, data.result.peakNits / 80.0f);
+            AppendText(tb, L" Min:  %3d (%.2f)\n", min8, data.result.minNits / 80.0f);
+            AppendText(tb, L" Avg:  %3d (%.2f)\n", avg8, data.result.avgNits / 80.0f);
+            AppendText(tb, L"\n");
+            AppendText(tb, L" CLIPPING\n");
             float totalF = (float)data.result.totalPixels;
             if (totalF > 0) {
-                ss << std::setprecision(1);
-                ss << L"   Black (<1):   " << std::setw(5) << (data.result.pixelsClipBlack / totalF * 100.0f) << L"%\n";
-                ss << L"   White (>254): " << std::setw(5) << (data.result.pixelsClipWhite / totalF * 100.0f) << L"%\n";
+                AppendText(tb, L"   Black (<1):   %5.1f%%\n", data.result.pixelsClipBlack / totalF * 100.0f);
+                AppendText(tb, L"   White (>254): %5.1f%%\n", data.result.pixelsClipWhite / totalF * 100.0f);
             }
-            ss << L"\n";
-            ss << L" GAMUT\n";
+            AppendText(tb, L"\n");
+            AppendText(tb, L" GAMUT\n");
             if (totalF > 0) {
-                ss << L"   sRGB:  " << std::setw(5) << (data.result.pixelsRec709 / totalF * 100.0f) << L"%\n";
-                ss << L"   Wide:  " << std::setw(5) << ((data.result.pixelsP3Only + data.result.pixelsRec2020Only + data.result.pixelsOutOfGamut) / totalF * 100.0f) << L"%\n";
+                AppendText(tb, L"   sRGB:  %5.1f%%\n", data.result.pixelsRec709 / totalF * 100.0f);
+                AppendText(tb, L"   Wide:  %5.1f%%\n",
+                    (data.result.pixelsP3Only + data.result.pixelsRec2020Only + data.result.pixelsOutOfGamut) / totalF * 100.0f);
             }
             if (g_showFrameTiming.load()) {
-                ss << L"\n";
-                ss << L" FRAME TIMING\n";
-                ss << std::setprecision(1);
-                ss << L"   FPS:   " << std::setw(6) << data.frameTiming.fps << L"\n";
-                ss << std::setprecision(2);
-                ss << L"   Cur:   " << std::setw(6) << data.frameTiming.currentMs << L" ms\n";
-                ss << L"   Avg:   " << std::setw(6) << data.frameTiming.avgMs << L" ms\n";
-                ss << L"   Min:   " << std::setw(6) << data.frameTiming.minMs << L" ms\n";
-                ss << L"   Max:   " << std::setw(6) << data.frameTiming.maxMs << L" ms\n";
-                ss << L"   Jit:   " << std::setw(6) << data.frameTiming.varianceMs << L" ms\n";
-                ss << L"   Sync:  " << (data.frameTiming.compositorClockAvailable ? L"CompClock" : L"DwmFlush") << L"\n";
+                AppendFrameTiming(tb, data.frameTiming);
             }
         }
+        g_analysisTextLen = tb.len;
 
         // Update window
-        std::wstring text = ss.str();
-        wchar_t* textCopy = (wchar_t*)malloc((text.length() + 1) * sizeof(wchar_t));
-        if (textCopy) {
-            wcscpy_s(textCopy, text.length() + 1, text.c_str());
-
-            wchar_t* oldText = (wchar_t*)GetProp(hwnd, L"AnalysisText");
-            if (oldText) free(oldText);
-            SetProp(hwnd, L"AnalysisText", textCopy);
-
-            // Window heights depend on frame timing visibility
-            // HDR: 430 base, +160 with frame timing = 590
-            // SDR: 260 base, +160 with frame timing = 420
-            bool showTiming = g_showFrameTiming.load();
-            int height = data.isHDR ? (showTiming ? 590 : 430) : (showTiming ? 420 : 260);
-            SetWindowPos(hwnd, nullptr, 0, 0, 260, height, SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
-            InvalidateRect(hwnd, nullptr, FALSE);  // FALSE = don't erase, prevents flicker
+        // Window heights depend on frame timing visibility
+        // HDR: 430 base, +280 with frame timing and present stats = 710
+        // SDR: 260 base, +280 with frame timing and present stats = 540
+        bool showTiming = g_showFrameTiming.load();
+        int height = data.isHDR ? (showTiming ? 710 : 430) : (showTiming ? 540 : 260);
+
+        // Scopes panel below the text (normalized here, off the render thread)
+        if (g_scopesDataReady.load(std::memory_order_acquire)) {
+            BuildScopeImages(g_pendingScopeBins);
+            g_scopesHDR = g_pendingScopesHDR;
+            g_scopesValid = true;
+            g_scopesDataReady.store(false, std::memory_order_release);
+        }
+        if (g_scopesValid && g_analysisScopes.load()) {
+            g_scopesTop = height - 8;
+            height += SCOPE_PANEL_HEIGHT;
         }
+        SetWindowPos(hwnd, nullptr, 0, 0, 260, height, SWP_NOMOVE | SWP_NOZORDER | SWP_NOACTIVATE);
+        InvalidateRect(hwnd, nullptr, FALSE);  // FALSE = don't erase, prevents flicker
         return 0;
     }
     case WM_DESTROY:
-        // Free stored text
-        {
-            wchar_t* text = (wchar_t*)RemoveProp(hwnd, L"AnalysisText");
-            if (text) free(text);
-        }
+        g_analysisTextLen = 0;
         return 0;
     }
     return DefWindowProc(hwnd, msg, wParam, lParam);
@@ -361,8 +555,8 @@ void ShowAnalysisOverlay() {
     if (g_analysisHwnd) {
         // Reset session tracking when overlay is opened
         for (auto& ctx : g_monitors) {
-            ctx.sessionMaxCLL = 0.0f;
-            ctx.sessionMaxFALL = 0.0f;
+            ctx->stats->sessionMaxCLL = 0.0f;
+            ctx->stats->sessionMaxFALL = 0.0f;
         }
 
         // Set initial placeholder text
@@ -375,9 +569,31 @@ void ShowAnalysisOverlay() {
             SetProp(g_analysisHwnd, L"AnalysisText", textCopy);
         }
 
+        // Report the processed monitor under the cursor (else the first one), from its top-right corner
+        POINT cursor = {};
+        GetCursorPos(&cursor);
+        HMONITOR target = MonitorFromPoint(cursor, MONITOR_DEFAULTTOPRIMARY);
+        HMONITOR fallback = nullptr;
+        bool processed = false;
+        for (const auto& ctx : g_monitors) {
+            if (ctx->cold->detached) continue;
+            if (!fallback) fallback = ctx->cold->monitor;
+            if (ctx->cold->monitor == target) processed = true;
+        }
+        if (!processed && fallback) target = fallback;
+        g_analysisOverlayMonitor.store(target);
+
+        MONITORINFO mi = { sizeof(MONITORINFO) };
+        int margin = 40;
+        int x = GetSystemMetrics(SM_CXSCREEN) - 260 - margin, y = margin;
+        if (GetMonitorInfo(target, &mi)) {
+            x = mi.rcMonitor.right - 260 - margin;
+            y = mi.rcMonitor.top + margin;
+        }
+
         // Show window and force to top of z-order
-        SetWindowPos(g_analysisHwnd, HWND_TOPMOST, 0, 0, 0, 0,
-            SWP_NOMOVE | SWP_NOSIZE | SWP_SHOWWINDOW | SWP_NOACTIVATE);
+        SetWindowPos(g_analysisHwnd, HWND_TOPMOST, x, y, 0, 0,
+            SWP_NOSIZE | SWP_SHOWWINDOW | SWP_NOACTIVATE);
 
         // Force immediate repaint
         InvalidateRect(g_analysisHwnd, nullptr, TRUE);
@@ -409,7 +625,7 @@ bool IsAnalysisOverlayVisible() {
 }
 
 bool CreateAnalysisResources(MonitorContext* ctx) {
-    if (!g_analysisCS || !g_analysisCB) {
+    if (!ctx->gpu->analysisCS || !ctx->gpu->analysisCB) {
         return false;  // Compute shader not available
     }
 
@@ -421,7 +637,7 @@ bool CreateAnalysisResources(MonitorContext* ctx) {
     bufDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
     bufDesc.StructureByteStride = sizeof(uint32_t);  // Each element is a uint
 
-    HRESULT hr = g_device->CreateBuffer(&bufDesc, nullptr, &ctx->analysisBuffer);
+    HRESULT hr = ctx->gpu->device->CreateBuffer(&bufDesc, nullptr, &ctx->stats->analysisBuffer);
     if (FAILED(hr)) {
         std::cerr << "Monitor " << ctx->index << " failed to create analysis buffer: 0x"
                   << std::hex << hr << std::dec << std::endl;
@@ -435,163 +651,423 @@ bool CreateAnalysisResources(MonitorContext* ctx) {
     uavDesc.Buffer.FirstElement = 0;
     uavDesc.Buffer.NumElements = 16;
 
-    hr = g_device->CreateUnorderedAccessView(ctx->analysisBuffer, &uavDesc, &ctx->analysisUAV);
+    hr = ctx->gpu->device->CreateUnorderedAccessView(ctx->stats->analysisBuffer, &uavDesc, &ctx->stats->analysisUAV);
     if (FAILED(hr)) {
         std::cerr << "Monitor " << ctx->index << " failed to create analysis UAV: 0x"
                   << std::hex << hr << std::dec << std::endl;
-        ctx->analysisBuffer->Release();
-        ctx->analysisBuffer = nullptr;
+        ctx->stats->analysisBuffer->Release();
+        ctx->stats->analysisBuffer = nullptr;
         return false;
     }
 
-    // Create double-buffered staging buffers for async readback
-    D3D11_BUFFER_DESC stagingDesc = {};
-    stagingDesc.ByteWidth = 16 * sizeof(uint32_t);  // 16 uint elements
-    stagingDesc.Usage = D3D11_USAGE_STAGING;
-    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-
-    for (int i = 0; i < 2; i++) {
-        hr = g_device->CreateBuffer(&stagingDesc, nullptr, &ctx->analysisStagingBuffer[i]);
-        if (FAILED(hr)) {
-            std::cerr << "Monitor " << ctx->index << " failed to create analysis staging buffer " << i << std::endl;
-            // Clean up
-            if (ctx->analysisUAV) { ctx->analysisUAV->Release(); ctx->analysisUAV = nullptr; }
-            if (ctx->analysisBuffer) { ctx->analysisBuffer->Release(); ctx->analysisBuffer = nullptr; }
-            for (int j = 0; j < i; j++) {
-                if (ctx->analysisStagingBuffer[j]) {
-                    ctx->analysisStagingBuffer[j]->Release();
-                    ctx->analysisStagingBuffer[j] = nullptr;
-                }
-            }
-            return false;
-        }
+    std::cout << "Monitor " << ctx->index << " analysis resources created" << std::endl;
+    return true;
+}
+
+static void ReleaseScopeResources(MonitorContext* ctx) {
+    if (ctx->stats->scopesUAV) { ctx->stats->scopesUAV->Release(); ctx->stats->scopesUAV = nullptr; }
+    if (ctx->stats->scopesBuffer) { ctx->stats->scopesBuffer->Release(); ctx->stats->scopesBuffer = nullptr; }
+}
+
+// Scope bins: SCOPE_BIN_COUNT uints, read back through their own ring like the analysis buffer
+static bool CreateScopeResources(MonitorContext* ctx) {
+    if (!ctx->gpu->scopesCS || !ctx->gpu->scopesCB) {
+        return false;  // Scopes shader not available
     }
 
-    std::cout << "Monitor " << ctx->index << " analysis resources created" << std::endl;
+    D3D11_BUFFER_DESC bufDesc = {};
+    bufDesc.ByteWidth = SCOPE_BIN_COUNT * sizeof(uint32_t);
+    bufDesc.Usage = D3D11_USAGE_DEFAULT;
+    bufDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS;
+    bufDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    bufDesc.StructureByteStride = sizeof(uint32_t);
+
+    HRESULT hr = ctx->gpu->device->CreateBuffer(&bufDesc, nullptr, &ctx->stats->scopesBuffer);
+    if (FAILED(hr)) {
+        std::cerr << "Monitor " << ctx->index << " failed to create scopes buffer: 0x"
+                  << std::hex << hr << std::dec << std::endl;
+        return false;
+    }
+
+    D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+    uavDesc.Format = DXGI_FORMAT_UNKNOWN;
+    uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+    uavDesc.Buffer.FirstElement = 0;
+    uavDesc.Buffer.NumElements = SCOPE_BIN_COUNT;
+
+    hr = ctx->gpu->device->CreateUnorderedAccessView(ctx->stats->scopesBuffer, &uavDesc, &ctx->stats->scopesUAV);
+    if (FAILED(hr)) {
+        std::cerr << "Monitor " << ctx->index << " failed to create scopes UAV: 0x"
+                  << std::hex << hr << std::dec << std::endl;
+        ReleaseScopeResources(ctx);
+        return false;
+    }
     return true;
 }
 
 void ReleaseAnalysisResources(MonitorContext* ctx) {
-    if (ctx->analysisUAV) { ctx->analysisUAV->Release(); ctx->analysisUAV = nullptr; }
-    if (ctx->analysisBuffer) { ctx->analysisBuffer->Release(); ctx->analysisBuffer = nullptr; }
-    for (int i = 0; i < 2; i++) {
-        if (ctx->analysisStagingBuffer[i]) {
-            ctx->analysisStagingBuffer[i]->Release();
-            ctx->analysisStagingBuffer[i] = nullptr;
+    if (ctx->stats->analysisUAV) { ctx->stats->analysisUAV->Release(); ctx->stats->analysisUAV = nullptr; }
+    if (ctx->stats->analysisBuffer) { ctx->stats->analysisBuffer->Release(); ctx->stats->analysisBuffer = nullptr; }
+    ReleaseScopeResources(ctx);
+    for (auto& timer : ctx->stats->analysisTimers) {
+        if (timer.disjoint) { timer.disjoint->Release(); timer.disjoint = nullptr; }
+        if (timer.begin) { timer.begin->Release(); timer.begin = nullptr; }
+        if (timer.end) { timer.end->Release(); timer.end = nullptr; }
+        timer.pending = false;
+    }
+    // Staging copies belong to the monitor's readback manager (released with the monitor)
+}
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+// Timestamps around the analysis work (null when both timers are still in flight: untimed)
+static AnalysisTimer* StartAnalysisTimer(MonitorContext* ctx) {
+    for (auto& timer : ctx->stats->analysisTimers) {
+        if (timer.pending) continue;
+        if (!timer.disjoint) {
+            D3D11_QUERY_DESC desc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+            if (FAILED(ctx->gpu->device->CreateQuery(&desc, &timer.disjoint))) return nullptr;
+            desc.Query = D3D11_QUERY_TIMESTAMP;
+            if (FAILED(ctx->gpu->device->CreateQuery(&desc, &timer.begin)) ||
+                FAILED(ctx->gpu->device->CreateQuery(&desc, &timer.end))) {
+                if (timer.begin) { timer.begin->Release(); timer.begin = nullptr; }
+                timer.disjoint->Release();
+                timer.disjoint = nullptr;
+                return nullptr;
+            }
+        }
+        ctx->gpu->context->Begin(timer.disjoint);
+        ctx->gpu->context->End(timer.begin);
+        return &timer;
+    }
+    return nullptr;
+}
+
+static void StopAnalysisTimer(MonitorContext* ctx, AnalysisTimer* timer) {
+    if (!timer) return;
+    ctx->gpu->context->End(timer->end);
+    ctx->gpu->context->End(timer->disjoint);
+    timer->pending = true;
+}
+
+// Finished timings go to the scheduler; unfinished ones are retried next pass (never flushes or waits)
+static void PollAnalysisTimers(MonitorContext* ctx) {
+    for (auto& timer : ctx->stats->analysisTimers) {
+        if (!timer.pending) continue;
+        D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+        UINT64 begin = 0, end = 0;
+        ID3D11DeviceContext* context = ctx->gpu->context;
+        if (context->GetData(timer.disjoint, &disjoint, sizeof(disjoint), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context->GetData(timer.begin, &begin, sizeof(begin), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK ||
+            context->GetData(timer.end, &end, sizeof(end), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK) {
+            continue;
+        }
+        timer.pending = false;
+        if (disjoint.Disjoint || disjoint.Frequency == 0 || end < begin) continue;  // Clock changed mid-way
+        float gpuMs = (float)((double)(end - begin) * 1000.0 / (double)disjoint.Frequency);
+        ReportAnalysisCost(g_analysisScheduler, ctx->index, gpuMs);
+        MetricSet(ctx->metrics->analysisGpuMs, g_analysisScheduler.monitors[ctx->index].costMs);
+    }
+}
+
+void PlanAnalysisDispatches() {
+    bool wanted = g_analysisEnabled.load() || IsAnalysisRecording();
+    for (auto& ctx : g_monitors) {
+        AnalysisSchedMonitor& slot = AnalysisSchedSlot(g_analysisScheduler, ctx->index);
+        slot.active = wanted && ctx->enabled && ctx->gpu && ctx->gpu->analysisCS && ctx->captureSRV;
+        slot.group = 0;
+        for (size_t g = 0; g < g_gpuDevices.size(); g++) {
+            if (g_gpuDevices[g].get() == ctx->gpu) slot.group = (int)g;
         }
+        if (ctx->gpu) PollAnalysisTimers(ctx.get());
     }
+
+    g_analysisScheduler.budgetMs = g_analysisBudgetMs.load();
+    PlanAnalysisPass(g_analysisScheduler);
+
+    for (auto& ctx : g_monitors) {
+        const AnalysisSchedMonitor& slot = g_analysisScheduler.monitors[ctx->index];
+        if (!slot.active) continue;
+        if (!slot.granted && slot.waited >= slot.interval) MetricInc(ctx->metrics->analysisDeferrals);
+        MetricSet(ctx->metrics->analysisInterval, slot.interval);
+    }
+}
+
+static bool IsOverlayMonitor(const MonitorContext* ctx) {
+    return g_analysisHwnd && IsWindowVisible(g_analysisHwnd) && ctx->cold->monitor == g_analysisOverlayMonitor.load();
+}
+
+// Readback delivery, 2 frames after the dispatch (defined with the recording below)
+static void DeliverAnalysis(MonitorContext* ctx, const uint32_t* data);
+static void DeliverScopes(MonitorContext* ctx, const void* bins);
+
+// Rings are registered once per monitor; device-loss recovery only drops their staging
+static void RegisterAnalysisReadbacks(MonitorContext* ctx) {
+    if (ctx->stats->analysisReadbackRing >= 0) return;
+    ReadbackManager& readback = MonitorReadbacks(ctx);
+
+    ReadbackDesc desc;
+    desc.bytes = 16 * sizeof(uint32_t);
+    ctx->stats->analysisReadbackRing = AddReadbackRing(readback, "analysis", desc, 2, ANALYSIS_READBACK_DELAY,
+        [ctx](const void* data, uint64_t) { DeliverAnalysis(ctx, (const uint32_t*)data); });
+
+    desc.bytes = SCOPE_BIN_COUNT * sizeof(uint32_t);
+    ctx->stats->scopesReadbackRing = AddReadbackRing(readback, "scopes", desc, 2, ANALYSIS_READBACK_DELAY,
+        [ctx](const void* data, uint64_t) { DeliverScopes(ctx, data); });
 }
 
-void DispatchAnalysisCompute(MonitorContext* ctx) {
-    if (!g_analysisCS || !g_analysisCB || !ctx->captureSRV) return;
+// Bin the captured frame into the scope buffer (caller has the stats pass bound state cleared)
+static bool DispatchScopes(MonitorContext* ctx) {
+    if (!ctx->stats->scopesBuffer && !CreateScopeResources(ctx)) return false;
+
+    ScopeGrid grid = ScopeSampleGrid((uint32_t)ctx->width, (uint32_t)ctx->height);
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (FAILED(ctx->gpu->context->Map(ctx->gpu->scopesCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) return false;
+    uint32_t* udata = (uint32_t*)mapped.pData;
+    udata[0] = (uint32_t)ctx->width;
+    udata[1] = (uint32_t)ctx->height;
+    udata[2] = ctx->isHDREnabled ? 1 : 0;
+    udata[3] = grid.x;
+    udata[4] = grid.y;
+    udata[5] = udata[6] = udata[7] = 0;  // pad
+    ctx->gpu->context->Unmap(ctx->gpu->scopesCB, 0);
+
+    UINT clearVal[4] = { 0, 0, 0, 0 };
+    ctx->gpu->context->ClearUnorderedAccessViewUint(ctx->stats->scopesUAV, clearVal);
+
+    ctx->gpu->context->CSSetShader(ctx->gpu->scopesCS, nullptr, 0);
+    ctx->gpu->context->CSSetConstantBuffers(0, 1, &ctx->gpu->scopesCB);
+    ctx->gpu->context->CSSetShaderResources(0, 1, &ctx->captureSRV);
+    ctx->gpu->context->CSSetUnorderedAccessViews(0, 1, &ctx->stats->scopesUAV, nullptr);
+    ctx->gpu->context->Dispatch((grid.x + SCOPE_THREAD_GROUP - 1) / SCOPE_THREAD_GROUP,
+                                (grid.y + SCOPE_THREAD_GROUP - 1) / SCOPE_THREAD_GROUP, 1);
+
+    ID3D11UnorderedAccessView* nullUAV = nullptr;
+    ctx->gpu->context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+    ID3D11ShaderResourceView* nullSRV = nullptr;
+    ctx->gpu->context->CSSetShaderResources(0, 1, &nullSRV);
+
+    return RequestReadback(MonitorReadbacks(ctx), ctx->stats->scopesReadbackRing, ctx->stats->scopesBuffer);
+}
+
+bool IsAnalysisDispatchFrame(const MonitorContext* ctx) {
+    return IsAnalysisGranted(g_analysisScheduler, ctx->index);
+}
+
+void DispatchAnalysisCompute(MonitorContext* ctx, bool statsWritten) {
+    if (!ctx->gpu->analysisCS || !ctx->gpu->analysisCB || !ctx->captureSRV) return;
 
     // Create resources on first use
-    if (!ctx->analysisBuffer) {
+    if (!ctx->stats->analysisBuffer) {
         if (!CreateAnalysisResources(ctx)) {
             return;
         }
     }
+    RegisterAnalysisReadbacks(ctx);
 
-    // Only dispatch every N frames
-    ctx->analysisFrameCounter++;
-    int frameInCycle = ctx->analysisFrameCounter % ANALYSIS_DISPATCH_INTERVAL;
+    // Only on passes the scheduler granted this monitor
+    if (!IsAnalysisDispatchFrame(ctx)) return;
+    MarkAnalysisDispatched(g_analysisScheduler, ctx->index);
+    MetricInc(ctx->metrics->analysisDispatches);
+    AnalysisTimer* timer = StartAnalysisTimer(ctx);
 
-    if (frameInCycle == 0) {
+    if (!statsWritten) {
         // Update constant buffer with frame dimensions and HDR state
         D3D11_MAPPED_SUBRESOURCE mapped;
-        if (SUCCEEDED(g_context->Map(g_analysisCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        if (SUCCEEDED(ctx->gpu->context->Map(ctx->gpu->analysisCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
             uint32_t* udata = (uint32_t*)mapped.pData;
             udata[0] = (uint32_t)ctx->width;
             udata[1] = (uint32_t)ctx->height;
             udata[2] = ctx->isHDREnabled ? 1 : 0;
             udata[3] = 0;  // pad
-            g_context->Unmap(g_analysisCB, 0);
+            ctx->gpu->context->Unmap(ctx->gpu->analysisCB, 0);
         }
 
         // Clear the analysis buffer (reset counters)
         UINT clearVal[4] = { 0, 0, 0, 0 };
-        g_context->ClearUnorderedAccessViewUint(ctx->analysisUAV, clearVal);
+        ctx->gpu->context->ClearUnorderedAccessViewUint(ctx->stats->analysisUAV, clearVal);
 
         // Dispatch compute shader
-        g_context->CSSetShader(g_analysisCS, nullptr, 0);
-        g_context->CSSetConstantBuffers(0, 1, &g_analysisCB);
-        g_context->CSSetShaderResources(0, 1, &ctx->captureSRV);
-        g_context->CSSetUnorderedAccessViews(0, 1, &ctx->analysisUAV, nullptr);
-        g_context->Dispatch(1, 1, 1);
+        ctx->gpu->context->CSSetShader(ctx->gpu->analysisCS, nullptr, 0);
+        ctx->gpu->context->CSSetConstantBuffers(0, 1, &ctx->gpu->analysisCB);
+        ctx->gpu->context->CSSetShaderResources(0, 1, &ctx->captureSRV);
+        ctx->gpu->context->CSSetUnorderedAccessViews(0, 1, &ctx->stats->analysisUAV, nullptr);
+        ctx->gpu->context->Dispatch(1, 1, 1);
 
         // Unbind resources
         ID3D11UnorderedAccessView* nullUAV = nullptr;
-        g_context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+        ctx->gpu->context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
         ID3D11ShaderResourceView* nullSRV = nullptr;
-        g_context->CSSetShaderResources(0, 1, &nullSRV);
+        ctx->gpu->context->CSSetShaderResources(0, 1, &nullSRV);
+    }
 
-        // Copy to staging buffer (this frame's results go to current staging index)
-        int stagingIdx = ctx->analysisStagingIndex;
-        g_context->CopyResource(ctx->analysisStagingBuffer[stagingIdx], ctx->analysisBuffer);
+    // Queue the copy; PollReadbacks delivers it once it's ANALYSIS_READBACK_DELAY frames old
+    RequestReadback(MonitorReadbacks(ctx), ctx->stats->analysisReadbackRing, ctx->stats->analysisBuffer);
 
-        // Flip staging index for next time
-        ctx->analysisStagingIndex = 1 - stagingIdx;
-    }
+    // Scopes only while someone can see them (the recording keeps scalar stats only)
+    if (g_analysisScopes.load() && IsOverlayMonitor(ctx)) DispatchScopes(ctx);
+    StopAnalysisTimer(ctx, timer);
 }
 
-static void ComputeFrameTimingStats(MonitorContext* ctx) {
-    if (ctx->frameTimeCount == 0) return;
+void ComputeFrameTimingStats(MonitorContext* ctx) {
+    if (ctx->stats->frameTimeCount == 0) return;
 
     float sum = 0.0f;
     float minMs = 1000.0f;
     float maxMs = 0.0f;
 
-    for (int i = 0; i < ctx->frameTimeCount; i++) {
-        float t = ctx->frameTimeHistory[i];
+    for (int i = 0; i < ctx->stats->frameTimeCount; i++) {
+        float t = ctx->stats->frameTimeHistory[i];
         sum += t;
         if (t < minMs) minMs = t;
         if (t > maxMs) maxMs = t;
     }
 
-    float avgMs = sum / ctx->frameTimeCount;
+    float avgMs = sum / ctx->stats->frameTimeCount;
 
     // Compute variance
     float varSum = 0.0f;
-    for (int i = 0; i < ctx->frameTimeCount; i++) {
-        float diff = ctx->frameTimeHistory[i] - avgMs;
+    for (int i = 0; i < ctx->stats->frameTimeCount; i++) {
+        float diff = ctx->stats->frameTimeHistory[i] - avgMs;
         varSum += diff * diff;
     }
-    float variance = varSum / ctx->frameTimeCount;
+    float variance = varSum / ctx->stats->frameTimeCount;
 
     // Current frame time is the most recent
-    int lastIdx = (ctx->frameTimeIndex + 63) % 64;
-    float currentMs = ctx->frameTimeHistory[lastIdx];
+    int lastIdx = (ctx->stats->frameTimeIndex + 63) % 64;
+    float currentMs = ctx->stats->frameTimeHistory[lastIdx];
+
+    ctx->stats->frameTimingStats.currentMs = currentMs;
+    ctx->stats->frameTimingStats.minMs = minMs;
+    ctx->stats->frameTimingStats.maxMs = maxMs;
+    ctx->stats->frameTimingStats.avgMs = avgMs;
+    ctx->stats->frameTimingStats.varianceMs = sqrtf(variance);  // Std dev
+    ctx->stats->frameTimingStats.fps = (avgMs > 0.0f) ? (1000.0f / avgMs) : 0.0f;
+}
 
-    ctx->frameTimingStats.currentMs = currentMs;
-    ctx->frameTimingStats.minMs = minMs;
-    ctx->frameTimingStats.maxMs = maxMs;
-    ctx->frameTimingStats.avgMs = avgMs;
-    ctx->frameTimingStats.varianceMs = sqrtf(variance);  // Std dev
-    ctx->frameTimingStats.fps = (avgMs > 0.0f) ? (1000.0f / avgMs) : 0.0f;
+static void ComputePresentStats(MonitorContext* ctx) {
+    const PresentAccounting& acc = ctx->stats->presentStats;
+    FrameTimingStats& stats = ctx->stats->frameTimingStats;
+    stats.presentStatsAvailable = ctx->stats->presentStatsAvailable;
+    stats.presentsDisplayed = acc.displayed;
+    stats.presentsLate = acc.late;
+    stats.refreshesMissed = acc.missedRefreshes;
+    stats.presentsDuplicate = acc.duplicates;
+    PresentStatsLatency(acc, stats.presentLatencyAvgMs, stats.presentLatencyMaxMs);
+
+    uint64_t total = 0;
+    for (int i = 0; i < PRESENT_LATENCY_BUCKETS; i++) {
+        total += acc.latencyBuckets[i];
+    }
+    for (int i = 0; i < PRESENT_LATENCY_BUCKETS; i++) {
+        stats.presentLatencyPct[i] = total > 0 ? (float)acc.latencyBuckets[i] * 100.0f / (float)total : 0.0f;
+    }
 }
 
-void UpdateAnalysisDisplay(MonitorContext* ctx) {
-    if (!g_analysisHwnd || !IsWindowVisible(g_analysisHwnd)) return;
-    if (!ctx->analysisStagingBuffer[0] || !ctx->analysisStagingBuffer[1]) return;
+// ============================================================================
+// Time Series Recording
+// ============================================================================
 
-    // Only read back 2 frames after dispatch to avoid GPU sync stall
-    int frameInCycle = ctx->analysisFrameCounter % ANALYSIS_DISPATCH_INTERVAL;
-    if (frameInCycle != ANALYSIS_READBACK_DELAY) return;
+// Memory-mapped ring file next to the exe (render thread appends, StartAnalysisRecording and
+// StopAnalysisRecording run on the processing thread before/after the render loop)
+static HANDLE g_recordFile = INVALID_HANDLE_VALUE;
+static HANDLE g_recordMapping = nullptr;
+static void* g_recordView = nullptr;
 
-    // Read from the OTHER staging buffer (the one we copied to 2 frames ago)
-    int readIdx = ctx->analysisStagingIndex;  // Current index points to buffer we'll write NEXT
+static std::wstring GetAnalysisRecordingPath() {
+    std::wstring path = GetIniPath();
+    size_t lastSlash = path.find_last_of(L"\\/");
+    return path.substr(0, lastSlash + 1) + L"DesktopLUT-analysis.ring";
+}
 
-    D3D11_MAPPED_SUBRESOURCE mapped;
-    HRESULT hr = g_context->Map(ctx->analysisStagingBuffer[readIdx], 0, D3D11_MAP_READ, 0, &mapped);
-    if (FAILED(hr)) return;
+bool StartAnalysisRecording() {
+    if (g_recordView) return true;  // Already recording
+
+    std::wstring path = GetAnalysisRecordingPath();
+    size_t bytes = AnalysisRingBytes(ANALYSIS_RING_DEFAULT_CAPACITY);
+
+    // Readers may copy or map the file while we record
+    g_recordFile = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                               OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (g_recordFile == INVALID_HANDLE_VALUE) {
+        std::wcerr << L"Analysis recording: cannot open " << path << L" (" << GetLastError() << L")" << std::endl;
+        return false;
+    }
 
-    // Read uint array and convert to AnalysisResult
-    uint32_t* data = (uint32_t*)mapped.pData;
+    // Mapping at full size grows a new file (zero-filled) in one step
+    g_recordMapping = CreateFileMappingW(g_recordFile, nullptr, PAGE_READWRITE,
+                                         (DWORD)((uint64_t)bytes >> 32), (DWORD)bytes, nullptr);
+    if (g_recordMapping) {
+        g_recordView = MapViewOfFile(g_recordMapping, FILE_MAP_WRITE, 0, 0, bytes);
+    }
+    if (!g_recordView || !AnalysisRingAttach(g_recordView, bytes, ANALYSIS_RING_DEFAULT_CAPACITY)) {
+        std::cerr << "Analysis recording: cannot map ring file (" << GetLastError() << ")" << std::endl;
+        StopAnalysisRecording();
+        return false;
+    }
+
+    std::wcout << L"Analysis recording to " << path << std::endl;
+    return true;
+}
+
+void StopAnalysisRecording() {
+    if (g_recordView) {
+        FlushViewOfFile(g_recordView, 0);
+        UnmapViewOfFile(g_recordView);
+        g_recordView = nullptr;
+    }
+    if (g_recordMapping) { CloseHandle(g_recordMapping); g_recordMapping = nullptr; }
+    if (g_recordFile != INVALID_HANDLE_VALUE) { CloseHandle(g_recordFile); g_recordFile = INVALID_HANDLE_VALUE; }
+}
+
+bool IsAnalysisRecording() {
+    return g_recordView != nullptr;
+}
+
+static void RecordAnalysis(const MonitorContext* ctx, const AnalysisResult& result) {
+    AnalysisRecord r = {};
+    r.timestampMs = (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    r.monitorIndex = (uint8_t)ctx->index;
+    r.flags = ctx->isHDREnabled ? ANALYSIS_RECORD_HDR : 0;
+    r.peakNits = result.peakNits;
+    r.avgNits = result.avgNits;
+    r.minNonZeroNits = result.minNonZeroNits;
+    r.detectedPeakNits = ctx->stats->detectedPeakNits;
+    r.frameAvgMs = ctx->stats->frameTimingStats.avgMs;
+    r.frameMaxMs = ctx->stats->frameTimingStats.maxMs;
+    r.fps = ctx->stats->frameTimingStats.fps;
+    uint32_t total = result.totalPixels;
+    r.shareRec709 = AnalysisShare(result.pixelsRec709, total);
+    r.shareP3Only = AnalysisShare(result.pixelsP3Only, total);
+    r.shareRec2020Only = AnalysisShare(result.pixelsRec2020Only, total);
+    r.shareOutOfGamut = AnalysisShare(result.pixelsOutOfGamut, total);
+    r.shareClipBlack = AnalysisShare(result.pixelsClipBlack, total);
+    r.shareClipWhite = AnalysisShare(result.pixelsClipWhite, total);
+    for (int i = 0; i < 5; i++) {
+        r.histogram[i] = AnalysisShare(result.histogram[i], total);
+    }
+    AnalysisRingAppend(g_recordView, r);
+}
+
+// Scope bins from an analysis dispatch (skipped while the UI still holds the previous set)
+static void DeliverScopes(MonitorContext* ctx, const void* bins) {
+    if (!IsOverlayMonitor(ctx) || g_scopesDataReady.load(std::memory_order_acquire)) return;
+    memcpy(g_pendingScopeBins, bins, sizeof(g_pendingScopeBins));
+    g_pendingScopesHDR = ctx->isHDREnabled;
+    g_scopesDataReady.store(true, std::memory_order_release);
+}
+
+// Recording and display update for a completed analysis readback (16 uints)
+static void DeliverAnalysis(MonitorContext* ctx, const uint32_t* data) {
+    // Convert uint array to AnalysisResult
     AnalysisResult result = {};
 
-    result.peakNits = *(float*)&data[0];
-    result.minNits = *(float*)&data[1];
-    float sumNits = *(float*)&data[2];
+    result.peakNits = *(const float*)&data[0];
+    result.minNits = *(const float*)&data[1];
+    float sumNits = *(const float*)&data[2];
     result.totalPixels = data[3];
     result.pixelsRec709 = data[4];
     result.pixelsP3Only = data[5];
@@ -604,9 +1080,7 @@ void UpdateAnalysisDisplay(MonitorContext* ctx) {
     result.histogram[2] = data[12];
     result.histogram[3] = data[13];
     result.histogram[4] = data[14];
-    result.minNonZeroNits = *(float*)&data[15];
-
-    g_context->Unmap(ctx->analysisStagingBuffer[readIdx], 0);
+    result.minNonZeroNits = *(const float*)&data[15];
 
     // Calculate derived values
     if (result.totalPixels > 0) {
@@ -614,15 +1088,35 @@ void UpdateAnalysisDisplay(MonitorContext* ctx) {
     }
 
     // Update session maximums
-    if (result.peakNits > ctx->sessionMaxCLL) {
-        ctx->sessionMaxCLL = result.peakNits;
+    if (result.peakNits > ctx->stats->sessionMaxCLL) {
+        ctx->stats->sessionMaxCLL = result.peakNits;
     }
-    if (result.avgNits > ctx->sessionMaxFALL) {
-        ctx->sessionMaxFALL = result.avgNits;
+    if (result.avgNits > ctx->stats->sessionMaxFALL) {
+        ctx->stats->sessionMaxFALL = result.avgNits;
     }
 
     // Store latest result
-    ctx->analysisResult = result;
+    ctx->stats->analysisResult = result;
+
+    // The scheduler adapts this monitor's interval to how much the frame changed
+    AnalysisSignature signature;
+    signature.avgNits = result.avgNits;
+    signature.peakNits = result.peakNits;
+    if (result.totalPixels > 0) {
+        float totalF = (float)result.totalPixels;
+        signature.wideShare = (result.pixelsP3Only + result.pixelsRec2020Only + result.pixelsOutOfGamut) / totalF;
+        signature.clipShare = (result.pixelsClipBlack + result.pixelsClipWhite) / totalF;
+    }
+    ReportAnalysisResult(g_analysisScheduler, ctx->index, signature);
+
+    bool overlayVisible = IsOverlayMonitor(ctx);
+    if (!overlayVisible && !g_recordView) return;
+
+    ComputeFrameTimingStats(ctx);
+    if (g_recordView) {
+        RecordAnalysis(ctx, result);
+    }
+    if (!overlayVisible) return;
 
     // Get tonemap settings for APL calculation and TM indicator
     float referencePeak = 1000.0f;
@@ -640,22 +1134,25 @@ void UpdateAnalysisDisplay(MonitorContext* ctx) {
         }
     }
 
-    // Compute and pass frame timing stats
-    ComputeFrameTimingStats(ctx);
-    ctx->frameTimingStats.compositorClockAvailable = (g_pfnWaitForCompositorClock != nullptr);
+    // Pass frame timing stats
+    ComputePresentStats(ctx);
+    ctx->stats->frameTimingStats.compositorClockAvailable = (g_pfnWaitForCompositorClock != nullptr);
+    ctx->stats->frameTimingStats.wakeupsPerSecond = g_idleTracker.wakeupsPerSecond;
+    ctx->stats->frameTimingStats.idleState = (int)g_idleTracker.state;
 
     // Queue data for UI thread (offloads formatting from render thread)
     g_pendingAnalysis.result = result;
+    g_pendingAnalysis.monitorIndex = g_monitors.size() > 1 ? ctx->index : -1;
     g_pendingAnalysis.isHDR = ctx->isHDREnabled;
     g_pendingAnalysis.targetPeak = referencePeak;
-    g_pendingAnalysis.sessionMaxCLL = ctx->sessionMaxCLL;
-    g_pendingAnalysis.sessionMaxFALL = ctx->sessionMaxFALL;
+    g_pendingAnalysis.sessionMaxCLL = ctx->stats->sessionMaxCLL;
+    g_pendingAnalysis.sessionMaxFALL = ctx->stats->sessionMaxFALL;
     g_pendingAnalysis.tonemapEnabled = tmEnabled;
     g_pendingAnalysis.tonemapDynamic = tmDynamic;
     g_pendingAnalysis.tonemapSourcePeak = tmSourcePeak;
     g_pendingAnalysis.tonemapTargetPeak = tmTargetPeak;
-    g_pendingAnalysis.detectedPeak = ctx->detectedPeakNits;
-    g_pendingAnalysis.frameTiming = ctx->frameTimingStats;
+    g_pendingAnalysis.detectedPeak = ctx->stats->detectedPeakNits;
+    g_pendingAnalysis.frameTiming = ctx->stats->frameTimingStats;
     g_analysisDataReady.store(true);
 
     // Post message to trigger UI update on window's thread
@@ -7,7 +7,8 @@
 
 // AnalysisResult is defined in types.h
 
-// Overlay management
+// Overlay management. Every processed monitor is analyzed; the overlay shows the one it sits on,
+// and showing it moves it to the top-right corner of the monitor under the cursor.
 bool CreateAnalysisOverlay(HINSTANCE hInstance);
 void DestroyAnalysisOverlay();
 void ShowAnalysisOverlay();
@@ -15,12 +16,30 @@ void HideAnalysisOverlay();
 void ToggleAnalysisOverlay();
 bool IsAnalysisOverlayVisible();
 
-// GPU resources (per-monitor, but only used for primary)
+// GPU resources (per-monitor, created on a monitor's first analysis dispatch)
 bool CreateAnalysisResources(MonitorContext* ctx);
 void ReleaseAnalysisResources(MonitorContext* ctx);
 
-// Per-frame dispatch (called from RenderMonitor)
-void DispatchAnalysisCompute(MonitorContext* ctx);
+// Start of a render loop pass (before any RenderMonitor): decide which monitors analyze this
+// pass. Dispatches are shared out round-robin under the AnalysisBudgetMs GPU budget, each
+// monitor's interval adapting to its content (see analysissched.h). Also collects the GPU
+// timings of earlier dispatches.
+void PlanAnalysisDispatches();
 
-// Async readback and display update (called from RenderMonitor)
-void UpdateAnalysisDisplay(MonitorContext* ctx);
+// Per-frame dispatch (called from RenderMonitor). statsWritten = the tiled main pass already
+// reduced this frame's statistics into analysisBuffer, so only the copy and scopes run.
+// Results arrive through the monitor's readback manager (recording and overlay update).
+void DispatchAnalysisCompute(MonitorContext* ctx, bool statsWritten = false);
+
+// True when the monitor was granted an analysis dispatch this pass (lets the tiled main
+// pass collect the statistics while it reads the frame)
+bool IsAnalysisDispatchFrame(const MonitorContext* ctx);
+
+// Analysis time series (DesktopLUT-analysis.ring next to the exe, see analysisring.h)
+// Start/stop around the render loop; while recording, analysis runs without the overlay
+bool StartAnalysisRecording();
+void StopAnalysisRecording();
+bool IsAnalysisRecording();
+
+// Min/max/avg/stddev over the frame time history (called when an analysis readback arrives)
+void ComputeFrameTimingStats(MonitorContext* ctx);
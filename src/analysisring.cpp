@@ -0,0 +1,52 @@
+// DesktopLUT - analysisring.cpp
+// Analysis time series: fixed-size records in a ring laid out for a memory-mapped file
+
+#include "analysisring.h"
+#include <atomic>
+#include <cstring>
+
+static AnalysisRingHeader* Header(void* base) {
+    return static_cast<AnalysisRingHeader*>(base);
+}
+
+static AnalysisRecord* Records(void* base) {
+    return reinterpret_cast<AnalysisRecord*>(static_cast<uint8_t*>(base) + sizeof(AnalysisRingHeader));
+}
+
+size_t AnalysisRingBytes(uint32_t capacity) {
+    return sizeof(AnalysisRingHeader) + (size_t)capacity * sizeof(AnalysisRecord);
+}
+
+bool AnalysisRingAttach(void* base, size_t size, uint32_t capacity) {
+    if (!base || capacity == 0 || size < AnalysisRingBytes(capacity)) return false;
+
+    AnalysisRingHeader* h = Header(base);
+    if (h->magic == ANALYSIS_RING_MAGIC && h->version == ANALYSIS_RING_VERSION &&
+        h->recordSize == sizeof(AnalysisRecord) && h->capacity == capacity) {
+        return true;  // Resume the existing series
+    }
+
+    // New file (zero-filled) or incompatible layout - start over
+    memset(base, 0, AnalysisRingBytes(capacity));
+    h->magic = ANALYSIS_RING_MAGIC;
+    h->version = ANALYSIS_RING_VERSION;
+    h->recordSize = sizeof(AnalysisRecord);
+    h->capacity = capacity;
+    h->writeCount = 0;
+    return true;
+}
+
+void AnalysisRingAppend(void* base, const AnalysisRecord& record) {
+    AnalysisRingHeader* h = Header(base);
+    uint64_t n = h->writeCount;
+    Records(base)[n % h->capacity] = record;
+    // Publish after the slot is complete (readers snapshot writeCount first)
+    std::atomic_thread_fence(std::memory_order_release);
+    h->writeCount = n + 1;
+}
+
+uint16_t AnalysisShare(uint32_t count, uint32_t total) {
+    if (total == 0) return 0;
+    double share = (double)count / (double)total * ANALYSIS_SHARE_SCALE;
+    return (uint16_t)(share > ANALYSIS_SHARE_SCALE ? ANALYSIS_SHARE_SCALE : share + 0.5);
+}
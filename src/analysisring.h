@@ -0,0 +1,68 @@
+// DesktopLUT - analysisring.h
+// Analysis time series: fixed-size records in a ring laid out for a memory-mapped file
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// File layout (little-endian): AnalysisRingHeader, then capacity AnalysisRecords.
+// Record n lives in slot n % capacity; writeCount is bumped after the slot is filled, so a
+// reader that snapshots writeCount first sees only complete records. tools/query_analysis.py
+// reads the same layout.
+constexpr uint32_t ANALYSIS_RING_MAGIC = 0x53544C44;   // "DLTS"
+constexpr uint32_t ANALYSIS_RING_VERSION = 1;
+
+// 2 records/s for one monitor = ~36 hours; 16MB file
+constexpr uint32_t ANALYSIS_RING_DEFAULT_CAPACITY = 262144;
+
+// Shares below are fixed point: 10000 = 100% of analyzed pixels
+constexpr float ANALYSIS_SHARE_SCALE = 10000.0f;
+
+constexpr uint8_t ANALYSIS_RECORD_HDR = 0x01;      // Captured in HDR mode (nits are absolute)
+
+struct AnalysisRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t capacity;
+    uint64_t writeCount;           // Records ever appended (survives restarts of the same file)
+    uint8_t reserved[40];
+};
+static_assert(sizeof(AnalysisRingHeader) == 64, "ring header layout is part of the file format");
+
+struct AnalysisRecord {
+    uint64_t timestampMs;          // UTC, milliseconds since the Unix epoch
+    uint8_t monitorIndex;
+    uint8_t flags;                 // ANALYSIS_RECORD_*
+    uint16_t reserved;
+    float peakNits;                // Frame MaxCLL
+    float avgNits;                 // Frame average (FALL)
+    float minNonZeroNits;
+    float detectedPeakNits;        // Smoothed dynamic-tonemap peak
+    float frameAvgMs;              // Render interval over the timing window
+    float frameMaxMs;
+    float fps;
+    uint16_t shareRec709;          // Gamut usage
+    uint16_t shareP3Only;
+    uint16_t shareRec2020Only;
+    uint16_t shareOutOfGamut;
+    uint16_t shareClipBlack;
+    uint16_t shareClipWhite;
+    uint16_t histogram[5];         // 0-203, 203-1k, 1k-2k, 2k-4k, 4k+ nits
+    uint16_t pad;
+};
+static_assert(sizeof(AnalysisRecord) == 64, "record layout is part of the file format");
+
+// Bytes needed for a ring of capacity records
+size_t AnalysisRingBytes(uint32_t capacity);
+
+// Attach to a mapped region of AnalysisRingBytes(capacity). An existing ring with the same
+// version and capacity is resumed; anything else is reformatted. False if size is too small.
+bool AnalysisRingAttach(void* base, size_t size, uint32_t capacity);
+
+// Append one record (no allocation, single writer)
+void AnalysisRingAppend(void* base, const AnalysisRecord& record);
+
+// Pixel count -> fixed-point share of total
+uint16_t AnalysisShare(uint32_t count, uint32_t total);
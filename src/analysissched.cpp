@@ -0,0 +1,104 @@
+// DesktopLUT - analysissched.cpp
+// Analysis scheduling across monitors: round-robin dispatches under a per-pass GPU-time budget,
+// each monitor's interval adapting to how fast its content changes (no Windows dependencies)
+
+#include "analysissched.h"
+#include <algorithm>
+#include <cmath>
+
+AnalysisSchedMonitor& AnalysisSchedSlot(AnalysisScheduler& s, int index) {
+    if (index >= (int)s.monitors.size()) s.monitors.resize(index + 1);
+    return s.monitors[index];
+}
+
+int PlanAnalysisPass(AnalysisScheduler& s) {
+    s.passes++;
+    size_t count = s.monitors.size();
+    if (count == 0) return 0;
+    if (s.cursor >= count) s.cursor = 0;
+
+    int groups = 0;
+    for (auto& m : s.monitors) {
+        m.granted = false;
+        if (!m.active) {
+            m.waited = m.interval;   // Due again the moment it's re-enabled
+            continue;
+        }
+        m.waited++;
+        groups = (std::max)(groups, m.group + 1);
+    }
+    // GPU time granted so far this pass, per adapter
+    if ((int)s.spent.size() < groups) {
+        s.spent.resize(groups);
+        s.grantedIn.resize(groups);
+    }
+    std::fill(s.spent.begin(), s.spent.begin() + groups, 0.0f);
+    std::fill(s.grantedIn.begin(), s.grantedIn.begin() + groups, 0);
+
+    int granted = 0;
+    size_t firstLeft = count;    // First due monitor that had to wait (next pass starts there)
+    size_t lastGranted = count;
+    for (size_t n = 0; n < count; n++) {
+        size_t i = (s.cursor + n) % count;
+        AnalysisSchedMonitor& m = s.monitors[i];
+        if (!m.active || m.waited < m.interval) continue;
+
+        float cost = m.costMs > 0.0f ? m.costMs : ANALYSIS_DEFAULT_COST_MS;
+        bool fits = s.budgetMs <= 0.0f || s.spent[m.group] + cost <= s.budgetMs;
+        if (!fits && s.grantedIn[m.group] > 0) {
+            m.deferrals++;
+            if (firstLeft == count) firstLeft = i;
+            continue;
+        }
+        if (!fits) s.overBudget++;
+        s.spent[m.group] += cost;
+        s.grantedIn[m.group]++;
+        m.granted = true;
+        granted++;
+        lastGranted = i;
+    }
+
+    if (firstLeft != count) s.cursor = firstLeft;
+    else if (lastGranted != count) s.cursor = (lastGranted + 1) % count;
+    return granted;
+}
+
+bool IsAnalysisGranted(const AnalysisScheduler& s, int index) {
+    return index >= 0 && index < (int)s.monitors.size() && s.monitors[index].granted;
+}
+
+void MarkAnalysisDispatched(AnalysisScheduler& s, int index) {
+    if (index < 0 || index >= (int)s.monitors.size()) return;
+    AnalysisSchedMonitor& m = s.monitors[index];
+    m.waited = 0;
+    m.dispatches++;
+}
+
+void ReportAnalysisCost(AnalysisScheduler& s, int index, float gpuMs) {
+    if (index < 0 || index >= (int)s.monitors.size() || !(gpuMs >= 0.0f)) return;
+    AnalysisSchedMonitor& m = s.monitors[index];
+    m.costMs = m.costMs > 0.0f ? m.costMs * 0.75f + gpuMs * 0.25f : (std::max)(gpuMs, 1e-3f);
+}
+
+// Luminance compared relative to the larger value (1 nit floor, so near-black noise doesn't count)
+static float RelativeChange(float a, float b) {
+    return std::fabs(a - b) / (std::max)({ a, b, 1.0f });
+}
+
+void ReportAnalysisResult(AnalysisScheduler& s, int index, const AnalysisSignature& signature) {
+    if (index < 0 || index >= (int)s.monitors.size()) return;
+    AnalysisSchedMonitor& m = s.monitors[index];
+    if (m.hasLast) {
+        float change = (std::max)({ RelativeChange(signature.avgNits, m.last.avgNits),
+                                    RelativeChange(signature.peakNits, m.last.peakNits),
+                                    std::fabs(signature.wideShare - m.last.wideShare),
+                                    std::fabs(signature.clipShare - m.last.clipShare) });
+        if (change > ANALYSIS_CHANGE_THRESHOLD) {
+            m.interval = (std::max)(ANALYSIS_INTERVAL_MIN, m.interval / 4);
+        } else {
+            m.interval = (std::min)(ANALYSIS_INTERVAL_MAX, m.interval + (std::max)(1, m.interval / 4));
+        }
+    }
+    m.last = signature;
+    m.hasLast = true;
+}
@@ -0,0 +1,84 @@
+// DesktopLUT - analysissched.h
+// Analysis scheduling across monitors: round-robin dispatches under a per-pass GPU-time budget,
+// each monitor's interval adapting to how fast its content changes (no Windows dependencies)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Interval bounds, in render loop passes (~60 per second while the desktop is active)
+constexpr int ANALYSIS_INTERVAL_MIN = 8;
+constexpr int ANALYSIS_INTERVAL_MAX = 120;
+constexpr int ANALYSIS_INTERVAL_START = 30;
+
+// GPU time analysis may use per render loop pass, per adapter (INI AnalysisBudgetMs, <= 0: no limit)
+constexpr float ANALYSIS_DEFAULT_BUDGET_MS = 0.5f;
+
+// Cost assumed for a monitor until its first dispatch has been timed
+constexpr float ANALYSIS_DEFAULT_COST_MS = 0.1f;
+
+// A result differing from the previous one by more than this (relative luminance, or share of
+// pixels) cuts the interval to a quarter; anything less lengthens it by a quarter
+constexpr float ANALYSIS_CHANGE_THRESHOLD = 0.05f;
+
+// What consecutive results are compared on
+struct AnalysisSignature {
+    float avgNits = 0.0f;
+    float peakNits = 0.0f;
+    float wideShare = 0.0f;     // Pixels outside Rec.709 (0-1)
+    float clipShare = 0.0f;     // Clipped black + white (0-1)
+};
+
+struct AnalysisSchedMonitor {
+    // Set by the caller before each plan
+    bool active = false;        // Wants analysis this pass (enabled, resources available)
+    int group = 0;              // Adapter it renders on; the budget applies per adapter
+
+    // Plan output
+    bool granted = false;       // Dispatch this pass
+
+    int interval = ANALYSIS_INTERVAL_START;
+    int waited = 0;             // Passes since the last dispatch
+    float costMs = 0.0f;        // Smoothed GPU time of one dispatch (0: not timed yet)
+    AnalysisSignature last;
+    bool hasLast = false;
+
+    uint64_t dispatches = 0;
+    uint64_t deferrals = 0;     // Passes spent due but over budget
+};
+
+// Shared by every monitor (owned by the render thread)
+struct AnalysisScheduler {
+    float budgetMs = ANALYSIS_DEFAULT_BUDGET_MS;
+    std::vector<AnalysisSchedMonitor> monitors;   // By display index (MonitorContext::index)
+    size_t cursor = 0;          // Where the next plan starts looking: the first monitor left waiting
+    uint64_t passes = 0;
+    uint64_t overBudget = 0;    // Dispatches granted alone although their cost exceeds the budget
+
+    // Per adapter, for PlanAnalysisPass: GPU time and dispatches granted so far this pass. Grown
+    // when a higher adapter group first appears, then reused, so planning allocates nothing.
+    std::vector<float> spent;
+    std::vector<int> grantedIn;
+};
+
+// Slot for a display index (created inactive, due as soon as it becomes active)
+AnalysisSchedMonitor& AnalysisSchedSlot(AnalysisScheduler& s, int index);
+
+// Start of a render loop pass: visit active monitors round-robin from the cursor and grant the
+// due ones (waited >= interval) while their adapter's budget lasts. A dispatch costing more than
+// the whole budget is granted only as its adapter's first of the pass, so it still runs. Due
+// monitors left over keep waiting and are visited first next pass. Returns the grants.
+int PlanAnalysisPass(AnalysisScheduler& s);
+
+bool IsAnalysisGranted(const AnalysisScheduler& s, int index);
+
+// The grant was used. A monitor that had no new frame to analyze stays due for the next pass.
+void MarkAnalysisDispatched(AnalysisScheduler& s, int index);
+
+// Measured GPU time of one dispatch
+void ReportAnalysisCost(AnalysisScheduler& s, int index, float gpuMs);
+
+// A dispatch's result arrived: shorten the interval if the content moved, lengthen it if not
+void ReportAnalysisResult(AnalysisScheduler& s, int index, const AnalysisSignature& signature);
@@ -0,0 +1,599 @@
+// DesktopLUT - benchcore.cpp
+// Microbenchmark harness and the fixtures for the portable modules (no Windows dependencies)
+
+#include "benchcore.h"
+#include "alloctrack.h"
+#include "analysisring.h"
+#include "analysissched.h"
+#include "color.h"
+#include "colordiff.h"
+#include "frameconstants.h"
+#include "lutingest.h"
+#include "lutstack.h"
+#include "metrics.h"
+#include "scopes.h"
+#include "tiledpass.h"
+#include "whitelist.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <cwchar>
+#include <iostream>
+#include <memory>
+
+// Each sample runs the fixture enough times to take at least this long (timer resolution)
+static const double BATCH_TARGET_NS = 20e6;
+
+// Median over this many samples; fixtures slower than SLOW_FIXTURE_NS (large LUT loads) take fewer
+static const int SAMPLE_COUNT = 9;
+static const int SLOW_SAMPLE_COUNT = 3;
+static const double SLOW_FIXTURE_NS = 200e6;
+
+volatile float g_benchSink = 0.0f;
+
+static double ElapsedNs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static BenchResult RunFixture(const BenchFixture& f) {
+    // Warm-up (file cache, first-touch allocations), then size the batch from one timed run
+    f.run();
+    auto start = std::chrono::steady_clock::now();
+    f.run();
+    double singleNs = (std::max)(ElapsedNs(start), 1.0);
+
+    BenchResult r;
+    r.name = f.name;
+    r.iterations = (std::max)((uint64_t)1, (uint64_t)(BATCH_TARGET_NS / singleNs));
+    r.samples = singleNs > SLOW_FIXTURE_NS ? SLOW_SAMPLE_COUNT : SAMPLE_COUNT;
+
+    std::vector<double> perRun(r.samples);
+    uint64_t allocsBefore = AllocThreadCount();
+    for (int s = 0; s < r.samples; s++) {
+        start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < r.iterations; i++) {
+            f.run();
+        }
+        perRun[s] = ElapsedNs(start) / (double)r.iterations;
+    }
+    r.allocs = AllocThreadCount() - allocsBefore;
+    std::sort(perRun.begin(), perRun.end());
+    r.minNs = perRun.front();
+    r.medianNs = perRun[perRun.size() / 2];
+    r.maxNs = perRun.back();
+    return r;
+}
+
+static void PrintResult(const BenchResult& r) {
+    char line[160];
+    double ns = r.medianNs;
+    if (ns >= 1e6) {
+        snprintf(line, sizeof(line), "%-34s %10.2f ms  (min %.2f, max %.2f)", r.name.c_str(), ns / 1e6, r.minNs / 1e6, r.maxNs / 1e6);
+    } else if (ns >= 1e3) {
+        snprintf(line, sizeof(line), "%-34s %10.2f us  (min %.2f, max %.2f)", r.name.c_str(), ns / 1e3, r.minNs / 1e3, r.maxNs / 1e3);
+    } else {
+        snprintf(line, sizeof(line), "%-34s %10.1f ns  (min %.1f, max %.1f)", r.name.c_str(), ns, r.minNs, r.maxNs);
+    }
+    std::cout << line << std::endl;
+}
+
+std::vector<BenchResult> RunBenchmarkFixtures(const std::vector<BenchFixture>& fixtures, const std::string& filter,
+                                              int& allocating) {
+    std::vector<BenchResult> results;
+    allocating = 0;
+    for (const BenchFixture& f : fixtures) {
+        if (!filter.empty() && f.name.find(filter) == std::string::npos) continue;
+
+        // Fixtures log like the app does (e.g. "Loaded 65^3 LUT") - keep that out of the timing
+        std::streambuf* console = std::cout.rdbuf(nullptr);
+        results.push_back(RunFixture(f));
+        std::cout.rdbuf(console);
+        std::cout.clear();
+        PrintResult(results.back());
+        if (DESKTOPLUT_ALLOC_TRACKING && f.steadyState && results.back().allocs > 0) {
+            std::cerr << "  " << f.name << " is steady-state work but allocated " << results.back().allocs
+                      << " times" << std::endl;
+            allocating++;
+        }
+    }
+    return results;
+}
+
+void WriteBenchmarkJson(FILE* f, const std::vector<BenchResult>& results) {
+#ifdef NDEBUG
+    const char* build = "release";
+#else
+    const char* build = "debug";
+#endif
+    fprintf(f, "{\n  \"schema\": %d,\n  \"build\": \"%s\",\n  \"benchmarks\": [\n", BENCHMARK_SCHEMA, build);
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        char allocs[48] = "";
+        if (DESKTOPLUT_ALLOC_TRACKING) {
+            snprintf(allocs, sizeof(allocs), ", \"allocs_per_run\": %.3f",
+                     (double)r.allocs / (double)(r.iterations * r.samples));
+        }
+        fprintf(f, "    {\"name\": \"%s\", \"iterations\": %llu, \"samples\": %d, "
+                   "\"min_ns\": %.1f, \"median_ns\": %.1f, \"max_ns\": %.1f%s}%s\n",
+                r.name.c_str(), (unsigned long long)r.iterations, r.samples,
+                r.minNs, r.medianNs, r.maxNs, allocs, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+// ============================================================================
+// Fixture Data
+// ============================================================================
+
+std::string MakeCubeFixture(int size) {
+    std::string text = "# DesktopLUT benchmark fixture\nTITLE \"bench " + std::to_string(size) + "\"\nLUT_3D_SIZE " +
+                       std::to_string(size) + "\n";
+    text.reserve(text.size() + (size_t)size * size * size * 27);
+    char line[64];
+    float scale = 1.0f / (float)(size - 1);
+    for (int b = 0; b < size; b++) {
+        for (int g = 0; g < size; g++) {
+            for (int r = 0; r < size; r++) {
+                float rf = r * scale, gf = g * scale, bf = b * scale;
+                float ro = powf(rf, 1.05f) * 0.96f + gf * 0.03f + bf * 0.01f;
+                float go = powf(gf, 1.02f) * 0.97f + rf * 0.02f + bf * 0.01f;
+                float bo = powf(bf, 0.98f) * 0.98f + rf * 0.01f + gf * 0.01f;
+                snprintf(line, sizeof(line), "%.6f %.6f %.6f\n", ro, go, bo);
+                text += line;
+            }
+        }
+    }
+    return text;
+}
+
+std::wstring MakeWhitelistFixture() {
+    std::wstring raw;
+    wchar_t entry[64];
+    for (int i = 0; i < 200; i++) {
+        if (i % 10 == 7) {
+            swprintf(entry, 64, L"*player%02d*", i);
+        } else if (i % 10 == 9) {
+            swprintf(entry, 64, L"steamapps/common/Title%03d/", i);
+        } else {
+            swprintf(entry, 64, L"Game%03d.exe", i);
+        }
+        if (!raw.empty()) raw += (i % 3 == 0) ? L"; " : L", ";
+        raw += entry;
+    }
+    return raw;
+}
+
+// A 500-process snapshot: system and app processes that match nothing, plus one game under a
+// whitelisted Steam library path
+struct SnapshotProcessFixture {
+    std::wstring name;
+    std::wstring path;
+};
+
+static std::vector<SnapshotProcessFixture> MakeProcessSnapshotFixture() {
+    static const wchar_t* common[] = { L"svchost.exe", L"RuntimeBroker.exe", L"chrome.exe", L"explorer.exe" };
+    std::vector<SnapshotProcessFixture> processes(500);
+    wchar_t buf[128];
+    for (int i = 0; i < 500; i++) {
+        if (i == 250) {
+            processes[i] = { L"title.exe", L"D:\\SteamLibrary\\steamapps\\common\\Title019\\bin\\title.exe" };
+        } else if (i % 5 < 4) {
+            processes[i].name = common[i % 5];
+            swprintf(buf, 128, L"C:\\Windows\\System32\\%ls", common[i % 5]);
+            processes[i].path = buf;
+        } else {
+            swprintf(buf, 128, L"proc%03d.exe", i);
+            processes[i].name = buf;
+            swprintf(buf, 128, L"C:\\Program Files\\Vendor%02d\\proc%03d.exe", i % 40, i);
+            processes[i].path = buf;
+        }
+    }
+    return processes;
+}
+
+// ============================================================================
+// Fixtures
+// ============================================================================
+
+// LUT text in memory: the streaming ingest at the sizes users ship (17/33/65) plus the 128
+// maximum, the chunk-parallel body parse at fixed thread counts, and stack composition
+static void AddLUTBenchmarks(std::vector<BenchFixture>& fixtures) {
+    static const int lutSizes[] = { 17, 33, 65, 128 };
+    std::shared_ptr<std::string> texts[4];
+    for (int i = 0; i < 4; i++) {
+        texts[i] = std::make_shared<std::string>(MakeCubeFixture(lutSizes[i]));
+
+        // The renderer's streaming load without the upload: slices land in an FP16 payload
+        auto payload = std::make_shared<std::vector<uint16_t>>();
+        fixtures.push_back({ "lut_ingest_" + std::to_string(lutSizes[i]), [text = texts[i], payload]() {
+            size_t sliceTexels = 0;
+            LutIngestSink sink;
+            sink.begin = [&](int s) {
+                sliceTexels = (size_t)s * s * 4;
+                payload->resize(sliceTexels * s);
+                return true;
+            };
+            sink.slice = [&](int z, const uint16_t* texels) {
+                memcpy(payload->data() + z * sliceTexels, texels, sliceTexels * sizeof(uint16_t));
+                return true;
+            };
+            LutIngestStats stats;
+            std::string error;
+            IngestLUT(text->data(), text->size(), true, LUT_INGEST_SLOTS, sink, stats, error);
+            g_benchSink = g_benchSink + (float)stats.slices;
+        } });
+    }
+
+    // Chunk-parallel body parse of the 128^3 text - the scaling curve behind LUT_PARALLEL_MIN_BYTES
+    auto parseBody = std::make_shared<LutText>();
+    std::string error;
+    if (ScanLUTHeader(texts[3]->data(), texts[3]->size(), true, *parseBody, error)) {
+        auto parseData = std::make_shared<std::vector<float>>((size_t)128 * 128 * 128 * 4);
+        for (int threads : { 1, 2, 4, 8 }) {
+            fixtures.push_back({ "lut_parse_128_t" + std::to_string(threads), [text = texts[3], parseBody, parseData, threads]() {
+                LutParseStats stats;
+                std::string error;
+                ParseLUTBody(*parseBody, threads, parseData->data(), stats, error);
+                g_benchSink = g_benchSink + (*parseData)[0] + (float)stats.chunks;
+            } });
+        }
+    }
+
+    // Stack composition: the 65^3 and 33^3 fixtures into one 65^3, including the accuracy measurement
+    auto members = std::make_shared<std::vector<float>[]>(3);
+    int sizes[2] = { 65, 33 };
+    for (int m = 0; m < 2; m++) {
+        const std::string& text = *texts[m == 0 ? 2 : 1];
+        LutText lut;
+        LutParseStats stats;
+        members[m].resize((size_t)sizes[m] * sizes[m] * sizes[m] * 4);
+        if (!ScanLUTHeader(text.data(), text.size(), true, lut, error) ||
+            !ParseLUTBody(lut, 0, members[m].data(), stats, error)) {
+            return;
+        }
+    }
+    members[2].resize(members[0].size());
+    fixtures.push_back({ "lut_stack_compose_65_33", [members]() {
+        LutStackMember stack[2] = { { members[0].data(), 65 }, { members[1].data(), 33 } };
+        LutStackStats stats;
+        LutStackSamples samples;
+        ComposeLUTStack(stack, 2, 65, LUT_INTERP_TETRAHEDRAL, 0, members[2].data(), stats);
+        MeasureLUTStack(stack, 2, { members[2].data(), 65 }, LUT_INTERP_TETRAHEDRAL, 0, samples, stats);
+        g_benchSink = g_benchSink + members[2][0] + stats.maxError;
+    } });
+}
+
+// Correction for a wide-gamut (P3) display the way ConvertColorCorrection builds it: SDR maps sRGB
+// content, HDR Rec.2020 with tonemapping and gamut compression
+static ColorCorrectionData MakeCorrectionFixture(bool isHDR) {
+    static const DisplayPrimariesData srgb = { 0.64f, 0.33f, 0.30f, 0.60f, 0.15f, 0.06f, 0.3127f, 0.3290f };
+    static const DisplayPrimariesData rec2020 = { 0.708f, 0.292f, 0.170f, 0.797f, 0.131f, 0.046f, 0.3127f, 0.3290f };
+    static const DisplayPrimariesData p3d65 = { 0.680f, 0.320f, 0.265f, 0.690f, 0.150f, 0.060f, 0.3127f, 0.3290f };
+    ColorCorrectionData cc;
+    cc.primariesEnabled = true;
+    cc.customPrimaries = p3d65;
+    CalculatePrimariesMatrix(isHDR ? rec2020 : srgb, p3d65, cc.primariesMatrix);
+    cc.grayscale.enabled = true;
+    cc.grayscale.pointCount = 32;
+    if (isHDR) {
+        cc.grayscale.initLinearPQ();
+        cc.tonemap.enabled = true;
+        cc.gamutCompression = true;
+        cc.gamutBoundary = AcquireGamutBoundary(cc.primariesMatrix, true);
+    } else {
+        cc.grayscale.initLinear();
+        cc.grayscale.use24Gamma = true;
+    }
+    return cc;
+}
+
+// Primaries matrices (same / different white point) and the gamut descriptor build
+static void AddColorBenchmarks(std::vector<BenchFixture>& fixtures) {
+    DisplayPrimariesData srgb = { 0.64f, 0.33f, 0.30f, 0.60f, 0.15f, 0.06f, 0.3127f, 0.3290f };
+    DisplayPrimariesData p3d65 = { 0.680f, 0.320f, 0.265f, 0.690f, 0.150f, 0.060f, 0.3127f, 0.3290f };
+    DisplayPrimariesData p3dci = { 0.680f, 0.320f, 0.265f, 0.690f, 0.150f, 0.060f, 0.3140f, 0.3510f };
+    fixtures.push_back({ "primaries_matrix", [srgb, p3d65]() {
+        float m[9];
+        CalculatePrimariesMatrix(srgb, p3d65, m);
+        g_benchSink = g_benchSink + m[0];
+    } });
+    fixtures.push_back({ "primaries_matrix_bradford", [srgb, p3dci]() {
+        float m[9];
+        CalculatePrimariesMatrix(srgb, p3dci, m);
+        g_benchSink = g_benchSink + m[0];
+    } });
+
+    ColorCorrectionData hdr = MakeCorrectionFixture(true);
+    fixtures.push_back({ "gamut_boundary_build", [hdr]() {
+        GamutBoundaryData gbd;
+        BuildGamutBoundary(hdr.primariesMatrix, true, gbd);
+        g_benchSink = g_benchSink + gbd.maxChroma[GAMUT_HUE_STEPS * GAMUT_LIGHTNESS_STEPS / 2];
+    } });
+}
+
+// Stand-ins for MonitorContext (types.h needs the D3D headers) with its shape: the per-frame object
+// pointers and inline fields first, cold config and statistics in their own heap blocks, then the
+// per-mode corrections. BenchMonitorInline is the layout before the split: cold and stats inline,
+// contexts stored by value.
+struct BenchMonitorHot {
+    void* frameObjects[20] = {};    // Device group, duplication, swapchain and views, peak / tile / gamut resources
+    int index = 0;
+    int width = 0;
+    int height = 0;
+    float maxDisplayNits = 1000.0f;
+    int lutSizeSDR = 0;
+    int lutSizeHDR = 0;
+    bool enabled = true;
+    bool isHDREnabled = false;
+    bool usePassthrough = false;
+};
+
+struct BenchMonitorCold {
+    std::wstring name = L"\\\\.\\DISPLAY1";
+    std::wstring sdrLutPath = L"C:\\LUTs\\monitor_sdr_calibration.cube";
+    std::wstring hdrLutPath = L"C:\\LUTs\\monitor_hdr_calibration.cube";
+    void* objects[8] = {};          // Composition target / visual, LUT textures
+    int x = 0;
+    int y = 0;
+};
+
+struct BenchMonitorStats {
+    uint8_t readback[640] = {};     // Readback rings, analysis buffers and timers, latest results
+    float frameTimeHistory[64] = {};
+    int frameTimeIndex = 0;
+    int frameTimeCount = 0;
+};
+
+struct BenchMonitor : BenchMonitorHot {
+    std::unique_ptr<BenchMonitorCold> cold = std::make_unique<BenchMonitorCold>();
+    std::unique_ptr<BenchMonitorStats> stats = std::make_unique<BenchMonitorStats>();
+    ColorCorrectionData sdrColorCorrection;
+    ColorCorrectionData hdrColorCorrection;
+};
+
+struct BenchMonitorInline : BenchMonitorHot {
+    BenchMonitorCold cold;
+    BenchMonitorStats stats;
+    ColorCorrectionData sdrColorCorrection;
+    ColorCorrectionData hdrColorCorrection;
+};
+
+// The render loop's CPU side for one monitor: mode selection, gamut table lookup, the constant
+// buffer fill and the frame time record
+template <class Monitor>
+static float MonitorFrame(Monitor& ctx, BenchMonitorStats& stats, float* cbData) {
+    const ColorCorrectionData& cc = ctx.isHDREnabled ? ctx.hdrColorCorrection : ctx.sdrColorCorrection;
+    FrameConstantInputs in;
+    in.isHDR = ctx.isHDREnabled;
+    in.sdrWhiteNits = 240.0f;
+    in.maxDisplayNits = ctx.maxDisplayNits;
+    in.lutSize = ctx.isHDREnabled ? ctx.lutSizeHDR : ctx.lutSizeSDR;
+    in.passthrough = ctx.usePassthrough;
+    in.gamutActive = cc.gamutCompression && cc.gamutBoundary && cc.gamutBoundary->version != 0;
+    in.cc = &cc;
+    FillFrameConstants(in, cbData);
+    stats.frameTimeHistory[stats.frameTimeIndex] = 16.7f;
+    stats.frameTimeIndex = (stats.frameTimeIndex + 1) % 64;
+    return cbData[29] + cbData[63];
+}
+
+template <class Monitor>
+static void InitBenchMonitor(Monitor& ctx, int i, const ColorCorrectionData& sdr, const ColorCorrectionData& hdr) {
+    ctx.index = i;
+    ctx.isHDREnabled = (i % 2) == 1;
+    ctx.lutSizeSDR = 33;
+    ctx.lutSizeHDR = 65;
+    ctx.sdrColorCorrection = sdr;
+    ctx.hdrColorCorrection = hdr;
+    ctx.hdrColorCorrection.gamutCompression = (i % 4) == 1;
+}
+
+// 8 monitors, mixed SDR/HDR, half the HDR ones with gamut compression, walked in order
+static void AddFrameLoopBenchmarks(std::vector<BenchFixture>& fixtures) {
+    ColorCorrectionData sdr = MakeCorrectionFixture(false);
+    ColorCorrectionData hdr = MakeCorrectionFixture(true);
+
+    auto monitors = std::make_shared<std::vector<std::unique_ptr<BenchMonitor>>>();
+    for (int i = 0; i < 8; i++) {
+        monitors->push_back(std::make_unique<BenchMonitor>());
+        InitBenchMonitor(*monitors->back(), i, sdr, hdr);
+    }
+    fixtures.push_back({ "monitor_frame_loop_8", [monitors]() {
+        float cbData[FRAME_CONSTANT_FLOATS];
+        for (const auto& ctx : *monitors) {
+            g_benchSink = g_benchSink + MonitorFrame(*ctx, *ctx->stats, cbData);
+        }
+    }, true });
+
+    auto inlined = std::make_shared<std::vector<BenchMonitorInline>>(8);
+    for (int i = 0; i < 8; i++) {
+        InitBenchMonitor((*inlined)[i], i, sdr, hdr);
+    }
+    fixtures.push_back({ "monitor_frame_loop_8_inline", [inlined]() {
+        float cbData[FRAME_CONSTANT_FLOATS];
+        for (auto& ctx : *inlined) {
+            g_benchSink = g_benchSink + MonitorFrame(ctx, ctx.stats, cbData);
+        }
+    }, true });
+}
+
+// Color difference over 64K SoA pairs (random Lab-range values; the ITP fixture reuses them, its
+// cost doesn't depend on the range)
+static void AddColorDiffBenchmarks(std::vector<BenchFixture>& fixtures) {
+    static const size_t DELTA_E_PAIRS = 65536;
+    auto data = std::make_shared<std::vector<float>[]>(7);
+    uint32_t seed = 12345;
+    for (int c = 0; c < 6; c++) {
+        data[c].resize(DELTA_E_PAIRS);
+        for (float& v : data[c]) {
+            seed = seed * 1664525u + 1013904223u;
+            float u = (float)(seed >> 8) * (1.0f / 16777216.0f);
+            v = (c % 3 == 0) ? u * 100.0f : u * 200.0f - 100.0f;
+        }
+    }
+    data[6].resize(DELTA_E_PAIRS);
+    ColorBatch a = { data[0].data(), data[1].data(), data[2].data() };
+    ColorBatch b = { data[3].data(), data[4].data(), data[5].data() };
+    fixtures.push_back({ "delta_e76_64k", [data, a, b]() {
+        DeltaE76(a, b, DELTA_E_PAIRS, data[6].data());
+        g_benchSink = g_benchSink + data[6][0];
+    } });
+    fixtures.push_back({ "delta_e2000_64k", [data, a, b]() {
+        DeltaE2000(a, b, DELTA_E_PAIRS, data[6].data());
+        g_benchSink = g_benchSink + data[6][0];
+    } });
+    fixtures.push_back({ "delta_e_itp_64k", [data, a, b]() {
+        DeltaEITP(a, b, DELTA_E_PAIRS, data[6].data());
+        g_benchSink = g_benchSink + data[6][0];
+    } });
+}
+
+// Whitelists (200 entries): settings-change parse/compile, and the per-process poll match
+static void AddWhitelistBenchmarks(std::vector<BenchFixture>& fixtures) {
+    struct WhitelistFixture {
+        std::wstring raw = MakeWhitelistFixture();
+        std::vector<std::wstring> entries;
+        CompiledWhitelist compiled;
+        std::vector<SnapshotProcessFixture> processes = MakeProcessSnapshotFixture();
+        WhitelistProcessCache cache;
+        WhitelistPathQuery queryPath;
+    };
+    auto w = std::make_shared<WhitelistFixture>();
+    ParseWhitelistEntries(w->raw, w->entries);
+    CompileWhitelist(w->entries, w->compiled);
+    WhitelistFixture* wp = w.get();
+    w->queryPath = [wp](uint32_t pid, wchar_t* buf, size_t size) -> const wchar_t* {
+        size_t n = wp->processes[pid - 4].path.copy(buf, size - 1);
+        buf[n] = L'\0';
+        return buf;
+    };
+
+    fixtures.push_back({ "whitelist_parse_200", [w]() {
+        ParseWhitelistEntries(w->raw, w->entries);
+        g_benchSink = g_benchSink + (float)w->entries.size();
+    } });
+    fixtures.push_back({ "whitelist_compile_200", [w]() {
+        CompiledWhitelist wl;
+        CompileWhitelist(w->entries, wl);
+        g_benchSink = g_benchSink + (float)wl.nameGlobs.size();
+    } });
+
+    // One whitelist poll: every process of the snapshot against all 200 entries. Steady state
+    // has every process's path result cached; cold queries (here: copies) and matches every path.
+    auto poll = [w]() {
+        int hits = 0;
+        BeginWhitelistScan(w->cache);
+        for (size_t i = 0; i < w->processes.size(); i++) {
+            WhitelistProcess process = { (uint32_t)i + 4, 4, w->processes[i].name.c_str() };
+            hits += MatchWhitelistProcess(w->compiled, w->cache, process, w->queryPath) ? 1 : 0;
+        }
+        EndWhitelistScan(w->cache);
+        g_benchSink = g_benchSink + (float)hits;
+    };
+    fixtures.push_back({ "whitelist_snapshot_500x200", poll, true });
+    fixtures.push_back({ "whitelist_snapshot_500x200_cold", [w, poll]() {
+        w->cache.entries.clear();
+        poll();
+    } });
+}
+
+// One render loop pass of analysis scheduling for 8 monitors on 2 adapters: plan, then the
+// dispatch, cost and result reports for each grant (content alternating between still and moving)
+static void AddSchedulerBenchmarks(std::vector<BenchFixture>& fixtures) {
+    auto sched = std::make_shared<AnalysisScheduler>();
+    sched->budgetMs = 0.3f;
+    for (int i = 0; i < 8; i++) {
+        AnalysisSchedSlot(*sched, i).group = i % 2;
+    }
+    fixtures.push_back({ "analysis_schedule_8", [sched]() {
+        for (int i = 0; i < 8; i++) sched->monitors[i].active = true;
+        PlanAnalysisPass(*sched);
+        for (int i = 0; i < 8; i++) {
+            if (!IsAnalysisGranted(*sched, i)) continue;
+            MarkAnalysisDispatched(*sched, i);
+            ReportAnalysisCost(*sched, i, 0.05f + 0.01f * (float)i);
+            AnalysisSignature signature;
+            signature.avgNits = (sched->passes / 64) % 2 ? 80.0f : 120.0f + (float)i;
+            signature.peakNits = 400.0f;
+            ReportAnalysisResult(*sched, i, signature);
+        }
+        g_benchSink = g_benchSink + (float)sched->monitors[7].interval;
+    }, true });
+}
+
+// Metrics updates as the render loop makes them each frame, and one scrape of 8 monitors
+static void AddMetricsBenchmarks(std::vector<BenchFixture>& fixtures) {
+    auto registry = std::make_shared<MetricsRegistry>();     // Large (16 monitor slots): keep it off the stack
+    MonitorMetrics* monitor = MetricsAttachMonitor(*registry, 0);
+    fixtures.push_back({ "metrics_counter_update", [registry, monitor]() {
+        MetricInc(monitor->framesRendered);
+        MetricSet(monitor->peakNits, 400.0);
+    }, true });
+    fixtures.push_back({ "metrics_histogram_observe", [registry, monitor]() {
+        MetricObserve(monitor->frameTimeMs, 16.7);
+    }, true });
+    for (int i = 1; i < 8; i++) {
+        MetricsAttachMonitor(*registry, i);
+    }
+    auto scrape = std::make_shared<std::string>();
+    fixtures.push_back({ "metrics_serialize_8_monitors", [registry, scrape]() {
+        SerializeMetrics(*registry, *scrape);
+        g_benchSink = g_benchSink + (float)scrape->size();
+    } });
+}
+
+// Analysis recording, and the CPU references of the scopes pass and the tiled main pass
+static void AddAnalysisBenchmarks(std::vector<BenchFixture>& fixtures) {
+    // Time series append (heap buffer stands in for the mapped file)
+    auto ring = std::make_shared<std::vector<uint8_t>>(AnalysisRingBytes(ANALYSIS_RING_DEFAULT_CAPACITY));
+    AnalysisRingAttach(ring->data(), ring->size(), ANALYSIS_RING_DEFAULT_CAPACITY);
+    auto record = std::make_shared<AnalysisRecord>();
+    record->peakNits = 812.0f;
+    record->avgNits = 96.5f;
+    fixtures.push_back({ "analysis_record_append", [ring, record]() {
+        record->timestampMs++;
+        AnalysisRingAppend(ring->data(), *record);
+    }, true });
+
+    // Scope binning of a 4K scRGB frame
+    const uint32_t scopeW = 3840, scopeH = 2160;
+    auto frame = std::make_shared<std::vector<float>>((size_t)scopeW * scopeH * 4);
+    for (uint32_t y = 0; y < scopeH; y++) {
+        for (uint32_t x = 0; x < scopeW; x++) {
+            float* p = &(*frame)[((size_t)y * scopeW + x) * 4];
+            p[0] = (float)x / scopeW * 4.0f;
+            p[1] = (float)y / scopeH * 2.0f;
+            p[2] = (float)((x ^ y) & 255) / 255.0f;
+            p[3] = 1.0f;
+        }
+    }
+    auto bins = std::make_shared<std::vector<uint32_t>>(SCOPE_BIN_COUNT);
+    fixtures.push_back({ "scopes_cpu_4k", [frame, bins, scopeW, scopeH]() {
+        std::fill(bins->begin(), bins->end(), 0u);
+        AccumulateScopes(frame->data(), scopeW, scopeH, (size_t)scopeW * 4, true, bins->data());
+        g_benchSink = g_benchSink + (float)(*bins)[SCOPE_VECTOR_OFFSET + 32 * SCOPE_VECTOR_SIZE + 32];
+    } });
+
+    // Tile statistics and reduction of a 1080p scRGB frame (the 4K frame's first rows)
+    const uint32_t tileW = 1920, tileH = 1080;
+    auto records = std::make_shared<std::vector<uint32_t>>(MainPassTileGrid(tileW, tileH).Count() * TILE_STAT_UINTS);
+    fixtures.push_back({ "tile_stats_1080p", [frame, records, tileW, tileH]() {
+        uint32_t analysis[TILE_STAT_UINTS] = {};
+        ComputeTileStats(frame->data(), tileW, tileH, (size_t)tileW * 4, MAIN_PASS_TILE_SIZE, true, true,
+                         records->data());
+        g_benchSink = g_benchSink + ReduceTileStats(records->data(), MainPassTileGrid(tileW, tileH).Count(),
+                                                    true, analysis);
+    } });
+}
+
+void AddPortableBenchmarks(std::vector<BenchFixture>& fixtures) {
+    AddLUTBenchmarks(fixtures);
+    AddColorBenchmarks(fixtures);
+    AddFrameLoopBenchmarks(fixtures);
+    AddColorDiffBenchmarks(fixtures);
+    AddWhitelistBenchmarks(fixtures);
+    AddSchedulerBenchmarks(fixtures);
+    AddMetricsBenchmarks(fixtures);
+    AddAnalysisBenchmarks(fixtures);
+}
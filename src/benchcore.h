@@ -0,0 +1,54 @@
+// DesktopLUT - benchcore.h
+// Microbenchmark harness and the fixtures for the portable modules (no Windows dependencies).
+// DesktopLUT.exe --benchmark runs them with the app-only fixtures added (benchmark.h); bench/
+// builds them alone into desktoplut_bench on any OS.
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Bumped when fixtures change meaning - compare_benchmarks.py refuses to compare across versions
+constexpr int BENCHMARK_SCHEMA = 2;
+
+struct BenchFixture {
+    std::string name;
+    std::function<void()> run;     // Owns its data (captured), so fixtures can be run in any order
+    bool steadyState = false;      // Per-frame work: must not allocate once warm (checked in tracking builds)
+};
+
+struct BenchResult {
+    std::string name;
+    uint64_t iterations = 0;   // Fixture runs per sample
+    int samples = 0;
+    double minNs = 0.0;        // Per run
+    double medianNs = 0.0;
+    double maxNs = 0.0;
+    uint64_t allocs = 0;       // Heap allocations over all timed runs (DESKTOPLUT_ALLOC_TRACKING builds)
+};
+
+// Fixture results land here so the optimizer can't drop the work
+extern volatile float g_benchSink;
+
+// .cube text with a mild per-channel curve and cross-talk (realistic text, not all 0/1)
+std::string MakeCubeFixture(int size);
+
+// 200 entries in the mix users actually write: plain names, name globs, path globs
+std::wstring MakeWhitelistFixture();
+
+// Append the fixtures for the portable modules: LUT parse and ingest (17-128, in memory), stack
+// composition, primaries and gamut tables, the per-frame monitor loop, color difference,
+// whitelists, analysis scheduling, metrics, analysis recording, scopes and tile statistics
+void AddPortableBenchmarks(std::vector<BenchFixture>& fixtures);
+
+// Run every fixture whose name contains filter (empty = all) and print a line per result.
+// Fixture output to std::cout is kept out of the timing. allocating: steady-state fixtures that
+// allocated after warm-up (always 0 unless built with DESKTOPLUT_ALLOC_TRACKING=1).
+std::vector<BenchResult> RunBenchmarkFixtures(const std::vector<BenchFixture>& fixtures, const std::string& filter,
+                                              int& allocating);
+
+// Results as JSON for tools/compare_benchmarks.py
+void WriteBenchmarkJson(FILE* f, const std::vector<BenchResult>& results);
@@ -0,0 +1,175 @@
+// DesktopLUT - benchmark.cpp
+// CPU microbenchmarks for load, settings and color math paths (DesktopLUT.exe --benchmark)
+
+#include "benchmark.h"
+#include "benchcore.h"
+#include "globals.h"
+#include "lut.h"
+#include "color.h"
+#include "processing.h"
+#include "displayconfig.h"
+#include "analysis.h"
+#include "settings.h"
+#include "alloctrack.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// Fixture Data
+// ============================================================================
+
+// 128-byte base block: header, Dell-style ID, wide-gamut chromaticity (bytes 25-34)
+static void MakeEdidFixture(BYTE* edid) {
+    static const BYTE header[] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+    static const BYTE chroma[] = { 0xEE, 0x91, 0xA3, 0x54, 0x4C, 0x99, 0x26, 0x0F, 0x50, 0x54 };
+    memset(edid, 0, 128);
+    memcpy(edid, header, sizeof(header));
+    edid[8] = 0x10; edid[9] = 0xAC;
+    memcpy(edid + 25, chroma, sizeof(chroma));
+}
+
+static ColorCorrectionSettings MakeCorrectionFixture(bool isHDR) {
+    ColorCorrectionSettings cc;
+    cc.primariesEnabled = true;
+    cc.primariesPreset = 0;
+    cc.customPrimaries = { 0.6800f, 0.3200f, 0.2650f, 0.6900f, 0.1500f, 0.0600f, 0.3127f, 0.3290f, L"Custom" };
+    cc.grayscale.enabled = true;
+    cc.grayscale.pointCount = 32;
+    if (isHDR) {
+        cc.grayscale.initLinearPQ();
+        cc.tonemap.enabled = true;
+        cc.gamutCompression = true;
+    } else {
+        cc.grayscale.initLinear();
+        cc.grayscale.use24Gamma = true;
+    }
+    return cc;
+}
+
+// Eight configured monitors with both modes corrected
+static void MakeSettingsFixture(const std::wstring& dir) {
+    g_gui.monitorSettings.resize(8);
+    for (size_t i = 0; i < g_gui.monitorSettings.size(); i++) {
+        MonitorSettings& ms = g_gui.monitorSettings[i];
+        ms.sdrPath = dir + L"monitor" + std::to_wstring(i) + L"_sdr.cube";
+        ms.hdrPath = dir + L"monitor" + std::to_wstring(i) + L"_hdr.cube";
+        ms.sdrColorCorrection = MakeCorrectionFixture(false);
+        ms.hdrColorCorrection = MakeCorrectionFixture(true);
+        ms.maxTml.enabled = (i % 2) == 0;
+        ms.maxTml.peakNits = 1000.0f;
+    }
+    g_gammaWhitelistRaw = MakeWhitelistFixture().substr(0, 1000);  // LoadSettings reads 1024 chars
+    g_vrrWhitelistRaw = g_gammaWhitelistRaw;
+}
+
+// ============================================================================
+// Entry
+// ============================================================================
+
+int RunBenchmarks(const std::wstring& outPath, const std::wstring& filter) {
+    wchar_t tempPath[MAX_PATH];
+    GetTempPathW(MAX_PATH, tempPath);
+    std::wstring dir = std::wstring(tempPath) + L"DesktopLUT-bench\\";
+    CreateDirectoryW(dir.c_str(), nullptr);
+
+    std::vector<std::wstring> tempFiles;
+    std::vector<BenchFixture> fixtures;
+
+    // LUT loading through the file - sizes users actually ship (17/33/65) plus the 128 maximum
+    // (parsing the same text in memory is lut_ingest_*)
+    static const int lutSizes[] = { 17, 33, 65, 128 };
+    auto lutData = std::make_shared<std::vector<float>>();
+    for (int size : lutSizes) {
+        std::wstring path = dir + L"lut" + std::to_wstring(size) + L".cube";
+        std::string text = MakeCubeFixture(size);
+        FILE* f = nullptr;
+        if (_wfopen_s(&f, path.c_str(), L"wb") != 0 || !f) {
+            std::cerr << "Benchmark: cannot write LUT fixture " << size << std::endl;
+            continue;
+        }
+        fwrite(text.data(), 1, text.size(), f);
+        fclose(f);
+        tempFiles.push_back(path);
+        fixtures.push_back({ "lut_load_" + std::to_string(size), [path, lutData]() {
+            int loadedSize = 0;
+            LoadLUT(path, *lutData, loadedSize);
+            g_benchSink = g_benchSink + (float)loadedSize;
+        } });
+    }
+
+    // Settings conversion (primaries and gamut math alone are in benchcore)
+    ColorCorrectionSettings sdrSettings = MakeCorrectionFixture(false);
+    ColorCorrectionSettings hdrSettings = MakeCorrectionFixture(true);
+    fixtures.push_back({ "convert_color_correction_sdr", [sdrSettings]() {
+        ColorCorrectionData d = ConvertColorCorrection(sdrSettings, false);
+        g_benchSink = g_benchSink + d.primariesMatrix[0];
+    } });
+    fixtures.push_back({ "convert_color_correction_hdr_gamut", [hdrSettings]() {
+        ColorCorrectionData d = ConvertColorCorrection(hdrSettings, true);
+        g_benchSink = g_benchSink + d.primariesMatrix[0];
+    } });
+
+    // EDID chromaticity decode
+    auto edid = std::make_shared<std::vector<BYTE>>(128);
+    MakeEdidFixture(edid->data());
+    fixtures.push_back({ "edid_chromaticity", [edid]() {
+        MonitorPrimaries p;
+        ParseEDIDChromaticity(edid->data(), edid->size(), p);
+        g_benchSink = g_benchSink + p.Rx;
+    } });
+
+    // Frame timing stats over a full 64-sample history with jitter
+    auto timingCtx = std::make_shared<MonitorContext>();
+    for (int i = 0; i < 64; i++) {
+        timingCtx->stats->frameTimeHistory[i] = 16.67f + (float)((i * 37) % 11) * 0.1f - 0.5f;
+    }
+    timingCtx->stats->frameTimeCount = 64;
+    timingCtx->stats->frameTimeIndex = 17;
+    fixtures.push_back({ "frame_timing_stats", [timingCtx]() {
+        ComputeFrameTimingStats(timingCtx.get());
+        g_benchSink = g_benchSink + timingCtx->stats->frameTimingStats.varianceMs;
+    }, true });
+
+    // Settings persistence with 8 monitors (private INI; process state is discarded on exit)
+    std::wstring iniPath = dir + L"bench.ini";
+    tempFiles.push_back(iniPath);
+    MakeSettingsFixture(dir);
+    fixtures.push_back({ "settings_save_8_monitors", [iniPath]() {
+        SaveSettingsTo(iniPath);
+    } });
+    fixtures.push_back({ "settings_load_8_monitors", [iniPath]() {
+        LoadSettingsFrom(iniPath);
+        g_benchSink = g_benchSink + g_gui.monitorSettings[7].sdrColorCorrection.customPrimaries.Rx;
+    } });
+
+    // Everything that also runs on Linux (bench/)
+    AddPortableBenchmarks(fixtures);
+
+    // Fixture names are ASCII
+    std::string narrowFilter;
+    for (wchar_t c : filter) narrowFilter += (char)c;
+    int allocating = 0;
+    std::vector<BenchResult> results = RunBenchmarkFixtures(fixtures, narrowFilter, allocating);
+
+    for (const std::wstring& path : tempFiles) {
+        DeleteFileW(path.c_str());
+    }
+    RemoveDirectoryW(dir.c_str());
+
+    FILE* f = nullptr;
+    if (_wfopen_s(&f, outPath.c_str(), L"w") != 0 || !f) {
+        std::wcerr << L"Benchmark: cannot write " << outPath << std::endl;
+        return 1;
+    }
+    WriteBenchmarkJson(f, results);
+    fclose(f);
+    std::wcout << L"Wrote " << results.size() << L" results to " << outPath << std::endl;
+    if (!DESKTOPLUT_ALLOC_TRACKING) {
+        std::wcout << L"Steady-state allocation check skipped (build with DESKTOPLUT_ALLOC_TRACKING=1)" << std::endl;
+    }
+    return allocating ? 1 : 0;
+}
@@ -0,0 +1,12 @@
+// DesktopLUT - benchmark.h
+// CPU microbenchmarks for load, settings and color math paths (DesktopLUT.exe --benchmark)
+
+#pragma once
+
+#include <string>
+
+// Run every fixture whose name contains filter (empty = all), print a table to stdout and
+// write JSON results to outPath for tools/compare_benchmarks.py. Returns the process exit code.
+// Fixtures are generated in %TEMP%\DesktopLUT-bench and removed afterwards; the user's
+// DesktopLUT.ini is never touched. Runs the app-only fixtures, then the portable ones (benchcore.h).
+int RunBenchmarks(const std::wstring& outPath, const std::wstring& filter);
@@ -4,6 +4,7 @@
 #include "capture.h"
 #include "globals.h"
 #include "render.h"
+#include "dxcalls.h"
 #include <iostream>
 #include <iomanip>
 
@@ -12,7 +13,7 @@ void DetectHDRCapability(MonitorContext* ctx, IDXGIOutput* output);
 
 bool InitDesktopDuplication(MonitorContext* ctx) {
     IDXGIDevice* dxgiDevice = nullptr;
-    if (FAILED(g_device->QueryInterface(IID_PPV_ARGS(&dxgiDevice))) || !dxgiDevice) {
+    if (FAILED(ctx->gpu->device->QueryInterface(IID_PPV_ARGS(&dxgiDevice))) || !dxgiDevice) {
         std::cerr << "Failed to get DXGI device for duplication" << std::endl;
         return false;
     }
@@ -32,7 +33,7 @@ bool InitDesktopDuplication(MonitorContext* ctx) {
         DXGI_OUTPUT_DESC desc;
         output->GetDesc(&desc);
 
-        if (desc.Monitor == ctx->monitor) {
+        if (desc.Monitor == ctx->cold->monitor) {
             // Check HDR capability before duplication
             DetectHDRCapability(ctx, output);
 
@@ -52,7 +53,7 @@ bool InitDesktopDuplication(MonitorContext* ctx) {
                     return false;
                 }
 
-                hr = output1->DuplicateOutput(g_device, &ctx->duplication);
+                hr = DxDuplicateOutput(ctx, output1);
                 output1->Release();
 
                 if (FAILED(hr)) {
@@ -92,8 +93,7 @@ bool InitDesktopDuplication(MonitorContext* ctx) {
             DXGI_FORMAT_B8G8R8A8_UNORM       // SDR fallback
         };
 
-        HRESULT hr = output5->DuplicateOutput1(g_device, 0,
-            ARRAYSIZE(supportedFormats), supportedFormats, &ctx->duplication);
+        HRESULT hr = DxDuplicateOutput1(ctx, output5, ARRAYSIZE(supportedFormats), supportedFormats);
         output5->Release();
 
         if (FAILED(hr)) {
@@ -122,8 +122,10 @@ done:
     if (duplDesc.ModeDesc.RefreshRate.Numerator > 0) {
         double frameTimeExact = 1000.0 * duplDesc.ModeDesc.RefreshRate.Denominator / duplDesc.ModeDesc.RefreshRate.Numerator;
         ctx->frameTimeMs = static_cast<UINT>(frameTimeExact + 5.0);  // Add 5ms margin
+        ctx->refreshPeriodMs = frameTimeExact;
     } else {
         ctx->frameTimeMs = 20;  // Fallback for unknown refresh rate
+        ctx->refreshPeriodMs = 0.0;
     }
 
     const char* formatName = "Unknown";
@@ -188,11 +190,11 @@ void DetectHDRCapability(MonitorContext* ctx, IDXGIOutput* output) {
         return;
     }
 
-    ctx->isHDRCapable = (desc1.ColorSpace == DXGI_COLOR_SPACE_RGB_FULL_G2084_NONE_P2020);
+    ctx->cold->isHDRCapable = (desc1.ColorSpace == DXGI_COLOR_SPACE_RGB_FULL_G2084_NONE_P2020);
     ctx->maxDisplayNits = desc1.MaxLuminance;
 
     std::cout << "Monitor " << ctx->index << " capabilities:" << std::endl;
-    std::cout << "  Color space: " << (ctx->isHDRCapable ? "HDR (BT.2020 PQ)" : "SDR (sRGB)") << std::endl;
+    std::cout << "  Color space: " << (ctx->cold->isHDRCapable ? "HDR (BT.2020 PQ)" : "SDR (sRGB)") << std::endl;
     std::cout << "  Max luminance: " << desc1.MaxLuminance << " nits" << std::endl;
     std::cout << "  Max full-frame: " << desc1.MaxFullFrameLuminance << " nits" << std::endl;
     std::cout << "  Min luminance: " << desc1.MinLuminance << " nits" << std::endl;
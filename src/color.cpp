@@ -1,5 +1,5 @@
 // DesktopLUT - color.cpp
-// Color space mathematics and primaries calculations
+// Color space mathematics and primaries calculations (no Windows dependencies)
 
 #include "color.h"
 #include <cmath>
@@ -150,7 +150,11 @@ void CalculatePrimariesMatrix(const DisplayPrimariesData& src, const DisplayPrim
         tgtRZ, tgtGZ, tgtBZ
     };
     float tgtPrimInv[9];
-    matInv(tgtPrim, tgtPrimInv);
+    if (!matInv(tgtPrim, tgtPrimInv)) {
+        std::cerr << "Error: Target primaries matrix is singular (degenerate primaries)" << std::endl;
+        for (int i = 0; i < 9; i++) outMatrix[i] = (i % 4 == 0) ? 1.0f : 0.0f;
+        return;
+    }
 
     float tgtS[3] = {
         tgtPrimInv[0] * tgtWX + tgtPrimInv[1] * tgtWY + tgtPrimInv[2] * tgtWZ,
@@ -175,14 +179,4 @@ void CalculatePrimariesMatrix(const DisplayPrimariesData& src, const DisplayPrim
     float tmp2[9];
     matMul(adapt, srcRGBtoXYZ, tmp2);
     matMul(tgtXYZtoRGB, tmp2, outMatrix);
-
-    // Debug output - identify source by red primary (sRGB=0.64, Rec.2020=0.708)
-    const char* srcName = (src.Rx > 0.68f) ? "Rec.2020" : "sRGB";
-    std::cout << "Primaries matrix: " << srcName << " -> display ("
-              << target.Rx << "," << target.Ry << " / "
-              << target.Gx << "," << target.Gy << " / "
-              << target.Bx << "," << target.By << ")" << std::endl;
-    std::cout << "  [" << outMatrix[0] << ", " << outMatrix[1] << ", " << outMatrix[2] << "]" << std::endl;
-    std::cout << "  [" << outMatrix[3] << ", " << outMatrix[4] << ", " << outMatrix[5] << "]" << std::endl;
-    std::cout << "  [" << outMatrix[6] << ", " << outMatrix[7] << ", " << outMatrix[8] << "]" << std::endl;
 }
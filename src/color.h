@@ -1,9 +1,9 @@
 // DesktopLUT - color.h
-// Color space mathematics and primaries calculations
+// Color space mathematics and primaries calculations (no Windows dependencies)
 
 #pragma once
 
-#include "types.h"
+#include "colorcorrection.h"
 
 // Calculate 3x3 color space conversion matrix using Bradford chromatic adaptation
 // Converts from source primaries (content) to target primaries (display)
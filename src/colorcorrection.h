@@ -0,0 +1,92 @@
+// DesktopLUT - colorcorrection.h
+// Render-side color correction data: primaries, grayscale curve, tonemapping and the gamut
+// descriptor, as the frame constant fill reads them (no Windows dependencies)
+
+#pragma once
+
+#include "gamut.h"
+
+// Preset display primaries (chromaticity coordinates) - for calculations
+struct DisplayPrimariesData {
+    float Rx, Ry, Gx, Gy, Bx, By;  // RGB chromaticity
+    float Wx, Wy;                   // White point
+};
+
+// Grayscale correction settings (used in MonitorContext and runtime)
+struct GrayscaleData {
+    bool enabled = false;
+    int pointCount = 20;           // 10, 20, or 32
+    float points[32] = {};         // Fixed size, values 0-1 (max 32 points)
+    float peakNits = 10000.0f;     // HDR only: peak luminance for curve scaling
+    bool use24Gamma = false;       // SDR only: apply 2.2->2.4 gamma transform
+
+    void initLinear() {
+        // Initialize to linear response using square root distribution (for SDR)
+        // Point i corresponds to input (i/(N-1))^2, output should match input for linear
+        for (int i = 0; i < pointCount && i < 32; i++) {
+            float t = (float)i / (float)(pointCount - 1);
+            points[i] = t * t;  // Square root distribution: output = input = t^2
+        }
+    }
+
+    void initLinearPQ() {
+        // Initialize to linear response for PQ space (for HDR)
+        // Point i corresponds to input PQ value i/(N-1), output matches input for linear
+        for (int i = 0; i < pointCount && i < 32; i++) {
+            float t = (float)i / (float)(pointCount - 1);
+            points[i] = t;  // Evenly spaced in PQ: output = input = t
+        }
+    }
+};
+
+// Tonemapping curve types (values match shader constants)
+enum class TonemapCurve {
+    BT2390 = 0,    // ITU-R BT.2390 EETF (Hermite spline)
+    SoftClip = 1,  // Simple exponential rolloff
+    Reinhard = 2,  // Shoulder-only Reinhard (hyperbolic)
+    BT2446A = 3,   // ITU-R BT.2446 Method A (logarithmic)
+    HardClip = 4,  // Hard clamp at target (for colorists)
+};
+
+// Dropdown order: BT2390, BT2446A, Reinhard, SoftClip, HardClip
+inline const TonemapCurve g_tonemapDropdownOrder[] = {
+    TonemapCurve::BT2390,
+    TonemapCurve::BT2446A,
+    TonemapCurve::Reinhard,
+    TonemapCurve::SoftClip,
+    TonemapCurve::HardClip,
+};
+
+inline TonemapCurve DropdownIndexToTonemapCurve(int index) {
+    if (index >= 0 && index < 5) return g_tonemapDropdownOrder[index];
+    return TonemapCurve::BT2390;
+}
+
+inline int TonemapCurveToDropdownIndex(TonemapCurve curve) {
+    for (int i = 0; i < 5; i++) {
+        if (g_tonemapDropdownOrder[i] == curve) return i;
+    }
+    return 0;
+}
+
+// Tonemapping settings (HDR only)
+// Source peak is user-specified or dynamically detected
+struct TonemapData {
+    bool enabled = false;
+    bool dynamicPeak = false;         // Detect source peak per-frame (GPU-based)
+    TonemapCurve curve = TonemapCurve::BT2390;
+    float sourcePeakNits = 10000.0f;  // Content source peak (ignored when dynamicPeak=true)
+    float targetPeakNits = 1000.0f;   // Actual display capability
+};
+
+// Color correction settings (used in MonitorContext and runtime)
+struct ColorCorrectionData {
+    bool primariesEnabled = false;
+    int primariesPreset = 0;       // Index into preset list
+    DisplayPrimariesData customPrimaries = { 0.64f, 0.33f, 0.30f, 0.60f, 0.15f, 0.06f, 0.3127f, 0.329f };
+    float primariesMatrix[9] = { 1,0,0, 0,1,0, 0,0,1 };  // Identity by default (includes Bradford adaptation)
+    GrayscaleData grayscale;
+    TonemapData tonemap;  // HDR tonemapping (only used in HDR mode)
+    bool gamutCompression = false;     // Soft-compress out-of-gamut chroma (requires primariesEnabled)
+    GamutBoundaryRef gamutBoundary;    // Display gamut descriptor (shared, immutable), set when gamutCompression is on
+};
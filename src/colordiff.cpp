@@ -0,0 +1,324 @@
+// DesktopLUT - colordiff.cpp
+// Color difference: Delta E 76 / CIEDE2000 / ITP over SoA batches, and the conversions into their
+// spaces (no Windows dependencies)
+
+#include "colordiff.h"
+#include "gamut.h"
+#include <algorithm>
+#include <cmath>
+
+// ============================================================================
+// Color difference
+// ============================================================================
+
+// The kernels are written once against a small lane type: 4 lanes of SSE2 where available
+// (always on x64), one plain float otherwise.
+#if defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define COLOR_DIFF_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if COLOR_DIFF_SSE2
+
+static const int LANES = 4;
+
+struct VecF {
+    __m128 v;
+    VecF() = default;
+    VecF(__m128 x) : v(x) {}
+    VecF(float x) : v(_mm_set1_ps(x)) {}
+};
+typedef VecF VecMask;
+
+static inline VecF Load(const float* p) { return _mm_loadu_ps(p); }
+static inline void Store(float* p, VecF x) { _mm_storeu_ps(p, x.v); }
+static inline VecF operator+(VecF a, VecF b) { return _mm_add_ps(a.v, b.v); }
+static inline VecF operator-(VecF a, VecF b) { return _mm_sub_ps(a.v, b.v); }
+static inline VecF operator*(VecF a, VecF b) { return _mm_mul_ps(a.v, b.v); }
+static inline VecF operator/(VecF a, VecF b) { return _mm_div_ps(a.v, b.v); }
+static inline VecF operator-(VecF a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.0f)); }
+static inline VecF Sqrt(VecF a) { return _mm_sqrt_ps(a.v); }
+static inline VecF Min(VecF a, VecF b) { return _mm_min_ps(a.v, b.v); }
+static inline VecF Max(VecF a, VecF b) { return _mm_max_ps(a.v, b.v); }
+static inline VecF Abs(VecF a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v); }
+static inline VecMask Gt(VecF a, VecF b) { return _mm_cmpgt_ps(a.v, b.v); }
+static inline VecMask Lt(VecF a, VecF b) { return _mm_cmplt_ps(a.v, b.v); }
+static inline VecMask Eq(VecF a, VecF b) { return _mm_cmpeq_ps(a.v, b.v); }
+static inline VecMask And(VecMask a, VecMask b) { return _mm_and_ps(a.v, b.v); }
+static inline VecMask Or(VecMask a, VecMask b) { return _mm_or_ps(a.v, b.v); }
+static inline VecMask Not(VecMask a) { return _mm_xor_ps(a.v, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+static inline VecF Select(VecMask m, VecF a, VecF b) { return _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)); }
+
+// 2^n for integral n in [-126, 127], through the exponent bits
+static inline VecF Exp2Int(VecF n) {
+    __m128i e = _mm_add_epi32(_mm_cvtps_epi32(n.v), _mm_set1_epi32(127));
+    return _mm_castsi128_ps(_mm_slli_epi32(e, 23));
+}
+static inline VecF Round(VecF x) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(x.v)); }
+
+#else
+
+static const int LANES = 1;
+
+struct VecF {
+    float v;
+    VecF() = default;
+    VecF(float x) : v(x) {}
+};
+typedef bool VecMask;
+
+static inline VecF Load(const float* p) { return *p; }
+static inline void Store(float* p, VecF x) { *p = x.v; }
+static inline VecF operator+(VecF a, VecF b) { return a.v + b.v; }
+static inline VecF operator-(VecF a, VecF b) { return a.v - b.v; }
+static inline VecF operator*(VecF a, VecF b) { return a.v * b.v; }
+static inline VecF operator/(VecF a, VecF b) { return a.v / b.v; }
+static inline VecF operator-(VecF a) { return -a.v; }
+static inline VecF Sqrt(VecF a) { return sqrtf(a.v); }
+static inline VecF Min(VecF a, VecF b) { return a.v < b.v ? a.v : b.v; }
+static inline VecF Max(VecF a, VecF b) { return a.v > b.v ? a.v : b.v; }
+static inline VecF Abs(VecF a) { return fabsf(a.v); }
+static inline VecMask Gt(VecF a, VecF b) { return a.v > b.v; }
+static inline VecMask Lt(VecF a, VecF b) { return a.v < b.v; }
+static inline VecMask Eq(VecF a, VecF b) { return a.v == b.v; }
+static inline VecMask And(VecMask a, VecMask b) { return a && b; }
+static inline VecMask Or(VecMask a, VecMask b) { return a || b; }
+static inline VecMask Not(VecMask a) { return !a; }
+static inline VecF Select(VecMask m, VecF a, VecF b) { return m ? a : b; }
+static inline VecF Exp2Int(VecF n) { return ldexpf(1.0f, (int)n.v); }
+static inline VecF Round(VecF x) { return nearbyintf(x.v); }
+
+#endif
+
+static const float DE_PI = 3.14159265358979f;
+
+// atan2 in degrees, [0, 360) - Cephes atanf polynomial on min/max ratio (~1e-7 rad)
+static inline VecF Atan2Degrees(VecF y, VecF x) {
+    VecF ax = Abs(x), ay = Abs(y);
+    VecF hi = Max(ax, ay);
+    VecF t = Min(ax, ay) / Select(Gt(hi, 0.0f), hi, 1.0f);
+    VecMask reduce = Gt(t, 0.41421356f);   // tan(pi/8)
+    VecF r = Select(reduce, (t - 1.0f) / (t + 1.0f), t);
+    VecF z = r * r;
+    VecF p = (((z * 8.05374449538e-2f - 1.38776856032e-1f) * z + 1.99777106478e-1f) * z - 3.33329491539e-1f) * z * r + r;
+    VecF a = Select(reduce, p + DE_PI * 0.25f, p);
+    a = Select(Gt(ay, ax), -a + DE_PI * 0.5f, a);   // Angle from the larger component
+    a = Select(Lt(x, 0.0f), -a + DE_PI, a);
+    a = Select(Lt(y, 0.0f), -a + DE_PI * 2.0f, a);
+    a = a * (180.0f / DE_PI);
+    return Select(Lt(a, 360.0f), a, 0.0f);
+}
+
+// e^x for x <= 0 (Cephes expf: 2^n times a polynomial on the remainder)
+static inline VecF ExpNegative(VecF x) {
+    x = Max(x, -87.0f);
+    VecF n = Round(x * 1.44269504088896341f);
+    VecF r = x - n * 0.693359375f + n * 2.12194440e-4f;
+    VecF p = (((((r * 1.9875691500e-4f + 1.3981999507e-3f) * r + 8.3334519073e-3f) * r + 4.1665795894e-2f) * r
+              + 1.6666665459e-1f) * r + 5.0000001201e-1f) * r * r + r + 1.0f;
+    return p * Exp2Int(n);
+}
+
+// sin(x) for x in [0, pi/3] (Taylor to x^11, error < 1e-7)
+static inline VecF SinSmall(VecF x) {
+    VecF z = x * x;
+    return x * (((((z * (-1.0f / 39916800.0f) + 1.0f / 362880.0f) * z - 1.0f / 5040.0f) * z + 1.0f / 120.0f) * z
+                 - 1.0f / 6.0f) * z + 1.0f);
+}
+
+static inline VecF Pow7(VecF x) {
+    VecF x2 = x * x;
+    return x2 * x2 * x2 * x;
+}
+
+static VecF DeltaE76Lane(VecF L1, VecF a1, VecF b1, VecF L2, VecF a2, VecF b2) {
+    VecF dL = L2 - L1, da = a2 - a1, db = b2 - b1;
+    return Sqrt(dL * dL + da * da + db * db);
+}
+
+static VecF DeltaEITPLane(VecF I1, VecF t1, VecF p1, VecF I2, VecF t2, VecF p2) {
+    VecF dI = I2 - I1, dT = (t2 - t1) * 0.5f, dP = p2 - p1;
+    return Sqrt(dI * dI + dT * dT + dP * dP) * 720.0f;
+}
+
+// CIEDE2000 after Sharma, Wu and Dalal (2005). Hue angles only enter the formula through the
+// principal hue difference and the mean hue. Both follow from the unit hue vectors u1, u2 (the
+// half-angle sine and cosine of the difference, and u1 turned by that half angle), and the T term
+// expands cos(k*h) from the mean hue's cos/sin, so only dTheta needs an angle.
+static VecF DeltaE2000Lane(VecF L1, VecF a1, VecF b1, VecF L2, VecF a2, VecF b2) {
+    const float POW25_7 = 6103515625.0f;   // 25^7
+    const float DEG = DE_PI / 180.0f;
+
+    VecF C1 = Sqrt(a1 * a1 + b1 * b1);
+    VecF C2 = Sqrt(a2 * a2 + b2 * b2);
+    VecF Cbar7 = Pow7((C1 + C2) * 0.5f);
+    VecF G = (VecF(1.0f) - Sqrt(Cbar7 / (Cbar7 + POW25_7))) * 0.5f;
+    VecF a1p = a1 * (G + 1.0f);
+    VecF a2p = a2 * (G + 1.0f);
+    VecF C1p = Sqrt(a1p * a1p + b1 * b1);
+    VecF C2p = Sqrt(a2p * a2p + b2 * b2);
+    VecF prod = C1p * C2p;
+    VecMask chromatic = Gt(prod, 0.0f);   // Both have a hue (else dH' = 0 and the mean hue is h1 + h2)
+
+    // Unit hue vectors (zero when achromatic)
+    VecF inv1 = Select(Gt(C1p, 0.0f), VecF(1.0f) / Max(C1p, 1e-30f), 0.0f);
+    VecF inv2 = Select(Gt(C2p, 0.0f), VecF(1.0f) / Max(C2p, 1e-30f), 0.0f);
+    VecF u1x = a1p * inv1, u1y = b1 * inv1;
+    VecF u2x = a2p * inv2, u2y = b2 * inv2;
+
+    // Principal hue difference from the chord and the bisector: |u2 - u1| = 2 sin(dh/2) (sign from
+    // the cross product), |u2 + u1| = 2 cos(dh/2). Exactly opposite hues take dh = +180 when
+    // h1 < 180, else -180 (the reference's rule).
+    VecF dx = u2x - u1x, dy = u2y - u1y;
+    VecF sx = u1x + u2x, sy = u1y + u2y;
+    VecF cross = a1p * b2 - b1 * a2p;
+    VecMask opposite = And(Eq(cross, 0.0f), Lt(a1p * a2p + b1 * b2, 0.0f));
+    VecF sinHalf = Select(opposite, 1.0f, Sqrt(dx * dx + dy * dy) * 0.5f);
+    VecF cosHalf = Select(opposite, 0.0f, Sqrt(sx * sx + sy * sy) * 0.5f);
+    VecMask h1Below180 = Or(Gt(b1, 0.0f), And(Eq(b1, 0.0f), Gt(a1p, 0.0f)));
+    VecMask negative = Or(Lt(cross, 0.0f), And(opposite, Not(h1Below180)));
+    sinHalf = Select(negative, -sinHalf, sinHalf);
+    VecF dHp = Select(chromatic, Sqrt(prod) * sinHalf * 2.0f, 0.0f);
+
+    // Mean hue: u1 turned by dh/2 (stays accurate for nearly opposite hues, where u1 + u2 is
+    // mostly rounding); with an achromatic side, the other's hue (h1 + h2 with h = 0), 0 for greys
+    VecF mx = u1x * cosHalf - u1y * sinHalf;
+    VecF my = u1y * cosHalf + u1x * sinHalf;
+    VecF gx = a1p + a2p, gy = b1 + b2;
+    VecMask grey = And(Eq(gx, 0.0f), Eq(gy, 0.0f));
+    mx = Select(chromatic, mx, Select(grey, 1.0f, gx));
+    my = Select(chromatic, my, Select(grey, 0.0f, gy));
+    VecF invLen = VecF(1.0f) / Sqrt(mx * mx + my * my);
+    VecF c = mx * invLen, s = my * invLen;
+    VecF hbar = Atan2Degrees(my, mx);
+
+    // T = 1 - 0.17 cos(h - 30) + 0.24 cos(2h) + 0.32 cos(3h + 6) - 0.20 cos(4h - 63)
+    VecF cos2 = c * c - s * s, sin2 = c * s * 2.0f;
+    VecF cos3 = c * (c * c * 4.0f - 3.0f), sin3 = s * (VecF(3.0f) - s * s * 4.0f);
+    VecF cos4 = cos2 * cos2 - sin2 * sin2, sin4 = sin2 * cos2 * 2.0f;
+    VecF T = VecF(1.0f)
+           - (c * 0.86602540f + s * 0.5f) * 0.17f                   // cos/sin 30
+           + cos2 * 0.24f
+           + (cos3 * 0.99452190f - sin3 * 0.10452846f) * 0.32f       // cos/sin 6
+           - (cos4 * 0.45399050f + sin4 * 0.89100652f) * 0.20f;      // cos/sin 63
+
+    VecF dLp = L2 - L1;
+    VecF dCp = C2p - C1p;
+    VecF Lm = (L1 + L2) * 0.5f - 50.0f;
+    VecF Cbarp = (C1p + C2p) * 0.5f;
+    VecF Cbarp7 = Pow7(Cbarp);
+    VecF q = (hbar - 275.0f) * (1.0f / 25.0f);
+    VecF dTheta = ExpNegative(-(q * q)) * 30.0f;
+    VecF RT = -SinSmall(dTheta * (2.0f * DEG)) * Sqrt(Cbarp7 / (Cbarp7 + POW25_7)) * 2.0f;
+    VecF SL = VecF(1.0f) + Lm * Lm * 0.015f / Sqrt(Lm * Lm + 20.0f);
+    VecF SC = VecF(1.0f) + Cbarp * 0.045f;
+    VecF SH = VecF(1.0f) + Cbarp * T * 0.015f;
+
+    VecF tL = dLp / SL, tC = dCp / SC, tH = dHp / SH;
+    return Sqrt(Max(tL * tL + tC * tC + tH * tH + RT * tC * tH, 0.0f));
+}
+
+// Run a lane kernel over a batch; the tail is padded so every pair takes the same code path
+template <typename Kernel>
+static void DeltaEBatch(const ColorBatch& a, const ColorBatch& b, size_t count, float* out, Kernel kernel) {
+    size_t i = 0;
+    for (; i + LANES <= count; i += LANES) {
+        Store(out + i, kernel(Load(a.c0 + i), Load(a.c1 + i), Load(a.c2 + i),
+                              Load(b.c0 + i), Load(b.c1 + i), Load(b.c2 + i)));
+    }
+    if (i < count) {
+        float in[6][LANES] = {};
+        float res[LANES];
+        size_t n = count - i;
+        for (size_t k = 0; k < n; k++) {
+            in[0][k] = a.c0[i + k]; in[1][k] = a.c1[i + k]; in[2][k] = a.c2[i + k];
+            in[3][k] = b.c0[i + k]; in[4][k] = b.c1[i + k]; in[5][k] = b.c2[i + k];
+        }
+        Store(res, kernel(Load(in[0]), Load(in[1]), Load(in[2]), Load(in[3]), Load(in[4]), Load(in[5])));
+        for (size_t k = 0; k < n; k++) out[i + k] = res[k];
+    }
+}
+
+void DeltaE76(const ColorBatch& a, const ColorBatch& b, size_t count, float* out) {
+    DeltaEBatch(a, b, count, out, DeltaE76Lane);
+}
+
+void DeltaE2000(const ColorBatch& a, const ColorBatch& b, size_t count, float* out) {
+    DeltaEBatch(a, b, count, out, DeltaE2000Lane);
+}
+
+void DeltaEITP(const ColorBatch& a, const ColorBatch& b, size_t count, float* out) {
+    DeltaEBatch(a, b, count, out, DeltaEITPLane);
+}
+
+DeltaEStats SummarizeDeltaE(const float* deltaE, size_t count) {
+    DeltaEStats stats;
+    stats.count = count;
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        stats.max = (std::max)(stats.max, deltaE[i]);
+        sum += deltaE[i];
+    }
+    stats.mean = count ? (float)(sum / count) : 0.0f;
+    return stats;
+}
+
+// ============================================================================
+// Conversions for color difference
+// ============================================================================
+
+// BT.709 linear RGB -> XYZ (D65), and the D65 white for CIELAB
+static const float Rec709_to_XYZ[9] = {
+    0.4123908f, 0.3575843f, 0.1804808f,
+    0.2126390f, 0.7151687f, 0.0721923f,
+    0.0193308f, 0.1191948f, 0.9505322f
+};
+static const float D65_WHITE[3] = { 0.9504559f, 1.0f, 1.0890578f };
+
+// PQ (ST.2084) constants - same as shader.h
+static const float PQ_m1 = 0.1593017578125f;
+static const float PQ_m2 = 78.84375f;
+static const float PQ_c1 = 0.8359375f;
+static const float PQ_c2 = 18.8515625f;
+static const float PQ_c3 = 18.6875f;
+
+static float LabF(float t) {
+    const float delta = 6.0f / 29.0f;
+    return t > delta * delta * delta ? cbrtf(t) : t / (3.0f * delta * delta) + 4.0f / 29.0f;
+}
+
+void DisplayRGBToLab(const ColorBatch& rgb, size_t count, float* L, float* a, float* b) {
+    for (size_t i = 0; i < count; i++) {
+        float lin[3] = {
+            powf((std::max)(rgb.c0[i], 0.0f), 2.2f),
+            powf((std::max)(rgb.c1[i], 0.0f), 2.2f),
+            powf((std::max)(rgb.c2[i], 0.0f), 2.2f),
+        };
+        float f[3];
+        for (int k = 0; k < 3; k++) {
+            const float* m = Rec709_to_XYZ + k * 3;
+            f[k] = LabF((m[0] * lin[0] + m[1] * lin[1] + m[2] * lin[2]) / D65_WHITE[k]);
+        }
+        L[i] = 116.0f * f[1] - 16.0f;
+        a[i] = 500.0f * (f[0] - f[1]);
+        b[i] = 200.0f * (f[1] - f[2]);
+    }
+}
+
+void PQRGBToICtCp(const ColorBatch& rgb, size_t count, float* I, float* Ct, float* Cp) {
+    for (size_t i = 0; i < count; i++) {
+        // PQ -> linear BT.2020 normalized to 10000 nits, which is SourceToICtCp's HDR input
+        float lin[3];
+        const float* src[3] = { rgb.c0, rgb.c1, rgb.c2 };
+        for (int k = 0; k < 3; k++) {
+            float Vm = powf((std::max)(src[k][i], 1e-10f), 1.0f / PQ_m2);
+            float t = (std::max)(Vm - PQ_c1, 0.0f) / (std::max)(PQ_c2 - PQ_c3 * Vm, 1e-10f);
+            lin[k] = powf(t, 1.0f / PQ_m1);
+        }
+        float ictcp[3];
+        SourceToICtCp(lin, true, ictcp);
+        I[i] = ictcp[0];
+        Ct[i] = ictcp[1];
+        Cp[i] = ictcp[2];
+    }
+}
@@ -0,0 +1,46 @@
+// DesktopLUT - colordiff.h
+// Color difference: Delta E 76 / CIEDE2000 / ITP over SoA batches, and the conversions into their
+// spaces (no Windows dependencies)
+
+#pragma once
+
+#include <cstddef>
+
+// ============================================================================
+// Color difference
+// ============================================================================
+
+// Structure-of-arrays batch: component k of color i is ck[i] (L*, a*, b* or I, Ct, Cp)
+struct ColorBatch {
+    const float* c0 = nullptr;
+    const float* c1 = nullptr;
+    const float* c2 = nullptr;
+};
+
+// Per-pair differences into out[count], 4 pairs per SSE2 step (any count, no alignment needed).
+// Inputs and out may not overlap.
+
+// CIE76: Euclidean distance in CIELAB
+void DeltaE76(const ColorBatch& a, const ColorBatch& b, size_t count, float* out);
+
+// CIEDE2000 (kL = kC = kH = 1). The hue terms are built from the hue unit vectors instead of
+// angles, so a pair costs one atan2 and one exp approximation rather than the usual trig chain;
+// agrees with the Sharma/Wu/Dalal test data to 1e-4.
+void DeltaE2000(const ColorBatch& a, const ColorBatch& b, size_t count, float* out);
+
+// Delta E ITP (ITU-R BT.2124) from ICtCp: 720 * sqrt(dI^2 + (dCt/2)^2 + dCp^2), 1.0 ~ one JND
+void DeltaEITP(const ColorBatch& a, const ColorBatch& b, size_t count, float* out);
+
+struct DeltaEStats {
+    size_t count = 0;
+    float max = 0.0f;
+    float mean = 0.0f;
+};
+
+DeltaEStats SummarizeDeltaE(const float* deltaE, size_t count);
+
+// LUT output values to the spaces above (SoA, out arrays hold count values each)
+// SDR: gamma 2.2 BT.709 display RGB -> CIELAB (D65 white = RGB 1.0)
+void DisplayRGBToLab(const ColorBatch& rgb, size_t count, float* L, float* a, float* b);
+// HDR: PQ-encoded BT.2020 RGB -> ICtCp
+void PQRGBToICtCp(const ColorBatch& rgb, size_t count, float* I, float* Ct, float* Cp);
@@ -0,0 +1,109 @@
+// DesktopLUT - correction.cpp
+// Background color correction compiler (GUI settings -> render-ready ColorCorrectionData)
+
+#include "correction.h"
+#include "correctionqueue.h"
+#include "globals.h"
+#include "processing.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static std::mutex g_correctionSlotMutex;               // Protects the queue, settings and worker state below
+static std::condition_variable g_correctionSlotCV;
+static CorrectionQueue g_correctionQueue;
+static std::vector<ColorCorrectionSettings> g_correctionSettings;   // Per queue slot
+static bool g_correctionWorkerRunning = false;
+static std::thread g_correctionWorker;
+static CorrectionPublished g_correctionPublished;      // Under g_colorCorrectionMutex
+
+// Latest-wins publish into the render thread's mailbox (capacity reserved at startup)
+static void PublishCorrection(int monitorIndex, bool isHDR, uint64_t version, const ColorCorrectionData& data) {
+    std::lock_guard<std::mutex> lock(g_colorCorrectionMutex);
+    // Also rejects a result older than one the render thread has already taken out of the mailbox
+    if (!AcceptCorrectionResult(g_correctionPublished, monitorIndex, isHDR, version)) return;
+    for (auto& pending : g_pendingColorCorrections) {
+        if (pending.monitorIndex == monitorIndex && pending.isHDR == isHDR) {
+            pending.version = version;
+            pending.data = data;
+            g_hasPendingColorCorrections.store(true, std::memory_order_release);
+            return;
+        }
+    }
+    g_pendingColorCorrections.push_back({ monitorIndex, isHDR, version, data });
+    g_hasPendingColorCorrections.store(true, std::memory_order_release);
+}
+
+static void CorrectionWorkerFunc() {
+    // Reused across iterations so steady-state compiles don't reallocate the grayscale vector
+    ColorCorrectionSettings snapshot;
+
+    std::unique_lock<std::mutex> lock(g_correctionSlotMutex);
+    while (true) {
+        int slot = -1;
+        g_correctionSlotCV.wait(lock, [&slot] {
+            return !g_correctionWorkerRunning || (slot = CorrectionQueueTake(g_correctionQueue)) >= 0;
+        });
+        if (!g_correctionWorkerRunning) break;
+
+        int monitorIndex = g_correctionQueue.slots[slot].monitorIndex;
+        bool isHDR = g_correctionQueue.slots[slot].isHDR;
+        uint64_t version = g_correctionQueue.slots[slot].version;
+        snapshot = g_correctionSettings[slot];
+
+        // Compile without holding the slot lock so the GUI never waits on it
+        lock.unlock();
+        ColorCorrectionData data = ConvertColorCorrection(snapshot, isHDR);
+        lock.lock();
+
+        // A newer snapshot arrived while compiling: publishing this one would only flash it for a frame
+        if (!g_correctionWorkerRunning || CorrectionQueueSuperseded(g_correctionQueue, slot, version)) continue;
+        PublishCorrection(monitorIndex, isHDR, version, data);
+    }
+}
+
+void StartCorrectionCompiler() {
+    {
+        // A previous run's unapplied results would land on this run's monitors
+        std::lock_guard<std::mutex> lock(g_colorCorrectionMutex);
+        g_pendingColorCorrections.clear();
+        g_hasPendingColorCorrections.store(false, std::memory_order_release);
+    }
+    std::lock_guard<std::mutex> lock(g_correctionSlotMutex);
+    CorrectionQueueReset(g_correctionQueue);  // StartProcessing submits every monitor's settings next
+    g_correctionSettings.clear();
+    if (g_correctionWorkerRunning) return;  // Already running
+
+    g_correctionWorkerRunning = true;
+    g_correctionWorker = std::thread(CorrectionWorkerFunc);
+}
+
+void StopCorrectionCompiler() {
+    {
+        std::lock_guard<std::mutex> lock(g_correctionSlotMutex);
+        if (!g_correctionWorkerRunning) return;  // Not running
+        g_correctionWorkerRunning = false;
+    }
+    g_correctionSlotCV.notify_one();
+    if (g_correctionWorker.joinable()) {
+        g_correctionWorker.join();
+    }
+
+    std::lock_guard<std::mutex> lock(g_correctionSlotMutex);
+    CorrectionQueueReset(g_correctionQueue);
+    g_correctionSettings.clear();
+}
+
+void SubmitCorrectionSnapshot(int monitorIndex, bool isHDR, const ColorCorrectionSettings& settings) {
+    {
+        std::lock_guard<std::mutex> lock(g_correctionSlotMutex);
+        if (!g_correctionWorkerRunning) return;
+        MetricInc(g_metrics.correctionSubmits);
+
+        int slot = CorrectionQueueSubmit(g_correctionQueue, monitorIndex, isHDR);
+        if (slot >= (int)g_correctionSettings.size()) g_correctionSettings.resize(slot + 1);
+        g_correctionSettings[slot] = settings;
+    }
+    g_correctionSlotCV.notify_one();
+}
@@ -0,0 +1,23 @@
+// DesktopLUT - correction.h
+// Background color correction compiler (GUI settings -> render-ready ColorCorrectionData)
+
+#pragma once
+
+#include "types.h"
+
+// The GUI posts settings snapshots per monitor/mode and returns immediately.
+// A single worker compiles the latest snapshot of each slot (primaries matrix,
+// grayscale curve, gamut descriptor) and publishes the result as a versioned
+// PendingColorCorrection that the render thread copies in at the next frame.
+// Snapshots posted while the worker is busy coalesce - only the newest is compiled. A result
+// whose slot got a newer snapshot mid-compile is dropped, and no result replaces a newer one
+// already published (bookkeeping in correctionqueue.h).
+
+// Start/stop the worker (GUI thread, alongside Start/StopProcessing); both discard queued snapshots.
+// Start also drops results the render thread hasn't taken yet. StartProcessing submits each
+// configured monitor's settings right after, so startup compiles never block the GUI.
+void StartCorrectionCompiler();
+void StopCorrectionCompiler();
+
+// GUI thread: queue a snapshot of settings for one monitor and mode
+void SubmitCorrectionSnapshot(int monitorIndex, bool isHDR, const ColorCorrectionSettings& settings);
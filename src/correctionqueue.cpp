@@ -0,0 +1,63 @@
+// DesktopLUT - correctionqueue.cpp
+// Latest-wins bookkeeping for the color correction compiler: coalescing submission slots per
+// monitor/mode and the version check that keeps older results from replacing newer ones (no Windows dependencies)
+
+#include "correctionqueue.h"
+
+int CorrectionQueueSubmit(CorrectionQueue& q, int monitorIndex, bool isHDR) {
+    q.submitted++;
+    int index = -1;
+    for (size_t i = 0; i < q.slots.size(); i++) {
+        if (q.slots[i].monitorIndex == monitorIndex && q.slots[i].isHDR == isHDR) {
+            index = (int)i;
+            break;
+        }
+    }
+    if (index < 0) {
+        q.slots.push_back({ monitorIndex, isHDR, false, 0 });
+        index = (int)q.slots.size() - 1;
+    }
+    CorrectionSlotState& slot = q.slots[index];
+    if (slot.dirty) q.coalesced++;
+    slot.dirty = true;
+    slot.version = ++q.lastVersion;
+    return index;
+}
+
+int CorrectionQueueTake(CorrectionQueue& q) {
+    int oldest = -1;
+    for (size_t i = 0; i < q.slots.size(); i++) {
+        if (q.slots[i].dirty && (oldest < 0 || q.slots[i].version < q.slots[oldest].version)) oldest = (int)i;
+    }
+    if (oldest >= 0) q.slots[oldest].dirty = false;
+    return oldest;
+}
+
+bool CorrectionQueueSuperseded(CorrectionQueue& q, int slot, uint64_t version) {
+    if (slot < 0 || slot >= (int)q.slots.size()) return true;
+    const CorrectionSlotState& s = q.slots[slot];
+    if (s.dirty && s.version > version) {
+        q.superseded++;
+        return true;
+    }
+    return false;
+}
+
+void CorrectionQueueReset(CorrectionQueue& q) {
+    q.slots.clear();
+}
+
+bool AcceptCorrectionResult(CorrectionPublished& p, int monitorIndex, bool isHDR, uint64_t version) {
+    for (auto& entry : p.entries) {
+        if (entry.monitorIndex == monitorIndex && entry.isHDR == isHDR) {
+            if (version <= entry.version) {
+                p.rejected++;
+                return false;
+            }
+            entry.version = version;
+            return true;
+        }
+    }
+    p.entries.push_back({ monitorIndex, isHDR, version });
+    return true;
+}
@@ -0,0 +1,57 @@
+// DesktopLUT - correctionqueue.h
+// Latest-wins bookkeeping for the color correction compiler: coalescing submission slots per
+// monitor/mode and the version check that keeps older results from replacing newer ones (no Windows dependencies)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One per monitor/mode - a newer submission overwrites an uncompiled one
+struct CorrectionSlotState {
+    int monitorIndex;
+    bool isHDR;
+    bool dirty;
+    uint64_t version;                    // Newest submission for this slot
+};
+
+// Submission side (guarded by the compiler's slot mutex). Slot indices are stable until
+// CorrectionQueueReset, so the caller keeps each slot's settings at the same index.
+struct CorrectionQueue {
+    std::vector<CorrectionSlotState> slots;
+    uint64_t lastVersion = 0;            // Last version handed out (never reset)
+
+    uint64_t submitted = 0;
+    uint64_t coalesced = 0;              // Submissions that replaced one not compiled yet
+    uint64_t superseded = 0;             // Compiled results dropped because a newer submission was waiting
+};
+
+// Newest version published per monitor/mode (guarded by the render thread's mailbox mutex).
+// Outlives the mailbox entries the render thread drains, so a late result is still recognized.
+struct CorrectionPublished {
+    struct Entry {
+        int monitorIndex;
+        bool isHDR;
+        uint64_t version;
+    };
+    std::vector<Entry> entries;
+    uint64_t rejected = 0;               // Results older than one already published
+};
+
+// GUI: mark the monitor/mode's slot dirty with a new version. Returns the slot index.
+int CorrectionQueueSubmit(CorrectionQueue& q, int monitorIndex, bool isHDR);
+
+// Worker: oldest-submitted dirty slot (marked clean), or -1 when there is nothing to compile
+int CorrectionQueueTake(CorrectionQueue& q);
+
+// Worker, after compiling `version` of a slot: true if a newer submission is already waiting
+// there, so the result would be replaced right away and shouldn't be published
+bool CorrectionQueueSuperseded(CorrectionQueue& q, int slot, uint64_t version);
+
+// Drop every slot (compiler start/stop); versions keep counting up
+void CorrectionQueueReset(CorrectionQueue& q);
+
+// Publisher: true if `version` is newer than anything published for the monitor/mode (and
+// records it); false for a stale result
+bool AcceptCorrectionResult(CorrectionPublished& p, int monitorIndex, bool isHDR, uint64_t version);
@@ -0,0 +1,59 @@
+// DesktopLUT - devicegroup.cpp
+// Adapter topology to per-GPU device group assignment (no D3D dependencies)
+
+#include "devicegroup.h"
+#include <cstddef>
+
+// First adapter index with this LUID (duplicates resolve to the earliest entry)
+static int CanonicalAdapter(const std::vector<AdapterTopology>& adapters, int index) {
+    for (int i = 0; i < index; i++) {
+        if (adapters[i].id == adapters[index].id) return i;
+    }
+    return index;
+}
+
+static int FindOwningAdapter(const std::vector<AdapterTopology>& adapters, const void* monitor) {
+    for (int i = 0; i < (int)adapters.size(); i++) {
+        for (const void* output : adapters[i].outputs) {
+            if (output == monitor) return CanonicalAdapter(adapters, i);
+        }
+    }
+    return -1;
+}
+
+static int FindFallbackAdapter(const std::vector<AdapterTopology>& adapters) {
+    for (int i = 0; i < (int)adapters.size(); i++) {
+        if (!adapters[i].software) return CanonicalAdapter(adapters, i);
+    }
+    return 0;
+}
+
+bool PlanDeviceGroups(const std::vector<AdapterTopology>& adapters,
+                      const std::vector<const void*>& monitors, DeviceGroupPlan& out) {
+    out.groupAdapter.clear();
+    out.monitorGroup.assign(monitors.size(), -1);
+    out.monitorFallback.assign(monitors.size(), false);
+    if (adapters.empty()) return false;
+
+    for (size_t m = 0; m < monitors.size(); m++) {
+        int adapter = FindOwningAdapter(adapters, monitors[m]);
+        if (adapter < 0) {
+            adapter = FindFallbackAdapter(adapters);
+            out.monitorFallback[m] = true;
+        }
+
+        int group = -1;
+        for (int g = 0; g < (int)out.groupAdapter.size(); g++) {
+            if (out.groupAdapter[g] == adapter) {
+                group = g;
+                break;
+            }
+        }
+        if (group < 0) {
+            group = (int)out.groupAdapter.size();
+            out.groupAdapter.push_back(adapter);
+        }
+        out.monitorGroup[m] = group;
+    }
+    return true;
+}
@@ -0,0 +1,38 @@
+// DesktopLUT - devicegroup.h
+// Adapter topology to per-GPU device group assignment (no D3D dependencies)
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Adapter LUID (same layout as the Windows LUID, kept separate so this module stays portable)
+struct AdapterId {
+    uint32_t lowPart = 0;
+    int32_t highPart = 0;
+
+    bool operator==(const AdapterId& other) const { return lowPart == other.lowPart && highPart == other.highPart; }
+    bool operator!=(const AdapterId& other) const { return !(*this == other); }
+};
+
+// One adapter as enumerated by DXGI, in enumeration order (index 0 = default adapter)
+struct AdapterTopology {
+    AdapterId id;
+    bool software = false;               // Basic Render Driver / WARP - only used if nothing else exists
+    std::vector<const void*> outputs;    // HMONITOR of each output attached to this adapter
+};
+
+// Result of grouping: which adapters get a device, and which group drives each monitor
+struct DeviceGroupPlan {
+    std::vector<int> groupAdapter;       // Group -> index into the adapter list
+    std::vector<int> monitorGroup;       // Monitor -> group index (same order as the monitor list)
+    std::vector<bool> monitorFallback;   // Monitor had no owning adapter and uses the fallback group
+};
+
+// Assign each monitor to the adapter that owns its output
+// - Adapters listed more than once with the same LUID collapse into one group
+// - Groups are only created for adapters that drive at least one monitor, in first-use order
+// - Monitors no adapter claims fall back to the first hardware adapter (first adapter if none)
+// Returns false if there are no adapters
+bool PlanDeviceGroups(const std::vector<AdapterTopology>& adapters,
+                      const std::vector<const void*>& monitors, DeviceGroupPlan& out);
@@ -11,6 +11,7 @@
 #include <devguid.h>
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 
 #pragma comment(lib, "dxgi.lib")
 #pragma comment(lib, "setupapi.lib")
@@ -367,7 +368,7 @@ MonitorPrimaries GetMonitorPrimaries(int monitorIndex) {
 // Parse chromaticity coordinates from EDID bytes 25-34
 // EDID encodes each coordinate as a 10-bit value: 8 MSBs in one byte, 2 LSBs packed with others
 // The value represents a CIE 1931 xy coordinate as a binary fraction (value / 1024)
-static bool ParseEDIDChromaticity(const BYTE* edid, size_t edidSize, MonitorPrimaries& primaries) {
+bool ParseEDIDChromaticity(const BYTE* edid, size_t edidSize, MonitorPrimaries& primaries) {
     if (edidSize < 35) {
         return false;  // Need at least 35 bytes for chromaticity data
     }
@@ -432,8 +433,24 @@ static std::wstring ExtractHardwareIdFromPath(const std::wstring& devicePath) {
     return devicePath.substr(startPos, endPos - startPos);
 }
 
+// Full PnP instance ID from a monitor device path, which tells apart two monitors of the same model
+// \\?\DISPLAY#DELA1EE#5&2a3b4c5d&0&UID12345#{GUID} -> DISPLAY\DELA1EE\5&2a3b4c5d&0&UID12345
+static std::wstring ExtractInstanceIdFromPath(const std::wstring& devicePath) {
+    size_t displayPos = devicePath.find(L"DISPLAY#");
+    size_t guidPos = devicePath.rfind(L"#{");
+    if (displayPos == std::wstring::npos || guidPos == std::wstring::npos || guidPos <= displayPos) {
+        return L"";
+    }
+    std::wstring instanceId = devicePath.substr(displayPos, guidPos - displayPos);
+    std::replace(instanceId.begin(), instanceId.end(), L'#', L'\\');
+    return instanceId;
+}
+
 // Read EDID from registry via SetupAPI for a specific monitor
-static bool ReadEDIDFromRegistry(const wchar_t* targetHardwareId, std::vector<BYTE>& edidData) {
+// target: hardware ID (first monitor of that model) or full instance ID (that monitor)
+static bool ReadEDIDFromRegistry(const wchar_t* target, std::vector<BYTE>& edidData) {
+    bool matchInstance = wcschr(target, L'\\') != nullptr;
+
     // Get device info set for monitors
     HDEVINFO devInfo = SetupDiGetClassDevsW(&GUID_DEVINTERFACE_MONITOR, nullptr, nullptr,
                                              DIGCF_PRESENT | DIGCF_DEVICEINTERFACE);
@@ -467,8 +484,8 @@ static bool ReadEDIDFromRegistry(const wchar_t* targetHardwareId, std::vector<BY
         std::wstring hwId = instIdStr.substr(firstSlash + 1, secondSlash - firstSlash - 1);
 
         // Compare with target (case-insensitive)
-        std::wstring targetLower(targetHardwareId);
-        std::wstring hwIdLower = hwId;
+        std::wstring targetLower(target);
+        std::wstring hwIdLower = matchInstance ? instIdStr : hwId;
         std::transform(targetLower.begin(), targetLower.end(), targetLower.begin(), ::towlower);
         std::transform(hwIdLower.begin(), hwIdLower.end(), hwIdLower.begin(), ::towlower);
 
@@ -509,6 +526,18 @@ static bool ReadEDIDFromRegistry(const wchar_t* targetHardwareId, std::vector<BY
 MonitorPrimaries GetMonitorPrimariesFromEDID(int monitorIndex) {
     MonitorPrimaries result = {};
 
+    // Known display: primaries were parsed when it was first seen
+    if (monitorIndex >= 0 && monitorIndex < (int)g_gui.monitorEdidHashes.size()) {
+        const DisplayRecord* record = FindDisplay(g_gui.displayDb, g_gui.monitorEdidHashes[monitorIndex]);
+        if (record && record->primariesValid) {
+            const float* p = record->primaries;
+            result = { p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7] };
+            result.valid = true;
+            std::cout << "EDID primaries for monitor " << monitorIndex << " from the display database" << std::endl;
+            return result;
+        }
+    }
+
     // Get DisplayInfo for this monitor to get the device path
     DisplayInfo displayInfo;
     if (!GetDisplayInfoForMonitor(monitorIndex, displayInfo)) {
@@ -516,8 +545,9 @@ MonitorPrimaries GetMonitorPrimariesFromEDID(int monitorIndex) {
         return result;
     }
 
-    // Extract hardware ID from device path
-    std::wstring hardwareId = ExtractHardwareIdFromPath(displayInfo.devicePath);
+    // Extract the instance ID (or at least the hardware ID) from the device path
+    std::wstring hardwareId = ExtractInstanceIdFromPath(displayInfo.devicePath);
+    if (hardwareId.empty()) hardwareId = ExtractHardwareIdFromPath(displayInfo.devicePath);
     if (hardwareId.empty()) {
         std::cerr << "Could not extract hardware ID from device path" << std::endl;
         return result;
@@ -550,3 +580,222 @@ MonitorPrimaries GetMonitorPrimariesFromEDID(int monitorIndex) {
 
     return result;
 }
+
+// ============================================================================
+// Display identities
+// ============================================================================
+
+static std::string ToUtf8(const std::wstring& s) {
+    if (s.empty()) return std::string();
+    int len = WideCharToMultiByte(CP_UTF8, 0, s.c_str(), (int)s.size(), nullptr, 0, nullptr, nullptr);
+    std::string out(len, '\0');
+    WideCharToMultiByte(CP_UTF8, 0, s.c_str(), (int)s.size(), out.data(), len, nullptr, nullptr);
+    return out;
+}
+
+// Luminance range the OS reports for an output (DXGI_OUTPUT_DESC1)
+static void QueryOutputLuminance(IDXGIFactory1* factory, HMONITOR monitor, DisplayRecord& record) {
+    IDXGIAdapter1* adapter = nullptr;
+    for (UINT a = 0; factory->EnumAdapters1(a, &adapter) != DXGI_ERROR_NOT_FOUND; a++) {
+        IDXGIOutput* output = nullptr;
+        for (UINT o = 0; adapter->EnumOutputs(o, &output) != DXGI_ERROR_NOT_FOUND; o++) {
+            DXGI_OUTPUT_DESC desc;
+            IDXGIOutput6* output6 = nullptr;
+            bool match = SUCCEEDED(output->GetDesc(&desc)) && desc.Monitor == monitor;
+            if (match && SUCCEEDED(output->QueryInterface(__uuidof(IDXGIOutput6), (void**)&output6))) {
+                DXGI_OUTPUT_DESC1 desc1;
+                if (SUCCEEDED(output6->GetDesc1(&desc1))) {
+                    record.minLuminance = desc1.MinLuminance;
+                    record.maxLuminance = desc1.MaxLuminance;
+                    record.maxFullFrameLuminance = desc1.MaxFullFrameLuminance;
+                }
+                output6->Release();
+            }
+            output->Release();
+            if (match) {
+                adapter->Release();
+                return;
+            }
+        }
+        adapter->Release();
+    }
+}
+
+// Active display paths (QDC_ONLY_ACTIVE_PATHS)
+static bool QueryActivePaths(std::vector<DISPLAYCONFIG_PATH_INFO>& paths) {
+    UINT32 pathCount = 0, modeCount = 0;
+    if (GetDisplayConfigBufferSizes(QDC_ONLY_ACTIVE_PATHS, &pathCount, &modeCount) != ERROR_SUCCESS) {
+        return false;
+    }
+    paths.resize(pathCount);
+    std::vector<DISPLAYCONFIG_MODE_INFO> modes(modeCount);
+    if (QueryDisplayConfig(QDC_ONLY_ACTIVE_PATHS, &pathCount, paths.data(),
+        &modeCount, modes.data(), nullptr) != ERROR_SUCCESS) {
+        return false;
+    }
+    paths.resize(pathCount);
+    return true;
+}
+
+// GDI device name (\\.\DISPLAY1) -> active path -> monitor target name
+static const DISPLAYCONFIG_PATH_INFO* FindMonitorTarget(const std::vector<DISPLAYCONFIG_PATH_INFO>& paths,
+                                                        const wchar_t* gdiDeviceName,
+                                                        DISPLAYCONFIG_TARGET_DEVICE_NAME& targetName) {
+    for (const auto& candidate : paths) {
+        DISPLAYCONFIG_SOURCE_DEVICE_NAME sourceName = {};
+        sourceName.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_SOURCE_NAME;
+        sourceName.header.size = sizeof(sourceName);
+        sourceName.header.adapterId = candidate.sourceInfo.adapterId;
+        sourceName.header.id = candidate.sourceInfo.id;
+        if (DisplayConfigGetDeviceInfo(&sourceName.header) != ERROR_SUCCESS ||
+            _wcsicmp(sourceName.viewGdiDeviceName, gdiDeviceName) != 0) {
+            continue;
+        }
+        targetName = {};
+        targetName.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_TARGET_NAME;
+        targetName.header.size = sizeof(targetName);
+        targetName.header.adapterId = candidate.targetInfo.adapterId;
+        targetName.header.id = candidate.targetInfo.id;
+        return DisplayConfigGetDeviceInfo(&targetName.header) == ERROR_SUCCESS ? &candidate : nullptr;
+    }
+    return nullptr;
+}
+
+static std::string LowercaseDevicePath(const wchar_t* monitorDevicePath) {
+    std::wstring devicePathW = monitorDevicePath;
+    std::transform(devicePathW.begin(), devicePathW.end(), devicePathW.begin(), ::towlower);
+    return ToUtf8(devicePathW);
+}
+
+// EDID hash of the display on this target. The device path is only a hint: a different monitor
+// can appear behind the same path (swapped on a port, or a dock), so it is used only when the EDID
+// can't be read. edid is left empty in that case. 0 when neither identifies the display.
+static uint64_t IdentifyDisplay(const DISPLAYCONFIG_TARGET_DEVICE_NAME& targetName, const std::string& devicePath,
+                                const DisplayDatabase& db, std::vector<BYTE>& edid) {
+    edid.clear();
+    std::wstring instanceId = ExtractInstanceIdFromPath(targetName.monitorDevicePath);
+    if (!instanceId.empty() && ReadEDIDFromRegistry(instanceId.c_str(), edid) && !edid.empty()) {
+        return HashEDID(edid.data(), edid.size());
+    }
+    edid.clear();
+    return FindDisplayByDevicePath(db, devicePath);
+}
+
+void RefreshDisplayIdentities(const std::vector<HMONITOR>& monitors, DisplayDatabase& db,
+                              std::vector<uint64_t>& outHashes) {
+    outHashes.assign(monitors.size(), 0);
+
+    std::vector<DISPLAYCONFIG_PATH_INFO> paths;
+    if (!QueryActivePaths(paths)) return;
+
+    IDXGIFactory1* factory = nullptr;  // Only created for displays seen for the first time
+    for (size_t i = 0; i < monitors.size(); i++) {
+        MONITORINFOEXW mi = {};
+        mi.cbSize = sizeof(mi);
+        if (!GetMonitorInfoW(monitors[i], &mi)) continue;
+
+        DISPLAYCONFIG_TARGET_DEVICE_NAME targetName;
+        const DISPLAYCONFIG_PATH_INFO* path = FindMonitorTarget(paths, mi.szDevice, targetName);
+        if (!path) continue;
+        std::string devicePath = LowercaseDevicePath(targetName.monitorDevicePath);
+
+        std::vector<BYTE> edid;
+        uint64_t hash = IdentifyDisplay(targetName, devicePath, db, edid);
+        if (!hash) {
+            std::wcerr << L"No EDID for " << mi.szDevice << L", its settings stay index-based" << std::endl;
+            continue;
+        }
+        uint64_t lastOnPath = FindDisplayByDevicePath(db, devicePath);
+        if (lastOnPath && lastOnPath != hash) {
+            std::wcout << L"Different display on " << mi.szDevice << L" than last time" << std::endl;
+        }
+
+        DisplayRecord record;
+        if (edid.empty()) {
+            // EDID unreadable: the record last seen on this path is the best guess
+            std::wcerr << L"No EDID for " << mi.szDevice << L", using the display last seen on its port" << std::endl;
+            record = *FindDisplay(db, hash);
+        } else if (const DisplayRecord* known = FindDisplay(db, hash)) {
+            record = *known;  // Seen before (on this port or another)
+        } else {
+            record.edidHash = hash;
+            MonitorPrimaries primaries;
+            if (ParseEDIDChromaticity(edid.data(), edid.size(), primaries)) {
+                const float p[8] = { primaries.Rx, primaries.Ry, primaries.Gx, primaries.Gy,
+                                     primaries.Bx, primaries.By, primaries.Wx, primaries.Wy };
+                memcpy(record.primaries, p, sizeof(p));
+                record.primariesValid = ComputeRgbToXYZ(record.primaries, record.rgbToXYZ);
+            }
+
+            DISPLAYCONFIG_GET_ADVANCED_COLOR_INFO colorInfo = {};
+            colorInfo.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_ADVANCED_COLOR_INFO;
+            colorInfo.header.size = sizeof(colorInfo);
+            colorInfo.header.adapterId = path->targetInfo.adapterId;
+            colorInfo.header.id = path->targetInfo.id;
+            if (DisplayConfigGetDeviceInfo(&colorInfo.header) == ERROR_SUCCESS) {
+                record.hdrCapable = (colorInfo.value & 0x1) != 0;
+            }
+            if (factory || SUCCEEDED(CreateDXGIFactory1(__uuidof(IDXGIFactory1), (void**)&factory))) {
+                QueryOutputLuminance(factory, monitors[i], record);
+            }
+            std::wcout << L"New display " << targetName.monitorFriendlyDeviceName << L" on " << mi.szDevice << std::endl;
+        }
+
+        record.name = ToUtf8(targetName.monitorFriendlyDeviceName);
+        record.devicePath = devicePath;
+        const DISPLAYCONFIG_RATIONAL& refresh = path->targetInfo.refreshRate;
+        record.refreshMilliHz = refresh.Denominator ? (uint32_t)((uint64_t)refresh.Numerator * 1000 / refresh.Denominator) : 0;
+        record.lastIndex = (int)i;
+        UpdateDisplay(db, record);
+        outHashes[i] = hash;
+    }
+    if (factory) factory->Release();
+}
+
+void DescribeTopology(const std::vector<HMONITOR>& monitors, const DisplayDatabase& db,
+                      std::vector<TopologyDisplay>& out) {
+    out.assign(monitors.size(), TopologyDisplay());
+    std::vector<DISPLAYCONFIG_PATH_INFO> paths;
+    QueryActivePaths(paths);
+
+    for (size_t i = 0; i < monitors.size(); i++) {
+        TopologyDisplay& display = out[i];
+        display.handle = reinterpret_cast<uintptr_t>(monitors[i]);
+
+        MONITORINFOEXW mi = {};
+        mi.cbSize = sizeof(mi);
+        if (!GetMonitorInfoW(monitors[i], &mi)) continue;
+        display.x = mi.rcMonitor.left;
+        display.y = mi.rcMonitor.top;
+        display.width = mi.rcMonitor.right - mi.rcMonitor.left;
+        display.height = mi.rcMonitor.bottom - mi.rcMonitor.top;
+
+        DISPLAYCONFIG_TARGET_DEVICE_NAME targetName;
+        const DISPLAYCONFIG_PATH_INFO* path = FindMonitorTarget(paths, mi.szDevice, targetName);
+        if (!path) {
+            // No target (mirror/virtual): the GDI name is the best identity there is
+            std::string name = ToUtf8(mi.szDevice);
+            display.id = HashEDID(reinterpret_cast<const uint8_t*>(name.data()), name.size());
+            continue;
+        }
+        display.adapter.lowPart = path->targetInfo.adapterId.LowPart;
+        display.adapter.highPart = path->targetInfo.adapterId.HighPart;
+
+        DISPLAYCONFIG_GET_ADVANCED_COLOR_INFO colorInfo = {};
+        colorInfo.header.type = DISPLAYCONFIG_DEVICE_INFO_GET_ADVANCED_COLOR_INFO;
+        colorInfo.header.size = sizeof(colorInfo);
+        colorInfo.header.adapterId = path->targetInfo.adapterId;
+        colorInfo.header.id = path->targetInfo.id;
+        if (DisplayConfigGetDeviceInfo(&colorInfo.header) == ERROR_SUCCESS) {
+            display.hdr = (colorInfo.value & 0x2) != 0;  // advancedColorEnabled
+        }
+
+        // Same identity the GUI keys settings by: the EDID hash (path hint without one), else the path itself
+        std::string devicePath = LowercaseDevicePath(targetName.monitorDevicePath);
+        std::vector<BYTE> edid;
+        display.id = IdentifyDisplay(targetName, devicePath, db, edid);
+        if (!display.id) {
+            display.id = HashEDID(reinterpret_cast<const uint8_t*>(devicePath.data()), devicePath.size());
+        }
+    }
+}
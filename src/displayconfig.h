@@ -4,6 +4,8 @@
 #pragma once
 
 #include <windows.h>
+#include "displaydb.h"
+#include "topology.h"
 #include <string>
 #include <vector>
 
@@ -56,3 +58,18 @@ MonitorPrimaries GetMonitorPrimaries(int monitorIndex);
 // This is more reliable than GetMonitorPrimaries() as it reads actual EDID values
 // Returns primaries with valid=true if successful
 MonitorPrimaries GetMonitorPrimariesFromEDID(int monitorIndex);
+
+// Resolve each monitor (GUI order) to its display identity and refresh its database record.
+// Every refresh reads and hashes the EDID (the device path is only a fallback when it can't be
+// read); displays not in the database are also parsed and probed once. outHashes[i] = 0 when
+// monitor i has neither a readable EDID nor a known device path.
+void RefreshDisplayIdentities(const std::vector<HMONITOR>& monitors, DisplayDatabase& db,
+                              std::vector<uint64_t>& outHashes);
+
+// Snapshot of the given monitors for topology reconciliation (same order). Ids match the
+// identities RefreshDisplayIdentities assigns; displays without an EDID hash their device path.
+void DescribeTopology(const std::vector<HMONITOR>& monitors, const DisplayDatabase& db,
+                      std::vector<TopologyDisplay>& out);
+
+// Decode the chromaticity block (bytes 25-34) of a base EDID; false if too short or bad header
+bool ParseEDIDChromaticity(const BYTE* edid, size_t edidSize, MonitorPrimaries& primaries);
@@ -0,0 +1,310 @@
+// DesktopLUT - displaydb.cpp
+// Display identity database: per-display records keyed by an EDID content hash, the text file
+// they persist in, and the mapping of monitors to their settings sections
+
+#include "displaydb.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+static const char* DB_HEADER = "# DesktopLUT display database";
+
+uint64_t HashEDID(const uint8_t* edid, size_t size) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= edid[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash ? hash : 1;
+}
+
+bool ComputeRgbToXYZ(const float* p, float* m) {
+    // Columns: XYZ of each primary at Y = 1, scaled so R + G + B = white
+    double prim[3][3];
+    for (int i = 0; i < 3; i++) {
+        double x = p[i * 2], y = p[i * 2 + 1];
+        if (y <= 0.0) return false;
+        prim[0][i] = x / y;
+        prim[1][i] = 1.0;
+        prim[2][i] = (1.0 - x - y) / y;
+    }
+    if (p[7] <= 0.0f) return false;
+    double white[3] = { p[6] / (double)p[7], 1.0, (1.0 - p[6] - p[7]) / (double)p[7] };
+
+    double det = prim[0][0] * (prim[1][1] * prim[2][2] - prim[1][2] * prim[2][1])
+               - prim[0][1] * (prim[1][0] * prim[2][2] - prim[1][2] * prim[2][0])
+               + prim[0][2] * (prim[1][0] * prim[2][1] - prim[1][1] * prim[2][0]);
+    if (fabs(det) < 1e-12) return false;
+
+    // Solve prim * s = white (Cramer's rule)
+    double s[3];
+    for (int c = 0; c < 3; c++) {
+        double t[3][3];
+        memcpy(t, prim, sizeof(t));
+        for (int r = 0; r < 3; r++) t[r][c] = white[r];
+        s[c] = (t[0][0] * (t[1][1] * t[2][2] - t[1][2] * t[2][1])
+              - t[0][1] * (t[1][0] * t[2][2] - t[1][2] * t[2][0])
+              + t[0][2] * (t[1][0] * t[2][1] - t[1][1] * t[2][0])) / det;
+    }
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) m[r * 3 + c] = (float)(prim[r][c] * s[c]);
+    }
+    return true;
+}
+
+const DisplayRecord* FindDisplay(const DisplayDatabase& db, uint64_t edidHash) {
+    auto it = db.records.find(edidHash);
+    return it != db.records.end() ? &it->second : nullptr;
+}
+
+uint64_t FindDisplayByDevicePath(const DisplayDatabase& db, const std::string& devicePath) {
+    auto it = db.byDevicePath.find(devicePath);
+    return it != db.byDevicePath.end() ? it->second : 0;
+}
+
+static bool SameRecord(const DisplayRecord& a, const DisplayRecord& b) {
+    return a.edidHash == b.edidHash && a.name == b.name && a.devicePath == b.devicePath &&
+           a.primariesValid == b.primariesValid && memcmp(a.primaries, b.primaries, sizeof(a.primaries)) == 0 &&
+           memcmp(a.rgbToXYZ, b.rgbToXYZ, sizeof(a.rgbToXYZ)) == 0 &&
+           a.minLuminance == b.minLuminance && a.maxLuminance == b.maxLuminance &&
+           a.maxFullFrameLuminance == b.maxFullFrameLuminance && a.hdrCapable == b.hdrCapable &&
+           a.refreshMilliHz == b.refreshMilliHz && a.lastIndex == b.lastIndex;
+}
+
+void UpdateDisplay(DisplayDatabase& db, const DisplayRecord& record) {
+    if (record.edidHash == 0) return;
+    auto it = db.records.find(record.edidHash);
+    if (it != db.records.end()) {
+        if (SameRecord(it->second, record)) return;
+        // A device path moves with the display (different port = different path)
+        if (!it->second.devicePath.empty()) db.byDevicePath.erase(it->second.devicePath);
+        it->second = record;
+    } else {
+        db.records.emplace(record.edidHash, record);
+    }
+    if (!record.devicePath.empty()) {
+        // A different display now behind this path: the old record no longer owns it
+        auto owner = db.byDevicePath.find(record.devicePath);
+        if (owner != db.byDevicePath.end() && owner->second != record.edidHash) {
+            auto previous = db.records.find(owner->second);
+            if (previous != db.records.end()) previous->second.devicePath.clear();
+        }
+        db.byDevicePath[record.devicePath] = record.edidHash;
+    }
+    db.dirty = true;
+}
+
+void IndexDisplayDatabase(DisplayDatabase& db) {
+    db.byDevicePath.clear();
+    for (const auto& [hash, record] : db.records) {
+        if (!record.devicePath.empty()) db.byDevicePath[record.devicePath] = hash;
+    }
+}
+
+// ============================================================================
+// Text form
+// ============================================================================
+
+static void WriteFloats(std::ostringstream& out, const char* key, const float* v, int count) {
+    out << key << '=';
+    char buf[32];
+    for (int i = 0; i < count; i++) {
+        snprintf(buf, sizeof(buf), "%.9g", v[i]);   // Round-trips exactly
+        out << (i ? "," : "") << buf;
+    }
+    out << '\n';
+}
+
+static bool ReadFloats(const std::string& value, float* v, int count) {
+    const char* p = value.c_str();
+    for (int i = 0; i < count; i++) {
+        char* end = nullptr;
+        v[i] = strtof(p, &end);
+        if (end == p) return false;
+        p = end;
+        if (i + 1 < count) {
+            if (*p != ',') return false;
+            p++;
+        }
+    }
+    return *p == '\0';
+}
+
+std::string SerializeDisplayDatabase(const DisplayDatabase& db) {
+    std::ostringstream out;
+    out << DB_HEADER << " v" << DISPLAY_DB_VERSION << '\n';
+    // Sorted so the file only changes where a record did
+    std::vector<const DisplayRecord*> sorted;
+    for (const auto& entry : db.records) sorted.push_back(&entry.second);
+    std::sort(sorted.begin(), sorted.end(),
+              [](const DisplayRecord* a, const DisplayRecord* b) { return a->edidHash < b->edidHash; });
+    for (const DisplayRecord* rec : sorted) {
+        const DisplayRecord& r = *rec;
+        uint64_t hash = r.edidHash;
+        char key[24];
+        snprintf(key, sizeof(key), "%016llx", (unsigned long long)hash);
+        out << '\n' << '[' << key << "]\n";
+        out << "Name=" << r.name << '\n';
+        out << "DevicePath=" << r.devicePath << '\n';
+        if (r.primariesValid) {
+            WriteFloats(out, "Primaries", r.primaries, 8);
+            WriteFloats(out, "RgbToXYZ", r.rgbToXYZ, 9);
+        }
+        float luminance[3] = { r.minLuminance, r.maxLuminance, r.maxFullFrameLuminance };
+        WriteFloats(out, "Luminance", luminance, 3);
+        out << "HdrCapable=" << (r.hdrCapable ? 1 : 0) << '\n';
+        out << "RefreshMilliHz=" << r.refreshMilliHz << '\n';
+        out << "LastIndex=" << r.lastIndex << '\n';
+    }
+    return out.str();
+}
+
+bool ParseDisplayDatabase(const std::string& text, DisplayDatabase& db) {
+    db.records.clear();
+    db.byDevicePath.clear();
+    db.dirty = false;
+
+    std::istringstream in(text);
+    std::string line;
+    if (!std::getline(in, line) || line.compare(0, strlen(DB_HEADER), DB_HEADER) != 0) return false;
+    size_t v = line.find(" v", strlen(DB_HEADER));
+    if (v == std::string::npos || atoi(line.c_str() + v + 2) > DISPLAY_DB_VERSION) return false;
+
+    DisplayRecord* current = nullptr;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+        if (line[0] == '[') {
+            current = nullptr;
+            char* end = nullptr;
+            uint64_t hash = strtoull(line.c_str() + 1, &end, 16);
+            if (hash != 0 && end == line.c_str() + 17 && *end == ']') {
+                current = &db.records[hash];
+                current->edidHash = hash;
+            }
+            continue;
+        }
+        size_t eq = line.find('=');
+        if (!current || eq == std::string::npos) continue;
+        std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+
+        if (key == "Name") current->name = value;
+        else if (key == "DevicePath") current->devicePath = value;
+        else if (key == "Primaries") current->primariesValid = ReadFloats(value, current->primaries, 8);
+        else if (key == "RgbToXYZ") ReadFloats(value, current->rgbToXYZ, 9);
+        else if (key == "Luminance") {
+            float l[3];
+            if (ReadFloats(value, l, 3)) {
+                current->minLuminance = l[0];
+                current->maxLuminance = l[1];
+                current->maxFullFrameLuminance = l[2];
+            }
+        }
+        else if (key == "HdrCapable") current->hdrCapable = atoi(value.c_str()) != 0;
+        else if (key == "RefreshMilliHz") current->refreshMilliHz = (uint32_t)strtoul(value.c_str(), nullptr, 10);
+        else if (key == "LastIndex") current->lastIndex = atoi(value.c_str());
+    }
+
+    // Files written without a matrix (hand-edited primaries) get it derived here
+    for (auto& [hash, r] : db.records) {
+        if (r.primariesValid && r.rgbToXYZ[4] == 0.0f && !ComputeRgbToXYZ(r.primaries, r.rgbToXYZ)) {
+            r.primariesValid = false;
+        }
+    }
+    IndexDisplayDatabase(db);
+    return true;
+}
+
+bool LoadDisplayDatabase(const std::wstring& path, DisplayDatabase& db) {
+    std::ifstream file(std::filesystem::path(path), std::ios::binary);
+    if (!file) {
+        db = DisplayDatabase();
+        return true;  // First run
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!ParseDisplayDatabase(text, db)) {
+        db = DisplayDatabase();
+        return false;
+    }
+    return true;
+}
+
+bool SaveDisplayDatabase(const std::wstring& path, DisplayDatabase& db) {
+    std::filesystem::path target(path);
+    std::filesystem::path temp = target;
+    temp += L".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+        std::string text = SerializeDisplayDatabase(db);
+        file.write(text.data(), (std::streamsize)text.size());
+        if (!file) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, target, ec);
+    if (ec) {
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    db.dirty = false;
+    return true;
+}
+
+// ============================================================================
+// Settings sections
+// ============================================================================
+
+std::wstring DisplaySettingsSection(uint64_t edidHash) {
+    wchar_t buf[32];
+    swprintf(buf, 32, L"Display.%016llx", (unsigned long long)edidHash);
+    return buf;
+}
+
+std::wstring LegacyMonitorSection(int index) {
+    return L"Monitor" + std::to_wstring(index);
+}
+
+std::vector<MonitorSectionPlan> PlanMonitorSections(const std::vector<uint64_t>& edidHashes,
+                                                    const std::unordered_set<std::wstring>& existingSections) {
+    // Legacy sections are only trusted on the first run after the upgrade: once any display
+    // section exists, Monitor<i> may describe whatever was plugged in at index i back then
+    bool upgraded = false;
+    for (const auto& name : existingSections) {
+        if (name.compare(0, 8, L"display.") == 0) {
+            upgraded = true;
+            break;
+        }
+    }
+
+    std::vector<MonitorSectionPlan> plans(edidHashes.size());
+    std::unordered_set<uint64_t> claimed;
+    for (size_t i = 0; i < edidHashes.size(); i++) {
+        MonitorSectionPlan& plan = plans[i];
+        std::wstring legacy = LegacyMonitorSection((int)i);
+        uint64_t hash = edidHashes[i];
+        if (hash == 0 || !claimed.insert(hash).second) {
+            plan.loadFrom = plan.saveTo = legacy;
+            continue;
+        }
+        plan.saveTo = DisplaySettingsSection(hash);
+        std::wstring lower = plan.saveTo;
+        for (auto& c : lower) c = (wchar_t)towlower(c);
+        std::wstring legacyLower = legacy;
+        for (auto& c : legacyLower) c = (wchar_t)towlower(c);
+
+        if (!upgraded && !existingSections.count(lower) && existingSections.count(legacyLower)) {
+            plan.loadFrom = legacy;
+            plan.migrateLegacy = true;
+        } else {
+            plan.loadFrom = plan.saveTo;
+        }
+    }
+    return plans;
+}
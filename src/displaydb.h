@@ -0,0 +1,85 @@
+// DesktopLUT - displaydb.h
+// Display identity database: per-display records keyed by an EDID content hash, the text file
+// they persist in, and the mapping of monitors to their settings sections (with migration from
+// the old index-based Monitor%d sections)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// File: UTF-8 text, one [<16 hex digit EDID hash>] section per display, key=value lines.
+// Unknown keys are ignored so older builds can read newer files.
+constexpr int DISPLAY_DB_VERSION = 1;
+
+struct DisplayRecord {
+    uint64_t edidHash = 0;
+    std::string name;                  // Friendly name when last seen (UTF-8)
+    std::string devicePath;            // Lowercase monitor device path; identity hint when the EDID can't be read
+    float primaries[8] = {};           // Rx Ry Gx Gy Bx By Wx Wy from the EDID chromaticity block
+    bool primariesValid = false;
+    float rgbToXYZ[9] = {};            // Row-major, Y of white = 1 (valid with primaries)
+    float minLuminance = 0.0f;         // Nits as reported by DXGI (0 = not queried yet)
+    float maxLuminance = 0.0f;
+    float maxFullFrameLuminance = 0.0f;
+    bool hdrCapable = false;
+    uint32_t refreshMilliHz = 0;       // Refresh of the active mode, 59940 = 59.94 Hz
+    int lastIndex = -1;                // Monitor index when last seen (diagnostics)
+};
+
+struct DisplayDatabase {
+    std::unordered_map<uint64_t, DisplayRecord> records;
+    std::unordered_map<std::string, uint64_t> byDevicePath;   // Rebuilt by IndexDisplayDatabase
+    bool dirty = false;                                       // Needs saving
+};
+
+// FNV-1a 64 over the full EDID blob (extension blocks included). 0 is reserved for "unknown".
+uint64_t HashEDID(const uint8_t* edid, size_t size);
+
+// Normalized primary matrix (RGB -> XYZ) for xy primaries Rx Ry Gx Gy Bx By Wx Wy.
+// False for degenerate primaries.
+bool ComputeRgbToXYZ(const float* primaries, float* outMatrix);
+
+// O(1) lookups; null when the display isn't known
+const DisplayRecord* FindDisplay(const DisplayDatabase& db, uint64_t edidHash);
+uint64_t FindDisplayByDevicePath(const DisplayDatabase& db, const std::string& devicePath);
+
+// Insert or replace a record (keeps the device path index current - a path taken over by another
+// display is dropped from the old record - and marks the database dirty only when something changed)
+void UpdateDisplay(DisplayDatabase& db, const DisplayRecord& record);
+
+// Rebuild byDevicePath from records
+void IndexDisplayDatabase(DisplayDatabase& db);
+
+// Text form. Parsing replaces db's contents; malformed lines are skipped. False if the header
+// is missing or the version is newer than this build understands.
+std::string SerializeDisplayDatabase(const DisplayDatabase& db);
+bool ParseDisplayDatabase(const std::string& text, DisplayDatabase& db);
+
+// One read at startup / write-to-temp-and-rename on save. A missing file loads as empty.
+bool LoadDisplayDatabase(const std::wstring& path, DisplayDatabase& db);
+bool SaveDisplayDatabase(const std::wstring& path, DisplayDatabase& db);
+
+// ============================================================================
+// Settings sections
+// ============================================================================
+
+// Per-monitor settings live in [Display.<hash>]; monitors without a readable EDID, and the
+// second of two displays with identical EDIDs, keep the legacy index section [Monitor<i>].
+std::wstring DisplaySettingsSection(uint64_t edidHash);
+std::wstring LegacyMonitorSection(int index);
+
+struct MonitorSectionPlan {
+    std::wstring loadFrom;     // Section to read (absent = defaults)
+    std::wstring saveTo;       // Section to write
+    bool migrateLegacy = false;  // loadFrom is [Monitor<i>]; delete it once saveTo is written
+};
+
+// edidHashes: one per monitor in GUI order, 0 = unknown.
+// existingSections: section names present in the INI, lowercased.
+std::vector<MonitorSectionPlan> PlanMonitorSections(const std::vector<uint64_t>& edidHashes,
+                                                    const std::unordered_set<std::wstring>& existingSections);
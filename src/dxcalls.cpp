@@ -0,0 +1,136 @@
+// DesktopLUT - dxcalls.cpp
+// Duplication, swapchain and device calls the render loop can fail on, routed through one place
+// so scripted faults can be injected into them (developer instrumentation)
+
+#include "dxcalls.h"
+
+#if DESKTOPLUT_FAULT_INJECTION
+
+#include "faultinject.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+static FaultInjector g_faultInjector;
+static std::atomic<bool> g_faultsArmed{ false };
+
+// First unrecovered fault per monitor, cleared by the next successful Present
+struct PendingFault {
+    std::string label;
+    std::chrono::steady_clock::time_point start{};
+};
+static PendingFault g_pendingFaults[METRICS_MAX_MONITORS];
+static std::mutex g_pendingLock;
+
+bool LoadFaultScript(const std::wstring& path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::wcerr << L"Fault script not found: " << path << std::endl;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+
+    FaultScript script;
+    std::string error;
+    if (!ParseFaultScript(text.str(), script, error)) {
+        std::cerr << "Fault script " << error << std::endl;
+        return false;
+    }
+    ResetFaultInjector(g_faultInjector, script);
+    g_faultsArmed = true;
+    std::cout << "Fault injection armed: " << script.rules.size() << " rule(s), seed " << script.seed << std::endl;
+    return true;
+}
+
+static void NotePendingFault(int monitorIndex, const std::string& label) {
+    std::lock_guard<std::mutex> guard(g_pendingLock);
+    for (int m = 0; m < METRICS_MAX_MONITORS; m++) {
+        if (monitorIndex >= 0 && m != monitorIndex) continue;  // -1 = device-wide
+        if (g_pendingFaults[m].label.empty()) {
+            g_pendingFaults[m].label = label;
+            g_pendingFaults[m].start = std::chrono::steady_clock::now();
+        }
+    }
+}
+
+static void NotePresented(MonitorContext* ctx) {
+    if (ctx->index < 0 || ctx->index >= METRICS_MAX_MONITORS) return;
+    std::lock_guard<std::mutex> guard(g_pendingLock);
+    PendingFault& pending = g_pendingFaults[ctx->index];
+    if (pending.label.empty()) return;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - pending.start).count();
+    double lost = ctx->refreshPeriodMs > 0.0 ? ms / ctx->refreshPeriodMs - 1.0 : 0.0;
+    std::cout << "Monitor " << ctx->index << " recovered from " << pending.label << " in " << (int)ms
+              << " ms (~" << (lost > 0.0 ? (int)(lost + 0.5) : 0) << " frames lost)" << std::endl;
+    pending.label.clear();
+}
+
+// Decide the fault for a call; delays and hangs sleep here. True if the call must fail with `hr`.
+static bool Inject(MonitorContext* ctx, FaultSite site, HRESULT& hr, FaultDecision* outDecision = nullptr) {
+    if (!g_faultsArmed.load(std::memory_order_relaxed)) return false;
+    FaultDecision d = NextFault(g_faultInjector, site);
+    if (outDecision) *outDecision = d;
+    if (d.kind == FAULT_NONE) return false;
+
+    NotePendingFault(ctx ? ctx->index : -1, FaultLabel(site, d));
+    if (d.kind == FAULT_DELAY || d.kind == FAULT_HANG) Sleep(d.ms);
+    hr = (HRESULT)d.hr;
+    return d.kind == FAULT_ERROR || d.kind == FAULT_HANG;
+}
+
+HRESULT DxAcquireNextFrame(MonitorContext* ctx, UINT timeoutMs, DXGI_OUTDUPL_FRAME_INFO* info, IDXGIResource** resource) {
+    HRESULT hr;
+    if (Inject(ctx, FAULT_SITE_ACQUIRE, hr)) return hr;
+    return ctx->duplication->AcquireNextFrame(timeoutMs, info, resource);
+}
+
+DXGI_FORMAT DxFrameFormat(MonitorContext* ctx, DXGI_FORMAT format) {
+    HRESULT hr;
+    FaultDecision d;
+    Inject(ctx, FAULT_SITE_FRAME, hr, &d);
+    return d.kind == FAULT_FORMAT ? (DXGI_FORMAT)d.format : format;
+}
+
+HRESULT DxDuplicateOutput(MonitorContext* ctx, IDXGIOutput1* output) {
+    HRESULT hr;
+    if (Inject(ctx, FAULT_SITE_DUPLICATE, hr)) return hr;
+    return output->DuplicateOutput(ctx->gpu->device, &ctx->duplication);
+}
+
+HRESULT DxDuplicateOutput1(MonitorContext* ctx, IDXGIOutput5* output, UINT formatCount, const DXGI_FORMAT* formats) {
+    HRESULT hr;
+    if (Inject(ctx, FAULT_SITE_DUPLICATE, hr)) return hr;
+    return output->DuplicateOutput1(ctx->gpu->device, 0, formatCount, formats, &ctx->duplication);
+}
+
+HRESULT DxPresent(MonitorContext* ctx, UINT syncInterval, UINT flags) {
+    HRESULT hr;
+    if (Inject(ctx, FAULT_SITE_PRESENT, hr)) return hr;
+    hr = ctx->swapchain->Present(syncInterval, flags);
+    if (SUCCEEDED(hr)) NotePresented(ctx);
+    return hr;
+}
+
+HRESULT DxResizeBuffers(MonitorContext* ctx, UINT width, UINT height, UINT flags) {
+    HRESULT hr;
+    if (Inject(ctx, FAULT_SITE_RESIZE, hr)) return hr;
+    return ctx->swapchain->ResizeBuffers(2, width, height, ctx->swapchainFormat, flags);
+}
+
+HRESULT DxCreateSwapChainForComposition(MonitorContext* ctx, IDXGIFactory2* factory, const DXGI_SWAP_CHAIN_DESC1* desc,
+                                        IDXGISwapChain1** swapchain) {
+    HRESULT hr;
+    if (Inject(ctx, FAULT_SITE_SWAPCHAIN, hr)) return hr;
+    return factory->CreateSwapChainForComposition(ctx->gpu->device, desc, nullptr, swapchain);
+}
+
+HRESULT DxGetDeviceRemovedReason(ID3D11Device* device) {
+    HRESULT hr;
+    if (Inject(nullptr, FAULT_SITE_DEVICE, hr)) return hr;
+    return device->GetDeviceRemovedReason();
+}
+
+#endif
@@ -0,0 +1,56 @@
+// DesktopLUT - dxcalls.h
+// Duplication, swapchain and device calls the render loop can fail on, routed through one place
+// so scripted faults can be injected into them (developer instrumentation)
+
+#pragma once
+
+#include "types.h"
+
+// Build with DESKTOPLUT_FAULT_INJECTION=1 (Preprocessor Definitions) and start with
+// --faults script.txt to fail, delay or hang these calls on the schedule in the script
+// (format in faultinject.h). Each monitor logs how long it took to present a corrected
+// frame again after an injected fault. Compiled out, the wrappers are plain forwards.
+#ifndef DESKTOPLUT_FAULT_INJECTION
+#define DESKTOPLUT_FAULT_INJECTION 0
+#endif
+
+#if DESKTOPLUT_FAULT_INJECTION
+
+// Load and arm a fault script (false with the parse error logged)
+bool LoadFaultScript(const std::wstring& path);
+
+HRESULT DxAcquireNextFrame(MonitorContext* ctx, UINT timeoutMs, DXGI_OUTDUPL_FRAME_INFO* info, IDXGIResource** resource);
+DXGI_FORMAT DxFrameFormat(MonitorContext* ctx, DXGI_FORMAT format);
+HRESULT DxDuplicateOutput(MonitorContext* ctx, IDXGIOutput1* output);
+HRESULT DxDuplicateOutput1(MonitorContext* ctx, IDXGIOutput5* output, UINT formatCount, const DXGI_FORMAT* formats);
+HRESULT DxPresent(MonitorContext* ctx, UINT syncInterval, UINT flags);
+HRESULT DxResizeBuffers(MonitorContext* ctx, UINT width, UINT height, UINT flags);
+HRESULT DxCreateSwapChainForComposition(MonitorContext* ctx, IDXGIFactory2* factory, const DXGI_SWAP_CHAIN_DESC1* desc,
+                                        IDXGISwapChain1** swapchain);
+HRESULT DxGetDeviceRemovedReason(ID3D11Device* device);
+
+#else
+
+inline HRESULT DxAcquireNextFrame(MonitorContext* ctx, UINT timeoutMs, DXGI_OUTDUPL_FRAME_INFO* info, IDXGIResource** resource) {
+    return ctx->duplication->AcquireNextFrame(timeoutMs, info, resource);
+}
+inline DXGI_FORMAT DxFrameFormat(MonitorContext*, DXGI_FORMAT format) { return format; }
+inline HRESULT DxDuplicateOutput(MonitorContext* ctx, IDXGIOutput1* output) {
+    return output->DuplicateOutput(ctx->gpu->device, &ctx->duplication);
+}
+inline HRESULT DxDuplicateOutput1(MonitorContext* ctx, IDXGIOutput5* output, UINT formatCount, const DXGI_FORMAT* formats) {
+    return output->DuplicateOutput1(ctx->gpu->device, 0, formatCount, formats, &ctx->duplication);
+}
+inline HRESULT DxPresent(MonitorContext* ctx, UINT syncInterval, UINT flags) {
+    return ctx->swapchain->Present(syncInterval, flags);
+}
+inline HRESULT DxResizeBuffers(MonitorContext* ctx, UINT width, UINT height, UINT flags) {
+    return ctx->swapchain->ResizeBuffers(2, width, height, ctx->swapchainFormat, flags);
+}
+inline HRESULT DxCreateSwapChainForComposition(MonitorContext* ctx, IDXGIFactory2* factory, const DXGI_SWAP_CHAIN_DESC1* desc,
+                                               IDXGISwapChain1** swapchain) {
+    return factory->CreateSwapChainForComposition(ctx->gpu->device, desc, nullptr, swapchain);
+}
+inline HRESULT DxGetDeviceRemovedReason(ID3D11Device* device) { return device->GetDeviceRemovedReason(); }
+
+#endif
@@ -0,0 +1,423 @@
+// DesktopLUT - faultinject.cpp
+// Scripted fault injection for duplication, swapchain and device calls, the duplication retry
+// backoff, and a simulated render loop that measures recovery under a fault script
+// (no Windows dependencies)
+
+#include "faultinject.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+static const char* SITE_NAMES[FAULT_SITE_COUNT] = {
+    "acquire", "frame", "duplicate", "present", "resize", "swapchain", "device",
+};
+
+static const char* KIND_NAMES[] = { "none", "error", "delay", "hang", "format" };
+
+static const struct { const char* name; int32_t hr; } HR_NAMES[] = {
+    { "access_lost", FAULT_HR_ACCESS_LOST },
+    { "device_removed", FAULT_HR_DEVICE_REMOVED },
+    { "device_reset", FAULT_HR_DEVICE_RESET },
+    { "device_hung", FAULT_HR_DEVICE_HUNG },
+    { "wait_timeout", FAULT_HR_WAIT_TIMEOUT },
+    { "session_disconnected", FAULT_HR_SESSION_DISCONNECTED },
+    { "unsupported", FAULT_HR_UNSUPPORTED },
+    { "invalid_call", FAULT_HR_INVALID_CALL },
+    { "access_denied", FAULT_HR_ACCESS_DENIED },
+    { "outofmemory", FAULT_HR_OUTOFMEMORY },
+};
+
+// What the call usually fails with in the field
+static int32_t DefaultFaultHr(FaultSite site) {
+    switch (site) {
+    case FAULT_SITE_ACQUIRE:   return FAULT_HR_ACCESS_LOST;
+    case FAULT_SITE_DUPLICATE: return FAULT_HR_ACCESS_DENIED;      // Secure desktop
+    case FAULT_SITE_PRESENT:   return FAULT_HR_DEVICE_REMOVED;
+    case FAULT_SITE_DEVICE:    return FAULT_HR_DEVICE_REMOVED;
+    default:                   return FAULT_HR_INVALID_CALL;
+    }
+}
+
+const char* FaultSiteName(FaultSite site) {
+    return site < FAULT_SITE_COUNT ? SITE_NAMES[site] : "unknown";
+}
+
+const char* FaultKindName(FaultKind kind) {
+    return kind <= FAULT_FORMAT ? KIND_NAMES[kind] : "unknown";
+}
+
+std::string FaultHrName(int32_t hr) {
+    for (const auto& entry : HR_NAMES) {
+        if (entry.hr == hr) return entry.name;
+    }
+    char hex[16];
+    snprintf(hex, sizeof(hex), "0x%08X", (uint32_t)hr);
+    return hex;
+}
+
+std::string FaultLabel(FaultSite site, const FaultDecision& d) {
+    std::string label = FaultSiteName(site);
+    label += ' ';
+    label += FaultKindName(d.kind);
+    if (d.kind == FAULT_ERROR || d.kind == FAULT_HANG) label += ' ' + FaultHrName(d.hr);
+    if (d.kind == FAULT_FORMAT) label += ' ' + std::to_string(d.format);
+    return label;
+}
+
+// ============================================================================
+// Script
+// ============================================================================
+
+// Decimal or 0x hex, at most `max` (strtoull alone would wrap "-1" and saturate overflows)
+static bool ParseUnsigned(const std::string& value, uint64_t& out, uint64_t max = UINT64_MAX) {
+    if (value.empty() || !isdigit((unsigned char)value[0])) return false;
+    char* end = nullptr;
+    errno = 0;
+    out = strtoull(value.c_str(), &end, 0);
+    return *end == '\0' && errno != ERANGE && out <= max;
+}
+
+static bool ParseHr(const std::string& value, int32_t& out) {
+    for (const auto& entry : HR_NAMES) {
+        if (value == entry.name) {
+            out = entry.hr;
+            return true;
+        }
+    }
+    uint64_t raw = 0;
+    if (!ParseUnsigned(value, raw, UINT32_MAX)) return false;
+    out = (int32_t)(uint32_t)raw;
+    return true;
+}
+
+static bool ParseRule(std::istringstream& words, const std::string& siteWord, FaultRule& rule, std::string& error) {
+    int site = -1;
+    for (int s = 0; s < FAULT_SITE_COUNT; s++) {
+        if (siteWord == SITE_NAMES[s]) site = s;
+    }
+    if (site < 0) {
+        error = "unknown site '" + siteWord + "'";
+        return false;
+    }
+    rule.site = (FaultSite)site;
+
+    std::string kindWord;
+    words >> kindWord;
+    int kind = -1;
+    for (int k = FAULT_ERROR; k <= FAULT_FORMAT; k++) {
+        if (kindWord == KIND_NAMES[k]) kind = k;
+    }
+    if (kind < 0) {
+        error = "unknown fault '" + kindWord + "'";
+        return false;
+    }
+    rule.kind = (FaultKind)kind;
+    if ((rule.kind == FAULT_FORMAT) != (rule.site == FAULT_SITE_FRAME)) {
+        error = "format faults apply to frame, and frame only takes format faults";
+        return false;
+    }
+
+    bool hasHr = false;
+    std::string option;
+    while (words >> option) {
+        size_t eq = option.find('=');
+        std::string key = option.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : option.substr(eq + 1);
+        uint64_t number = 0;
+        bool ok;
+        if (key == "hr") {
+            ok = ParseHr(value, rule.hr);
+            hasHr = true;
+        } else if (key == "p") {
+            char* end = nullptr;
+            rule.probability = strtod(value.c_str(), &end);
+            ok = !value.empty() && *end == '\0' && rule.probability >= 0.0 && rule.probability <= 1.0;
+        } else if (key == "every") {
+            ok = ParseUnsigned(value, number) && number > 0;
+            rule.every = number;
+        } else if (key == "after" || key == "until") {
+            ok = ParseUnsigned(value, number);
+            (key == "after" ? rule.after : rule.until) = number;
+        } else {
+            ok = ParseUnsigned(value, number, UINT32_MAX);
+            if (key == "ms") rule.ms = (uint32_t)number;
+            else if (key == "format") rule.format = (uint32_t)number;
+            else if (key == "limit") rule.limit = (uint32_t)number;
+            else ok = false;
+        }
+        if (!ok) {
+            error = "bad option '" + option + "'";
+            return false;
+        }
+    }
+    if (!hasHr) rule.hr = DefaultFaultHr(rule.site);
+    if ((rule.kind == FAULT_DELAY || rule.kind == FAULT_HANG) && rule.ms == 0) {
+        error = std::string(KIND_NAMES[rule.kind]) + " needs ms=";
+        return false;
+    }
+    return true;
+}
+
+bool ParseFaultScript(const std::string& text, FaultScript& script, std::string& error) {
+    script = FaultScript();
+    std::istringstream lines(text);
+    std::string line;
+    for (int lineNumber = 1; std::getline(lines, line); lineNumber++) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream words(line);
+        std::string first;
+        if (!(words >> first)) continue;
+
+        std::string lineError;
+        if (first == "seed") {
+            std::string value;
+            words >> value;
+            if (!ParseUnsigned(value, script.seed)) lineError = "bad seed '" + value + "'";
+        } else {
+            FaultRule rule;
+            if (ParseRule(words, first, rule, lineError)) script.rules.push_back(rule);
+        }
+        if (!lineError.empty()) {
+            error = "line " + std::to_string(lineNumber) + ": " + lineError;
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// Injector
+// ============================================================================
+
+void ResetFaultInjector(FaultInjector& f, const FaultScript& script) {
+    std::lock_guard<std::mutex> guard(f.lock);
+    f.script = script;
+    f.fired.assign(script.rules.size(), 0);
+    std::fill(std::begin(f.calls), std::end(f.calls), 0);
+    std::fill(std::begin(f.injected), std::end(f.injected), 0);
+    f.rng = script.seed ? script.seed : 1;  // xorshift state must be non-zero
+}
+
+// Uniform in [0, 1) (xorshift64*)
+static double NextUniform(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return (double)((state * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+FaultDecision NextFault(FaultInjector& f, FaultSite site) {
+    std::lock_guard<std::mutex> guard(f.lock);
+    uint64_t call = ++f.calls[site];
+    FaultDecision d;
+    for (size_t i = 0; i < f.script.rules.size(); i++) {
+        const FaultRule& rule = f.script.rules[i];
+        if (rule.site != site || call <= rule.after) continue;
+        if (rule.until && call > rule.until) continue;
+        if ((call - rule.after - 1) % rule.every != 0) continue;
+        if (rule.limit && f.fired[i] >= rule.limit) continue;
+        // Every scheduled call draws, so one rule's outcome doesn't shift another's sequence
+        if (rule.probability < 1.0 && NextUniform(f.rng) >= rule.probability) continue;
+
+        f.fired[i]++;
+        f.injected[site]++;
+        d.kind = rule.kind;
+        d.hr = rule.hr;
+        d.ms = rule.ms;
+        d.format = rule.format;
+        d.rule = (int)i;
+        break;
+    }
+    return d;
+}
+
+// ============================================================================
+// Backoff
+// ============================================================================
+
+int BackoffDelayMs(const BackoffPolicy& p, int failures) {
+    int doublings = (std::min)((std::max)(failures - 1, 0), p.maxDoublings);
+    return (std::min)(p.initialMs * (1 << doublings), p.maxMs);
+}
+
+// ============================================================================
+// Simulation
+// ============================================================================
+
+static bool IsDeviceLoss(int32_t hr) {
+    return hr == FAULT_HR_DEVICE_REMOVED || hr == FAULT_HR_DEVICE_RESET || hr == FAULT_HR_DEVICE_HUNG;
+}
+
+FaultSimReport SimulateFaults(const FaultScript& script, const FaultSimConfig& c) {
+    FaultInjector injector;
+    ResetFaultInjector(injector, script);
+    FaultSimReport report;
+
+    double t = 0.0;
+    double lastFrame = 0.0;               // g_lastSuccessfulFrame (also reset while retrying)
+    double nextHealthCheck = c.healthCheckMs;
+    bool duplication = true;
+    bool deviceLost = false;              // Monitor disabled until the health check recovers it
+    int failures = 0;                     // ctx->consecutiveFailures
+    int outage = -1;                      // Fault type being recovered from
+    double outageStart = 0.0;
+
+    auto typeOf = [&](FaultSite site, const FaultDecision& d) {
+        std::string label = FaultLabel(site, d);
+        for (size_t i = 0; i < report.types.size(); i++) {
+            if (report.types[i].name == label) return (int)i;
+        }
+        report.types.push_back(FaultTypeStats());
+        report.types.back().name = label;
+        return (int)report.types.size() - 1;
+    };
+    // Faults during an outage are part of it (the display is already dark)
+    auto begin = [&](int type, double start) {
+        if (outage >= 0) return;
+        outage = type;
+        outageStart = start;
+        report.types[type].faults++;
+    };
+    // Refreshes between the outage start and now that didn't get a corrected frame
+    auto lostSoFar = [&]() {
+        return (uint64_t)(std::max)(std::llround((t - outageStart) / c.refreshMs) - 1, 0ll);
+    };
+
+    while (t < c.durationMs) {
+        if (t >= nextHealthCheck) {
+            nextHealthCheck = t + c.healthCheckMs;
+            FaultDecision d = NextFault(injector, FAULT_SITE_DEVICE);
+            if (d.kind == FAULT_DELAY || d.kind == FAULT_HANG) t += d.ms;
+            if (d.kind == FAULT_ERROR || d.kind == FAULT_HANG) {
+                begin(typeOf(FAULT_SITE_DEVICE, d), t);
+                deviceLost = true;
+            }
+            if (deviceLost) {
+                t += c.deviceRecoveryMs;
+                deviceLost = false;
+                duplication = true;
+                failures = 0;
+                lastFrame = t;
+                continue;
+            }
+            if (t - lastFrame > c.watchdogMs) {
+                if (outage >= 0) report.types[outage].watchdogTrips++;
+                lastFrame = t;  // As if restarted
+            }
+        }
+        if (deviceLost) {
+            t = (std::max)(t, nextHealthCheck);
+            continue;
+        }
+
+        // RenderMonitor without duplication: back off, then try to recreate it
+        if (!duplication) {
+            failures++;
+            if (outage >= 0) report.types[outage].retries++;
+            t += BackoffDelayMs(c.backoff, failures);
+            lastFrame = t;
+            FaultDecision d = NextFault(injector, FAULT_SITE_DUPLICATE);
+            if (d.kind == FAULT_DELAY || d.kind == FAULT_HANG) t += d.ms;
+            t += c.reinitMs;
+            if (d.kind == FAULT_ERROR || d.kind == FAULT_HANG) continue;
+            duplication = true;
+            failures = 0;
+            continue;
+        }
+
+        FaultDecision acquire = NextFault(injector, FAULT_SITE_ACQUIRE);
+        if (acquire.kind != FAULT_NONE) {
+            begin(typeOf(FAULT_SITE_ACQUIRE, acquire), t);
+            if (acquire.kind == FAULT_DELAY || acquire.kind == FAULT_HANG) t += acquire.ms;
+            if (acquire.kind == FAULT_ERROR || acquire.kind == FAULT_HANG) {
+                if (acquire.hr == FAULT_HR_WAIT_TIMEOUT) {
+                    // Frame missed, duplication still healthy
+                    t += c.refreshMs;
+                    lastFrame = t;
+                } else {
+                    duplication = false;
+                }
+                continue;
+            }
+        }
+
+        FaultDecision frame = NextFault(injector, FAULT_SITE_FRAME);
+        if (frame.kind == FAULT_FORMAT) {
+            // Capture format changed: duplication and swapchain recreated in place
+            begin(typeOf(FAULT_SITE_FRAME, frame), t);
+            FaultDecision d = NextFault(injector, FAULT_SITE_DUPLICATE);
+            if (d.kind == FAULT_DELAY || d.kind == FAULT_HANG) t += d.ms;
+            t += c.reinitMs;
+            if (d.kind == FAULT_ERROR || d.kind == FAULT_HANG) {
+                duplication = false;
+            } else {
+                t += c.swapchainMs;
+            }
+            continue;
+        }
+
+        // Next desktop frame rendered and presented
+        t += c.refreshMs;
+        FaultDecision present = NextFault(injector, FAULT_SITE_PRESENT);
+        if (present.kind != FAULT_NONE) {
+            begin(typeOf(FAULT_SITE_PRESENT, present), t - c.refreshMs);
+            if (present.kind == FAULT_DELAY || present.kind == FAULT_HANG) t += present.ms;
+            if (present.kind == FAULT_ERROR || present.kind == FAULT_HANG) {
+                if (IsDeviceLoss(present.hr)) {
+                    deviceLost = true;
+                } else {
+                    lastFrame = t;  // Other Present failures count as a frame, but nothing was shown
+                }
+                continue;
+            }
+        }
+
+        report.framesPresented++;
+        lastFrame = t;
+        if (outage >= 0) {
+            FaultTypeStats& s = report.types[outage];
+            double ms = t - outageStart;
+            uint64_t lost = lostSoFar();
+            s.recovered++;
+            s.totalRecoverMs += ms;
+            s.maxRecoverMs = (std::max)(s.maxRecoverMs, ms);
+            s.framesLost += lost;
+            report.framesLost += lost;
+            outage = -1;
+        }
+    }
+
+    // Still dark when the simulation ended
+    if (outage >= 0) {
+        uint64_t lost = lostSoFar();
+        report.types[outage].framesLost += lost;
+        report.framesLost += lost;
+    }
+    report.simulatedMs = t;
+    return report;
+}
+
+std::string FormatFaultReport(const FaultSimReport& report) {
+    std::string out;
+    char line[256];
+    snprintf(line, sizeof(line), "%-36s %8s %9s %10s %10s %11s %8s %8s\n",
+             "Fault", "Faults", "Recovered", "Mean ms", "Max ms", "Lost frames", "Retries", "Watchdog");
+    out += line;
+    for (const auto& s : report.types) {
+        double mean = s.recovered ? s.totalRecoverMs / s.recovered : 0.0;
+        snprintf(line, sizeof(line), "%-36s %8llu %9llu %10.1f %10.1f %11llu %8llu %8llu\n",
+                 s.name.c_str(), (unsigned long long)s.faults, (unsigned long long)s.recovered, mean, s.maxRecoverMs,
+                 (unsigned long long)s.framesLost, (unsigned long long)s.retries, (unsigned long long)s.watchdogTrips);
+        out += line;
+    }
+    uint64_t expected = report.framesPresented + report.framesLost;
+    snprintf(line, sizeof(line), "%llu frames presented, %llu lost (%.3f%%) over %.0f s\n",
+             (unsigned long long)report.framesPresented, (unsigned long long)report.framesLost,
+             expected ? 100.0 * report.framesLost / expected : 0.0, report.simulatedMs / 1000.0);
+    out += line;
+    return out;
+}
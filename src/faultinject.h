@@ -0,0 +1,163 @@
+// DesktopLUT - faultinject.h
+// Scripted fault injection for duplication, swapchain and device calls, the duplication retry
+// backoff, and a simulated render loop that measures recovery under a fault script
+// (no Windows dependencies)
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Wrapped calls (faultwrap.h)
+enum FaultSite : uint8_t {
+    FAULT_SITE_ACQUIRE,      // IDXGIOutputDuplication::AcquireNextFrame
+    FAULT_SITE_FRAME,        // Format of the acquired desktop texture
+    FAULT_SITE_DUPLICATE,    // DuplicateOutput / DuplicateOutput1
+    FAULT_SITE_PRESENT,      // IDXGISwapChain::Present
+    FAULT_SITE_RESIZE,       // IDXGISwapChain::ResizeBuffers
+    FAULT_SITE_SWAPCHAIN,    // CreateSwapChainForComposition
+    FAULT_SITE_DEVICE,       // ID3D11Device::GetDeviceRemovedReason (health check)
+    FAULT_SITE_COUNT
+};
+
+enum FaultKind : uint8_t {
+    FAULT_NONE,
+    FAULT_ERROR,             // Return hr without making the call
+    FAULT_DELAY,             // Sleep ms, then make the call (slow driver)
+    FAULT_HANG,              // Sleep ms, then return hr (stuck call that eventually gives up)
+    FAULT_FORMAT,            // Report `format` as the frame format (FAULT_SITE_FRAME only)
+};
+
+// HRESULTs the render loop reacts to (winerror.h values)
+constexpr int32_t FAULT_HR_INVALID_CALL = (int32_t)0x887A0001;
+constexpr int32_t FAULT_HR_UNSUPPORTED = (int32_t)0x887A0004;
+constexpr int32_t FAULT_HR_DEVICE_REMOVED = (int32_t)0x887A0005;
+constexpr int32_t FAULT_HR_DEVICE_HUNG = (int32_t)0x887A0006;
+constexpr int32_t FAULT_HR_DEVICE_RESET = (int32_t)0x887A0007;
+constexpr int32_t FAULT_HR_ACCESS_LOST = (int32_t)0x887A0026;
+constexpr int32_t FAULT_HR_WAIT_TIMEOUT = (int32_t)0x887A0027;
+constexpr int32_t FAULT_HR_SESSION_DISCONNECTED = (int32_t)0x887A0028;
+constexpr int32_t FAULT_HR_ACCESS_DENIED = (int32_t)0x80070005;
+constexpr int32_t FAULT_HR_OUTOFMEMORY = (int32_t)0x8007000E;
+
+// One line of a fault script: which calls fail, how, and on what schedule
+struct FaultRule {
+    FaultSite site = FAULT_SITE_ACQUIRE;
+    FaultKind kind = FAULT_ERROR;
+    int32_t hr = 0;                // Returned HRESULT (error, hang)
+    uint32_t ms = 0;               // Sleep (delay, hang)
+    uint32_t format = 0;           // DXGI_FORMAT value (format)
+    double probability = 1.0;      // Chance per scheduled call
+    uint64_t after = 0;            // Calls at this site that pass before the rule starts
+    uint64_t until = 0;            // Last call the rule applies to (0 = no end)
+    uint64_t every = 1;            // Only every Nth call once started
+    uint32_t limit = 0;            // Most times the rule fires (0 = unlimited)
+};
+
+struct FaultScript {
+    std::vector<FaultRule> rules;
+    uint64_t seed = 1;             // Probability draws are deterministic per seed
+};
+
+// Script format, one rule per line ('#' starts a comment):
+//   <site> <kind> [hr=<name|hex>] [ms=N] [format=N] [p=0.01] [after=N] [until=N] [every=N] [limit=N]
+//   seed <N>
+// site: acquire, frame, duplicate, present, resize, swapchain, device
+// kind: error, delay, hang, format; hr names: access_lost, device_removed, device_reset,
+// device_hung, wait_timeout, session_disconnected, unsupported, invalid_call, access_denied,
+// outofmemory. error/hang without hr return the site's usual failure.
+// False with a "line N: ..." message on a malformed line.
+bool ParseFaultScript(const std::string& text, FaultScript& script, std::string& error);
+
+// What a wrapped call should do
+struct FaultDecision {
+    FaultKind kind = FAULT_NONE;
+    int32_t hr = 0;
+    uint32_t ms = 0;
+    uint32_t format = 0;
+    int rule = -1;                 // Index of the rule that fired
+};
+
+// Live injector state (thread-safe; calls are counted per site)
+struct FaultInjector {
+    FaultScript script;
+    std::vector<uint32_t> fired;                  // Per rule
+    uint64_t calls[FAULT_SITE_COUNT] = {};
+    uint64_t injected[FAULT_SITE_COUNT] = {};
+    uint64_t rng = 1;
+    std::mutex lock;
+};
+
+void ResetFaultInjector(FaultInjector& f, const FaultScript& script);
+
+// Count a call at `site` and decide its fault (first matching rule in script order wins)
+FaultDecision NextFault(FaultInjector& f, FaultSite site);
+
+const char* FaultSiteName(FaultSite site);
+const char* FaultKindName(FaultKind kind);
+
+// "access_lost", or hex for HRESULTs without a name
+std::string FaultHrName(int32_t hr);
+
+// "acquire error access_lost" style label for logs and reports
+std::string FaultLabel(FaultSite site, const FaultDecision& d);
+
+// ============================================================================
+// Backoff
+// ============================================================================
+
+// Retry delay after consecutive duplication failures: initialMs doubling per failure, capped.
+// Fast first retry for transient losses, slow retries while the secure desktop (UAC) is up.
+struct BackoffPolicy {
+    int initialMs = 50;
+    int maxMs = 5000;
+    int maxDoublings = 7;
+};
+
+constexpr BackoffPolicy DUPLICATION_BACKOFF = { 50, 5000, 7 };
+
+// Delay before retry number `failures` (1 = first retry)
+int BackoffDelayMs(const BackoffPolicy& p, int failures);
+
+// ============================================================================
+// Simulation
+// ============================================================================
+
+// Timing model of RenderMonitor/RenderAll for one monitor, driven by a fault script instead of
+// Windows. Time is virtual, so an hour of faults runs in milliseconds.
+struct FaultSimConfig {
+    double durationMs = 3600000.0;     // Simulated wall time
+    double refreshMs = 1000.0 / 60.0;  // Desktop refresh (one corrected frame per refresh when healthy)
+    BackoffPolicy backoff = DUPLICATION_BACKOFF;
+    double reinitMs = 15.0;            // DuplicateOutput1 + GetDesc
+    double swapchainMs = 10.0;         // Swapchain recreate after a format change
+    double healthCheckMs = 1000.0;     // Device health check interval (active tier)
+    double deviceRecoveryMs = 2100.0;  // AttemptDeviceRecovery: driver settle wait + manifest replay
+    double watchdogMs = 5000.0;        // WATCHDOG_TIMEOUT_SECONDS
+};
+
+// Outcome per fault type (site, kind and HRESULT)
+struct FaultTypeStats {
+    std::string name;
+    uint64_t faults = 0;               // Injected faults that interrupted rendering
+    uint64_t recovered = 0;
+    double totalRecoverMs = 0.0;       // Fault to next corrected frame
+    double maxRecoverMs = 0.0;
+    uint64_t framesLost = 0;           // Refreshes without a corrected frame
+    uint64_t retries = 0;              // Duplication reinit attempts
+    uint64_t watchdogTrips = 0;        // The real process would have exited here
+};
+
+struct FaultSimReport {
+    std::vector<FaultTypeStats> types;
+    uint64_t framesPresented = 0;
+    uint64_t framesLost = 0;
+    double simulatedMs = 0.0;
+};
+
+FaultSimReport SimulateFaults(const FaultScript& script, const FaultSimConfig& config);
+
+// Fixed-width table, one row per fault type plus a total
+std::string FormatFaultReport(const FaultSimReport& report);
@@ -0,0 +1,52 @@
+// DesktopLUT - frameconstants.cpp
+// Main constant buffer layout and fill, the CPU side of each monitor's frame (no Windows dependencies)
+
+#include "frameconstants.h"
+
+void FillFrameConstants(const FrameConstantInputs& in, float* cbData) {
+    const ColorCorrectionData& cc = *in.cc;
+    // Row 0: Core settings
+    cbData[0] = in.isHDR ? 1.0f : 0.0f;
+    cbData[1] = in.sdrWhiteNits;
+    cbData[2] = in.maxDisplayNits;
+    cbData[3] = (float)in.lutSize;
+    // Row 1: Toggles
+    cbData[4] = in.desktopGamma ? 1.0f : 0.0f;  // Desktop gamma toggle
+    cbData[5] = in.tetrahedral ? 1.0f : 0.0f;   // Tetrahedral interpolation
+    cbData[6] = in.passthrough ? 1.0f : 0.0f;   // HDR passthrough (no LUT)
+    cbData[7] = (cc.primariesEnabled || cc.grayscale.enabled) ? 1.0f : 0.0f;  // useManualCorrection
+    // Row 2: Grayscale control + tonemapping toggles
+    cbData[8] = (float)cc.grayscale.pointCount;
+    cbData[9] = cc.grayscale.enabled ? 1.0f : 0.0f;
+    cbData[10] = (in.isHDR && cc.tonemap.enabled) ? 1.0f : 0.0f;  // tonemapEnabled
+    cbData[11] = (float)static_cast<int>(cc.tonemap.curve);  // tonemapCurve
+    // Row 3-5: Primaries matrix (3 rows as float4, w unused)
+    cbData[12] = cc.primariesMatrix[0];
+    cbData[13] = cc.primariesMatrix[1];
+    cbData[14] = cc.primariesMatrix[2];
+    cbData[15] = 0.0f;
+    cbData[16] = cc.primariesMatrix[3];
+    cbData[17] = cc.primariesMatrix[4];
+    cbData[18] = cc.primariesMatrix[5];
+    cbData[19] = 0.0f;
+    cbData[20] = cc.primariesMatrix[6];
+    cbData[21] = cc.primariesMatrix[7];
+    cbData[22] = cc.primariesMatrix[8];
+    cbData[23] = 0.0f;
+    // Row 6: Tonemapping parameters
+    cbData[24] = cc.tonemap.sourcePeakNits;  // tonemapSourcePeak
+    cbData[25] = cc.tonemap.targetPeakNits;
+    cbData[26] = cc.tonemap.dynamicPeak ? 1.0f : 0.0f;  // tonemapDynamic
+    cbData[27] = cc.grayscale.use24Gamma ? 1.0f : 0.0f;  // grayscale24 (SDR 2.2->2.4 transform)
+    // Row 7: Grayscale peak + gamut compression (white balance now handled by Bradford in primaries matrix)
+    cbData[28] = cc.grayscale.peakNits;  // grayscalePeakNits (HDR only)
+    cbData[29] = in.gamutActive ? 1.0f : 0.0f;  // gamutCompression
+    cbData[30] = cc.gamutBoundary ? cc.gamutBoundary->maxIntensity : 0.0f;  // gamutMaxIntensity
+    cbData[31] = GAMUT_KNEE;  // gamutKnee
+    // Row 8-15: Grayscale LUT (32 points packed into 8 float4s)
+    for (int i = 0; i < 32; i++) {
+        cbData[32 + i] = (i < cc.grayscale.pointCount)
+            ? cc.grayscale.points[i]
+            : ((float)i / 31.0f);  // Linear fallback
+    }
+}
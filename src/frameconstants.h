@@ -0,0 +1,24 @@
+// DesktopLUT - frameconstants.h
+// Main constant buffer layout and fill, the CPU side of each monitor's frame (no Windows dependencies)
+
+#pragma once
+
+#include "colorcorrection.h"
+
+// Main constant buffer size (16 float4s, includes the grayscale LUT)
+constexpr int FRAME_CONSTANT_FLOATS = 64;
+
+// What the fill reads for one monitor's current mode
+struct FrameConstantInputs {
+    bool isHDR = false;
+    float sdrWhiteNits = 0.0f;
+    float maxDisplayNits = 0.0f;
+    int lutSize = 0;                          // Edge length of the bound LUT for this mode
+    bool desktopGamma = false;
+    bool tetrahedral = false;
+    bool passthrough = false;                 // No LUT applied
+    bool gamutActive = false;                 // Gamut compression on and its table uploaded
+    const ColorCorrectionData* cc = nullptr;  // Correction for this mode
+};
+
+void FillFrameConstants(const FrameConstantInputs& in, float* cbData);
@@ -0,0 +1,244 @@
+// DesktopLUT - gamut.cpp
+// Gamut boundary descriptor (max ICtCp chroma per lightness/hue) for soft gamut compression
+
+#include "gamut.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+static const float PI = 3.14159265358979f;
+
+// PQ (ST.2084) constants - same as shader.h
+static const float PQ_m1 = 0.1593017578125f;
+static const float PQ_m2 = 78.84375f;
+static const float PQ_c1 = 0.8359375f;
+static const float PQ_c2 = 18.8515625f;
+static const float PQ_c3 = 18.6875f;
+
+// ICtCp matrices - same as shader.h (Dolby ICtCp whitepaper)
+static const float Rec2020_to_LMS[9] = {
+    0.41210938f, 0.52392578f, 0.06396484f,
+    0.16674805f, 0.72045898f, 0.11279297f,
+    0.02416992f, 0.07543945f, 0.90039063f
+};
+static const float LMS_to_Rec2020[9] = {
+    3.43661000f, -2.50645000f,  0.06984000f,
+   -0.79133000f,  1.98360000f, -0.19227000f,
+   -0.02595000f, -0.09891000f,  1.12486000f
+};
+static const float LMSprime_to_ICtCp[9] = {
+    0.50000000f,  0.50000000f,  0.00000000f,
+    1.61376953f, -3.32348633f,  1.70971680f,
+    4.37817383f, -4.24560547f, -0.13256836f
+};
+static const float ICtCp_to_LMSprime[9] = {
+    1.0f,  0.00860904f,  0.11102963f,
+    1.0f, -0.00860904f, -0.11102963f,
+    1.0f,  0.56003134f, -0.32062717f
+};
+
+// BT.709 <-> Rec.2020 (ITU-R BT.2087) - same as shader.h
+static const float Rec709_to_Rec2020[9] = {
+    0.6274039f, 0.3292830f, 0.0433131f,
+    0.0690973f, 0.9195404f, 0.0113623f,
+    0.0163914f, 0.0880133f, 0.8955953f
+};
+static const float Rec2020_to_Rec709[9] = {
+    1.6604910f, -0.5876411f, -0.0728499f,
+   -0.1245505f,  1.1328999f, -0.0083494f,
+   -0.0181508f, -0.1005789f,  1.1187297f
+};
+
+// Bisection steps for boundary search (chroma resolution ~ 0.6 / 2^20)
+static const int BOUNDARY_SEARCH_STEPS = 20;
+static const float BOUNDARY_MAX_CHROMA = 0.6f;
+
+// Display RGB tolerance - values within this of [0, 1] count as in gamut
+static const float GAMUT_EPSILON = 1e-4f;
+
+static std::atomic<uint32_t> g_gamutBuildVersion{ 0 };
+
+static void MatVec(const float* m, const float* v, float* out) {
+    float x = v[0], y = v[1], z = v[2];
+    out[0] = m[0] * x + m[1] * y + m[2] * z;
+    out[1] = m[3] * x + m[4] * y + m[5] * z;
+    out[2] = m[6] * x + m[7] * y + m[8] * z;
+}
+
+static float LinearToPQ(float L) {
+    float Ym = powf((std::max)(L, 1e-10f), PQ_m1);
+    return powf((PQ_c1 + PQ_c2 * Ym) / (1.0f + PQ_c3 * Ym), PQ_m2);
+}
+
+static float PQToLinear(float pq) {
+    float Vm = powf((std::max)(pq, 1e-10f), 1.0f / PQ_m2);
+    float t = (std::max)(Vm - PQ_c1, 0.0f) / (std::max)(PQ_c2 - PQ_c3 * Vm, 1e-10f);
+    return powf(t, 1.0f / PQ_m1);
+}
+
+// Source linear RGB -> Rec.2020 normalized to 10000 nits
+static void SourceToRec2020Normalized(const float rgb[3], bool isHDR, float out[3]) {
+    if (isHDR) {
+        out[0] = rgb[0]; out[1] = rgb[1]; out[2] = rgb[2];
+    } else {
+        MatVec(Rec709_to_Rec2020, rgb, out);
+        float scale = GAMUT_SDR_WHITE_NITS / 10000.0f;
+        out[0] *= scale; out[1] *= scale; out[2] *= scale;
+    }
+}
+
+void SourceToICtCp(const float rgb[3], bool isHDR, float ictcp[3]) {
+    float rec2020[3], lms[3], lmsPQ[3];
+    SourceToRec2020Normalized(rgb, isHDR, rec2020);
+    MatVec(Rec2020_to_LMS, rec2020, lms);
+    for (int c = 0; c < 3; c++) lmsPQ[c] = LinearToPQ(lms[c]);
+    MatVec(LMSprime_to_ICtCp, lmsPQ, ictcp);
+}
+
+void ICtCpToSource(const float ictcp[3], bool isHDR, float rgb[3]) {
+    float lmsPQ[3], lms[3], rec2020[3];
+    MatVec(ICtCp_to_LMSprime, ictcp, lmsPQ);
+    for (int c = 0; c < 3; c++) lms[c] = PQToLinear(lmsPQ[c]);
+    MatVec(LMS_to_Rec2020, lms, rec2020);
+    if (isHDR) {
+        rgb[0] = rec2020[0]; rgb[1] = rec2020[1]; rgb[2] = rec2020[2];
+    } else {
+        float scale = 10000.0f / GAMUT_SDR_WHITE_NITS;
+        rec2020[0] *= scale; rec2020[1] *= scale; rec2020[2] *= scale;
+        MatVec(Rec2020_to_Rec709, rec2020, rgb);
+    }
+}
+
+// Whether an ICtCp source color lands inside the display's [0, 1] RGB cube
+static bool InDisplayGamut(const float* primariesMatrix, bool isHDR, float I, float ct, float cp) {
+    float ictcp[3] = { I, ct, cp };
+    float src[3], display[3];
+    ICtCpToSource(ictcp, isHDR, src);
+    MatVec(primariesMatrix, src, display);
+    for (int c = 0; c < 3; c++) {
+        if (display[c] < -GAMUT_EPSILON || display[c] > 1.0f + GAMUT_EPSILON) return false;
+    }
+    return true;
+}
+
+// Highest lightness (up to maxIntensity) whose neutral is inside the display gamut. A white
+// point shift can push a channel past 1 before the top of the table; black is always inside.
+static float NeutralCeiling(const float* primariesMatrix, bool isHDR, float maxIntensity) {
+    if (InDisplayGamut(primariesMatrix, isHDR, maxIntensity, 0.0f, 0.0f)) return maxIntensity;
+    float lo = 0.0f, hi = maxIntensity;
+    for (int step = 0; step < BOUNDARY_SEARCH_STEPS; step++) {
+        float mid = 0.5f * (lo + hi);
+        if (InDisplayGamut(primariesMatrix, isHDR, mid, 0.0f, 0.0f)) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+static void BuildGamutRow(const float* primariesMatrix, bool isHDR, float I, int row, GamutBoundaryData& out) {
+    for (int col = 0; col < GAMUT_HUE_STEPS; col++) {
+        float hue = (col + 0.5f) / GAMUT_HUE_STEPS * 2.0f * PI;
+        float dirT = cosf(hue), dirP = sinf(hue);
+
+        // Cross-sections are star-shaped around the neutral axis - bisect along the hue ray
+        float lo = 0.0f, hi = BOUNDARY_MAX_CHROMA;
+        for (int step = 0; step < BOUNDARY_SEARCH_STEPS; step++) {
+            float mid = 0.5f * (lo + hi);
+            if (InDisplayGamut(primariesMatrix, isHDR, I, mid * dirT, mid * dirP)) lo = mid;
+            else hi = mid;
+        }
+        out.maxChroma[row * GAMUT_HUE_STEPS + col] = lo;
+    }
+}
+
+void BuildGamutBoundary(const float* primariesMatrix, bool isHDR, GamutBoundaryData& out) {
+    // SDR table tops out at reference white, HDR covers the full PQ range
+    out.maxIntensity = isHDR ? 1.0f : LinearToPQ(GAMUT_SDR_WHITE_NITS / 10000.0f);
+
+    // Rows whose neutral is out of gamut take the cross-section at the ceiling (clamped lightness)
+    // rather than zero chroma, which would compress every color there to gray
+    float ceiling = NeutralCeiling(primariesMatrix, isHDR, out.maxIntensity);
+    for (int row = 0; row < GAMUT_LIGHTNESS_STEPS; row++) {
+        float I = (row + 0.5f) / GAMUT_LIGHTNESS_STEPS * out.maxIntensity;
+        BuildGamutRow(primariesMatrix, isHDR, (std::min)(I, ceiling), row, out);
+    }
+
+    out.version = ++g_gamutBuildVersion;
+}
+
+// Recently built tables by matrix/mode, oldest first
+struct GamutCacheEntry {
+    float matrix[9];
+    bool isHDR;
+    GamutBoundaryRef table;
+};
+
+static std::mutex g_gamutCacheMutex;
+static std::vector<GamutCacheEntry> g_gamutCache;
+
+GamutBoundaryRef AcquireGamutBoundary(const float* primariesMatrix, bool isHDR) {
+    {
+        std::lock_guard<std::mutex> lock(g_gamutCacheMutex);
+        for (const auto& entry : g_gamutCache) {
+            if (entry.isHDR == isHDR && memcmp(entry.matrix, primariesMatrix, sizeof(entry.matrix)) == 0) {
+                return entry.table;
+            }
+        }
+    }
+
+    // Build outside the lock; two threads racing on the same matrix both build, the first is kept
+    auto built = std::make_shared<GamutBoundaryData>();
+    BuildGamutBoundary(primariesMatrix, isHDR, *built);
+
+    std::lock_guard<std::mutex> lock(g_gamutCacheMutex);
+    for (const auto& entry : g_gamutCache) {
+        if (entry.isHDR == isHDR && memcmp(entry.matrix, primariesMatrix, sizeof(entry.matrix)) == 0) {
+            return entry.table;
+        }
+    }
+    if (g_gamutCache.size() >= (size_t)GAMUT_CACHE_SIZE) g_gamutCache.erase(g_gamutCache.begin());
+    GamutCacheEntry entry;
+    memcpy(entry.matrix, primariesMatrix, sizeof(entry.matrix));
+    entry.isHDR = isHDR;
+    entry.table = built;
+    g_gamutCache.push_back(entry);
+    return built;
+}
+
+float SampleGamutBoundary(const GamutBoundaryData& gbd, float intensity, float hue) {
+    // Bilinear with hue wrap and lightness clamp (matches wrapSampler + clamped v in shader)
+    float u = hue / (2.0f * PI) * GAMUT_HUE_STEPS - 0.5f;
+    float v = (gbd.maxIntensity > 0.0f ? intensity / gbd.maxIntensity : 0.0f) * GAMUT_LIGHTNESS_STEPS - 0.5f;
+    v = (std::min)((std::max)(v, 0.0f), (float)(GAMUT_LIGHTNESS_STEPS - 1));
+
+    float u0f = floorf(u);
+    float fu = u - u0f;
+    int u0 = ((int)u0f % GAMUT_HUE_STEPS + GAMUT_HUE_STEPS) % GAMUT_HUE_STEPS;
+    int u1 = (u0 + 1) % GAMUT_HUE_STEPS;
+    int v0 = (int)v;
+    int v1 = (std::min)(v0 + 1, GAMUT_LIGHTNESS_STEPS - 1);
+    float fv = v - v0;
+
+    auto at = [&](int row, int col) { return gbd.maxChroma[row * GAMUT_HUE_STEPS + col]; };
+    float top = at(v0, u0) + (at(v0, u1) - at(v0, u0)) * fu;
+    float bottom = at(v1, u0) + (at(v1, u1) - at(v1, u0)) * fu;
+    return top + (bottom - top) * fv;
+}
+
+void GamutCompressICtCp(const GamutBoundaryData& gbd, float ictcp[3]) {
+    float c = sqrtf(ictcp[1] * ictcp[1] + ictcp[2] * ictcp[2]);
+    if (c < 1e-6f) return;
+
+    float cMax = SampleGamutBoundary(gbd, ictcp[0], atan2f(ictcp[2], ictcp[1]));
+    float knee = GAMUT_KNEE * cMax;
+    if (c <= knee) return;
+
+    // Soft knee: slope 1 at the knee, approaches cMax asymptotically (hue and intensity preserved)
+    float range = (std::max)(cMax - knee, 1e-6f);
+    float x = (c - knee) / range;
+    float cNew = knee + range * x / (1.0f + x);
+    ictcp[1] *= cNew / c;
+    ictcp[2] *= cNew / c;
+}
@@ -0,0 +1,49 @@
+// DesktopLUT - gamut.h
+// Gamut boundary descriptor (max ICtCp chroma per lightness/hue) for soft gamut compression
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+// Descriptor resolution - uploaded as a GAMUT_HUE_STEPS x GAMUT_LIGHTNESS_STEPS R32_FLOAT texture
+// (shader.h hardcodes the lightness step count - keep in sync)
+constexpr int GAMUT_HUE_STEPS = 64;          // Columns, hue wraps around
+constexpr int GAMUT_LIGHTNESS_STEPS = 32;    // Rows, I from 0 to maxIntensity
+
+// Compression starts at this fraction of the boundary chroma (soft knee)
+constexpr float GAMUT_KNEE = 0.8f;
+
+// SDR source is relative - map linear 1.0 to this luminance for ICtCp conversion
+constexpr float GAMUT_SDR_WHITE_NITS = 100.0f;
+
+// Max in-gamut chroma (length of CtCp) for each lightness/hue cell
+// Cell (row i, column j) is sampled at I = (i + 0.5) / rows * maxIntensity, hue = (j + 0.5) / cols * 2pi
+struct GamutBoundaryData {
+    float maxChroma[GAMUT_LIGHTNESS_STEPS * GAMUT_HUE_STEPS] = {};  // Row-major (lightness rows)
+    float maxIntensity = 0.0f;  // I (PQ) at the top of the table
+    uint32_t version = 0;       // Unique per build (0 = never built) - render thread re-uploads on change
+};
+
+// Built tables are immutable and shared by every ColorCorrectionData that uses them
+typedef std::shared_ptr<const GamutBoundaryData> GamutBoundaryRef;
+
+// Distinct tables kept for reuse (8 monitors x SDR/HDR)
+constexpr int GAMUT_CACHE_SIZE = 16;
+
+// Build the descriptor for the display gamut as seen from the source space
+// SDR: source = linear sRGB (1.0 = GAMUT_SDR_WHITE_NITS), HDR: source = linear Rec.2020 (1.0 = 10000 nits)
+// primariesMatrix maps source RGB to display RGB (row-major 3x3, as in ColorCorrectionData)
+// Runs on the calling thread (the correction worker for live changes). Rows above the highest
+// lightness whose neutral is still in gamut use the boundary at that lightness instead.
+void BuildGamutBoundary(const float* primariesMatrix, bool isHDR, GamutBoundaryData& out);
+
+// Shared table for a matrix/mode: reused when an identical one was built recently (most setting
+// changes don't touch the primaries), built and cached otherwise. Thread-safe.
+GamutBoundaryRef AcquireGamutBoundary(const float* primariesMatrix, bool isHDR);
+
+// CPU reference of the shader path (matches ApplyGamutCompressionICtCp in shader.h)
+void SourceToICtCp(const float rgb[3], bool isHDR, float ictcp[3]);
+void ICtCpToSource(const float ictcp[3], bool isHDR, float rgb[3]);
+float SampleGamutBoundary(const GamutBoundaryData& gbd, float intensity, float hue);
+void GamutCompressICtCp(const GamutBoundaryData& gbd, float ictcp[3]);
@@ -2,36 +2,22 @@
 // Global variable definitions
 
 #include "globals.h"
+#include "analysissched.h"
 
 // ============================================================================
-// D3D Device and Resources (shared across all monitors)
+// D3D Devices (one group per adapter driving a configured monitor)
 // ============================================================================
 
-ID3D11Device* g_device = nullptr;
-ID3D11DeviceContext* g_context = nullptr;
-ID3D11VertexShader* g_vs = nullptr;
-ID3D11PixelShader* g_ps = nullptr;
-ID3D11ComputeShader* g_peakDetectCS = nullptr;
-ID3D11Buffer* g_peakCB = nullptr;
-ID3D11ComputeShader* g_analysisCS = nullptr;
-ID3D11Buffer* g_analysisCB = nullptr;
-ID3D11SamplerState* g_samplerPoint = nullptr;
-ID3D11SamplerState* g_samplerLinear = nullptr;
-ID3D11SamplerState* g_samplerWrap = nullptr;
-ID3D11Buffer* g_constantBuffer = nullptr;
+std::vector<std::unique_ptr<GpuDevice>> g_gpuDevices;
 
-// DirectComposition device (shared)
+// DirectComposition device (shared - not tied to a D3D device)
 IDCompositionDevice* g_dcompDevice = nullptr;
 
-// Blue noise texture (shared)
-ID3D11Texture2D* g_blueNoiseTexture = nullptr;
-ID3D11ShaderResourceView* g_blueNoiseSRV = nullptr;
-
 // ============================================================================
 // Monitor State
 // ============================================================================
 
-std::vector<MonitorContext> g_monitors;
+std::vector<std::unique_ptr<MonitorContext>> g_monitors;
 
 // ============================================================================
 // Atomic Control Flags
@@ -40,11 +26,20 @@ std::vector<MonitorContext> g_monitors;
 std::atomic<bool> g_desktopGammaMode{ true };   // Effective gamma state (may be overridden by whitelist)
 std::atomic<bool> g_tetrahedralInterp{ false };  // Default: trilinear (tetrahedral opt-in for quality)
 std::atomic<bool> g_running{ true };            // Main loop control
-std::atomic<bool> g_forceReinit{ false };       // Force reinit on next frame
+std::atomic<bool> g_forceReinit{ false };       // System/display woke: reconcile topology with fresh duplications
 std::atomic<bool> g_forceTopmostReassert{ false }; // Force TOPMOST reassert on next frame
+std::atomic<bool> g_topologyChanged{ false };    // Display topology changed (WM_DISPLAYCHANGE), reconcile once settled
 std::atomic<bool> g_logPeakDetection{ false };  // Debug: log detected peak nits to console
 std::atomic<bool> g_consoleEnabled{ false };   // Show console window (GUI mode only, default off)
 std::atomic<bool> g_showFrameTiming{ false };  // Show frame timing in analysis overlay (default off)
+std::atomic<bool> g_adaptiveIdle{ true };  // Lengthen render-loop waits while desktop is static (default on)
+std::atomic<int> g_metricsPort{ 0 };       // Localhost Prometheus endpoint port (0 = disabled)
+std::atomic<bool> g_liveLutEnabled{ false };  // Accept streamed LUTs on the live LUT pipe
+std::atomic<bool> g_analysisRecording{ false };  // Record analysis stats to the ring file while processing
+std::atomic<bool> g_analysisScopes{ false };     // Waveform/vectorscope/CIE panel in the analysis overlay
+std::atomic<float> g_analysisBudgetMs{ ANALYSIS_DEFAULT_BUDGET_MS };  // Analysis GPU time per render loop pass, per adapter (<= 0 = no limit)
+std::atomic<bool> g_tiledMainPass{ false };      // Run the correction as the tiled compute pass (fused statistics)
+std::atomic<bool> g_halfPrecision{ false };      // Compile the correction shaders with HALF_PRECISION (min16float LUT stage)
 
 // ============================================================================
 // Hotkey Settings
@@ -70,6 +65,7 @@ std::wstring g_gammaWhitelistMatch;                    // Name of matched proces
 std::atomic<bool> g_gammaWhitelistThreadRunning{ false }; // Control flag for whitelist polling thread
 std::atomic<bool> g_gammaWhitelistUserOverride{ false };  // User manually toggled while whitelist was active
 std::wstring g_gammaWhitelistOverrideProcess;             // Process name when user overrode (lowercase)
+std::atomic<uint32_t> g_gammaWhitelistVersion{ 0 };      // Bumped when g_gammaWhitelist is reparsed
 
 // ============================================================================
 // VRR Whitelist
@@ -81,6 +77,7 @@ std::wstring g_vrrWhitelistRaw;                          // Raw comma-separated
 std::atomic<bool> g_vrrWhitelistActive{ false };         // A whitelisted process is running (overlay hidden)
 std::wstring g_vrrWhitelistMatch;                        // Name of matched process
 std::mutex g_vrrWhitelistMutex;                          // Protects g_vrrWhitelist, g_vrrWhitelistMatch
+std::atomic<uint32_t> g_vrrWhitelistVersion{ 0 };        // Bumped when g_vrrWhitelist is reparsed
 
 // ============================================================================
 // Thread Synchronization
@@ -124,6 +121,18 @@ float g_sdrWhiteNits = 80.0f;
 
 std::chrono::steady_clock::time_point g_lastSuccessfulFrame;
 
+// ============================================================================
+// Adaptive Idle (render thread only)
+// ============================================================================
+
+IdleTracker g_idleTracker;
+
+// ============================================================================
+// Metrics (lock-free, updated from any thread - see metrics.h)
+// ============================================================================
+
+MetricsRegistry g_metrics;
+
 // ============================================================================
 // Display Power State
 // ============================================================================
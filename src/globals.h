@@ -4,42 +4,30 @@
 #pragma once
 
 #include "types.h"
+#include "idle.h"
+#include "metrics.h"
 #include <d3d11_4.h>
 #include <dcomp.h>
 #include <atomic>
 #include <mutex>
 #include <chrono>
 #include <vector>
+#include <memory>
 
 // ============================================================================
-// D3D Device and Resources (shared across all monitors)
+// D3D Devices (one group per adapter driving a configured monitor)
 // ============================================================================
 
-extern ID3D11Device* g_device;
-extern ID3D11DeviceContext* g_context;
-extern ID3D11VertexShader* g_vs;
-extern ID3D11PixelShader* g_ps;
-extern ID3D11ComputeShader* g_peakDetectCS;  // Compute shader for dynamic peak detection
-extern ID3D11Buffer* g_peakCB;               // Constant buffer for peak detection parameters
-extern ID3D11ComputeShader* g_analysisCS;    // Compute shader for frame analysis
-extern ID3D11Buffer* g_analysisCB;           // Constant buffer for analysis parameters
-extern ID3D11SamplerState* g_samplerPoint;
-extern ID3D11SamplerState* g_samplerLinear;
-extern ID3D11SamplerState* g_samplerWrap;
-extern ID3D11Buffer* g_constantBuffer;
+extern std::vector<std::unique_ptr<GpuDevice>> g_gpuDevices;  // Render thread only - MonitorContext::gpu points into this
 
-// DirectComposition device (shared)
+// DirectComposition device (shared - not tied to a D3D device)
 extern IDCompositionDevice* g_dcompDevice;
 
-// Blue noise texture (shared)
-extern ID3D11Texture2D* g_blueNoiseTexture;
-extern ID3D11ShaderResourceView* g_blueNoiseSRV;
-
 // ============================================================================
 // Monitor State
 // ============================================================================
 
-extern std::vector<MonitorContext> g_monitors;
+extern std::vector<std::unique_ptr<MonitorContext>> g_monitors;
 
 // ============================================================================
 // Atomic Control Flags
@@ -48,11 +36,20 @@ extern std::vector<MonitorContext> g_monitors;
 extern std::atomic<bool> g_desktopGammaMode;   // Effective gamma state (may be overridden by whitelist)
 extern std::atomic<bool> g_tetrahedralInterp;  // true = tetrahedral, false = trilinear
 extern std::atomic<bool> g_running;            // Main loop control
-extern std::atomic<bool> g_forceReinit;        // Force reinit on next frame
+extern std::atomic<bool> g_forceReinit;        // System/display woke: reconcile topology with fresh duplications
 extern std::atomic<bool> g_forceTopmostReassert; // Force TOPMOST reassert on next frame
+extern std::atomic<bool> g_topologyChanged;     // Display topology changed (WM_DISPLAYCHANGE), reconcile once settled
 extern std::atomic<bool> g_logPeakDetection;   // Debug: log detected peak nits to console
 extern std::atomic<bool> g_consoleEnabled;     // Show console window (GUI mode only)
 extern std::atomic<bool> g_showFrameTiming;    // Show frame timing in analysis overlay
+extern std::atomic<bool> g_adaptiveIdle;       // Lengthen render-loop waits while desktop is static
+extern std::atomic<int> g_metricsPort;         // Localhost Prometheus endpoint port (0 = disabled)
+extern std::atomic<bool> g_liveLutEnabled;     // Accept streamed LUTs on the live LUT pipe
+extern std::atomic<bool> g_analysisRecording;  // Record analysis stats to the ring file while processing
+extern std::atomic<bool> g_analysisScopes;     // Waveform/vectorscope/CIE panel in the analysis overlay
+extern std::atomic<float> g_analysisBudgetMs;  // GPU time frame analysis may use per render loop pass, per adapter
+extern std::atomic<bool> g_tiledMainPass;      // Run the correction as the tiled compute pass (fused statistics)
+extern std::atomic<bool> g_halfPrecision;      // Compile the correction shaders with HALF_PRECISION (min16float LUT stage)
 
 // ============================================================================
 // Hotkey Settings
@@ -78,6 +75,7 @@ extern std::wstring g_gammaWhitelistMatch;             // Name of the matched pr
 extern std::atomic<bool> g_gammaWhitelistThreadRunning; // Control flag for whitelist polling thread
 extern std::atomic<bool> g_gammaWhitelistUserOverride; // User manually toggled while whitelist was active
 extern std::wstring g_gammaWhitelistOverrideProcess;   // Process name when user overrode - protected by g_gammaWhitelistMutex
+extern std::atomic<uint32_t> g_gammaWhitelistVersion; // Bumped when g_gammaWhitelist is reparsed (polling thread refreshes its copy)
 
 // ============================================================================
 // VRR Whitelist (auto-hide overlay when whitelisted apps are running)
@@ -89,6 +87,7 @@ extern std::wstring g_vrrWhitelistRaw;                 // Raw comma-separated st
 extern std::atomic<bool> g_vrrWhitelistActive;         // A whitelisted process is currently running (overlay hidden)
 extern std::wstring g_vrrWhitelistMatch;               // Name of the matched process - protected by g_vrrWhitelistMutex
 extern std::mutex g_vrrWhitelistMutex;                 // Protects g_vrrWhitelist, g_vrrWhitelistMatch
+extern std::atomic<uint32_t> g_vrrWhitelistVersion;   // Bumped when g_vrrWhitelist is reparsed (polling thread refreshes its copy)
 
 // ============================================================================
 // Thread Synchronization
@@ -132,6 +131,18 @@ extern float g_sdrWhiteNits;
 
 extern std::chrono::steady_clock::time_point g_lastSuccessfulFrame;
 
+// ============================================================================
+// Adaptive Idle (render thread only)
+// ============================================================================
+
+extern IdleTracker g_idleTracker;
+
+// ============================================================================
+// Metrics (lock-free, updated from any thread - see metrics.h)
+// ============================================================================
+
+extern MetricsRegistry g_metrics;
+
 // ============================================================================
 // Display Power State
 // ============================================================================
@@ -5,232 +5,766 @@
 #include "globals.h"
 #include "shader.h"
 #include "lut.h"
+#include "lutingest.h"
+#include "lutstack.h"
 #include "capture.h"
 #include "render.h"
 #include "processing.h"
+#include "livelut.h"
+#include "analysis.h"
+#include "tiledpass.h"
 #include <d3dcompiler.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
 
 #pragma comment(lib, "d3dcompiler.lib")
 
-bool InitD3D() {
-    D3D_FEATURE_LEVEL featureLevel;
-    UINT flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
-#ifdef _DEBUG
-    flags |= D3D11_CREATE_DEVICE_DEBUG;
-#endif
+// ============================================================================
+// Resource manifest
+// ============================================================================
 
-    HRESULT hr = D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, flags,
-        nullptr, 0, D3D11_SDK_VERSION, &g_device, &featureLevel, &g_context);
-    if (FAILED(hr)) {
-        std::cerr << "D3D11CreateDevice failed: 0x" << std::hex << hr << std::endl;
-        return false;
+// Compiled bytecode by source name and defines. Compiled once per process: further device
+// groups and device-loss recoveries create their shaders from it without recompiling.
+static std::map<std::string, ManifestBlob> g_shaderBytecode;
+
+// Compile (or fetch) bytecode; null on failure (errors logged)
+static ManifestBlob CompileShaderBlob(const char* source, const char* name, const D3D_SHADER_MACRO* defines,
+                                      const char* target) {
+    std::string key = std::string(name) + "/" + target;
+    for (const D3D_SHADER_MACRO* d = defines; d && d->Name; d++) {
+        key += std::string(" ") + d->Name + "=" + d->Definition;
     }
+    auto it = g_shaderBytecode.find(key);
+    if (it != g_shaderBytecode.end()) return it->second;
 
-    // Compile shaders
-    ID3DBlob* vsBlob = nullptr;
-    ID3DBlob* psBlob = nullptr;
+    ID3DBlob* blob = nullptr;
     ID3DBlob* errorBlob = nullptr;
-
-    hr = D3DCompile(g_vsSource, strlen(g_vsSource), "VS", nullptr, nullptr,
-        "main", "vs_5_0", 0, 0, &vsBlob, &errorBlob);
+    HRESULT hr = D3DCompile(source, strlen(source), name, defines, nullptr,
+        "main", target, 0, 0, &blob, &errorBlob);
     if (FAILED(hr)) {
         if (errorBlob) {
-            std::cerr << "VS Error: " << (char*)errorBlob->GetBufferPointer() << std::endl;
+            std::cerr << name << " Error: " << (char*)errorBlob->GetBufferPointer() << std::endl;
             errorBlob->Release();
         }
-        return false;
+        return nullptr;
     }
-    if (errorBlob) { errorBlob->Release(); errorBlob = nullptr; }  // May contain warnings
+    if (errorBlob) errorBlob->Release();  // May contain warnings
 
-    hr = D3DCompile(g_psSource, strlen(g_psSource), "PS", nullptr, nullptr,
-        "main", "ps_5_0", 0, 0, &psBlob, &errorBlob);
-    if (FAILED(hr)) {
-        if (errorBlob) {
-            std::cerr << "PS Error: " << (char*)errorBlob->GetBufferPointer() << std::endl;
-            errorBlob->Release();
-        }
-        vsBlob->Release();  // Clean up VS blob before returning
+    const uint8_t* bytes = static_cast<const uint8_t*>(blob->GetBufferPointer());
+    auto code = std::make_shared<const std::vector<uint8_t>>(bytes, bytes + blob->GetBufferSize());
+    blob->Release();
+    g_shaderBytecode[key] = code;
+    return code;
+}
+
+static int AddShaderEntry(ResourceManifest& m, const char* name, ManifestKind kind, ManifestBlob code,
+                          void** slot, int group = -1) {
+    ManifestEntry entry;
+    entry.name = name;
+    entry.kind = kind;
+    entry.source = std::move(code);
+    entry.group = group;
+    entry.required = group < 0;
+    entry.slot = slot;
+    return AddManifestEntry(m, std::move(entry));
+}
+
+static int AddConstantBufferEntry(ResourceManifest& m, const char* name, UINT byteWidth, void** slot, int group = -1) {
+    D3D11_BUFFER_DESC desc = {};
+    desc.ByteWidth = byteWidth;
+    desc.Usage = D3D11_USAGE_DYNAMIC;
+    desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    ManifestEntry entry;
+    entry.name = name;
+    entry.kind = MANIFEST_BUFFER;
+    SetManifestDesc(entry, desc);
+    entry.group = group;
+    entry.required = group < 0;
+    entry.slot = slot;
+    return AddManifestEntry(m, std::move(entry));
+}
+
+static int AddSamplerEntry(ResourceManifest& m, const char* name, D3D11_FILTER filter,
+                           D3D11_TEXTURE_ADDRESS_MODE address, void** slot) {
+    D3D11_SAMPLER_DESC desc = {};
+    desc.Filter = filter;
+    desc.AddressU = address;
+    desc.AddressV = address;
+    desc.AddressW = address;
+    ManifestEntry entry;
+    entry.name = name;
+    entry.kind = MANIFEST_SAMPLER;
+    SetManifestDesc(entry, desc);
+    entry.slot = slot;
+    return AddManifestEntry(m, std::move(entry));
+}
+
+// SRV over the whole of entry `resource` (default view)
+static int AddViewEntry(ResourceManifest& m, const std::string& name, int resource, void** slot,
+                        int group = -1, bool required = true) {
+    ManifestEntry entry;
+    entry.name = name;
+    entry.kind = MANIFEST_SRV;
+    entry.deps = { resource };
+    entry.group = group;
+    entry.required = required;
+    entry.slot = slot;
+    return AddManifestEntry(m, std::move(entry));
+}
+
+// Describe every device-level object of a group (shaders, constant buffers, samplers, blue
+// noise); LUT textures are added as monitors first use them. False if a required shader
+// doesn't compile.
+static bool BuildDeviceManifest(GpuDevice* gpu) {
+    ResourceManifest& m = gpu->manifest;
+    m.entries.clear();
+    int group = 0;
+
+    ManifestBlob vsCode = CompileShaderBlob(g_vsSource, "VS", nullptr, "vs_5_0");
+    if (!vsCode) return false;
+
+    // HalfPrecision=1: min16float LUT stage (see tools/fp16_error_report.py). Hardware without
+    // 16-bit shader ALUs runs it at full precision, so the variant is always safe to compile.
+    bool halfPrecision = g_halfPrecision.load();
+    if (halfPrecision) {
+        D3D11_FEATURE_DATA_SHADER_MIN_PRECISION_SUPPORT minPrecision = {};
+        bool native = SUCCEEDED(gpu->device->CheckFeatureSupport(D3D11_FEATURE_SHADER_MIN_PRECISION_SUPPORT,
+            &minPrecision, sizeof(minPrecision))) &&
+            (minPrecision.PixelShaderMinPrecision & D3D11_SHADER_MIN_PRECISION_16_BIT);
+        std::wcout << L"Half precision LUT stage on " << gpu->adapterName
+                   << (native ? L" (16-bit ALUs)" : L" (no 16-bit support, runs at full precision)") << std::endl;
+    }
+    D3D_SHADER_MACRO psDefines[] = { { "HALF_PRECISION", "1" }, { nullptr, nullptr } };
+    ManifestBlob psCode = CompileShaderBlob(g_psSource, "PS", halfPrecision ? psDefines : nullptr, "ps_5_0");
+    if (!psCode) return false;
+
+    AddShaderEntry(m, "vs", MANIFEST_VERTEX_SHADER, vsCode, (void**)&gpu->vs);
+    AddShaderEntry(m, "ps", MANIFEST_PIXEL_SHADER, psCode, (void**)&gpu->ps);
+
+    // Optional passes: shader and constant buffer come and go together
+    if (ManifestBlob code = CompileShaderBlob(g_csSource, "CS", nullptr, "cs_5_0")) {
+        AddShaderEntry(m, "peakDetectCS", MANIFEST_COMPUTE_SHADER, code, (void**)&gpu->peakDetectCS, group);
+        // 8 floats: width, height, riseRate, fallRate, maxRise, maxFall, pad, pad
+        AddConstantBufferEntry(m, "peakCB", 32, (void**)&gpu->peakCB, group);
+        group++;
+    } else {
+        std::cerr << "Warning: Compute shader compilation failed, dynamic peak detection disabled" << std::endl;
+    }
+
+    if (ManifestBlob code = CompileShaderBlob(g_analysisCSSource, "AnalysisCS", nullptr, "cs_5_0")) {
+        AddShaderEntry(m, "analysisCS", MANIFEST_COMPUTE_SHADER, code, (void**)&gpu->analysisCS, group);
+        AddConstantBufferEntry(m, "analysisCB", 16, (void**)&gpu->analysisCB, group);  // 4 uints: width, height, isHDR, pad
+        group++;
+    } else {
+        std::cerr << "Warning: Analysis compute shader compilation failed, frame analysis disabled" << std::endl;
+    }
+
+    if (ManifestBlob code = CompileShaderBlob(g_scopesCSSource, "ScopesCS", nullptr, "cs_5_0")) {
+        AddShaderEntry(m, "scopesCS", MANIFEST_COMPUTE_SHADER, code, (void**)&gpu->scopesCS, group);
+        // 8 uints: width, height, isHDR, gridX, gridY, pad x3
+        AddConstantBufferEntry(m, "scopesCB", 32, (void**)&gpu->scopesCB, group);
+        group++;
+    } else {
+        std::cerr << "Warning: Scopes compute shader compilation failed, analysis scopes disabled" << std::endl;
+    }
+
+    // Tiled compute main pass (same correction source, compute entry point) and its reduction
+    // Non-fatal: g_tiledMainPass falls back to the pixel shader path
+    std::string tileSize = std::to_string(MAIN_PASS_TILE_SIZE);
+    D3D_SHADER_MACRO mainPassDefines[] = { { "MAIN_PASS_CS", "1" }, { "MAIN_PASS_TILE", tileSize.c_str() },
+        { halfPrecision ? "HALF_PRECISION" : nullptr, halfPrecision ? "1" : nullptr }, { nullptr, nullptr } };
+    ManifestBlob mainPassCode = CompileShaderBlob(g_psSource, "MainPassCS", mainPassDefines, "cs_5_0");
+    ManifestBlob reduceCode = mainPassCode ? CompileShaderBlob(g_tileReduceCSSource, "TileReduceCS", nullptr, "cs_5_0") : nullptr;
+    if (mainPassCode && reduceCode) {
+        AddShaderEntry(m, "mainPassCS", MANIFEST_COMPUTE_SHADER, mainPassCode, (void**)&gpu->mainPassCS, group);
+        AddShaderEntry(m, "tileReduceCS", MANIFEST_COMPUTE_SHADER, reduceCode, (void**)&gpu->tileReduceCS, group);
+        AddConstantBufferEntry(m, "tileCB", 16, (void**)&gpu->tileCB, group);  // 4 uints: width, height, tilesX, collectAnalysis
+        // tileCount, collectAnalysis, updatePeak, pad, 4 smoothing floats
+        AddConstantBufferEntry(m, "tileReduceCB", 32, (void**)&gpu->tileReduceCB, group);
+        group++;
+    } else {
+        std::cerr << "Warning: Tiled main pass unavailable, using the pixel shader" << std::endl;
+    }
+
+    AddSamplerEntry(m, "samplerPoint", D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_CLAMP, (void**)&gpu->samplerPoint);
+    AddSamplerEntry(m, "samplerLinear", D3D11_FILTER_MIN_MAG_MIP_LINEAR, D3D11_TEXTURE_ADDRESS_CLAMP, (void**)&gpu->samplerLinear);
+    // Wrap sampler for blue noise tiling
+    AddSamplerEntry(m, "samplerWrap", D3D11_FILTER_MIN_MAG_MIP_POINT, D3D11_TEXTURE_ADDRESS_WRAP, (void**)&gpu->samplerWrap);
+
+    // Shader parameters: 64 floats (16 float4s) - includes grayscale peak
+    AddConstantBufferEntry(m, "constantBuffer", (UINT)(FRAME_CONSTANT_FLOATS * sizeof(float)), (void**)&gpu->constantBuffer);
+
+    // Blue noise texture for SDR dithering
+    static const ManifestBlob noiseBytes = std::make_shared<const std::vector<uint8_t>>(
+        g_blueNoiseData, g_blueNoiseData + sizeof(g_blueNoiseData));
+    D3D11_TEXTURE2D_DESC noiseDesc = {};
+    noiseDesc.Width = 64;
+    noiseDesc.Height = 64;
+    noiseDesc.MipLevels = 1;
+    noiseDesc.ArraySize = 1;
+    noiseDesc.Format = DXGI_FORMAT_R8_UNORM;
+    noiseDesc.SampleDesc.Count = 1;
+    noiseDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    noiseDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    ManifestEntry noise;
+    noise.name = "blueNoiseTexture";
+    noise.kind = MANIFEST_TEXTURE2D;
+    SetManifestDesc(noise, noiseDesc);
+    noise.source = noiseBytes;
+    noise.rowPitch = 64;
+    noise.slot = (void**)&gpu->blueNoiseTexture;
+    int noiseIndex = AddManifestEntry(m, std::move(noise));
+    AddViewEntry(m, "blueNoiseSRV", noiseIndex, (void**)&gpu->blueNoiseSRV);
+
+    gpu->nextManifestGroup = group;
+    return true;
+}
+
+// Create one manifest entry on the group's device (thread-safe: D3D11 device creation methods
+// are free-threaded and each entry writes only its own slot). `initial` overrides the entry's
+// source for this creation (a caller that already holds the data).
+static bool CreateManifestObject(GpuDevice* gpu, int index, ManifestBlob initial = nullptr) {
+    const ManifestEntry& e = gpu->manifest.entries[index];
+    ID3D11Device* device = gpu->device;
+    ManifestBlob source = initial ? std::move(initial) : e.load ? e.load() : e.source;
+    if (e.load && !source) {
+        std::cerr << "Failed to load " << e.name << std::endl;
+        *e.slot = nullptr;
         return false;
     }
-    if (errorBlob) { errorBlob->Release(); errorBlob = nullptr; }  // May contain warnings
+    const void* data = source ? source->data() : nullptr;
+    SIZE_T size = source ? source->size() : 0;
+    D3D11_SUBRESOURCE_DATA init = { data, e.rowPitch, e.slicePitch };
 
-    hr = g_device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &g_vs);
+    HRESULT hr = E_INVALIDARG;
+    switch (e.kind) {
+    case MANIFEST_VERTEX_SHADER:
+        hr = device->CreateVertexShader(data, size, nullptr, reinterpret_cast<ID3D11VertexShader**>(e.slot));
+        break;
+    case MANIFEST_PIXEL_SHADER:
+        hr = device->CreatePixelShader(data, size, nullptr, reinterpret_cast<ID3D11PixelShader**>(e.slot));
+        break;
+    case MANIFEST_COMPUTE_SHADER:
+        hr = device->CreateComputeShader(data, size, nullptr, reinterpret_cast<ID3D11ComputeShader**>(e.slot));
+        break;
+    case MANIFEST_BUFFER:
+        hr = device->CreateBuffer(reinterpret_cast<const D3D11_BUFFER_DESC*>(e.desc.data()), data ? &init : nullptr,
+            reinterpret_cast<ID3D11Buffer**>(e.slot));
+        break;
+    case MANIFEST_SAMPLER:
+        hr = device->CreateSamplerState(reinterpret_cast<const D3D11_SAMPLER_DESC*>(e.desc.data()),
+            reinterpret_cast<ID3D11SamplerState**>(e.slot));
+        break;
+    case MANIFEST_TEXTURE2D:
+        hr = device->CreateTexture2D(reinterpret_cast<const D3D11_TEXTURE2D_DESC*>(e.desc.data()), data ? &init : nullptr,
+            reinterpret_cast<ID3D11Texture2D**>(e.slot));
+        break;
+    case MANIFEST_TEXTURE3D:
+        hr = device->CreateTexture3D(reinterpret_cast<const D3D11_TEXTURE3D_DESC*>(e.desc.data()), data ? &init : nullptr,
+            reinterpret_cast<ID3D11Texture3D**>(e.slot));
+        break;
+    case MANIFEST_SRV: {
+        auto* resource = static_cast<ID3D11Resource*>(*gpu->manifest.entries[e.deps[0]].slot);
+        hr = device->CreateShaderResourceView(resource,
+            e.desc.empty() ? nullptr : reinterpret_cast<const D3D11_SHADER_RESOURCE_VIEW_DESC*>(e.desc.data()),
+            reinterpret_cast<ID3D11ShaderResourceView**>(e.slot));
+        break;
+    }
+    }
     if (FAILED(hr)) {
-        std::cerr << "Failed to create vertex shader: 0x" << std::hex << hr << std::dec << std::endl;
-        vsBlob->Release();
-        psBlob->Release();
+        std::cerr << "Failed to create " << e.name << ": 0x" << std::hex << hr << std::dec << std::endl;
+        *e.slot = nullptr;
         return false;
     }
-    hr = g_device->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(), nullptr, &g_ps);
+    return true;
+}
+
+static void ReleaseManifestObject(GpuDevice* gpu, int index) {
+    void** slot = gpu->manifest.entries[index].slot;
+    if (*slot) {
+        static_cast<IUnknown*>(*slot)->Release();
+        *slot = nullptr;
+    }
+}
+
+// Create every manifest object on the group's device, independent objects in parallel
+static bool ReplayDeviceManifest(GpuDevice* gpu) {
+    std::vector<std::vector<int>> waves;
+    std::vector<int> unplaced;
+    if (!PlanManifestWaves(gpu->manifest, waves, unplaced)) {
+        // Dropped by the replay (with their groups); fails it only if one is required
+        for (int i : unplaced) {
+            std::cerr << "GPU resource " << gpu->manifest.entries[i].name << " has a broken dependency" << std::endl;
+        }
+    }
+    int threads = (std::min)((std::max)((int)std::thread::hardware_concurrency(), 1), 4);
+    ManifestReplayResult result = ReplayManifest(gpu->manifest, waves,
+        [gpu](int i) { return CreateManifestObject(gpu, i); },
+        [gpu](int i) { ReleaseManifestObject(gpu, i); }, threads);
+    std::cout << "GPU resources: " << result.created << " created in " << waves.size() << " waves";
+    if (result.failed || result.skipped) {
+        std::cout << " (" << result.failed << " failed, " << result.skipped << " dropped)";
+    }
+    std::cout << std::endl;
+    return result.ok;
+}
+
+// Device and immediate context on the group's adapter
+static bool CreateGpuDevice(GpuDevice* gpu, IDXGIAdapter1* adapter) {
+    D3D_FEATURE_LEVEL featureLevel;
+    UINT flags = D3D11_CREATE_DEVICE_BGRA_SUPPORT;
+#ifdef _DEBUG
+    flags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif
+
+    // Explicit adapter requires D3D_DRIVER_TYPE_UNKNOWN
+    HRESULT hr = D3D11CreateDevice(adapter, D3D_DRIVER_TYPE_UNKNOWN, nullptr, flags,
+        nullptr, 0, D3D11_SDK_VERSION, &gpu->device, &featureLevel, &gpu->context);
     if (FAILED(hr)) {
-        std::cerr << "Failed to create pixel shader: 0x" << std::hex << hr << std::dec << std::endl;
-        vsBlob->Release();
-        psBlob->Release();
+        std::wcerr << L"D3D11CreateDevice failed on " << gpu->adapterName << L": 0x" << std::hex << hr << std::dec << std::endl;
         return false;
     }
-    vsBlob->Release();
-    psBlob->Release();
+    return true;
+}
 
-    // Compile compute shader for dynamic peak detection
-    ID3DBlob* csBlob = nullptr;
-    hr = D3DCompile(g_csSource, strlen(g_csSource), "CS", nullptr, nullptr,
-        "main", "cs_5_0", 0, 0, &csBlob, &errorBlob);
-    if (FAILED(hr)) {
-        if (errorBlob) {
-            std::cerr << "CS Error: " << (char*)errorBlob->GetBufferPointer() << std::endl;
-            errorBlob->Release();
-        }
-        // Non-fatal: dynamic peak detection just won't work
-        std::cerr << "Warning: Compute shader compilation failed, dynamic peak detection disabled" << std::endl;
-    } else {
-        if (errorBlob) { errorBlob->Release(); errorBlob = nullptr; }  // May contain warnings
-        hr = g_device->CreateComputeShader(csBlob->GetBufferPointer(), csBlob->GetBufferSize(), nullptr, &g_peakDetectCS);
-        csBlob->Release();
-        if (FAILED(hr)) {
-            std::cerr << "Failed to create peak detection compute shader: 0x" << std::hex << hr << std::dec << std::endl;
-            g_peakDetectCS = nullptr;
+// Create the device and shared resources for one adapter group
+static bool InitGpuDevice(GpuDevice* gpu, IDXGIAdapter1* adapter) {
+    if (!CreateGpuDevice(gpu, adapter)) return false;
+    if (!BuildDeviceManifest(gpu)) return false;
+    if (!ReplayDeviceManifest(gpu)) return false;
+
+    std::cout << "Blue noise dithering: enabled (64x64 texture)" << std::endl;
+    if (gpu->analysisCS) {
+        std::cout << "Analysis compute shader: enabled" << std::endl;
+    }
+    return true;
+}
+
+// Enumerate adapters (in DXGI order) and the monitors attached to each
+// adapters[i] holds a reference matching topology[i] - caller releases
+static bool EnumerateAdapters(IDXGIFactory1* factory, std::vector<AdapterTopology>& topology,
+                              std::vector<IDXGIAdapter1*>& adapters, std::vector<std::wstring>& names) {
+    IDXGIAdapter1* adapter = nullptr;
+    for (UINT i = 0; factory->EnumAdapters1(i, &adapter) != DXGI_ERROR_NOT_FOUND; i++) {
+        DXGI_ADAPTER_DESC1 desc;
+        if (FAILED(adapter->GetDesc1(&desc))) {
+            adapter->Release();
+            continue;
         }
 
-        // Create constant buffer for peak detection parameters (only if shader succeeded)
-        if (g_peakDetectCS) {
-            D3D11_BUFFER_DESC peakCbDesc = {};
-            peakCbDesc.ByteWidth = 32;  // 8 floats: width, height, riseRate, fallRate, maxRise, maxFall, pad, pad
-            peakCbDesc.Usage = D3D11_USAGE_DYNAMIC;
-            peakCbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-            peakCbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-            hr = g_device->CreateBuffer(&peakCbDesc, nullptr, &g_peakCB);
-            if (FAILED(hr)) {
-                std::cerr << "Failed to create peak CB: 0x" << std::hex << hr << std::endl;
-                g_peakDetectCS->Release();
-                g_peakDetectCS = nullptr;
+        AdapterTopology entry;
+        entry.id.lowPart = desc.AdapterLuid.LowPart;
+        entry.id.highPart = desc.AdapterLuid.HighPart;
+        entry.software = (desc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) != 0;
+
+        IDXGIOutput* output = nullptr;
+        for (UINT j = 0; adapter->EnumOutputs(j, &output) != DXGI_ERROR_NOT_FOUND; j++) {
+            DXGI_OUTPUT_DESC outDesc;
+            if (SUCCEEDED(output->GetDesc(&outDesc))) {
+                entry.outputs.push_back(outDesc.Monitor);
             }
+            output->Release();
         }
+
+        topology.push_back(entry);
+        adapters.push_back(adapter);
+        names.push_back(desc.Description);
     }
+    return !adapters.empty();
+}
 
-    // Compile analysis compute shader
-    ID3DBlob* analysisBlob = nullptr;
-    hr = D3DCompile(g_analysisCSSource, strlen(g_analysisCSSource), "AnalysisCS", nullptr, nullptr,
-        "main", "cs_5_0", 0, 0, &analysisBlob, &errorBlob);
+bool InitD3D(const std::vector<HMONITOR>& monitors) {
+    IDXGIFactory1* factory = nullptr;
+    HRESULT hr = CreateDXGIFactory1(IID_PPV_ARGS(&factory));
     if (FAILED(hr)) {
-        if (errorBlob) {
-            std::cerr << "Analysis CS Error: " << (char*)errorBlob->GetBufferPointer() << std::endl;
-            errorBlob->Release();
+        std::cerr << "CreateDXGIFactory1 failed: 0x" << std::hex << hr << std::dec << std::endl;
+        return false;
+    }
+
+    std::vector<AdapterTopology> topology;
+    std::vector<IDXGIAdapter1*> adapters;
+    std::vector<std::wstring> names;
+    EnumerateAdapters(factory, topology, adapters, names);
+    factory->Release();
+
+    std::vector<const void*> monitorKeys(monitors.begin(), monitors.end());
+    DeviceGroupPlan plan;
+    bool ok = PlanDeviceGroups(topology, monitorKeys, plan);
+    if (!ok) {
+        std::cerr << "No DXGI adapters found" << std::endl;
+    }
+
+    // One device per adapter that drives a configured monitor
+    for (size_t g = 0; ok && g < plan.groupAdapter.size(); g++) {
+        int a = plan.groupAdapter[g];
+        auto gpu = std::make_unique<GpuDevice>();
+        gpu->adapterId = topology[a].id;
+        gpu->adapterName = names[a];
+        for (size_t m = 0; m < monitors.size(); m++) {
+            if (plan.monitorGroup[m] == (int)g) gpu->monitors.push_back(monitors[m]);
         }
-        std::cerr << "Warning: Analysis compute shader compilation failed, frame analysis disabled" << std::endl;
-    } else {
-        if (errorBlob) { errorBlob->Release(); errorBlob = nullptr; }  // May contain warnings
-        hr = g_device->CreateComputeShader(analysisBlob->GetBufferPointer(), analysisBlob->GetBufferSize(), nullptr, &g_analysisCS);
-        analysisBlob->Release();
-        if (FAILED(hr)) {
-            std::cerr << "Failed to create analysis compute shader: 0x" << std::hex << hr << std::dec << std::endl;
-            g_analysisCS = nullptr;
+
+        ok = InitGpuDevice(gpu.get(), adapters[a]);
+        std::wcout << L"GPU device group " << g << L": " << gpu->adapterName << L" ("
+                   << gpu->monitors.size() << L" monitor(s))" << (ok ? L"" : L" - init failed") << std::endl;
+        g_gpuDevices.push_back(std::move(gpu));
+    }
+
+    for (size_t m = 0; m < monitors.size(); m++) {
+        if (plan.monitorFallback.size() > m && plan.monitorFallback[m]) {
+            std::cerr << "Warning: no adapter owns monitor " << m << " output, using fallback device" << std::endl;
         }
+    }
+
+    for (auto* adapter : adapters) {
+        adapter->Release();
+    }
+    return ok;
+}
+
+GpuDevice* FindGpuDevice(HMONITOR monitor) {
+    for (auto& gpu : g_gpuDevices) {
+        for (HMONITOR m : gpu->monitors) {
+            if (m == monitor) return gpu.get();
+        }
+    }
+    return nullptr;
+}
 
-        // Create constant buffer for analysis parameters (only if shader succeeded)
-        if (g_analysisCS) {
-            D3D11_BUFFER_DESC analysisCbDesc = {};
-            analysisCbDesc.ByteWidth = 16;  // 4 uints: width, height, isHDR, pad
-            analysisCbDesc.Usage = D3D11_USAGE_DYNAMIC;
-            analysisCbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-            analysisCbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-            hr = g_device->CreateBuffer(&analysisCbDesc, nullptr, &g_analysisCB);
-            if (FAILED(hr)) {
-                std::cerr << "Failed to create analysis CB: 0x" << std::hex << hr << std::endl;
-                g_analysisCS->Release();
-                g_analysisCS = nullptr;
-            } else {
-                std::cout << "Analysis compute shader: enabled" << std::endl;
+GpuDevice* AssignGpuDevice(HMONITOR monitor) {
+    ReleaseGpuMonitor(monitor);
+
+    IDXGIFactory1* factory = nullptr;
+    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory)))) return nullptr;
+    std::vector<AdapterTopology> topology;
+    std::vector<IDXGIAdapter1*> adapters;
+    std::vector<std::wstring> names;
+    EnumerateAdapters(factory, topology, adapters, names);
+    factory->Release();
+    for (auto* adapter : adapters) {
+        adapter->Release();
+    }
+
+    // Only adapters that already have a device group - a new adapter needs InitD3D
+    for (const auto& entry : topology) {
+        if (std::find(entry.outputs.begin(), entry.outputs.end(), (const void*)monitor) == entry.outputs.end()) continue;
+        for (auto& gpu : g_gpuDevices) {
+            if (gpu->adapterId == entry.id && gpu->device) {
+                gpu->monitors.push_back(monitor);
+                return gpu.get();
             }
         }
     }
+    return nullptr;
+}
 
-    // Create samplers
-    D3D11_SAMPLER_DESC sdPoint = {};
-    sdPoint.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
-    sdPoint.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
-    sdPoint.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
-    sdPoint.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
-    hr = g_device->CreateSamplerState(&sdPoint, &g_samplerPoint);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to create point sampler: 0x" << std::hex << hr << std::dec << std::endl;
-        return false;
+void ReleaseGpuMonitor(HMONITOR monitor) {
+    for (auto& gpu : g_gpuDevices) {
+        gpu->monitors.erase(std::remove(gpu->monitors.begin(), gpu->monitors.end(), monitor), gpu->monitors.end());
     }
+}
 
-    D3D11_SAMPLER_DESC sdLinear = {};
-    sdLinear.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-    sdLinear.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
-    sdLinear.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
-    sdLinear.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
-    hr = g_device->CreateSamplerState(&sdLinear, &g_samplerLinear);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to create linear sampler: 0x" << std::hex << hr << std::dec << std::endl;
-        return false;
+// Pooled LUTs of devices torn down by a regroup, so the new groups upload their retained copies
+// instead of reading the files (render thread only)
+static std::vector<PooledLUT> g_orphanedLUTs;
+
+// The texture's RGBA texels from a pooled LUT's retained RGB copy
+static ManifestBlob ExpandRetainedLUT(const std::vector<uint16_t>& rgb) {
+    size_t count = rgb.size() / 3;
+    auto bytes = std::make_shared<std::vector<uint8_t>>();
+    try {
+        bytes->resize(count * 4 * sizeof(uint16_t));
+    } catch (const std::bad_alloc&) {
+        std::cerr << "Failed to allocate memory for a " << count << "-texel LUT" << std::endl;
+        return nullptr;
     }
+    ExpandLUTRGB(rgb.data(), count, reinterpret_cast<uint16_t*>(bytes->data()));
+    return bytes;
+}
 
-    // Wrap sampler for blue noise tiling
-    D3D11_SAMPLER_DESC sdWrap = {};
-    sdWrap.Filter = D3D11_FILTER_MIN_MAG_MIP_POINT;
-    sdWrap.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
-    sdWrap.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
-    sdWrap.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
-    hr = g_device->CreateSamplerState(&sdWrap, &g_samplerWrap);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to create wrap sampler: 0x" << std::hex << hr << std::dec << std::endl;
+// A retained copy of exactly this LUT, held by another device group or left by a regroup
+static const PooledLUT* FindRetainedLUT(const LUTPoolKey& key) {
+    for (const auto& gpu : g_gpuDevices) {
+        for (const auto& entry : gpu->lutPool) {
+            if (entry.key == key && entry.retained) return &entry;
+        }
+    }
+    for (const auto& entry : g_orphanedLUTs) {
+        if (entry.key == key && entry.retained) return &entry;
+    }
+    return nullptr;
+}
+
+// Key of the LUT at `path` as it is now; false if a file is missing
+static bool CurrentLUTKey(const std::wstring& path, LUTPoolKey& key) {
+    key = {};
+    key.path = path;
+    std::vector<std::wstring> files = IsLUTStack(path) ? SplitLUTStack(path) : std::vector<std::wstring>{ path };
+    key.stamps.resize(files.size());
+    for (size_t i = 0; i < files.size(); i++) {
+        if (!GetLUTFileStamp(files[i], key.stamps[i])) return false;
+    }
+    // Single files are interpolated in the shader, so only a stack's texels depend on the mode
+    if (IsLUTStack(path) && g_tetrahedralInterp.load()) key.interp = LUT_INTERP_TETRAHEDRAL;
+    return true;
+}
+
+// Pool entry with manifest entries for a LUT. `texture` is adopted (already created and filled),
+// or null to create the texture from `initial` (its RGBA texels, or null to expand `retained`).
+// The manifest replays from `retained`, so recovering from device loss reads no files. A path
+// already pooled under an older key is replaced in place: the pool lets go of the old texture
+// (monitors still holding it keep it until they reload) and its manifest entries are rewritten,
+// so reloading an edited file doesn't grow the pool or the manifest. On failure an adopted
+// texture is released and a new entry leaves no trace; a replaced one stays empty until the next
+// load.
+static bool AddPooledLUT(GpuDevice* gpu, const LUTPoolKey& key, int lutSize, RetainedLUTTexels retained,
+                         ManifestBlob initial, ID3D11Texture3D* texture, ID3D11Texture3D** outTexture,
+                         ID3D11ShaderResourceView** outSRV) {
+    D3D11_TEXTURE3D_DESC texDesc = {};
+    texDesc.Width = lutSize;
+    texDesc.Height = lutSize;
+    texDesc.Depth = lutSize;
+    texDesc.MipLevels = 1;
+    texDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    texDesc.Usage = D3D11_USAGE_IMMUTABLE;  // Replays create it whole from the retained texels
+    texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    PooledLUT* pooled = nullptr;
+    for (auto& entry : gpu->lutPool) {
+        if (entry.key.path == key.path) pooled = &entry;
+    }
+    bool replacing = pooled != nullptr;
+    size_t firstEntry = gpu->manifest.entries.size();
+    if (replacing) {
+        ReleaseManifestObject(gpu, pooled->manifestIndex + 1);
+        ReleaseManifestObject(gpu, pooled->manifestIndex);
+    } else {
+        gpu->lutPool.push_back({});
+        pooled = &gpu->lutPool.back();
+        std::string name = "lut:" + std::to_string(gpu->lutPool.size());
+        int group = gpu->nextManifestGroup++;
+
+        ManifestEntry entry;
+        entry.name = name;
+        entry.kind = MANIFEST_TEXTURE3D;
+        entry.group = group;
+        entry.required = false;  // A LUT that can't be recreated fails its monitors, not the device
+        entry.slot = (void**)&pooled->texture;
+        pooled->manifestIndex = AddManifestEntry(gpu->manifest, std::move(entry));
+        AddViewEntry(gpu->manifest, name + ":srv", pooled->manifestIndex, (void**)&pooled->srv, group, false);
+    }
+    pooled->key = key;
+    pooled->lutSize = lutSize;
+    pooled->texture = texture;
+    pooled->retained = retained;
+
+    ManifestEntry& entry = gpu->manifest.entries[pooled->manifestIndex];
+    SetManifestDesc(entry, texDesc);
+    entry.load = [retained] { return ExpandRetainedLUT(*retained); };
+    entry.rowPitch = lutSize * 4 * sizeof(uint16_t);       // 4 components × 2 bytes
+    entry.slicePitch = lutSize * lutSize * 4 * sizeof(uint16_t);
+
+    bool created = (texture || CreateManifestObject(gpu, pooled->manifestIndex, std::move(initial))) &&
+                   CreateManifestObject(gpu, pooled->manifestIndex + 1);
+    if (!created) {
+        ReleaseManifestObject(gpu, pooled->manifestIndex);   // Also the adopted texture
+        if (replacing) {
+            pooled->key.stamps.clear();                      // Never matches: the next load retries
+            pooled->retained = nullptr;
+            return false;
+        }
+        // No pool entry or manifest records for a LUT that never made it onto the device, so
+        // replays don't keep retrying it
+        gpu->manifest.entries.resize(firstEntry);
+        gpu->lutPool.pop_back();
+        gpu->nextManifestGroup--;
         return false;
     }
 
-    // Create constant buffer for shader parameters
-    D3D11_BUFFER_DESC cbDesc = {};
-    cbDesc.ByteWidth = 256;  // 64 floats (16 float4s) - includes grayscale peak
-    cbDesc.Usage = D3D11_USAGE_DYNAMIC;
-    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
-    cbDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
-    hr = g_device->CreateBuffer(&cbDesc, nullptr, &g_constantBuffer);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to create constant buffer: 0x" << std::hex << hr << std::endl;
+    // Pool keeps its own reference so the texture outlives any single monitor
+    pooled->texture->AddRef();
+    pooled->srv->AddRef();
+    *outTexture = pooled->texture;
+    *outSRV = pooled->srv;
+    return true;
+}
+
+// Map the file and upload each z-slice as soon as it is converted, so parsing, conversion and
+// upload overlap. Large files are parsed in parallel chunks into a whole FP16 buffer; smaller ones
+// stream through a parser thread and a few slices of staging. Each slice is also packed into the
+// retained RGB copy the manifest replays from after device loss.
+static bool StreamLUTTexture(GpuDevice* gpu, const LUTPoolKey& key, int& lutSize,
+                             ID3D11Texture3D** outTexture, ID3D11ShaderResourceView** outSRV) {
+    auto start = std::chrono::steady_clock::now();
+    const std::wstring& path = key.path;
+    LUTFileView view;
+    if (!OpenLUTFileView(path, view)) {
+        MetricInc(g_metrics.lutLoadFailures);
         return false;
     }
 
-    // Create blue noise texture for SDR dithering
-    D3D11_TEXTURE2D_DESC noiseDesc = {};
-    noiseDesc.Width = 64;
-    noiseDesc.Height = 64;
-    noiseDesc.MipLevels = 1;
-    noiseDesc.ArraySize = 1;
-    noiseDesc.Format = DXGI_FORMAT_R8_UNORM;
-    noiseDesc.SampleDesc.Count = 1;
-    noiseDesc.Usage = D3D11_USAGE_IMMUTABLE;
-    noiseDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    ID3D11Texture3D* texture = nullptr;
+    UINT rowPitch = 0;
+    UINT slicePitch = 0;
+    int size = 0;
+    std::shared_ptr<std::vector<uint16_t>> retained = std::make_shared<std::vector<uint16_t>>();
 
-    D3D11_SUBRESOURCE_DATA noiseData = {};
-    noiseData.pSysMem = g_blueNoiseData;
-    noiseData.SysMemPitch = 64;
+    auto begin = [&](int lutSizeRead) {
+        size = lutSizeRead;
+        rowPitch = size * 4 * sizeof(uint16_t);
+        slicePitch = rowPitch * size;
+        try {
+            retained->resize((size_t)size * size * size * 3);
+        } catch (const std::bad_alloc&) {
+            std::cerr << "Failed to allocate memory for " << size << "^3 LUT" << std::endl;
+            return false;
+        }
 
-    hr = g_device->CreateTexture2D(&noiseDesc, &noiseData, &g_blueNoiseTexture);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to create blue noise texture: 0x" << std::hex << hr << std::endl;
+        // DEFAULT usage: slices arrive as boxes while the rest of the file is still parsing
+        D3D11_TEXTURE3D_DESC texDesc = {};
+        texDesc.Width = size;
+        texDesc.Height = size;
+        texDesc.Depth = size;
+        texDesc.MipLevels = 1;
+        texDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;
+        texDesc.Usage = D3D11_USAGE_DEFAULT;
+        texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        HRESULT hr = gpu->device->CreateTexture3D(&texDesc, nullptr, &texture);
+        if (FAILED(hr)) {
+            std::cerr << "Failed to create 3D LUT texture: 0x" << std::hex << hr << std::dec << std::endl;
+            return false;
+        }
+        return true;
+    };
+    auto upload = [&](int z, const uint16_t* texels) {
+        D3D11_BOX box = { 0, 0, (UINT)z, (UINT)size, (UINT)size, (UINT)z + 1 };
+        gpu->context->UpdateSubresource(texture, 0, &box, texels, rowPitch, slicePitch);
+        size_t sliceTexels = (size_t)size * size;
+        PackLUTRGB(texels, sliceTexels, retained->data() + (size_t)z * sliceTexels * 3);
+        return true;
+    };
+
+    bool isCube = IsCubePath(path);
+    std::string error;
+    bool ok;
+    std::string detail;
+    if (view.size >= LUT_PARALLEL_MIN_BYTES) {
+        LutText text;
+        LutParseStats stats;
+        std::vector<uint16_t> texels;
+        ok = ScanLUTHeader(view.data, view.size, isCube, text, error);
+        if (ok && !begin(text.lutSize)) {
+            ok = false;
+            error = "LUT upload could not start";
+        }
+        if (ok) {
+            try {
+                texels.resize((size_t)size * size * size * 4);
+            } catch (const std::bad_alloc&) {
+                ok = false;
+                error = "Failed to allocate memory for " + std::to_string(size) + "^3 LUT";
+            }
+        }
+        if (ok) {
+            ok = ParseLUTBodyHalf(text, 0, texels.data(),
+                [&](int z) { return upload(z, texels.data() + (size_t)z * size * size * 4); }, stats, error);
+        }
+        detail = std::to_string(stats.threads) + " threads, " + std::to_string(stats.chunks) + " chunks";
+    } else {
+        LutIngestSink sink;
+        sink.begin = begin;
+        sink.slice = [&](int z, const uint16_t* texels) { return upload(z, texels); };
+        LutIngestStats stats;
+        ok = IngestLUT(view.data, view.size, isCube, LUT_INGEST_SLOTS, sink, stats, error);
+        detail = std::to_string(stats.arenaBytes / 1024) + " KB staging, " + std::to_string(stats.parserStalls) +
+                 " parser / " + std::to_string(stats.sinkStalls) + " upload waits";
+    }
+    CloseLUTFileView(view);
+
+    if (!ok) {
+        std::cerr << error << std::endl;
+        if (texture) texture->Release();
+        MetricInc(g_metrics.lutLoadFailures);
         return false;
     }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    MetricObserve(g_metrics.lutLoadMs, ms);
+    std::cout << "Loaded " << size << "^3 LUT in " << (int)ms << " ms (" << detail << ")" << std::endl;
 
-    hr = g_device->CreateShaderResourceView(g_blueNoiseTexture, nullptr, &g_blueNoiseSRV);
-    if (FAILED(hr)) {
-        std::cerr << "Failed to create blue noise SRV: 0x" << std::hex << hr << std::endl;
+    if (!AddPooledLUT(gpu, key, size, std::move(retained), nullptr, texture, outTexture, outSRV)) {
+        MetricInc(g_metrics.lutLoadFailures);
         return false;
     }
+    lutSize = size;
+    return true;
+}
 
-    std::cout << "Blue noise dithering: enabled (64x64 texture)" << std::endl;
+bool LoadLUTTexture(GpuDevice* gpu, const std::wstring& path, bool isHDR, int& lutSize,
+                    ID3D11Texture3D** outTexture, ID3D11ShaderResourceView** outSRV) {
+    // Reused only while nothing it was made from changed (a missing file never matches)
+    LUTPoolKey key;
+    bool keyed = CurrentLUTKey(path, key);
+    for (auto& entry : gpu->lutPool) {
+        if (keyed && entry.key == key && entry.texture) {
+            entry.texture->AddRef();
+            entry.srv->AddRef();
+            *outTexture = entry.texture;
+            *outSRV = entry.srv;
+            lutSize = entry.lutSize;
+            return true;
+        }
+    }
 
-    return true;
+    // Another device group (or the devices a regroup replaced) already holds these texels
+    const PooledLUT* held = keyed ? FindRetainedLUT(key) : nullptr;
+    if (held) {
+        int size = held->lutSize;
+        if (!AddPooledLUT(gpu, key, size, held->retained, nullptr, nullptr, outTexture, outSRV)) return false;
+        lutSize = size;
+        return true;
+    }
+
+    // A stack is composed on the CPU into one texture, so the shader still does a single lookup
+    // (the composition cache lets a changed interpolation or member skip recomposing the rest)
+    if (IsLUTStack(path)) {
+        ManifestBlob payload;
+        int size = 0;
+        if (!LoadLUTStack(path, isHDR, payload, size)) return false;
+        size_t count = (size_t)size * size * size;
+        auto retained = std::make_shared<std::vector<uint16_t>>();
+        try {
+            retained->resize(count * 3);
+        } catch (const std::bad_alloc&) {
+            std::cerr << "Failed to allocate memory for " << size << "^3 LUT" << std::endl;
+            return false;
+        }
+        PackLUTRGB(reinterpret_cast<const uint16_t*>(payload->data()), count, retained->data());
+        if (!AddPooledLUT(gpu, key, size, std::move(retained), std::move(payload), nullptr, outTexture, outSRV)) {
+            return false;
+        }
+        lutSize = size;
+        return true;
+    }
+
+    return StreamLUTTexture(gpu, key, lutSize, outTexture, outSRV);
 }
 
 bool CheckTearingSupport() {
+    // Tearing is a factory feature - the first device's factory answers for all groups
+    if (g_gpuDevices.empty()) return false;
+
     IDXGIDevice* dxgiDevice = nullptr;
-    if (FAILED(g_device->QueryInterface(IID_PPV_ARGS(&dxgiDevice))) || !dxgiDevice) {
+    if (FAILED(g_gpuDevices.front()->device->QueryInterface(IID_PPV_ARGS(&dxgiDevice))) || !dxgiDevice) {
         std::cerr << "Failed to get DXGI device for tearing check" << std::endl;
         return false;
     }
-
     IDXGIAdapter* adapter = nullptr;
     if (FAILED(dxgiDevice->GetAdapter(&adapter)) || !adapter) {
         std::cerr << "Failed to get adapter for tearing check" << std::endl;
@@ -259,130 +793,262 @@ bool CheckTearingSupport() {
     return g_tearingSupported;
 }
 
+// ============================================================================
+// Readback - staging resources on the monitor's device group
+// ============================================================================
+
+ReadbackManager& MonitorReadbacks(MonitorContext* ctx) {
+    ReadbackManager& m = ctx->stats->readback;
+    if (m.ops.create) return m;
+
+    // ctx->gpu is read on every call (device-loss regrouping can move the monitor)
+    m.ops.create = [ctx](const ReadbackDesc& desc) -> void* {
+        ID3D11Resource* resource = nullptr;
+        HRESULT hr;
+        if (desc.format != 0) {
+            D3D11_TEXTURE2D_DESC td = {};
+            td.Width = desc.width;
+            td.Height = desc.height;
+            td.MipLevels = 1;
+            td.ArraySize = 1;
+            td.Format = (DXGI_FORMAT)desc.format;
+            td.SampleDesc.Count = 1;
+            td.Usage = D3D11_USAGE_STAGING;
+            td.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+            ID3D11Texture2D* texture = nullptr;
+            hr = ctx->gpu->device->CreateTexture2D(&td, nullptr, &texture);
+            resource = texture;
+        } else {
+            D3D11_BUFFER_DESC bd = {};
+            bd.ByteWidth = desc.bytes;
+            bd.Usage = D3D11_USAGE_STAGING;
+            bd.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+            ID3D11Buffer* buffer = nullptr;
+            hr = ctx->gpu->device->CreateBuffer(&bd, nullptr, &buffer);
+            resource = buffer;
+        }
+        if (FAILED(hr)) {
+            std::cerr << "Failed to create readback staging resource: 0x" << std::hex << hr << std::dec << std::endl;
+            return nullptr;
+        }
+        return resource;
+    };
+    m.ops.release = [](void* staging) {
+        static_cast<ID3D11Resource*>(staging)->Release();
+    };
+    m.ops.copy = [ctx](void* staging, void* source) {
+        ctx->gpu->context->CopyResource(static_cast<ID3D11Resource*>(staging), static_cast<ID3D11Resource*>(source));
+    };
+    m.ops.map = [ctx](void* staging, const void** data) {
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        HRESULT hr = ctx->gpu->context->Map(static_cast<ID3D11Resource*>(staging), 0, D3D11_MAP_READ,
+                                            D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if (hr == DXGI_ERROR_WAS_STILL_DRAWING) return READBACK_MAP_BUSY;
+        if (FAILED(hr)) return READBACK_MAP_FAILED;
+        *data = mapped.pData;
+        return READBACK_MAP_READY;
+    };
+    m.ops.unmap = [ctx](void* staging) {
+        ctx->gpu->context->Unmap(static_cast<ID3D11Resource*>(staging), 0);
+    };
+    return m;
+}
+
 void ReleaseMonitorD3DResources(MonitorContext* ctx) {
     if (ctx->duplication) { ctx->duplication->Release(); ctx->duplication = nullptr; }
-    if (ctx->dcompVisual) { ctx->dcompVisual->Release(); ctx->dcompVisual = nullptr; }
-    if (ctx->dcompTarget) { ctx->dcompTarget->Release(); ctx->dcompTarget = nullptr; }
+    if (ctx->cold->dcompVisual) { ctx->cold->dcompVisual->Release(); ctx->cold->dcompVisual = nullptr; }
+    if (ctx->cold->dcompTarget) { ctx->cold->dcompTarget->Release(); ctx->cold->dcompTarget = nullptr; }
     if (ctx->captureSRV) { ctx->captureSRV->Release(); ctx->captureSRV = nullptr; }
     if (ctx->lutSRV_SDR) { ctx->lutSRV_SDR->Release(); ctx->lutSRV_SDR = nullptr; }
-    if (ctx->lutTextureSDR) { ctx->lutTextureSDR->Release(); ctx->lutTextureSDR = nullptr; }
+    if (ctx->cold->lutTextureSDR) { ctx->cold->lutTextureSDR->Release(); ctx->cold->lutTextureSDR = nullptr; }
     if (ctx->lutSRV_HDR) { ctx->lutSRV_HDR->Release(); ctx->lutSRV_HDR = nullptr; }
-    if (ctx->lutTextureHDR) { ctx->lutTextureHDR->Release(); ctx->lutTextureHDR = nullptr; }
+    if (ctx->cold->lutTextureHDR) { ctx->cold->lutTextureHDR->Release(); ctx->cold->lutTextureHDR = nullptr; }
+    ctx->cold->lutMutableSDR = false;
+    ctx->cold->lutMutableHDR = false;
     if (ctx->peakSRV) { ctx->peakSRV->Release(); ctx->peakSRV = nullptr; }
     if (ctx->peakUAV) { ctx->peakUAV->Release(); ctx->peakUAV = nullptr; }
     if (ctx->peakTexture) { ctx->peakTexture->Release(); ctx->peakTexture = nullptr; }
-    if (ctx->peakStagingTexture) { ctx->peakStagingTexture->Release(); ctx->peakStagingTexture = nullptr; }
-    // Analysis resources
-    if (ctx->analysisUAV) { ctx->analysisUAV->Release(); ctx->analysisUAV = nullptr; }
-    if (ctx->analysisBuffer) { ctx->analysisBuffer->Release(); ctx->analysisBuffer = nullptr; }
+    if (ctx->tileStatsSRV) { ctx->tileStatsSRV->Release(); ctx->tileStatsSRV = nullptr; }
+    if (ctx->tileStatsUAV) { ctx->tileStatsUAV->Release(); ctx->tileStatsUAV = nullptr; }
+    if (ctx->tileStatsBuffer) { ctx->tileStatsBuffer->Release(); ctx->tileStatsBuffer = nullptr; }
+    ctx->tileStatsCapacity = 0;
+    ReleaseReadbacks(ctx->stats->readback);
     for (int i = 0; i < 2; i++) {
-        if (ctx->analysisStagingBuffer[i]) {
-            ctx->analysisStagingBuffer[i]->Release();
-            ctx->analysisStagingBuffer[i] = nullptr;
-        }
+        if (ctx->gamutSRV[i]) { ctx->gamutSRV[i]->Release(); ctx->gamutSRV[i] = nullptr; }
+        if (ctx->gamutTexture[i]) { ctx->gamutTexture[i]->Release(); ctx->gamutTexture[i] = nullptr; }
+        ctx->gamutUploadedVersion[i] = 0;  // Re-upload from CPU copy after recovery
     }
+    // Analysis and scope resources
+    ReleaseAnalysisResources(ctx);
+    if (ctx->backBufferUAV) { ctx->backBufferUAV->Release(); ctx->backBufferUAV = nullptr; }
     if (ctx->rtv) { ctx->rtv->Release(); ctx->rtv = nullptr; }
     if (ctx->swapchain) { ctx->swapchain->Release(); ctx->swapchain = nullptr; }
     // Keep hwnd - we'll reuse it
 }
 
+// Release every manifest object and the device, keeping the manifest for a replay
+static void ReleaseGpuObjects(GpuDevice* gpu) {
+    for (int i = (int)gpu->manifest.entries.size() - 1; i >= 0; i--) {
+        ReleaseManifestObject(gpu, i);
+    }
+    if (gpu->context) { gpu->context->Release(); gpu->context = nullptr; }
+    if (gpu->device) { gpu->device->Release(); gpu->device = nullptr; }
+}
+
+static void ReleaseGpuDevice(GpuDevice* gpu) {
+    ReleaseGpuObjects(gpu);
+    gpu->manifest.entries.clear();
+    gpu->lutPool.clear();
+    gpu->nextManifestGroup = 0;
+}
+
 void ReleaseSharedD3DResources() {
     if (g_dcompDevice) { g_dcompDevice->Release(); g_dcompDevice = nullptr; }
-    if (g_blueNoiseSRV) { g_blueNoiseSRV->Release(); g_blueNoiseSRV = nullptr; }
-    if (g_blueNoiseTexture) { g_blueNoiseTexture->Release(); g_blueNoiseTexture = nullptr; }
-    if (g_constantBuffer) { g_constantBuffer->Release(); g_constantBuffer = nullptr; }
-    if (g_samplerPoint) { g_samplerPoint->Release(); g_samplerPoint = nullptr; }
-    if (g_samplerLinear) { g_samplerLinear->Release(); g_samplerLinear = nullptr; }
-    if (g_samplerWrap) { g_samplerWrap->Release(); g_samplerWrap = nullptr; }
-    if (g_peakDetectCS) { g_peakDetectCS->Release(); g_peakDetectCS = nullptr; }
-    if (g_peakCB) { g_peakCB->Release(); g_peakCB = nullptr; }
-    if (g_analysisCS) { g_analysisCS->Release(); g_analysisCS = nullptr; }
-    if (g_analysisCB) { g_analysisCB->Release(); g_analysisCB = nullptr; }
-    if (g_ps) { g_ps->Release(); g_ps = nullptr; }
-    if (g_vs) { g_vs->Release(); g_vs = nullptr; }
-    if (g_context) { g_context->Release(); g_context = nullptr; }
-    if (g_device) { g_device->Release(); g_device = nullptr; }
+    for (auto& gpu : g_gpuDevices) {
+        ReleaseGpuDevice(gpu.get());
+    }
+    g_gpuDevices.clear();
+    g_orphanedLUTs.clear();
+}
+
+// New devices on the same adapters, objects replayed from the retained manifests (no shader
+// compiles, no file reads). False if an adapter went away or a replay failed.
+static bool ReplayGpuDevices() {
+    IDXGIFactory1* factory = nullptr;
+    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&factory)))) return false;
+    std::vector<AdapterTopology> topology;
+    std::vector<IDXGIAdapter1*> adapters;
+    std::vector<std::wstring> names;
+    EnumerateAdapters(factory, topology, adapters, names);
+    factory->Release();
+
+    bool ok = true;
+    for (auto& gpu : g_gpuDevices) {
+        IDXGIAdapter1* adapter = nullptr;
+        for (size_t a = 0; a < topology.size(); a++) {
+            if (topology[a].id == gpu->adapterId) adapter = adapters[a];
+        }
+        if (!adapter) {
+            std::wcerr << L"Adapter " << gpu->adapterName << L" is gone, regrouping" << std::endl;
+            ok = false;
+            break;
+        }
+        if (!CreateGpuDevice(gpu.get(), adapter) || !ReplayDeviceManifest(gpu.get())) {
+            ok = false;
+            break;
+        }
+    }
+
+    for (auto* adapter : adapters) {
+        adapter->Release();
+    }
+    return ok;
 }
 
 bool AttemptDeviceRecovery() {
     std::cout << "Attempting GPU device recovery..." << std::endl;
 
-    // Release all D3D resources
+    // Release all D3D objects; the manifests and the DirectComposition device (not tied to a
+    // D3D device) are kept
     for (auto& ctx : g_monitors) {
-        ReleaseMonitorD3DResources(&ctx);
+        ReleaseMonitorD3DResources(ctx.get());
+    }
+    for (auto& gpu : g_gpuDevices) {
+        ReleaseGpuObjects(gpu.get());
     }
-    ReleaseSharedD3DResources();
 
     // Wait for driver to stabilize after TDR
     std::cout << "Waiting for driver to stabilize..." << std::endl;
     Sleep(2000);
 
-    // Reinit D3D
-    if (!InitD3D()) {
-        std::cerr << "Failed to reinit D3D after TDR" << std::endl;
-        return false;
+    auto start = std::chrono::steady_clock::now();
+    if (!ReplayGpuDevices()) {
+        // Regroup from scratch (a TDR can coincide with adapter changes); shaders still come
+        // from the bytecode cache, LUTs from the old pools' retained copies below
+        g_orphanedLUTs.clear();
+        for (auto& gpu : g_gpuDevices) {
+            for (const auto& entry : gpu->lutPool) {
+                if (!entry.retained) continue;
+                PooledLUT orphan;
+                orphan.key = entry.key;
+                orphan.lutSize = entry.lutSize;
+                orphan.retained = entry.retained;
+                g_orphanedLUTs.push_back(std::move(orphan));
+            }
+            ReleaseGpuDevice(gpu.get());
+        }
+        g_gpuDevices.clear();
+        std::vector<HMONITOR> monitors;
+        for (const auto& ctx : g_monitors) {
+            if (!ctx->cold->detached) monitors.push_back(ctx->cold->monitor);
+        }
+        if (!InitD3D(monitors)) {
+            std::cerr << "Failed to reinit D3D after TDR" << std::endl;
+            return false;
+        }
+    }
+    for (auto& ctx : g_monitors) {
+        ctx->gpu = ctx->cold->detached ? nullptr : FindGpuDevice(ctx->cold->monitor);
     }
     std::cout << "D3D reinitialized" << std::endl;
 
     // Check tearing support again
     g_tearingSupported = CheckTearingSupport();
 
-    // Reinit each monitor
+    // Reinit each monitor (parked ones are re-attached by the topology reconciler)
     for (auto& ctx : g_monitors) {
-        // Reload LUT data from stored paths
-        std::vector<float> lutDataSDR, lutDataHDR;
-        int lutSizeSDR = 0, lutSizeHDR = 0;
-
-        if (!LoadLUT(ctx.sdrLutPath, lutDataSDR, lutSizeSDR)) {
-            std::cerr << "Failed to reload SDR LUT for monitor " << ctx.index << std::endl;
+        if (ctx->cold->detached) continue;
+        if (!ctx->gpu) {
+            std::cerr << "No device group for monitor " << ctx->index << " after TDR" << std::endl;
             return false;
         }
 
-        if (!ctx.hdrLutPath.empty()) {
-            LoadLUT(ctx.hdrLutPath, lutDataHDR, lutSizeHDR);
-        }
-
         // Recreate swapchain (window already exists)
-        if (!CreateSwapChain(&ctx)) {
-            std::cerr << "Failed to recreate swapchain for monitor " << ctx.index << std::endl;
+        if (!CreateSwapChain(ctx.get())) {
+            std::cerr << "Failed to recreate swapchain for monitor " << ctx->index << std::endl;
             return false;
         }
 
         // Reinit DirectComposition
-        if (!InitDirectComposition(&ctx)) {
-            std::cerr << "Failed to reinit DirectComposition for monitor " << ctx.index << std::endl;
+        if (!InitDirectComposition(ctx.get())) {
+            std::cerr << "Failed to reinit DirectComposition for monitor " << ctx->index << std::endl;
             return false;
         }
 
-        // Recreate LUT textures
-        if (!CreateLUTTexture(lutDataSDR, lutSizeSDR, &ctx.lutTextureSDR, &ctx.lutSRV_SDR)) {
-            std::cerr << "Failed to recreate SDR LUT texture for monitor " << ctx.index << std::endl;
-            return false;
-        }
-        ctx.lutSizeSDR = lutSizeSDR;
-
-        if (!lutDataHDR.empty()) {
-            if (!CreateLUTTexture(lutDataHDR, lutSizeHDR, &ctx.lutTextureHDR, &ctx.lutSRV_HDR)) {
-                std::cerr << "Failed to recreate HDR LUT texture for monitor " << ctx.index << std::endl;
+        // LUT textures come back from the replayed pool, or a regrouped device's retained copies
+        struct { const std::wstring& path; bool isHDR; ID3D11Texture3D** texture; ID3D11ShaderResourceView** srv; int* size; const char* name; } luts[] = {
+            { ctx->cold->sdrLutPath, false, &ctx->cold->lutTextureSDR, &ctx->lutSRV_SDR, &ctx->lutSizeSDR, "SDR" },
+            { ctx->cold->hdrLutPath, true, &ctx->cold->lutTextureHDR, &ctx->lutSRV_HDR, &ctx->lutSizeHDR, "HDR" },
+        };
+        for (auto& lut : luts) {
+            if (lut.path.empty()) continue;
+            if (!LoadLUTTexture(ctx->gpu, lut.path, lut.isHDR, *lut.size, lut.texture, lut.srv)) {
+                std::cerr << "Failed to recreate " << lut.name << " LUT texture for monitor " << ctx->index << std::endl;
                 return false;
             }
-            ctx.lutSizeHDR = lutSizeHDR;
         }
 
         // Reinit desktop duplication
-        if (!InitDesktopDuplication(&ctx)) {
-            std::cerr << "Failed to reinit desktop duplication for monitor " << ctx.index << std::endl;
+        if (!InitDesktopDuplication(ctx.get())) {
+            std::cerr << "Failed to reinit desktop duplication for monitor " << ctx->index << std::endl;
             return false;
         }
 
-        ctx.enabled = true;
-        ctx.consecutiveFailures = 0;
-        std::cout << "Monitor " << ctx.index << " recovered" << std::endl;
+        ctx->enabled = true;
+        ctx->consecutiveFailures = 0;
+        std::cout << "Monitor " << ctx->index << " recovered" << std::endl;
     }
 
+    g_orphanedLUTs.clear();
+    double rebuildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    MetricObserve(g_metrics.recoveryMs, rebuildMs);
+
     // Reapply MaxTML settings (may be lost after TDR/driver recovery)
     ApplyMaxTmlSettings();
 
-    std::cout << "GPU device recovery successful" << std::endl;
+    // Streamed LUTs lived in the old device's textures
+    RequeueLiveLutUploads();
+
+    std::cout << "GPU device recovery successful (rebuilt in " << (int)rebuildMs << " ms)" << std::endl;
     return true;
 }
@@ -5,16 +5,37 @@
 
 #include "types.h"
 
-// Initialize D3D11 device, context, shaders, and resources
-bool InitD3D();
+// Create one device group per adapter that owns one of the given monitors
+// (device, context, shaders, samplers, blue noise) and append them to g_gpuDevices
+bool InitD3D(const std::vector<HMONITOR>& monitors);
+
+// Device group that drives a monitor (nullptr if the monitor wasn't passed to InitD3D)
+GpuDevice* FindGpuDevice(HMONITOR monitor);
+
+// Add a monitor that appeared after InitD3D to the device group of the adapter that owns its
+// output (nullptr if that adapter has no device group); ReleaseGpuMonitor drops it again
+GpuDevice* AssignGpuDevice(HMONITOR monitor);
+void ReleaseGpuMonitor(HMONITOR monitor);
+
+// Get the LUT texture for a file from the device's pool. On first use it is created from another
+// device group's copy, composed from a LUT stack (LoadLUTStack in lut.h), or streamed from the
+// file (parsed, converted to FP16 and uploaded slice by slice). isHDR = the monitor's HDR LUT
+// (stack accuracy is reported in Delta E ITP instead of CIEDE2000). Returned texture/SRV carry
+// their own reference (released with the monitor).
+bool LoadLUTTexture(GpuDevice* gpu, const std::wstring& path, bool isHDR, int& lutSize,
+                    ID3D11Texture3D** outTexture, ID3D11ShaderResourceView** outSRV);
 
 // Check if tearing (immediate present) is supported
 bool CheckTearingSupport();
 
+// Monitor's readback manager, with staging copies and non-blocking maps on its device group's
+// immediate context (installed on first call). Render thread only.
+ReadbackManager& MonitorReadbacks(MonitorContext* ctx);
+
 // Release D3D resources for a specific monitor
 void ReleaseMonitorD3DResources(MonitorContext* ctx);
 
-// Release all shared D3D resources
+// Release all device groups and the shared DirectComposition device
 void ReleaseSharedD3DResources();
 
 // Attempt to recover from GPU device loss (TDR)
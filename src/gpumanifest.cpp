@@ -0,0 +1,177 @@
+// DesktopLUT - gpumanifest.cpp
+// GPU resource manifest: what each device-level object is created from (descriptor, retained
+// CPU-side source data, dependencies), and the wave-parallel replay that builds the objects from it
+// at startup and again after device loss (no Windows dependencies)
+
+#include "gpumanifest.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+
+int AddManifestEntry(ResourceManifest& manifest, ManifestEntry entry) {
+    manifest.entries.push_back(std::move(entry));
+    return (int)manifest.entries.size() - 1;
+}
+
+int FindManifestEntry(const ResourceManifest& manifest, const std::string& name) {
+    for (size_t i = 0; i < manifest.entries.size(); i++) {
+        if (manifest.entries[i].name == name) return (int)i;
+    }
+    return -1;
+}
+
+bool PlanManifestWaves(const ResourceManifest& manifest, std::vector<std::vector<int>>& waves,
+                       std::vector<int>& unplaced) {
+    waves.clear();
+    unplaced.clear();
+    size_t count = manifest.entries.size();
+    std::vector<int> level(count, -1);
+
+    // A dependency that can never be created: the entry is never ready
+    std::vector<uint8_t> broken(count, 0);
+    for (size_t i = 0; i < count; i++) {
+        for (int dep : manifest.entries[i].deps) {
+            if (dep < 0 || dep >= (int)count || dep == (int)i) broken[i] = 1;
+        }
+    }
+
+    // Kahn's algorithm by levels: an entry lands one wave after its latest dependency. Stops when
+    // a scan places nothing; what is left waits on a cycle or a broken entry.
+    for (int wave = 0;; wave++) {
+        // Levels are assigned after the scan, so entries placed this wave don't unlock others yet
+        std::vector<int> current;
+        for (size_t i = 0; i < count; i++) {
+            if (level[i] >= 0 || broken[i]) continue;
+            bool ready = true;
+            for (int dep : manifest.entries[i].deps) {
+                if (level[dep] < 0) {
+                    ready = false;
+                    break;
+                }
+            }
+            if (ready) current.push_back((int)i);
+        }
+        if (current.empty()) break;
+        for (int i : current) level[i] = wave;
+        waves.push_back(std::move(current));
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (level[i] < 0) unplaced.push_back((int)i);
+    }
+    return unplaced.empty();
+}
+
+// Release created entries whose group has a failed member or whose dependency is gone, and skip
+// pending members of failed groups, until nothing changes
+static void DropBrokenEntries(const ResourceManifest& manifest, std::vector<ManifestStatus>& status,
+                              const std::function<void(int)>& release) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        std::unordered_set<int> brokenGroups;
+        for (size_t i = 0; i < status.size(); i++) {
+            int group = manifest.entries[i].group;
+            if (group >= 0 && (status[i] == MANIFEST_FAILED || status[i] == MANIFEST_SKIPPED)) brokenGroups.insert(group);
+        }
+
+        for (size_t i = 0; i < status.size(); i++) {
+            const ManifestEntry& entry = manifest.entries[i];
+            bool groupBroken = entry.group >= 0 && brokenGroups.count(entry.group);
+            if (status[i] == MANIFEST_PENDING && groupBroken) {
+                status[i] = MANIFEST_SKIPPED;
+                changed = true;
+            } else if (status[i] == MANIFEST_CREATED) {
+                bool drop = groupBroken;
+                for (int dep : entry.deps) {
+                    if (status[dep] != MANIFEST_CREATED) drop = true;
+                }
+                if (drop) {
+                    release((int)i);
+                    status[i] = MANIFEST_SKIPPED;
+                    changed = true;
+                }
+            }
+        }
+    }
+}
+
+ManifestReplayResult ReplayManifest(const ResourceManifest& manifest, const std::vector<std::vector<int>>& waves,
+                                    const std::function<bool(int)>& create,
+                                    const std::function<void(int)>& release, int threads) {
+    ManifestReplayResult result;
+    result.status.assign(manifest.entries.size(), MANIFEST_PENDING);
+    std::vector<ManifestStatus>& status = result.status;
+
+    // Entries the plan couldn't place never run
+    std::vector<uint8_t> planned(manifest.entries.size(), 0);
+    for (const auto& wave : waves) {
+        for (int i : wave) planned[i] = 1;
+    }
+    for (size_t i = 0; i < status.size(); i++) {
+        if (!planned[i]) status[i] = MANIFEST_SKIPPED;
+    }
+    DropBrokenEntries(manifest, status, release);   // Their group members go too
+    bool stop = false;
+    for (size_t i = 0; i < status.size(); i++) {
+        if (manifest.entries[i].required && status[i] == MANIFEST_SKIPPED) stop = true;
+    }
+
+    for (const auto& wave : waves) {
+        if (stop) break;
+
+        std::vector<int> runnable;
+        for (int i : wave) {
+            if (status[i] != MANIFEST_PENDING) continue;  // Skipped with its group
+            bool depsReady = true;
+            for (int dep : manifest.entries[i].deps) {
+                if (status[dep] != MANIFEST_CREATED) depsReady = false;
+            }
+            if (depsReady) {
+                runnable.push_back(i);
+            } else {
+                status[i] = MANIFEST_SKIPPED;
+            }
+        }
+
+        // Workers pull entries in manifest order; results land in per-entry slots
+        std::vector<uint8_t> succeeded(runnable.size(), 0);
+        std::atomic<size_t> next{ 0 };
+        auto work = [&]() {
+            for (size_t k = next.fetch_add(1); k < runnable.size(); k = next.fetch_add(1)) {
+                succeeded[k] = create(runnable[k]) ? 1 : 0;
+            }
+        };
+        size_t workerCount = (std::min)((size_t)(std::max)(threads, 1), runnable.size());
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < workerCount; t++) {
+            workers.emplace_back(work);
+        }
+        work();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        for (size_t k = 0; k < runnable.size(); k++) {
+            status[runnable[k]] = succeeded[k] ? MANIFEST_CREATED : MANIFEST_FAILED;
+        }
+
+        DropBrokenEntries(manifest, status, release);
+
+        for (size_t i = 0; i < status.size(); i++) {
+            if (manifest.entries[i].required && (status[i] == MANIFEST_FAILED || status[i] == MANIFEST_SKIPPED)) {
+                stop = true;
+            }
+        }
+    }
+
+    result.ok = true;
+    for (size_t i = 0; i < status.size(); i++) {
+        if (stop && status[i] == MANIFEST_PENDING) status[i] = MANIFEST_SKIPPED;
+        if (status[i] == MANIFEST_CREATED) result.created++;
+        if (status[i] == MANIFEST_FAILED) result.failed++;
+        if (status[i] == MANIFEST_SKIPPED) result.skipped++;
+        if (manifest.entries[i].required && status[i] != MANIFEST_CREATED) result.ok = false;
+    }
+    return result;
+}
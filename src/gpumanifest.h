@@ -0,0 +1,91 @@
+// DesktopLUT - gpumanifest.h
+// GPU resource manifest: what each device-level object is created from (descriptor, retained
+// CPU-side source data, dependencies), and the wave-parallel replay that builds the objects from it
+// at startup and again after device loss (no Windows dependencies)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Retained source data (shader bytecode, small textures). Shared: device groups and replays
+// after device loss reuse the same bytes instead of recompiling.
+typedef std::shared_ptr<const std::vector<uint8_t>> ManifestBlob;
+
+enum ManifestKind : uint8_t {
+    MANIFEST_VERTEX_SHADER,
+    MANIFEST_PIXEL_SHADER,
+    MANIFEST_COMPUTE_SHADER,
+    MANIFEST_BUFFER,
+    MANIFEST_SAMPLER,
+    MANIFEST_TEXTURE2D,
+    MANIFEST_TEXTURE3D,
+    MANIFEST_SRV,           // View of its first dependency
+};
+
+struct ManifestEntry {
+    std::string name;
+    ManifestKind kind = MANIFEST_BUFFER;
+    std::vector<uint8_t> desc;       // Creation descriptor, opaque here (D3D11_*_DESC for the replayer)
+    ManifestBlob source;             // Bytecode or initial data (null = none)
+    std::function<ManifestBlob()> load;  // Produces the initial data at each creation instead (LUTs
+                                         // expand their retained RGB copy, not kept as RGBA)
+    uint32_t rowPitch = 0;           // Initial data pitches (textures)
+    uint32_t slicePitch = 0;
+    std::vector<int> deps;           // Entries that must be created first
+    int group = -1;                  // All-or-nothing set (a shader and its constant buffer), -1 = none
+    bool required = true;            // A failure fails the replay; optional entries just drop out
+    void** slot = nullptr;           // Where the created object is stored (must stay at a fixed address)
+};
+
+struct ResourceManifest {
+    std::vector<ManifestEntry> entries;
+};
+
+// Append an entry, returns its index
+int AddManifestEntry(ResourceManifest& manifest, ManifestEntry entry);
+
+// Index of the entry with this name, -1 if none
+int FindManifestEntry(const ResourceManifest& manifest, const std::string& name);
+
+// Copy a descriptor struct into an entry
+template <typename T>
+void SetManifestDesc(ManifestEntry& entry, const T& desc) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&desc);
+    entry.desc.assign(bytes, bytes + sizeof(T));
+}
+
+// Dependency levels: every entry in waves[k] depends only on entries in earlier waves (so a wave
+// can be created in parallel); manifest order is kept within a wave. Entries with a dependency
+// that is out of range or on a cycle (directly or through another entry) are left out of every
+// wave and listed in unplaced; false if there are any. ReplayManifest skips them.
+bool PlanManifestWaves(const ResourceManifest& manifest, std::vector<std::vector<int>>& waves,
+                       std::vector<int>& unplaced);
+
+enum ManifestStatus : uint8_t {
+    MANIFEST_PENDING,
+    MANIFEST_CREATED,
+    MANIFEST_FAILED,        // create() returned false
+    MANIFEST_SKIPPED,       // A dependency or group member failed (created group members are released)
+};
+
+struct ManifestReplayResult {
+    std::vector<ManifestStatus> status;   // Per entry
+    bool ok = false;                      // Every required entry was created
+    int created = 0;
+    int failed = 0;
+    int skipped = 0;
+};
+
+// Create every entry, wave by wave, running the entries of a wave on up to `threads` threads.
+// Entries in no wave are skipped (with their groups) before the first wave runs.
+// create(i) builds entry i and stores it in its slot; release(i) undoes a created entry that has
+// to go because its group or a dependency failed. Stops after the wave where a required entry
+// failed (the caller releases what was created).
+ManifestReplayResult ReplayManifest(const ResourceManifest& manifest, const std::vector<std::vector<int>>& waves,
+                                    const std::function<bool(int)>& create,
+                                    const std::function<void(int)>& release, int threads);
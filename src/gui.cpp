@@ -8,6 +8,8 @@
 #include "color.h"
 #include "osd.h"
 #include "displayconfig.h"
+#include "metricsserver.h"
+#include "lutstack.h"
 #include "../resource.h"
 #include <commctrl.h>
 #include <commdlg.h>
@@ -180,16 +182,20 @@ static void SetNumericEdit(HWND hwnd, int maxDecimals) {
     SetWindowSubclass(hwnd, NumericEditSubclassProc, 0, (DWORD_PTR)maxDecimals);
 }
 
-// Helper to set path text - shows just the filename for readability
+// Helper to set path text - shows just the filename for readability (each member of a LUT stack)
 static void SetPathText(HWND hwndEdit, const wchar_t* path) {
     if (!path || !*path) {
         SetWindowText(hwndEdit, L"");
         return;
     }
-    // Extract just the filename
-    const wchar_t* filename = wcsrchr(path, L'\\');
-    if (!filename) filename = wcsrchr(path, L'/');
-    SetWindowText(hwndEdit, filename ? filename + 1 : path);
+    std::wstring text;
+    for (const std::wstring& member : SplitLUTStack(path)) {
+        // Extract just the filename
+        size_t slash = member.find_last_of(L"\\/");
+        if (!text.empty()) text += L" + ";
+        text += slash == std::wstring::npos ? member : member.substr(slash + 1);
+    }
+    SetWindowText(hwndEdit, text.c_str());
 }
 
 // Draw a Windows 11-style rounded button
@@ -430,43 +436,12 @@ void UpdateColorCorrectionControls() {
     SendMessage(g_gui.hwndHdrMaxTmlCombo, CB_SETCURSEL, comboSel, 0);
 }
 
-// Helper to recalculate primaries matrix and apply live update
+// Helper to apply a primaries change live (matrix is computed by the correction compiler)
 void ApplyPrimariesChange(bool isHDR) {
     if (g_gui.currentMonitor < 0 || g_gui.currentMonitor >= (int)g_gui.monitorSettings.size()) {
         return;
     }
 
-    auto& cc = isHDR ? g_gui.monitorSettings[g_gui.currentMonitor].hdrColorCorrection
-                     : g_gui.monitorSettings[g_gui.currentMonitor].sdrColorCorrection;
-
-    // Calculate matrix from current primaries (display to sRGB)
-    DisplayPrimariesData displayPrimaries;
-    if (cc.primariesPreset == g_numPresetPrimaries - 1) {
-        // Custom - use custom primaries
-        displayPrimaries.Rx = cc.customPrimaries.Rx;
-        displayPrimaries.Ry = cc.customPrimaries.Ry;
-        displayPrimaries.Gx = cc.customPrimaries.Gx;
-        displayPrimaries.Gy = cc.customPrimaries.Gy;
-        displayPrimaries.Bx = cc.customPrimaries.Bx;
-        displayPrimaries.By = cc.customPrimaries.By;
-        displayPrimaries.Wx = cc.customPrimaries.Wx;
-        displayPrimaries.Wy = cc.customPrimaries.Wy;
-    } else {
-        // Use preset
-        const auto& preset = g_presetPrimaries[cc.primariesPreset];
-        displayPrimaries.Rx = preset.Rx; displayPrimaries.Ry = preset.Ry;
-        displayPrimaries.Gx = preset.Gx; displayPrimaries.Gy = preset.Gy;
-        displayPrimaries.Bx = preset.Bx; displayPrimaries.By = preset.By;
-        displayPrimaries.Wx = preset.Wx; displayPrimaries.Wy = preset.Wy;
-    }
-
-    // sRGB primaries (target for content)
-    DisplayPrimariesData srgb = {
-        0.6400f, 0.3300f, 0.3000f, 0.6000f, 0.1500f, 0.0600f, 0.3127f, 0.3290f
-    };
-
-    CalculatePrimariesMatrix(srgb, displayPrimaries, cc.primariesMatrix);
-
     // Apply live update if running
     if (g_gui.isRunning) {
         UpdateColorCorrectionLive(g_gui.currentMonitor, isHDR);
@@ -1559,6 +1534,14 @@ LRESULT CALLBACK GUIWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
         SendMessage(g_gui.hwndTetrahedralCheck, BM_SETCHECK, g_tetrahedralInterp ? BST_CHECKED : BST_UNCHECKED, 0);
         innerY += h + pad;
 
+        // Tiled compute main pass checkbox (switchable while running for A/B timing)
+        g_gui.hwndTiledPassCheck = CreateWindow(L"BUTTON", L"Tiled compute main pass",
+            WS_CHILD | WS_VISIBLE | BS_AUTOCHECKBOX,
+            innerX + labelW + pad, innerY, 250, h, panel0, (HMENU)ID_TILED_PASS_CHECK, nullptr, nullptr);
+        g_gui.tab0Controls.push_back(g_gui.hwndTiledPassCheck);
+        SendMessage(g_gui.hwndTiledPassCheck, BM_SETCHECK, g_tiledMainPass ? BST_CHECKED : BST_UNCHECKED, 0);
+        innerY += h + pad;
+
         // Gamma checkbox and whitelist button
         g_gui.hwndGammaCheck = CreateWindow(L"BUTTON", L"Desktop gamma (2.2) - HDR only",
             WS_CHILD | WS_VISIBLE | BS_AUTOCHECKBOX,
@@ -2097,6 +2080,16 @@ LRESULT CALLBACK GUIWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             g_gui.monitorSettings.push_back({});  // Empty settings for each monitor
         }
 
+        // Resolve display identities so per-monitor settings follow the display, not its index
+        std::wstring displayDbPath = GetDisplayDbPath();
+        if (!LoadDisplayDatabase(displayDbPath, g_gui.displayDb)) {
+            std::wcerr << L"Ignoring unreadable display database " << displayDbPath << std::endl;
+        }
+        RefreshDisplayIdentities(g_gui.monitors, g_gui.displayDb, g_gui.monitorEdidHashes);
+        if (g_gui.displayDb.dirty && !SaveDisplayDatabase(displayDbPath, g_gui.displayDb)) {
+            std::wcerr << L"Failed to write " << displayDbPath << std::endl;
+        }
+
         // Load saved settings from INI
         LoadSettings();
 
@@ -2105,6 +2098,8 @@ LRESULT CALLBACK GUIWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             g_desktopGammaMode ? BST_CHECKED : BST_UNCHECKED, 0);
         SendMessage(g_gui.hwndTetrahedralCheck, BM_SETCHECK,
             g_tetrahedralInterp ? BST_CHECKED : BST_UNCHECKED, 0);
+        SendMessage(g_gui.hwndTiledPassCheck, BM_SETCHECK,
+            g_tiledMainPass ? BST_CHECKED : BST_UNCHECKED, 0);
 
         // Update Settings tab checkboxes from loaded settings
         SendMessage(g_gui.hwndSettingsHotkeyGamma, BM_SETCHECK,
@@ -2236,6 +2231,11 @@ LRESULT CALLBACK GUIWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             g_tetrahedralInterp = (SendMessage(g_gui.hwndTetrahedralCheck, BM_GETCHECK, 0, 0) == BST_CHECKED);
             SaveSettings();
             return 0;
+        case ID_TILED_PASS_CHECK:
+            // Render loop picks this up on the next frame (recreating swapchains for UAV output once)
+            g_tiledMainPass = (SendMessage(g_gui.hwndTiledPassCheck, BM_GETCHECK, 0, 0) == BST_CHECKED);
+            SaveSettings();
+            return 0;
 
         // SDR Color Correction Controls
         case ID_SDR_PRIMARIES_ENABLE:
@@ -3030,6 +3030,11 @@ int RunGUI() {
         StartProcessing();
     }
 
+    // Metrics endpoint runs for the app lifetime (counters survive processing restarts)
+    if (g_metricsPort.load() > 0) {
+        StartMetricsServer(g_metricsPort.load(), g_metrics);
+    }
+
     // Only start minimized if user explicitly enabled the setting
     if (!g_startMinimized.load()) {
         ShowWindow(g_gui.hwndMain, SW_SHOW);
@@ -3046,5 +3051,6 @@ int RunGUI() {
         DispatchMessage(&msg);
     }
 
+    StopMetricsServer();
     return (int)msg.wParam;
 }
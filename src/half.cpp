@@ -0,0 +1,35 @@
+// DesktopLUT - half.cpp
+// Float to IEEE half conversion shared by every FP16 upload (no Windows dependencies)
+
+#include "half.h"
+
+#include <cstring>
+
+uint16_t FloatToHalf(float f) {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    uint32_t sign = (bits & 0x80000000u) >> 16;
+    bits &= 0x7FFFFFFFu;
+
+    uint32_t result;
+    if (bits >= 0x47800000u) {
+        // Too large for a half: infinity (NaN stays NaN)
+        bool nan = (bits & 0x7F800000u) == 0x7F800000u && (bits & 0x7FFFFFu) != 0;
+        result = nan ? 0x7FFFu : 0x7C00u;
+    } else if (bits < 0x33000000u) {
+        result = 0;  // At most half the smallest denormal
+    } else {
+        if (bits < 0x38800000u) {
+            // Denormal half: shift the mantissa with its implicit 1 into place, keeping a sticky
+            // bit for what falls off so ties still round correctly
+            uint32_t shift = 113u - (bits >> 23);
+            uint32_t mantissa = 0x800000u | (bits & 0x7FFFFFu);
+            bits = (mantissa >> shift) | ((mantissa & ((1u << shift) - 1)) != 0 ? 1u : 0u);
+        } else {
+            bits += 0xC8000000u;  // Rebias the exponent
+        }
+        // Round to nearest even on the 13 dropped bits (a carry can reach infinity)
+        result = (bits + 0x0FFFu + ((bits >> 13) & 1u)) >> 13;
+    }
+    return (uint16_t)(result | sign);
+}
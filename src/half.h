@@ -0,0 +1,10 @@
+// DesktopLUT - half.h
+// Float to IEEE half conversion shared by every FP16 upload (no Windows dependencies)
+
+#pragma once
+
+#include <cstdint>
+
+// IEEE half, rounded to nearest even. Denormals are kept, overflow goes to infinity and NaN
+// stays a (quiet) NaN, so every FP16 texture the app uploads rounds the same way.
+uint16_t FloatToHalf(float f);
@@ -0,0 +1,116 @@
+// DesktopLUT - idle.cpp
+// Adaptive idle state machine and render-thread wakeup accounting
+
+#include "idle.h"
+#include <algorithm>
+
+using Clock = std::chrono::steady_clock;
+
+static long long ElapsedMs(Clock::time_point from, Clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+static void SetState(IdleTracker& t, IdleState state) {
+    if (t.state != state) {
+        t.state = state;
+        t.transitions++;
+    }
+}
+
+void IdleOnFrame(IdleTracker& t, Clock::time_point now) {
+    t.lastFrameTime = now;
+    SetState(t, IdleState::Active);
+}
+
+void IdleOnWakeup(IdleTracker& t, Clock::time_point now) {
+    t.totalWakeups++;
+    t.wakeupsInWindow++;
+
+    if (t.windowStart.time_since_epoch().count() == 0) {
+        t.windowStart = now;       // This wakeup opens the window, like the one that closes each window
+        t.wakeupsInWindow = 0;
+        return;
+    }
+
+    long long windowMs = ElapsedMs(t.windowStart, now);
+    if (windowMs >= IDLE_WAKEUP_WINDOW_MS) {
+        t.wakeupsPerSecond = t.wakeupsInWindow * 1000.0f / (float)windowMs;
+        t.wakeupsInWindow = 0;
+        t.windowStart = now;
+    }
+}
+
+IdleState IdleUpdate(IdleTracker& t, Clock::time_point now, bool enabled) {
+    // First pass: start the idle clock now rather than at epoch
+    if (t.lastFrameTime.time_since_epoch().count() == 0) {
+        t.lastFrameTime = now;
+    }
+
+    if (!enabled) {
+        SetState(t, IdleState::Active);
+        return t.state;
+    }
+
+    long long sinceFrameMs = ElapsedMs(t.lastFrameTime, now);
+    if (sinceFrameMs >= DEEP_IDLE_ENTER_MS) {
+        SetState(t, IdleState::DeepIdle);
+    } else if (sinceFrameMs >= IDLE_ENTER_MS) {
+        SetState(t, IdleState::Idle);
+    } else {
+        SetState(t, IdleState::Active);
+    }
+    return t.state;
+}
+
+int IdleAcquireTimeoutMs(IdleState state, int frameTimeMs, int monitorCount) {
+    // Monitors are serviced sequentially, so split the budget to bound hotkey/message latency
+    int monitors = (std::max)(monitorCount, 1);
+    switch (state) {
+    case IdleState::Idle:
+        return (std::max)(frameTimeMs, IDLE_ACQUIRE_BUDGET_MS / monitors);
+    case IdleState::DeepIdle:
+        return (std::max)(frameTimeMs, DEEP_IDLE_ACQUIRE_BUDGET_MS / monitors);
+    default:
+        return frameTimeMs;
+    }
+}
+
+bool IdleUseCompositorWait(IdleState state) {
+    return state == IdleState::Active;
+}
+
+int IdleTopmostIntervalMs(IdleState state) {
+    // Another window taking TOPMOST changes the desktop, which snaps us back to Active
+    switch (state) {
+    case IdleState::Idle:     return 4000;
+    case IdleState::DeepIdle: return 8000;
+    default:                  return 2000;
+    }
+}
+
+int IdleHealthCheckIntervalMs(IdleState state) {
+    // Device loss also surfaces as AcquireNextFrame failure, so slower polling is safe
+    switch (state) {
+    case IdleState::Idle:     return 2000;
+    case IdleState::DeepIdle: return 4000;
+    default:                  return 1000;
+    }
+}
+
+bool IdleHealthCheckDue(Clock::time_point& lastCheck, Clock::time_point now, IdleState state) {
+    if (ElapsedMs(lastCheck, now) < IdleHealthCheckIntervalMs(state)) return false;
+    lastCheck = now;
+    return true;
+}
+
+bool WatchdogExpired(Clock::time_point lastProgress, Clock::time_point now, int timeoutMs) {
+    return ElapsedMs(lastProgress, now) > timeoutMs;
+}
+
+const wchar_t* IdleStateName(IdleState state) {
+    switch (state) {
+    case IdleState::Idle:     return L"Idle";
+    case IdleState::DeepIdle: return L"Deep";
+    default:                  return L"Active";
+    }
+}
@@ -0,0 +1,70 @@
+// DesktopLUT - idle.h
+// Adaptive idle state machine and render-thread wakeup accounting
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Idle tiers - the render loop lengthens waits as the desktop stays static
+enum class IdleState {
+    Active = 0,     // New frames arriving: compositor-paced, per-refresh acquire timeout
+    Idle = 1,       // No new frame for IDLE_ENTER_MS: skip compositor wait, longer acquire timeout
+    DeepIdle = 2    // No new frame for DEEP_IDLE_ENTER_MS: longest waits, slowest housekeeping
+};
+
+// Tier thresholds (time since last acquired frame)
+constexpr int IDLE_ENTER_MS = 2000;
+constexpr int DEEP_IDLE_ENTER_MS = 10000;
+
+// Total AcquireNextFrame wait budget per render loop pass (split across monitors)
+constexpr int IDLE_ACQUIRE_BUDGET_MS = 50;
+constexpr int DEEP_IDLE_ACQUIRE_BUDGET_MS = 100;
+
+// Wakeup rate is recomputed once per window
+constexpr int IDLE_WAKEUP_WINDOW_MS = 1000;
+
+// Render-thread idle tracker (not thread-safe - owned by the render thread)
+struct IdleTracker {
+    IdleState state = IdleState::Active;
+    std::chrono::steady_clock::time_point lastFrameTime{};    // Last frame acquired on any monitor
+    std::chrono::steady_clock::time_point windowStart{};      // Start of current wakeup window
+    uint32_t wakeupsInWindow = 0;
+    float wakeupsPerSecond = 0.0f;                            // Rate over last complete window
+    uint64_t totalWakeups = 0;
+    uint32_t transitions = 0;                                 // State changes since start (debug)
+};
+
+// A new desktop frame was acquired - snap back to Active immediately
+void IdleOnFrame(IdleTracker& t, std::chrono::steady_clock::time_point now);
+
+// The render thread returned from a blocking wait (compositor clock, DwmFlush, acquire timeout)
+void IdleOnWakeup(IdleTracker& t, std::chrono::steady_clock::time_point now);
+
+// Re-evaluate tier from time since last frame (call once per render loop pass)
+// When disabled, the tracker stays Active but still counts wakeups
+IdleState IdleUpdate(IdleTracker& t, std::chrono::steady_clock::time_point now, bool enabled);
+
+// AcquireNextFrame timeout for the current tier (never shorter than one refresh)
+int IdleAcquireTimeoutMs(IdleState state, int frameTimeMs, int monitorCount);
+
+// Whether to pace on the compositor clock / DwmFlush before waiting for a frame
+// Idle tiers skip it: the blocking acquire alone wakes us when the desktop changes
+bool IdleUseCompositorWait(IdleState state);
+
+// Housekeeping cadences in RenderAll
+int IdleTopmostIntervalMs(IdleState state);
+int IdleHealthCheckIntervalMs(IdleState state);
+
+// Health check cadence: true (and lastCheck moved to now) once the tier's interval has passed
+bool IdleHealthCheckDue(std::chrono::steady_clock::time_point& lastCheck, std::chrono::steady_clock::time_point now,
+                        IdleState state);
+
+// Render watchdog verdict at a health check: nothing has shown progress for longer than timeoutMs.
+// Progress is a successful present, and also an AcquireNextFrame timeout (the duplication is alive,
+// the desktop just hasn't changed), so a static desktop in any idle tier never trips it.
+bool WatchdogExpired(std::chrono::steady_clock::time_point lastProgress, std::chrono::steady_clock::time_point now,
+                     int timeoutMs);
+
+// Short display name for analysis overlay
+const wchar_t* IdleStateName(IdleState state);
@@ -0,0 +1,314 @@
+// DesktopLUT - livelut.cpp
+// Live LUT streaming: named pipe server and render-thread application of streamed updates
+
+#include "livelut.h"
+#include "globals.h"
+#include "half.h"
+#include "lut.h"
+#include "lutstream.h"
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+// Pipe buffer sizes (a 65^3 full LUT is ~3.3MB and arrives in several reads)
+static const DWORD PIPE_BUFFER_SIZE = 64 * 1024;
+
+static std::thread g_liveLutThread;
+static std::atomic<bool> g_liveLutRunning{ false };
+static HANDLE g_liveLutStopEvent = nullptr;
+static std::vector<int> g_liveLutMonitors;      // Pipe thread only (set before start)
+
+static std::mutex g_liveLutMutex;               // Protects g_liveLutStore
+static LiveLutStore g_liveLutStore;
+static std::atomic<bool> g_liveLutPending{ false };
+
+// Render-thread copy of pending updates (taken under the lock, applied after releasing it)
+struct LiveLutApply {
+    int monitorIndex = 0;
+    bool isHDR = false;
+    bool hasLut = false;
+    LiveLutUpload lut;
+    bool hasMatrix = false;
+    float matrix[9] = {};
+    bool hasGrayscale = false;
+    int grayscalePointCount = 0;
+    float grayscalePoints[LUT_STREAM_MAX_GRAYSCALE_POINTS] = {};
+};
+static std::vector<LiveLutApply> g_liveLutApply;   // Render thread only, reused
+static std::vector<uint16_t> g_liveLutHalf;        // Render thread only, FP16 staging for box uploads
+
+// ============================================================================
+// Pipe Server
+// ============================================================================
+
+// Wait for an overlapped operation or the stop event; false if stopping or the operation failed
+static bool WaitOverlapped(HANDLE pipe, OVERLAPPED& ov, DWORD& transferred) {
+    HANDLE events[2] = { ov.hEvent, g_liveLutStopEvent };
+    DWORD wait = WaitForMultipleObjects(2, events, FALSE, INFINITE);
+    if (wait != WAIT_OBJECT_0) {
+        CancelIoEx(pipe, &ov);
+        GetOverlappedResult(pipe, &ov, &transferred, TRUE);
+        return false;
+    }
+    return GetOverlappedResult(pipe, &ov, &transferred, FALSE) != FALSE;
+}
+
+static bool WritePipe(HANDLE pipe, OVERLAPPED& ov, const std::vector<uint8_t>& data) {
+    DWORD written = 0;
+    if (!WriteFile(pipe, data.data(), (DWORD)data.size(), &written, &ov)) {
+        if (GetLastError() != ERROR_IO_PENDING) return false;
+        if (!WaitOverlapped(pipe, ov, written)) return false;
+    }
+    return written == data.size();
+}
+
+static LutStreamStatus HandleMessage(const LutStreamMessage& msg) {
+    bool known = false;
+    for (int index : g_liveLutMonitors) {
+        if (index == msg.monitorIndex) known = true;
+    }
+    if (!known) return LutStreamStatus::UnknownMonitor;
+
+    LutStreamStatus status;
+    {
+        std::lock_guard<std::mutex> lock(g_liveLutMutex);
+        status = LiveLutMerge(g_liveLutStore, msg);
+    }
+    if (status == LutStreamStatus::Ok) {
+        g_liveLutPending.store(true, std::memory_order_release);
+    }
+    return status;
+}
+
+// Serve one connected client until it disconnects, sends garbage, or we stop
+static void ServeClient(HANDLE pipe, OVERLAPPED& ov) {
+    LutStreamParser parser;
+    LutStreamMessage msg;
+    std::vector<uint8_t> readBuf(PIPE_BUFFER_SIZE);
+    std::vector<uint8_t> reply;
+
+    while (g_liveLutRunning.load()) {
+        DWORD bytesRead = 0;
+        if (!ReadFile(pipe, readBuf.data(), (DWORD)readBuf.size(), &bytesRead, &ov)) {
+            DWORD err = GetLastError();
+            if (err == ERROR_IO_PENDING) {
+                if (!WaitOverlapped(pipe, ov, bytesRead)) return;
+            } else if (err != ERROR_MORE_DATA) {
+                return;  // Client disconnected
+            }
+        }
+        if (bytesRead == 0) continue;
+
+        reply.clear();
+        if (!LutStreamServe(parser, readBuf.data(), bytesRead, HandleMessage, msg, reply)) {
+            WritePipe(pipe, ov, reply);
+            return;
+        }
+        if (!reply.empty() && !WritePipe(pipe, ov, reply)) return;
+    }
+}
+
+static void LiveLutThreadFunc() {
+    OVERLAPPED ov = {};
+    ov.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+
+    while (g_liveLutRunning.load()) {
+        // Default DACL: only the owner, SYSTEM and admins can write
+        HANDLE pipe = CreateNamedPipeW(LIVE_LUT_PIPE_NAME,
+            PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | FILE_FLAG_FIRST_PIPE_INSTANCE,
+            PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+            1, PIPE_BUFFER_SIZE, PIPE_BUFFER_SIZE, 0, nullptr);
+        if (pipe == INVALID_HANDLE_VALUE) {
+            std::cerr << "Live LUT: CreateNamedPipe failed (" << GetLastError() << ")" << std::endl;
+            break;
+        }
+
+        bool connected = ConnectNamedPipe(pipe, &ov) != FALSE;
+        if (!connected) {
+            DWORD err = GetLastError();
+            if (err == ERROR_PIPE_CONNECTED) {
+                connected = true;
+            } else if (err == ERROR_IO_PENDING) {
+                DWORD unused = 0;
+                connected = WaitOverlapped(pipe, ov, unused);
+            }
+        }
+
+        if (connected) {
+            std::cout << "Live LUT: client connected" << std::endl;
+            ServeClient(pipe, ov);
+            std::cout << "Live LUT: client disconnected" << std::endl;
+        }
+        DisconnectNamedPipe(pipe);
+        CloseHandle(pipe);
+    }
+
+    CloseHandle(ov.hEvent);
+}
+
+bool StartLiveLutServer(const std::vector<int>& monitorIndices) {
+    if (g_liveLutRunning.load()) return true;  // Already running
+
+    {
+        std::lock_guard<std::mutex> lock(g_liveLutMutex);
+        g_liveLutStore.targets.clear();
+    }
+    g_liveLutPending.store(false);
+    g_liveLutMonitors = monitorIndices;
+
+    g_liveLutStopEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!g_liveLutStopEvent) return false;
+
+    g_liveLutRunning.store(true);
+    g_liveLutThread = std::thread(LiveLutThreadFunc);
+    std::wcout << L"Live LUT: listening on " << LIVE_LUT_PIPE_NAME << std::endl;
+    return true;
+}
+
+void StopLiveLutServer() {
+    if (!g_liveLutRunning.load()) return;  // Not running
+
+    g_liveLutRunning.store(false);
+    SetEvent(g_liveLutStopEvent);
+    if (g_liveLutThread.joinable()) {
+        g_liveLutThread.join();
+    }
+    CloseHandle(g_liveLutStopEvent);
+    g_liveLutStopEvent = nullptr;
+}
+
+// ============================================================================
+// Render Thread
+// ============================================================================
+
+static MonitorContext* FindMonitor(int monitorIndex) {
+    for (auto& ctx : g_monitors) {
+        if (ctx->index == monitorIndex) return ctx.get();
+    }
+    return nullptr;
+}
+
+// Mark a target for a whole-volume upload on the next pass
+static void RequeueFullUpload(int monitorIndex, bool isHDR) {
+    std::lock_guard<std::mutex> lock(g_liveLutMutex);
+    for (auto& t : g_liveLutStore.targets) {
+        if (t.monitorIndex == monitorIndex && t.isHDR == isHDR && t.lutSize > 0) {
+            t.sizeChanged = true;
+            t.lutDirty = true;
+        }
+    }
+    g_liveLutPending.store(true, std::memory_order_release);
+}
+
+static void ApplyLutUpload(MonitorContext* ctx, bool isHDR, const LiveLutUpload& up) {
+    ID3D11Texture3D*& texture = isHDR ? ctx->cold->lutTextureHDR : ctx->cold->lutTextureSDR;
+    ID3D11ShaderResourceView*& srv = isHDR ? ctx->lutSRV_HDR : ctx->lutSRV_SDR;
+    int& lutSize = isHDR ? ctx->lutSizeHDR : ctx->lutSizeSDR;
+    bool& isMutable = isHDR ? ctx->cold->lutMutableHDR : ctx->cold->lutMutableSDR;
+
+    if (up.recreate) {
+        // Private DEFAULT-usage texture - the file LUT may be shared with other monitors via the pool
+        ID3D11Texture3D* newTexture = nullptr;
+        ID3D11ShaderResourceView* newSRV = nullptr;
+        if (!CreateLUTTexture(ctx->gpu->device, up.rgba, up.lutSize, &newTexture, &newSRV, true)) {
+            return;
+        }
+        if (srv) srv->Release();
+        if (texture) texture->Release();
+        texture = newTexture;
+        srv = newSRV;
+        lutSize = up.lutSize;
+        isMutable = true;
+        if (ctx->isHDREnabled == isHDR) {
+            ctx->usePassthrough = false;
+        }
+        std::cout << "Monitor " << ctx->index << " live " << (isHDR ? "HDR" : "SDR") << " LUT "
+                  << up.lutSize << "^3" << std::endl;
+        return;
+    }
+
+    if (!isMutable || !texture || lutSize != up.lutSize) {
+        // Texture was replaced under us (device recovery) - patching needs the whole volume again
+        RequeueFullUpload(ctx->index, isHDR);
+        return;
+    }
+
+    g_liveLutHalf.resize(up.rgba.size());
+    for (size_t i = 0; i < up.rgba.size(); i++) {
+        g_liveLutHalf[i] = FloatToHalf(up.rgba[i]);
+    }
+    UINT w = (UINT)(up.boxMax[0] - up.boxMin[0]);
+    UINT h = (UINT)(up.boxMax[1] - up.boxMin[1]);
+    D3D11_BOX box = { (UINT)up.boxMin[0], (UINT)up.boxMin[1], (UINT)up.boxMin[2],
+                      (UINT)up.boxMax[0], (UINT)up.boxMax[1], (UINT)up.boxMax[2] };
+    ctx->gpu->context->UpdateSubresource(texture, 0, &box, g_liveLutHalf.data(),
+        w * 4 * sizeof(uint16_t), w * h * 4 * sizeof(uint16_t));
+}
+
+void ApplyLiveLutUpdates() {
+    if (!g_liveLutPending.load(std::memory_order_acquire)) return;
+
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(g_liveLutMutex);
+        g_liveLutPending.store(false, std::memory_order_relaxed);
+        if (g_liveLutApply.size() < g_liveLutStore.targets.size()) {
+            g_liveLutApply.resize(g_liveLutStore.targets.size());
+        }
+        for (auto& t : g_liveLutStore.targets) {
+            LiveLutApply& a = g_liveLutApply[count++];
+            a.monitorIndex = t.monitorIndex;
+            a.isHDR = t.isHDR;
+            a.hasLut = LiveLutTakeUpload(t, a.lut);
+            a.hasMatrix = t.matrixDirty;
+            if (a.hasMatrix) std::copy(t.matrix, t.matrix + 9, a.matrix);
+            a.hasGrayscale = t.grayscaleDirty;
+            if (a.hasGrayscale) {
+                a.grayscalePointCount = t.grayscalePointCount;
+                std::copy(t.grayscalePoints, t.grayscalePoints + LUT_STREAM_MAX_GRAYSCALE_POINTS, a.grayscalePoints);
+            }
+            t.matrixDirty = false;
+            t.grayscaleDirty = false;
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const LiveLutApply& a = g_liveLutApply[i];
+        MonitorContext* ctx = FindMonitor(a.monitorIndex);
+        if (!ctx || !ctx->gpu) continue;
+
+        if (a.hasLut) {
+            ApplyLutUpload(ctx, a.isHDR, a.lut);
+        }
+
+        ColorCorrectionData& cc = a.isHDR ? ctx->hdrColorCorrection : ctx->sdrColorCorrection;
+        if (a.hasMatrix) {
+            std::copy(a.matrix, a.matrix + 9, cc.primariesMatrix);
+            cc.primariesEnabled = true;
+            // The gamut descriptor was built for the previous matrix
+            cc.gamutCompression = false;
+        }
+        if (a.hasGrayscale) {
+            cc.grayscale.pointCount = a.grayscalePointCount;
+            std::copy(a.grayscalePoints, a.grayscalePoints + a.grayscalePointCount, cc.grayscale.points);
+            cc.grayscale.enabled = true;
+        }
+    }
+}
+
+void RequeueLiveLutUploads() {
+    std::lock_guard<std::mutex> lock(g_liveLutMutex);
+    bool any = false;
+    for (auto& t : g_liveLutStore.targets) {
+        if (t.lutSize > 0) {
+            t.sizeChanged = true;
+            t.lutDirty = true;
+            any = true;
+        }
+    }
+    if (any) {
+        g_liveLutPending.store(true, std::memory_order_release);
+    }
+}
@@ -0,0 +1,20 @@
+// DesktopLUT - livelut.h
+// Live LUT streaming: named pipe server and render-thread application of streamed updates
+
+#pragma once
+
+#include <vector>
+
+// Pipe clients connect here (one client at a time, local only) - protocol in lutstream.h
+#define LIVE_LUT_PIPE_NAME L"\\\\.\\pipe\\DesktopLUT.LiveLUT"
+
+// Start/stop the pipe thread for the processed monitors (display indices); clears any previous stream
+bool StartLiveLutServer(const std::vector<int>& monitorIndices);
+void StopLiveLutServer();
+
+// Render thread, once per pass before rendering: upload streamed LUT boxes into mutable
+// textures and apply streamed matrices/curves (fast path: one atomic load when idle)
+void ApplyLiveLutUpdates();
+
+// Render thread, after device recovery recreated the file LUTs: stream state is re-uploaded in full
+void RequeueLiveLutUploads();
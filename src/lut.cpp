@@ -3,126 +3,261 @@
 
 #include "lut.h"
 #include "globals.h"
-#include <fstream>
-#include <sstream>
+#include "colordiff.h"
+#include "half.h"
+#include "lutingest.h"
+#include "lutstack.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
-#include <DirectXPackedVector.h>
+#include <map>
+#include <mutex>
 
-bool LoadLUT(const std::wstring& path, std::vector<float>& data, int& lutSize) {
-    std::ifstream file(path);
-    if (!file.is_open()) {
+bool OpenLUTFileView(const std::wstring& path, LUTFileView& view) {
+    view = {};
+    view.file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (view.file == INVALID_HANDLE_VALUE) {
         std::wcerr << L"Failed to open LUT file: " << path << std::endl;
         return false;
     }
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(view.file, &size) || size.QuadPart == 0) {
+        std::wcerr << L"LUT file is empty: " << path << std::endl;
+        CloseLUTFileView(view);
+        return false;
+    }
+    view.mapping = CreateFileMappingW(view.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    view.data = view.mapping ? static_cast<const char*>(MapViewOfFile(view.mapping, FILE_MAP_READ, 0, 0, 0)) : nullptr;
+    if (!view.data) {
+        std::wcerr << L"Failed to map LUT file: " << path << std::endl;
+        CloseLUTFileView(view);
+        return false;
+    }
+    view.size = (size_t)size.QuadPart;
+    return true;
+}
 
-    data.clear();
-    lutSize = 0;
-
-    // Detect format by extension
-    bool isCube = path.size() > 5 &&
-        (path.substr(path.size() - 5) == L".cube" || path.substr(path.size() - 5) == L".CUBE");
-
-    std::string line;
-    int count = 0;
-
-    if (isCube) {
-        // Parse .cube format
-        while (std::getline(file, line)) {
-            // Skip empty lines
-            if (line.empty()) continue;
-
-            // Skip comments
-            if (line[0] == '#') continue;
-
-            // Parse header
-            if (line.find("TITLE") == 0) continue;
-            if (line.find("DOMAIN_MIN") == 0) continue;
-            if (line.find("DOMAIN_MAX") == 0) continue;
-
-            if (line.find("LUT_3D_SIZE") == 0) {
-                std::istringstream iss(line.substr(11));
-                iss >> lutSize;
-                // Validate LUT size (reasonable range: 2-128, typical values: 17, 33, 65)
-                // 128^3 = 8MB texture, 256^3 = 64MB which is excessive
-                if (lutSize < 2 || lutSize > 128) {
-                    std::cerr << "Invalid LUT size: " << lutSize << " (must be 2-128)" << std::endl;
-                    return false;
-                }
-                try {
-                    data.reserve((size_t)lutSize * lutSize * lutSize * 4);
-                } catch (const std::bad_alloc&) {
-                    std::cerr << "Failed to allocate memory for " << lutSize << "^3 LUT" << std::endl;
-                    return false;
-                }
-                continue;
-            }
+void CloseLUTFileView(LUTFileView& view) {
+    if (view.data) { UnmapViewOfFile(view.data); view.data = nullptr; }
+    if (view.mapping) { CloseHandle(view.mapping); view.mapping = nullptr; }
+    if (view.file != INVALID_HANDLE_VALUE) { CloseHandle(view.file); view.file = INVALID_HANDLE_VALUE; }
+    view.size = 0;
+}
 
-            // Skip 1D LUT entries if present
-            if (line.find("LUT_1D_SIZE") == 0) continue;
-            if (line.find("LUT_1D_INPUT_RANGE") == 0) continue;
-
-            // Parse RGB values
-            std::istringstream iss(line);
-            float r, g, b;
-            if (iss >> r >> g >> b) {
-                data.push_back(r);
-                data.push_back(g);
-                data.push_back(b);
-                data.push_back(1.0f);
-                count++;
-            }
-        }
-    } else {
-        // Parse eeColor .txt format (65^3)
-        lutSize = 65;
+static bool ParseLUTFile(const std::wstring& path, std::vector<float>& data, int& lutSize) {
+    LUTFileView view;
+    if (!OpenLUTFileView(path, view)) return false;
+
+    // Header serially, then the body in newline-aligned chunks on every core
+    LutText text;
+    LutParseStats stats;
+    std::string error;
+    bool ok = ScanLUTHeader(view.data, view.size, IsCubePath(path), text, error);
+    if (ok) {
         try {
-            data.reserve(65 * 65 * 65 * 4);
+            data.resize((size_t)text.lutSize * text.lutSize * text.lutSize * 4);
         } catch (const std::bad_alloc&) {
-            std::cerr << "Failed to allocate memory for 65^3 LUT" << std::endl;
+            std::cerr << "Failed to allocate memory for " << text.lutSize << "^3 LUT" << std::endl;
+            CloseLUTFileView(view);
             return false;
         }
+        ok = ParseLUTBody(text, 0, data.data(), stats, error);
+    }
+    CloseLUTFileView(view);
+    if (!ok) {
+        std::cerr << error << std::endl;
+        data.clear();
+        return false;
+    }
+
+    lutSize = text.lutSize;
+    std::cout << "Loaded " << lutSize << "^3 LUT with " << data.size() / 4 << " entries" << std::endl;
+    return true;
+}
+
+bool LoadLUT(const std::wstring& path, std::vector<float>& data, int& lutSize) {
+    auto start = std::chrono::steady_clock::now();
+    bool ok = ParseLUTFile(path, data, lutSize);
+    if (ok) {
+        MetricObserve(g_metrics.lutLoadMs,
+            std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    } else {
+        MetricInc(g_metrics.lutLoadFailures);
+    }
+    return ok;
+}
+
+// ============================================================================
+// LUT stacks
+// ============================================================================
+
+struct CachedStackMember {
+    LUTFileStamp stamp;
+    int lutSize = 0;
+    std::vector<float> data;
+};
+
+struct CachedStack {
+    std::vector<LUTFileStamp> stamps;   // Per member, in order
+    LutInterp interp = LUT_INTERP_TRILINEAR;
+    int lutSize = 0;
+    std::shared_ptr<const std::vector<uint8_t>> payload;
+    uint64_t lastUse = 0;
+};
 
-        while (std::getline(file, line)) {
-            if (line.empty() || line[0] == '#') continue;
-
-            std::istringstream iss(line);
-            float r, g, b;
-            if (iss >> r >> g >> b) {
-                // Normalize if values are in 0-65535 range
-                if (r > 1.0f || g > 1.0f || b > 1.0f) {
-                    r /= 65535.0f;
-                    g /= 65535.0f;
-                    b /= 65535.0f;
-                }
-                data.push_back(r);
-                data.push_back(g);
-                data.push_back(b);
-                data.push_back(1.0f);
-                count++;
+// Compositions kept for reuse (least recently loaded dropped first); members stay cached while
+// a kept stack uses them
+static const size_t STACK_CACHE_SIZE = 8;
+
+// Processing thread, benchmark and manifest replay workers
+static std::mutex g_stackCacheMutex;
+static uint64_t g_stackLoads = 0;
+static std::map<std::wstring, CachedStackMember> g_stackMembers;
+static std::map<std::wstring, CachedStack> g_stacks;
+
+bool GetLUTFileStamp(const std::wstring& path, LUTFileStamp& stamp) {
+    WIN32_FILE_ATTRIBUTE_DATA attr = {};
+    if (!GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &attr)) return false;
+    stamp.size = ((uint64_t)attr.nFileSizeHigh << 32) | attr.nFileSizeLow;
+    stamp.writeTime = ((uint64_t)attr.ftLastWriteTime.dwHighDateTime << 32) | attr.ftLastWriteTime.dwLowDateTime;
+    return true;
+}
+
+bool LoadLUTStack(const std::wstring& spec, bool isHDR, std::shared_ptr<const std::vector<uint8_t>>& payload, int& lutSize) {
+    std::lock_guard<std::mutex> lock(g_stackCacheMutex);
+    std::vector<std::wstring> paths = SplitLUTStack(spec);
+    if (paths.empty() || paths.size() > (size_t)LUT_STACK_MAX) {
+        std::cerr << "LUT stack needs 1 to " << LUT_STACK_MAX << " files, got " << paths.size() << std::endl;
+        MetricInc(g_metrics.lutLoadFailures);
+        return false;
+    }
+
+    std::vector<LUTFileStamp> stamps(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (!GetLUTFileStamp(paths[i], stamps[i])) {
+            std::wcerr << L"Failed to open LUT file: " << paths[i] << std::endl;
+            MetricInc(g_metrics.lutLoadFailures);
+            return false;
+        }
+    }
+
+    // The composition bakes in the interpolation, so switching it recomposes on the next load
+    LutInterp interp = g_tetrahedralInterp.load() ? LUT_INTERP_TETRAHEDRAL : LUT_INTERP_TRILINEAR;
+    auto cached = g_stacks.find(spec);
+    if (cached != g_stacks.end() && cached->second.stamps == stamps && cached->second.interp == interp) {
+        cached->second.lastUse = ++g_stackLoads;
+        payload = cached->second.payload;
+        lutSize = cached->second.lutSize;
+        std::cout << "LUT stack unchanged, reusing its " << lutSize << "^3 composition" << std::endl;
+        return true;
+    }
+
+    // Only members that changed since they were cached are read again
+    std::vector<LutStackMember> members;
+    int outSize = 0;
+    for (size_t i = 0; i < paths.size(); i++) {
+        CachedStackMember& member = g_stackMembers[paths[i]];
+        if (member.data.empty() || !(member.stamp == stamps[i])) {
+            member = {};
+            if (!LoadLUT(paths[i], member.data, member.lutSize)) {
+                g_stackMembers.erase(paths[i]);
+                return false;
             }
+            member.stamp = stamps[i];
         }
+        members.push_back({ member.data.data(), member.lutSize });
+        outSize = (std::max)(outSize, member.lutSize);
     }
 
-    int expected = lutSize * lutSize * lutSize;
-    if (count != expected) {
-        std::cerr << "LUT error: Expected " << expected << " entries, got " << count << std::endl;
+    std::vector<float> composed;
+    try {
+        composed.resize((size_t)outSize * outSize * outSize * 4);
+    } catch (const std::bad_alloc&) {
+        std::cerr << "Failed to allocate memory for " << outSize << "^3 LUT stack" << std::endl;
+        MetricInc(g_metrics.lutLoadFailures);
         return false;
     }
+    LutStackStats stats;
+    ComposeLUTStack(members.data(), (int)members.size(), outSize, interp, 0, composed.data(), stats);
+
+    // Accuracy in perceptual terms: CIEDE2000 on the SDR gamma 2.2 output, Delta E ITP on the HDR
+    // PQ output (1.0 is about one just-noticeable difference in either)
+    LutStackSamples samples;
+    MeasureLUTStack(members.data(), (int)members.size(), { composed.data(), outSize }, interp, 0, samples, stats);
+    size_t n = (size_t)stats.samples;
+    std::vector<float> space(n * 6);
+    std::vector<float> deltaE(n);
+    float* c[6] = { &space[0], &space[n], &space[2 * n], &space[3 * n], &space[4 * n], &space[5 * n] };
+    ColorBatch composedRGB = { samples.composed[0].data(), samples.composed[1].data(), samples.composed[2].data() };
+    ColorBatch sequentialRGB = { samples.sequential[0].data(), samples.sequential[1].data(), samples.sequential[2].data() };
+    if (isHDR) {
+        PQRGBToICtCp(composedRGB, n, c[0], c[1], c[2]);
+        PQRGBToICtCp(sequentialRGB, n, c[3], c[4], c[5]);
+        DeltaEITP({ c[0], c[1], c[2] }, { c[3], c[4], c[5] }, n, deltaE.data());
+    } else {
+        DisplayRGBToLab(composedRGB, n, c[0], c[1], c[2]);
+        DisplayRGBToLab(sequentialRGB, n, c[3], c[4], c[5]);
+        DeltaE2000({ c[0], c[1], c[2] }, { c[3], c[4], c[5] }, n, deltaE.data());
+    }
+    DeltaEStats de = SummarizeDeltaE(deltaE.data(), n);
+
+    std::vector<uint16_t> half = PackLUTHalf(composed);
+    auto bytes = std::make_shared<std::vector<uint8_t>>(half.size() * sizeof(uint16_t));
+    memcpy(bytes->data(), half.data(), bytes->size());
+
+    MetricInc(g_metrics.lutStackCompositions);
+    MetricSet(g_metrics.lutStackMaxError, stats.maxError);
+    MetricSet(g_metrics.lutStackMaxDeltaE, de.max);
+    std::cout << "Composed " << members.size() << "-LUT stack to " << outSize << "^3 in " << (int)stats.composeMs
+              << " ms (" << stats.threads << " threads); vs sequential over " << stats.samples
+              << " points: max error " << stats.maxError << " (" << stats.maxError * 1023.0f
+              << " 10-bit codes), mean " << stats.meanError << "; " << (isHDR ? "dE ITP" : "dE2000")
+              << " max " << de.max << ", mean " << de.mean << std::endl;
+
+    CachedStack& stack = g_stacks[spec];
+    stack.stamps = std::move(stamps);
+    stack.interp = interp;
+    stack.lutSize = outSize;
+    stack.payload = bytes;
+    stack.lastUse = ++g_stackLoads;
 
-    std::cout << "Loaded " << lutSize << "^3 LUT with " << count << " entries" << std::endl;
+    // Drop the oldest compositions, then members no kept stack uses (a file swapped out of a stack)
+    while (g_stacks.size() > STACK_CACHE_SIZE) {
+        g_stacks.erase(std::min_element(g_stacks.begin(), g_stacks.end(), [](const auto& a, const auto& b) {
+            return a.second.lastUse < b.second.lastUse;
+        }));
+    }
+    for (auto it = g_stackMembers.begin(); it != g_stackMembers.end();) {
+        bool used = false;
+        for (const auto& entry : g_stacks) {
+            for (const auto& path : SplitLUTStack(entry.first)) used = used || path == it->first;
+        }
+        it = used ? std::next(it) : g_stackMembers.erase(it);
+    }
+
+    payload = std::move(bytes);
+    lutSize = outSize;
     return true;
 }
 
-bool CreateLUTTexture(const std::vector<float>& data, int lutSize,
-                      ID3D11Texture3D** outTexture, ID3D11ShaderResourceView** outSRV) {
+std::vector<uint16_t> PackLUTHalf(const std::vector<float>& data) {
     // Convert FP32 data to FP16 for GPU efficiency
     // Half-float is sufficient for LUT precision (10-bit mantissa = 1024 levels)
     // Industry standard: DaVinci, ACES, Baselight all use FP16 for LUT interchange
     std::vector<uint16_t> halfData;
     halfData.reserve(data.size());
     for (float f : data) {
-        halfData.push_back(DirectX::PackedVector::XMConvertFloatToHalf(f));
+        halfData.push_back(FloatToHalf(f));
     }
+    return halfData;
+}
+
+bool CreateLUTTexture(ID3D11Device* device, const std::vector<float>& data, int lutSize,
+                      ID3D11Texture3D** outTexture, ID3D11ShaderResourceView** outSRV,
+                      bool updatable) {
+    std::vector<uint16_t> halfData = PackLUTHalf(data);
 
     D3D11_TEXTURE3D_DESC texDesc = {};
     texDesc.Width = lutSize;
@@ -130,7 +265,7 @@ bool CreateLUTTexture(const std::vector<float>& data, int lutSize,
     texDesc.Depth = lutSize;
     texDesc.MipLevels = 1;
     texDesc.Format = DXGI_FORMAT_R16G16B16A16_FLOAT;  // FP16: 50% memory vs FP32
-    texDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    texDesc.Usage = updatable ? D3D11_USAGE_DEFAULT : D3D11_USAGE_IMMUTABLE;
     texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
 
     D3D11_SUBRESOURCE_DATA initData = {};
@@ -138,13 +273,13 @@ bool CreateLUTTexture(const std::vector<float>& data, int lutSize,
     initData.SysMemPitch = lutSize * 4 * sizeof(uint16_t);       // 4 components × 2 bytes
     initData.SysMemSlicePitch = lutSize * lutSize * 4 * sizeof(uint16_t);
 
-    HRESULT hr = g_device->CreateTexture3D(&texDesc, &initData, outTexture);
+    HRESULT hr = device->CreateTexture3D(&texDesc, &initData, outTexture);
     if (FAILED(hr)) {
         std::cerr << "Failed to create 3D LUT texture" << std::endl;
         return false;
     }
 
-    hr = g_device->CreateShaderResourceView(*outTexture, nullptr, outSRV);
+    hr = device->CreateShaderResourceView(*outTexture, nullptr, outSRV);
     if (FAILED(hr)) {
         std::cerr << "Failed to create LUT SRV" << std::endl;
         (*outTexture)->Release();
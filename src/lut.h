@@ -3,13 +3,43 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <d3d11.h>
+#include "lutstack.h"
 
-// Load LUT from file (.cube or .txt format)
+// Read-only mapping of a LUT file, so the text is parsed in place without a heap copy
+struct LUTFileView {
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+bool OpenLUTFileView(const std::wstring& path, LUTFileView& view);
+void CloseLUTFileView(LUTFileView& view);
+
+// Load LUT from file (.cube or .txt format) into FP32 RGBA. The renderer streams its textures
+// instead (LoadLUTTexture in gpu.h); this is for tools that need the values on the CPU.
 bool LoadLUT(const std::wstring& path, std::vector<float>& data, int& lutSize);
 
-// Create 3D texture from LUT data
-bool CreateLUTTexture(const std::vector<float>& data, int lutSize,
-                      ID3D11Texture3D** outTexture, ID3D11ShaderResourceView** outSRV);
+// Size and last write time from the file's attributes; false if it can't be found
+bool GetLUTFileStamp(const std::wstring& path, LUTFileStamp& stamp);
+
+// Compose a LUT stack ("a.cube|b.cube", see lutstack.h) into FP16 RGBA texels at the largest
+// member's size; isHDR picks the color difference its accuracy is reported in. Members are cached
+// with their file size and write time: a restart re-reads only members that changed, and reuses
+// the composition when none did.
+bool LoadLUTStack(const std::wstring& spec, bool isHDR, std::shared_ptr<const std::vector<uint8_t>>& payload, int& lutSize);
+
+// FP32 RGBA LUT data as the FP16 texels the LUT textures hold
+std::vector<uint16_t> PackLUTHalf(const std::vector<float>& data);
+
+// Create 3D texture from LUT data (RGBA)
+// updatable = DEFAULT usage so boxes can be patched with UpdateSubresource (live streaming),
+// otherwise IMMUTABLE
+bool CreateLUTTexture(ID3D11Device* device, const std::vector<float>& data, int lutSize,
+                      ID3D11Texture3D** outTexture, ID3D11ShaderResourceView** outSRV,
+                      bool updatable = false);
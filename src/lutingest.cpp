@@ -0,0 +1,523 @@
+// DesktopLUT - lutingest.cpp
+// LUT text parsing (.cube, eeColor .txt): the line grammar, a chunk-parallel parser for large
+// files, and the streaming ingest that converts z-slices to FP16 while earlier slices upload
+// (no Windows dependencies)
+
+#include "lutingest.h"
+#include "half.h"
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ============================================================================
+// Line parser
+// ============================================================================
+
+bool IsCubePath(const std::wstring& path) {
+    return path.size() > 5 &&
+        (path.substr(path.size() - 5) == L".cube" || path.substr(path.size() - 5) == L".CUBE");
+}
+
+LutLineParser MakeLutLineParser(bool isCube) {
+    LutLineParser parser;
+    parser.isCube = isCube;
+    parser.lutSize = isCube ? 0 : LUT_EECOLOR_SIZE;
+    return parser;
+}
+
+static bool StartsWith(const char* begin, const char* end, const char* keyword) {
+    size_t length = strlen(keyword);
+    return (size_t)(end - begin) >= length && memcmp(begin, keyword, length) == 0;
+}
+
+static const char* SkipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    return p;
+}
+
+static const char* LineEnd(const char* p, const char* end) {
+    const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+    return newline ? newline : end;
+}
+
+static const char* NextLine(const char* lineEnd, const char* end) {
+    return lineEnd < end ? lineEnd + 1 : end;
+}
+
+// Entry lines are told apart by their first character, so a damaged one is reported, not skipped
+static bool IsEntryLine(const char* begin, const char* end) {
+    const char* p = SkipBlanks(begin, end);
+    return p < end && ((*p >= '0' && *p <= '9') || *p == '-' || *p == '+' || *p == '.');
+}
+
+// Next whitespace-separated number, nullptr if there is none (from_chars: no locale, no allocation)
+template <typename T>
+static const char* ParseNumber(const char* p, const char* end, T& value) {
+    p = SkipBlanks(p, end);
+    if (p < end && *p == '+') p++;
+    auto result = std::from_chars(p, end, value);
+    return result.ec == std::errc() ? result.ptr : nullptr;
+}
+
+LutLineKind ParseLUTLine(LutLineParser& parser, const char* begin, const char* end, float rgb[3]) {
+    if (begin == end || *begin == '#') return LUT_LINE_SKIP;
+
+    if (parser.isCube) {
+        if (StartsWith(begin, end, "LUT_3D_SIZE")) {
+            int size = 0;
+            if (!ParseNumber(begin + 11, end, size) || size < LUT_MIN_SIZE || size > LUT_MAX_SIZE) {
+                parser.lutSize = size;
+                return LUT_LINE_BAD_SIZE;
+            }
+            parser.lutSize = size;
+            return LUT_LINE_SIZE;
+        }
+    }
+    if (!IsEntryLine(begin, end)) return LUT_LINE_SKIP;  // TITLE, DOMAIN_MIN/MAX, 1D LUT keywords
+
+    const char* p = begin;
+    for (int c = 0; c < 3; c++) {
+        p = ParseNumber(p, end, rgb[c]);
+        if (!p) return LUT_LINE_MALFORMED;
+    }
+
+    // eeColor: normalize if values are in 0-65535 range
+    if (!parser.isCube && (rgb[0] > 1.0f || rgb[1] > 1.0f || rgb[2] > 1.0f)) {
+        for (int c = 0; c < 3; c++) rgb[c] /= 65535.0f;
+    }
+    return LUT_LINE_ENTRY;
+}
+
+// ============================================================================
+// Streaming ingest
+// ============================================================================
+
+// Shared between the parser thread and the sink (calling) thread
+struct IngestState {
+    std::mutex lock;
+    std::condition_variable cv;
+    int lutSize = 0;                              // Published once known; the arena exists from then on
+    std::vector<std::vector<uint16_t>> arena;     // Slots of one z-slice each, never resized after publishing
+    std::deque<int> freeSlots;
+    std::deque<std::pair<int, int>> ready;        // Completed slices in z order: slot, z
+    bool finished = false;                        // Parser is done (error set on failure)
+    bool cancelled = false;                       // Sink failed, parser stops at its next wait
+    std::string error;
+    int parserStalls = 0;
+};
+
+static void IngestParserThread(const char* text, size_t length, bool isCube, int slots, IngestState& state) {
+    LutLineParser parser = MakeLutLineParser(isCube);
+    size_t sliceTexels = 0;
+    size_t expected = 0;
+    size_t count = 0;
+    int slot = -1;
+    int z = 0;
+    std::string error;
+
+    auto publish = [&](int size) {
+        sliceTexels = (size_t)size * size;
+        expected = sliceTexels * size;
+        std::lock_guard<std::mutex> guard(state.lock);
+        state.arena.assign(slots, std::vector<uint16_t>(sliceTexels * 4));
+        for (int i = 0; i < slots; i++) state.freeSlots.push_back(i);
+        state.lutSize = size;
+        state.cv.notify_all();
+    };
+    if (!isCube) publish(parser.lutSize);
+
+    const char* end = text + length;
+    int lineNumber = 0;
+    for (const char* line = text, *e = text; line < end; line = NextLine(e, end)) {
+        e = LineEnd(line, end);
+        lineNumber++;
+        float rgb[3];
+        LutLineKind kind = ParseLUTLine(parser, line, e, rgb);
+        if (kind == LUT_LINE_SKIP) continue;
+        if (kind == LUT_LINE_MALFORMED) {
+            error = "Line " + std::to_string(lineNumber) + ": expected three numbers";
+            break;
+        }
+        if (kind == LUT_LINE_BAD_SIZE) {
+            error = "Invalid LUT size: " + std::to_string(parser.lutSize) + " (must be " +
+                    std::to_string(LUT_MIN_SIZE) + "-" + std::to_string(LUT_MAX_SIZE) + ")";
+            break;
+        }
+        if (kind == LUT_LINE_SIZE) {
+            if (expected) {
+                error = "Line " + std::to_string(lineNumber) + ": repeated LUT_3D_SIZE";
+                break;
+            }
+            publish(parser.lutSize);
+            continue;
+        }
+
+        if (!expected) {
+            error = "Line " + std::to_string(lineNumber) + ": LUT data before LUT_3D_SIZE";
+            break;
+        }
+        if (count == expected) {
+            error = "Line " + std::to_string(lineNumber) + ": more than " + std::to_string(expected) + " entries";
+            break;
+        }
+
+        if (slot < 0) {
+            std::unique_lock<std::mutex> guard(state.lock);
+            if (state.freeSlots.empty()) {
+                state.parserStalls++;
+                state.cv.wait(guard, [&] { return !state.freeSlots.empty() || state.cancelled; });
+            }
+            if (state.cancelled) break;
+            slot = state.freeSlots.front();
+            state.freeSlots.pop_front();
+        }
+
+        uint16_t* texel = state.arena[slot].data() + (count % sliceTexels) * 4;
+        texel[0] = FloatToHalf(rgb[0]);
+        texel[1] = FloatToHalf(rgb[1]);
+        texel[2] = FloatToHalf(rgb[2]);
+        texel[3] = 0x3C00;  // 1.0
+        count++;
+
+        if (count % sliceTexels == 0) {
+            std::lock_guard<std::mutex> guard(state.lock);
+            state.ready.push_back({ slot, z++ });
+            slot = -1;
+            state.cv.notify_all();
+        }
+    }
+
+    if (error.empty() && !expected) {
+        error = "Missing LUT_3D_SIZE";
+    }
+    if (error.empty() && count != expected) {
+        error = "LUT error: Expected " + std::to_string(expected) + " entries, got " + std::to_string(count);
+    }
+
+    std::lock_guard<std::mutex> guard(state.lock);
+    if (!state.cancelled) state.error = error;
+    state.finished = true;
+    state.cv.notify_all();
+}
+
+bool IngestLUT(const char* text, size_t length, bool isCube, int slots, const LutIngestSink& sink,
+               LutIngestStats& stats, std::string& error) {
+    auto start = std::chrono::steady_clock::now();
+    stats = {};
+    error.clear();
+    if (slots < 2) slots = 2;  // One slot would serialize parsing and upload again
+
+    IngestState state;
+    std::thread parser(IngestParserThread, text, length, isCube, slots, std::ref(state));
+
+    bool begun = false;
+    for (;;) {
+        std::unique_lock<std::mutex> guard(state.lock);
+        auto progress = [&] { return (!begun && state.lutSize) || !state.ready.empty() || state.finished; };
+        if (!progress()) {
+            if (begun) stats.sinkStalls++;
+            state.cv.wait(guard, progress);
+        }
+
+        if (!begun && state.lutSize) {
+            begun = true;
+            stats.lutSize = state.lutSize;
+            stats.arenaBytes = (size_t)slots * state.arena[0].size() * sizeof(uint16_t);
+            guard.unlock();
+            if (!sink.begin(stats.lutSize)) {
+                error = "LUT upload could not start";
+                break;
+            }
+            continue;
+        }
+
+        if (!state.ready.empty()) {
+            auto [slot, z] = state.ready.front();
+            state.ready.pop_front();
+            const uint16_t* texels = state.arena[slot].data();
+            guard.unlock();
+
+            bool delivered = sink.slice(z, texels);
+            guard.lock();
+            state.freeSlots.push_back(slot);
+            state.cv.notify_all();
+            if (!delivered) {
+                error = "LUT upload failed at slice " + std::to_string(z);
+                break;
+            }
+            stats.slices++;
+            continue;
+        }
+
+        // Parser finished and every completed slice is delivered
+        break;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(state.lock);
+        if (!error.empty()) {
+            state.cancelled = true;
+            state.cv.notify_all();
+        }
+    }
+    parser.join();
+
+    stats.parserStalls = state.parserStalls;
+    stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    if (error.empty()) error = state.error;
+    return error.empty();
+}
+
+// ============================================================================
+// Parallel parse
+// ============================================================================
+
+bool ScanLUTHeader(const char* text, size_t length, bool isCube, LutText& out, std::string& error) {
+    const char* end = text + length;
+    LutLineParser parser = MakeLutLineParser(isCube);
+    out = {};
+    out.isCube = isCube;
+
+    size_t line = 1;
+    const char* p = text;
+    for (; p < end; line++) {
+        const char* e = LineEnd(p, end);
+        if (IsEntryLine(p, e)) break;
+
+        float rgb[3];
+        LutLineKind kind = ParseLUTLine(parser, p, e, rgb);
+        if (kind == LUT_LINE_BAD_SIZE) {
+            error = "Invalid LUT size: " + std::to_string(parser.lutSize) + " (must be " +
+                    std::to_string(LUT_MIN_SIZE) + "-" + std::to_string(LUT_MAX_SIZE) + ")";
+            return false;
+        }
+        if (kind == LUT_LINE_SIZE && out.lutSize) {
+            error = "Line " + std::to_string(line) + ": repeated LUT_3D_SIZE";
+            return false;
+        }
+        if (kind == LUT_LINE_SIZE) out.lutSize = parser.lutSize;
+        p = NextLine(e, end);
+    }
+    if (!isCube) out.lutSize = parser.lutSize;
+
+    if (!out.lutSize) {
+        error = p < end ? "Line " + std::to_string(line) + ": LUT data before LUT_3D_SIZE" : "Missing LUT_3D_SIZE";
+        return false;
+    }
+    out.body = p;
+    out.end = end;
+    out.bodyLine = line;
+    return true;
+}
+
+struct ParseChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    size_t lines = 0;
+    size_t entries = 0;
+    size_t firstLine = 0;          // Line number of `begin`
+    size_t firstEntry = 0;         // Entry index of the chunk's first entry
+    size_t errorLine = 0;          // First error in the chunk (0 = none)
+    std::string error;
+};
+
+static const size_t PARSE_CHUNK_MIN_BYTES = 256 * 1024;
+
+// Run fn(i) for i in [0, count) on `threads` threads, claiming indices in order
+static void ParallelFor(int count, int threads, const std::function<void(int)>& fn) {
+    std::atomic<int> next{ 0 };
+    auto worker = [&]() {
+        for (int i = next++; i < count; i = next++) fn(i);
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+}
+
+// write(index, rgb) stores one entry. Slices are handed to sliceReady by the calling thread while
+// `threads` workers parse, so the caller never parses itself when there is a sliceReady.
+template <typename Writer>
+static bool ParseLUTChunks(const LutText& text, int threads, const Writer& write,
+                           const std::function<bool(int z)>& sliceReady, LutParseStats& stats, std::string& error) {
+    auto start = std::chrono::steady_clock::now();
+    stats = {};
+    error.clear();
+    size_t bytes = text.end - text.body;
+    size_t expected = (size_t)text.lutSize * text.lutSize * text.lutSize;
+    if (threads <= 0) threads = (int)(std::max)(1u, std::thread::hardware_concurrency());
+
+    // Newline-aligned chunks, a few per thread so a slow chunk doesn't leave cores idle
+    int chunkCount = (int)(std::min)((size_t)threads * 4, (std::max)((size_t)1, bytes / PARSE_CHUNK_MIN_BYTES));
+    std::vector<ParseChunk> chunks(chunkCount);
+    const char* p = text.body;
+    for (int i = 0; i < chunkCount; i++) {
+        const char* target = i == chunkCount - 1 ? text.end : (std::max)(p, text.body + bytes * (i + 1) / chunkCount);
+        chunks[i].begin = p;
+        chunks[i].end = target < text.end ? NextLine(LineEnd(target, text.end), text.end) : text.end;
+        p = chunks[i].end;
+    }
+    threads = (std::min)(threads, chunkCount);
+    stats.threads = threads;
+    stats.chunks = chunkCount;
+    stats.bytes = bytes;
+
+    // Pass 1: lines and entries per chunk, then each chunk's first line number and entry index
+    ParallelFor(chunkCount, threads, [&](int i) {
+        ParseChunk& c = chunks[i];
+        for (const char* line = c.begin; line < c.end;) {
+            const char* e = LineEnd(line, c.end);
+            c.lines++;
+            if (IsEntryLine(line, e)) c.entries++;
+            line = NextLine(e, c.end);
+        }
+    });
+    size_t line = text.bodyLine;
+    size_t entry = 0;
+    for (auto& c : chunks) {
+        c.firstLine = line;
+        c.firstEntry = entry;
+        line += c.lines;
+        entry += c.entries;
+    }
+    auto counted = std::chrono::steady_clock::now();
+    stats.countMs = std::chrono::duration<double, std::milli>(counted - start).count();
+
+    // Pass 2: parse into place. Completed chunks are reported so slices can be handed off in order.
+    std::mutex lock;
+    std::condition_variable cv;
+    std::vector<char> done(chunkCount, 0);
+    std::atomic<bool> cancelled{ false };
+    auto parseChunk = [&](int i) {
+        ParseChunk& c = chunks[i];
+        LutLineParser parser = MakeLutLineParser(text.isCube);
+        parser.lutSize = text.lutSize;
+        size_t lineNumber = c.firstLine;
+        size_t index = c.firstEntry;
+        for (const char* cursor = c.begin; cursor < c.end && !cancelled.load(std::memory_order_relaxed); lineNumber++) {
+            const char* e = LineEnd(cursor, c.end);
+            float rgb[3];
+            LutLineKind kind = ParseLUTLine(parser, cursor, e, rgb);
+            if (kind == LUT_LINE_ENTRY) {
+                if (index >= expected) {
+                    c.error = "more than " + std::to_string(expected) + " entries";
+                } else {
+                    write(index++, rgb);
+                }
+            } else if (kind == LUT_LINE_MALFORMED) {
+                c.error = "expected three numbers";
+            } else if (kind != LUT_LINE_SKIP) {
+                c.error = "repeated LUT_3D_SIZE";
+            }
+            if (!c.error.empty()) {
+                c.errorLine = lineNumber;
+                break;
+            }
+            cursor = NextLine(e, c.end);
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        done[i] = 1;
+        cv.notify_all();
+    };
+
+    if (!sliceReady) {
+        ParallelFor(chunkCount, threads, parseChunk);
+    } else {
+        std::vector<std::thread> pool;
+        std::atomic<int> next{ 0 };
+        for (int t = 0; t < threads; t++) {
+            pool.emplace_back([&]() {
+                for (int i = next++; i < chunkCount; i = next++) parseChunk(i);
+            });
+        }
+
+        // A slice is complete once the chunks up to its last entry are done and error-free
+        size_t sliceTexels = (size_t)text.lutSize * text.lutSize;
+        int z = 0;
+        for (int i = 0; i < chunkCount && !cancelled; i++) {
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                cv.wait(guard, [&] { return done[i] != 0; });
+            }
+            if (chunks[i].errorLine) break;  // Reported below; later slices would be incomplete
+            size_t parsed = chunks[i].firstEntry + chunks[i].entries;
+            for (; z < text.lutSize && (size_t)(z + 1) * sliceTexels <= parsed; z++) {
+                if (!sliceReady(z)) {
+                    error = "LUT upload failed at slice " + std::to_string(z);
+                    cancelled = true;
+                    break;
+                }
+            }
+        }
+        cancelled = true;  // Workers past an error stop early
+        for (auto& thread : pool) thread.join();
+    }
+    stats.parseMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - counted).count();
+    if (!error.empty()) return false;
+
+    // Earliest line wins, as if the file had been read top to bottom
+    const ParseChunk* failed = nullptr;
+    for (const auto& c : chunks) {
+        if (c.errorLine && (!failed || c.errorLine < failed->errorLine)) failed = &c;
+    }
+    if (failed) {
+        error = "Line " + std::to_string(failed->errorLine) + ": " + failed->error;
+        return false;
+    }
+    if (entry != expected) {
+        error = "LUT error: Expected " + std::to_string(expected) + " entries, got " + std::to_string(entry);
+        return false;
+    }
+    return true;
+}
+
+bool ParseLUTBody(const LutText& text, int threads, float* rgba, LutParseStats& stats, std::string& error) {
+    auto write = [rgba](size_t index, const float rgb[3]) {
+        float* out = rgba + index * 4;
+        out[0] = rgb[0];
+        out[1] = rgb[1];
+        out[2] = rgb[2];
+        out[3] = 1.0f;
+    };
+    return ParseLUTChunks(text, threads, write, nullptr, stats, error);
+}
+
+bool ParseLUTBodyHalf(const LutText& text, int threads, uint16_t* texels, const std::function<bool(int z)>& sliceReady,
+                      LutParseStats& stats, std::string& error) {
+    auto write = [texels](size_t index, const float rgb[3]) {
+        uint16_t* out = texels + index * 4;
+        out[0] = FloatToHalf(rgb[0]);
+        out[1] = FloatToHalf(rgb[1]);
+        out[2] = FloatToHalf(rgb[2]);
+        out[3] = 0x3C00;  // 1.0
+    };
+    return ParseLUTChunks(text, threads, write, sliceReady, stats, error);
+}
+
+// ============================================================================
+// Retained copy
+// ============================================================================
+
+void PackLUTRGB(const uint16_t* rgba, size_t texels, uint16_t* rgb) {
+    for (size_t i = 0; i < texels; i++) {
+        rgb[i * 3 + 0] = rgba[i * 4 + 0];
+        rgb[i * 3 + 1] = rgba[i * 4 + 1];
+        rgb[i * 3 + 2] = rgba[i * 4 + 2];
+    }
+}
+
+void ExpandLUTRGB(const uint16_t* rgb, size_t texels, uint16_t* rgba) {
+    for (size_t i = 0; i < texels; i++) {
+        rgba[i * 4 + 0] = rgb[i * 3 + 0];
+        rgba[i * 4 + 1] = rgb[i * 3 + 1];
+        rgba[i * 4 + 2] = rgb[i * 3 + 2];
+        rgba[i * 4 + 3] = 0x3C00;  // 1.0
+    }
+}
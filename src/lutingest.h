@@ -0,0 +1,118 @@
+// DesktopLUT - lutingest.h
+// LUT text parsing (.cube, eeColor .txt): the line grammar, a chunk-parallel parser for large
+// files, and the streaming ingest that converts z-slices to FP16 while earlier slices upload
+// (no Windows dependencies)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Accepted sizes (typical values: 17, 33, 65). 128^3 = 16MB FP16 texture, 256^3 = 128MB is excessive
+constexpr int LUT_MIN_SIZE = 2;
+constexpr int LUT_MAX_SIZE = 128;
+constexpr int LUT_EECOLOR_SIZE = 65;     // eeColor .txt files are always 65^3
+
+// ============================================================================
+// Line parser
+// ============================================================================
+
+enum LutLineKind : uint8_t {
+    LUT_LINE_SKIP,       // Blank, comment or keyword (anything not starting with a number)
+    LUT_LINE_SIZE,       // LUT_3D_SIZE (stored in the parser)
+    LUT_LINE_ENTRY,      // One RGB entry; red varies fastest, then green, then blue
+    LUT_LINE_BAD_SIZE,   // LUT_3D_SIZE outside LUT_MIN_SIZE..LUT_MAX_SIZE
+    LUT_LINE_MALFORMED,  // Starts with a number but isn't three of them
+};
+
+struct LutLineParser {
+    bool isCube = true;
+    int lutSize = 0;     // Set by LUT_3D_SIZE (.cube) or from the start (eeColor)
+};
+
+// .cube by extension, anything else is eeColor .txt
+bool IsCubePath(const std::wstring& path);
+
+LutLineParser MakeLutLineParser(bool isCube);
+
+// Classify one line (without its newline). Entries are written to rgb, with eeColor
+// 0-65535 values normalized to 0-1.
+LutLineKind ParseLUTLine(LutLineParser& parser, const char* begin, const char* end, float rgb[3]);
+
+// ============================================================================
+// Streaming ingest
+// ============================================================================
+
+// Entries arrive blue-slowest, so every lutSize^2 lines complete one z-slice of the texture.
+// A parser thread converts each entry straight to FP16 into a bounded arena of slices and the
+// calling thread hands completed slices to the sink in order. When the arena is full the parser
+// waits for the sink, so the staging held is `slots` slices whatever the LUT size.
+struct LutIngestSink {
+    std::function<bool(int lutSize)> begin;                      // Size known, before any slice
+    std::function<bool(int z, const uint16_t* texels)> slice;    // lutSize^2 RGBA FP16 texels
+};
+
+constexpr int LUT_INGEST_SLOTS = 3;      // One uploading, one parsing, one spare
+
+struct LutIngestStats {
+    int lutSize = 0;
+    int slices = 0;            // Delivered to the sink
+    int parserStalls = 0;      // Parser found the arena full (the sink is the bottleneck)
+    int sinkStalls = 0;        // Sink found no completed slice (parsing is the bottleneck)
+    size_t arenaBytes = 0;     // Staging allocated for the slices
+    double ms = 0.0;
+};
+
+// Parse the file text (mapped) and stream it through the sink; sink calls are made on the
+// calling thread. False with `error` set on a bad size or line, a wrong entry count or a sink
+// that returned false (the parser stops early; slices already delivered stay delivered).
+bool IngestLUT(const char* text, size_t length, bool isCube, int slots, const LutIngestSink& sink,
+               LutIngestStats& stats, std::string& error);
+
+// ============================================================================
+// Parallel parse
+// ============================================================================
+
+// A whole LUT file in memory (mapped or read). The header is read serially. The body is split into
+// newline-aligned chunks that are counted in parallel (lines, entries); the counts give every chunk
+// its first line number and entry index, so the chunks are then parsed in parallel straight into
+// their final texels. Errors carry the file line number, whichever chunk finds them.
+struct LutText {
+    const char* body = nullptr;    // First entry line
+    const char* end = nullptr;
+    size_t bodyLine = 0;           // Its line number (1-based)
+    int lutSize = 0;
+    bool isCube = true;
+};
+
+// Below this much text the threads cost more than they save (a 65^3 .cube is ~7MB)
+constexpr size_t LUT_PARALLEL_MIN_BYTES = 4 << 20;
+
+struct LutParseStats {
+    int threads = 0;
+    int chunks = 0;
+    size_t bytes = 0;          // Body text
+    double countMs = 0.0;      // Chunk line/entry counting
+    double parseMs = 0.0;      // Entry parsing (and slice hand-off)
+};
+
+// Read the header up to the first entry line; false with `error` set on a bad or missing size
+bool ScanLUTHeader(const char* text, size_t length, bool isCube, LutText& out, std::string& error);
+
+// Parse the body into lutSize^3 RGBA texels (threads <= 0: one per core). The FP16 variant calls
+// sliceReady (optional) on the calling thread with each z, in order, as soon as the chunks covering
+// it are parsed, so uploads overlap the rest of the parse; returning false stops it.
+bool ParseLUTBody(const LutText& text, int threads, float* rgba, LutParseStats& stats, std::string& error);
+bool ParseLUTBodyHalf(const LutText& text, int threads, uint16_t* texels, const std::function<bool(int z)>& sliceReady,
+                      LutParseStats& stats, std::string& error);
+
+// ============================================================================
+// Retained copy
+// ============================================================================
+
+// What a pooled LUT keeps to rebuild its texture after device loss without the file: the FP16
+// RGB of each texel (alpha is always 1.0), three quarters of the texture's size
+void PackLUTRGB(const uint16_t* rgba, size_t texels, uint16_t* rgb);
+void ExpandLUTRGB(const uint16_t* rgb, size_t texels, uint16_t* rgba);
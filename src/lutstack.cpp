@@ -0,0 +1,188 @@
+// DesktopLUT - lutstack.cpp
+// LUT stacks: several LUTs applied in order, composed on the CPU into a single texture
+// (no Windows dependencies)
+
+#include "lutstack.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cmath>
+#include <functional>
+#include <thread>
+
+std::vector<std::wstring> SplitLUTStack(const std::wstring& spec) {
+    std::vector<std::wstring> members;
+    size_t start = 0;
+    while (start <= spec.size()) {
+        size_t sep = (std::min)(spec.find(LUT_STACK_SEPARATOR, start), spec.size());
+        std::wstring member = spec.substr(start, sep - start);
+        size_t first = member.find_first_not_of(L" \t");
+        if (first != std::wstring::npos) {
+            members.push_back(member.substr(first, member.find_last_not_of(L" \t") - first + 1));
+        }
+        start = sep + 1;
+    }
+    return members;
+}
+
+bool IsLUTStack(const std::wstring& spec) {
+    return spec.find(LUT_STACK_SEPARATOR) != std::wstring::npos && SplitLUTStack(spec).size() > 1;
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+static inline float Saturate(float v) {
+    return v > 0.0f ? (v < 1.0f ? v : 1.0f) : 0.0f;   // NaN -> 0, like HLSL saturate
+}
+
+void SampleLUT(const LutStackMember& lut, LutInterp interp, const float in[3], float out[3]) {
+    int n = lut.lutSize;
+    float scaled[3];
+    int base[3];
+    float f[3];
+    for (int c = 0; c < 3; c++) {
+        scaled[c] = Saturate(in[c]) * (float)(n - 1);
+        base[c] = (std::min)((int)scaled[c], n - 2);
+        f[c] = scaled[c] - (float)base[c];
+    }
+    auto texel = [&](int dr, int dg, int db) {
+        return lut.rgba + (((size_t)(base[2] + db) * n + (base[1] + dg)) * n + (base[0] + dr)) * 4;
+    };
+
+    const float* c000 = texel(0, 0, 0);
+    const float* c111 = texel(1, 1, 1);
+    if (interp == LUT_INTERP_TRILINEAR) {
+        const float* c100 = texel(1, 0, 0);
+        const float* c010 = texel(0, 1, 0);
+        const float* c110 = texel(1, 1, 0);
+        const float* c001 = texel(0, 0, 1);
+        const float* c101 = texel(1, 0, 1);
+        const float* c011 = texel(0, 1, 1);
+        for (int c = 0; c < 3; c++) {
+            float x00 = c000[c] + (c100[c] - c000[c]) * f[0];
+            float x10 = c010[c] + (c110[c] - c010[c]) * f[0];
+            float x01 = c001[c] + (c101[c] - c001[c]) * f[0];
+            float x11 = c011[c] + (c111[c] - c011[c]) * f[0];
+            float y0 = x00 + (x10 - x00) * f[1];
+            float y1 = x01 + (x11 - x01) * f[1];
+            out[c] = y0 + (y1 - y0) * f[2];
+        }
+        return;
+    }
+
+    // Tetrahedral: the same six cases as SampleLUTTetrahedral in the shader
+    float fr = f[0], fg = f[1], fb = f[2];
+    const float* a;
+    const float* b;
+    float w0, w1, w2;   // Weights of (a - c000), (b - a), (c111 - b)
+    if (fr > fg) {
+        if (fg > fb)      { a = texel(1, 0, 0); b = texel(1, 1, 0); w0 = fr; w1 = fg; w2 = fb; }
+        else if (fr > fb) { a = texel(1, 0, 0); b = texel(1, 0, 1); w0 = fr; w1 = fb; w2 = fg; }
+        else              { a = texel(0, 0, 1); b = texel(1, 0, 1); w0 = fb; w1 = fr; w2 = fg; }
+    } else {
+        if (fb > fg)      { a = texel(0, 0, 1); b = texel(0, 1, 1); w0 = fb; w1 = fg; w2 = fr; }
+        else if (fb > fr) { a = texel(0, 1, 0); b = texel(0, 1, 1); w0 = fg; w1 = fb; w2 = fr; }
+        else              { a = texel(0, 1, 0); b = texel(1, 1, 0); w0 = fg; w1 = fr; w2 = fb; }
+    }
+    for (int c = 0; c < 3; c++) {
+        out[c] = c000[c] + w0 * (a[c] - c000[c]) + w1 * (b[c] - a[c]) + w2 * (c111[c] - b[c]);
+    }
+}
+
+void ApplyLUTStack(const LutStackMember* members, int count, LutInterp interp, const float in[3], float out[3]) {
+    float rgb[3] = { in[0], in[1], in[2] };
+    for (int i = 0; i < count; i++) {
+        SampleLUT(members[i], interp, rgb, out);
+        rgb[0] = out[0]; rgb[1] = out[1]; rgb[2] = out[2];
+    }
+    if (count == 0) { out[0] = rgb[0]; out[1] = rgb[1]; out[2] = rgb[2]; }
+}
+
+// ============================================================================
+// Composition
+// ============================================================================
+
+// Run fn(i) for i in [0, count) on `threads` threads, claiming indices in order
+static void ParallelFor(int count, int threads, const std::function<void(int)>& fn) {
+    std::atomic<int> next{ 0 };
+    auto worker = [&]() {
+        for (int i = next++; i < count; i = next++) fn(i);
+    };
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; t++) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+}
+
+// Measurement points, split into blocks so the threads can share the work
+static const int ERROR_BLOCKS = 64;
+
+void ComposeLUTStack(const LutStackMember* members, int count, int outSize, LutInterp interp, int threads,
+                     float* rgba, LutStackStats& stats) {
+    auto start = std::chrono::steady_clock::now();
+    if (threads <= 0) threads = (int)(std::max)(1u, std::thread::hardware_concurrency());
+    threads = (std::min)(threads, outSize);
+    stats.threads = threads;
+
+    // Every node is independent, so slices go to whichever thread is free
+    float scale = 1.0f / (float)(outSize - 1);
+    ParallelFor(outSize, threads, [&](int z) {
+        float* dst = rgba + (size_t)z * outSize * outSize * 4;
+        for (int y = 0; y < outSize; y++) {
+            for (int x = 0; x < outSize; x++, dst += 4) {
+                float in[3] = { x * scale, y * scale, z * scale };
+                ApplyLUTStack(members, count, interp, in, dst);
+                dst[3] = 1.0f;
+            }
+        }
+    });
+    stats.composeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void MeasureLUTStack(const LutStackMember* members, int count, const LutStackMember& composed, LutInterp interp,
+                     int threads, LutStackSamples& samples, LutStackStats& stats) {
+    auto start = std::chrono::steady_clock::now();
+    if (threads <= 0) threads = (int)(std::max)(1u, std::thread::hardware_concurrency());
+    for (int c = 0; c < 3; c++) {
+        samples.composed[c].resize(LUT_STACK_ERROR_SAMPLES);
+        samples.sequential[c].resize(LUT_STACK_ERROR_SAMPLES);
+    }
+
+    // Fixed pseudo-random points, each block seeded on its own so the split doesn't change them
+    float blockMax[ERROR_BLOCKS] = {};
+    double blockSum[ERROR_BLOCKS] = {};
+    const int perBlock = LUT_STACK_ERROR_SAMPLES / ERROR_BLOCKS;
+    ParallelFor(ERROR_BLOCKS, threads, [&](int block) {
+        uint32_t state = 0x9E3779B9u * (uint32_t)(block + 1);
+        auto next = [&]() {
+            state ^= state << 13; state ^= state >> 17; state ^= state << 5;   // xorshift32
+            return (float)(state >> 8) * (1.0f / 16777216.0f);
+        };
+        for (int i = block * perBlock; i < (block + 1) * perBlock; i++) {
+            float in[3] = { next(), next(), next() };
+            float direct[3], sequential[3];
+            SampleLUT(composed, interp, in, direct);
+            ApplyLUTStack(members, count, interp, in, sequential);
+            float err = 0.0f;
+            for (int c = 0; c < 3; c++) {
+                samples.composed[c][i] = direct[c];
+                samples.sequential[c][i] = sequential[c];
+                err = (std::max)(err, std::fabs(direct[c] - sequential[c]));
+            }
+            blockMax[block] = (std::max)(blockMax[block], err);
+            blockSum[block] += err;
+        }
+    });
+    double sum = 0.0;
+    stats.maxError = 0.0f;
+    for (int b = 0; b < ERROR_BLOCKS; b++) {
+        stats.maxError = (std::max)(stats.maxError, blockMax[b]);
+        sum += blockSum[b];
+    }
+    stats.samples = perBlock * ERROR_BLOCKS;
+    stats.meanError = (float)(sum / stats.samples);
+    stats.measureMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
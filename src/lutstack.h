@@ -0,0 +1,73 @@
+// DesktopLUT - lutstack.h
+// LUT stacks: several LUTs applied in order, composed on the CPU into a single texture
+// (no Windows dependencies)
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A LUT path setting may list several files separated by '|' (not valid in Windows paths),
+// applied left to right: "print-proof.cube|calibration.cube"
+constexpr wchar_t LUT_STACK_SEPARATOR = L'|';
+constexpr int LUT_STACK_MAX = 4;
+
+// Members in application order (surrounding spaces trimmed, empty members dropped)
+std::vector<std::wstring> SplitLUTStack(const std::wstring& spec);
+
+// More than one member - a single path is loaded as before
+bool IsLUTStack(const std::wstring& spec);
+
+// Size and last write time of a member file: a different stamp means the file changed
+struct LUTFileStamp {
+    uint64_t size = 0;
+    uint64_t writeTime = 0;
+    bool operator==(const LUTFileStamp& o) const { return size == o.size && writeTime == o.writeTime; }
+};
+
+enum LutInterp {
+    LUT_INTERP_TRILINEAR,
+    LUT_INTERP_TETRAHEDRAL,
+};
+
+// FP32 RGBA, red varying fastest (LoadLUT layout)
+struct LutStackMember {
+    const float* rgba = nullptr;
+    int lutSize = 0;
+};
+
+// One lookup the way the shader does it: input saturated to 0-1, then interpolated
+void SampleLUT(const LutStackMember& lut, LutInterp interp, const float in[3], float out[3]);
+
+// Sequential application of every member (each stage's output saturated by the next lookup)
+void ApplyLUTStack(const LutStackMember* members, int count, LutInterp interp, const float in[3], float out[3]);
+
+struct LutStackStats {
+    int threads = 0;
+    double composeMs = 0.0;
+    double measureMs = 0.0;
+    // Composed lookup vs sequential application, at points between the composed grid nodes
+    // (the nodes themselves are exact); 0-1 signal units, worst channel
+    int samples = 0;
+    float maxError = 0.0f;
+    float meanError = 0.0f;
+};
+
+// Points compared by the accuracy measurement (fixed pseudo-random set, same for every stack)
+constexpr int LUT_STACK_ERROR_SAMPLES = 1 << 16;
+
+// Evaluate the stack at every node of an outSize^3 grid, z-slices spread over `threads`
+// (<= 0: one per core), into outSize^3 RGBA. outSize is normally the largest member's.
+void ComposeLUTStack(const LutStackMember* members, int count, int outSize, LutInterp interp, int threads,
+                     float* rgba, LutStackStats& stats);
+
+// The measurement points' outputs (SoA RGB), for color-difference reports (color.h)
+struct LutStackSamples {
+    std::vector<float> composed[3];     // Through the composed LUT
+    std::vector<float> sequential[3];   // Through the members one after another
+};
+
+// Run the measurement points through the composed LUT and the members; fills the error fields
+void MeasureLUTStack(const LutStackMember* members, int count, const LutStackMember& composed, LutInterp interp,
+                     int threads, LutStackSamples& samples, LutStackStats& stats);
@@ -0,0 +1,333 @@
+// DesktopLUT - lutstream.cpp
+// Live LUT streaming protocol (framing, validation) and the pending-update store it merges into
+
+#include "lutstream.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+// Wire integers are little-endian - every supported target is, so fields are copied as-is
+template <typename T>
+static T ReadField(const uint8_t* p) {
+    T v;
+    memcpy(&v, p, sizeof(T));
+    return v;
+}
+
+template <typename T>
+static void WriteField(std::vector<uint8_t>& out, T v) {
+    size_t pos = out.size();
+    out.resize(pos + sizeof(T));
+    memcpy(out.data() + pos, &v, sizeof(T));
+}
+
+static bool ValidValues(const std::vector<float>& values, float minValue) {
+    for (float v : values) {
+        if (!std::isfinite(v) || v < minValue || v > LUT_STREAM_MAX_VALUE) return false;
+    }
+    return true;
+}
+
+static bool ValidLutSize(int lutSize) {
+    return lutSize >= LUT_STREAM_MIN_SIZE && lutSize <= LUT_STREAM_MAX_SIZE;
+}
+
+static void ReadFloats(const uint8_t* p, size_t count, std::vector<float>& out) {
+    out.resize(count);
+    if (count) memcpy(out.data(), p, count * sizeof(float));
+}
+
+// Decode and validate one payload (framing already checked)
+static LutStreamStatus DecodePayload(const uint8_t* p, size_t size, LutStreamMessage& msg) {
+    if (msg.type == LutStreamType::Ack) return LutStreamStatus::BadType;
+    if (msg.type != LutStreamType::LutFull && msg.type != LutStreamType::LutRegion &&
+        msg.type != LutStreamType::Matrix && msg.type != LutStreamType::Grayscale) {
+        return LutStreamStatus::BadType;
+    }
+    if (size < LUT_STREAM_TARGET_SIZE) return LutStreamStatus::BadLength;
+    msg.monitorIndex = ReadField<int32_t>(p);
+    msg.isHDR = p[4] != 0;
+    p += LUT_STREAM_TARGET_SIZE;
+    size -= LUT_STREAM_TARGET_SIZE;
+
+    switch (msg.type) {
+    case LutStreamType::LutFull: {
+        if (size < 4) return LutStreamStatus::BadLength;
+        uint32_t lutSize = ReadField<uint32_t>(p);
+        if (!ValidLutSize((int)(std::min)(lutSize, 0x7FFFFFFFu))) return LutStreamStatus::BadSize;
+        msg.lutSize = (int)lutSize;
+        size_t count = (size_t)lutSize * lutSize * lutSize * 3;
+        if (size != 4 + count * sizeof(float)) return LutStreamStatus::BadLength;
+        ReadFloats(p + 4, count, msg.values);
+        return ValidValues(msg.values, -LUT_STREAM_MAX_VALUE) ? LutStreamStatus::Ok : LutStreamStatus::BadValue;
+    }
+    case LutStreamType::LutRegion: {
+        if (size < 4 + 6 * 4) return LutStreamStatus::BadLength;
+        uint32_t lutSize = ReadField<uint32_t>(p);
+        if (!ValidLutSize((int)(std::min)(lutSize, 0x7FFFFFFFu))) return LutStreamStatus::BadSize;
+        msg.lutSize = (int)lutSize;
+        uint64_t box[6];
+        for (int i = 0; i < 6; i++) box[i] = ReadField<uint32_t>(p + 4 + i * 4);
+        for (int axis = 0; axis < 3; axis++) {
+            // 64-bit so a huge offset can't wrap past the end check
+            if (box[3 + axis] == 0 || box[axis] + box[3 + axis] > lutSize) return LutStreamStatus::BadRegion;
+        }
+        for (int i = 0; i < 6; i++) msg.region[i] = (int)box[i];
+        size_t count = (size_t)(box[3] * box[4] * box[5] * 3);
+        if (size != 4 + 6 * 4 + count * sizeof(float)) return LutStreamStatus::BadLength;
+        ReadFloats(p + 4 + 6 * 4, count, msg.values);
+        return ValidValues(msg.values, -LUT_STREAM_MAX_VALUE) ? LutStreamStatus::Ok : LutStreamStatus::BadValue;
+    }
+    case LutStreamType::Matrix:
+        if (size != 9 * sizeof(float)) return LutStreamStatus::BadLength;
+        ReadFloats(p, 9, msg.values);
+        return ValidValues(msg.values, -LUT_STREAM_MAX_VALUE) ? LutStreamStatus::Ok : LutStreamStatus::BadValue;
+    case LutStreamType::Grayscale: {
+        if (size < 4) return LutStreamStatus::BadLength;
+        uint32_t points = ReadField<uint32_t>(p);
+        if (points < 2 || points > (uint32_t)LUT_STREAM_MAX_GRAYSCALE_POINTS) return LutStreamStatus::BadSize;
+        if (size != 4 + points * sizeof(float)) return LutStreamStatus::BadLength;
+        ReadFloats(p + 4, points, msg.values);
+        return ValidValues(msg.values, 0.0f) ? LutStreamStatus::Ok : LutStreamStatus::BadValue;
+    }
+    default:
+        return LutStreamStatus::BadType;
+    }
+}
+
+void LutStreamFeed(LutStreamParser& p, const uint8_t* data, size_t size) {
+    // Drop consumed bytes once they dominate the buffer (keeps compaction amortized O(1))
+    if (p.readPos > 0 && p.readPos * 2 >= p.buffer.size()) {
+        p.buffer.erase(p.buffer.begin(), p.buffer.begin() + (ptrdiff_t)p.readPos);
+        p.readPos = 0;
+    }
+    p.buffer.insert(p.buffer.end(), data, data + size);
+}
+
+LutStreamResult LutStreamNext(LutStreamParser& p, LutStreamMessage& msg, LutStreamStatus& status) {
+    size_t available = p.buffer.size() - p.readPos;
+    if (available < LUT_STREAM_HEADER_SIZE) return LutStreamResult::NeedMore;
+
+    const uint8_t* h = p.buffer.data() + p.readPos;
+    if (ReadField<uint32_t>(h) != LUT_STREAM_MAGIC) {
+        status = LutStreamStatus::BadMagic;
+        return LutStreamResult::FramingError;
+    }
+    msg.sequence = ReadField<uint32_t>(h + 8);
+    if (ReadField<uint16_t>(h + 4) != LUT_STREAM_VERSION) {
+        status = LutStreamStatus::BadVersion;
+        return LutStreamResult::FramingError;
+    }
+    uint32_t payloadSize = ReadField<uint32_t>(h + 12);
+    if (payloadSize > LUT_STREAM_MAX_PAYLOAD) {
+        status = LutStreamStatus::PayloadTooLarge;
+        return LutStreamResult::FramingError;
+    }
+    if (available < LUT_STREAM_HEADER_SIZE + payloadSize) return LutStreamResult::NeedMore;
+
+    msg.type = (LutStreamType)ReadField<uint16_t>(h + 6);
+    msg.lutSize = 0;
+    msg.values.clear();
+    status = DecodePayload(h + LUT_STREAM_HEADER_SIZE, payloadSize, msg);
+    p.readPos += LUT_STREAM_HEADER_SIZE + payloadSize;
+    return LutStreamResult::Message;
+}
+
+static void EncodeHeader(LutStreamType type, uint32_t sequence, size_t payloadSize, std::vector<uint8_t>& out) {
+    WriteField<uint32_t>(out, LUT_STREAM_MAGIC);
+    WriteField<uint16_t>(out, LUT_STREAM_VERSION);
+    WriteField<uint16_t>(out, (uint16_t)type);
+    WriteField<uint32_t>(out, sequence);
+    WriteField<uint32_t>(out, (uint32_t)payloadSize);
+}
+
+void LutStreamEncode(const LutStreamMessage& msg, std::vector<uint8_t>& out) {
+    size_t payloadSize = LUT_STREAM_TARGET_SIZE + msg.values.size() * sizeof(float);
+    if (msg.type == LutStreamType::LutFull || msg.type == LutStreamType::Grayscale) payloadSize += 4;
+    if (msg.type == LutStreamType::LutRegion) payloadSize += 4 + 6 * 4;
+
+    EncodeHeader(msg.type, msg.sequence, payloadSize, out);
+    WriteField<int32_t>(out, msg.monitorIndex);
+    WriteField<uint8_t>(out, msg.isHDR ? 1 : 0);
+    WriteField<uint8_t>(out, 0);
+    WriteField<uint16_t>(out, 0);
+    if (msg.type == LutStreamType::LutFull || msg.type == LutStreamType::LutRegion) {
+        WriteField<uint32_t>(out, (uint32_t)msg.lutSize);
+    }
+    if (msg.type == LutStreamType::LutRegion) {
+        for (int i = 0; i < 6; i++) WriteField<uint32_t>(out, (uint32_t)msg.region[i]);
+    }
+    if (msg.type == LutStreamType::Grayscale) {
+        WriteField<uint32_t>(out, (uint32_t)msg.values.size());
+    }
+    size_t pos = out.size();
+    out.resize(pos + msg.values.size() * sizeof(float));
+    if (!msg.values.empty()) memcpy(out.data() + pos, msg.values.data(), msg.values.size() * sizeof(float));
+}
+
+void LutStreamEncodeAck(uint32_t sequence, LutStreamStatus status, std::vector<uint8_t>& out) {
+    EncodeHeader(LutStreamType::Ack, sequence, 4, out);
+    WriteField<uint16_t>(out, (uint16_t)status);
+    WriteField<uint16_t>(out, 0);
+}
+
+const char* LutStreamStatusName(LutStreamStatus status) {
+    switch (status) {
+    case LutStreamStatus::Ok: return "ok";
+    case LutStreamStatus::BadMagic: return "bad magic";
+    case LutStreamStatus::BadVersion: return "unsupported version";
+    case LutStreamStatus::PayloadTooLarge: return "payload too large";
+    case LutStreamStatus::BadType: return "unknown message type";
+    case LutStreamStatus::BadLength: return "payload length mismatch";
+    case LutStreamStatus::BadSize: return "size out of range";
+    case LutStreamStatus::BadRegion: return "region outside LUT";
+    case LutStreamStatus::BadValue: return "non-finite or out-of-range value";
+    case LutStreamStatus::NoBaseLut: return "no full LUT of this size streamed yet";
+    case LutStreamStatus::UnknownMonitor: return "monitor not processed";
+    }
+    return "unknown";
+}
+
+bool LutStreamServe(LutStreamParser& p, const uint8_t* data, size_t size, const LutStreamHandler& handle,
+                    LutStreamMessage& msg, std::vector<uint8_t>& reply) {
+    LutStreamFeed(p, data, size);
+
+    LutStreamStatus status;
+    LutStreamResult result;
+    while ((result = LutStreamNext(p, msg, status)) != LutStreamResult::NeedMore) {
+        if (result == LutStreamResult::FramingError) {
+            std::cerr << "Live LUT: dropping client (" << LutStreamStatusName(status) << ")" << std::endl;
+            LutStreamEncodeAck(0, status, reply);
+            return false;
+        }
+        if (status == LutStreamStatus::Ok) {
+            status = handle(msg);
+        }
+        if (status != LutStreamStatus::Ok) {
+            std::cerr << "Live LUT: message " << msg.sequence << " rejected ("
+                      << LutStreamStatusName(status) << ")" << std::endl;
+        }
+        LutStreamEncodeAck(msg.sequence, status, reply);
+    }
+    return true;
+}
+
+// ============================================================================
+// Pending update store
+// ============================================================================
+
+static LiveLutTarget& FindOrAddTarget(LiveLutStore& store, int monitorIndex, bool isHDR) {
+    for (auto& t : store.targets) {
+        if (t.monitorIndex == monitorIndex && t.isHDR == isHDR) return t;
+    }
+    store.targets.emplace_back();
+    store.targets.back().monitorIndex = monitorIndex;
+    store.targets.back().isHDR = isHDR;
+    return store.targets.back();
+}
+
+// Copy an RGB box into the RGBA shadow and grow the dirty box to cover it
+static void WriteRegion(LiveLutTarget& t, const int box[6], const std::vector<float>& rgb) {
+    int n = t.lutSize;
+    const float* src = rgb.data();
+    for (int z = box[2]; z < box[2] + box[5]; z++) {
+        for (int y = box[1]; y < box[1] + box[4]; y++) {
+            float* dst = t.rgba.data() + (((size_t)z * n + y) * n + box[0]) * 4;
+            for (int x = 0; x < box[3]; x++) {
+                dst[0] = src[0];
+                dst[1] = src[1];
+                dst[2] = src[2];
+                dst[3] = 1.0f;
+                dst += 4;
+                src += 3;
+            }
+        }
+    }
+
+    if (!t.lutDirty) {
+        for (int axis = 0; axis < 3; axis++) {
+            t.dirtyMin[axis] = box[axis];
+            t.dirtyMax[axis] = box[axis] + box[3 + axis];
+        }
+        t.lutDirty = true;
+    } else {
+        for (int axis = 0; axis < 3; axis++) {
+            t.dirtyMin[axis] = (std::min)(t.dirtyMin[axis], box[axis]);
+            t.dirtyMax[axis] = (std::max)(t.dirtyMax[axis], box[axis] + box[3 + axis]);
+        }
+    }
+}
+
+LutStreamStatus LiveLutMerge(LiveLutStore& store, const LutStreamMessage& msg) {
+    switch (msg.type) {
+    case LutStreamType::LutFull: {
+        LiveLutTarget& t = FindOrAddTarget(store, msg.monitorIndex, msg.isHDR);
+        if (t.lutSize != msg.lutSize) {
+            t.lutSize = msg.lutSize;
+            t.rgba.assign((size_t)msg.lutSize * msg.lutSize * msg.lutSize * 4, 0.0f);
+            t.sizeChanged = true;
+        }
+        int box[6] = { 0, 0, 0, msg.lutSize, msg.lutSize, msg.lutSize };
+        WriteRegion(t, box, msg.values);
+        return LutStreamStatus::Ok;
+    }
+    case LutStreamType::LutRegion: {
+        LiveLutTarget& t = FindOrAddTarget(store, msg.monitorIndex, msg.isHDR);
+        // Regions patch the streamed shadow - the file-loaded LUT isn't mirrored on the CPU
+        if (t.lutSize != msg.lutSize) return LutStreamStatus::NoBaseLut;
+        WriteRegion(t, msg.region, msg.values);
+        return LutStreamStatus::Ok;
+    }
+    case LutStreamType::Matrix: {
+        LiveLutTarget& t = FindOrAddTarget(store, msg.monitorIndex, msg.isHDR);
+        std::copy(msg.values.begin(), msg.values.end(), t.matrix);
+        t.matrixDirty = true;
+        return LutStreamStatus::Ok;
+    }
+    case LutStreamType::Grayscale: {
+        LiveLutTarget& t = FindOrAddTarget(store, msg.monitorIndex, msg.isHDR);
+        t.grayscalePointCount = (int)msg.values.size();
+        std::copy(msg.values.begin(), msg.values.end(), t.grayscalePoints);
+        t.grayscaleDirty = true;
+        return LutStreamStatus::Ok;
+    }
+    default:
+        return LutStreamStatus::BadType;
+    }
+}
+
+bool LiveLutTakeUpload(LiveLutTarget& t, LiveLutUpload& out) {
+    if (!t.lutDirty) return false;
+
+    out.recreate = t.sizeChanged;
+    out.lutSize = t.lutSize;
+    if (out.recreate) {
+        // New texture is created from the whole volume
+        for (int axis = 0; axis < 3; axis++) {
+            out.boxMin[axis] = 0;
+            out.boxMax[axis] = t.lutSize;
+        }
+    } else {
+        std::copy(t.dirtyMin, t.dirtyMin + 3, out.boxMin);
+        std::copy(t.dirtyMax, t.dirtyMax + 3, out.boxMax);
+    }
+
+    int n = t.lutSize;
+    int w = out.boxMax[0] - out.boxMin[0];
+    int h = out.boxMax[1] - out.boxMin[1];
+    int d = out.boxMax[2] - out.boxMin[2];
+    out.rgba.resize((size_t)w * h * d * 4);
+    float* dst = out.rgba.data();
+    for (int z = out.boxMin[2]; z < out.boxMax[2]; z++) {
+        for (int y = out.boxMin[1]; y < out.boxMax[1]; y++) {
+            const float* src = t.rgba.data() + (((size_t)z * n + y) * n + out.boxMin[0]) * 4;
+            memcpy(dst, src, (size_t)w * 4 * sizeof(float));
+            dst += (size_t)w * 4;
+        }
+    }
+
+    t.lutDirty = false;
+    t.sizeChanged = false;
+    return true;
+}
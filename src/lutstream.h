@@ -0,0 +1,137 @@
+// DesktopLUT - lutstream.h
+// Live LUT streaming protocol (framing, validation) and the pending-update store it merges into
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Wire format (little-endian, no padding):
+//   header   magic u32 'DLUT', version u16, type u16, sequence u32, payloadSize u32
+//   target   monitorIndex i32, isHDR u8, reserved u8[3]
+//   LutFull      target, lutSize u32, float rgb[lutSize^3 * 3]   (red varies fastest, as in .cube)
+//   LutRegion    target, lutSize u32, x y z u32, w h d u32, float rgb[w*h*d * 3]
+//   Matrix       target, float m[9]                             (row-major, source RGB -> display RGB)
+//   Grayscale    target, pointCount u32, float points[pointCount] (same layout as GrayscaleData)
+//   Ack          status u16, reserved u16                       (server -> client, sequence echoed)
+// Every client message is answered with one Ack in order
+constexpr uint32_t LUT_STREAM_MAGIC = 0x54554C44;   // "DLUT"
+constexpr uint16_t LUT_STREAM_VERSION = 1;
+constexpr size_t LUT_STREAM_HEADER_SIZE = 16;
+constexpr size_t LUT_STREAM_TARGET_SIZE = 8;
+
+constexpr int LUT_STREAM_MIN_SIZE = 2;               // Same range as LoadLUT
+constexpr int LUT_STREAM_MAX_SIZE = 128;
+constexpr int LUT_STREAM_MAX_GRAYSCALE_POINTS = 32;  // GrayscaleData::points
+
+// Largest legal payload (128^3 region covering the whole LUT) - anything bigger is a framing error
+constexpr size_t LUT_STREAM_MAX_PAYLOAD = LUT_STREAM_TARGET_SIZE + 4 + 6 * 4 +
+    (size_t)LUT_STREAM_MAX_SIZE * LUT_STREAM_MAX_SIZE * LUT_STREAM_MAX_SIZE * 3 * sizeof(float);
+
+// Values outside this range are rejected (LUT outputs and curve points are normalized)
+constexpr float LUT_STREAM_MAX_VALUE = 16.0f;
+
+enum class LutStreamType : uint16_t {
+    LutFull = 1,
+    LutRegion = 2,
+    Matrix = 3,
+    Grayscale = 4,
+    Ack = 0x80
+};
+
+enum class LutStreamStatus : uint16_t {
+    Ok = 0,
+    BadMagic = 1,        // Framing errors - the connection is dropped after the Ack
+    BadVersion = 2,
+    PayloadTooLarge = 3,
+    BadType = 4,         // Message errors - the message is skipped, the stream continues
+    BadLength = 5,
+    BadSize = 6,
+    BadRegion = 7,
+    BadValue = 8,
+    NoBaseLut = 9,       // Region update before any full LUT for that target (or size mismatch)
+    UnknownMonitor = 10  // Target not currently processed
+};
+
+struct LutStreamMessage {
+    LutStreamType type = LutStreamType::LutFull;
+    uint32_t sequence = 0;
+    int monitorIndex = 0;
+    bool isHDR = false;
+    int lutSize = 0;
+    int region[6] = {};           // x, y, z, w, h, d (LutRegion only)
+    std::vector<float> values;    // RGB triplets, matrix or curve points
+};
+
+// Incremental decoder - feed whatever the transport delivered, pull complete messages
+struct LutStreamParser {
+    std::vector<uint8_t> buffer;
+    size_t readPos = 0;
+};
+
+enum class LutStreamResult {
+    NeedMore,        // No complete frame buffered
+    Message,         // msg holds a frame; status says whether its payload was valid
+    FramingError     // Stream is unrecoverable; status says why
+};
+
+void LutStreamFeed(LutStreamParser& p, const uint8_t* data, size_t size);
+LutStreamResult LutStreamNext(LutStreamParser& p, LutStreamMessage& msg, LutStreamStatus& status);
+
+// Client-side encoder and the server's reply (appended to out)
+void LutStreamEncode(const LutStreamMessage& msg, std::vector<uint8_t>& out);
+void LutStreamEncodeAck(uint32_t sequence, LutStreamStatus status, std::vector<uint8_t>& out);
+
+const char* LutStreamStatusName(LutStreamStatus status);
+
+// Server side of one transport read (pipe or socket): feed data, pass each valid message to handle
+// and append one Ack per message to reply. false on a framing error - reply then ends with that
+// Ack and the transport drops the client once it is sent. msg is scratch, reused across calls.
+typedef std::function<LutStreamStatus(const LutStreamMessage&)> LutStreamHandler;
+bool LutStreamServe(LutStreamParser& p, const uint8_t* data, size_t size, const LutStreamHandler& handle,
+                    LutStreamMessage& msg, std::vector<uint8_t>& reply);
+
+// ============================================================================
+// Pending update store (shared by the pipe thread and the render thread under a mutex)
+// ============================================================================
+
+// Latest streamed state for one monitor/mode - a CPU shadow of the live LUT texture
+// plus the box touched since the render thread last uploaded
+struct LiveLutTarget {
+    int monitorIndex = 0;
+    bool isHDR = false;
+
+    int lutSize = 0;               // 0 = no LUT streamed yet
+    std::vector<float> rgba;       // Shadow volume, RGBA (texture layout, alpha = 1)
+    bool sizeChanged = false;      // Texture must be (re)created, whole volume uploaded
+    bool lutDirty = false;
+    int dirtyMin[3] = {};          // Union of pending region updates (inclusive min, exclusive max)
+    int dirtyMax[3] = {};
+
+    bool matrixDirty = false;
+    float matrix[9] = {};
+    bool grayscaleDirty = false;
+    int grayscalePointCount = 0;
+    float grayscalePoints[LUT_STREAM_MAX_GRAYSCALE_POINTS] = {};
+};
+
+struct LiveLutStore {
+    std::vector<LiveLutTarget> targets;
+};
+
+// Merge a validated message into the store (later updates win; regions union their dirty boxes)
+LutStreamStatus LiveLutMerge(LiveLutStore& store, const LutStreamMessage& msg);
+
+// Pending LUT upload for one target, copied out of the shadow so the lock can be released
+struct LiveLutUpload {
+    bool recreate = false;         // New texture of lutSize^3, box covers the whole volume
+    int lutSize = 0;
+    int boxMin[3] = {};
+    int boxMax[3] = {};
+    std::vector<float> rgba;       // Tightly packed box contents (x fastest)
+};
+
+// Take and clear the target's pending LUT change; false if none
+bool LiveLutTakeUpload(LiveLutTarget& target, LiveLutUpload& out);
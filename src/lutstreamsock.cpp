@@ -0,0 +1,130 @@
+// DesktopLUT - lutstreamsock.cpp
+// Live LUT streaming over a Unix-domain socket: the same framing and Acks as the named pipe
+// (lutstream.h), for platforms and tools without named pipes
+
+#include "netsocket.h"
+#ifdef _WIN32
+#include <afunix.h>
+#else
+#include <sys/un.h>
+#endif
+#include "lutstreamsock.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+// Same read size as the pipe (a 65^3 full LUT arrives in several reads)
+static const size_t SOCKET_READ_SIZE = 64 * 1024;
+
+static const int SEND_TIMEOUT_MS = 1000;
+
+static SOCKET g_lutSocket = INVALID_SOCKET;
+static std::string g_lutSocketPath;
+static std::thread g_lutSocketThread;
+static std::atomic<bool> g_lutSocketRunning{ false };
+static LutStreamHandler g_lutSocketHandler;
+
+static bool SendAll(SOCKET s, const uint8_t* data, size_t size) {
+    while (size > 0 && g_lutSocketRunning.load()) {
+        int sent = (int)send(s, (const char*)data, (int)(std::min)(size, (size_t)INT_MAX), NET_SEND_FLAGS);
+        if (sent <= 0) return false;
+        data += sent;
+        size -= (size_t)sent;
+    }
+    return size == 0;
+}
+
+// Serve one connected client until it disconnects, sends garbage, or we stop
+static void ServeClient(SOCKET client) {
+    LutStreamParser parser;
+    LutStreamMessage msg;
+    std::vector<uint8_t> readBuf(SOCKET_READ_SIZE);
+    std::vector<uint8_t> reply;
+    NetSetTimeouts(client, LUT_SOCKET_POLL_MS, SEND_TIMEOUT_MS);
+
+    while (g_lutSocketRunning.load()) {
+        if (!NetWaitReadable(client, LUT_SOCKET_POLL_MS)) continue;
+        int bytesRead = (int)recv(client, (char*)readBuf.data(), (int)readBuf.size(), 0);
+        if (bytesRead <= 0) return;  // Client disconnected
+
+        reply.clear();
+        if (!LutStreamServe(parser, readBuf.data(), (size_t)bytesRead, g_lutSocketHandler, msg, reply)) {
+            SendAll(client, reply.data(), reply.size());
+            return;
+        }
+        if (!reply.empty() && !SendAll(client, reply.data(), reply.size())) return;
+    }
+}
+
+static void LutSocketThreadFunc() {
+    while (g_lutSocketRunning.load()) {
+        if (!NetWaitReadable(g_lutSocket, LUT_SOCKET_POLL_MS)) continue;
+        SOCKET client = accept(g_lutSocket, nullptr, nullptr);
+        if (client == INVALID_SOCKET) continue;
+
+        std::cout << "Live LUT: socket client connected" << std::endl;
+        ServeClient(client);
+        shutdown(client, SD_SEND);
+        closesocket(client);
+        std::cout << "Live LUT: socket client disconnected" << std::endl;
+    }
+}
+
+bool StartLutStreamSocket(const std::string& path, LutStreamHandler handle) {
+    if (g_lutSocketRunning.load()) return true;  // Already running
+
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "Live LUT: socket path too long: " << path << std::endl;
+        return false;
+    }
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+    if (!NetStartup()) {
+        std::cerr << "Live LUT: WSAStartup failed" << std::endl;
+        return false;
+    }
+    g_lutSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (g_lutSocket == INVALID_SOCKET) {
+        std::cerr << "Live LUT: socket failed (" << NetLastError() << ")" << std::endl;
+        NetCleanup();
+        return false;
+    }
+
+    // A previous run that did not stop cleanly leaves the socket file behind
+    std::remove(path.c_str());
+    if (bind(g_lutSocket, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR ||
+        listen(g_lutSocket, 1) == SOCKET_ERROR) {
+        std::cerr << "Live LUT: cannot listen on " << path << " (" << NetLastError() << ")" << std::endl;
+        closesocket(g_lutSocket);
+        g_lutSocket = INVALID_SOCKET;
+        NetCleanup();
+        return false;
+    }
+
+    g_lutSocketPath = path;
+    g_lutSocketHandler = std::move(handle);
+    g_lutSocketRunning.store(true);
+    g_lutSocketThread = std::thread(LutSocketThreadFunc);
+    std::cout << "Live LUT: listening on " << path << std::endl;
+    return true;
+}
+
+void StopLutStreamSocket() {
+    if (!g_lutSocketRunning.load()) return;  // Not running
+
+    g_lutSocketRunning.store(false);
+    if (g_lutSocketThread.joinable()) {
+        g_lutSocketThread.join();
+    }
+    closesocket(g_lutSocket);
+    g_lutSocket = INVALID_SOCKET;
+    std::remove(g_lutSocketPath.c_str());
+    g_lutSocketHandler = nullptr;
+    NetCleanup();
+}
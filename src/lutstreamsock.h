@@ -0,0 +1,16 @@
+// DesktopLUT - lutstreamsock.h
+// Live LUT streaming over a Unix-domain socket: the same framing and Acks as the named pipe
+// (lutstream.h), for platforms and tools without named pipes
+
+#pragma once
+
+#include "lutstream.h"
+#include <string>
+
+// Listen on a Unix-domain socket at path (a stale socket file there is replaced); one client at a
+// time, each valid message goes to handle on the server thread. A client that stops sending is
+// polled, so StopLutStreamSocket returns within about LUT_SOCKET_POLL_MS.
+constexpr int LUT_SOCKET_POLL_MS = 250;
+
+bool StartLutStreamSocket(const std::string& path, LutStreamHandler handle);
+void StopLutStreamSocket();
@@ -4,7 +4,120 @@
 #include "types.h"
 #include "globals.h"
 #include "gui.h"
+#include "benchmark.h"
+#include "faultinject.h"
+#include "dxcalls.h"
 #include <objbase.h>
+#include <shellapi.h>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// ============================================================================
+// Command Line
+// ============================================================================
+
+// Print to the launching console (Windows subsystem has none of its own)
+static void AttachCommandConsole() {
+    if (AttachConsole(ATTACH_PARENT_PROCESS) || AllocConsole()) {
+        FILE* fp;
+        freopen_s(&fp, "CONOUT$", "w", stdout);
+        freopen_s(&fp, "CONOUT$", "w", stderr);
+        std::cout.clear();
+        std::cerr.clear();
+        std::wcout.clear();
+        std::wcerr.clear();
+    }
+}
+
+// DesktopLUT.exe --benchmark [out.json] [--filter name]
+// Runs the CPU microbenchmarks instead of the GUI; returns -1 if not requested
+static int RunBenchmarkCommand() {
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (!argv) return -1;
+    if (argc < 2 || wcscmp(argv[1], L"--benchmark") != 0) {
+        LocalFree(argv);
+        return -1;
+    }
+
+    std::wstring outPath = L"DesktopLUT-benchmark.json";
+    std::wstring filter;
+    for (int i = 2; i < argc; i++) {
+        if (wcscmp(argv[i], L"--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            outPath = argv[i];
+        }
+    }
+    LocalFree(argv);
+
+    AttachCommandConsole();
+    return RunBenchmarks(outPath, filter);
+}
+
+// DesktopLUT.exe --fault-sim script.txt [--refresh hz] [--minutes n]
+// Runs a fault script against the simulated render loop under a few backoff policies and
+// prints time-to-recover and frames lost per fault type; returns -1 if not requested
+static int RunFaultSimCommand() {
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (!argv) return -1;
+    if (argc < 3 || wcscmp(argv[1], L"--fault-sim") != 0) {
+        LocalFree(argv);
+        return -1;
+    }
+
+    std::wstring scriptPath = argv[2];
+    FaultSimConfig config;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (wcscmp(argv[i], L"--refresh") == 0) {
+            double hz = _wtof(argv[i + 1]);
+            if (hz > 0.0) config.refreshMs = 1000.0 / hz;
+        } else if (wcscmp(argv[i], L"--minutes") == 0) {
+            double minutes = _wtof(argv[i + 1]);
+            if (minutes > 0.0) config.durationMs = minutes * 60000.0;
+        }
+    }
+    LocalFree(argv);
+
+    AttachCommandConsole();
+    std::ifstream file(scriptPath);
+    std::stringstream text;
+    text << file.rdbuf();
+    FaultScript script;
+    std::string error;
+    if (!file || !ParseFaultScript(text.str(), script, error)) {
+        std::cerr << "Fault script " << (file ? error : std::string("not found")) << std::endl;
+        return 1;
+    }
+
+    // Current policy first, then faster and slower first retries for comparison
+    const BackoffPolicy policies[] = { DUPLICATION_BACKOFF, { 16, 5000, 9 }, { 100, 5000, 6 }, { 50, 2000, 6 } };
+    for (const auto& policy : policies) {
+        config.backoff = policy;
+        std::cout << "Backoff " << policy.initialMs << " ms doubling to " << policy.maxMs << " ms"
+                  << (&policy == &policies[0] ? " (current)" : "") << std::endl;
+        std::cout << FormatFaultReport(SimulateFaults(script, config)) << std::endl;
+    }
+    return 0;
+}
+
+#if DESKTOPLUT_FAULT_INJECTION
+// DesktopLUT.exe --faults script.txt: run normally with the fault script armed
+static void LoadFaultScriptCommand() {
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (!argv) return;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (wcscmp(argv[i], L"--faults") == 0) {
+            LoadFaultScript(argv[i + 1]);
+        }
+    }
+    LocalFree(argv);
+}
+#endif
 
 // ============================================================================
 // Entry Point (Windows subsystem)
@@ -16,6 +129,16 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLi
     // Initialize COM for DirectComposition and shell APIs
     CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
 
+    // Benchmarks run alongside a live instance and never show the GUI
+    int benchmarkResult = RunBenchmarkCommand();
+    if (benchmarkResult >= 0) {
+        return benchmarkResult;
+    }
+    int faultSimResult = RunFaultSimCommand();
+    if (faultSimResult >= 0) {
+        return faultSimResult;
+    }
+
     // Single instance check - prevent multiple copies from running
     g_singleInstanceMutex = CreateMutexW(nullptr, TRUE, L"DesktopLUT_SingleInstance_Mutex");
     if (GetLastError() == ERROR_ALREADY_EXISTS) {
@@ -29,6 +152,10 @@ int WINAPI wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPWSTR lpCmdLi
         return 0;
     }
 
+#if DESKTOPLUT_FAULT_INJECTION
+    LoadFaultScriptCommand();
+#endif
+
     int result = RunGUI();
     CloseHandle(g_singleInstanceMutex);
     return result;
@@ -0,0 +1,225 @@
+// DesktopLUT - metrics.cpp
+// Metrics registry (lock-free counters, gauges, histograms) and Prometheus text serializer
+
+#include "metrics.h"
+#include <cstdio>
+
+// Frame time buckets (ms) - refresh periods from 240Hz to 30Hz plus stall territory
+static const double FRAME_TIME_BOUNDS_MS[] = { 4.2, 7.0, 8.4, 11.2, 16.8, 25.0, 33.4, 50.0, 100.0, 250.0, 1000.0 };
+static const int FRAME_TIME_BOUND_COUNT = sizeof(FRAME_TIME_BOUNDS_MS) / sizeof(FRAME_TIME_BOUNDS_MS[0]);
+
+// LUT load buckets (ms) - 17^3 loads in a few ms, 65^3 text parses take hundreds
+static const double LUT_LOAD_BOUNDS_MS[] = { 5.0, 10.0, 25.0, 50.0, 100.0, 250.0, 500.0, 1000.0, 2500.0 };
+static const int LUT_LOAD_BOUND_COUNT = sizeof(LUT_LOAD_BOUNDS_MS) / sizeof(LUT_LOAD_BOUNDS_MS[0]);
+
+// Device recovery buckets (ms) - a manifest replay takes tens of ms, a full reinit far longer
+static const double RECOVERY_BOUNDS_MS[] = { 25.0, 50.0, 100.0, 250.0, 500.0, 1000.0, 2500.0, 5000.0 };
+static const int RECOVERY_BOUND_COUNT = sizeof(RECOVERY_BOUNDS_MS) / sizeof(RECOVERY_BOUNDS_MS[0]);
+
+MonitorMetrics::MonitorMetrics()
+    : frameTimeMs(FRAME_TIME_BOUNDS_MS, FRAME_TIME_BOUND_COUNT) {}
+
+MetricsRegistry::MetricsRegistry()
+    : lutLoadMs(LUT_LOAD_BOUNDS_MS, LUT_LOAD_BOUND_COUNT),
+      recoveryMs(RECOVERY_BOUNDS_MS, RECOVERY_BOUND_COUNT) {}
+
+void MetricObserve(MetricHistogram& h, double v) {
+    int bucket = 0;
+    while (bucket < h.boundCount && v > h.bounds[bucket]) bucket++;
+    h.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    h.sum.fetch_add(v, std::memory_order_relaxed);
+}
+
+MonitorMetrics* MetricsAttachMonitor(MetricsRegistry& r, int monitorIndex) {
+    MonitorMetrics* m = (monitorIndex >= 0 && monitorIndex < METRICS_MAX_MONITORS)
+        ? &r.monitors[monitorIndex] : &r.unattached;
+    if (m != &r.unattached) {
+        m->active.store(true, std::memory_order_release);
+    }
+    return m;
+}
+
+void MetricsDetachMonitor(MonitorMetrics* m) {
+    if (m) m->active.store(false, std::memory_order_release);
+}
+
+// ============================================================================
+// Serializer
+// ============================================================================
+
+struct MonitorCounterDesc {
+    const char* name;
+    const char* help;
+    MetricCounter MonitorMetrics::* field;
+};
+
+static const MonitorCounterDesc MONITOR_COUNTERS[] = {
+    { "desktoplut_frames_rendered_total", "Frames presented to the overlay swapchain", &MonitorMetrics::framesRendered },
+    { "desktoplut_frames_skipped_total", "Desktop updates coalesced by desktop duplication before capture", &MonitorMetrics::framesSkipped },
+    { "desktoplut_access_lost_total", "Desktop duplication acquire failures (ACCESS_LOST, secure desktop)", &MonitorMetrics::accessLost },
+    { "desktoplut_duplication_recoveries_total", "Desktop duplication reinits after a loss", &MonitorMetrics::duplicationRecoveries },
+    { "desktoplut_analysis_dispatches_total", "Frame analysis dispatches granted by the scheduler", &MonitorMetrics::analysisDispatches },
+    { "desktoplut_analysis_deferrals_total", "Render loop passes a due analysis dispatch waited for GPU budget", &MonitorMetrics::analysisDeferrals },
+};
+
+struct MonitorGaugeDesc {
+    const char* name;
+    const char* help;
+    MetricGauge MonitorMetrics::* field;
+};
+
+static const MonitorGaugeDesc MONITOR_GAUGES[] = {
+    { "desktoplut_peak_nits", "Last dynamic peak detection readback (nits)", &MonitorMetrics::peakNits },
+    { "desktoplut_analysis_interval", "Current adaptive frame analysis interval (render loop passes)", &MonitorMetrics::analysisInterval },
+    { "desktoplut_analysis_gpu_ms", "Smoothed GPU time of one frame analysis dispatch (ms)", &MonitorMetrics::analysisGpuMs },
+};
+
+struct GlobalCounterDesc {
+    const char* name;
+    const char* help;
+    MetricCounter MetricsRegistry::* field;
+};
+
+static const GlobalCounterDesc GLOBAL_COUNTERS[] = {
+    { "desktoplut_tdr_recoveries_total", "GPU device-lost recoveries that succeeded", &MetricsRegistry::tdrRecoveries },
+    { "desktoplut_tdr_recovery_failures_total", "GPU device-lost recoveries that failed", &MetricsRegistry::tdrRecoveryFailures },
+    { "desktoplut_watchdog_trips_total", "Render watchdog timeouts", &MetricsRegistry::watchdogTrips },
+    { "desktoplut_gamma_whitelist_scans_total", "Process scans by the gamma whitelist thread", &MetricsRegistry::gammaWhitelistScans },
+    { "desktoplut_vrr_whitelist_scans_total", "Process scans by the VRR whitelist thread", &MetricsRegistry::vrrWhitelistScans },
+    { "desktoplut_correction_submits_total", "Live color correction changes submitted by the GUI", &MetricsRegistry::correctionSubmits },
+    { "desktoplut_lut_load_failures_total", "LUT files that failed to load", &MetricsRegistry::lutLoadFailures },
+    { "desktoplut_lut_stack_compositions_total", "LUT stacks composed into a single texture", &MetricsRegistry::lutStackCompositions },
+};
+
+static void AppendHeader(std::string& out, const char* name, const char* type, const char* help) {
+    out += "# HELP ";
+    out += name;
+    out += ' ';
+    out += help;
+    out += "\n# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+// name{labels} value - labels may be empty
+static void AppendSample(std::string& out, const char* name, const char* suffix, const char* labels, const char* value) {
+    out += name;
+    out += suffix;
+    if (labels[0]) {
+        out += '{';
+        out += labels;
+        out += '}';
+    }
+    out += ' ';
+    out += value;
+    out += '\n';
+}
+
+static void FormatUint(char* buf, size_t size, uint64_t v) {
+    snprintf(buf, size, "%llu", (unsigned long long)v);
+}
+
+static void FormatDouble(char* buf, size_t size, double v) {
+    snprintf(buf, size, "%.9g", v);
+}
+
+// name_bucket{labels,le="bound"} value - appended directly, labels can be any length
+static void AppendBucket(std::string& out, const char* name, const char* labels, const char* le, const char* value) {
+    out += name;
+    out += "_bucket{";
+    if (labels[0]) {
+        out += labels;
+        out += ',';
+    }
+    out += "le=\"";
+    out += le;
+    out += "\"} ";
+    out += value;
+    out += '\n';
+}
+
+// Cumulative buckets, _sum and _count (each bucket is read once, so cumulative counts never decrease)
+static void AppendHistogram(std::string& out, const char* name, const char* labels, const MetricHistogram& h) {
+    char value[32], le[32];
+    uint64_t cumulative = 0;
+    for (int i = 0; i <= h.boundCount; i++) {
+        cumulative += h.buckets[i].load(std::memory_order_relaxed);
+        if (i < h.boundCount) {
+            FormatDouble(le, sizeof(le), h.bounds[i]);
+        } else {
+            snprintf(le, sizeof(le), "+Inf");
+        }
+        FormatUint(value, sizeof(value), cumulative);
+        AppendBucket(out, name, labels, le, value);
+    }
+    FormatDouble(value, sizeof(value), h.sum.load(std::memory_order_relaxed));
+    AppendSample(out, name, "_sum", labels, value);
+    // _count is the +Inf bucket by definition
+    FormatUint(value, sizeof(value), cumulative);
+    AppendSample(out, name, "_count", labels, value);
+}
+
+void SerializeMetrics(const MetricsRegistry& r, std::string& out) {
+    out.clear();
+    char value[32];
+
+    // Label strings for attached monitors
+    char monitorLabels[METRICS_MAX_MONITORS][24];
+    bool active[METRICS_MAX_MONITORS];
+    int activeCount = 0;
+    for (int m = 0; m < METRICS_MAX_MONITORS; m++) {
+        active[m] = r.monitors[m].active.load(std::memory_order_acquire);
+        snprintf(monitorLabels[m], sizeof(monitorLabels[m]), "monitor=\"%d\"", m);
+        if (active[m]) activeCount++;
+    }
+
+    AppendHeader(out, "desktoplut_monitors_active", "gauge", "Monitors currently processed");
+    FormatUint(value, sizeof(value), (uint64_t)activeCount);
+    AppendSample(out, "desktoplut_monitors_active", "", "", value);
+
+    for (const auto& desc : MONITOR_COUNTERS) {
+        AppendHeader(out, desc.name, "counter", desc.help);
+        for (int m = 0; m < METRICS_MAX_MONITORS; m++) {
+            if (!active[m]) continue;
+            FormatUint(value, sizeof(value), (r.monitors[m].*desc.field).value.load(std::memory_order_relaxed));
+            AppendSample(out, desc.name, "", monitorLabels[m], value);
+        }
+    }
+
+    for (const auto& desc : MONITOR_GAUGES) {
+        AppendHeader(out, desc.name, "gauge", desc.help);
+        for (int m = 0; m < METRICS_MAX_MONITORS; m++) {
+            if (!active[m]) continue;
+            FormatDouble(value, sizeof(value), (r.monitors[m].*desc.field).value.load(std::memory_order_relaxed));
+            AppendSample(out, desc.name, "", monitorLabels[m], value);
+        }
+    }
+
+    AppendHeader(out, "desktoplut_frame_time_ms", "histogram", "Present-to-present interval (ms)");
+    for (int m = 0; m < METRICS_MAX_MONITORS; m++) {
+        if (!active[m]) continue;
+        AppendHistogram(out, "desktoplut_frame_time_ms", monitorLabels[m], r.monitors[m].frameTimeMs);
+    }
+
+    for (const auto& desc : GLOBAL_COUNTERS) {
+        AppendHeader(out, desc.name, "counter", desc.help);
+        FormatUint(value, sizeof(value), (r.*desc.field).value.load(std::memory_order_relaxed));
+        AppendSample(out, desc.name, "", "", value);
+    }
+
+    AppendHeader(out, "desktoplut_lut_load_ms", "histogram", "LUT file load and parse time (ms)");
+    AppendHistogram(out, "desktoplut_lut_load_ms", "", r.lutLoadMs);
+
+    AppendHeader(out, "desktoplut_lut_stack_max_error", "gauge", "Last composed LUT stack's worst deviation from sequential application (0-1 signal)");
+    FormatDouble(value, sizeof(value), r.lutStackMaxError.value.load(std::memory_order_relaxed));
+    AppendSample(out, "desktoplut_lut_stack_max_error", "", "", value);
+
+    AppendHeader(out, "desktoplut_lut_stack_max_delta_e", "gauge", "Last composed LUT stack's worst deviation as CIEDE2000 (SDR) or Delta E ITP (HDR)");
+    FormatDouble(value, sizeof(value), r.lutStackMaxDeltaE.value.load(std::memory_order_relaxed));
+    AppendSample(out, "desktoplut_lut_stack_max_delta_e", "", "", value);
+
+    AppendHeader(out, "desktoplut_recovery_ms", "histogram", "GPU device-loss rebuild time (ms)");
+    AppendHistogram(out, "desktoplut_recovery_ms", "", r.recoveryMs);
+}
@@ -0,0 +1,87 @@
+// DesktopLUT - metrics.h
+// Metrics registry (lock-free counters, gauges, histograms) and Prometheus text serializer
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Per-monitor slots are indexed by display index (monitors beyond this share an unexported slot)
+constexpr int METRICS_MAX_MONITORS = 16;
+
+// Histogram upper bounds per metric (the +Inf bucket is implicit)
+constexpr int METRICS_MAX_BUCKETS = 12;
+
+// All updates are relaxed atomics - safe from any thread, no locks, no allocation
+// Values are monotonic for the process lifetime (processing restarts don't reset them)
+struct MetricCounter {
+    std::atomic<uint64_t> value{ 0 };
+};
+
+struct MetricGauge {
+    std::atomic<double> value{ 0.0 };
+};
+
+struct MetricHistogram {
+    const double* bounds;                                  // Ascending upper bounds (le)
+    int boundCount;
+    std::atomic<uint64_t> buckets[METRICS_MAX_BUCKETS + 1] = {};  // Per-bucket (not cumulative), last = +Inf
+    std::atomic<double> sum{ 0.0 };
+
+    MetricHistogram(const double* b, int n) : bounds(b), boundCount(n < METRICS_MAX_BUCKETS ? n : METRICS_MAX_BUCKETS) {}
+};
+
+// Render-thread metrics for one monitor
+struct MonitorMetrics {
+    MonitorMetrics();
+
+    std::atomic<bool> active{ false };   // Exported while a MonitorContext is attached
+    MetricCounter framesRendered;        // Successful Present calls
+    MetricCounter framesSkipped;         // Desktop updates coalesced by duplication (AccumulatedFrames - 1)
+    MetricCounter accessLost;            // AcquireNextFrame failures (ACCESS_LOST, secure desktop, ...)
+    MetricCounter duplicationRecoveries; // Successful duplication reinits after a loss
+    MetricCounter analysisDispatches;    // Analysis dispatches granted by the scheduler
+    MetricCounter analysisDeferrals;     // Passes an analysis dispatch was due but over the GPU budget
+    MetricGauge peakNits;                // Last dynamic peak readback
+    MetricGauge analysisInterval;        // Current adaptive analysis interval (render loop passes)
+    MetricGauge analysisGpuMs;           // Smoothed GPU time of one analysis dispatch
+    MetricHistogram frameTimeMs;         // Present-to-present interval
+};
+
+struct MetricsRegistry {
+    MetricsRegistry();
+
+    MonitorMetrics monitors[METRICS_MAX_MONITORS];
+    MonitorMetrics unattached;           // Sink for display indices >= METRICS_MAX_MONITORS
+
+    MetricCounter tdrRecoveries;         // Device-lost recoveries that succeeded
+    MetricCounter tdrRecoveryFailures;
+    MetricCounter watchdogTrips;
+    MetricCounter gammaWhitelistScans;   // Process snapshots taken by the whitelist threads
+    MetricCounter vrrWhitelistScans;
+    MetricCounter correctionSubmits;     // Live color correction changes from the GUI
+    MetricCounter lutLoadFailures;
+    MetricHistogram lutLoadMs;           // .cube parse time
+    MetricCounter lutStackCompositions;  // LUT stacks composed (cached stacks with unchanged members don't count)
+    MetricGauge lutStackMaxError;        // Last composed stack vs sequential application (0-1 signal)
+    MetricGauge lutStackMaxDeltaE;       // Same, as CIEDE2000 (SDR) or Delta E ITP (HDR)
+    MetricHistogram recoveryMs;          // Device-loss rebuild time (after the driver settle wait)
+};
+
+inline void MetricInc(MetricCounter& c, uint64_t n = 1) {
+    c.value.fetch_add(n, std::memory_order_relaxed);
+}
+
+inline void MetricSet(MetricGauge& g, double v) {
+    g.value.store(v, std::memory_order_relaxed);
+}
+
+void MetricObserve(MetricHistogram& h, double v);
+
+// Slot for a display index; marks it active so it is exported
+MonitorMetrics* MetricsAttachMonitor(MetricsRegistry& r, int monitorIndex);
+void MetricsDetachMonitor(MonitorMetrics* m);
+
+// Prometheus text exposition format 0.0.4 (replaces out's contents, reuses its capacity)
+void SerializeMetrics(const MetricsRegistry& r, std::string& out);
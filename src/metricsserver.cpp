@@ -0,0 +1,138 @@
+// DesktopLUT - metricsserver.cpp
+// Localhost HTTP endpoint serving g_metrics in Prometheus text format
+
+#include "netsocket.h"
+#include "metricsserver.h"
+#include "metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Accept poll interval - bounds StopMetricsServer latency
+static const int ACCEPT_POLL_MS = 250;
+
+// Scrapers send a short GET; anything past this is ignored
+static const int REQUEST_BUFFER_SIZE = 2048;
+
+// Per-call socket timeouts: a stalled client (not sending its request, not reading the response)
+// is dropped after this, and the loops below also give up once the server is stopping
+static const int RECEIVE_TIMEOUT_MS = 1000;
+static const int SEND_TIMEOUT_MS = 1000;
+
+static SOCKET g_listenSocket = INVALID_SOCKET;
+static std::thread g_metricsThread;
+static std::atomic<bool> g_metricsRunning{ false };
+static const MetricsRegistry* g_metricsRegistry = nullptr;
+
+static void SendAll(SOCKET s, const char* data, size_t size) {
+    while (size > 0 && g_metricsRunning.load()) {
+        int sent = (int)send(s, data, (int)(std::min)(size, (size_t)INT_MAX), NET_SEND_FLAGS);
+        if (sent <= 0) return;
+        data += sent;
+        size -= (size_t)sent;
+    }
+}
+
+static void ServeClient(SOCKET client, std::string& body, std::string& response) {
+    NetSetTimeouts(client, RECEIVE_TIMEOUT_MS, SEND_TIMEOUT_MS);
+
+    // Read until end of headers (request line is all we look at)
+    char request[REQUEST_BUFFER_SIZE];
+    int received = 0;
+    while (received < REQUEST_BUFFER_SIZE - 1 && g_metricsRunning.load()) {
+        int n = (int)recv(client, request + received, REQUEST_BUFFER_SIZE - 1 - received, 0);
+        if (n <= 0) break;
+        received += n;
+        request[received] = 0;
+        if (strstr(request, "\r\n\r\n")) break;
+    }
+    request[received] = 0;
+
+    bool isGet = strncmp(request, "GET ", 4) == 0;
+    bool isHead = strncmp(request, "HEAD ", 5) == 0;
+    if (isGet || isHead) {
+        SerializeMetrics(*g_metricsRegistry, body);
+        char header[160];
+        snprintf(header, sizeof(header),
+            "HTTP/1.0 200 OK\r\n"
+            "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+            "Content-Length: %zu\r\n"
+            "Connection: close\r\n\r\n", body.size());
+        response = header;
+        if (isGet) response += body;
+    } else {
+        response = "HTTP/1.0 405 Method Not Allowed\r\nAllow: GET, HEAD\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+    }
+    SendAll(client, response.data(), response.size());
+    shutdown(client, SD_SEND);
+}
+
+static void MetricsThreadFunc() {
+    // Reused across scrapes (no per-request allocation once warmed up)
+    std::string body, response;
+
+    while (g_metricsRunning.load()) {
+        if (!NetWaitReadable(g_listenSocket, ACCEPT_POLL_MS)) continue;
+
+        SOCKET client = accept(g_listenSocket, nullptr, nullptr);
+        if (client == INVALID_SOCKET) continue;
+        ServeClient(client, body, response);
+        closesocket(client);
+    }
+}
+
+bool StartMetricsServer(int port, const MetricsRegistry& registry) {
+    if (g_metricsRunning.load()) return true;  // Already running
+    if (port <= 0 || port > 65535) return false;
+
+    if (!NetStartup()) {
+        std::cerr << "Metrics: WSAStartup failed" << std::endl;
+        return false;
+    }
+
+    g_listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (g_listenSocket == INVALID_SOCKET) {
+        std::cerr << "Metrics: socket failed (" << NetLastError() << ")" << std::endl;
+        NetCleanup();
+        return false;
+    }
+    NetAllowRebind(g_listenSocket);
+
+    // Loopback only - the endpoint is unauthenticated
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (bind(g_listenSocket, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR ||
+        listen(g_listenSocket, SOMAXCONN) == SOCKET_ERROR) {
+        std::cerr << "Metrics: cannot listen on 127.0.0.1:" << port << " (" << NetLastError() << ")" << std::endl;
+        closesocket(g_listenSocket);
+        g_listenSocket = INVALID_SOCKET;
+        NetCleanup();
+        return false;
+    }
+
+    g_metricsRegistry = &registry;
+    g_metricsRunning.store(true);
+    g_metricsThread = std::thread(MetricsThreadFunc);
+    std::cout << "Metrics: serving http://127.0.0.1:" << port << "/metrics" << std::endl;
+    return true;
+}
+
+void StopMetricsServer() {
+    if (!g_metricsRunning.load()) return;  // Not running
+
+    g_metricsRunning.store(false);
+    if (g_metricsThread.joinable()) {
+        g_metricsThread.join();
+    }
+    closesocket(g_listenSocket);
+    g_listenSocket = INVALID_SOCKET;
+    NetCleanup();
+}
@@ -0,0 +1,12 @@
+// DesktopLUT - metricsserver.h
+// Localhost HTTP endpoint serving g_metrics in Prometheus text format
+
+#pragma once
+
+struct MetricsRegistry;
+
+// Listen on 127.0.0.1:port (port 0 = disabled); any GET returns the registry's metrics page
+// Runs on its own thread - safe to call from the GUI thread at startup/exit. A client that stops
+// reading or writing is dropped after a timeout, so StopMetricsServer returns within about a second.
+bool StartMetricsServer(int port, const MetricsRegistry& registry);
+void StopMetricsServer();
@@ -0,0 +1,100 @@
+// DesktopLUT - netsocket.h
+// The few socket calls the loopback endpoints use, on Winsock or BSD sockets, so those endpoints
+// and their tests also build and run on Linux
+
+#pragma once
+
+#ifdef _WIN32
+// Winsock2 must come before windows.h - same lean/NOMINMAX setup as types.h
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+typedef int SOCKET;
+constexpr SOCKET INVALID_SOCKET = -1;
+constexpr int SOCKET_ERROR = -1;
+constexpr int SD_SEND = SHUT_WR;
+
+inline int closesocket(SOCKET s) { return close(s); }
+#endif
+
+// A peer that has gone away fails the send instead of raising SIGPIPE
+#ifdef MSG_NOSIGNAL
+constexpr int NET_SEND_FLAGS = MSG_NOSIGNAL;
+#else
+constexpr int NET_SEND_FLAGS = 0;
+#endif
+
+// WSAStartup / WSACleanup (nothing to do on BSD sockets); calls nest
+inline bool NetStartup() {
+#ifdef _WIN32
+    WSADATA wsaData;
+    return WSAStartup(MAKEWORD(2, 2), &wsaData) == 0;
+#else
+    return true;
+#endif
+}
+
+inline void NetCleanup() {
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+// Last socket error code, for logging
+inline int NetLastError() {
+#ifdef _WIN32
+    return WSAGetLastError();
+#else
+    return errno;
+#endif
+}
+
+// Per-call receive / send timeouts
+inline void NetSetTimeouts(SOCKET s, int receiveMs, int sendMs) {
+#ifdef _WIN32
+    DWORD receiveTimeout = (DWORD)receiveMs;
+    DWORD sendTimeout = (DWORD)sendMs;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, (const char*)&receiveTimeout, sizeof(receiveTimeout));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, (const char*)&sendTimeout, sizeof(sendTimeout));
+#else
+    timeval receiveTimeout = { receiveMs / 1000, (receiveMs % 1000) * 1000 };
+    timeval sendTimeout = { sendMs / 1000, (sendMs % 1000) * 1000 };
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &receiveTimeout, sizeof(receiveTimeout));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+#endif
+}
+
+// Let a restarted listener bind while the last run's connections sit in TIME_WAIT. BSD sockets
+// only: on Winsock SO_REUSEADDR would let another process take over a port in use.
+inline void NetAllowRebind(SOCKET s) {
+#ifndef _WIN32
+    int on = 1;
+    setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+#else
+    (void)s;
+#endif
+}
+
+// Wait up to timeoutMs for s to become readable (a pending accept or data); false on timeout
+inline bool NetWaitReadable(SOCKET s, int timeoutMs) {
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(s, &readSet);
+    timeval tv = { timeoutMs / 1000, (timeoutMs % 1000) * 1000 };
+    // nfds is ignored by Winsock
+    return select((int)s + 1, &readSet, nullptr, nullptr, &tv) > 0;
+}
@@ -0,0 +1,123 @@
+// DesktopLUT - presentstats.cpp
+// Present statistics: maps DXGI frame statistics onto the vblank timeline to count
+// late, missed and duplicate presents and measure present-to-vblank latency
+
+#include "presentstats.h"
+#include <cmath>
+
+static const PresentRecord* FindPresent(const PresentAccounting& acc, uint32_t presentId) {
+    uint32_t available = acc.historyCount < PRESENT_HISTORY_SIZE ? acc.historyCount : PRESENT_HISTORY_SIZE;
+    for (uint32_t i = 1; i <= available; i++) {
+        const PresentRecord& rec = acc.history[(acc.historyCount - i) % PRESENT_HISTORY_SIZE];
+        if (rec.presentId == presentId) return &rec;
+    }
+    return nullptr;
+}
+
+// Half a refresh of slack absorbs timer jitter around the budget boundary
+static double Overshoot(double latencyMs, double refreshPeriodMs) {
+    return latencyMs / refreshPeriodMs - PRESENT_LATENCY_BUDGET_REFRESHES;
+}
+
+static bool IsLate(double latencyMs, double refreshPeriodMs) {
+    return Overshoot(latencyMs, refreshPeriodMs) > 0.5;
+}
+
+// Latency bucket, lateness and rolling window for one displayed present
+static void ClassifyShownPresent(PresentAccounting& acc, double latencyMs, double refreshPeriodMs) {
+    if (latencyMs < 0.0) latencyMs = 0.0;  // Clock skew between QPC sources
+
+    int bucket = (int)(latencyMs / refreshPeriodMs);
+    if (bucket >= PRESENT_LATENCY_BUCKETS) bucket = PRESENT_LATENCY_BUCKETS - 1;
+    acc.latencyBuckets[bucket]++;
+
+    double overshoot = Overshoot(latencyMs, refreshPeriodMs);
+    if (overshoot > 0.5) {
+        acc.late++;
+        acc.missedRefreshes += (uint64_t)std::ceil(overshoot - 0.5);
+    }
+
+    acc.latencyMs[acc.latencyIndex] = (float)latencyMs;
+    acc.latencyIndex = (acc.latencyIndex + 1) % PRESENT_LATENCY_WINDOW;
+    if (acc.latencyCount < PRESENT_LATENCY_WINDOW) acc.latencyCount++;
+}
+
+void PresentStatsOnPresent(PresentAccounting& acc, uint32_t presentId, double cpuTimeMs) {
+    acc.history[acc.historyCount % PRESENT_HISTORY_SIZE] = { presentId, cpuTimeMs };
+    acc.historyCount++;
+}
+
+void PresentStatsReset(PresentAccounting& acc) {
+    acc.haveLast = false;
+}
+
+void PresentStatsOnSample(PresentAccounting& acc, const PresentStatsSample& sample, double refreshPeriodMs) {
+    if (refreshPeriodMs <= 0.0) return;
+
+    // First sample (or after a disjoint) only establishes the baseline
+    if (!acc.haveLast) {
+        acc.haveLast = true;
+        acc.lastPresentCount = sample.presentCount;
+        acc.lastPresentRefresh = sample.presentRefreshCount;
+        return;
+    }
+
+    // Unsigned deltas so counter wraparound is harmless; no new present shown yet
+    uint32_t presents = sample.presentCount - acc.lastPresentCount;
+    uint32_t refreshes = sample.presentRefreshCount - acc.lastPresentRefresh;
+    if (presents == 0 || presents > 0x80000000u) return;
+
+    // Each vblank can show at most one present: any excess was overwritten unseen
+    uint32_t shown = presents < refreshes ? presents : refreshes;
+    if (shown == 0) shown = 1;  // Same-vblank report of a newer present (driver quirk) - count it once
+    acc.duplicates += presents - shown;
+    acc.displayed += shown;
+    acc.lastPresentCount = sample.presentCount;
+    acc.lastPresentRefresh = sample.presentRefreshCount;
+
+    // Only the newest shown present has a known vblank (presentRefreshCount); the older ones
+    // went up in order on earlier vblanks of this batch. Walking back from the newest: a late
+    // present was waiting in the queue behind its predecessor, which therefore went up on the
+    // vblank just before it; a present on time leaves its predecessor on the vblank the budget
+    // allows it. A backed-up queue thus counts every present in it as late, not just the one
+    // the sample names. Presents overwritten unseen are taken to be the oldest of the batch.
+    double newestVblankMs = sample.syncTimeMs -
+        (double)(int32_t)(sample.syncRefreshCount - sample.presentRefreshCount) * refreshPeriodMs;
+    uint32_t count = shown < PRESENT_HISTORY_SIZE ? shown : PRESENT_HISTORY_SIZE;   // Older can't be matched
+    int32_t lowest = -(int32_t)refreshes + (int32_t)(shown - count);    // Vblanks relative to the newest
+    const PresentRecord* recs[PRESENT_HISTORY_SIZE];
+    int32_t vblanks[PRESENT_HISTORY_SIZE];
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t i = count - 1 - k;                                     // Oldest first
+        recs[i] = FindPresent(acc, sample.presentCount - k);
+        if (k == 0) {
+            vblanks[i] = 0;
+            continue;
+        }
+        int32_t vblank = vblanks[i + 1] - 1;
+        const PresentRecord* newer = recs[i + 1];
+        bool newerWaited = !newer || IsLate(newestVblankMs + vblanks[i + 1] * refreshPeriodMs - newer->cpuTimeMs, refreshPeriodMs);
+        if (!newerWaited && recs[i]) {
+            int32_t onTime = (int32_t)std::floor((recs[i]->cpuTimeMs - newestVblankMs) / refreshPeriodMs) + PRESENT_LATENCY_BUDGET_REFRESHES;
+            if (onTime < vblank) vblank = onTime;
+        }
+        if (vblank <= lowest + (int32_t)i) vblank = lowest + (int32_t)i + 1;   // Older shown presents need room
+        vblanks[i] = vblank;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (recs[i]) ClassifyShownPresent(acc, newestVblankMs + vblanks[i] * refreshPeriodMs - recs[i]->cpuTimeMs, refreshPeriodMs);
+    }
+}
+
+void PresentStatsLatency(const PresentAccounting& acc, float& avgMs, float& maxMs) {
+    avgMs = 0.0f;
+    maxMs = 0.0f;
+    if (acc.latencyCount == 0) return;
+
+    float sum = 0.0f;
+    for (int i = 0; i < acc.latencyCount; i++) {
+        sum += acc.latencyMs[i];
+        if (acc.latencyMs[i] > maxMs) maxMs = acc.latencyMs[i];
+    }
+    avgMs = sum / acc.latencyCount;
+}
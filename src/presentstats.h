@@ -0,0 +1,67 @@
+// DesktopLUT - presentstats.h
+// Present statistics: maps DXGI frame statistics onto the vblank timeline to count
+// late, missed and duplicate presents and measure present-to-vblank latency
+
+#pragma once
+
+#include <cstdint>
+
+// Recent presents remembered for matching against frame statistics (power of two)
+constexpr int PRESENT_HISTORY_SIZE = 64;
+
+// Latency window for avg/max (most recent displayed presents)
+constexpr int PRESENT_LATENCY_WINDOW = 64;
+
+// A composed flip-model present normally reaches the screen within this many refreshes
+// (DWM composes on the next vblank and scans out on the one after); anything later is late
+constexpr int PRESENT_LATENCY_BUDGET_REFRESHES = 2;
+
+// Latency histogram buckets in refresh periods: <1, 1-2, 2-3, 3+
+constexpr int PRESENT_LATENCY_BUCKETS = 4;
+
+// One frame statistics sample (DXGI_FRAME_STATISTICS with times converted to ms)
+struct PresentStatsSample {
+    uint32_t presentCount;         // Last present the display has shown
+    uint32_t presentRefreshCount;  // Vblank at which that present was shown
+    uint32_t syncRefreshCount;     // Vblank the sample refers to
+    double syncTimeMs;             // Time of that vblank
+};
+
+struct PresentRecord {
+    uint32_t presentId;
+    double cpuTimeMs;
+};
+
+// Per-monitor accounting (render thread only)
+struct PresentAccounting {
+    PresentRecord history[PRESENT_HISTORY_SIZE] = {};
+    uint32_t historyCount = 0;          // Total presents recorded (index = count % size)
+
+    bool haveLast = false;              // Baseline for deltas (reset on disjoint stats)
+    uint32_t lastPresentCount = 0;
+    uint32_t lastPresentRefresh = 0;
+
+    // Totals since start
+    uint64_t displayed = 0;             // Presents that reached the screen
+    uint64_t late = 0;                  // Displayed past the latency budget
+    uint64_t missedRefreshes = 0;       // Refreshes lost to late presents (sum of overshoot)
+    uint64_t duplicates = 0;            // Presents superseded before any vblank showed them
+    uint64_t latencyBuckets[PRESENT_LATENCY_BUCKETS] = {};
+
+    // Rolling latency window
+    float latencyMs[PRESENT_LATENCY_WINDOW] = {};
+    int latencyIndex = 0;
+    int latencyCount = 0;
+};
+
+// Record a present we just issued (presentId from IDXGISwapChain::GetLastPresentCount)
+void PresentStatsOnPresent(PresentAccounting& acc, uint32_t presentId, double cpuTimeMs);
+
+// Fold in a frame statistics sample; refreshPeriodMs is the output's refresh period
+void PresentStatsOnSample(PresentAccounting& acc, const PresentStatsSample& sample, double refreshPeriodMs);
+
+// Statistics became discontinuous (mode change, occlusion, DXGI_ERROR_FRAME_STATISTICS_DISJOINT)
+void PresentStatsReset(PresentAccounting& acc);
+
+// Rolling latency over the last PRESENT_LATENCY_WINDOW displayed presents
+void PresentStatsLatency(const PresentAccounting& acc, float& avgMs, float& maxMs);
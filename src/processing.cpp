@@ -3,7 +3,6 @@
 
 #include "processing.h"
 #include "globals.h"
-#include "lut.h"
 #include "color.h"
 #include "render.h"
 #include "capture.h"
@@ -13,9 +12,11 @@
 #include "gui.h"
 #include "gpu.h"
 #include "displayconfig.h"
+#include "alloctrack.h"
+#include "correction.h"
+#include "livelut.h"
 #include <objbase.h>
 #include <iostream>
-#include <map>
 #include <algorithm>
 #include <cmath>
 #include <cstdlib>
@@ -114,9 +115,116 @@ ColorCorrectionData ConvertColorCorrection(const ColorCorrectionSettings& src, b
     dst.tonemap.sourcePeakNits = src.tonemap.sourcePeakNits;
     dst.tonemap.targetPeakNits = src.tonemap.targetPeakNits;
 
+    // Gamut boundary descriptor for soft compression (only meaningful with a primaries matrix)
+    dst.gamutCompression = src.gamutCompression && src.primariesEnabled;
+    if (dst.gamutCompression) {
+        dst.gamutBoundary = AcquireGamutBoundary(dst.primariesMatrix, isHDR);
+    }
+
     return dst;
 }
 
+// Topology reconciliation state (processing thread only)
+struct TopologyConfig {
+    uint64_t id;                   // Display the config was made for (TopologyDisplay::id)
+    MonitorLUTConfig config;
+};
+static std::vector<TopologyConfig> g_topologyConfigs;   // Every configured display, attached or not
+static DisplayDatabase g_topologyDb;                     // GUI database copy for display ids
+
+// Bring a monitor context up on ctx.cold->monitor with ctx.gpu: LUT textures (from the device's
+// pool on re-attach), overlay window (created on first attach, moved on re-attach), duplication,
+// swapchain and composition. On failure its D3D resources are released and a window created
+// here is destroyed.
+static bool AttachMonitor(MonitorContext& ctx, const MonitorLUTConfig& config) {
+    ctx.cold->sdrLutPath = config.sdrLutPath;
+    ctx.cold->hdrLutPath = config.hdrLutPath;
+
+    MONITORINFO mi = { sizeof(mi) };
+    GetMonitorInfo(ctx.cold->monitor, &mi);
+    ctx.width = mi.rcMonitor.right - mi.rcMonitor.left;
+    ctx.height = mi.rcMonitor.bottom - mi.rcMonitor.top;
+    ctx.cold->x = mi.rcMonitor.left;
+    ctx.cold->y = mi.rcMonitor.top;
+
+    // Load SDR LUT (optional if color correction is enabled)
+    bool hasSDRLUT = false;
+    if (!config.sdrLutPath.empty()) {
+        if (!LoadLUTTexture(ctx.gpu, config.sdrLutPath, false, ctx.lutSizeSDR, &ctx.cold->lutTextureSDR, &ctx.lutSRV_SDR)) {
+            SetStatus(L"Failed to load SDR LUT");
+            return false;
+        }
+        hasSDRLUT = true;
+    }
+
+    // Set passthrough mode if no SDR LUT (color correction only)
+    ctx.usePassthrough = !hasSDRLUT;
+
+    // Load HDR LUT if specified
+    bool hasHDRLUT = !config.hdrLutPath.empty() &&
+        LoadLUTTexture(ctx.gpu, config.hdrLutPath, true, ctx.lutSizeHDR, &ctx.cold->lutTextureHDR, &ctx.lutSRV_HDR);
+
+    bool createdWindow = false;
+    if (!ctx.hwnd) {
+        // Create overlay window
+        wchar_t windowTitle[64];
+        swprintf_s(windowTitle, L"DesktopLUT_Monitor%d", ctx.index);
+
+        ctx.hwnd = CreateWindowEx(
+            WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOPMOST | WS_EX_NOACTIVATE | WS_EX_TOOLWINDOW,
+            g_windowClassName, windowTitle,
+            WS_POPUP,
+            ctx.cold->x, ctx.cold->y, ctx.width, ctx.height,
+            nullptr, nullptr, GetModuleHandle(nullptr), nullptr);
+
+        if (!ctx.hwnd) {
+            ReleaseMonitorD3DResources(&ctx);  // LUT textures
+            return false;
+        }
+        createdWindow = true;
+
+        SetWindowDisplayAffinity(ctx.hwnd, WDA_EXCLUDEFROMCAPTURE);
+    } else {
+        SetWindowPos(ctx.hwnd, HWND_TOPMOST, ctx.cold->x, ctx.cold->y, ctx.width, ctx.height,
+            SWP_NOACTIVATE);
+    }
+    // Start fully transparent - will be made opaque after first frame renders
+    SetLayeredWindowAttributes(ctx.hwnd, 0, 0, LWA_ALPHA);
+
+    auto fail = [&]() {
+        ReleaseMonitorD3DResources(&ctx);
+        if (createdWindow) {
+            DestroyWindow(ctx.hwnd);
+            ctx.hwnd = nullptr;
+        }
+        return false;
+    };
+
+    if (!InitDesktopDuplication(&ctx)) return fail();
+
+    // Check if we have any HDR processing to do (the compiled correction may still be on its way)
+    bool hasHdrColorCorrection = config.hasHdrColorCorrection ||
+                                 ctx.hdrColorCorrection.primariesEnabled ||
+                                 ctx.hdrColorCorrection.grayscale.enabled ||
+                                 ctx.hdrColorCorrection.tonemap.enabled;
+
+    if (ctx.isHDREnabled && !hasHDRLUT && !hasHdrColorCorrection) {
+        SetStatus(L"HDR mode requires HDR LUT or color correction");
+        return fail();
+    }
+
+    // Set passthrough mode if no applicable LUT for current mode
+    if (ctx.isHDREnabled) {
+        ctx.usePassthrough = !hasHDRLUT;
+    }
+
+    if (!CreateSwapChain(&ctx)) return fail();
+    if (!InitDirectComposition(&ctx)) return fail();
+
+    // Don't show window yet - render loop will show it after first frame is rendered
+    return true;
+}
+
 void ProcessingThreadFunc(std::vector<MonitorLUTConfig> configs) {
     // Initialize COM for this thread (separate apartment from GUI thread)
     CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
@@ -135,8 +243,14 @@ void ProcessingThreadFunc(std::vector<MonitorLUTConfig> configs) {
     wc.lpszClassName = g_windowClassName;
     RegisterClassEx(&wc);
 
-    // Initialize D3D
-    if (!InitD3D()) {
+    // Initialize D3D - one device group per adapter driving a configured monitor
+    std::vector<HMONITOR> configuredMonitors;
+    for (const auto& config : configs) {
+        if (config.monitorIndex < (int)monitors.size()) {
+            configuredMonitors.push_back(monitors[config.monitorIndex]);
+        }
+    }
+    if (!InitD3D(configuredMonitors)) {
         SetStatus(L"Failed to initialize D3D11");
         ReleaseSharedD3DResources();  // Clean up any partially initialized resources
         return;
@@ -153,140 +267,45 @@ void ProcessingThreadFunc(std::vector<MonitorLUTConfig> configs) {
     // Initialize Compositor Clock API for VRR-aware frame timing
     InitCompositorClock();
 
-    // LUT cache
-    std::map<std::wstring, std::pair<std::vector<float>, int>> lutCache;
+    // Display ids for every monitor (configs are matched to displays by id from here on)
+    g_topologyDb = g_gui.displayDb;
+    std::vector<TopologyDisplay> topology;
+    DescribeTopology(monitors, g_topologyDb, topology);
+    g_topologyConfigs.clear();
 
     for (const auto& config : configs) {
-        if (config.monitorIndex >= (int)monitors.size()) continue;
-
-        MonitorContext ctx;
-        ctx.index = config.monitorIndex;
-        ctx.monitor = monitors[config.monitorIndex];
-        ctx.sdrLutPath = config.sdrLutPath;
-        ctx.hdrLutPath = config.hdrLutPath;
-        ctx.sdrColorCorrection = config.sdrColorCorrection;
-        ctx.hdrColorCorrection = config.hdrColorCorrection;
-
-        MONITORINFO mi = { sizeof(mi) };
-        GetMonitorInfo(ctx.monitor, &mi);
-        ctx.width = mi.rcMonitor.right - mi.rcMonitor.left;
-        ctx.height = mi.rcMonitor.bottom - mi.rcMonitor.top;
-        ctx.x = mi.rcMonitor.left;
-        ctx.y = mi.rcMonitor.top;
-
-        // Load SDR LUT (optional if color correction is enabled)
-        std::vector<float> lutDataSDR;
-        bool hasSDRLUT = false;
-        if (!config.sdrLutPath.empty()) {
-            if (lutCache.find(config.sdrLutPath) != lutCache.end()) {
-                lutDataSDR = lutCache[config.sdrLutPath].first;
-                ctx.lutSizeSDR = lutCache[config.sdrLutPath].second;
-                hasSDRLUT = true;
-            } else {
-                if (LoadLUT(config.sdrLutPath, lutDataSDR, ctx.lutSizeSDR)) {
-                    hasSDRLUT = true;
-                    lutCache[config.sdrLutPath] = { lutDataSDR, ctx.lutSizeSDR };
-                } else {
-                    SetStatus(L"Failed to load SDR LUT");
-                    continue;
-                }
-            }
-        }
-
-        // Set passthrough mode if no SDR LUT (color correction only)
-        ctx.usePassthrough = !hasSDRLUT;
-
-        // Load HDR LUT if specified
-        std::vector<float> lutDataHDR;
-        bool hasHDRLUT = false;
-        if (!config.hdrLutPath.empty()) {
-            if (lutCache.find(config.hdrLutPath) != lutCache.end()) {
-                lutDataHDR = lutCache[config.hdrLutPath].first;
-                ctx.lutSizeHDR = lutCache[config.hdrLutPath].second;
-                hasHDRLUT = true;
-            } else {
-                if (LoadLUT(config.hdrLutPath, lutDataHDR, ctx.lutSizeHDR)) {
-                    hasHDRLUT = true;
-                    lutCache[config.hdrLutPath] = { lutDataHDR, ctx.lutSizeHDR };
-                }
+        if (config.monitorIndex >= (int)monitors.size()) {
+            // Connected when the GUI enumerated it but gone now: attach it if it comes back
+            if (config.monitorIndex < (int)g_gui.monitorEdidHashes.size() && g_gui.monitorEdidHashes[config.monitorIndex]) {
+                g_topologyConfigs.push_back({ g_gui.monitorEdidHashes[config.monitorIndex], config });
             }
-        }
-
-        // Create overlay window
-        wchar_t windowTitle[64];
-        swprintf_s(windowTitle, L"DesktopLUT_Monitor%d", ctx.index);
-
-        ctx.hwnd = CreateWindowEx(
-            WS_EX_LAYERED | WS_EX_TRANSPARENT | WS_EX_TOPMOST | WS_EX_NOACTIVATE | WS_EX_TOOLWINDOW,
-            g_windowClassName, windowTitle,
-            WS_POPUP,
-            ctx.x, ctx.y, ctx.width, ctx.height,
-            nullptr, nullptr, wc.hInstance, nullptr);
-
-        if (!ctx.hwnd) continue;
-
-        SetWindowDisplayAffinity(ctx.hwnd, WDA_EXCLUDEFROMCAPTURE);
-        // Start fully transparent - will be made opaque after first frame renders
-        SetLayeredWindowAttributes(ctx.hwnd, 0, 0, LWA_ALPHA);
-
-        if (!InitDesktopDuplication(&ctx)) {
-            DestroyWindow(ctx.hwnd);
             continue;
         }
+        g_topologyConfigs.push_back({ topology[config.monitorIndex].id, config });
 
-        // Check if we have any HDR processing to do
-        bool hasHdrColorCorrection = ctx.hdrColorCorrection.primariesEnabled ||
-                                     ctx.hdrColorCorrection.grayscale.enabled ||
-                                     ctx.hdrColorCorrection.tonemap.enabled;
-
-        if (ctx.isHDREnabled && !hasHDRLUT && !hasHdrColorCorrection) {
-            SetStatus(L"HDR mode requires HDR LUT or color correction");
-            ReleaseMonitorD3DResources(&ctx);
-            DestroyWindow(ctx.hwnd);
-            continue;
-        }
-
-        // Set passthrough mode if no applicable LUT for current mode
-        if (ctx.isHDREnabled) {
-            ctx.usePassthrough = !hasHDRLUT;
-        }
-
-        if (!CreateSwapChain(&ctx)) {
-            ReleaseMonitorD3DResources(&ctx);
-            DestroyWindow(ctx.hwnd);
-            continue;
-        }
-
-        if (!InitDirectComposition(&ctx)) {
-            ReleaseMonitorD3DResources(&ctx);
-            DestroyWindow(ctx.hwnd);
-            continue;
-        }
-
-        // Create LUT textures (only if we have LUT data)
-        if (hasSDRLUT) {
-            if (!CreateLUTTexture(lutDataSDR, ctx.lutSizeSDR, &ctx.lutTextureSDR, &ctx.lutSRV_SDR)) {
-                ReleaseMonitorD3DResources(&ctx);
-                DestroyWindow(ctx.hwnd);
-                continue;
-            }
-        }
+        auto owned = std::make_unique<MonitorContext>();
+        MonitorContext& ctx = *owned;
+        ctx.index = config.monitorIndex;
+        ctx.cold->monitor = monitors[config.monitorIndex];
+        ctx.cold->display = topology[config.monitorIndex];
+        ctx.gpu = FindGpuDevice(ctx.cold->monitor);
+        ctx.sdrColorCorrection = config.sdrColorCorrection;
+        ctx.hdrColorCorrection = config.hdrColorCorrection;
 
-        if (hasHDRLUT) {
-            CreateLUTTexture(lutDataHDR, ctx.lutSizeHDR, &ctx.lutTextureHDR, &ctx.lutSRV_HDR);
-        }
+        if (!AttachMonitor(ctx, config)) continue;
 
-        // Don't show window yet - render loop will show it after first frame is rendered
-        g_monitors.push_back(ctx);
+        ctx.metrics = MetricsAttachMonitor(g_metrics, ctx.index);
+        g_monitors.push_back(std::move(owned));
     }
 
     if (g_monitors.empty()) {
         SetStatus(L"No monitors initialized");
+        g_topologyConfigs.clear();
         ReleaseSharedD3DResources();  // Clean up D3D resources on early exit
         return;
     }
 
-    g_mainHwnd = g_monitors[0].hwnd;
+    g_mainHwnd = g_monitors[0]->hwnd;
 
     // Register hotkeys (conditional based on settings, MOD_NOREPEAT prevents repeat when held)
     if (g_hotkeyGammaEnabled.load()) {
@@ -308,9 +327,29 @@ void ProcessingThreadFunc(std::vector<MonitorLUTConfig> configs) {
     // Create analysis overlay
     CreateAnalysisOverlay(GetModuleHandle(nullptr));
 
+    // Reserve one pending color correction slot per monitor and mode (live slider updates don't allocate)
+    {
+        std::lock_guard<std::mutex> lock(g_colorCorrectionMutex);
+        g_pendingColorCorrections.reserve((std::max)(g_monitors.size(), g_gui.monitorSettings.size()) * 2);
+    }
+
     // Start gamma whitelist polling thread (runs independently from frame timing)
     StartGammaWhitelistThread();
 
+    // Start live LUT pipe for the monitors we actually process
+    if (g_liveLutEnabled.load()) {
+        std::vector<int> liveLutMonitors;
+        for (auto& ctx : g_monitors) {
+            liveLutMonitors.push_back(ctx->index);
+        }
+        StartLiveLutServer(liveLutMonitors);
+    }
+
+    // Analysis time series (runs the analysis pass even with the overlay hidden)
+    if (g_analysisRecording.load()) {
+        StartAnalysisRecording();
+    }
+
     SetStatus(L"Active");
 
     // Initialize watchdog timestamp
@@ -318,6 +357,7 @@ void ProcessingThreadFunc(std::vector<MonitorLUTConfig> configs) {
 
     // Main loop
     MSG msg = {};
+    AllocProbe allocProbe{ "render pass" };
     while (g_running) {
         while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
             TranslateMessage(&msg);
@@ -325,13 +365,17 @@ void ProcessingThreadFunc(std::vector<MonitorLUTConfig> configs) {
         }
 
         if (g_running) {
+            AllocProbeBegin(allocProbe);
             RenderAll();
+            AllocProbeEnd(allocProbe);
             // AcquireNextFrame timeout provides CPU yielding
         }
     }
 
     // Stop gamma whitelist polling thread
     StopGammaWhitelistThread();
+    StopLiveLutServer();
+    StopAnalysisRecording();
 
     // Unregister hotkeys before cleanup
     if (g_mainHwnd) {
@@ -354,10 +398,12 @@ void ProcessingThreadFunc(std::vector<MonitorLUTConfig> configs) {
 
     // Cleanup monitor contexts
     for (auto& ctx : g_monitors) {
-        CleanupMonitorContext(&ctx);
+        MetricsDetachMonitor(ctx->metrics);
+        CleanupMonitorContext(ctx.get());
     }
     g_monitors.clear();
     g_mainHwnd = nullptr;
+    g_topologyConfigs.clear();
 
     // Pump any remaining messages
     while (PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE)) {
@@ -365,21 +411,7 @@ void ProcessingThreadFunc(std::vector<MonitorLUTConfig> configs) {
         DispatchMessage(&msg);
     }
 
-    if (g_dcompDevice) { g_dcompDevice->Release(); g_dcompDevice = nullptr; }
-    if (g_blueNoiseSRV) { g_blueNoiseSRV->Release(); g_blueNoiseSRV = nullptr; }
-    if (g_blueNoiseTexture) { g_blueNoiseTexture->Release(); g_blueNoiseTexture = nullptr; }
-    if (g_constantBuffer) { g_constantBuffer->Release(); g_constantBuffer = nullptr; }
-    if (g_samplerPoint) { g_samplerPoint->Release(); g_samplerPoint = nullptr; }
-    if (g_samplerLinear) { g_samplerLinear->Release(); g_samplerLinear = nullptr; }
-    if (g_samplerWrap) { g_samplerWrap->Release(); g_samplerWrap = nullptr; }
-    if (g_peakDetectCS) { g_peakDetectCS->Release(); g_peakDetectCS = nullptr; }
-    if (g_peakCB) { g_peakCB->Release(); g_peakCB = nullptr; }
-    if (g_analysisCS) { g_analysisCS->Release(); g_analysisCS = nullptr; }
-    if (g_analysisCB) { g_analysisCB->Release(); g_analysisCB = nullptr; }
-    if (g_ps) { g_ps->Release(); g_ps = nullptr; }
-    if (g_vs) { g_vs->Release(); g_vs = nullptr; }
-    if (g_context) { g_context->Release(); g_context = nullptr; }
-    if (g_device) { g_device->Release(); g_device = nullptr; }
+    ReleaseSharedD3DResources();
 
     CoUninitialize();
 
@@ -387,6 +419,170 @@ void ProcessingThreadFunc(std::vector<MonitorLUTConfig> configs) {
     PostMessage(g_gui.hwndMain, WM_USER + 100, 0, 0);  // Signal GUI to update
 }
 
+// Park a monitor whose display went away: release its device resources and hide its window.
+// The context (and the window, which may own the hotkeys) stays so the display can come back.
+static void DetachMonitor(MonitorContext* ctx) {
+    ReleaseMonitorD3DResources(ctx);
+    ReleaseGpuMonitor(ctx->cold->monitor);
+    if (ctx->hwnd) ShowWindow(ctx->hwnd, SW_HIDE);
+    ctx->gpu = nullptr;
+    ctx->enabled = false;
+    ctx->cold->detached = true;
+}
+
+// New duplication for a display whose mode, HDR state or output changed (the render loop keeps
+// retrying if it fails here)
+static void ReduplicateMonitor(MonitorContext* ctx) {
+    ctx->consecutiveFailures = 0;
+    if (!ReinitDesktopDuplication(ctx)) {
+        if (ctx->hwnd && IsWindowVisible(ctx->hwnd)) ShowWindow(ctx->hwnd, SW_HIDE);
+        return;
+    }
+    if (ctx->isHDREnabled != ctx->wasHDREnabled) {
+        // ReinitDesktopDuplication recreated the swapchain for the new mode
+        ApplyMaxTmlSettings();
+        ctx->wasHDREnabled = ctx->isHDREnabled;
+    }
+}
+
+void ReconcileTopology(bool resumed) {
+    std::vector<HMONITOR> monitors;
+    EnumDisplayMonitors(nullptr, nullptr, MonitorEnumProc, reinterpret_cast<LPARAM>(&monitors));
+    std::vector<TopologyDisplay> current;
+    DescribeTopology(monitors, g_topologyDb, current);
+
+    std::vector<MonitorContext*> attached;
+    std::vector<TopologyDisplay> running;
+    for (auto& ctx : g_monitors) {
+        if (ctx->cold->detached) continue;
+        attached.push_back(ctx.get());
+        running.push_back(ctx->cold->display);
+    }
+    std::vector<uint64_t> configured;
+    for (const auto& entry : g_topologyConfigs) {
+        configured.push_back(entry.id);
+    }
+
+    std::vector<TopologyStep> plan = PlanTopology(running, current, configured, resumed);
+    if (plan.empty()) {
+        std::cout << "Display topology unchanged" << std::endl;
+        return;
+    }
+
+    bool added = false;
+    for (const TopologyStep& step : plan) {
+        if (step.actions & TOPOLOGY_REMOVE) {
+            MonitorContext* ctx = attached[step.running];
+            std::cout << "Monitor " << ctx->index << ": display removed, parking" << std::endl;
+            DetachMonitor(ctx);
+            continue;
+        }
+
+        const TopologyDisplay& display = current[step.current];
+        HMONITOR monitor = reinterpret_cast<HMONITOR>(display.handle);
+
+        if (step.actions & TOPOLOGY_ADD) {
+            // Re-attach the parked context for this display, or make one for a display that
+            // wasn't connected when processing started
+            MonitorContext* ctx = nullptr;
+            for (auto& candidate : g_monitors) {
+                if (candidate->cold->detached && candidate->cold->display.id == step.id) {
+                    ctx = candidate.get();
+                    break;
+                }
+            }
+            const TopologyConfig* entry = nullptr;
+            for (const auto& candidate : g_topologyConfigs) {
+                if (candidate.id != step.id) continue;
+                bool hasContext = false;
+                for (auto& other : g_monitors) {
+                    if (other->index == candidate.config.monitorIndex) hasContext = true;
+                }
+                // Parked: its own config. New: a config no context claimed yet (identical displays)
+                if (ctx ? candidate.config.monitorIndex == ctx->index : !hasContext) {
+                    entry = &candidate;
+                    break;
+                }
+            }
+            if (!entry) continue;
+
+            std::unique_ptr<MonitorContext> owned;
+            if (!ctx) {
+                owned = std::make_unique<MonitorContext>();
+                ctx = owned.get();
+                ctx->index = entry->config.monitorIndex;
+                ctx->sdrColorCorrection = entry->config.sdrColorCorrection;
+                ctx->hdrColorCorrection = entry->config.hdrColorCorrection;
+            }
+            ctx->cold->monitor = monitor;
+            ctx->cold->display = display;
+            ctx->gpu = AssignGpuDevice(monitor);
+            bool ok = false;
+            if (!ctx->gpu) {
+                std::cerr << "Monitor " << ctx->index << ": display is on an adapter without a device, "
+                          << "restart processing to use it" << std::endl;
+            } else if (AttachMonitor(*ctx, entry->config)) {
+                ok = true;
+            } else {
+                std::cerr << "Monitor " << ctx->index << ": failed to attach display" << std::endl;
+                ReleaseGpuMonitor(monitor);
+            }
+            if (!ok) {
+                // A parked context stays parked; a new one is dropped and retried on the next change
+                ctx->gpu = nullptr;
+                ctx->enabled = false;
+                ctx->cold->detached = true;
+                continue;
+            }
+
+            ctx->cold->detached = false;
+            ctx->enabled = true;
+            ctx->consecutiveFailures = 0;
+            ctx->wasHDREnabled = ctx->isHDREnabled;
+            added = true;
+            std::cout << "Monitor " << ctx->index << ": display attached" << std::endl;
+            if (owned) {
+                ctx->metrics = MetricsAttachMonitor(g_metrics, ctx->index);
+                g_monitors.push_back(std::move(owned));
+            }
+            continue;
+        }
+
+        MonitorContext* ctx = attached[step.running];
+        std::cout << "Monitor " << ctx->index << ": " << FormatTopologyActions(step.actions) << std::endl;
+        if (step.actions & TOPOLOGY_REBIND) {
+            ReleaseGpuMonitor(ctx->cold->monitor);
+            if (ctx->gpu) ctx->gpu->monitors.push_back(monitor);
+            ctx->cold->monitor = monitor;
+        }
+        if (step.actions & (TOPOLOGY_MOVE | TOPOLOGY_RESIZE)) {
+            ctx->cold->x = display.x;
+            ctx->cold->y = display.y;
+            if ((step.actions & TOPOLOGY_RESIZE) && ctx->swapchain) {
+                ResizeSwapChain(ctx, display.width, display.height);
+            }
+            SetWindowPos(ctx->hwnd, nullptr, display.x, display.y, display.width, display.height,
+                SWP_NOZORDER | SWP_NOACTIVATE);
+        }
+        if (step.actions & TOPOLOGY_REDUPLICATE) {
+            ReduplicateMonitor(ctx);
+        }
+        ctx->cold->display = display;
+    }
+
+    // Streamed LUTs for re-attached monitors were dropped with their textures
+    if (added) {
+        RequeueLiveLutUploads();
+    }
+}
+
+void KeepTopologyCorrection(int monitorIndex, bool isHDR, const ColorCorrectionData& data) {
+    for (auto& entry : g_topologyConfigs) {
+        if (entry.config.monitorIndex != monitorIndex) continue;
+        (isHDR ? entry.config.hdrColorCorrection : entry.config.sdrColorCorrection) = data;
+    }
+}
+
 void StartProcessing() {
     if (g_gui.isRunning) return;
 
@@ -412,8 +608,7 @@ void StartProcessing() {
             config.monitorIndex = (int)i;
             config.sdrLutPath = ms.sdrPath;
             config.hdrLutPath = ms.hdrPath;
-            config.sdrColorCorrection = ConvertColorCorrection(ms.sdrColorCorrection, false);
-            config.hdrColorCorrection = ConvertColorCorrection(ms.hdrColorCorrection, true);
+            config.hasHdrColorCorrection = hasHdrColorCorrection;
             configs.push_back(config);
         }
     }
@@ -431,6 +626,14 @@ void StartProcessing() {
 
     g_running = true;
     g_gui.isRunning = true;
+
+    // Corrections compile on the worker like live edits; monitors render uncorrected until they land
+    StartCorrectionCompiler();
+    for (const auto& config : configs) {
+        const auto& ms = g_gui.monitorSettings[config.monitorIndex];
+        SubmitCorrectionSnapshot(config.monitorIndex, false, ms.sdrColorCorrection);
+        SubmitCorrectionSnapshot(config.monitorIndex, true, ms.hdrColorCorrection);
+    }
     g_gui.processingThread = std::thread(ProcessingThreadFunc, configs);
 
     // Directly set button states - don't call UpdateGUIState which may re-enable via SettingsChanged
@@ -479,6 +682,7 @@ void StopProcessing() {
         }
     }
 
+    StopCorrectionCompiler();
     g_gui.isRunning = false;
     g_gui.activeSettings.clear();  // No longer running, clear active settings
     UpdateGUIState();
@@ -489,22 +693,11 @@ void UpdateColorCorrectionLive(int monitorIndex, bool isHDR) {
         return;
     }
 
-    // Convert GUI settings to runtime format
+    // Hand a snapshot to the correction compiler - conversion (primaries matrix, gamut
+    // descriptor) runs on its worker so slider drags never stall the GUI thread
     const auto& src = isHDR ? g_gui.monitorSettings[monitorIndex].hdrColorCorrection
                             : g_gui.monitorSettings[monitorIndex].sdrColorCorrection;
-    ColorCorrectionData cc = ConvertColorCorrection(src, isHDR);
-
-    // Queue the update for the processing thread
-    std::lock_guard<std::mutex> lock(g_colorCorrectionMutex);
-    // Remove any existing pending update for this monitor and mode
-    g_pendingColorCorrections.erase(
-        std::remove_if(g_pendingColorCorrections.begin(), g_pendingColorCorrections.end(),
-            [monitorIndex, isHDR](const PendingColorCorrection& p) {
-                return p.monitorIndex == monitorIndex && p.isHDR == isHDR;
-            }),
-        g_pendingColorCorrections.end());
-    g_pendingColorCorrections.push_back({ monitorIndex, isHDR, cc });
-    g_hasPendingColorCorrections.store(true, std::memory_order_release);
+    SubmitCorrectionSnapshot(monitorIndex, isHDR, src);
 }
 
 // Helper to compare primaries (DisplayPrimariesData vs DisplayPrimaries)
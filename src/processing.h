@@ -12,6 +12,16 @@ BOOL CALLBACK MonitorEnumProc(HMONITOR hMonitor, HDC, LPRECT, LPARAM lParam);
 // Processing thread function
 void ProcessingThreadFunc(std::vector<MonitorLUTConfig> configs);
 
+// Bring the running monitors in line with the current display topology (render thread).
+// Only displays that changed are touched: removed ones are parked, configured ones that
+// appear are attached, moved/resized/HDR-toggled ones get the matching partial reinit.
+// resumed: after sleep/wake, every display also gets a fresh duplication.
+void ReconcileTopology(bool resumed);
+
+// Keep a compiled correction for a monitor's topology config too (render thread), so a display
+// attached or re-attached later starts from it rather than from the startup identity
+void KeepTopologyCorrection(int monitorIndex, bool isHDR, const ColorCorrectionData& data);
+
 // Start processing (GUI mode)
 void StartProcessing();
 
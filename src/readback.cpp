@@ -0,0 +1,107 @@
+// DesktopLUT - readback.cpp
+// Asynchronous GPU readback: a ring of staging resources per result type, mapped without waiting
+// once a copy is a few frames old, results delivered to callbacks (no Windows dependencies)
+
+#include "readback.h"
+
+int AddReadbackRing(ReadbackManager& m, const std::string& name, const ReadbackDesc& desc, int slots,
+                    uint32_t latency, ReadbackCallback deliver) {
+    ReadbackRing ring;
+    ring.name = name;
+    ring.desc = desc;
+    ring.latency = latency;
+    ring.slots.resize(slots > 0 ? slots : 1);
+    ring.deliver = std::move(deliver);
+    m.rings.push_back(std::move(ring));
+    return (int)m.rings.size() - 1;
+}
+
+bool RequestReadback(ReadbackManager& m, int ring, void* source) {
+    if (ring < 0 || ring >= (int)m.rings.size() || !source) return false;
+    ReadbackRing& r = m.rings[ring];
+    r.requested++;
+
+    ReadbackSlot* slot = nullptr;
+    for (auto& s : r.slots) {
+        if (!s.inFlight) {
+            slot = &s;
+            break;
+        }
+    }
+    if (!slot) {
+        r.dropped++;
+        return false;
+    }
+    if (!slot->staging) {
+        slot->staging = m.ops.create(r.desc);
+        if (!slot->staging) {
+            r.failed++;
+            return false;
+        }
+    }
+
+    m.ops.copy(slot->staging, source);
+    slot->inFlight = true;
+    slot->frame = m.frame;
+    slot->sequence = r.nextSequence++;
+    return true;
+}
+
+static void Poll(ReadbackManager& m, bool ignoreLatency) {
+    for (auto& r : m.rings) {
+        // Copies complete in submission order, so stop at the first one still in flight
+        for (;;) {
+            ReadbackSlot* oldest = nullptr;
+            for (auto& s : r.slots) {
+                if (s.inFlight && (!oldest || s.sequence < oldest->sequence)) oldest = &s;
+            }
+            if (!oldest || (!ignoreLatency && m.frame < oldest->frame + r.latency)) break;
+
+            const void* data = nullptr;
+            ReadbackMapStatus status = m.ops.map(oldest->staging, &data);
+            if (status == READBACK_MAP_BUSY) {
+                r.busyPolls++;
+                break;
+            }
+            oldest->inFlight = false;
+            if (status == READBACK_MAP_FAILED) {
+                r.failed++;
+                continue;
+            }
+            r.delivered++;
+            if (r.deliver) r.deliver(data, oldest->frame);
+            m.ops.unmap(oldest->staging);
+        }
+    }
+}
+
+void PollReadbacks(ReadbackManager& m) {
+    Poll(m, false);
+}
+
+void PollIdleReadbacks(ReadbackManager& m) {
+    Poll(m, true);
+}
+
+void AdvanceReadbackFrame(ReadbackManager& m) {
+    m.frame++;
+}
+
+int PendingReadbacks(const ReadbackManager& m, int ring) {
+    if (ring < 0 || ring >= (int)m.rings.size()) return 0;
+    int pending = 0;
+    for (const auto& s : m.rings[ring].slots) {
+        if (s.inFlight) pending++;
+    }
+    return pending;
+}
+
+void ReleaseReadbacks(ReadbackManager& m) {
+    for (auto& r : m.rings) {
+        for (auto& s : r.slots) {
+            if (s.staging && m.ops.release) m.ops.release(s.staging);
+            s.staging = nullptr;
+            s.inFlight = false;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+// DesktopLUT - readback.h
+// Asynchronous GPU readback: a ring of staging resources per result type, mapped without waiting
+// once a copy is a few frames old, results delivered to callbacks (no Windows dependencies)
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+enum ReadbackMapStatus : uint8_t {
+    READBACK_MAP_READY,
+    READBACK_MAP_BUSY,       // Copy still in flight (DXGI_ERROR_WAS_STILL_DRAWING), try next frame
+    READBACK_MAP_FAILED,
+};
+
+// Staging resource shape: a format-less buffer of `bytes`, or a width x height texture of `format`
+struct ReadbackDesc {
+    uint32_t bytes = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t format = 0;     // DXGI_FORMAT (0 = buffer)
+};
+
+// GPU side (D3D11 immediate context in gpu.cpp). Resources are opaque here.
+struct ReadbackOps {
+    std::function<void*(const ReadbackDesc&)> create;                 // Staging resource, null on failure
+    std::function<void(void*)> release;
+    std::function<void(void*, void*)> copy;                           // Queue staging <- source
+    std::function<ReadbackMapStatus(void*, const void**)> map;        // Must not block
+    std::function<void(void*)> unmap;
+};
+
+// Mapped data and the frame its copy was queued on; only valid during the call
+typedef std::function<void(const void* data, uint64_t frame)> ReadbackCallback;
+
+struct ReadbackSlot {
+    void* staging = nullptr;     // Created on first use, kept until ReleaseReadbacks
+    bool inFlight = false;
+    uint64_t frame = 0;          // Frame the copy was queued on
+    uint64_t sequence = 0;       // Request order within the ring
+};
+
+struct ReadbackRing {
+    std::string name;
+    ReadbackDesc desc;
+    uint32_t latency = 2;        // Frames between the copy and the first map attempt
+    std::vector<ReadbackSlot> slots;
+    ReadbackCallback deliver;
+    uint64_t nextSequence = 0;
+
+    uint64_t requested = 0;
+    uint64_t delivered = 0;
+    uint64_t dropped = 0;        // Every slot still in flight (consumer asks faster than the GPU returns)
+    uint64_t busyPolls = 0;      // Map attempts that found the copy unfinished (a stall avoided)
+    uint64_t failed = 0;
+};
+
+// One per monitor (owned by the render thread)
+struct ReadbackManager {
+    ReadbackOps ops;
+    std::vector<ReadbackRing> rings;
+    uint64_t frame = 0;
+};
+
+// Register a result type; returns the ring index for RequestReadback
+int AddReadbackRing(ReadbackManager& m, const std::string& name, const ReadbackDesc& desc, int slots,
+                    uint32_t latency, ReadbackCallback deliver);
+
+// Queue a copy of `source` into the ring's next free slot. False if every slot is still in
+// flight (the request is dropped) or the staging resource can't be created.
+bool RequestReadback(ReadbackManager& m, int ring, void* source);
+
+// Deliver copies that are at least `latency` frames old and finished, oldest first per ring.
+// A copy still in flight is retried on the next poll; nothing ever waits on the GPU.
+void PollReadbacks(ReadbackManager& m);
+
+// Same, on a pass without a frame (the acquire wait timed out while the desktop is static):
+// frames don't advance then, but the wait gave the GPU time, so copies younger than their
+// latency are tried as well. Still never waits.
+void PollIdleReadbacks(ReadbackManager& m);
+
+// End of the monitor's frame (latency is counted in these)
+void AdvanceReadbackFrame(ReadbackManager& m);
+
+// Copies queued and not yet delivered
+int PendingReadbacks(const ReadbackManager& m, int ring);
+
+// Release every staging resource and abandon copies in flight (device loss, monitor release).
+// Rings stay registered; staging is recreated on the next request.
+void ReleaseReadbacks(ReadbackManager& m);
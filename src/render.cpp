@@ -9,6 +9,12 @@
 #include "analysis.h"
 #include "displayconfig.h"
 #include "processing.h"
+#include "alloctrack.h"
+#include "whitelist.h"
+#include "livelut.h"
+#include "tiledpass.h"
+#include "dxcalls.h"
+#include "faultinject.h"
 #include <dwmapi.h>
 #include <tlhelp32.h>
 #include <iostream>
@@ -63,15 +69,55 @@ void UnregisterDisplayPowerNotification() {
     }
 }
 
+// Compiled whitelist owned by the polling thread
+// Recompiled only when settings reparse the list (version bump), so steady-state polls don't allocate
+struct WhitelistSnapshot {
+    CompiledWhitelist compiled;
+    WhitelistProcessCache processes;                  // Path-entry results for processes already seen
+    uint32_t version = UINT32_MAX;                    // Source list version this was built from
+
+    bool empty() const { return compiled.empty(); }
+};
+
+static WhitelistSnapshot g_gammaWhitelistSnapshot;  // Polling thread only
+static WhitelistSnapshot g_vrrWhitelistSnapshot;    // Polling thread only
+
+// Recompile snapshot if the source list changed since the last poll
+static void RefreshWhitelistSnapshot(WhitelistSnapshot& snap, const std::vector<std::wstring>& list,
+                                     std::mutex& mutex, const std::atomic<uint32_t>& version) {
+    if (snap.version == version.load()) return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CompileWhitelist(list, snap.compiled);
+    snap.processes.entries.clear();
+    snap.version = version.load();
+}
+
+// Full image path for path-pattern entries (only queried when the whitelist has any, once per process)
+static const wchar_t* QueryProcessPath(uint32_t pid, wchar_t* buf, size_t bufSize) {
+    HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+    if (!process) return nullptr;
+    DWORD size = (DWORD)bufSize;
+    BOOL ok = QueryFullProcessImageNameW(process, 0, buf, &size);
+    CloseHandle(process);
+    return ok ? buf : nullptr;
+}
+
+// Match a Toolhelp process entry against a compiled whitelist
+static bool MatchesWhitelistSnapshot(const PROCESSENTRY32W& pe, WhitelistSnapshot& snap) {
+    WhitelistProcess process = { pe.th32ProcessID, pe.th32ParentProcessID, pe.szExeFile };
+    return MatchWhitelistProcess(snap.compiled, snap.processes, process, QueryProcessPath);
+}
+
 // Check if any whitelisted process is running and update gamma state accordingly
 // Returns true if a whitelisted process was found
 static bool CheckGammaWhitelist() {
-    // Copy whitelist data under lock for thread-safe access
-    std::vector<std::wstring> localWhitelist;
-    std::wstring localOverrideProcess;
+    // Refresh interned whitelist only when settings changed; override name copies into reused capacity
+    WhitelistSnapshot& localWhitelist = g_gammaWhitelistSnapshot;
+    RefreshWhitelistSnapshot(localWhitelist, g_gammaWhitelist, g_gammaWhitelistMutex, g_gammaWhitelistVersion);
+    static std::wstring localOverrideProcess;
     {
         std::lock_guard<std::mutex> lock(g_gammaWhitelistMutex);
-        localWhitelist = g_gammaWhitelist;
         localOverrideProcess = g_gammaWhitelistOverrideProcess;
     }
 
@@ -101,7 +147,7 @@ static bool CheckGammaWhitelist() {
     // Check if any monitor is in HDR mode
     bool anyHDR = false;
     for (const auto& ctx : g_monitors) {
-        if (ctx.isHDREnabled) {
+        if (ctx->isHDREnabled) {
             anyHDR = true;
             break;
         }
@@ -125,6 +171,7 @@ static bool CheckGammaWhitelist() {
     }
 
     // Enumerate running processes
+    MetricInc(g_metrics.gammaWhitelistScans);
     HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     if (snapshot == INVALID_HANDLE_VALUE) {
         return false;
@@ -134,55 +181,28 @@ static bool CheckGammaWhitelist() {
     pe32.dwSize = sizeof(pe32);
 
     bool found = false;
-    std::wstring matchedProcess;
+    wchar_t matchedProcess[MAX_PATH] = {};
     bool overrideProcessStillRunning = false;
 
-    // Helper: case-insensitive length-limited compare
-    auto matchesPattern = [](const wchar_t* str, size_t strLen, const std::wstring& pattern) -> bool {
-        // Compare without .exe extension
-        size_t baseLen = strLen;
-        if (baseLen > 4 && _wcsnicmp(str + baseLen - 4, L".exe", 4) == 0) {
-            baseLen -= 4;
-        }
-        // Match pattern against base name (without extension)
-        if (baseLen == pattern.size() && _wcsnicmp(str, pattern.c_str(), baseLen) == 0) {
-            return true;
-        }
-        // Match pattern against full name (with extension)
-        if (strLen == pattern.size() && _wcsnicmp(str, pattern.c_str(), strLen) == 0) {
-            return true;
-        }
-        // Match pattern+.exe against full name
-        if (strLen == pattern.size() + 4 && _wcsnicmp(str, pattern.c_str(), pattern.size()) == 0 &&
-            _wcsnicmp(str + pattern.size(), L".exe", 4) == 0) {
-            return true;
-        }
-        return false;
-    };
-
+    BeginWhitelistScan(localWhitelist.processes);
     if (Process32FirstW(snapshot, &pe32)) {
         do {
-            const wchar_t* exeName = pe32.szExeFile;
-            size_t exeLen = wcslen(exeName);
-
             // Check if the override process is still running
             if (g_gammaWhitelistUserOverride.load() && !localOverrideProcess.empty()) {
-                if (matchesPattern(exeName, exeLen, localOverrideProcess)) {
+                if (WhitelistNameEquals(pe32.szExeFile, localOverrideProcess.c_str())) {
                     overrideProcessStillRunning = true;
                 }
             }
 
             // Check against whitelist (case-insensitive matching)
-            for (const auto& pattern : localWhitelist) {
-                if (matchesPattern(exeName, exeLen, pattern)) {
-                    found = true;
-                    matchedProcess = pe32.szExeFile;  // Original case for display
-                    break;
-                }
+            if (MatchesWhitelistSnapshot(pe32, localWhitelist)) {
+                found = true;
+                wcscpy_s(matchedProcess, pe32.szExeFile);  // Original case for display
             }
             // Don't break early - need to check if override process is still running too
         } while (Process32NextW(snapshot, &pe32));
     }
+    EndWhitelistScan(localWhitelist.processes);
 
     CloseHandle(snapshot);
 
@@ -239,12 +259,9 @@ static bool CheckGammaWhitelist() {
 
 // Check if any VRR-whitelisted process is running and hide/show overlay accordingly
 static void CheckVrrWhitelist() {
-    // Copy whitelist data under lock for thread-safe access
-    std::vector<std::wstring> localWhitelist;
-    {
-        std::lock_guard<std::mutex> lock(g_vrrWhitelistMutex);
-        localWhitelist = g_vrrWhitelist;
-    }
+    // Refresh interned whitelist only when settings changed
+    WhitelistSnapshot& localWhitelist = g_vrrWhitelistSnapshot;
+    RefreshWhitelistSnapshot(localWhitelist, g_vrrWhitelist, g_vrrWhitelistMutex, g_vrrWhitelistVersion);
 
     // Early exit if feature disabled or whitelist empty
     if (!g_vrrWhitelistEnabled.load() || localWhitelist.empty()) {
@@ -256,9 +273,9 @@ static void CheckVrrWhitelist() {
                 g_vrrWhitelistMatch.clear();
             }
             for (auto& ctx : g_monitors) {
-                if (ctx.hwnd && ctx.enabled && ctx.dcompCommitted) {
-                    SetLayeredWindowAttributes(ctx.hwnd, 0, 255, LWA_ALPHA);
-                    ShowWindow(ctx.hwnd, SW_SHOWNA);
+                if (ctx->hwnd && ctx->enabled && ctx->dcompCommitted) {
+                    SetLayeredWindowAttributes(ctx->hwnd, 0, 255, LWA_ALPHA);
+                    ShowWindow(ctx->hwnd, SW_SHOWNA);
                 }
             }
             std::cout << "VRR whitelist: disabled, showing overlays" << std::endl;
@@ -267,6 +284,7 @@ static void CheckVrrWhitelist() {
     }
 
     // Enumerate running processes
+    MetricInc(g_metrics.vrrWhitelistScans);
     HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
     if (snapshot == INVALID_HANDLE_VALUE) {
         return;
@@ -276,42 +294,19 @@ static void CheckVrrWhitelist() {
     pe32.dwSize = sizeof(pe32);
 
     bool found = false;
-    std::wstring matchedProcess;
-
-    // Helper: case-insensitive length-limited compare
-    auto matchesPattern = [](const wchar_t* str, size_t strLen, const std::wstring& pattern) -> bool {
-        size_t baseLen = strLen;
-        if (baseLen > 4 && _wcsnicmp(str + baseLen - 4, L".exe", 4) == 0) {
-            baseLen -= 4;
-        }
-        if (baseLen == pattern.size() && _wcsnicmp(str, pattern.c_str(), baseLen) == 0) {
-            return true;
-        }
-        if (strLen == pattern.size() && _wcsnicmp(str, pattern.c_str(), strLen) == 0) {
-            return true;
-        }
-        if (strLen == pattern.size() + 4 && _wcsnicmp(str, pattern.c_str(), pattern.size()) == 0 &&
-            _wcsnicmp(str + pattern.size(), L".exe", 4) == 0) {
-            return true;
-        }
-        return false;
-    };
+    wchar_t matchedProcess[MAX_PATH] = {};
 
+    BeginWhitelistScan(localWhitelist.processes);
     if (Process32FirstW(snapshot, &pe32)) {
         do {
-            const wchar_t* exeName = pe32.szExeFile;
-            size_t exeLen = wcslen(exeName);
-
-            for (const auto& pattern : localWhitelist) {
-                if (matchesPattern(exeName, exeLen, pattern)) {
-                    found = true;
-                    matchedProcess = pe32.szExeFile;
-                    break;
-                }
+            if (MatchesWhitelistSnapshot(pe32, localWhitelist)) {
+                found = true;
+                wcscpy_s(matchedProcess, pe32.szExeFile);
+                break;
             }
-            if (found) break;
         } while (Process32NextW(snapshot, &pe32));
     }
+    if (!found) EndWhitelistScan(localWhitelist.processes);   // Stale entries only known after a full scan
 
     CloseHandle(snapshot);
 
@@ -326,8 +321,8 @@ static void CheckVrrWhitelist() {
                 g_vrrWhitelistMatch = matchedProcess;
             }
             for (auto& ctx : g_monitors) {
-                if (ctx.hwnd) {
-                    ShowWindow(ctx.hwnd, SW_HIDE);
+                if (ctx->hwnd) {
+                    ShowWindow(ctx->hwnd, SW_HIDE);
                 }
             }
             std::wcout << L"VRR whitelist: detected " << matchedProcess << L", hiding overlays" << std::endl;
@@ -343,9 +338,9 @@ static void CheckVrrWhitelist() {
                 g_vrrWhitelistMatch.clear();
             }
             for (auto& ctx : g_monitors) {
-                if (ctx.hwnd && ctx.enabled && ctx.dcompCommitted) {
-                    SetLayeredWindowAttributes(ctx.hwnd, 0, 255, LWA_ALPHA);
-                    ShowWindow(ctx.hwnd, SW_SHOWNA);
+                if (ctx->hwnd && ctx->enabled && ctx->dcompCommitted) {
+                    SetLayeredWindowAttributes(ctx->hwnd, 0, 255, LWA_ALPHA);
+                    ShowWindow(ctx->hwnd, SW_SHOWNA);
                 }
             }
             std::wcout << L"VRR whitelist: " << exitedProcess << L" exited, showing overlays" << std::endl;
@@ -362,9 +357,12 @@ static void GammaWhitelistThreadFunc() {
         Sleep(50);  // 500ms total, in chunks for responsive shutdown
     }
 
+    static AllocProbe allocProbe{ "whitelist poll" };
     while (g_gammaWhitelistThreadRunning.load()) {
+        AllocProbeBegin(allocProbe);
         CheckGammaWhitelist();
         CheckVrrWhitelist();
+        AllocProbeEnd(allocProbe);
 
         // Sleep in small chunks to allow quick exit on shutdown
         for (int i = 0; i < 10 && g_gammaWhitelistThreadRunning.load(); i++) {
@@ -407,7 +405,7 @@ void StopGammaWhitelistThread() {
 
 // Create peak detection resources for dynamic tonemapping
 bool CreatePeakDetectionResources(MonitorContext* ctx) {
-    if (!g_peakDetectCS || !g_peakCB) {
+    if (!ctx->gpu->peakDetectCS || !ctx->gpu->peakCB) {
         return false;  // Compute shader not available
     }
 
@@ -422,7 +420,7 @@ bool CreatePeakDetectionResources(MonitorContext* ctx) {
     texDesc.Usage = D3D11_USAGE_DEFAULT;
     texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_UNORDERED_ACCESS;
 
-    HRESULT hr = g_device->CreateTexture2D(&texDesc, nullptr, &ctx->peakTexture);
+    HRESULT hr = ctx->gpu->device->CreateTexture2D(&texDesc, nullptr, &ctx->peakTexture);
     if (FAILED(hr)) {
         std::cerr << "Monitor " << ctx->index << " failed to create peak texture: 0x"
                   << std::hex << hr << std::dec << std::endl;
@@ -430,7 +428,7 @@ bool CreatePeakDetectionResources(MonitorContext* ctx) {
     }
 
     // Create UAV for compute shader write
-    hr = g_device->CreateUnorderedAccessView(ctx->peakTexture, nullptr, &ctx->peakUAV);
+    hr = ctx->gpu->device->CreateUnorderedAccessView(ctx->peakTexture, nullptr, &ctx->peakUAV);
     if (FAILED(hr)) {
         std::cerr << "Monitor " << ctx->index << " failed to create peak UAV: 0x"
                   << std::hex << hr << std::dec << std::endl;
@@ -440,7 +438,7 @@ bool CreatePeakDetectionResources(MonitorContext* ctx) {
     }
 
     // Create SRV for pixel shader read
-    hr = g_device->CreateShaderResourceView(ctx->peakTexture, nullptr, &ctx->peakSRV);
+    hr = ctx->gpu->device->CreateShaderResourceView(ctx->peakTexture, nullptr, &ctx->peakSRV);
     if (FAILED(hr)) {
         std::cerr << "Monitor " << ctx->index << " failed to create peak SRV: 0x"
                   << std::hex << hr << std::dec << std::endl;
@@ -455,6 +453,64 @@ bool CreatePeakDetectionResources(MonitorContext* ctx) {
     return true;
 }
 
+// HDR state, toggles and the active color correction; reads only MonitorContext's inline fields
+// and the shared gamut table
+void FillFrameConstants(const MonitorContext* ctx, bool gamutActive, float* cbData) {
+    FrameConstantInputs in;
+    in.isHDR = ctx->isHDREnabled;
+    in.sdrWhiteNits = g_sdrWhiteNits;
+    in.maxDisplayNits = ctx->maxDisplayNits;
+    in.lutSize = ctx->isHDREnabled ? ctx->lutSizeHDR : ctx->lutSizeSDR;
+    in.desktopGamma = g_desktopGammaMode.load();
+    in.tetrahedral = g_tetrahedralInterp.load();
+    in.passthrough = ctx->usePassthrough;
+    in.gamutActive = gamutActive;
+    in.cc = ctx->isHDREnabled ? &ctx->hdrColorCorrection : &ctx->sdrColorCorrection;
+    FillFrameConstants(in, cbData);
+}
+
+// Upload the gamut boundary descriptor for the active mode (t4), creating the texture on first use
+// Re-uploads only when the processing thread has rebuilt the descriptor (version changed)
+static bool UpdateGamutTexture(MonitorContext* ctx, bool isHDR) {
+    int idx = isHDR ? 1 : 0;
+    const GamutBoundaryData& gbd = isHDR ? *ctx->hdrColorCorrection.gamutBoundary : *ctx->sdrColorCorrection.gamutBoundary;
+
+    if (!ctx->gamutTexture[idx]) {
+        D3D11_TEXTURE2D_DESC texDesc = {};
+        texDesc.Width = GAMUT_HUE_STEPS;
+        texDesc.Height = GAMUT_LIGHTNESS_STEPS;
+        texDesc.MipLevels = 1;
+        texDesc.ArraySize = 1;
+        texDesc.Format = DXGI_FORMAT_R32_FLOAT;
+        texDesc.SampleDesc.Count = 1;
+        texDesc.Usage = D3D11_USAGE_DEFAULT;
+        texDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+        HRESULT hr = ctx->gpu->device->CreateTexture2D(&texDesc, nullptr, &ctx->gamutTexture[idx]);
+        if (FAILED(hr)) {
+            std::cerr << "Monitor " << ctx->index << " failed to create gamut texture: 0x"
+                      << std::hex << hr << std::dec << std::endl;
+            return false;
+        }
+        hr = ctx->gpu->device->CreateShaderResourceView(ctx->gamutTexture[idx], nullptr, &ctx->gamutSRV[idx]);
+        if (FAILED(hr)) {
+            std::cerr << "Monitor " << ctx->index << " failed to create gamut SRV: 0x"
+                      << std::hex << hr << std::dec << std::endl;
+            ctx->gamutTexture[idx]->Release();
+            ctx->gamutTexture[idx] = nullptr;
+            return false;
+        }
+        ctx->gamutUploadedVersion[idx] = 0;
+    }
+
+    if (ctx->gamutUploadedVersion[idx] != gbd.version) {
+        ctx->gpu->context->UpdateSubresource(ctx->gamutTexture[idx], 0, nullptr, gbd.maxChroma,
+                                     GAMUT_HUE_STEPS * sizeof(float), 0);
+        ctx->gamutUploadedVersion[idx] = gbd.version;
+    }
+    return true;
+}
+
 // Update HDR metadata on swapchain to tell Windows our content's peak brightness
 // This allows us to bypass Windows tonemapping by declaring our output peak
 void UpdateHDRMetadata(MonitorContext* ctx) {
@@ -501,9 +557,27 @@ void UpdateHDRMetadata(MonitorContext* ctx) {
     }
 }
 
+// Back buffer UAV for the tiled main pass, when the buffers were created with UAV usage
+// (GetBuffer(0) views follow the current back buffer like the RTV does)
+static void CreateBackBufferUAV(MonitorContext* ctx, ID3D11Texture2D* backBuffer) {
+    if (ctx->backBufferUAV) { ctx->backBufferUAV->Release(); ctx->backBufferUAV = nullptr; }
+    D3D11_TEXTURE2D_DESC desc;
+    backBuffer->GetDesc(&desc);
+    if (!(desc.BindFlags & D3D11_BIND_UNORDERED_ACCESS)) return;
+    HRESULT hr = ctx->gpu->device->CreateUnorderedAccessView(backBuffer, nullptr, &ctx->backBufferUAV);
+    if (FAILED(hr)) {
+        std::cerr << "Monitor " << ctx->index << " failed to create back buffer UAV: 0x"
+                  << std::hex << hr << std::dec << std::endl;
+        ctx->backBufferUAV = nullptr;
+    }
+}
+
 bool CreateSwapChain(MonitorContext* ctx) {
+    // New swapchain restarts present and refresh counts
+    PresentStatsReset(ctx->stats->presentStats);
+
     IDXGIDevice* dxgiDevice = nullptr;
-    if (FAILED(g_device->QueryInterface(IID_PPV_ARGS(&dxgiDevice))) || !dxgiDevice) {
+    if (FAILED(ctx->gpu->device->QueryInterface(IID_PPV_ARGS(&dxgiDevice))) || !dxgiDevice) {
         std::cerr << "Failed to get DXGI device for swapchain" << std::endl;
         return false;
     }
@@ -536,6 +610,12 @@ bool CreateSwapChain(MonitorContext* ctx) {
     scd.Format = ctx->swapchainFormat;
     scd.SampleDesc.Count = 1;
     scd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+    // Tiled main pass writes the back buffer as a UAV (only asked for while it's selected,
+    // some drivers drop render target compression for UAV-capable buffers)
+    ctx->cold->swapchainUAVRequested = g_tiledMainPass.load() && ctx->gpu->mainPassCS;
+    if (ctx->cold->swapchainUAVRequested) {
+        scd.BufferUsage |= DXGI_USAGE_UNORDERED_ACCESS;
+    }
     scd.BufferCount = 2;
     scd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
     scd.AlphaMode = DXGI_ALPHA_MODE_PREMULTIPLIED;
@@ -545,7 +625,13 @@ bool CreateSwapChain(MonitorContext* ctx) {
     }
 
     IDXGISwapChain1* swapchain1 = nullptr;
-    HRESULT hr = factory->CreateSwapChainForComposition(g_device, &scd, nullptr, &swapchain1);
+    HRESULT hr = DxCreateSwapChainForComposition(ctx, factory, &scd, &swapchain1);
+    if (FAILED(hr) && (scd.BufferUsage & DXGI_USAGE_UNORDERED_ACCESS)) {
+        std::cout << "Monitor " << ctx->index << " swapchain without UAV usage (0x" << std::hex << hr << std::dec
+                  << "), tiled main pass unavailable" << std::endl;
+        scd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        hr = DxCreateSwapChainForComposition(ctx, factory, &scd, &swapchain1);
+    }
 
     factory->Release();
     adapter->Release();
@@ -563,14 +649,14 @@ bool CreateSwapChain(MonitorContext* ctx) {
     // Set color space based on HDR state
     // HDR: scRGB linear (G10 = linear gamma, P709 = BT.709 primaries)
     // SDR: sRGB (G22 = 2.2 gamma, P709 = BT.709 primaries)
-    ctx->colorSpace = ctx->isHDREnabled ?
+    ctx->cold->colorSpace = ctx->isHDREnabled ?
         DXGI_COLOR_SPACE_RGB_FULL_G10_NONE_P709 :
         DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709;
 
     UINT colorSpaceSupport = 0;
-    hr = ctx->swapchain->CheckColorSpaceSupport(ctx->colorSpace, &colorSpaceSupport);
+    hr = ctx->swapchain->CheckColorSpaceSupport(ctx->cold->colorSpace, &colorSpaceSupport);
     if (SUCCEEDED(hr) && (colorSpaceSupport & DXGI_SWAP_CHAIN_COLOR_SPACE_SUPPORT_FLAG_PRESENT)) {
-        hr = ctx->swapchain->SetColorSpace1(ctx->colorSpace);
+        hr = ctx->swapchain->SetColorSpace1(ctx->cold->colorSpace);
         if (SUCCEEDED(hr)) {
             std::cout << "Monitor " << ctx->index << " color space: " << (ctx->isHDREnabled ? "scRGB linear (HDR)" : "sRGB (SDR)") << std::endl;
         }
@@ -588,14 +674,17 @@ bool CreateSwapChain(MonitorContext* ctx) {
     // but SetMaximumFrameLatency still limits the present queue to prevent frame buildup
     ctx->swapchain->SetMaximumFrameLatency(1);
 
-    // Create RTV
+    // Create RTV (and the UAV for the tiled main pass)
     ID3D11Texture2D* backBuffer = nullptr;
     hr = ctx->swapchain->GetBuffer(0, IID_PPV_ARGS(&backBuffer));
     if (FAILED(hr) || !backBuffer) {
         std::cerr << "Failed to get swapchain back buffer: 0x" << std::hex << hr << std::dec << std::endl;
         return false;
     }
-    hr = g_device->CreateRenderTargetView(backBuffer, nullptr, &ctx->rtv);
+    hr = ctx->gpu->device->CreateRenderTargetView(backBuffer, nullptr, &ctx->rtv);
+    if (SUCCEEDED(hr)) {
+        CreateBackBufferUAV(ctx, backBuffer);
+    }
     backBuffer->Release();
     if (FAILED(hr)) {
         std::cerr << "Failed to create RTV: 0x" << std::hex << hr << std::dec << std::endl;
@@ -615,37 +704,37 @@ bool InitDirectCompositionDevice() {
 }
 
 bool InitDirectComposition(MonitorContext* ctx) {
-    HRESULT hr = g_dcompDevice->CreateTargetForHwnd(ctx->hwnd, TRUE, &ctx->dcompTarget);
+    HRESULT hr = g_dcompDevice->CreateTargetForHwnd(ctx->hwnd, TRUE, &ctx->cold->dcompTarget);
     if (FAILED(hr)) {
         std::cerr << "CreateTargetForHwnd failed for monitor " << ctx->index << ": 0x" << std::hex << hr << std::dec << std::endl;
         return false;
     }
 
-    hr = g_dcompDevice->CreateVisual(&ctx->dcompVisual);
+    hr = g_dcompDevice->CreateVisual(&ctx->cold->dcompVisual);
     if (FAILED(hr)) {
         std::cerr << "CreateVisual failed for monitor " << ctx->index << ": 0x" << std::hex << hr << std::dec << std::endl;
-        ctx->dcompTarget->Release();
-        ctx->dcompTarget = nullptr;
+        ctx->cold->dcompTarget->Release();
+        ctx->cold->dcompTarget = nullptr;
         return false;
     }
 
-    hr = ctx->dcompVisual->SetContent(ctx->swapchain);
+    hr = ctx->cold->dcompVisual->SetContent(ctx->swapchain);
     if (FAILED(hr)) {
         std::cerr << "SetContent failed for monitor " << ctx->index << ": 0x" << std::hex << hr << std::dec << std::endl;
-        ctx->dcompVisual->Release();
-        ctx->dcompVisual = nullptr;
-        ctx->dcompTarget->Release();
-        ctx->dcompTarget = nullptr;
+        ctx->cold->dcompVisual->Release();
+        ctx->cold->dcompVisual = nullptr;
+        ctx->cold->dcompTarget->Release();
+        ctx->cold->dcompTarget = nullptr;
         return false;
     }
 
-    hr = ctx->dcompTarget->SetRoot(ctx->dcompVisual);
+    hr = ctx->cold->dcompTarget->SetRoot(ctx->cold->dcompVisual);
     if (FAILED(hr)) {
         std::cerr << "SetRoot failed for monitor " << ctx->index << ": 0x" << std::hex << hr << std::dec << std::endl;
-        ctx->dcompVisual->Release();
-        ctx->dcompVisual = nullptr;
-        ctx->dcompTarget->Release();
-        ctx->dcompTarget = nullptr;
+        ctx->cold->dcompVisual->Release();
+        ctx->cold->dcompVisual = nullptr;
+        ctx->cold->dcompTarget->Release();
+        ctx->cold->dcompTarget = nullptr;
         return false;
     }
 
@@ -660,11 +749,14 @@ void ResizeSwapChain(MonitorContext* ctx, int width, int height) {
         ctx->rtv->Release();
         ctx->rtv = nullptr;
     }
+    if (ctx->backBufferUAV) {
+        ctx->backBufferUAV->Release();
+        ctx->backBufferUAV = nullptr;
+    }
 
     UINT flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
     if (g_tearingSupported) flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
-    HRESULT hr = ctx->swapchain->ResizeBuffers(2, width, height,
-        ctx->swapchainFormat, flags);
+    HRESULT hr = DxResizeBuffers(ctx, width, height, flags);
 
     if (FAILED(hr)) {
         std::cerr << "Monitor " << ctx->index << " ResizeBuffers failed: 0x"
@@ -680,7 +772,10 @@ void ResizeSwapChain(MonitorContext* ctx, int width, int height) {
                   << std::hex << hr << std::dec << std::endl;
         return;
     }
-    hr = g_device->CreateRenderTargetView(backBuffer, nullptr, &ctx->rtv);
+    hr = ctx->gpu->device->CreateRenderTargetView(backBuffer, nullptr, &ctx->rtv);
+    if (SUCCEEDED(hr)) {
+        CreateBackBufferUAV(ctx, backBuffer);
+    }
     backBuffer->Release();
     if (FAILED(hr)) {
         std::cerr << "Monitor " << ctx->index << " CreateRTV failed after resize: 0x"
@@ -702,8 +797,8 @@ bool RecreateSwapchain(MonitorContext* ctx) {
     }
 
     // Clean up existing DirectComposition content
-    if (ctx->dcompVisual) {
-        ctx->dcompVisual->SetContent(nullptr);
+    if (ctx->cold->dcompVisual) {
+        ctx->cold->dcompVisual->SetContent(nullptr);
     }
 
     // Clean up existing swapchain resources
@@ -711,6 +806,10 @@ bool RecreateSwapchain(MonitorContext* ctx) {
         ctx->rtv->Release();
         ctx->rtv = nullptr;
     }
+    if (ctx->backBufferUAV) {
+        ctx->backBufferUAV->Release();
+        ctx->backBufferUAV = nullptr;
+    }
     if (ctx->swapchain) {
         ctx->swapchain->Release();
         ctx->swapchain = nullptr;
@@ -723,8 +822,8 @@ bool RecreateSwapchain(MonitorContext* ctx) {
     }
 
     // Rebind to DirectComposition (but don't commit yet - wait for first frame)
-    if (ctx->dcompVisual) {
-        ctx->dcompVisual->SetContent(ctx->swapchain);
+    if (ctx->cold->dcompVisual) {
+        ctx->cold->dcompVisual->SetContent(ctx->swapchain);
     }
     ctx->dcompCommitted = false;  // Will commit after first frame is rendered
     ctx->framesAfterCommit = 0;   // Reset frame counter for visibility delay
@@ -733,9 +832,184 @@ bool RecreateSwapchain(MonitorContext* ctx) {
     return true;
 }
 
+static double QpcToMs(LONGLONG qpc) {
+    static LARGE_INTEGER frequency = {};
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    return (double)qpc * 1000.0 / (double)frequency.QuadPart;
+}
+
+// Record the present just issued and fold in the swapchain's latest frame statistics
+// (which present the display showed, and at which vblank)
+static void SamplePresentStatistics(MonitorContext* ctx) {
+    UINT presentId = 0;
+    if (FAILED(ctx->swapchain->GetLastPresentCount(&presentId))) return;
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    PresentStatsOnPresent(ctx->stats->presentStats, presentId, QpcToMs(now.QuadPart));
+
+    DXGI_FRAME_STATISTICS fs = {};
+    HRESULT hr = ctx->swapchain->GetFrameStatistics(&fs);
+    if (hr == DXGI_ERROR_FRAME_STATISTICS_DISJOINT) {
+        PresentStatsReset(ctx->stats->presentStats);
+        return;
+    }
+    if (FAILED(hr)) return;  // No statistics yet (first presents) or unsupported
+
+    ctx->stats->presentStatsAvailable = true;
+    PresentStatsSample sample = { fs.PresentCount, fs.PresentRefreshCount, fs.SyncRefreshCount,
+                                  QpcToMs(fs.SyncQPCTime.QuadPart) };
+    PresentStatsOnSample(ctx->stats->presentStats, sample, ctx->refreshPeriodMs);
+}
+
+// Correction as a fullscreen pixel shader pass into the back buffer RTV
+static void RenderPixelShaderPass(MonitorContext* ctx, ID3D11ShaderResourceView* activeLUT, bool gamutActive) {
+    GpuDevice* gpu = ctx->gpu;
+    float clearColor[4] = { 0, 0, 0, 0 };
+    gpu->context->ClearRenderTargetView(ctx->rtv, clearColor);
+
+    D3D11_VIEWPORT vp = { 0, 0, (float)ctx->width, (float)ctx->height, 0, 1 };
+    gpu->context->RSSetViewports(1, &vp);
+    gpu->context->OMSetRenderTargets(1, &ctx->rtv, nullptr);
+
+    gpu->context->VSSetShader(gpu->vs, nullptr, 0);
+    gpu->context->PSSetShader(gpu->ps, nullptr, 0);
+    gpu->context->PSSetConstantBuffers(0, 1, &gpu->constantBuffer);
+    gpu->context->PSSetShaderResources(0, 1, &ctx->captureSRV);
+    gpu->context->PSSetShaderResources(1, 1, &activeLUT);
+    gpu->context->PSSetShaderResources(2, 1, &gpu->blueNoiseSRV);
+    // Bind peak texture for dynamic tonemapping (t3)
+    if (ctx->peakSRV) {
+        gpu->context->PSSetShaderResources(3, 1, &ctx->peakSRV);
+    }
+    // Bind gamut boundary descriptor for gamut compression (t4)
+    if (gamutActive) {
+        gpu->context->PSSetShaderResources(4, 1, &ctx->gamutSRV[ctx->isHDREnabled ? 1 : 0]);
+    }
+
+    ID3D11SamplerState* samplers[] = { gpu->samplerPoint, gpu->samplerLinear, gpu->samplerWrap };
+    gpu->context->PSSetSamplers(0, 3, samplers);
+
+    gpu->context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    gpu->context->Draw(3, 0);
+}
+
+// Tile record buffer for the tiled main pass, grown to the frame's tile count
+static bool EnsureTileStatsBuffer(MonitorContext* ctx, uint32_t tileCount) {
+    if (ctx->tileStatsBuffer && ctx->tileStatsCapacity >= tileCount) return true;
+    if (ctx->tileStatsSRV) { ctx->tileStatsSRV->Release(); ctx->tileStatsSRV = nullptr; }
+    if (ctx->tileStatsUAV) { ctx->tileStatsUAV->Release(); ctx->tileStatsUAV = nullptr; }
+    if (ctx->tileStatsBuffer) { ctx->tileStatsBuffer->Release(); ctx->tileStatsBuffer = nullptr; }
+    ctx->tileStatsCapacity = 0;
+
+    uint32_t elements = tileCount * TILE_STAT_UINTS;
+    D3D11_BUFFER_DESC bufDesc = {};
+    bufDesc.ByteWidth = elements * sizeof(uint32_t);
+    bufDesc.Usage = D3D11_USAGE_DEFAULT;
+    bufDesc.BindFlags = D3D11_BIND_UNORDERED_ACCESS | D3D11_BIND_SHADER_RESOURCE;
+    bufDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+    bufDesc.StructureByteStride = sizeof(uint32_t);
+    HRESULT hr = ctx->gpu->device->CreateBuffer(&bufDesc, nullptr, &ctx->tileStatsBuffer);
+    if (SUCCEEDED(hr)) {
+        D3D11_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
+        uavDesc.Format = DXGI_FORMAT_UNKNOWN;
+        uavDesc.ViewDimension = D3D11_UAV_DIMENSION_BUFFER;
+        uavDesc.Buffer.NumElements = elements;
+        hr = ctx->gpu->device->CreateUnorderedAccessView(ctx->tileStatsBuffer, &uavDesc, &ctx->tileStatsUAV);
+    }
+    if (SUCCEEDED(hr)) {
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+        srvDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        srvDesc.Buffer.NumElements = elements;
+        hr = ctx->gpu->device->CreateShaderResourceView(ctx->tileStatsBuffer, &srvDesc, &ctx->tileStatsSRV);
+    }
+    if (FAILED(hr)) {
+        std::cerr << "Monitor " << ctx->index << " failed to create tile statistics buffer: 0x"
+                  << std::hex << hr << std::dec << std::endl;
+        if (ctx->tileStatsUAV) { ctx->tileStatsUAV->Release(); ctx->tileStatsUAV = nullptr; }
+        if (ctx->tileStatsBuffer) { ctx->tileStatsBuffer->Release(); ctx->tileStatsBuffer = nullptr; }
+        return false;
+    }
+    ctx->tileStatsCapacity = tileCount;
+    return true;
+}
+
+// Correction as a compute pass over MAIN_PASS_TILE_SIZE tiles: each capture texel is read once,
+// corrected into the back buffer UAV and folded into its tile's statistics record; a one-group
+// reduction then updates the smoothed peak (dynamic tonemapping reads it next frame) and,
+// on analysis frames, the analysis buffer. LUT/CB/SRV bindings match the pixel shader path.
+static void RenderTiledMainPass(MonitorContext* ctx, ID3D11ShaderResourceView* activeLUT, bool gamutActive,
+                                bool updatePeak, bool collectAnalysis) {
+    GpuDevice* gpu = ctx->gpu;
+    TileGrid grid = MainPassTileGrid((uint32_t)ctx->width, (uint32_t)ctx->height);
+
+    D3D11_MAPPED_SUBRESOURCE mapped;
+    if (SUCCEEDED(gpu->context->Map(gpu->tileCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        uint32_t* udata = (uint32_t*)mapped.pData;
+        udata[0] = (uint32_t)ctx->width;
+        udata[1] = (uint32_t)ctx->height;
+        udata[2] = grid.x;
+        udata[3] = collectAnalysis ? 1 : 0;
+        gpu->context->Unmap(gpu->tileCB, 0);
+    }
+
+    // The back buffer can't be a render target and a UAV at once
+    gpu->context->OMSetRenderTargets(0, nullptr, nullptr);
+
+    ID3D11Buffer* cbs[] = { gpu->constantBuffer, gpu->tileCB };
+    ID3D11ShaderResourceView* srvs[] = { ctx->captureSRV, activeLUT, gpu->blueNoiseSRV, ctx->peakSRV,
+        gamutActive ? ctx->gamutSRV[ctx->isHDREnabled ? 1 : 0] : nullptr };
+    ID3D11SamplerState* samplers[] = { gpu->samplerPoint, gpu->samplerLinear, gpu->samplerWrap };
+    ID3D11UnorderedAccessView* uavs[] = { ctx->backBufferUAV, ctx->tileStatsUAV };
+    gpu->context->CSSetShader(gpu->mainPassCS, nullptr, 0);
+    gpu->context->CSSetConstantBuffers(0, 2, cbs);
+    gpu->context->CSSetShaderResources(0, 5, srvs);
+    gpu->context->CSSetSamplers(0, 3, samplers);
+    gpu->context->CSSetUnorderedAccessViews(0, 2, uavs, nullptr);
+    gpu->context->Dispatch(grid.x, grid.y, 1);
+
+    ID3D11UnorderedAccessView* nullUAVs[2] = {};
+    ID3D11ShaderResourceView* nullSRVs[5] = {};
+    gpu->context->CSSetUnorderedAccessViews(0, 2, nullUAVs, nullptr);
+    gpu->context->CSSetShaderResources(0, 5, nullSRVs);
+
+    // Reduce tile records (peak UAV and analysis UAV only when their results are wanted)
+    updatePeak = updatePeak && ctx->peakUAV;
+    collectAnalysis = collectAnalysis && ctx->stats->analysisUAV;
+    if (!updatePeak && !collectAnalysis) return;
+
+    if (SUCCEEDED(gpu->context->Map(gpu->tileReduceCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+        uint32_t* udata = (uint32_t*)mapped.pData;
+        udata[0] = grid.Count();
+        udata[1] = collectAnalysis ? 1 : 0;
+        udata[2] = updatePeak ? 1 : 0;
+        udata[3] = 0;  // pad
+        float* fdata = (float*)mapped.pData;
+        fdata[4] = DEFAULT_PEAK_SMOOTHING.riseRate;
+        fdata[5] = DEFAULT_PEAK_SMOOTHING.fallRate;
+        fdata[6] = DEFAULT_PEAK_SMOOTHING.maxRisePerFrame;
+        fdata[7] = DEFAULT_PEAK_SMOOTHING.maxFallPerFrame;
+        gpu->context->Unmap(gpu->tileReduceCB, 0);
+    }
+
+    ID3D11UnorderedAccessView* reduceUAVs[] = { updatePeak ? ctx->peakUAV : nullptr,
+        collectAnalysis ? ctx->stats->analysisUAV : nullptr };
+    gpu->context->CSSetShader(gpu->tileReduceCS, nullptr, 0);
+    gpu->context->CSSetConstantBuffers(0, 1, &gpu->tileReduceCB);
+    gpu->context->CSSetShaderResources(0, 1, &ctx->tileStatsSRV);
+    gpu->context->CSSetUnorderedAccessViews(0, 2, reduceUAVs, nullptr);
+    gpu->context->Dispatch(1, 1, 1);
+
+    gpu->context->CSSetUnorderedAccessViews(0, 2, nullUAVs, nullptr);
+    gpu->context->CSSetShaderResources(0, 1, nullSRVs);
+}
+
 void RenderMonitor(MonitorContext* ctx) {
     // Entry validation - skip if monitor is disabled
     if (!ctx || !ctx->enabled) return;
+    GpuDevice* gpu = ctx->gpu;
 
     // If resources are missing (failed reinit), try to recover with backoff
     if (!ctx->duplication) {
@@ -748,8 +1022,7 @@ void RenderMonitor(MonitorContext* ctx) {
 
         ctx->consecutiveFailures++;
         // Fast initial retry (50ms), exponential backoff to 5s for prolonged failures
-        int backoffMs = (std::min)(50 * (1 << (std::min)(ctx->consecutiveFailures - 1, 7)), 5000);
-        Sleep(backoffMs);
+        Sleep(BackoffDelayMs(DUPLICATION_BACKOFF, ctx->consecutiveFailures));
 
         if (ctx->consecutiveFailures % 10 == 0) {
             std::cout << "Monitor " << ctx->index << " attempting recovery, attempt "
@@ -762,6 +1035,7 @@ void RenderMonitor(MonitorContext* ctx) {
         if (InitDesktopDuplication(ctx)) {
             std::cout << "Monitor " << ctx->index << " recovery success" << std::endl;
             ctx->consecutiveFailures = 0;
+            MetricInc(ctx->metrics->duplicationRecoveries);
             // Window will be shown after first successful frame render
         }
         return;
@@ -769,24 +1043,42 @@ void RenderMonitor(MonitorContext* ctx) {
 
     if (!ctx->swapchain || !ctx->rtv) return;
 
+    // Tiled main pass switched on: back buffers need UAV usage, recreate once
+    if (g_tiledMainPass.load() && gpu->mainPassCS && !ctx->cold->swapchainUAVRequested) {
+        std::cout << "Monitor " << ctx->index << " recreating swapchain for the tiled main pass" << std::endl;
+        RecreateSwapchain(ctx);
+        return;
+    }
+
     // Acquire next frame from desktop duplication
     // First try with 0 timeout for immediate response to desktop changes (menus, etc.)
     // If no frame ready, use DwmFlush for pacing then wait with normal timeout
+    // While idle, skip compositor pacing and block longer in AcquireNextFrame instead
+    // (it returns as soon as the desktop changes, so the first new frame isn't delayed)
     DXGI_OUTDUPL_FRAME_INFO frameInfo;
     IDXGIResource* desktopResource = nullptr;
     bool frameAcquired = false;
 
-    HRESULT hr = ctx->duplication->AcquireNextFrame(0, &frameInfo, &desktopResource);
+    IdleState idleState = g_idleTracker.state;
+    HRESULT hr = DxAcquireNextFrame(ctx, 0, &frameInfo, &desktopResource);
     if (hr == DXGI_ERROR_WAIT_TIMEOUT) {
-        // No frame immediately available - sync to compositor
-        if (g_pfnWaitForCompositorClock) {
-            // Compositor Clock: VRR-aware timing (Windows 10 1903+)
-            g_pfnWaitForCompositorClock(0, nullptr, ctx->frameTimeMs);
-        } else {
-            // Fallback: DwmFlush (not VRR-aware but widely compatible)
-            DwmFlush();
+        if (IdleUseCompositorWait(idleState)) {
+            // No frame immediately available - sync to compositor
+            if (g_pfnWaitForCompositorClock) {
+                // Compositor Clock: VRR-aware timing (Windows 10 1903+)
+                g_pfnWaitForCompositorClock(0, nullptr, ctx->frameTimeMs);
+            } else {
+                // Fallback: DwmFlush (not VRR-aware but widely compatible)
+                DwmFlush();
+            }
+            IdleOnWakeup(g_idleTracker, std::chrono::steady_clock::now());
         }
-        hr = ctx->duplication->AcquireNextFrame(ctx->frameTimeMs, &frameInfo, &desktopResource);
+        int timeoutMs = IdleAcquireTimeoutMs(idleState, ctx->frameTimeMs, (int)g_monitors.size());
+        hr = DxAcquireNextFrame(ctx, timeoutMs, &frameInfo, &desktopResource);
+        IdleOnWakeup(g_idleTracker, std::chrono::steady_clock::now());
+    }
+    if (SUCCEEDED(hr)) {
+        IdleOnFrame(g_idleTracker, std::chrono::steady_clock::now());
     }
 
     if (hr == DXGI_ERROR_WAIT_TIMEOUT) {
@@ -794,6 +1086,8 @@ void RenderMonitor(MonitorContext* ctx) {
         // Reset watchdog since the duplication interface is working (just no desktop changes)
         // This prevents false watchdog triggers when monitor is off or desktop is static
         g_lastSuccessfulFrame = std::chrono::steady_clock::now();
+        // Copies queued by the last frames would otherwise wait for the desktop to change
+        PollIdleReadbacks(ctx->stats->readback);
         // Still need to handle initial visibility even without new frames
         // (window waits to be shown after DirectComposition commit)
         // Skip if VRR whitelist is hiding overlays (passthrough mode)
@@ -807,6 +1101,7 @@ void RenderMonitor(MonitorContext* ctx) {
         return;
     } else if (hr == DXGI_ERROR_ACCESS_LOST || FAILED(hr)) {
         // Desktop duplication lost or other error - hide overlay and release duplication
+        MetricInc(ctx->metrics->accessLost);
         if (ctx->hwnd && IsWindowVisible(ctx->hwnd)) {
             ShowWindow(ctx->hwnd, SW_HIDE);
         }
@@ -828,8 +1123,7 @@ void RenderMonitor(MonitorContext* ctx) {
 
         // Exponential backoff: 50ms, 100ms, 200ms, 400ms, 800ms, 1600ms, 3200ms, max 5s
         // Fast initial retry for transient issues, backs off for secure desktop (UAC) recovery
-        int backoffMs = (std::min)(50 * (1 << (std::min)(ctx->consecutiveFailures - 1, 7)), 5000);
-        Sleep(backoffMs);
+        Sleep(BackoffDelayMs(DUPLICATION_BACKOFF, ctx->consecutiveFailures));
 
         // Log occasionally (not every attempt)
         if (ctx->consecutiveFailures == 1 || ctx->consecutiveFailures % 10 == 0) {
@@ -844,6 +1138,7 @@ void RenderMonitor(MonitorContext* ctx) {
         if (ReinitDesktopDuplication(ctx)) {
             std::cout << "Monitor " << ctx->index << " reinit success" << std::endl;
             ctx->consecutiveFailures = 0;
+            MetricInc(ctx->metrics->duplicationRecoveries);
 
             if (ctx->isHDREnabled != ctx->wasHDREnabled) {
                 // Passthrough if no applicable LUT for current mode:
@@ -869,6 +1164,11 @@ void RenderMonitor(MonitorContext* ctx) {
     // Reset consecutive failures on successful frame acquisition
     ctx->consecutiveFailures = 0;
 
+    // Desktop updates duplication folded into this one were never rendered
+    if (frameInfo.AccumulatedFrames > 1) {
+        MetricInc(ctx->metrics->framesSkipped, frameInfo.AccumulatedFrames - 1);
+    }
+
     // Got a new frame - get the texture
     ID3D11Texture2D* frameTexture = nullptr;
     hr = desktopResource->QueryInterface(IID_PPV_ARGS(&frameTexture));
@@ -882,6 +1182,7 @@ void RenderMonitor(MonitorContext* ctx) {
     // Check if size changed
     D3D11_TEXTURE2D_DESC texDesc;
     frameTexture->GetDesc(&texDesc);
+    texDesc.Format = DxFrameFormat(ctx, texDesc.Format);
 
     if ((int)texDesc.Width != ctx->width || (int)texDesc.Height != ctx->height) {
         ctx->width = texDesc.Width;
@@ -927,7 +1228,7 @@ void RenderMonitor(MonitorContext* ctx) {
     srvDesc.Format = texDesc.Format;
     srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
     srvDesc.Texture2D.MipLevels = 1;
-    hr = g_device->CreateShaderResourceView(frameTexture, &srvDesc, &ctx->captureSRV);
+    hr = gpu->device->CreateShaderResourceView(frameTexture, &srvDesc, &ctx->captureSRV);
     frameTexture->Release();
 
     if (FAILED(hr)) {
@@ -935,192 +1236,135 @@ void RenderMonitor(MonitorContext* ctx) {
         return;
     }
 
+    // Gamut compression needs a built descriptor uploaded to t4
+    const auto& activeCC = ctx->isHDREnabled ? ctx->hdrColorCorrection : ctx->sdrColorCorrection;
+    bool gamutActive = activeCC.gamutCompression && activeCC.gamutBoundary &&
+                       UpdateGamutTexture(ctx, ctx->isHDREnabled);
+
     // Update constant buffer with current HDR state, gamma mode, and manual corrections
     D3D11_MAPPED_SUBRESOURCE mapped;
-    hr = g_context->Map(g_constantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    hr = gpu->context->Map(gpu->constantBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
     if (SUCCEEDED(hr)) {
-        float* cbData = (float*)mapped.pData;
-        // Row 0: Core settings
-        cbData[0] = ctx->isHDREnabled ? 1.0f : 0.0f;
-        cbData[1] = g_sdrWhiteNits;
-        cbData[2] = ctx->maxDisplayNits;
-        cbData[3] = (float)(ctx->isHDREnabled ? ctx->lutSizeHDR : ctx->lutSizeSDR);
-        // Row 1: Toggles
-        cbData[4] = g_desktopGammaMode.load() ? 1.0f : 0.0f;  // Desktop gamma toggle
-        cbData[5] = g_tetrahedralInterp.load() ? 1.0f : 0.0f; // Tetrahedral interpolation
-        cbData[6] = ctx->usePassthrough ? 1.0f : 0.0f;  // HDR passthrough (no LUT)
-        // Select color correction based on HDR state
-        const auto& cc = ctx->isHDREnabled ? ctx->hdrColorCorrection : ctx->sdrColorCorrection;
-        cbData[7] = (cc.primariesEnabled || cc.grayscale.enabled) ? 1.0f : 0.0f;  // useManualCorrection
-        // Row 2: Grayscale control + tonemapping toggles
-        cbData[8] = (float)cc.grayscale.pointCount;
-        cbData[9] = cc.grayscale.enabled ? 1.0f : 0.0f;
-        cbData[10] = (ctx->isHDREnabled && cc.tonemap.enabled) ? 1.0f : 0.0f;  // tonemapEnabled
-        cbData[11] = (float)static_cast<int>(cc.tonemap.curve);  // tonemapCurve
-        // Row 3-5: Primaries matrix (3 rows as float4, w unused)
-        cbData[12] = cc.primariesMatrix[0];
-        cbData[13] = cc.primariesMatrix[1];
-        cbData[14] = cc.primariesMatrix[2];
-        cbData[15] = 0.0f;
-        cbData[16] = cc.primariesMatrix[3];
-        cbData[17] = cc.primariesMatrix[4];
-        cbData[18] = cc.primariesMatrix[5];
-        cbData[19] = 0.0f;
-        cbData[20] = cc.primariesMatrix[6];
-        cbData[21] = cc.primariesMatrix[7];
-        cbData[22] = cc.primariesMatrix[8];
-        cbData[23] = 0.0f;
-        // Row 6: Tonemapping parameters
-        cbData[24] = cc.tonemap.sourcePeakNits;  // tonemapSourcePeak
-        cbData[25] = cc.tonemap.targetPeakNits;
-        cbData[26] = cc.tonemap.dynamicPeak ? 1.0f : 0.0f;  // tonemapDynamic
-        cbData[27] = cc.grayscale.use24Gamma ? 1.0f : 0.0f;  // grayscale24 (SDR 2.2->2.4 transform)
-        // Row 7: Grayscale peak + padding (white balance now handled by Bradford in primaries matrix)
-        cbData[28] = cc.grayscale.peakNits;  // grayscalePeakNits (HDR only)
-        cbData[29] = 0.0f;  // padding
-        cbData[30] = 0.0f;  // padding
-        cbData[31] = 0.0f;  // padding
-        // Row 8-15: Grayscale LUT (32 points packed into 8 float4s)
-        for (int i = 0; i < 32; i++) {
-            cbData[32 + i] = (i < cc.grayscale.pointCount)
-                ? cc.grayscale.points[i]
-                : ((float)i / 31.0f);  // Linear fallback
-        }
-        g_context->Unmap(g_constantBuffer, 0);
+        FillFrameConstants(ctx, gamutActive, (float*)mapped.pData);
+        gpu->context->Unmap(gpu->constantBuffer, 0);
     }
 
     // Select the appropriate LUT based on HDR mode (no fallback - SDR/HDR LUTs are incompatible)
     // If no applicable LUT, usePassthrough is true and shader skips LUT sampling
     ID3D11ShaderResourceView* activeLUT = ctx->isHDREnabled ? ctx->lutSRV_HDR : ctx->lutSRV_SDR;
 
+    // Tiled compute main pass: correction and statistics in one read of the capture
+    bool tiled = g_tiledMainPass.load() && ctx->backBufferUAV && gpu->mainPassCS && gpu->tileReduceCS &&
+                 EnsureTileStatsBuffer(ctx, MainPassTileGrid((uint32_t)ctx->width, (uint32_t)ctx->height).Count());
+
     // Run peak detection compute shader if dynamic tonemapping enabled
+    // (the tiled pass detects the peak itself; its result is used from the next frame)
     const auto& cc = ctx->isHDREnabled ? ctx->hdrColorCorrection : ctx->sdrColorCorrection;
-    if (ctx->isHDREnabled && cc.tonemap.enabled && cc.tonemap.dynamicPeak &&
-        g_peakDetectCS && g_peakCB && ctx->captureSRV) {
+    bool dynamicPeak = ctx->isHDREnabled && cc.tonemap.enabled && cc.tonemap.dynamicPeak &&
+                       gpu->peakDetectCS && gpu->peakCB && ctx->captureSRV;
+    if (dynamicPeak) {
         // Create peak resources on first use
         if (!ctx->peakTexture) {
             CreatePeakDetectionResources(ctx);
         }
 
         if (ctx->peakTexture && ctx->peakUAV) {
-            // Update peak constant buffer only when dimensions change (static values stay valid)
-            if (ctx->width != ctx->lastPeakCBWidth || ctx->height != ctx->lastPeakCBHeight) {
-                D3D11_MAPPED_SUBRESOURCE mapped;
-                if (SUCCEEDED(g_context->Map(g_peakCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
-                    // frameWidth/frameHeight are uint in shader, must write as uint
-                    uint32_t* udata = (uint32_t*)mapped.pData;
-                    udata[0] = (uint32_t)ctx->width;
-                    udata[1] = (uint32_t)ctx->height;
-                    float* fdata = (float*)mapped.pData;
-                    fdata[2] = 0.3f;    // riseRate - exponential rise (0.3 = 30% per frame)
-                    fdata[3] = 0.05f;   // fallRate - exponential fall (0.05 = 5% per frame)
-                    fdata[4] = 100.0f;  // maxRisePerFrame - slew limit (nits/frame)
-                    fdata[5] = 50.0f;   // maxFallPerFrame - slew limit (nits/frame)
-                    fdata[6] = 0.0f;    // padding
-                    fdata[7] = 0.0f;    // padding
-                    g_context->Unmap(g_peakCB, 0);
-                    ctx->lastPeakCBWidth = ctx->width;
-                    ctx->lastPeakCBHeight = ctx->height;
+            // Sampled peak detection pass (the tiled pass reduces the peak itself)
+            if (!tiled) {
+                // Update peak constant buffer only when dimensions change (static values stay valid)
+                if (ctx->width != ctx->lastPeakCBWidth || ctx->height != ctx->lastPeakCBHeight) {
+                    D3D11_MAPPED_SUBRESOURCE mapped;
+                    if (SUCCEEDED(gpu->context->Map(gpu->peakCB, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+                        // frameWidth/frameHeight are uint in shader, must write as uint
+                        uint32_t* udata = (uint32_t*)mapped.pData;
+                        udata[0] = (uint32_t)ctx->width;
+                        udata[1] = (uint32_t)ctx->height;
+                        float* fdata = (float*)mapped.pData;
+                        fdata[2] = DEFAULT_PEAK_SMOOTHING.riseRate;         // Exponential rise (30% per frame)
+                        fdata[3] = DEFAULT_PEAK_SMOOTHING.fallRate;         // Exponential fall (5% per frame)
+                        fdata[4] = DEFAULT_PEAK_SMOOTHING.maxRisePerFrame;  // Slew limit (nits/frame)
+                        fdata[5] = DEFAULT_PEAK_SMOOTHING.maxFallPerFrame;  // Slew limit (nits/frame)
+                        fdata[6] = 0.0f;    // padding
+                        fdata[7] = 0.0f;    // padding
+                        gpu->context->Unmap(gpu->peakCB, 0);
+                        ctx->lastPeakCBWidth = ctx->width;
+                        ctx->lastPeakCBHeight = ctx->height;
+                    }
                 }
-            }
-
-            // Dispatch compute shader
-            g_context->CSSetShader(g_peakDetectCS, nullptr, 0);
-            g_context->CSSetConstantBuffers(0, 1, &g_peakCB);
-            g_context->CSSetShaderResources(0, 1, &ctx->captureSRV);
-            g_context->CSSetUnorderedAccessViews(0, 1, &ctx->peakUAV, nullptr);
-            g_context->Dispatch(1, 1, 1);
 
-            // Unbind UAV to allow SRV binding
-            ID3D11UnorderedAccessView* nullUAV = nullptr;
-            g_context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
-            ID3D11ShaderResourceView* nullSRV = nullptr;
-            g_context->CSSetShaderResources(0, 1, &nullSRV);
+                // Dispatch compute shader
+                gpu->context->CSSetShader(gpu->peakDetectCS, nullptr, 0);
+                gpu->context->CSSetConstantBuffers(0, 1, &gpu->peakCB);
+                gpu->context->CSSetShaderResources(0, 1, &ctx->captureSRV);
+                gpu->context->CSSetUnorderedAccessViews(0, 1, &ctx->peakUAV, nullptr);
+                gpu->context->Dispatch(1, 1, 1);
+
+                // Unbind UAV to allow SRV binding
+                ID3D11UnorderedAccessView* nullUAV = nullptr;
+                gpu->context->CSSetUnorderedAccessViews(0, 1, &nullUAV, nullptr);
+                ID3D11ShaderResourceView* nullSRV = nullptr;
+                gpu->context->CSSetShaderResources(0, 1, &nullSRV);
+            }
 
             // Read detected peak for analysis overlay or debug logging
-            bool needPeakReadback = g_analysisEnabled.load() || g_logPeakDetection.load();
+            bool needPeakReadback = g_analysisEnabled.load() || IsAnalysisRecording() || g_logPeakDetection.load();
             if (needPeakReadback) {
-                // Throttle readback to once per second per monitor (analysis has its own display throttle)
-                static std::chrono::steady_clock::time_point lastReadback[8] = {};
+                // Throttle readback to twice per second per monitor (analysis has its own display throttle)
                 auto now = std::chrono::steady_clock::now();
-                int idx = ctx->index < 8 ? ctx->index : 0;
-
-                if (std::chrono::duration_cast<std::chrono::milliseconds>(now - lastReadback[idx]).count() >= 500) {
-                    // Create staging texture on first use
-                    if (!ctx->peakStagingTexture) {
-                        D3D11_TEXTURE2D_DESC stagingDesc = {};
-                        stagingDesc.Width = 1;
-                        stagingDesc.Height = 1;
-                        stagingDesc.MipLevels = 1;
-                        stagingDesc.ArraySize = 1;
-                        stagingDesc.Format = DXGI_FORMAT_R32_FLOAT;
-                        stagingDesc.SampleDesc.Count = 1;
-                        stagingDesc.Usage = D3D11_USAGE_STAGING;
-                        stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
-                        g_device->CreateTexture2D(&stagingDesc, nullptr, &ctx->peakStagingTexture);
+                if (std::chrono::duration_cast<std::chrono::milliseconds>(now - ctx->stats->lastPeakReadback).count() >= 500) {
+                    ReadbackManager& readback = MonitorReadbacks(ctx);
+                    if (ctx->stats->peakReadbackRing < 0) {
+                        ReadbackDesc desc;
+                        desc.width = 1;
+                        desc.height = 1;
+                        desc.format = DXGI_FORMAT_R32_FLOAT;
+                        ctx->stats->peakReadbackRing = AddReadbackRing(readback, "peak", desc, 2, 2,
+                            [ctx](const void* data, uint64_t) {
+                                float peakNits = *(const float*)data;  // Already in nits from compute shader
+                                ctx->stats->detectedPeakNits = peakNits;  // Store for analysis overlay
+                                MetricSet(ctx->metrics->peakNits, peakNits);
+                                if (g_logPeakDetection.load()) {
+                                    std::cout << "Monitor " << ctx->index << " detected peak: "
+                                              << std::fixed << std::setprecision(1) << peakNits << " nits" << std::endl;
+                                }
+                            });
                     }
-
-                    if (ctx->peakStagingTexture) {
-                        g_context->CopyResource(ctx->peakStagingTexture, ctx->peakTexture);
-                        D3D11_MAPPED_SUBRESOURCE mapped;
-                        if (SUCCEEDED(g_context->Map(ctx->peakStagingTexture, 0, D3D11_MAP_READ, 0, &mapped))) {
-                            float peakNits = *((float*)mapped.pData);  // Already in nits from compute shader
-                            g_context->Unmap(ctx->peakStagingTexture, 0);
-                            ctx->detectedPeakNits = peakNits;  // Store for analysis overlay
-                            if (g_logPeakDetection.load()) {
-                                std::cout << "Monitor " << ctx->index << " detected peak: "
-                                          << std::fixed << std::setprecision(1) << peakNits << " nits" << std::endl;
-                            }
-                        }
-                    }
-                    lastReadback[idx] = now;
+                    RequestReadback(readback, ctx->stats->peakReadbackRing, ctx->peakTexture);
+                    ctx->stats->lastPeakReadback = now;
                 }
             }
         }
     }
 
-    // Render
-    float clearColor[4] = { 0, 0, 0, 0 };
-    g_context->ClearRenderTargetView(ctx->rtv, clearColor);
+    // Analysis overlay and recording (passes granted by PlanAnalysisDispatches)
+    bool analysisActive = IsAnalysisDispatchFrame(ctx);
 
-    D3D11_VIEWPORT vp = { 0, 0, (float)ctx->width, (float)ctx->height, 0, 1 };
-    g_context->RSSetViewports(1, &vp);
-    g_context->OMSetRenderTargets(1, &ctx->rtv, nullptr);
-
-    g_context->VSSetShader(g_vs, nullptr, 0);
-    g_context->PSSetShader(g_ps, nullptr, 0);
-    g_context->PSSetConstantBuffers(0, 1, &g_constantBuffer);
-    g_context->PSSetShaderResources(0, 1, &ctx->captureSRV);
-    g_context->PSSetShaderResources(1, 1, &activeLUT);
-    g_context->PSSetShaderResources(2, 1, &g_blueNoiseSRV);
-    // Bind peak texture for dynamic tonemapping (t3)
-    if (ctx->peakSRV) {
-        g_context->PSSetShaderResources(3, 1, &ctx->peakSRV);
+    // Tiled pass: correct, detect peak and (on analysis frames) gather statistics in one dispatch
+    bool fusedAnalysis = false;
+    if (tiled) {
+        fusedAnalysis = analysisActive && (ctx->stats->analysisBuffer || CreateAnalysisResources(ctx));
+        RenderTiledMainPass(ctx, activeLUT, gamutActive, dynamicPeak, fusedAnalysis);
+    } else {
+        RenderPixelShaderPass(ctx, activeLUT, gamutActive);
     }
 
-    ID3D11SamplerState* samplers[] = { g_samplerPoint, g_samplerLinear, g_samplerWrap };
-    g_context->PSSetSamplers(0, 3, samplers);
-
-    g_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    g_context->Draw(3, 0);
-
-    // Analysis overlay (primary monitor only)
-    if (ctx->index == 0 && g_analysisEnabled.load()) {
-        DispatchAnalysisCompute(ctx);
-        UpdateAnalysisDisplay(ctx);
+    if (analysisActive) {
+        DispatchAnalysisCompute(ctx, fusedAnalysis);
     }
 
+    // Deliver peak/analysis/scope copies queued a few frames ago (never waits on the GPU)
+    PollReadbacks(ctx->stats->readback);
+    AdvanceReadbackFrame(ctx->stats->readback);
+
     // Present immediately - DwmFlush at start of loop handles sync
     UINT presentFlags = g_tearingSupported ? DXGI_PRESENT_ALLOW_TEARING : 0;
-    HRESULT presentHr = ctx->swapchain->Present(0, presentFlags);
+    HRESULT presentHr = DxPresent(ctx, 0, presentFlags);
 
     if (presentHr == DXGI_ERROR_DEVICE_REMOVED || presentHr == DXGI_ERROR_DEVICE_RESET) {
         std::cerr << "Monitor " << ctx->index << " device lost during Present: 0x"
                   << std::hex << presentHr << std::dec << std::endl;
-        if (g_device) {
-            HRESULT reason = g_device->GetDeviceRemovedReason();
-            std::cerr << "  Device removed reason: 0x" << std::hex << reason << std::dec << std::endl;
-        }
+        HRESULT reason = gpu->device->GetDeviceRemovedReason();
+        std::cerr << "  Device removed reason: 0x" << std::hex << reason << std::dec << std::endl;
         // Hide overlay immediately to prevent black screen blocking desktop
         if (ctx->hwnd) {
             ShowWindow(ctx->hwnd, SW_HIDE);
@@ -1130,25 +1374,29 @@ void RenderMonitor(MonitorContext* ctx) {
         // Successful frame - update watchdog timestamp
         g_lastSuccessfulFrame = std::chrono::steady_clock::now();
 
-        // Track frame timing for analysis overlay
-        if (ctx->lastFrameTime.time_since_epoch().count() > 0) {
+        SamplePresentStatistics(ctx);
+        MetricInc(ctx->metrics->framesRendered);
+
+        // Track frame timing for analysis overlay and metrics
+        if (ctx->stats->lastFrameTime.time_since_epoch().count() > 0) {
             auto now = std::chrono::steady_clock::now();
-            float frameMs = std::chrono::duration<float, std::milli>(now - ctx->lastFrameTime).count();
-            ctx->lastFrameTime = now;
+            float frameMs = std::chrono::duration<float, std::milli>(now - ctx->stats->lastFrameTime).count();
+            ctx->stats->lastFrameTime = now;
+            MetricObserve(ctx->metrics->frameTimeMs, frameMs);
 
             // Store in circular buffer
-            ctx->frameTimeHistory[ctx->frameTimeIndex] = frameMs;
-            ctx->frameTimeIndex = (ctx->frameTimeIndex + 1) % 64;
-            if (ctx->frameTimeCount < 64) ctx->frameTimeCount++;
+            ctx->stats->frameTimeHistory[ctx->stats->frameTimeIndex] = frameMs;
+            ctx->stats->frameTimeIndex = (ctx->stats->frameTimeIndex + 1) % 64;
+            if (ctx->stats->frameTimeCount < 64) ctx->stats->frameTimeCount++;
         } else {
-            ctx->lastFrameTime = std::chrono::steady_clock::now();
+            ctx->stats->lastFrameTime = std::chrono::steady_clock::now();
         }
 
         // Two-phase visibility: first commit DirectComposition, then show window on next frame
         // This prevents black flash by ensuring DirectComposition has processed the visual
         if (!ctx->dcompCommitted && g_dcompDevice) {
             // First successful frame: commit DirectComposition but don't show yet
-            g_context->Flush();
+            gpu->context->Flush();
             g_dcompDevice->Commit();
             ctx->dcompCommitted = true;
             ctx->framesAfterCommit = 0;  // Start counting frames after commit
@@ -1173,87 +1421,101 @@ void RenderMonitor(MonitorContext* ctx) {
 void RenderAll() {
     int activeCount = 0;
 
-    // Check device health periodically (not every frame - driver call has some overhead)
-    static int deviceCheckCounter = 0;
-    if (++deviceCheckCounter >= 60) {  // Check every ~60 frames (~1 second at 60Hz)
-        deviceCheckCounter = 0;
-        if (g_device) {
-            HRESULT reason = g_device->GetDeviceRemovedReason();
-            if (reason != S_OK) {
-                std::cerr << "GPU device lost (TDR/driver crash): 0x" << std::hex << reason << std::dec << std::endl;
-                // Hide all overlay windows immediately to prevent black screen
-                for (auto& ctx : g_monitors) {
-                    if (ctx.hwnd) {
-                        ShowWindow(ctx.hwnd, SW_HIDE);
-                    }
-                }
+    // Update idle tier once per pass - drives wait lengths and housekeeping cadences below
+    auto now = std::chrono::steady_clock::now();
+    IdleState idleState = IdleUpdate(g_idleTracker, now, g_adaptiveIdle.load());
 
-                // Attempt recovery once
-                if (AttemptDeviceRecovery()) {
-                    // Recovery succeeded - reset watchdog and continue
-                    g_lastSuccessfulFrame = std::chrono::steady_clock::now();
-                    std::cout << "Resuming after TDR recovery" << std::endl;
-                    return;
+    // Check device health periodically (not every frame - driver call has some overhead)
+    // Interval stretches while idle; device loss also surfaces through AcquireNextFrame
+    static auto lastHealthCheck = now;
+    bool healthCheckDue = IdleHealthCheckDue(lastHealthCheck, now, idleState);
+    if (healthCheckDue) {
+        // Any lost device triggers a full regroup (TDR usually takes the whole driver down)
+        HRESULT reason = S_OK;
+        for (const auto& gpu : g_gpuDevices) {
+            reason = gpu->device ? DxGetDeviceRemovedReason(gpu->device) : S_OK;
+            if (reason != S_OK) break;
+        }
+        if (reason != S_OK) {
+            std::cerr << "GPU device lost (TDR/driver crash): 0x" << std::hex << reason << std::dec << std::endl;
+            // Hide all overlay windows immediately to prevent black screen
+            for (auto& ctx : g_monitors) {
+                if (ctx->hwnd) {
+                    ShowWindow(ctx->hwnd, SW_HIDE);
                 }
+            }
 
-                // Recovery failed - exit with error sound
-                std::cerr << "TDR recovery failed, exiting" << std::endl;
-                MessageBeep(MB_ICONERROR);
-                for (auto& ctx : g_monitors) {
-                    ctx.enabled = false;
-                }
-                g_running = false;
+            // Attempt recovery once
+            if (AttemptDeviceRecovery()) {
+                // Recovery succeeded - reset watchdog and continue
+                MetricInc(g_metrics.tdrRecoveries);
+                g_lastSuccessfulFrame = std::chrono::steady_clock::now();
+                std::cout << "Resuming after TDR recovery" << std::endl;
                 return;
             }
+
+            // Recovery failed - exit with error sound
+            MetricInc(g_metrics.tdrRecoveryFailures);
+            std::cerr << "TDR recovery failed, exiting" << std::endl;
+            MessageBeep(MB_ICONERROR);
+            for (auto& ctx : g_monitors) {
+                ctx->enabled = false;
+            }
+            g_running = false;
+            return;
         }
     }
 
     // Watchdog: if no successful frame for N seconds, exit gracefully
     // This catches cases where device appears healthy but rendering is stuck
-    auto timeSinceLastFrame = std::chrono::steady_clock::now() - g_lastSuccessfulFrame;
-    if (timeSinceLastFrame > std::chrono::seconds(WATCHDOG_TIMEOUT_SECONDS)) {
+    // Evaluated on the health check cadence (interval always well below the timeout)
+    if (healthCheckDue && WatchdogExpired(g_lastSuccessfulFrame, now, WATCHDOG_TIMEOUT_SECONDS * 1000)) {
         std::cerr << "Watchdog timeout: no successful frame for " << WATCHDOG_TIMEOUT_SECONDS << " seconds" << std::endl;
+        MetricInc(g_metrics.watchdogTrips);
         MessageBeep(MB_ICONERROR);
         // Hide all overlay windows
         for (auto& ctx : g_monitors) {
-            if (ctx.hwnd) {
-                ShowWindow(ctx.hwnd, SW_HIDE);
+            if (ctx->hwnd) {
+                ShowWindow(ctx->hwnd, SW_HIDE);
             }
-            ctx.enabled = false;
+            ctx->enabled = false;
         }
         g_running = false;
         return;
     }
 
-    // Check for forced reinit (e.g., resume from sleep)
-    if (g_forceReinit.exchange(false)) {
-        std::cout << "Forcing reinit of all monitors..." << std::endl;
-        // Give system time to stabilize after wake
-        Sleep(500);
-        // Release all duplication interfaces to force reinit
-        for (auto& ctx : g_monitors) {
-            if (ctx.duplication) {
-                ctx.duplication->Release();
-                ctx.duplication = nullptr;
-            }
-            ctx.consecutiveFailures = 0;  // Reset backoff
-        }
-        // Reset watchdog to avoid timeout during recovery
+    // Display changes (wake, hotplug, mode/HDR/arrangement changes) are reconciled once the
+    // burst of notifications has settled; monitors keep rendering in the meantime
+    static TopologySettle topologySettle;
+    int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count();
+    bool resumeEvent = g_forceReinit.exchange(false);
+    bool topologyEvent = g_topologyChanged.exchange(false);
+    if (resumeEvent || topologyEvent) {
+        NoteTopologyEvent(topologySettle, nowMs, resumeEvent);
+        // Reset watchdog to avoid timeout while displays come back
+        g_lastSuccessfulFrame = std::chrono::steady_clock::now();
+    }
+    bool resumed = false;
+    if (TopologySettled(topologySettle, nowMs, TOPOLOGY_SETTLE_MS, resumed)) {
+        std::cout << "Reconciling display topology" << (resumed ? " after wake" : "") << "..." << std::endl;
+        ReconcileTopology(resumed);
         g_lastSuccessfulFrame = std::chrono::steady_clock::now();
-        // Reapply MaxTML settings (may be lost after sleep/wake)
-        ApplyMaxTmlSettings();
-        // Force TOPMOST reassert after wake (z-order most likely disrupted)
+        if (resumed) {
+            // Reapply MaxTML settings (may be lost after sleep/wake)
+            ApplyMaxTmlSettings();
+        }
+        // Force TOPMOST reassert (z-order most likely disrupted)
         g_forceTopmostReassert.store(true);
     }
 
     // Periodically reassert TOPMOST to prevent other windows pushing us down
     static auto lastTopmost = std::chrono::steady_clock::now();
-    auto now = std::chrono::steady_clock::now();
+    now = std::chrono::steady_clock::now();
     bool forceReassert = g_forceTopmostReassert.exchange(false);
-    if (forceReassert || std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTopmost).count() >= 2000) {
+    if (forceReassert || std::chrono::duration_cast<std::chrono::milliseconds>(now - lastTopmost).count() >= IdleTopmostIntervalMs(idleState)) {
         for (auto& ctx : g_monitors) {
-            if (ctx.hwnd) {
-                SetWindowPos(ctx.hwnd, HWND_TOPMOST, 0, 0, 0, 0,
+            if (ctx->hwnd) {
+                SetWindowPos(ctx->hwnd, HWND_TOPMOST, 0, 0, 0, 0,
                     SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
             }
         }
@@ -1272,29 +1534,44 @@ void RenderAll() {
     if (g_hasPendingColorCorrections.load(std::memory_order_acquire)) {
         std::lock_guard<std::mutex> lock(g_colorCorrectionMutex);
         for (const auto& update : g_pendingColorCorrections) {
-            if (update.monitorIndex >= 0 && update.monitorIndex < (int)g_monitors.size()) {
-                auto& ctx = g_monitors[update.monitorIndex];
+            KeepTopologyCorrection(update.monitorIndex, update.isHDR, update.data);
+            // monitorIndex is the display index, not the position in g_monitors (skipped monitors leave gaps)
+            for (auto& ctx : g_monitors) {
+                if (ctx->index != update.monitorIndex) continue;
                 if (update.isHDR) {
-                    ctx.hdrColorCorrection = update.data;
+                    ctx->hdrColorCorrection = update.data;
                     // HDR metadata (MaxCLL=10000) is set once at swapchain creation
                     // and doesn't change based on color correction settings
                 } else {
-                    ctx.sdrColorCorrection = update.data;
+                    ctx->sdrColorCorrection = update.data;
                 }
+                break;
             }
         }
         g_pendingColorCorrections.clear();
         g_hasPendingColorCorrections.store(false, std::memory_order_release);
     }
 
+    // Streamed LUT boxes/matrices land after file-based corrections so they win
+    ApplyLiveLutUpdates();
+
+    // Share this pass's analysis GPU budget out between the monitors
+    PlanAnalysisDispatches();
+
+    int parkedCount = 0;
     for (auto& ctx : g_monitors) {
-        if (ctx.enabled) {
-            RenderMonitor(&ctx);
+        if (ctx->enabled) {
+            RenderMonitor(ctx.get());
             activeCount++;
+        } else if (ctx->cold->detached) {
+            parkedCount++;
         }
     }
-    // Only stop if ALL monitors have failed
-    if (activeCount == 0 && !g_monitors.empty()) {
+    // Only stop if ALL monitors have failed - parked ones are waiting for their display
+    if (activeCount == 0 && parkedCount > 0) {
+        g_lastSuccessfulFrame = std::chrono::steady_clock::now();
+        Sleep(100);  // Minimal CPU usage while waiting
+    } else if (activeCount == 0 && !g_monitors.empty()) {
         std::cerr << "All monitors failed, stopping" << std::endl;
         g_running = false;
     }
@@ -1317,7 +1594,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
             // Check if any monitor is in HDR mode
             bool anyHDR = false;
             for (const auto& ctx : g_monitors) {
-                if (ctx.isHDREnabled) {
+                if (ctx->isHDREnabled) {
                     anyHDR = true;
                     break;
                 }
@@ -1363,6 +1640,10 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
     case WM_TIMER:
         HideOSD();
         return 0;
+    case WM_DISPLAYCHANGE:
+        // Sent to every top-level window for each mode, arrangement or monitor set change
+        g_topologyChanged.store(true);
+        return 0;
     case WM_POWERBROADCAST:
         // Handle power events for sleep/wake recovery
         if (wParam == PBT_APMRESUMEAUTOMATIC || wParam == PBT_APMRESUMESUSPEND) {
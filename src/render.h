@@ -4,6 +4,7 @@
 #pragma once
 
 #include "types.h"
+#include "frameconstants.h"
 
 // Create swapchain for a monitor
 bool CreateSwapChain(MonitorContext* ctx);
@@ -29,6 +30,10 @@ void ResizeSwapChain(MonitorContext* ctx, int width, int height);
 // Render a single monitor
 void RenderMonitor(MonitorContext* ctx);
 
+// Fill the main constant buffer for a monitor's current mode (CPU side of RenderMonitor, layout
+// in frameconstants.h)
+void FillFrameConstants(const MonitorContext* ctx, bool gamutActive, float* cbData);
+
 // Main render loop for all monitors
 void RenderAll();
 
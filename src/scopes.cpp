@@ -0,0 +1,129 @@
+// DesktopLUT - scopes.cpp
+// Waveform, vectorscope and CIE xy scope binning: layout shared with the GPU pass,
+// CPU reference binning and display normalization
+
+#include "scopes.h"
+#include <algorithm>
+#include <cmath>
+
+// BT.709 luma and Cb/Cr scale (same constants as the shader)
+static const float LUMA_R = 0.2126f, LUMA_G = 0.7152f, LUMA_B = 0.0722f;
+static const float CB_SCALE = 1.8556f, CR_SCALE = 1.5748f;
+
+// ST 2084 constants
+static const float PQ_M1 = 0.1593017578125f;
+static const float PQ_M2 = 78.84375f;
+static const float PQ_C1 = 0.8359375f;
+static const float PQ_C2 = 18.8515625f;
+static const float PQ_C3 = 18.6875f;
+
+static float PQEncode(float nits) {
+    float y = std::clamp(nits / 10000.0f, 0.0f, 1.0f);
+    float p = powf(y, PQ_M1);
+    return powf((PQ_C1 + PQ_C2 * p) / (1.0f + PQ_C3 * p), PQ_M2);
+}
+
+static float SRGBToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+// floor(v * n) clamped to [0, n-1] (NaN lands in bin 0)
+static uint32_t BinIndex(float v, uint32_t n) {
+    float f = floorf(v * (float)n);
+    if (!(f >= 0.0f)) return 0;
+    return f >= (float)(n - 1) ? n - 1 : (uint32_t)f;
+}
+
+static uint32_t ISqrt(uint64_t v) {
+    uint64_t r = (uint64_t)sqrt((double)v);
+    while (r * r > v) r--;
+    while ((r + 1) * (r + 1) <= v) r++;
+    return (uint32_t)r;
+}
+
+ScopeGrid ScopeSampleGrid(uint32_t frameWidth, uint32_t frameHeight) {
+    ScopeGrid grid = { 1, 1 };
+    if (frameWidth == 0 || frameHeight == 0) return grid;
+    // gridX = sqrt(N * aspect), gridY = sqrt(N / aspect), never more than one sample per pixel
+    grid.x = ISqrt((uint64_t)SCOPE_TARGET_SAMPLES * frameWidth / frameHeight);
+    grid.y = ISqrt((uint64_t)SCOPE_TARGET_SAMPLES * frameHeight / frameWidth);
+    grid.x = std::clamp(grid.x, 1u, frameWidth);
+    grid.y = std::clamp(grid.y, 1u, frameHeight);
+    return grid;
+}
+
+void ScopeBinPixel(float r, float g, float b, uint32_t px, uint32_t frameWidth, bool isHDR, uint32_t* bins) {
+    // Signal values: SDR scopes show the encoded signal, HDR scopes show PQ (one scale for 0-10k nits)
+    float er, eg, eb, level;
+    float lr, lg, lb;
+    if (isHDR) {
+        lr = r; lg = g; lb = b;
+        er = PQEncode((std::max)(r, 0.0f) * 80.0f);
+        eg = PQEncode((std::max)(g, 0.0f) * 80.0f);
+        eb = PQEncode((std::max)(b, 0.0f) * 80.0f);
+        float y = LUMA_R * lr + LUMA_G * lg + LUMA_B * lb;
+        level = PQEncode((std::max)(y, 0.0f) * 80.0f);
+    } else {
+        er = r; eg = g; eb = b;
+        level = LUMA_R * r + LUMA_G * g + LUMA_B * b;
+        lr = SRGBToLinear(r); lg = SRGBToLinear(g); lb = SRGBToLinear(b);
+    }
+
+    // Waveform: column from frame x, row from luma (top = 1.0)
+    uint32_t col = (uint32_t)((uint64_t)px * SCOPE_WAVEFORM_WIDTH / frameWidth);
+    uint32_t row = SCOPE_WAVEFORM_HEIGHT - 1 - BinIndex(level, SCOPE_WAVEFORM_HEIGHT);
+    bins[SCOPE_WAVEFORM_OFFSET + row * SCOPE_WAVEFORM_WIDTH + col]++;
+
+    // Vectorscope: Cb/Cr of the encoded signal, +-0.5 full scale
+    float ey = LUMA_R * er + LUMA_G * eg + LUMA_B * eb;
+    float cb = (eb - ey) / CB_SCALE;
+    float cr = (er - ey) / CR_SCALE;
+    uint32_t vx = BinIndex(cb + 0.5f, SCOPE_VECTOR_SIZE);
+    uint32_t vy = SCOPE_VECTOR_SIZE - 1 - BinIndex(cr + 0.5f, SCOPE_VECTOR_SIZE);
+    bins[SCOPE_VECTOR_OFFSET + vy * SCOPE_VECTOR_SIZE + vx]++;
+
+    // CIE 1931 xy of the linear BT.709 value (scRGB negatives reach outside the 709 triangle)
+    float X = 0.4124f * lr + 0.3576f * lg + 0.1805f * lb;
+    float Y = 0.2126f * lr + 0.7152f * lg + 0.0722f * lb;
+    float Z = 0.0193f * lr + 0.1192f * lg + 0.9505f * lb;
+    float sum = X + Y + Z;
+    if (Y > SCOPE_CIE_LUMINANCE_FLOOR && sum > 1e-6f) {
+        float x = X / sum;
+        float y = Y / sum;
+        if (x >= 0.0f && x < SCOPE_CIE_MAX_X && y >= 0.0f && y < SCOPE_CIE_MAX_Y) {
+            uint32_t cx = BinIndex(x / SCOPE_CIE_MAX_X, SCOPE_CIE_SIZE);
+            uint32_t cy = SCOPE_CIE_SIZE - 1 - BinIndex(y / SCOPE_CIE_MAX_Y, SCOPE_CIE_SIZE);
+            bins[SCOPE_CIE_OFFSET + cy * SCOPE_CIE_SIZE + cx]++;
+        }
+    }
+}
+
+void AccumulateScopes(const float* rgba, uint32_t width, uint32_t height, size_t rowStride,
+                      bool isHDR, uint32_t* bins) {
+    ScopeGrid grid = ScopeSampleGrid(width, height);
+    for (uint32_t gy = 0; gy < grid.y; gy++) {
+        uint32_t py = (uint32_t)((uint64_t)gy * height / grid.y);
+        const float* row = rgba + py * rowStride;
+        for (uint32_t gx = 0; gx < grid.x; gx++) {
+            uint32_t px = (uint32_t)((uint64_t)gx * width / grid.x);
+            const float* p = row + (size_t)px * 4;
+            ScopeBinPixel(p[0], p[1], p[2], px, width, isHDR, bins);
+        }
+    }
+}
+
+void NormalizeScopeBins(const uint32_t* bins, int count, uint8_t* out) {
+    uint32_t maxCount = 0;
+    for (int i = 0; i < count; i++) {
+        maxCount = (std::max)(maxCount, bins[i]);
+    }
+    if (maxCount == 0) {
+        std::fill(out, out + count, (uint8_t)0);
+        return;
+    }
+    // Log scale keeps single hits visible next to a dominant flat background
+    float scale = 255.0f / logf(1.0f + (float)maxCount);
+    for (int i = 0; i < count; i++) {
+        out[i] = bins[i] ? (uint8_t)(std::max)(24.0f, logf(1.0f + (float)bins[i]) * scale) : 0;
+    }
+}
@@ -0,0 +1,52 @@
+// DesktopLUT - scopes.h
+// Waveform, vectorscope and CIE xy scope binning: layout shared with the GPU pass,
+// CPU reference binning and display normalization
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Bin buffer layout (uint counts, row-major, row 0 at the top):
+//   waveform     SCOPE_WAVEFORM_WIDTH columns (frame x) x SCOPE_WAVEFORM_HEIGHT rows (luma, 1.0 at top)
+//   vectorscope  SCOPE_VECTOR_SIZE^2, Cb left->right, Cr bottom->top, center = neutral
+//   CIE xy       SCOPE_CIE_SIZE^2, x 0..SCOPE_CIE_MAX_X, y 0..SCOPE_CIE_MAX_Y (bottom->top)
+// The scope compute shader in shader.h bins with the same math; keep the two in step.
+constexpr int SCOPE_WAVEFORM_WIDTH = 128;
+constexpr int SCOPE_WAVEFORM_HEIGHT = 64;
+constexpr int SCOPE_VECTOR_SIZE = 64;
+constexpr int SCOPE_CIE_SIZE = 64;
+
+constexpr int SCOPE_WAVEFORM_OFFSET = 0;
+constexpr int SCOPE_VECTOR_OFFSET = SCOPE_WAVEFORM_OFFSET + SCOPE_WAVEFORM_WIDTH * SCOPE_WAVEFORM_HEIGHT;
+constexpr int SCOPE_CIE_OFFSET = SCOPE_VECTOR_OFFSET + SCOPE_VECTOR_SIZE * SCOPE_VECTOR_SIZE;
+constexpr int SCOPE_BIN_COUNT = SCOPE_CIE_OFFSET + SCOPE_CIE_SIZE * SCOPE_CIE_SIZE;   // 64KB readback
+
+constexpr float SCOPE_CIE_MAX_X = 0.8f;
+constexpr float SCOPE_CIE_MAX_Y = 0.9f;
+
+// Samples per dispatch (aspect-ratio-aware grid, ~8x the stats pass so scopes fill in)
+constexpr uint32_t SCOPE_TARGET_SAMPLES = 32768;
+constexpr uint32_t SCOPE_THREAD_GROUP = 16;          // numthreads(16, 16, 1)
+
+// Pixels darker than this (linear, 1.0 = 80 nits) carry no usable chromaticity
+constexpr float SCOPE_CIE_LUMINANCE_FLOOR = 0.00125f;
+
+struct ScopeGrid {
+    uint32_t x;
+    uint32_t y;
+};
+
+// Sample grid for a frame (integer math so the CPU and the constant buffer agree exactly)
+ScopeGrid ScopeSampleGrid(uint32_t frameWidth, uint32_t frameHeight);
+
+// Bin one sample as the shader loads it: SDR = sRGB-encoded 0-1, HDR = scRGB linear
+void ScopeBinPixel(float r, float g, float b, uint32_t px, uint32_t frameWidth, bool isHDR, uint32_t* bins);
+
+// CPU reference: sample an RGBA float frame on the scope grid and add into bins
+// (SCOPE_BIN_COUNT entries, not cleared). rowStride is in floats.
+void AccumulateScopes(const float* rgba, uint32_t width, uint32_t height, size_t rowStride,
+                      bool isHDR, uint32_t* bins);
+
+// Log-scale one scope's counts to 0-255 intensities (max bin = 255, empty = 0)
+void NormalizeScopeBins(const uint32_t* bins, int count, uint8_t* out);
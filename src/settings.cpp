@@ -3,7 +3,13 @@
 
 #include "settings.h"
 #include "globals.h"
+#include "whitelist.h"
+#include "lutstack.h"
+#include "analysissched.h"
 #include <cwchar>
+#include <cwctype>
+#include <iostream>
+#include <unordered_set>
 
 std::wstring GetIniPath() {
     wchar_t exePath[MAX_PATH];
@@ -16,6 +22,36 @@ std::wstring GetIniPath() {
     return path + L"DesktopLUT.ini";
 }
 
+std::wstring GetDisplayDbPath() {
+    std::wstring path = GetIniPath();
+    size_t lastSlash = path.find_last_of(L"\\/");
+    return path.substr(0, lastSlash + 1) + L"DesktopLUT-displays.db";
+}
+
+// Lowercased section names present in the INI (one read)
+static std::unordered_set<std::wstring> ReadSectionNames(const wchar_t* iniPath) {
+    std::unordered_set<std::wstring> names;
+    std::vector<wchar_t> buf(4096);
+    DWORD len;
+    // Returns size - 2 when the buffer is too small
+    while ((len = GetPrivateProfileSectionNamesW(buf.data(), (DWORD)buf.size(), iniPath)) == buf.size() - 2) {
+        buf.resize(buf.size() * 2);
+    }
+    for (const wchar_t* p = buf.data(); *p; p += wcslen(p) + 1) {
+        std::wstring name(p);
+        for (auto& c : name) c = (wchar_t)towlower(c);
+        names.insert(name);
+    }
+    return names;
+}
+
+// Section per monitor; without identities (benchmark fixtures, EDIDs unreadable) the index sections
+static std::vector<MonitorSectionPlan> MonitorSectionsFor(size_t monitorCount, const wchar_t* iniPath) {
+    std::vector<uint64_t> hashes = g_gui.monitorEdidHashes;
+    hashes.resize(monitorCount, 0);
+    return PlanMonitorSections(hashes, ReadSectionNames(iniPath));
+}
+
 void WritePrivateProfileFloat(const wchar_t* section, const wchar_t* key, float value, const wchar_t* file) {
     wchar_t buf[32];
     swprintf_s(buf, L"%.4f", value);
@@ -101,6 +137,7 @@ void SaveColorCorrectionSettings(const wchar_t* section, const wchar_t* prefix,
         cc.customPrimaries.Bx, cc.customPrimaries.By, iniPath);
     WritePrivateProfileXY(section, (p + L"PrimariesWhite").c_str(),
         cc.customPrimaries.Wx, cc.customPrimaries.Wy, iniPath);
+    WritePrivateProfileBool(section, (p + L"GamutCompression").c_str(), cc.gamutCompression, iniPath);
 
     WritePrivateProfileBool(section, (p + L"GrayscaleEnabled").c_str(), cc.grayscale.enabled, iniPath);
     wchar_t pointsBuf[8];
@@ -172,6 +209,7 @@ void LoadColorCorrectionSettings(const wchar_t* section, const wchar_t* prefix,
         cc.customPrimaries.Wx = 0.3127f;
         cc.customPrimaries.Wy = 0.329f;
     }
+    cc.gamutCompression = GetPrivateProfileBool(section, (p + L"GamutCompression").c_str(), false, iniPath);
 
     cc.grayscale.enabled = GetPrivateProfileBool(section, (p + L"GrayscaleEnabled").c_str(), false, iniPath);
     int points = GetPrivateProfileIntW(section, (p + L"GrayscalePoints").c_str(), 20, iniPath);
@@ -221,73 +259,40 @@ void LoadColorCorrectionSettings(const wchar_t* section, const wchar_t* prefix,
     }
 }
 
-// Helper to parse comma-separated whitelist into vector of lowercase exe names
-static void ParseWhitelistString(const std::wstring& raw, std::vector<std::wstring>& out) {
-    out.clear();
-    if (raw.empty()) return;
-
-    std::wstring item;
-    for (wchar_t c : raw) {
-        if (c == L',' || c == L';') {
-            // Trim whitespace
-            size_t start = item.find_first_not_of(L" \t");
-            size_t end = item.find_last_not_of(L" \t");
-            if (start != std::wstring::npos) {
-                std::wstring trimmed = item.substr(start, end - start + 1);
-                // Convert to lowercase
-                for (wchar_t& ch : trimmed) {
-                    ch = towlower(ch);
-                }
-                // Remove .exe extension if present (we'll match with and without)
-                if (trimmed.size() > 4 && trimmed.substr(trimmed.size() - 4) == L".exe") {
-                    trimmed = trimmed.substr(0, trimmed.size() - 4);
-                }
-                if (!trimmed.empty()) {
-                    out.push_back(trimmed);
-                }
-            }
-            item.clear();
-        } else {
-            item += c;
-        }
-    }
-    // Handle last item
-    size_t start = item.find_first_not_of(L" \t");
-    size_t end = item.find_last_not_of(L" \t");
-    if (start != std::wstring::npos) {
-        std::wstring trimmed = item.substr(start, end - start + 1);
-        for (wchar_t& ch : trimmed) {
-            ch = towlower(ch);
-        }
-        if (trimmed.size() > 4 && trimmed.substr(trimmed.size() - 4) == L".exe") {
-            trimmed = trimmed.substr(0, trimmed.size() - 4);
-        }
-        if (!trimmed.empty()) {
-            out.push_back(trimmed);
-        }
-    }
-}
-
-// Parse comma-separated whitelist string into vector of lowercase exe names
+// Parse comma-separated whitelist string into normalized entries (see whitelist.h for syntax)
 void ParseGammaWhitelist() {
     std::lock_guard<std::mutex> lock(g_gammaWhitelistMutex);
-    ParseWhitelistString(g_gammaWhitelistRaw, g_gammaWhitelist);
+    ParseWhitelistEntries(g_gammaWhitelistRaw, g_gammaWhitelist);
+    g_gammaWhitelistVersion.fetch_add(1);
 }
 
 void ParseVrrWhitelist() {
     std::lock_guard<std::mutex> lock(g_vrrWhitelistMutex);
-    ParseWhitelistString(g_vrrWhitelistRaw, g_vrrWhitelist);
+    ParseWhitelistEntries(g_vrrWhitelistRaw, g_vrrWhitelist);
+    g_vrrWhitelistVersion.fetch_add(1);
 }
 
 void SaveSettings() {
-    std::wstring iniPath = GetIniPath();
+    SaveSettingsTo(GetIniPath());
+}
 
+void SaveSettingsTo(const std::wstring& iniPath) {
     // Save general settings (save user preference, not effective state)
     WritePrivateProfileBool(L"General", L"DesktopGamma", g_userDesktopGammaMode.load(), iniPath.c_str());
     WritePrivateProfileBool(L"General", L"TetrahedralInterp", g_tetrahedralInterp.load(), iniPath.c_str());
     WritePrivateProfileBool(L"General", L"LogPeakDetection", g_logPeakDetection.load(), iniPath.c_str());
     WritePrivateProfileBool(L"General", L"ConsoleLog", g_consoleEnabled.load(), iniPath.c_str());
     WritePrivateProfileBool(L"General", L"ShowFrameTiming", g_showFrameTiming.load(), iniPath.c_str());
+    WritePrivateProfileBool(L"General", L"AdaptiveIdle", g_adaptiveIdle.load(), iniPath.c_str());
+    wchar_t portBuf[16];
+    swprintf_s(portBuf, L"%d", g_metricsPort.load());
+    WritePrivateProfileStringW(L"General", L"MetricsPort", portBuf, iniPath.c_str());
+    WritePrivateProfileBool(L"General", L"LiveLutPipe", g_liveLutEnabled.load(), iniPath.c_str());
+    WritePrivateProfileBool(L"General", L"AnalysisRecording", g_analysisRecording.load(), iniPath.c_str());
+    WritePrivateProfileBool(L"General", L"AnalysisScopes", g_analysisScopes.load(), iniPath.c_str());
+    WritePrivateProfileFloat(L"General", L"AnalysisBudgetMs", g_analysisBudgetMs.load(), iniPath.c_str());
+    WritePrivateProfileBool(L"General", L"TiledMainPass", g_tiledMainPass.load(), iniPath.c_str());
+    WritePrivateProfileBool(L"General", L"HalfPrecision", g_halfPrecision.load(), iniPath.c_str());
     WritePrivateProfileStringW(L"General", L"GammaWhitelist", g_gammaWhitelistRaw.c_str(), iniPath.c_str());
     WritePrivateProfileBool(L"General", L"VRRWhitelistEnabled", g_vrrWhitelistEnabled.load(), iniPath.c_str());
     WritePrivateProfileStringW(L"General", L"VRRWhitelist", g_vrrWhitelistRaw.c_str(), iniPath.c_str());
@@ -306,10 +311,13 @@ void SaveSettings() {
     // Save startup settings
     WritePrivateProfileBool(L"General", L"StartMinimized", g_startMinimized.load(), iniPath.c_str());
 
-    // Save per-monitor settings
+    // Save per-monitor settings, keyed by display identity
+    if (g_gui.monitorSections.size() != g_gui.monitorSettings.size()) {
+        g_gui.monitorSections = MonitorSectionsFor(g_gui.monitorSettings.size(), iniPath.c_str());
+    }
     for (size_t i = 0; i < g_gui.monitorSettings.size(); i++) {
-        wchar_t section[32];
-        swprintf_s(section, L"Monitor%d", (int)i);
+        MonitorSectionPlan& plan = g_gui.monitorSections[i];
+        const wchar_t* section = plan.saveTo.c_str();
 
         WritePrivateProfileStringW(section, L"LUT_SDR", g_gui.monitorSettings[i].sdrPath.c_str(), iniPath.c_str());
         WritePrivateProfileStringW(section, L"LUT_HDR", g_gui.monitorSettings[i].hdrPath.c_str(), iniPath.c_str());
@@ -321,12 +329,22 @@ void SaveSettings() {
         // Save MaxTML settings
         WritePrivateProfileBool(section, L"MaxTmlEnabled", g_gui.monitorSettings[i].maxTml.enabled, iniPath.c_str());
         WritePrivateProfileFloat(section, L"MaxTmlPeak", g_gui.monitorSettings[i].maxTml.peakNits, iniPath.c_str());
+
+        // Settings now live under the display's identity; drop the index section they came from
+        if (plan.migrateLegacy) {
+            WritePrivateProfileStringW(plan.loadFrom.c_str(), nullptr, nullptr, iniPath.c_str());
+            std::wcout << L"Migrated [" << plan.loadFrom << L"] to [" << plan.saveTo << L"]" << std::endl;
+            plan.loadFrom = plan.saveTo;
+            plan.migrateLegacy = false;
+        }
     }
 }
 
 void LoadSettings() {
-    std::wstring iniPath = GetIniPath();
+    LoadSettingsFrom(GetIniPath());
+}
 
+void LoadSettingsFrom(const std::wstring& iniPath) {
     // Load general settings
     bool desktopGamma = GetPrivateProfileBool(L"General", L"DesktopGamma", true, iniPath.c_str());
     g_userDesktopGammaMode.store(desktopGamma);
@@ -335,6 +353,15 @@ void LoadSettings() {
     g_logPeakDetection.store(GetPrivateProfileBool(L"General", L"LogPeakDetection", false, iniPath.c_str()));
     g_consoleEnabled.store(GetPrivateProfileBool(L"General", L"ConsoleLog", false, iniPath.c_str()));
     g_showFrameTiming.store(GetPrivateProfileBool(L"General", L"ShowFrameTiming", false, iniPath.c_str()));
+    g_adaptiveIdle.store(GetPrivateProfileBool(L"General", L"AdaptiveIdle", true, iniPath.c_str()));
+    int metricsPort = GetPrivateProfileIntW(L"General", L"MetricsPort", 0, iniPath.c_str());
+    g_metricsPort.store((metricsPort > 0 && metricsPort <= 65535) ? metricsPort : 0);
+    g_liveLutEnabled.store(GetPrivateProfileBool(L"General", L"LiveLutPipe", false, iniPath.c_str()));
+    g_analysisRecording.store(GetPrivateProfileBool(L"General", L"AnalysisRecording", false, iniPath.c_str()));
+    g_analysisScopes.store(GetPrivateProfileBool(L"General", L"AnalysisScopes", false, iniPath.c_str()));
+    g_analysisBudgetMs.store(GetPrivateProfileFloat(L"General", L"AnalysisBudgetMs", ANALYSIS_DEFAULT_BUDGET_MS, iniPath.c_str()));
+    g_tiledMainPass.store(GetPrivateProfileBool(L"General", L"TiledMainPass", false, iniPath.c_str()));
+    g_halfPrecision.store(GetPrivateProfileBool(L"General", L"HalfPrecision", false, iniPath.c_str()));
 
     // Load gamma whitelist
     wchar_t whitelistBuf[1024] = {};
@@ -364,15 +391,16 @@ void LoadSettings() {
     g_startMinimized.store(GetPrivateProfileBool(L"General", L"StartMinimized", false, iniPath.c_str()));
 
     // Load per-monitor settings
+    g_gui.monitorSections = MonitorSectionsFor(g_gui.monitorSettings.size(), iniPath.c_str());
     for (size_t i = 0; i < g_gui.monitorSettings.size(); i++) {
-        wchar_t section[32];
-        swprintf_s(section, L"Monitor%d", (int)i);
+        const wchar_t* section = g_gui.monitorSections[i].loadFrom.c_str();
 
-        wchar_t sdrPath[MAX_PATH] = {};
-        wchar_t hdrPath[MAX_PATH] = {};
+        // Room for a full LUT stack ("a.cube|b.cube", see lutstack.h)
+        wchar_t sdrPath[MAX_PATH * LUT_STACK_MAX] = {};
+        wchar_t hdrPath[MAX_PATH * LUT_STACK_MAX] = {};
 
-        GetPrivateProfileStringW(section, L"LUT_SDR", L"", sdrPath, MAX_PATH, iniPath.c_str());
-        GetPrivateProfileStringW(section, L"LUT_HDR", L"", hdrPath, MAX_PATH, iniPath.c_str());
+        GetPrivateProfileStringW(section, L"LUT_SDR", L"", sdrPath, MAX_PATH * LUT_STACK_MAX, iniPath.c_str());
+        GetPrivateProfileStringW(section, L"LUT_HDR", L"", hdrPath, MAX_PATH * LUT_STACK_MAX, iniPath.c_str());
 
         g_gui.monitorSettings[i].sdrPath = sdrPath;
         g_gui.monitorSettings[i].hdrPath = hdrPath;
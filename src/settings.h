@@ -9,6 +9,9 @@
 // Get path to INI file (next to exe)
 std::wstring GetIniPath();
 
+// Display identity database (next to the INI)
+std::wstring GetDisplayDbPath();
+
 // Helper to write float to INI
 void WritePrivateProfileFloat(const wchar_t* section, const wchar_t* key, float value, const wchar_t* file);
 
@@ -32,6 +35,10 @@ void SaveSettings();
 // Load all settings from INI file
 void LoadSettings();
 
+// Same, for an explicit INI path (benchmark fixtures)
+void SaveSettingsTo(const std::wstring& iniPath);
+void LoadSettingsFrom(const std::wstring& iniPath);
+
 // Parse g_gammaWhitelistRaw into g_gammaWhitelist vector
 void ParseGammaWhitelist();
 
@@ -20,6 +20,9 @@ VS_OUTPUT main(uint id : SV_VertexID) {
 
 // Pixel shader: LUT application with HDR/SDR support
 // Split into multiple parts to avoid MSVC string literal length limit
+// Also compiled as cs_5_0 with MAIN_PASS_CS defined: the tiled compute main pass (Part 7)
+// runs the same CorrectPixel() per texel, so both passes produce identical output.
+// Texture reads use SampleLevel/Load only (no derivatives in compute).
 inline const char* g_psSource =
 // Part 1: Constant buffer and textures
 R"(
@@ -44,9 +47,9 @@ cbuffer LUTParams : register(b0) {
     float tonemapDynamic;
     float grayscale24;     // SDR: apply 2.2->2.4 gamma transform (0 or 1)
     float grayscalePeakNits;   // HDR grayscale peak - must match ColourSpace target peak
-    float _padding;            // Padding for alignment (was whiteBalanceGains, now in primaries matrix via Bradford)
-    float _padding2;
-    float _padding3;
+    float gamutCompression;    // Soft-compress chroma toward display gamut boundary (0 or 1)
+    float gamutMaxIntensity;   // ICtCp I at the top row of gamutTexture
+    float gamutKnee;           // Fraction of boundary chroma where compression starts
     float4 grayscale[8];
 };
 
@@ -54,10 +57,22 @@ Texture2D<float4> captureTexture : register(t0);
 Texture3D<float4> lutTexture : register(t1);
 Texture2D<float> blueNoiseTexture : register(t2);
 Texture2D<float> peakTexture : register(t3);  // Dynamic peak detection result
+Texture2D<float> gamutTexture : register(t4); // Gamut boundary: max CtCp chroma (u = hue, v = I)
 SamplerState pointSampler : register(s0);
 SamplerState linearSampler : register(s1);
 SamplerState wrapSampler : register(s2);
 
+// HALF_PRECISION: stages validated by tools/fp16_error_report.py (< 1 10-bit code of error
+// against FP32) run in min16float. Only the LUT interpolation qualifies; decode/encode,
+// grayscale, 2.4 gamma and dither stay FP32. Full precision on hardware without 16-bit ALUs.
+#ifdef HALF_PRECISION
+typedef min16float lut_half;
+typedef min16float3 lut_half3;
+#else
+typedef float lut_half;
+typedef float3 lut_half3;
+#endif
+
 float3 ApplyPrimariesMatrix(float3 rgb) {
     if (useManualCorrection < 0.5) return rgb;
     float3x3 mat = float3x3(primariesRow0.xyz, primariesRow1.xyz, primariesRow2.xyz);
@@ -167,6 +182,40 @@ float PQ_to_Linear_scalar(float pq) {
     return pow(t, 1.0f / PQ_m1);
 }
 
+// Gamut compression (see gamut.cpp for the CPU reference and descriptor builder)
+// Must match GAMUT_LIGHTNESS_STEPS / GAMUT_SDR_WHITE_NITS in gamut.h
+static const float GAMUT_LIGHTNESS_STEPS = 32.0f;
+static const float GAMUT_SDR_SCALE = 100.0f / 10000.0f;
+
+// Linear Rec.2020 (normalized to 10000 nits) <-> ICtCp
+float3 Rec2020ToICtCp(float3 rec2020) {
+    return mul(LMSprime_to_ICtCp, Linear_to_PQ(mul(Rec2020_to_LMS, rec2020)));
+}
+
+float3 ICtCpToRec2020(float3 ictcp) {
+    return mul(LMS_to_Rec2020, PQ_to_Linear(mul(ICtCp_to_LMSprime, ictcp)));
+}
+
+// Soft-knee chroma compression toward the precomputed display gamut boundary
+// One texture fetch; hue and intensity are preserved
+float3 ApplyGamutCompressionICtCp(float3 ictcp) {
+    float c = length(ictcp.yz);
+    if (c < 1e-6f) return ictcp;
+
+    // u wraps with hue (wrapSampler), v clamped to row centers so I never wraps
+    float hue = atan2(ictcp.z, ictcp.y);
+    float halfRow = 0.5f / GAMUT_LIGHTNESS_STEPS;
+    float2 uv = float2(hue * (0.5f / 3.14159265f), clamp(ictcp.x / gamutMaxIntensity, halfRow, 1.0f - halfRow));
+    float cMax = gamutTexture.SampleLevel(wrapSampler, uv, 0);
+
+    float knee = gamutKnee * cMax;
+    if (c <= knee) return ictcp;
+    float range = max(cMax - knee, 1e-6f);
+    float x = (c - knee) / range;
+    float cNew = knee + range * x / (1.0f + x);
+    return float3(ictcp.x, ictcp.yz * (cNew / c));
+}
+
 )"
 // Part 3: HDR Tonemapping functions
 R"(
@@ -439,9 +488,9 @@ float3 ApplyDitherICtCp(float3 ictcp, float2 pos) {
     float2 noiseUV = pos / 64.0f;
 
     // Sample blue noise texture at different offsets for decorrelated I/CT/CP noise
-    float noiseI  = blueNoiseTexture.Sample(wrapSampler, noiseUV);
-    float noiseCT = blueNoiseTexture.Sample(wrapSampler, noiseUV + float2(0.5f, 0.0f));
-    float noiseCP = blueNoiseTexture.Sample(wrapSampler, noiseUV + float2(0.0f, 0.5f));
+    float noiseI  = blueNoiseTexture.SampleLevel(wrapSampler, noiseUV, 0);
+    float noiseCT = blueNoiseTexture.SampleLevel(wrapSampler, noiseUV + float2(0.5f, 0.0f), 0);
+    float noiseCP = blueNoiseTexture.SampleLevel(wrapSampler, noiseUV + float2(0.0f, 0.5f), 0);
 
     // Dither amplitude: ~1 LSB in 10-bit PQ = 1/1023 ≈ 0.001
     // I channel: full amplitude (luminance banding most visible)
@@ -456,49 +505,50 @@ float3 ApplyDitherICtCp(float3 ictcp, float2 pos) {
 // Part 4: LUT sampling functions
 R"(
 float3 SampleLUTTetrahedral(float3 rgb) {
-    float3 scaled = saturate(rgb) * (lutSize - 1.0f);
-    float3 base = floor(scaled);
-    float3 frac = scaled - base;
+    // Weights and blends in lut_half; texel coordinates stay float
+    lut_half3 scaled = (lut_half3)saturate(rgb) * (lut_half)(lutSize - 1.0f);
+    lut_half3 base = floor(scaled);
+    lut_half3 frac = scaled - base;
     float3 texelSize = 1.0f / lutSize;
-    float3 baseUV = (base + 0.5f) * texelSize;
-    float3 c000 = lutTexture.SampleLevel(pointSampler, baseUV, 0).rgb;
-    float3 c111 = lutTexture.SampleLevel(pointSampler, baseUV + texelSize, 0).rgb;
-    float3 result;
+    float3 baseUV = ((float3)base + 0.5f) * texelSize;
+    lut_half3 c000 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV, 0).rgb;
+    lut_half3 c111 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + texelSize, 0).rgb;
+    lut_half3 result;
     if (frac.r >= frac.g) {
         if (frac.g >= frac.b) {
-            float3 c100 = lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, 0, 0), 0).rgb;
-            float3 c110 = lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, texelSize.y, 0), 0).rgb;
+            lut_half3 c100 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, 0, 0), 0).rgb;
+            lut_half3 c110 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, texelSize.y, 0), 0).rgb;
             result = c000 + (c100 - c000) * frac.r + (c110 - c100) * frac.g + (c111 - c110) * frac.b;
         } else if (frac.r >= frac.b) {
-            float3 c100 = lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, 0, 0), 0).rgb;
-            float3 c101 = lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, 0, texelSize.z), 0).rgb;
+            lut_half3 c100 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, 0, 0), 0).rgb;
+            lut_half3 c101 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, 0, texelSize.z), 0).rgb;
             result = c000 + (c100 - c000) * frac.r + (c101 - c100) * frac.b + (c111 - c101) * frac.g;
         } else {
-            float3 c001 = lutTexture.SampleLevel(pointSampler, baseUV + float3(0, 0, texelSize.z), 0).rgb;
-            float3 c101 = lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, 0, texelSize.z), 0).rgb;
+            lut_half3 c001 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(0, 0, texelSize.z), 0).rgb;
+            lut_half3 c101 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, 0, texelSize.z), 0).rgb;
             result = c000 + (c001 - c000) * frac.b + (c101 - c001) * frac.r + (c111 - c101) * frac.g;
         }
     } else {
         if (frac.b >= frac.g) {
-            float3 c001 = lutTexture.SampleLevel(pointSampler, baseUV + float3(0, 0, texelSize.z), 0).rgb;
-            float3 c011 = lutTexture.SampleLevel(pointSampler, baseUV + float3(0, texelSize.y, texelSize.z), 0).rgb;
+            lut_half3 c001 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(0, 0, texelSize.z), 0).rgb;
+            lut_half3 c011 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(0, texelSize.y, texelSize.z), 0).rgb;
             result = c000 + (c001 - c000) * frac.b + (c011 - c001) * frac.g + (c111 - c011) * frac.r;
         } else if (frac.r >= frac.b) {
-            float3 c010 = lutTexture.SampleLevel(pointSampler, baseUV + float3(0, texelSize.y, 0), 0).rgb;
-            float3 c110 = lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, texelSize.y, 0), 0).rgb;
+            lut_half3 c010 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(0, texelSize.y, 0), 0).rgb;
+            lut_half3 c110 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(texelSize.x, texelSize.y, 0), 0).rgb;
             result = c000 + (c010 - c000) * frac.g + (c110 - c010) * frac.r + (c111 - c110) * frac.b;
         } else {
-            float3 c010 = lutTexture.SampleLevel(pointSampler, baseUV + float3(0, texelSize.y, 0), 0).rgb;
-            float3 c011 = lutTexture.SampleLevel(pointSampler, baseUV + float3(0, texelSize.y, texelSize.z), 0).rgb;
+            lut_half3 c010 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(0, texelSize.y, 0), 0).rgb;
+            lut_half3 c011 = (lut_half3)lutTexture.SampleLevel(pointSampler, baseUV + float3(0, texelSize.y, texelSize.z), 0).rgb;
             result = c000 + (c010 - c000) * frac.g + (c011 - c010) * frac.b + (c111 - c011) * frac.r;
         }
     }
-    return result;
+    return (float3)result;
 }
 
 float3 SampleLUTTrilinear(float3 rgb) {
-    float3 lutUV = (saturate(rgb) * (lutSize - 1.0f) + 0.5f) / lutSize;
-    return lutTexture.Sample(linearSampler, lutUV).rgb;
+    lut_half3 lutUV = ((lut_half3)saturate(rgb) * (lut_half)(lutSize - 1.0f) + (lut_half)0.5) / (lut_half)lutSize;
+    return lutTexture.SampleLevel(linearSampler, (float3)lutUV, 0).rgb;
 }
 
 float3 SampleLUT(float3 rgb) {
@@ -506,11 +556,11 @@ float3 SampleLUT(float3 rgb) {
     else return SampleLUTTrilinear(rgb);
 }
 )"
-// Part 5: Main function - HDR path (ICTCP pipeline)
+// Part 5: Per-pixel correction - HDR path (ICTCP pipeline)
 // Pipeline: scRGB -> Rec.2020 -> LMS -> PQ -> ICtCp -> [process] -> PQ RGB -> LUT -> scRGB
+// color = captured texel, pos = pixel center (SV_POSITION.xy in the pixel shader)
 R"(
-float4 main(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_TARGET {
-    float4 color = captureTexture.Sample(pointSampler, uv);
+float4 CorrectPixel(float4 color, float2 pos) {
     if (isHDR > 0.5) {
         float3 input = color.rgb;
 
@@ -547,6 +597,13 @@ float4 main(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_TARGET {
         // STAGE 3: Display calibration (Linear Rec.2020)
         // ═══════════════════════════════════════════════════════════════════════
 
+        // Gamut compression (before the matrix, in source ICtCp): pulls colors the display
+        // can't reach toward its boundary instead of hard-clipping negative LMS in PQ encode
+        if (gamutCompression > 0.5) {
+            float3 ictcpSrc = Rec2020ToICtCp(rec2020 * (80.0f / 10000.0f));
+            rec2020 = ICtCpToRec2020(ApplyGamutCompressionICtCp(ictcpSrc)) * (10000.0f / 80.0f);
+        }
+
         // Primaries correction: adjusts for display's actual vs ideal primaries
         // Includes Bradford chromatic adaptation for white point correction
         rec2020 = ApplyPrimariesMatrix(rec2020);
@@ -581,7 +638,7 @@ float4 main(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_TARGET {
         ictcp = ApplyTonemappingICtCp(ictcp);
 
         // Dithering in ICtCp space (perceptually uniform noise distribution)
-        ictcp = ApplyDitherICtCp(ictcp, pos.xy);
+        ictcp = ApplyDitherICtCp(ictcp, pos);
 
         // ═══════════════════════════════════════════════════════════════════════
         // STAGE 6: Convert to PQ Rec.2020 RGB for LUT
@@ -626,7 +683,7 @@ float4 main(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_TARGET {
         return float4(result, 1.0);
     }
 )"
-// Part 6: Main function - SDR path
+// Part 6: Per-pixel correction - SDR path
 R"(
     else {
         float3 input = color.rgb;
@@ -635,6 +692,19 @@ R"(
         if (useManualCorrection > 0.5) {
             // Decode with gamma 2.2 (matching display's actual EOTF)
             float3 lin = pow(max(input, 0.0), 2.2);
+            // Gamut compression in ICtCp (linear sRGB scaled to 100 nits reference white)
+            if (gamutCompression > 0.5) {
+                float3 rec2020 = float3(
+                    dot(lin, float3(0.6274039f, 0.3292830f, 0.0433131f)),
+                    dot(lin, float3(0.0690973f, 0.9195404f, 0.0113623f)),
+                    dot(lin, float3(0.0163914f, 0.0880133f, 0.8955953f)));
+                float3 ictcpSrc = Rec2020ToICtCp(rec2020 * GAMUT_SDR_SCALE);
+                rec2020 = ICtCpToRec2020(ApplyGamutCompressionICtCp(ictcpSrc)) / GAMUT_SDR_SCALE;
+                lin = float3(
+                    dot(rec2020, float3(1.6604910f, -0.5876411f, -0.0728499f)),
+                    dot(rec2020, float3(-0.1245505f, 1.1328999f, -0.0083494f)),
+                    dot(rec2020, float3(-0.0181508f, -0.1005789f, 1.1187297f)));
+            }
             // Apply primaries matrix in linear space
             // Includes Bradford chromatic adaptation for white point correction
             float3x3 mat = float3x3(primariesRow0.xyz, primariesRow1.xyz, primariesRow2.xyz);
@@ -652,13 +722,121 @@ R"(
         if (usePassthrough > 0.5) corrected = input;
         else corrected = SampleLUT(input);
         // Dithering
-        float2 noiseUV = pos.xy / 64.0;
-        float noise = blueNoiseTexture.Sample(wrapSampler, noiseUV);
+        float2 noiseUV = pos / 64.0;
+        float noise = blueNoiseTexture.SampleLevel(wrapSampler, noiseUV, 0);
         float dither = (noise - 0.5) / 1024.0;
         float3 dithered = corrected.rgb + dither;
         return float4(dithered, 1.0);
     }
 }
+)"
+// Part 7: Entry points - fullscreen pixel shader, or the tiled compute main pass
+// The compute pass reads each capture texel once, writes the corrected value to the back
+// buffer UAV and reduces frame statistics per tile in groupshared memory.
+// Tile record layout matches the analysis buffer (see tiledpass.h); g_tileReduceCSSource
+// folds the records into the smoothed peak and the analysis result.
+R"(
+#ifndef MAIN_PASS_CS
+float4 main(float4 pos : SV_POSITION, float2 uv : TEXCOORD0) : SV_TARGET {
+    return CorrectPixel(captureTexture.Sample(pointSampler, uv), pos.xy);
+}
+#else
+cbuffer TileParams : register(b1) {
+    uint frameWidth;
+    uint frameHeight;
+    uint tilesX;
+    uint collectAnalysis;  // Full statistics this frame (else peak only)
+};
+
+RWTexture2D<float4> outputTexture : register(u0);
+RWStructuredBuffer<uint> tileStats : register(u1);
+
+#define TILE_THREADS (MAIN_PASS_TILE * MAIN_PASS_TILE)
+
+groupshared float tilePeak[TILE_THREADS];
+groupshared float tileMin[TILE_THREADS];
+groupshared float tileMinNonZero[TILE_THREADS];
+groupshared float tileSum[TILE_THREADS];
+groupshared uint tileCounts[11];   // Record slots 4-14
+
+// Record slot for a pixel's gamut class (same classification as g_analysisCSSource)
+uint GamutSlot(float3 rgb, float Y, bool hdr) {
+    if (!hdr || Y < 0.00125f || all(rgb >= -0.005f)) return 4;
+    float3 p3 = mul(float3x3(0.8225, 0.1774, 0.0000,
+                             0.0332, 0.9669, 0.0000,
+                             0.0171, 0.0724, 0.9108), rgb);
+    if (all(p3 >= -0.005f)) return 5;
+    float3 r2020 = mul(float3x3(0.6274, 0.3293, 0.0433,
+                                0.0691, 0.9195, 0.0114,
+                                0.0164, 0.0880, 0.8956), rgb);
+    return all(r2020 >= -0.005f) ? 6 : 7;
+}
+
+[numthreads(MAIN_PASS_TILE, MAIN_PASS_TILE, 1)]
+void main(uint3 gid : SV_GroupID, uint3 gtid : SV_GroupThreadID, uint gi : SV_GroupIndex) {
+    uint2 px = gid.xy * MAIN_PASS_TILE + gtid.xy;
+    bool inside = px.x < frameWidth && px.y < frameHeight;
+    bool analysis = collectAnalysis != 0;
+    bool hdr = isHDR > 0.5;
+
+    if (analysis && gi < 11) tileCounts[gi] = 0;
+
+    float4 color = float4(0, 0, 0, 0);
+    if (inside) {
+        color = captureTexture.Load(int3(px, 0));
+        outputTexture[px] = CorrectPixel(color, float2(px) + 0.5f);
+    }
+
+    // Statistics of the captured texel (same inputs as the sampled analysis/peak passes)
+    float nits = dot(color.rgb, float3(0.2126f, 0.7152f, 0.0722f)) * 80.0f;
+    tilePeak[gi] = inside ? max(nits, 0.0f) : 0.0f;
+    if (analysis) {
+        tileMin[gi] = inside ? nits : 100000.0f;
+        tileMinNonZero[gi] = (inside && nits > 0.1f) ? nits : 100000.0f;
+        tileSum[gi] = inside ? nits : 0.0f;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    if (analysis && inside) {
+        InterlockedAdd(tileCounts[GamutSlot(color.rgb, nits / 80.0f, hdr) - 4], 1);
+        if (!hdr) {
+            if (all(color.rgb < 1.0f / 255.0f)) InterlockedAdd(tileCounts[4], 1);
+            if (all(color.rgb > 254.0f / 255.0f)) InterlockedAdd(tileCounts[5], 1);
+        } else {
+            uint bucket = nits < 203.0f ? 0 : nits < 1000.0f ? 1 : nits < 2000.0f ? 2 : nits < 4000.0f ? 3 : 4;
+            InterlockedAdd(tileCounts[6 + bucket], 1);
+        }
+    }
+
+    // Tree reduction (TILE_THREADS is a power of two)
+    for (uint stride = TILE_THREADS / 2; stride > 0; stride >>= 1) {
+        if (gi < stride) {
+            tilePeak[gi] = max(tilePeak[gi], tilePeak[gi + stride]);
+            if (analysis) {
+                tileMin[gi] = min(tileMin[gi], tileMin[gi + stride]);
+                tileMinNonZero[gi] = min(tileMinNonZero[gi], tileMinNonZero[gi + stride]);
+                tileSum[gi] += tileSum[gi + stride];
+            }
+        }
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    uint base = (gid.y * tilesX + gid.x) * 16;
+    if (gi == 0) {
+        tileStats[base + 0] = asuint(tilePeak[0]);
+        if (analysis) {
+            uint2 tileEnd = min(gid.xy * MAIN_PASS_TILE + MAIN_PASS_TILE, uint2(frameWidth, frameHeight));
+            uint2 tileSize = tileEnd - gid.xy * MAIN_PASS_TILE;
+            tileStats[base + 1] = asuint(tileMin[0]);
+            tileStats[base + 2] = asuint(tileSum[0]);
+            tileStats[base + 3] = tileSize.x * tileSize.y;
+            tileStats[base + 15] = asuint(tileMinNonZero[0]);
+        }
+    } else if (analysis && gi < 12) {
+        tileStats[base + 3 + gi] = tileCounts[gi - 1];
+    }
+}
+#endif
 )";
 
 // Compute shader for dynamic peak detection
@@ -977,3 +1155,201 @@ void main(uint3 GTid : SV_GroupThreadID) {
     }
 }
 )";
+
+// Compute shader for analysis scopes (waveform, vectorscope, CIE xy)
+// One thread per grid sample, atomically binned - layout and math mirror scopes.cpp
+inline const char* g_scopesCSSource = R"(
+Texture2D<float4> inputTexture : register(t0);
+RWStructuredBuffer<uint> bins : register(u0);
+
+cbuffer ScopeParams : register(b0) {
+    uint frameWidth;
+    uint frameHeight;
+    uint isHDR;
+    uint gridX;
+    uint gridY;
+    uint3 pad;
+};
+
+// Layout (see scopes.h)
+static const uint WAVEFORM_WIDTH = 128;
+static const uint WAVEFORM_HEIGHT = 64;
+static const uint VECTOR_SIZE = 64;
+static const uint CIE_SIZE = 64;
+static const uint VECTOR_OFFSET = WAVEFORM_WIDTH * WAVEFORM_HEIGHT;
+static const uint CIE_OFFSET = VECTOR_OFFSET + VECTOR_SIZE * VECTOR_SIZE;
+static const float CIE_MAX_X = 0.8f;
+static const float CIE_MAX_Y = 0.9f;
+static const float CIE_LUMINANCE_FLOOR = 0.00125f;
+
+static const float3 LUMA = float3(0.2126f, 0.7152f, 0.0722f);
+static const float CB_SCALE = 1.8556f;
+static const float CR_SCALE = 1.5748f;
+
+float PQEncode(float nits) {
+    float y = saturate(nits / 10000.0f);
+    float p = pow(y, 0.1593017578125f);
+    return pow((0.8359375f + 18.8515625f * p) / (1.0f + 18.6875f * p), 78.84375f);
+}
+
+float SRGBToLinear(float c) {
+    return c <= 0.04045f ? c / 12.92f : pow((c + 0.055f) / 1.055f, 2.4f);
+}
+
+// floor(v * n) clamped to [0, n-1] (NaN lands in bin 0)
+uint BinIndex(float v, uint n) {
+    float f = floor(v * (float)n);
+    if (!(f >= 0.0f)) return 0;
+    return f >= (float)(n - 1) ? n - 1 : (uint)f;
+}
+
+[numthreads(16, 16, 1)]
+void main(uint3 DTid : SV_DispatchThreadID) {
+    if (DTid.x >= gridX || DTid.y >= gridY) return;
+
+    uint px = DTid.x * frameWidth / gridX;
+    uint py = DTid.y * frameHeight / gridY;
+    float3 rgb = inputTexture.Load(int3(px, py, 0)).rgb;
+
+    // SDR scopes show the encoded signal, HDR scopes show PQ (one scale for 0-10k nits)
+    float3 encoded;
+    float3 lin;
+    float level;
+    if (isHDR) {
+        lin = rgb;
+        float3 nits = max(rgb, 0.0f) * 80.0f;
+        encoded = float3(PQEncode(nits.r), PQEncode(nits.g), PQEncode(nits.b));
+        level = PQEncode(max(dot(lin, LUMA), 0.0f) * 80.0f);
+    } else {
+        encoded = rgb;
+        level = dot(rgb, LUMA);
+        lin = float3(SRGBToLinear(rgb.r), SRGBToLinear(rgb.g), SRGBToLinear(rgb.b));
+    }
+
+    // Waveform: column from frame x, row from luma (top = 1.0)
+    uint col = px * WAVEFORM_WIDTH / frameWidth;
+    uint row = WAVEFORM_HEIGHT - 1 - BinIndex(level, WAVEFORM_HEIGHT);
+    InterlockedAdd(bins[row * WAVEFORM_WIDTH + col], 1);
+
+    // Vectorscope: Cb/Cr of the encoded signal, +-0.5 full scale
+    float ey = dot(encoded, LUMA);
+    float cb = (encoded.b - ey) / CB_SCALE;
+    float cr = (encoded.r - ey) / CR_SCALE;
+    uint vx = BinIndex(cb + 0.5f, VECTOR_SIZE);
+    uint vy = VECTOR_SIZE - 1 - BinIndex(cr + 0.5f, VECTOR_SIZE);
+    InterlockedAdd(bins[VECTOR_OFFSET + vy * VECTOR_SIZE + vx], 1);
+
+    // CIE 1931 xy of the linear BT.709 value (scRGB negatives reach outside the 709 triangle)
+    float X = dot(lin, float3(0.4124f, 0.3576f, 0.1805f));
+    float Y = dot(lin, float3(0.2126f, 0.7152f, 0.0722f));
+    float Z = dot(lin, float3(0.0193f, 0.1192f, 0.9505f));
+    float sum = X + Y + Z;
+    if (Y > CIE_LUMINANCE_FLOOR && sum > 1e-6f) {
+        float x = X / sum;
+        float y = Y / sum;
+        if (x >= 0.0f && x < CIE_MAX_X && y >= 0.0f && y < CIE_MAX_Y) {
+            uint cx = BinIndex(x / CIE_MAX_X, CIE_SIZE);
+            uint cy = CIE_SIZE - 1 - BinIndex(y / CIE_MAX_Y, CIE_SIZE);
+            InterlockedAdd(bins[CIE_OFFSET + cy * CIE_SIZE + cx], 1);
+        }
+    }
+}
+)";
+
+// Compute shader folding the tiled main pass records into frame results
+// Peak: same temporal smoothing as g_csSource. Analysis: same 16-uint layout as g_analysisCSSource.
+// Dispatch with (1, 1, 1) groups, 256 threads - reduction order mirrors ReduceTileStats in tiledpass.cpp
+inline const char* g_tileReduceCSSource = R"(
+StructuredBuffer<uint> tileStats : register(t0);
+RWTexture2D<float> peakOutput : register(u0);
+RWStructuredBuffer<uint> analysisOutput : register(u1);
+
+cbuffer ReduceParams : register(b0) {
+    uint tileCount;
+    uint collectAnalysis;  // Records carry full statistics this frame
+    uint updatePeak;       // Dynamic tonemapping active: smooth into peakOutput
+    uint pad;
+    float riseRate;
+    float fallRate;
+    float maxRisePerFrame;
+    float maxFallPerFrame;
+};
+
+groupshared float sharedPeak[256];
+groupshared float sharedMin[256];
+groupshared float sharedMinNonZero[256];
+groupshared float sharedSum[256];
+groupshared uint sharedCounts[12];   // Record slots 3-14
+
+[numthreads(256, 1, 1)]
+void main(uint3 GTid : SV_GroupThreadID) {
+    uint t = GTid.x;
+    bool analysis = collectAnalysis != 0;
+    if (t < 12) sharedCounts[t] = 0;
+    GroupMemoryBarrierWithGroupSync();
+
+    float localPeak = 0.0f;
+    float localMin = 100000.0f;
+    float localMinNonZero = 100000.0f;
+    float localSum = 0.0f;
+    uint localCounts[12] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+
+    // Thread t folds tiles t, t + 256, t + 512, ...
+    for (uint tile = t; tile < tileCount; tile += 256) {
+        uint base = tile * 16;
+        localPeak = max(localPeak, asfloat(tileStats[base]));
+        if (analysis) {
+            localMin = min(localMin, asfloat(tileStats[base + 1]));
+            localSum += asfloat(tileStats[base + 2]);
+            localMinNonZero = min(localMinNonZero, asfloat(tileStats[base + 15]));
+            for (uint c = 0; c < 12; c++) localCounts[c] += tileStats[base + 3 + c];
+        }
+    }
+
+    sharedPeak[t] = localPeak;
+    sharedMin[t] = localMin;
+    sharedMinNonZero[t] = localMinNonZero;
+    sharedSum[t] = localSum;
+    if (analysis) {
+        for (uint c = 0; c < 12; c++) InterlockedAdd(sharedCounts[c], localCounts[c]);
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    for (uint stride = 128; stride > 0; stride >>= 1) {
+        if (t < stride) {
+            sharedPeak[t] = max(sharedPeak[t], sharedPeak[t + stride]);
+            sharedMin[t] = min(sharedMin[t], sharedMin[t + stride]);
+            sharedMinNonZero[t] = min(sharedMinNonZero[t], sharedMinNonZero[t + stride]);
+            sharedSum[t] += sharedSum[t + stride];
+        }
+        GroupMemoryBarrierWithGroupSync();
+    }
+
+    if (t != 0) return;
+
+    if (updatePeak != 0) {
+        float framePeak = sharedPeak[0];
+        float prevPeak = peakOutput[uint2(0, 0)];
+        if (prevPeak <= 0.0f) prevPeak = framePeak;
+        float target;
+        float maxDelta;
+        if (framePeak > prevPeak) {
+            target = lerp(prevPeak, framePeak, riseRate);
+            maxDelta = maxRisePerFrame;
+        } else {
+            target = lerp(prevPeak, framePeak, fallRate);
+            maxDelta = maxFallPerFrame;
+        }
+        float smoothedPeak = clamp(target, prevPeak - maxDelta, prevPeak + maxDelta);
+        peakOutput[uint2(0, 0)] = clamp(smoothedPeak, 0.0f, 10000.0f);
+    }
+
+    if (analysis) {
+        analysisOutput[0] = asuint(sharedPeak[0]);
+        analysisOutput[1] = asuint(sharedMin[0]);
+        analysisOutput[2] = asuint(sharedSum[0]);
+        for (uint c = 0; c < 12; c++) analysisOutput[3 + c] = sharedCounts[c];
+        analysisOutput[15] = asuint(sharedMinNonZero[0]);
+    }
+}
+)";
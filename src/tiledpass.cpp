@@ -0,0 +1,155 @@
+// DesktopLUT - tiledpass.cpp
+// Tiled compute main pass: tile scheduling, per-tile statistics records and their reduction
+// (CPU reference for the MAIN_PASS_CS variant of g_psSource and g_tileReduceCSSource)
+
+#include "tiledpass.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static uint32_t FloatBits(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float BitsFloat(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static bool AllAtLeast(const float* v, float limit) {
+    return v[0] >= limit && v[1] >= limit && v[2] >= limit;
+}
+
+// Gamut class slot, same matrices and tolerance as the shaders
+static int GamutSlot(const float* rgb, float Y, bool isHDR) {
+    if (!isHDR || Y < 0.00125f || AllAtLeast(rgb, -0.005f)) return TILE_STAT_REC709;
+    float p3[3] = {
+        0.8225f * rgb[0] + 0.1774f * rgb[1],
+        0.0332f * rgb[0] + 0.9669f * rgb[1],
+        0.0171f * rgb[0] + 0.0724f * rgb[1] + 0.9108f * rgb[2] };
+    if (AllAtLeast(p3, -0.005f)) return TILE_STAT_P3_ONLY;
+    float r2020[3] = {
+        0.6274f * rgb[0] + 0.3293f * rgb[1] + 0.0433f * rgb[2],
+        0.0691f * rgb[0] + 0.9195f * rgb[1] + 0.0114f * rgb[2],
+        0.0164f * rgb[0] + 0.0880f * rgb[1] + 0.8956f * rgb[2] };
+    return AllAtLeast(r2020, -0.005f) ? TILE_STAT_REC2020_ONLY : TILE_STAT_OUT_OF_GAMUT;
+}
+
+// Groupshared tree reduction over a power-of-two thread count
+template <typename Op>
+static float TreeReduce(std::vector<float>& v, Op op) {
+    for (size_t stride = v.size() / 2; stride > 0; stride >>= 1) {
+        for (size_t i = 0; i < stride; i++) {
+            v[i] = op(v[i], v[i + stride]);
+        }
+    }
+    return v[0];
+}
+
+static float Max(float a, float b) { return (std::max)(a, b); }
+static float Min(float a, float b) { return (std::min)(a, b); }
+static float Add(float a, float b) { return a + b; }
+
+TileGrid MainPassTileGrid(uint32_t frameWidth, uint32_t frameHeight, uint32_t tileSize) {
+    TileGrid grid = { 0, 0 };
+    if (tileSize == 0) return grid;
+    grid.x = (frameWidth + tileSize - 1) / tileSize;
+    grid.y = (frameHeight + tileSize - 1) / tileSize;
+    return grid;
+}
+
+void ComputeTileStats(const float* rgba, uint32_t frameWidth, uint32_t frameHeight, size_t rowStride,
+                      uint32_t tileSize, bool isHDR, bool collectAnalysis, uint32_t* records) {
+    TileGrid grid = MainPassTileGrid(frameWidth, frameHeight, tileSize);
+    size_t threads = (size_t)tileSize * tileSize;
+    std::vector<float> peak(threads), minNits(threads), minNonZero(threads), sum(threads);
+
+    for (uint32_t ty = 0; ty < grid.y; ty++) {
+        for (uint32_t tx = 0; tx < grid.x; tx++) {
+            uint32_t* rec = records + ((size_t)ty * grid.x + tx) * TILE_STAT_UINTS;
+            uint32_t counts[TILE_STAT_UINTS] = {};
+
+            // One "thread" per tile pixel; threads outside the frame hold neutral values
+            for (uint32_t gy = 0; gy < tileSize; gy++) {
+                for (uint32_t gx = 0; gx < tileSize; gx++) {
+                    size_t gi = (size_t)gy * tileSize + gx;
+                    uint32_t x = tx * tileSize + gx;
+                    uint32_t y = ty * tileSize + gy;
+                    bool inside = x < frameWidth && y < frameHeight;
+                    const float* p = inside ? rgba + y * rowStride + (size_t)x * 4 : nullptr;
+                    float nits = inside ? (0.2126f * p[0] + 0.7152f * p[1] + 0.0722f * p[2]) * 80.0f : 0.0f;
+
+                    peak[gi] = inside ? (std::max)(nits, 0.0f) : 0.0f;
+                    minNits[gi] = inside ? nits : 100000.0f;
+                    minNonZero[gi] = (inside && nits > 0.1f) ? nits : 100000.0f;
+                    sum[gi] = inside ? nits : 0.0f;
+                    if (!collectAnalysis || !inside) continue;
+
+                    counts[TILE_STAT_PIXELS]++;
+                    counts[GamutSlot(p, nits / 80.0f, isHDR)]++;
+                    if (!isHDR) {
+                        if (p[0] < 1.0f / 255.0f && p[1] < 1.0f / 255.0f && p[2] < 1.0f / 255.0f) counts[TILE_STAT_CLIP_BLACK]++;
+                        if (p[0] > 254.0f / 255.0f && p[1] > 254.0f / 255.0f && p[2] > 254.0f / 255.0f) counts[TILE_STAT_CLIP_WHITE]++;
+                    } else {
+                        int bucket = nits < 203.0f ? 0 : nits < 1000.0f ? 1 : nits < 2000.0f ? 2 : nits < 4000.0f ? 3 : 4;
+                        counts[TILE_STAT_HISTOGRAM + bucket]++;
+                    }
+                }
+            }
+
+            rec[TILE_STAT_PEAK] = FloatBits(TreeReduce(peak, Max));
+            if (collectAnalysis) {
+                for (int s = TILE_STAT_PIXELS; s < TILE_STAT_MIN_NON_ZERO; s++) rec[s] = counts[s];
+                rec[TILE_STAT_MIN] = FloatBits(TreeReduce(minNits, Min));
+                rec[TILE_STAT_SUM] = FloatBits(TreeReduce(sum, Add));
+                rec[TILE_STAT_MIN_NON_ZERO] = FloatBits(TreeReduce(minNonZero, Min));
+            }
+        }
+    }
+}
+
+float ReduceTileStats(const uint32_t* records, uint32_t tileCount, bool collectAnalysis, uint32_t* analysisOut) {
+    std::vector<float> peak(TILE_REDUCE_THREADS, 0.0f), minNits(TILE_REDUCE_THREADS, 100000.0f);
+    std::vector<float> minNonZero(TILE_REDUCE_THREADS, 100000.0f), sum(TILE_REDUCE_THREADS, 0.0f);
+    uint32_t counts[TILE_STAT_UINTS] = {};
+
+    // Thread t folds tiles t, t + 256, ...
+    for (uint32_t t = 0; t < TILE_REDUCE_THREADS; t++) {
+        for (uint32_t tile = t; tile < tileCount; tile += TILE_REDUCE_THREADS) {
+            const uint32_t* rec = records + (size_t)tile * TILE_STAT_UINTS;
+            peak[t] = (std::max)(peak[t], BitsFloat(rec[TILE_STAT_PEAK]));
+            if (!collectAnalysis) continue;
+            minNits[t] = (std::min)(minNits[t], BitsFloat(rec[TILE_STAT_MIN]));
+            sum[t] += BitsFloat(rec[TILE_STAT_SUM]);
+            minNonZero[t] = (std::min)(minNonZero[t], BitsFloat(rec[TILE_STAT_MIN_NON_ZERO]));
+            for (int s = TILE_STAT_PIXELS; s < TILE_STAT_MIN_NON_ZERO; s++) counts[s] += rec[s];
+        }
+    }
+
+    float framePeak = TreeReduce(peak, Max);
+    if (collectAnalysis && analysisOut) {
+        for (int s = TILE_STAT_PIXELS; s < TILE_STAT_MIN_NON_ZERO; s++) analysisOut[s] = counts[s];
+        analysisOut[TILE_STAT_PEAK] = FloatBits(framePeak);
+        analysisOut[TILE_STAT_MIN] = FloatBits(TreeReduce(minNits, Min));
+        analysisOut[TILE_STAT_SUM] = FloatBits(TreeReduce(sum, Add));
+        analysisOut[TILE_STAT_MIN_NON_ZERO] = FloatBits(TreeReduce(minNonZero, Min));
+    }
+    return framePeak;
+}
+
+float SmoothPeak(float prevPeak, float framePeak, const PeakSmoothing& params) {
+    if (prevPeak <= 0.0f) prevPeak = framePeak;  // First frame
+    float target, maxDelta;
+    if (framePeak > prevPeak) {
+        target = prevPeak + (framePeak - prevPeak) * params.riseRate;
+        maxDelta = params.maxRisePerFrame;
+    } else {
+        target = prevPeak + (framePeak - prevPeak) * params.fallRate;
+        maxDelta = params.maxFallPerFrame;
+    }
+    float smoothed = std::clamp(target, prevPeak - maxDelta, prevPeak + maxDelta);
+    return std::clamp(smoothed, 0.0f, 10000.0f);
+}
@@ -0,0 +1,83 @@
+// DesktopLUT - tiledpass.h
+// Tiled compute main pass: tile scheduling, per-tile statistics records and their reduction
+// (CPU reference for the MAIN_PASS_CS variant of g_psSource and g_tileReduceCSSource)
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Tile edge in pixels (MAIN_PASS_TILE when compiling the compute variant; 8 or 16)
+// 16x16 = 256 threads per group, one tile record per group
+constexpr uint32_t MAIN_PASS_TILE_SIZE = 16;
+
+// Threads in the single reduction group (g_tileReduceCSSource numthreads)
+constexpr uint32_t TILE_REDUCE_THREADS = 256;
+
+// Tile record: 16 uints, same slots as the analysis buffer (g_analysisCSSource) so the
+// reduced record can be read back by the analysis overlay unchanged.
+// Only TILE_STAT_PEAK is written on frames that don't collect analysis.
+constexpr int TILE_STAT_UINTS = 16;
+enum TileStatSlot {
+    TILE_STAT_PEAK = 0,            // float bits, max luminance nits (>= 0)
+    TILE_STAT_MIN = 1,             // float bits
+    TILE_STAT_SUM = 2,             // float bits, sum of luminance nits
+    TILE_STAT_PIXELS = 3,          // Pixels inside the frame
+    TILE_STAT_REC709 = 4,          // Gamut classes, clipping and HDR histogram as in AnalysisResult
+    TILE_STAT_P3_ONLY = 5,
+    TILE_STAT_REC2020_ONLY = 6,
+    TILE_STAT_OUT_OF_GAMUT = 7,
+    TILE_STAT_CLIP_BLACK = 8,
+    TILE_STAT_CLIP_WHITE = 9,
+    TILE_STAT_HISTOGRAM = 10,      // 10-14
+    TILE_STAT_MIN_NON_ZERO = 15,   // float bits, min excluding < 0.1 nit
+};
+
+struct TileGrid {
+    uint32_t x;
+    uint32_t y;
+    uint32_t Count() const { return x * y; }
+};
+
+// Dispatch size for a frame (partial tiles at the right/bottom edges)
+TileGrid MainPassTileGrid(uint32_t frameWidth, uint32_t frameHeight, uint32_t tileSize = MAIN_PASS_TILE_SIZE);
+
+// Visit every frame pixel exactly once in dispatch order: fn(tileX, tileY, x, y)
+template <typename Fn>
+void ForEachTilePixel(uint32_t frameWidth, uint32_t frameHeight, uint32_t tileSize, Fn&& fn) {
+    TileGrid grid = MainPassTileGrid(frameWidth, frameHeight, tileSize);
+    for (uint32_t ty = 0; ty < grid.y; ty++) {
+        for (uint32_t tx = 0; tx < grid.x; tx++) {
+            for (uint32_t gy = 0; gy < tileSize; gy++) {
+                uint32_t y = ty * tileSize + gy;
+                if (y >= frameHeight) break;
+                for (uint32_t gx = 0; gx < tileSize; gx++) {
+                    uint32_t x = tx * tileSize + gx;
+                    if (x >= frameWidth) break;
+                    fn(tx, ty, x, y);
+                }
+            }
+        }
+    }
+}
+
+// Per-tile records for an RGBA float frame (scRGB for HDR, encoded 0-1 for SDR), as the main
+// pass writes them: records holds grid.Count() * TILE_STAT_UINTS uints. rowStride is in floats.
+void ComputeTileStats(const float* rgba, uint32_t frameWidth, uint32_t frameHeight, size_t rowStride,
+                      uint32_t tileSize, bool isHDR, bool collectAnalysis, uint32_t* records);
+
+// Fold tile records as the reduction shader does: frame peak, and with collectAnalysis the
+// 16-uint analysis layout in analysisOut (may be null otherwise)
+float ReduceTileStats(const uint32_t* records, uint32_t tileCount, bool collectAnalysis, uint32_t* analysisOut);
+
+// Dynamic peak temporal smoothing (exponential + slew limit), shared by the peak detection
+// and tile reduction shaders
+struct PeakSmoothing {
+    float riseRate;         // Exponential rise per frame
+    float fallRate;         // Exponential fall per frame
+    float maxRisePerFrame;  // Slew limits (nits/frame)
+    float maxFallPerFrame;
+};
+constexpr PeakSmoothing DEFAULT_PEAK_SMOOTHING = { 0.3f, 0.05f, 100.0f, 50.0f };
+
+float SmoothPeak(float prevPeak, float framePeak, const PeakSmoothing& params);
@@ -0,0 +1,93 @@
+// DesktopLUT - topology.cpp
+// Display topology reconciliation: diff the displays Windows reports against the monitors being
+// processed and plan the per-monitor actions that bring them back in line (no Windows dependencies)
+
+#include "topology.h"
+#include <algorithm>
+
+std::vector<TopologyStep> PlanTopology(const std::vector<TopologyDisplay>& running,
+                                       const std::vector<TopologyDisplay>& current,
+                                       const std::vector<uint64_t>& configured, bool resumed) {
+    std::vector<int> match(running.size(), -1);
+    std::vector<bool> claimed(current.size(), false);
+    // Same id and handle first, so one of two identical displays going away doesn't rebind the other
+    for (int pass = 0; pass < 2; pass++) {
+        for (size_t r = 0; r < running.size(); r++) {
+            if (match[r] >= 0) continue;
+            for (size_t c = 0; c < current.size(); c++) {
+                if (!claimed[c] && current[c].id == running[r].id &&
+                    (pass == 1 || current[c].handle == running[r].handle)) {
+                    match[r] = (int)c;
+                    claimed[c] = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<TopologyStep> removes, updates, adds;
+    for (size_t r = 0; r < running.size(); r++) {
+        int c = match[r];
+        const TopologyDisplay& was = running[r];
+        if (c < 0 || current[c].adapter != was.adapter) {
+            // A display that moved to another adapter is re-attached there from scratch
+            if (c >= 0) claimed[c] = false;
+            removes.push_back({ was.id, (int)r, -1, TOPOLOGY_REMOVE });
+            continue;
+        }
+
+        const TopologyDisplay& now = current[c];
+        uint32_t actions = 0;
+        if (now.handle != was.handle) actions |= TOPOLOGY_REBIND | TOPOLOGY_REDUPLICATE;
+        if (now.x != was.x || now.y != was.y) actions |= TOPOLOGY_MOVE;
+        if (now.width != was.width || now.height != was.height) actions |= TOPOLOGY_RESIZE | TOPOLOGY_REDUPLICATE;
+        if (now.hdr != was.hdr) actions |= TOPOLOGY_HDR | TOPOLOGY_REDUPLICATE;
+        if (resumed) actions |= TOPOLOGY_REDUPLICATE;
+        if (actions) updates.push_back({ was.id, (int)r, c, actions });
+    }
+
+    for (size_t c = 0; c < current.size(); c++) {
+        if (claimed[c]) continue;
+        if (std::find(configured.begin(), configured.end(), current[c].id) == configured.end()) continue;
+        adds.push_back({ current[c].id, -1, (int)c, TOPOLOGY_ADD });
+    }
+
+    std::vector<TopologyStep> plan;
+    plan.reserve(removes.size() + updates.size() + adds.size());
+    plan.insert(plan.end(), removes.begin(), removes.end());
+    plan.insert(plan.end(), updates.begin(), updates.end());
+    plan.insert(plan.end(), adds.begin(), adds.end());
+    return plan;
+}
+
+std::string FormatTopologyActions(uint32_t actions) {
+    static const struct { uint32_t bit; const char* name; } names[] = {
+        { TOPOLOGY_REMOVE, "remove" }, { TOPOLOGY_REBIND, "rebind" }, { TOPOLOGY_MOVE, "move" },
+        { TOPOLOGY_RESIZE, "resize" }, { TOPOLOGY_HDR, "hdr" }, { TOPOLOGY_REDUPLICATE, "reduplicate" },
+        { TOPOLOGY_ADD, "add" },
+    };
+    std::string out;
+    for (const auto& entry : names) {
+        if (!(actions & entry.bit)) continue;
+        if (!out.empty()) out += '+';
+        out += entry.name;
+    }
+    return out.empty() ? "none" : out;
+}
+
+// ============================================================================
+// Settling
+// ============================================================================
+
+void NoteTopologyEvent(TopologySettle& settle, int64_t nowMs, bool resumed) {
+    settle.pending = true;
+    settle.resumed = settle.resumed || resumed;
+    settle.lastEventMs = nowMs;
+}
+
+bool TopologySettled(TopologySettle& settle, int64_t nowMs, int64_t settleMs, bool& outResumed) {
+    if (!settle.pending || nowMs - settle.lastEventMs < settleMs) return false;
+    outResumed = settle.resumed;
+    settle = TopologySettle();
+    return true;
+}
@@ -0,0 +1,73 @@
+// DesktopLUT - topology.h
+// Display topology reconciliation: diff the displays Windows reports against the monitors being
+// processed and plan the per-monitor actions that bring them back in line (no Windows dependencies)
+
+#pragma once
+
+#include "devicegroup.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One display as the processing thread sees it
+struct TopologyDisplay {
+    uint64_t id = 0;           // Display identity: EDID hash, survives port changes and reboots
+    AdapterId adapter;         // Adapter driving the display (moving adapters means a new device group)
+    uintptr_t handle = 0;      // HMONITOR; Windows hands out new ones when it rebuilds the monitor list
+    int32_t x = 0;             // Desktop rectangle
+    int32_t y = 0;
+    int32_t width = 0;
+    int32_t height = 0;
+    bool hdr = false;          // Advanced color enabled
+};
+
+// Actions for one monitor, applied in this order by ReconcileTopology
+enum TopologyAction : uint32_t {
+    TOPOLOGY_REMOVE = 1 << 0,       // Display gone (or moved adapter): park the monitor
+    TOPOLOGY_REBIND = 1 << 1,       // Same display, new HMONITOR
+    TOPOLOGY_MOVE = 1 << 2,         // Desktop position changed: move the overlay window
+    TOPOLOGY_RESIZE = 1 << 3,       // Mode changed: resize swapchain and window
+    TOPOLOGY_HDR = 1 << 4,          // Advanced color toggled: new capture format and swapchain
+    TOPOLOGY_REDUPLICATE = 1 << 5,  // Duplication must be recreated (resume, rebind, resize, HDR)
+    TOPOLOGY_ADD = 1 << 6,          // Configured display appeared: attach (or re-attach) it
+};
+
+struct TopologyStep {
+    uint64_t id = 0;
+    int running = -1;          // Index into the running list (-1 for TOPOLOGY_ADD)
+    int current = -1;          // Index into the current list (-1 for TOPOLOGY_REMOVE)
+    uint32_t actions = 0;      // TopologyAction bits
+};
+
+// Minimal plan that turns `running` into `current`:
+// - Displays pair up by id (and handle, when two share an id), then in list order
+// - Removes come first (frees their device resources), then updates, then adds
+// - Unchanged displays get no step, so they keep rendering untouched
+// - Only ids in `configured` are ever added
+// - resumed: the system woke from sleep, every kept display gets TOPOLOGY_REDUPLICATE
+std::vector<TopologyStep> PlanTopology(const std::vector<TopologyDisplay>& running,
+                                       const std::vector<TopologyDisplay>& current,
+                                       const std::vector<uint64_t>& configured, bool resumed);
+
+// "move+resize" style description for logs
+std::string FormatTopologyActions(uint32_t actions);
+
+// ============================================================================
+// Settling
+// ============================================================================
+
+// Display changes arrive in bursts (WM_DISPLAYCHANGE per window and per mode step, power
+// notifications on wake). Reconciliation runs once the burst has been quiet for a while,
+// instead of blocking the render loop for a fixed time.
+constexpr int64_t TOPOLOGY_SETTLE_MS = 500;
+
+struct TopologySettle {
+    bool pending = false;
+    bool resumed = false;      // A wake event is part of the burst
+    int64_t lastEventMs = 0;
+};
+
+void NoteTopologyEvent(TopologySettle& settle, int64_t nowMs, bool resumed);
+
+// True once per burst, settleMs after its last event; outResumed reports whether it included a wake
+bool TopologySettled(TopologySettle& settle, int64_t nowMs, int64_t settleMs, bool& outResumed);
@@ -12,8 +12,19 @@
 #include <dcomp.h>
 #include <string>
 #include <vector>
+#include <list>
 #include <thread>
 #include <chrono>
+#include <memory>
+#include "colorcorrection.h"
+#include "devicegroup.h"
+#include "presentstats.h"
+#include "metrics.h"
+#include "displaydb.h"
+#include "topology.h"
+#include "gpumanifest.h"
+#include "readback.h"
+#include "lutstack.h"
 
 // ============================================================================
 // Control IDs
@@ -33,6 +44,7 @@
 #define ID_STATUS           111
 #define ID_TETRAHEDRAL_CHECK 112
 #define ID_GAMMA_WHITELIST_BTN 113
+#define ID_TILED_PASS_CHECK 114
 #define ID_TRAY_ICON        1
 #define WM_TRAYICON         (WM_USER + 1)
 #define ID_TRAY_SHOW        2001
@@ -135,12 +147,6 @@ const int HOTKEY_HDR_TOGGLE = 5; // Win+Shift+H for HDR toggle on focused monito
 // Data Structures
 // ============================================================================
 
-// Preset display primaries (chromaticity coordinates) - for calculations
-struct DisplayPrimariesData {
-    float Rx, Ry, Gx, Gy, Bx, By;  // RGB chromaticity
-    float Wx, Wy;                   // White point
-};
-
 // Preset display primaries with name - for GUI presets
 struct DisplayPrimaries {
     float Rx, Ry, Gx, Gy, Bx, By;  // RGB chromaticity
@@ -148,33 +154,6 @@ struct DisplayPrimaries {
     const wchar_t* name;
 };
 
-// Grayscale correction settings (used in MonitorContext and runtime)
-struct GrayscaleData {
-    bool enabled = false;
-    int pointCount = 20;           // 10, 20, or 32
-    float points[32] = {};         // Fixed size, values 0-1 (max 32 points)
-    float peakNits = 10000.0f;     // HDR only: peak luminance for curve scaling
-    bool use24Gamma = false;       // SDR only: apply 2.2->2.4 gamma transform
-
-    void initLinear() {
-        // Initialize to linear response using square root distribution (for SDR)
-        // Point i corresponds to input (i/(N-1))^2, output should match input for linear
-        for (int i = 0; i < pointCount && i < 32; i++) {
-            float t = (float)i / (float)(pointCount - 1);
-            points[i] = t * t;  // Square root distribution: output = input = t^2
-        }
-    }
-
-    void initLinearPQ() {
-        // Initialize to linear response for PQ space (for HDR)
-        // Point i corresponds to input PQ value i/(N-1), output matches input for linear
-        for (int i = 0; i < pointCount && i < 32; i++) {
-            float t = (float)i / (float)(pointCount - 1);
-            points[i] = t;  // Evenly spaced in PQ: output = input = t
-        }
-    }
-};
-
 // Analysis result structure (matches GPU buffer layout - 64 bytes aligned)
 struct AnalysisResult {
     float peakNits = 0.0f;
@@ -200,151 +179,224 @@ struct FrameTimingStats {
     float varianceMs = 0.0f;     // Variance (jitter indicator)
     float fps = 0.0f;            // Current FPS (1000/avgMs)
     bool compositorClockAvailable = false;  // Whether API is available
+    float wakeupsPerSecond = 0.0f;  // Render-thread wakeups (blocking wait returns) per second
+    int idleState = 0;              // IdleState tier (0=Active, 1=Idle, 2=DeepIdle)
+    // Present statistics (from swapchain frame statistics, totals since start)
+    bool presentStatsAvailable = false;  // GetFrameStatistics has returned data
+    uint64_t presentsDisplayed = 0;
+    uint64_t presentsLate = 0;           // Shown past the latency budget
+    uint64_t refreshesMissed = 0;        // Refreshes lost to late presents
+    uint64_t presentsDuplicate = 0;      // Overwritten before any vblank showed them
+    float presentLatencyAvgMs = 0.0f;    // Present-to-vblank, rolling window
+    float presentLatencyMaxMs = 0.0f;
+    float presentLatencyPct[PRESENT_LATENCY_BUCKETS] = {};  // Share of presents per latency bucket (<1, 1-2, 2-3, 3+ refreshes)
 };
 
-// Tonemapping curve types (values match shader constants)
-enum class TonemapCurve {
-    BT2390 = 0,    // ITU-R BT.2390 EETF (Hermite spline)
-    SoftClip = 1,  // Simple exponential rolloff
-    Reinhard = 2,  // Shoulder-only Reinhard (hyperbolic)
-    BT2446A = 3,   // ITU-R BT.2446 Method A (logarithmic)
-    HardClip = 4,  // Hard clamp at target (for colorists)
+// What a pooled LUT's texels depend on: the path, every member file's size and write time (one
+// for a single file) and, for a stack, the interpolation baked into its composition
+struct LUTPoolKey {
+    std::wstring path;
+    std::vector<LUTFileStamp> stamps;
+    LutInterp interp = LUT_INTERP_TRILINEAR;
+    bool operator==(const LUTPoolKey& o) const { return path == o.path && stamps == o.stamps && interp == o.interp; }
 };
 
-// Dropdown order: BT2390, BT2446A, Reinhard, SoftClip, HardClip
-inline const TonemapCurve g_tonemapDropdownOrder[] = {
-    TonemapCurve::BT2390,
-    TonemapCurve::BT2446A,
-    TonemapCurve::Reinhard,
-    TonemapCurve::SoftClip,
-    TonemapCurve::HardClip,
+// FP16 RGB of every texel (PackLUTRGB), shared by the pool entry and its manifest replay
+typedef std::shared_ptr<const std::vector<uint16_t>> RetainedLUTTexels;
+
+// LUT texture shared by every monitor on a device that loads the same file. One per path: a
+// changed key replaces it in place.
+struct PooledLUT {
+    LUTPoolKey key;
+    int lutSize = 0;
+    int manifestIndex = -1;      // Texture entry, its SRV follows
+    RetainedLUTTexels retained;  // Rebuilds the texture after device loss without the file
+    ID3D11Texture3D* texture = nullptr;
+    ID3D11ShaderResourceView* srv = nullptr;
 };
 
-inline TonemapCurve DropdownIndexToTonemapCurve(int index) {
-    if (index >= 0 && index < 5) return g_tonemapDropdownOrder[index];
-    return TonemapCurve::BT2390;
-}
-
-inline int TonemapCurveToDropdownIndex(TonemapCurve curve) {
-    for (int i = 0; i < 5; i++) {
-        if (g_tonemapDropdownOrder[i] == curve) return i;
-    }
-    return 0;
-}
-
-// Tonemapping settings (HDR only)
-// Source peak is user-specified or dynamically detected
-struct TonemapData {
-    bool enabled = false;
-    bool dynamicPeak = false;         // Detect source peak per-frame (GPU-based)
-    TonemapCurve curve = TonemapCurve::BT2390;
-    float sourcePeakNits = 10000.0f;  // Content source peak (ignored when dynamicPeak=true)
-    float targetPeakNits = 1000.0f;   // Actual display capability
+// One D3D device per adapter that drives a configured monitor, plus the resources
+// every monitor on that adapter shares (monitors duplicate and render through their own group)
+struct GpuDevice {
+    AdapterId adapterId;
+    std::wstring adapterName;
+    std::vector<HMONITOR> monitors;                   // Monitors assigned to this group
+
+    ID3D11Device* device = nullptr;
+    ID3D11DeviceContext* context = nullptr;
+    ID3D11VertexShader* vs = nullptr;
+    ID3D11PixelShader* ps = nullptr;
+    ID3D11ComputeShader* peakDetectCS = nullptr;      // Compute shader for dynamic peak detection
+    ID3D11Buffer* peakCB = nullptr;                   // Constant buffer for peak detection parameters
+    ID3D11ComputeShader* analysisCS = nullptr;        // Compute shader for frame analysis
+    ID3D11Buffer* analysisCB = nullptr;               // Constant buffer for analysis parameters
+    ID3D11ComputeShader* scopesCS = nullptr;          // Compute shader for waveform/vectorscope/CIE scopes
+    ID3D11Buffer* scopesCB = nullptr;                 // Constant buffer for scope parameters
+    ID3D11ComputeShader* mainPassCS = nullptr;        // Tiled compute main pass (g_psSource with MAIN_PASS_CS)
+    ID3D11Buffer* tileCB = nullptr;                   // Constant buffer for main pass tile parameters
+    ID3D11ComputeShader* tileReduceCS = nullptr;      // Folds tile records into peak and analysis results
+    ID3D11Buffer* tileReduceCB = nullptr;             // Constant buffer for the reduction
+    ID3D11SamplerState* samplerPoint = nullptr;
+    ID3D11SamplerState* samplerLinear = nullptr;
+    ID3D11SamplerState* samplerWrap = nullptr;
+    ID3D11Buffer* constantBuffer = nullptr;
+    ID3D11Texture2D* blueNoiseTexture = nullptr;
+    ID3D11ShaderResourceView* blueNoiseSRV = nullptr;
+    std::list<PooledLUT> lutPool;                     // Holds one reference per texture (list: manifest slots point into it)
+
+    // How every object above (and each pooled LUT) is created, replayed after device loss
+    ResourceManifest manifest;
+    int nextManifestGroup = 0;                        // Next free all-or-nothing group id
 };
 
-// Color correction settings (used in MonitorContext and runtime)
-struct ColorCorrectionData {
-    bool primariesEnabled = false;
-    int primariesPreset = 0;       // Index into preset list
-    DisplayPrimariesData customPrimaries = { 0.64f, 0.33f, 0.30f, 0.60f, 0.15f, 0.06f, 0.3127f, 0.329f };
-    float primariesMatrix[9] = { 1,0,0, 0,1,0, 0,0,1 };  // Identity by default (includes Bradford adaptation)
-    GrayscaleData grayscale;
-    TonemapData tonemap;  // HDR tonemapping (only used in HDR mode)
-};
-
-// Per-monitor context (holds all state for one monitor)
-struct MonitorContext {
-    // Identity
+// Per-monitor cold state: identity, paths, composition objects, LUT ownership
+// Touched at init, reinit and recovery - never on the per-frame path
+struct MonitorColdState {
     HMONITOR monitor = nullptr;
-    int index = 0;  // 0, 1, 2...
     std::wstring name;
-
-    // Window
-    HWND hwnd = nullptr;
-    int width = 0;
-    int height = 0;
+    TopologyDisplay display;       // Display as last reconciled (id, adapter, rect, HDR)
+    bool detached = false;         // Display gone: resources released, window hidden, waiting for it to return
     int x = 0;
     int y = 0;  // Monitor position
 
-    // Desktop duplication
-    IDXGIOutputDuplication* duplication = nullptr;
-    DXGI_FORMAT captureFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
-    bool isHDREnabled = false;
     bool isHDRCapable = false;
-    bool wasHDREnabled = false;  // Track previous HDR state for mode change detection
-    float maxDisplayNits = 1000.0f;
-
-    // Rendering
-    IDXGISwapChain4* swapchain = nullptr;
-    ID3D11RenderTargetView* rtv = nullptr;
-    ID3D11ShaderResourceView* captureSRV = nullptr;
-    DXGI_FORMAT swapchainFormat = DXGI_FORMAT_R10G10B10A2_UNORM;
     DXGI_COLOR_SPACE_TYPE colorSpace = DXGI_COLOR_SPACE_RGB_FULL_G22_NONE_P709;
+    bool swapchainUAVRequested = false;  // Swapchain was created for the tiled main pass (UAV usage asked for)
 
     // DirectComposition
     IDCompositionTarget* dcompTarget = nullptr;
     IDCompositionVisual* dcompVisual = nullptr;
 
-    // Per-monitor LUTs
+    // LUT textures (SRVs live in MonitorContext) and their sources (for reload/info)
     ID3D11Texture3D* lutTextureSDR = nullptr;
-    ID3D11ShaderResourceView* lutSRV_SDR = nullptr;
     ID3D11Texture3D* lutTextureHDR = nullptr;
-    ID3D11ShaderResourceView* lutSRV_HDR = nullptr;
-    int lutSizeSDR = 0;
-    int lutSizeHDR = 0;
+    bool lutMutableSDR = false;    // Texture is a private updatable copy (live LUT streaming), not pooled
+    bool lutMutableHDR = false;
+    std::wstring sdrLutPath;
+    std::wstring hdrLutPath;
+};
 
-    // Dynamic peak detection (for adaptive tonemapping)
-    ID3D11Texture2D* peakTexture = nullptr;           // 1x1 R32_FLOAT for smoothed peak
-    ID3D11UnorderedAccessView* peakUAV = nullptr;     // UAV for compute shader write
-    ID3D11ShaderResourceView* peakSRV = nullptr;      // SRV for pixel shader read
-    ID3D11Texture2D* peakStagingTexture = nullptr;    // Staging texture for CPU readback
-    int lastPeakCBWidth = 0;                          // Track last written dimensions to avoid redundant CB updates
-    int lastPeakCBHeight = 0;
-    float detectedPeakNits = 0.0f;                    // Last detected peak (for analysis overlay)
+// GPU timestamps around one analysis dispatch, read a few passes later without waiting
+struct AnalysisTimer {
+    ID3D11Query* disjoint = nullptr;
+    ID3D11Query* begin = nullptr;
+    ID3D11Query* end = nullptr;
+    bool pending = false;      // Issued, results not read yet
+};
+
+// Per-monitor statistics: analysis overlay, frame timing, present accounting
+// Written every frame but only read when the overlay updates
+struct MonitorStats {
+    // Asynchronous readbacks (dynamic peak, analysis, scopes), rings created on first use
+    ReadbackManager readback;
+    int peakReadbackRing = -1;
+    int analysisReadbackRing = -1;
+    int scopesReadbackRing = -1;
+
+    // Dynamic peak readback (logging / analysis overlay)
+    std::chrono::steady_clock::time_point lastPeakReadback{};  // Readback throttle
+    float detectedPeakNits = 0.0f;                    // Last detected peak
 
     // Analysis resources (frame statistics overlay)
     ID3D11Buffer* analysisBuffer = nullptr;           // Structured buffer for results
     ID3D11UnorderedAccessView* analysisUAV = nullptr; // UAV for compute shader write
-    ID3D11Buffer* analysisStagingBuffer[2] = {nullptr, nullptr};  // Double-buffered for async readback
-    int analysisStagingIndex = 0;                     // Which staging buffer to use
-    int analysisFrameCounter = 0;                     // For dispatch/readback timing
+    AnalysisTimer analysisTimers[2];                  // Dispatches are passes apart, two is plenty
     float sessionMaxCLL = 0.0f;                       // Session peak tracking
     float sessionMaxFALL = 0.0f;                      // Session average tracking
     AnalysisResult analysisResult = {};               // Latest analysis result for display
 
+    // Scope bins (waveform/vectorscope/CIE counts, layout in scopes.h), same cadence as analysis
+    ID3D11Buffer* scopesBuffer = nullptr;
+    ID3D11UnorderedAccessView* scopesUAV = nullptr;
+
     // Frame timing tracking
     std::chrono::steady_clock::time_point lastFrameTime;
     float frameTimeHistory[64] = {};   // Rolling window of frame times (ms)
     int frameTimeIndex = 0;            // Current index in circular buffer
     int frameTimeCount = 0;            // Number of valid samples (0-64)
     FrameTimingStats frameTimingStats; // Computed stats for display
+    PresentAccounting presentStats;    // Vblank-mapped present accounting (see presentstats.h)
+    bool presentStatsAvailable = false;
+};
 
-    // LUT file paths (for reload/info)
-    std::wstring sdrLutPath;
-    std::wstring hdrLutPath;
+// Per-monitor context - hot render state first (contiguous, read every frame),
+// then per-mode color correction, with cold config and stats in separate blocks
+// Heap-allocated and owned by g_monitors, so addresses stay stable
+struct MonitorContext {
+    // Device and per-frame D3D objects
+    GpuDevice* gpu = nullptr;  // Device group of the adapter that owns this output (owned by g_gpuDevices)
+    IDXGIOutputDuplication* duplication = nullptr;
+    IDXGISwapChain4* swapchain = nullptr;
+    ID3D11RenderTargetView* rtv = nullptr;
+    ID3D11ShaderResourceView* captureSRV = nullptr;
+    ID3D11ShaderResourceView* lutSRV_SDR = nullptr;
+    ID3D11ShaderResourceView* lutSRV_HDR = nullptr;
 
-    // Frame timing (calculated from refresh rate)
-    UINT frameTimeMs = 16;  // Default for 60Hz, updated on init
+    // Dynamic peak detection (for adaptive tonemapping)
+    ID3D11Texture2D* peakTexture = nullptr;           // 1x1 R32_FLOAT for smoothed peak
+    ID3D11UnorderedAccessView* peakUAV = nullptr;     // UAV for compute shader write
+    ID3D11ShaderResourceView* peakSRV = nullptr;      // SRV for pixel shader read
 
-    // Per-monitor error tracking
-    bool enabled = true;           // false = skip in render loop
+    // Tiled compute main pass (g_tiledMainPass)
+    ID3D11UnorderedAccessView* backBufferUAV = nullptr;  // Back buffer output (swapchain created with UAV usage)
+    ID3D11Buffer* tileStatsBuffer = nullptr;          // One TILE_STAT_UINTS record per tile (see tiledpass.h)
+    ID3D11UnorderedAccessView* tileStatsUAV = nullptr;
+    ID3D11ShaderResourceView* tileStatsSRV = nullptr;
+    uint32_t tileStatsCapacity = 0;                   // Tiles the buffer holds
+
+    // Gamut boundary descriptor textures (index 0 = SDR, 1 = HDR), uploaded from ColorCorrectionData
+    ID3D11Texture2D* gamutTexture[2] = {nullptr, nullptr};
+    ID3D11ShaderResourceView* gamutSRV[2] = {nullptr, nullptr};
+    uint32_t gamutUploadedVersion[2] = {0, 0};        // GamutBoundaryData::version currently on GPU
+
+    MonitorMetrics* metrics = nullptr;  // Slot in g_metrics (stable, set at init)
+
+    // Window and frame geometry
+    HWND hwnd = nullptr;
+    int index = 0;  // 0, 1, 2...
+    int width = 0;
+    int height = 0;
+    UINT frameTimeMs = 16;         // Acquire timeout from refresh rate (default 60Hz, updated on init)
+    double refreshPeriodMs = 0.0;  // Exact refresh period (0 = unknown)
+    float maxDisplayNits = 1000.0f;
+    int lutSizeSDR = 0;            // Edge length of the bound LUTs (read by the CB fill)
+    int lutSizeHDR = 0;
+    DXGI_FORMAT captureFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
+    DXGI_FORMAT swapchainFormat = DXGI_FORMAT_R10G10B10A2_UNORM;
+    int lastPeakCBWidth = 0;       // Track last written dimensions to avoid redundant CB updates
+    int lastPeakCBHeight = 0;
+
+    // Per-monitor state and error tracking
     int consecutiveFailures = 0;   // track failures for retry logic
+    int framesAfterCommit = 0;     // frames rendered since dcompCommitted, for visibility delay
+    bool enabled = true;           // false = skip in render loop
+    bool isHDREnabled = false;
+    bool wasHDREnabled = false;    // Track previous HDR state for mode change detection
     bool usePassthrough = false;   // true = no LUT applied (no applicable LUT for current mode)
     bool dcompCommitted = false;   // true after first frame rendered (prevents black flash)
-    int framesAfterCommit = 0;     // frames rendered since dcompCommitted, for visibility delay
+
+    // Separately allocated blocks
+    std::unique_ptr<MonitorColdState> cold = std::make_unique<MonitorColdState>();
+    std::unique_ptr<MonitorStats> stats = std::make_unique<MonitorStats>();
 
     // Manual color correction settings (separate for SDR and HDR)
+    // CB fill reads the leading fields; the gamut boundary tables trail
     ColorCorrectionData sdrColorCorrection;
     ColorCorrectionData hdrColorCorrection;
 };
 
+// The render loop walks every monitor's context each frame; keep it to a handful of cache lines
+// (gamut tables and other large state live behind pointers - see monitor_frame_loop_8)
+static_assert(sizeof(MonitorContext) <= 1024, "MonitorContext grew: move cold or large state out of line");
+
 // Per-monitor LUT configuration from command line
 struct MonitorLUTConfig {
     int monitorIndex;
     std::wstring sdrLutPath;
     std::wstring hdrLutPath;
-    ColorCorrectionData sdrColorCorrection;  // Color correction for SDR mode
-    ColorCorrectionData hdrColorCorrection;  // Color correction for HDR mode
+    ColorCorrectionData sdrColorCorrection;  // Color correction for SDR mode (identity until compiled)
+    ColorCorrectionData hdrColorCorrection;  // Color correction for HDR mode (identity until compiled)
+    bool hasHdrColorCorrection = false;      // HDR correction configured, compiled or not
 };
 
 // Monitor enumeration callback data
@@ -352,11 +404,12 @@ struct EnumMonitorData {
     std::vector<HMONITOR> monitors;
 };
 
-// Real-time color correction updates
+// Real-time color correction updates (published by the correction compiler, see correction.h)
 struct PendingColorCorrection {
     int monitorIndex;
     bool isHDR;  // true = update HDR settings, false = update SDR settings
-    ColorCorrectionData data;
+    uint64_t version;  // Snapshot version - only newer bundles replace a pending one
+    ColorCorrectionData data;  // Immutable once published
 };
 
 // Grayscale correction settings for GUI (uses vector)
@@ -408,9 +461,9 @@ struct ColorCorrectionSettings {
     bool primariesEnabled = false;
     int primariesPreset = 0;       // Index into g_presetPrimaries
     DisplayPrimaries customPrimaries = { 0.6400f, 0.3300f, 0.3000f, 0.6000f, 0.1500f, 0.0600f, 0.3127f, 0.3290f, L"Custom" };
-    float primariesMatrix[9] = { 1,0,0, 0,1,0, 0,0,1 };  // Identity
     GrayscaleSettings grayscale;
     TonemapSettings tonemap;  // HDR tonemapping (only used in HDR mode)
+    bool gamutCompression = false;  // Soft gamut compression toward display primaries (INI only)
 };
 
 // Per-monitor settings for persistence
@@ -432,6 +485,7 @@ struct GUIState {
     HWND hwndGammaCheck = nullptr;
     HWND hwndGammaWhitelistBtn = nullptr;
     HWND hwndTetrahedralCheck = nullptr;
+    HWND hwndTiledPassCheck = nullptr;
     HWND hwndApply = nullptr;
     HWND hwndStop = nullptr;
     NOTIFYICONDATA nid = {};
@@ -440,6 +494,9 @@ struct GUIState {
     std::vector<HMONITOR> monitors;
     std::vector<std::wstring> monitorNames;
     std::vector<MonitorSettings> monitorSettings;  // Per-monitor LUT paths (editable)
+    std::vector<uint64_t> monitorEdidHashes;       // Display identity per monitor (0 = EDID unavailable)
+    std::vector<MonitorSectionPlan> monitorSections;  // INI section per monitor, planned by LoadSettings
+    DisplayDatabase displayDb;                     // DesktopLUT-displays.db, loaded once at startup
     std::vector<MonitorSettings> activeSettings;   // Settings currently running (for comparison)
     int currentMonitor = 0;  // Currently selected monitor in list
 
@@ -0,0 +1,327 @@
+// DesktopLUT - whitelist.cpp
+// Process whitelist compiler and matcher (exact names, wildcards, full paths)
+
+#include "whitelist.h"
+#include <algorithm>
+#include <cwchar>
+#include <cwctype>
+
+// Scratch sizes for lowercase copies (Toolhelp names are MAX_PATH, image paths can be longer)
+static const size_t NAME_BUFFER_SIZE = 260;
+static const size_t PATH_BUFFER_SIZE = 1024;
+
+static bool IsBlank(wchar_t c) {
+    return c == L' ' || c == L'\t' || c == L'\r' || c == L'\n';
+}
+
+static bool EndsWithExe(std::wstring_view s) {
+    if (s.size() <= 4) return false;
+    std::wstring_view ext = s.substr(s.size() - 4);
+    return ext[0] == L'.' && towlower(ext[1]) == L'e' && towlower(ext[2]) == L'x' && towlower(ext[3]) == L'e';
+}
+
+// Lowercase copy into a fixed buffer, optionally folding '\' to '/'; truncates to fit
+static std::wstring_view LowerInto(const wchar_t* src, wchar_t* buf, size_t bufSize, bool foldSlashes) {
+    size_t n = 0;
+    for (; src[n] && n + 1 < bufSize; n++) {
+        wchar_t c = (wchar_t)towlower(src[n]);
+        buf[n] = (foldSlashes && c == L'\\') ? L'/' : c;
+    }
+    buf[n] = 0;
+    return std::wstring_view(buf, n);
+}
+
+std::wstring NormalizeWhitelistEntry(std::wstring_view entry) {
+    size_t start = 0, end = entry.size();
+    while (start < end && IsBlank(entry[start])) start++;
+    while (end > start && IsBlank(entry[end - 1])) end--;
+
+    std::wstring out(entry.substr(start, end - start));
+    for (wchar_t& c : out) {
+        c = (wchar_t)towlower(c);
+        if (c == L'\\') c = L'/';
+    }
+
+    // Plain names are stored without .exe (matched with and without it)
+    // Path entries are kept literal - they match anywhere in the full path
+    if (out.find(L'/') == std::wstring::npos && EndsWithExe(out)) {
+        out.resize(out.size() - 4);
+    }
+    return out;
+}
+
+void ParseWhitelistEntries(const std::wstring& raw, std::vector<std::wstring>& out) {
+    out.clear();
+    size_t itemStart = 0;
+    for (size_t i = 0; i <= raw.size(); i++) {
+        if (i == raw.size() || raw[i] == L',' || raw[i] == L';') {
+            std::wstring entry = NormalizeWhitelistEntry(std::wstring_view(raw).substr(itemStart, i - itemStart));
+            if (!entry.empty()) {
+                out.push_back(std::move(entry));
+            }
+            itemStart = i + 1;
+        }
+    }
+}
+
+static void CompileGlob(const std::wstring& pattern, bool isPath, CompiledGlob& out) {
+    out.segments.clear();
+    // Path entries are implicitly unanchored (match anywhere in the path)
+    out.anchoredStart = !isPath && !pattern.empty() && pattern.front() != L'*';
+    out.anchoredEnd = !isPath && !pattern.empty() && pattern.back() != L'*';
+
+    size_t segStart = 0;
+    for (size_t i = 0; i <= pattern.size(); i++) {
+        if (i == pattern.size() || pattern[i] == L'*') {
+            if (i > segStart) {
+                out.segments.push_back(pattern.substr(segStart, i - segStart));
+            }
+            segStart = i + 1;
+        }
+    }
+}
+
+// Longest literal run of a glob ('*' and '?' both end a run); empty if it has none
+static std::wstring_view GlobKey(const CompiledGlob& glob) {
+    std::wstring_view best;
+    for (const auto& segment : glob.segments) {
+        std::wstring_view seg(segment);
+        size_t runStart = 0;
+        for (size_t i = 0; i <= seg.size(); i++) {
+            if (i == seg.size() || seg[i] == L'?') {
+                if (i - runStart > best.size()) best = seg.substr(runStart, i - runStart);
+                runStart = i + 1;
+            }
+        }
+    }
+    return best;
+}
+
+static uint32_t FindEdge(const GlobSet& set, const GlobSet::Node& node, wchar_t c) {
+    auto first = set.edges.begin() + node.firstEdge;
+    auto last = first + node.edgeCount;
+    auto it = std::lower_bound(first, last, c, [](const GlobSet::Edge& e, wchar_t ch) { return e.c < ch; });
+    return (it != last && it->c == c) ? it->next : UINT32_MAX;
+}
+
+// Trie of glob keys flattened into sorted edge runs, then fail/output links breadth-first
+static void BuildGlobSet(GlobSet& set) {
+    std::vector<std::vector<GlobSet::Edge>> children(1);
+    std::vector<std::vector<uint32_t>> keyEnds(1);
+    set.unkeyedGlobs.clear();
+    for (uint32_t g = 0; g < (uint32_t)set.globs.size(); g++) {
+        std::wstring_view key = GlobKey(set.globs[g]);
+        if (key.empty()) {
+            set.unkeyedGlobs.push_back(g);
+            continue;
+        }
+        uint32_t node = 0;
+        for (wchar_t c : key) {
+            auto& kids = children[node];
+            auto it = std::lower_bound(kids.begin(), kids.end(), c, [](const GlobSet::Edge& e, wchar_t ch) { return e.c < ch; });
+            if (it == kids.end() || it->c != c) {
+                uint32_t child = (uint32_t)children.size();
+                kids.insert(it, { c, child });
+                children.emplace_back();
+                keyEnds.emplace_back();
+                node = child;
+            } else {
+                node = it->next;
+            }
+        }
+        keyEnds[node].push_back(g);
+    }
+
+    set.nodes.assign(children.size(), GlobSet::Node());
+    set.edges.clear();
+    set.keyedGlobs.clear();
+    for (size_t n = 0; n < children.size(); n++) {
+        GlobSet::Node& node = set.nodes[n];
+        node.firstEdge = (uint32_t)set.edges.size();
+        node.edgeCount = (uint32_t)children[n].size();
+        set.edges.insert(set.edges.end(), children[n].begin(), children[n].end());
+        node.firstGlob = (uint32_t)set.keyedGlobs.size();
+        node.globCount = (uint32_t)keyEnds[n].size();
+        set.keyedGlobs.insert(set.keyedGlobs.end(), keyEnds[n].begin(), keyEnds[n].end());
+    }
+
+    // A node's fail target is shallower, so its links are final before the node is dequeued
+    std::vector<uint32_t> queue(1, 0);
+    queue.reserve(set.nodes.size());
+    for (size_t q = 0; q < queue.size(); q++) {
+        uint32_t u = queue[q];
+        GlobSet::Node& node = set.nodes[u];
+        node.output = node.globCount ? u : (u ? set.nodes[node.fail].output : UINT32_MAX);
+        for (uint32_t e = node.firstEdge; e < node.firstEdge + node.edgeCount; e++) {
+            wchar_t c = set.edges[e].c;
+            uint32_t v = set.edges[e].next;
+            uint32_t f = node.fail, next;
+            while ((next = FindEdge(set, set.nodes[f], c)) == UINT32_MAX && f != 0) f = set.nodes[f].fail;
+            set.nodes[v].fail = (next == UINT32_MAX || next == v) ? 0 : next;
+            queue.push_back(v);
+        }
+    }
+}
+
+void CompileWhitelist(const std::vector<std::wstring>& entries, CompiledWhitelist& out) {
+    out.exactNames.clear();
+    out.nameGlobs.globs.clear();
+    out.pathGlobs.globs.clear();
+
+    for (const auto& entry : entries) {
+        bool isPath = entry.find(L'/') != std::wstring::npos;
+        bool isGlob = entry.find_first_of(L"*?") != std::wstring::npos;
+        if (isPath) {
+            out.pathGlobs.globs.emplace_back();
+            CompileGlob(entry, true, out.pathGlobs.globs.back());
+        } else if (isGlob) {
+            out.nameGlobs.globs.emplace_back();
+            CompileGlob(entry, false, out.nameGlobs.globs.back());
+        } else {
+            out.exactNames.insert(entry);
+        }
+    }
+    BuildGlobSet(out.nameGlobs);
+    BuildGlobSet(out.pathGlobs);
+}
+
+// Literal segment match at a fixed position ('?' matches any single char)
+static bool SegmentMatchesAt(std::wstring_view str, size_t pos, const std::wstring& seg) {
+    if (pos + seg.size() > str.size()) return false;
+    for (size_t i = 0; i < seg.size(); i++) {
+        if (seg[i] != L'?' && seg[i] != str[pos + i]) return false;
+    }
+    return true;
+}
+
+// Leftmost occurrence of segment in [from, limit)
+static size_t FindSegment(std::wstring_view str, size_t from, size_t limit, const std::wstring& seg) {
+    if (seg.size() > limit) return std::wstring_view::npos;
+    for (size_t pos = from; pos + seg.size() <= limit; pos++) {
+        if (SegmentMatchesAt(str, pos, seg)) return pos;
+    }
+    return std::wstring_view::npos;
+}
+
+// Greedy leftmost matching of '*'-separated segments is exact for * / ? globs
+static bool GlobMatches(const CompiledGlob& glob, std::wstring_view str) {
+    const auto& segs = glob.segments;
+    if (segs.empty()) {
+        // Pattern was only '*'s (or empty)
+        return !glob.anchoredStart || str.empty();
+    }
+
+    size_t first = 0, last = segs.size();
+    size_t pos = 0, limit = str.size();
+
+    if (glob.anchoredStart) {
+        if (!SegmentMatchesAt(str, 0, segs[0])) return false;
+        pos = segs[0].size();
+        first = 1;
+        // Single segment with no '*' must cover the whole string
+        if (glob.anchoredEnd && segs.size() == 1) return pos == str.size();
+    }
+    if (glob.anchoredEnd && last > first) {
+        const std::wstring& tail = segs[last - 1];
+        if (tail.size() > str.size() - pos) return false;
+        size_t tailPos = str.size() - tail.size();
+        if (!SegmentMatchesAt(str, tailPos, tail)) return false;
+        limit = tailPos;
+        last--;
+    }
+
+    for (size_t i = first; i < last; i++) {
+        size_t found = FindSegment(str, pos, limit, segs[i]);
+        if (found == std::wstring_view::npos) return false;
+        pos = found + segs[i].size();
+    }
+    return true;
+}
+
+// One automaton pass collects the globs whose key occurs in str; only those run the full match
+static bool GlobSetMatches(const GlobSet& set, std::wstring_view str) {
+    for (uint32_t g : set.unkeyedGlobs) {
+        if (GlobMatches(set.globs[g], str)) return true;
+    }
+    if (set.nodes.size() <= 1) return false;
+
+    uint32_t state = 0;
+    for (wchar_t c : str) {
+        uint32_t next;
+        while ((next = FindEdge(set, set.nodes[state], c)) == UINT32_MAX && state != 0) state = set.nodes[state].fail;
+        state = next == UINT32_MAX ? 0 : next;
+
+        for (uint32_t o = set.nodes[state].output; o != UINT32_MAX; o = set.nodes[set.nodes[o].fail].output) {
+            const GlobSet::Node& hit = set.nodes[o];
+            for (uint32_t i = 0; i < hit.globCount; i++) {
+                if (GlobMatches(set.globs[set.keyedGlobs[hit.firstGlob + i]], str)) return true;
+            }
+        }
+    }
+    return false;
+}
+
+static bool MatchWhitelistPath(const CompiledWhitelist& wl, const wchar_t* fullPath) {
+    wchar_t pathBuf[PATH_BUFFER_SIZE];
+    std::wstring_view path = LowerInto(fullPath, pathBuf, PATH_BUFFER_SIZE, true);
+    return GlobSetMatches(wl.pathGlobs, path);
+}
+
+bool MatchWhitelist(const CompiledWhitelist& wl, const wchar_t* exeName, const wchar_t* fullPath) {
+    wchar_t nameBuf[NAME_BUFFER_SIZE];
+    std::wstring_view fullName = LowerInto(exeName, nameBuf, NAME_BUFFER_SIZE, false);
+    std::wstring_view baseName = EndsWithExe(fullName) ? fullName.substr(0, fullName.size() - 4) : fullName;
+
+    // Exact names: O(name length) hash lookup, base name first then full name
+    if (!wl.exactNames.empty()) {
+        if (wl.exactNames.find(baseName) != wl.exactNames.end()) return true;
+        if (baseName.size() != fullName.size() && wl.exactNames.find(fullName) != wl.exactNames.end()) return true;
+    }
+
+    if (GlobSetMatches(wl.nameGlobs, baseName)) return true;
+    return fullPath && !wl.pathGlobs.empty() && MatchWhitelistPath(wl, fullPath);
+}
+
+void BeginWhitelistScan(WhitelistProcessCache& cache) {
+    cache.scan++;
+}
+
+void EndWhitelistScan(WhitelistProcessCache& cache) {
+    std::erase_if(cache.entries, [&cache](const WhitelistProcessCache::Entry& e) { return e.scan != cache.scan; });
+}
+
+bool MatchWhitelistProcess(const CompiledWhitelist& wl, WhitelistProcessCache& cache, const WhitelistProcess& process,
+                           const WhitelistPathQuery& queryPath) {
+    // Name entries first - no need to know the path
+    if (MatchWhitelist(wl, process.exeName, nullptr)) return true;
+    if (!wl.needsFullPath()) return false;
+
+    size_t nameHash = std::hash<std::wstring_view>{}(process.exeName);
+    auto it = std::lower_bound(cache.entries.begin(), cache.entries.end(), process.pid,
+                               [](const WhitelistProcessCache::Entry& e, uint32_t pid) { return e.pid < pid; });
+    if (it != cache.entries.end() && it->pid == process.pid) {
+        if (it->parentPid == process.parentPid && it->nameHash == nameHash) {
+            it->scan = cache.scan;
+            return it->pathMatched;
+        }
+        // Pid reused by another process - requery below
+    } else {
+        it = cache.entries.insert(it, WhitelistProcessCache::Entry());
+    }
+
+    wchar_t pathBuf[PATH_BUFFER_SIZE];
+    const wchar_t* fullPath = queryPath ? queryPath(process.pid, pathBuf, PATH_BUFFER_SIZE) : nullptr;
+    cache.pathQueries++;
+    bool matched = fullPath && MatchWhitelistPath(wl, fullPath);
+    *it = { process.pid, process.parentPid, nameHash, cache.scan, matched };
+    return matched;
+}
+
+bool WhitelistNameEquals(const wchar_t* exeName, const wchar_t* otherName) {
+    wchar_t aBuf[NAME_BUFFER_SIZE], bBuf[NAME_BUFFER_SIZE];
+    std::wstring_view a = LowerInto(exeName, aBuf, NAME_BUFFER_SIZE, false);
+    std::wstring_view b = LowerInto(otherName, bBuf, NAME_BUFFER_SIZE, false);
+    if (EndsWithExe(a)) a.remove_suffix(4);
+    if (EndsWithExe(b)) b.remove_suffix(4);
+    return a == b;
+}
@@ -0,0 +1,121 @@
+// DesktopLUT - whitelist.h
+// Process whitelist compiler and matcher (exact names, wildcards, full paths)
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+// Entry syntax (case-insensitive, .exe suffix optional on names):
+//   mpv            exact executable name - hash set lookup
+//   *player*       wildcard name (* = any run, ? = any char) - matched against name without .exe
+//   steamapps/*/   contains '/' or '\' - matched anywhere in the full image path
+
+// Heterogeneous hash so lookups take a wstring_view into a stack buffer (no allocation)
+struct WhitelistNameHash {
+    using is_transparent = void;
+    size_t operator()(std::wstring_view s) const { return std::hash<std::wstring_view>{}(s); }
+};
+
+// Wildcard pattern pre-split on '*' into literal segments ('?' kept as single-char wildcard)
+struct CompiledGlob {
+    std::vector<std::wstring> segments;
+    bool anchoredStart = true;    // Pattern doesn't begin with '*'
+    bool anchoredEnd = true;      // Pattern doesn't end with '*'
+};
+
+// All globs of one kind behind a single Aho-Corasick automaton. Each glob is keyed by its longest
+// literal run without '?'; a string can only match globs whose key occurs in it, so one pass over
+// the string (O(length), independent of the glob count) finds every candidate, and only those are
+// checked against the full pattern.
+struct GlobSet {
+    struct Node {
+        uint32_t firstEdge = 0;       // Into edges, sorted by char
+        uint32_t edgeCount = 0;
+        uint32_t fail = 0;            // Longest proper suffix that is also a trie node
+        uint32_t output = UINT32_MAX; // Nearest node on the fail chain (itself included) ending a key
+        uint32_t firstGlob = 0;       // Into keyedGlobs: globs whose key ends at this node
+        uint32_t globCount = 0;
+    };
+    struct Edge {
+        wchar_t c;
+        uint32_t next;
+    };
+
+    std::vector<CompiledGlob> globs;
+    std::vector<Node> nodes;          // nodes[0] is the root
+    std::vector<Edge> edges;
+    std::vector<uint32_t> keyedGlobs;
+    std::vector<uint32_t> unkeyedGlobs;   // No literal at all ('*', '?*'): always checked
+
+    size_t size() const { return globs.size(); }
+    bool empty() const { return globs.empty(); }
+};
+
+struct CompiledWhitelist {
+    std::unordered_set<std::wstring, WhitelistNameHash, std::equal_to<>> exactNames;
+    GlobSet nameGlobs;
+    GlobSet pathGlobs;
+
+    bool empty() const { return exactNames.empty() && nameGlobs.empty() && pathGlobs.empty(); }
+    bool needsFullPath() const { return !pathGlobs.empty(); }
+};
+
+// Normalize one entry: trim, lowercase, '\' -> '/', strip .exe from plain names
+// Returns empty string for blank entries
+std::wstring NormalizeWhitelistEntry(std::wstring_view entry);
+
+// Split a comma/semicolon separated list into normalized entries
+void ParseWhitelistEntries(const std::wstring& raw, std::vector<std::wstring>& out);
+
+// Build the matcher from normalized entries (reuses out's storage)
+void CompileWhitelist(const std::vector<std::wstring>& entries, CompiledWhitelist& out);
+
+// Match a process against the compiled whitelist
+// exeName: image name as reported by Toolhelp (any case, with or without .exe)
+// fullPath: full image path, or nullptr if unavailable (path entries then never match)
+bool MatchWhitelist(const CompiledWhitelist& wl, const wchar_t* exeName, const wchar_t* fullPath);
+
+// Path-entry results per running process, so a poll opens only processes it hasn't seen before.
+// A process is identified by its snapshot entry (pid, parent pid, image name); a pid reused by a
+// different image or parent is a new process. Entries for pids missing from a complete scan are
+// dropped. Owned by one polling thread; clear it when the whitelist is recompiled.
+struct WhitelistProcessCache {
+    struct Entry {
+        uint32_t pid;
+        uint32_t parentPid;
+        size_t nameHash;
+        uint32_t scan;                // Last scan that saw the process
+        bool pathMatched;
+    };
+    std::vector<Entry> entries;       // Sorted by pid
+    uint32_t scan = 0;
+
+    uint64_t pathQueries = 0;         // Processes whose image path had to be queried
+};
+
+// One process from a snapshot
+struct WhitelistProcess {
+    uint32_t pid;
+    uint32_t parentPid;
+    const wchar_t* exeName;
+};
+
+// Full image path of a process into buf (size in chars), nullptr if it can't be queried
+typedef std::function<const wchar_t*(uint32_t pid, wchar_t* buf, size_t size)> WhitelistPathQuery;
+
+// Start / finish a scan. Only a complete scan (every process visited) drops stale entries.
+void BeginWhitelistScan(WhitelistProcessCache& cache);
+void EndWhitelistScan(WhitelistProcessCache& cache);
+
+// Match one snapshot process: names first, then path entries - from the cache, or by querying
+// the path once per process (a failed query caches as no match)
+bool MatchWhitelistProcess(const CompiledWhitelist& wl, WhitelistProcessCache& cache, const WhitelistProcess& process,
+                           const WhitelistPathQuery& queryPath);
+
+// Case-insensitive executable name comparison ignoring a trailing .exe on either side
+bool WhitelistNameEquals(const wchar_t* exeName, const wchar_t* otherName);
@@ -0,0 +1,52 @@
+// DesktopLUT - tests/check.h
+// Minimal assertions for the portable-module tests (no framework, no dependencies)
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+
+inline int g_checkFailures = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            g_checkFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) \
+    do { \
+        auto checkA_ = (a); \
+        auto checkB_ = (b); \
+        if (!(checkA_ == checkB_)) { \
+            std::fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %g vs %g\n", __FILE__, __LINE__, #a, #b, \
+                         (double)checkA_, (double)checkB_); \
+            g_checkFailures++; \
+        } \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tolerance) \
+    do { \
+        double checkA_ = (double)(a); \
+        double checkB_ = (double)(b); \
+        if (!(std::fabs(checkA_ - checkB_) <= (tolerance))) { \
+            std::fprintf(stderr, "%s:%d: CHECK_NEAR(%s, %s) failed: %.9g vs %.9g\n", __FILE__, __LINE__, #a, #b, \
+                         checkA_, checkB_); \
+            g_checkFailures++; \
+        } \
+    } while (0)
+
+// Run one test function and report it
+#define RUN_TEST(fn) \
+    do { \
+        int checkBefore_ = g_checkFailures; \
+        fn(); \
+        std::printf("%s %s\n", g_checkFailures == checkBefore_ ? "[ ok ]" : "[FAIL]", #fn); \
+    } while (0)
+
+inline int CheckExitCode() {
+    if (g_checkFailures) std::fprintf(stderr, "%d check(s) failed\n", g_checkFailures);
+    return g_checkFailures ? 1 : 0;
+}
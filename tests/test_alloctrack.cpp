@@ -0,0 +1,192 @@
+// DesktopLUT - tests/test_alloctrack.cpp
+// Allocation counting covers every operator new form; the portable per-frame work allocates nothing
+
+#include "alloctrack.h"
+#include "analysisring.h"
+#include "analysissched.h"
+#include "check.h"
+#include "idle.h"
+#include "metrics.h"
+#include "presentstats.h"
+#include "readback.h"
+#include "whitelist.h"
+
+#include <chrono>
+#include <new>
+#include <vector>
+
+static_assert(DESKTOPLUT_ALLOC_TRACKING, "built with DESKTOPLUT_ALLOC_TRACKING=1 (tests/CMakeLists.txt)");
+
+using Clock = std::chrono::steady_clock;
+
+struct alignas(64) CacheLine {
+    float v[16];
+};
+
+// Keeps new/delete pairs from being elided (the compiler may drop an unobserved allocation)
+static void* volatile g_escape = nullptr;
+
+template <typename T>
+static T* Escape(T* p) {
+    g_escape = p;
+    return p;
+}
+
+// Allocations the calling thread makes inside fn
+template <typename Fn>
+static uint64_t CountAllocs(Fn&& fn) {
+    uint64_t before = AllocThreadCount();
+    fn();
+    return AllocThreadCount() - before;
+}
+
+static void EveryOverloadCounted() {
+    CHECK_EQ(CountAllocs([] { delete Escape(new int(1)); }), 1u);
+    CHECK_EQ(CountAllocs([] { delete[] Escape(new int[4]); }), 1u);
+    CHECK_EQ(CountAllocs([] { delete Escape(new (std::nothrow) int(1)); }), 1u);
+    CHECK_EQ(CountAllocs([] { delete[] Escape(new (std::nothrow) int[4]); }), 1u);
+
+    // Over-aligned types go through the align_val_t forms
+    CHECK_EQ(CountAllocs([] {
+        CacheLine* p = Escape(new CacheLine());
+        CHECK((reinterpret_cast<uintptr_t>(p) & 63) == 0);
+        delete p;
+    }), 1u);
+    CHECK_EQ(CountAllocs([] { delete[] Escape(new CacheLine[3]); }), 1u);
+    CHECK_EQ(CountAllocs([] { delete Escape(new (std::nothrow) CacheLine()); }), 1u);
+    CHECK_EQ(CountAllocs([] {
+        void* p = Escape(::operator new(100, std::align_val_t(256)));
+        CHECK((reinterpret_cast<uintptr_t>(p) & 255) == 0);
+        ::operator delete(p, std::align_val_t(256));
+    }), 1u);
+
+    // Library allocations land in the same counter
+    CHECK_EQ(CountAllocs([] { std::vector<int> v(10); Escape(v.data()); }), 1u);
+
+    uint64_t bytes = AllocThreadBytes();
+    delete[] Escape(new char[1000]);
+    CHECK(AllocThreadBytes() - bytes >= 1000);
+}
+
+// Fake GPU side: fixed staging slots, every copy finished by the first poll
+static char g_staging[4][256];
+static int g_stagingUsed = 0;
+
+static ReadbackOps FakeReadbackOps() {
+    ReadbackOps ops;
+    ops.create = [](const ReadbackDesc&) -> void* { return g_stagingUsed < 4 ? g_staging[g_stagingUsed++] : nullptr; };
+    ops.release = [](void*) {};
+    ops.copy = [](void*, void*) {};
+    ops.map = [](void* staging, const void** data) {
+        *data = staging;
+        return READBACK_MAP_READY;
+    };
+    ops.unmap = [](void*) {};
+    return ops;
+}
+
+// What the render loop does per monitor per frame outside of D3D: idle tracking, readback
+// polling, present statistics, metrics, analysis scheduling and the analysis time series
+static void SteadyStateFrameLoopAllocatesNothing() {
+    IdleTracker idle;
+
+    ReadbackManager rb;
+    rb.ops = FakeReadbackOps();
+    uint64_t deliveredFrames = 0;
+    int ring = AddReadbackRing(rb, "peak", ReadbackDesc{ 16, 0, 0, 0 }, 3, 2,
+                               [&deliveredFrames](const void*, uint64_t frame) { deliveredFrames = frame; });
+
+    char source = 0;             // Stands in for the GPU resource being copied
+    PresentAccounting present;
+    MetricsRegistry metrics;
+    MonitorMetrics* mm = MetricsAttachMonitor(metrics, 0);
+
+    std::vector<unsigned char> ringFile(AnalysisRingBytes(1024));
+    CHECK(AnalysisRingAttach(ringFile.data(), ringFile.size(), 1024));
+
+    // Three monitors on two adapters, more due than the budget allows
+    AnalysisScheduler sched;
+    sched.budgetMs = 0.3f;
+    for (int i = 0; i < 3; i++) {
+        AnalysisSchedMonitor& m = AnalysisSchedSlot(sched, i);
+        m.active = true;
+        m.group = i / 2;
+        m.interval = 1;
+    }
+
+    Clock::time_point start = Clock::time_point(std::chrono::seconds(1000));
+    uint32_t presentId = 0;
+    auto frame = [&](int n) {
+        Clock::time_point now = start + std::chrono::milliseconds(n * 16);
+        IdleOnWakeup(idle, now);
+        IdleOnFrame(idle, now);
+        IdleUpdate(idle, now, true);
+
+        PollReadbacks(rb);
+        RequestReadback(rb, ring, &source);
+        AdvanceReadbackFrame(rb);
+
+        presentId++;
+        PresentStatsOnPresent(present, presentId, n * 16.0);
+        PresentStatsOnSample(present, PresentStatsSample{ presentId - 1, presentId + 1, presentId + 1, n * 16.0 + 8.0 }, 16.0);
+        float avgMs, maxMs;
+        PresentStatsLatency(present, avgMs, maxMs);
+
+        MetricInc(mm->framesRendered);
+        MetricSet(mm->peakNits, 400.0);
+        MetricObserve(mm->frameTimeMs, 16.0 + (n % 3));
+
+        PlanAnalysisPass(sched);
+        for (int i = 0; i < 3; i++) {
+            if (!IsAnalysisGranted(sched, i)) continue;
+            MarkAnalysisDispatched(sched, i);
+            ReportAnalysisCost(sched, i, 0.2f);
+            AnalysisSignature signature;
+            signature.avgNits = 100.0f + (n % 7) * 10.0f;
+            ReportAnalysisResult(sched, i, signature);
+        }
+
+        AnalysisRecord record = {};
+        record.timestampMs = (uint64_t)n * 16;
+        record.avgNits = 100.0f;
+        AnalysisRingAppend(ringFile.data(), record);
+    };
+
+    // Warm-up may size things once (staging creation)
+    for (int n = 0; n < 240; n++) frame(n);
+    uint64_t allocs = CountAllocs([&] {
+        for (int n = 240; n < 2400; n++) frame(n);
+    });
+    CHECK_EQ(allocs, 0u);
+    CHECK(deliveredFrames > 2000);
+    CHECK(present.displayed > 2000);
+    CHECK(sched.monitors[0].deferrals + sched.monitors[1].deferrals > 0);
+}
+
+// A whitelist poll once every process's path result is cached
+static void WhitelistPollAllocatesNothing() {
+    std::vector<std::wstring> entries;
+    ParseWhitelistEntries(L"mpv, *player*, steamapps/common/", entries);
+    CompiledWhitelist wl;
+    CompileWhitelist(entries, wl);
+    WhitelistProcessCache cache;
+    cache.entries.reserve(64);
+    WhitelistPathQuery query = [](uint32_t, wchar_t*, size_t) -> const wchar_t* { return L"C:\\Windows\\app.exe"; };
+
+    auto poll = [&] {
+        BeginWhitelistScan(cache);
+        for (uint32_t pid = 4; pid < 64; pid++) MatchWhitelistProcess(wl, cache, { pid, 4, L"app.exe" }, query);
+        EndWhitelistScan(cache);
+    };
+    poll();
+    CHECK_EQ(CountAllocs([&] {
+        for (int i = 0; i < 100; i++) poll();
+    }), 0u);
+}
+
+int main() {
+    RUN_TEST(EveryOverloadCounted);
+    RUN_TEST(SteadyStateFrameLoopAllocatesNothing);
+    RUN_TEST(WhitelistPollAllocatesNothing);
+    return CheckExitCode();
+}
@@ -0,0 +1,125 @@
+// DesktopLUT - tests/test_analysisring.cpp
+// Analysis time series ring: file layout, attach/resume/reformat, wraparound, fixed-point shares.
+// "test_analysisring --write <path>" writes the sample ring test_query_analysis.py reads.
+
+#include "analysisring.h"
+#include "check.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Offsets tools/query_analysis.py unpacks ("<QBBH7f6H5HH" after a "<IIIIQ40x" header)
+static_assert(offsetof(AnalysisRingHeader, writeCount) == 16, "header layout");
+static_assert(offsetof(AnalysisRecord, monitorIndex) == 8, "record layout");
+static_assert(offsetof(AnalysisRecord, peakNits) == 12, "record layout");
+static_assert(offsetof(AnalysisRecord, fps) == 36, "record layout");
+static_assert(offsetof(AnalysisRecord, shareRec709) == 40, "record layout");
+static_assert(offsetof(AnalysisRecord, histogram) == 52, "record layout");
+
+static const uint64_t SAMPLE_BASE_MS = 1792195200000ull;   // 2026-10-17 00:00 UTC
+static const uint32_t SAMPLE_CAPACITY = 8;
+static const int SAMPLE_RECORDS = 13;                       // Wraps once: records 5..12 survive
+
+// Record n of the sample series (values test_query_analysis.py checks)
+static AnalysisRecord SampleRecord(int n) {
+    AnalysisRecord r = {};
+    r.timestampMs = SAMPLE_BASE_MS + (uint64_t)n * 500;
+    r.monitorIndex = (uint8_t)(n % 2);
+    r.flags = (n % 2) ? ANALYSIS_RECORD_HDR : 0;
+    r.peakNits = 100.0f + n * 10.0f;
+    r.avgNits = 20.0f + n;
+    r.minNonZeroNits = 0.5f;
+    r.detectedPeakNits = 90.0f + n * 10.0f;
+    r.frameAvgMs = 16.5f;
+    r.frameMaxMs = 20.0f + n;
+    r.fps = 60.0f;
+    r.shareRec709 = AnalysisShare(9000, 10000);
+    r.shareP3Only = AnalysisShare(700, 10000);
+    r.shareRec2020Only = AnalysisShare(200, 10000);
+    r.shareOutOfGamut = AnalysisShare(100, 10000);
+    r.shareClipBlack = 0;
+    r.shareClipWhite = (uint16_t)n;
+    r.histogram[0] = 8000;
+    r.histogram[1] = 2000;
+    return r;
+}
+
+static const AnalysisRingHeader* Header(const std::vector<uint8_t>& ring) {
+    return reinterpret_cast<const AnalysisRingHeader*>(ring.data());
+}
+
+static const AnalysisRecord* Slot(const std::vector<uint8_t>& ring, uint32_t i) {
+    return reinterpret_cast<const AnalysisRecord*>(ring.data() + sizeof(AnalysisRingHeader)) + i;
+}
+
+static void AttachFormatsAndResumes() {
+    std::vector<uint8_t> ring(AnalysisRingBytes(16));
+    CHECK_EQ(ring.size(), 64u + 16 * 64);
+    CHECK(!AnalysisRingAttach(ring.data(), ring.size() - 1, 16));
+    CHECK(!AnalysisRingAttach(nullptr, ring.size(), 16));
+    CHECK(!AnalysisRingAttach(ring.data(), ring.size(), 0));
+
+    CHECK(AnalysisRingAttach(ring.data(), ring.size(), 16));
+    CHECK_EQ(Header(ring)->magic, ANALYSIS_RING_MAGIC);
+    CHECK_EQ(Header(ring)->capacity, 16u);
+    CHECK_EQ(Header(ring)->recordSize, (uint32_t)sizeof(AnalysisRecord));
+    for (int n = 0; n < 5; n++) AnalysisRingAppend(ring.data(), SampleRecord(n));
+
+    // Reattaching (app restart) keeps the series
+    CHECK(AnalysisRingAttach(ring.data(), ring.size(), 16));
+    CHECK_EQ(Header(ring)->writeCount, 5u);
+    CHECK_EQ(Slot(ring, 4)->peakNits, 140.0f);
+
+    // A different capacity or version starts over
+    std::vector<uint8_t> smaller(ring.begin(), ring.begin() + AnalysisRingBytes(8));
+    CHECK(AnalysisRingAttach(smaller.data(), smaller.size(), 8));
+    CHECK_EQ(Header(smaller)->writeCount, 0u);
+    CHECK_EQ(Slot(smaller, 0)->timestampMs, 0u);
+
+    reinterpret_cast<AnalysisRingHeader*>(ring.data())->version = ANALYSIS_RING_VERSION + 1;
+    CHECK(AnalysisRingAttach(ring.data(), ring.size(), 16));
+    CHECK_EQ(Header(ring)->version, ANALYSIS_RING_VERSION);
+    CHECK_EQ(Header(ring)->writeCount, 0u);
+}
+
+static void AppendWraps() {
+    std::vector<uint8_t> ring(AnalysisRingBytes(SAMPLE_CAPACITY));
+    CHECK(AnalysisRingAttach(ring.data(), ring.size(), SAMPLE_CAPACITY));
+    for (int n = 0; n < SAMPLE_RECORDS; n++) AnalysisRingAppend(ring.data(), SampleRecord(n));
+    CHECK_EQ(Header(ring)->writeCount, (uint64_t)SAMPLE_RECORDS);
+    // Record n in slot n % capacity: the oldest surviving one is 5, in slot 5; 12 overwrote 4
+    CHECK_EQ(Slot(ring, 5)->timestampMs, SampleRecord(5).timestampMs);
+    CHECK_EQ(Slot(ring, 4)->timestampMs, SampleRecord(12).timestampMs);
+    CHECK_EQ(Slot(ring, 0)->peakNits, SampleRecord(8).peakNits);
+}
+
+static void Shares() {
+    CHECK_EQ(AnalysisShare(0, 0), 0);
+    CHECK_EQ(AnalysisShare(1, 2), 5000);
+    CHECK_EQ(AnalysisShare(1, 3), 3333);
+    CHECK_EQ(AnalysisShare(2, 3), 6667);        // Rounded
+    CHECK_EQ(AnalysisShare(5, 4), 10000);       // Clamped
+    CHECK_EQ(AnalysisShare(1, 1000000), 0);
+    CHECK_EQ(AnalysisShare(100, 1000000), 1);
+}
+
+static int WriteSampleRing(const char* path) {
+    std::vector<uint8_t> ring(AnalysisRingBytes(SAMPLE_CAPACITY));
+    AnalysisRingAttach(ring.data(), ring.size(), SAMPLE_CAPACITY);
+    for (int n = 0; n < SAMPLE_RECORDS; n++) AnalysisRingAppend(ring.data(), SampleRecord(n));
+    FILE* f = fopen(path, "wb");
+    if (!f) return 1;
+    size_t written = fwrite(ring.data(), 1, ring.size(), f);
+    fclose(f);
+    return written == ring.size() ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && strcmp(argv[1], "--write") == 0) return WriteSampleRing(argv[2]);
+    RUN_TEST(AttachFormatsAndResumes);
+    RUN_TEST(AppendWraps);
+    RUN_TEST(Shares);
+    return CheckExitCode();
+}
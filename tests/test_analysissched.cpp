@@ -0,0 +1,204 @@
+// DesktopLUT - tests/test_analysissched.cpp
+// Analysis scheduling: per-adapter budget deferrals, round-robin fairness from the cursor,
+// over-budget dispatches granted alone, interval adaptation to content changes, activation
+
+#include "check.h"
+#include "analysissched.h"
+
+#include <cmath>
+#include <vector>
+
+// `count` active monitors due every pass, each with a timed cost
+static AnalysisScheduler Monitors(int count, float costMs, float budgetMs, int groups = 1) {
+    AnalysisScheduler s;
+    s.budgetMs = budgetMs;
+    for (int i = 0; i < count; i++) {
+        AnalysisSchedMonitor& m = AnalysisSchedSlot(s, i);
+        m.active = true;
+        m.interval = 1;
+        m.group = i % groups;
+        ReportAnalysisCost(s, i, costMs);
+    }
+    return s;
+}
+
+// Plan a pass and dispatch every grant; returns the granted indices
+static std::vector<int> Pass(AnalysisScheduler& s) {
+    PlanAnalysisPass(s);
+    std::vector<int> granted;
+    for (int i = 0; i < (int)s.monitors.size(); i++) {
+        if (!IsAnalysisGranted(s, i)) continue;
+        MarkAnalysisDispatched(s, i);
+        granted.push_back(i);
+    }
+    return granted;
+}
+
+// 4 x 0.2 ms against 0.5 ms: two per pass, the other two deferred
+static void BudgetDefers() {
+    AnalysisScheduler s = Monitors(4, 0.2f, 0.5f);
+    CHECK(Pass(s) == std::vector<int>({ 0, 1 }));
+    CHECK_EQ(s.monitors[2].deferrals, 1u);
+    CHECK_EQ(s.monitors[3].deferrals, 1u);
+    CHECK_EQ(s.monitors[0].deferrals, 0u);
+
+    int most = 0;
+    for (int p = 0; p < 99; p++) most = (std::max)(most, (int)Pass(s).size());
+    CHECK_EQ(most, 2);
+    CHECK_EQ(s.overBudget, 0u);
+
+    // No budget: everything due runs
+    s.budgetMs = 0.0f;
+    CHECK_EQ(PlanAnalysisPass(s), 4);
+}
+
+// The next pass starts at the first monitor left waiting, so deferred ones go first and every
+// monitor gets the same share
+static void CursorFairness() {
+    AnalysisScheduler s = Monitors(4, 0.2f, 0.5f);
+    CHECK(Pass(s) == std::vector<int>({ 0, 1 }));
+    CHECK_EQ(s.cursor, 2u);
+    CHECK(Pass(s) == std::vector<int>({ 2, 3 }));
+    CHECK_EQ(s.cursor, 0u);
+
+    // Three that fit two at a time rotate through all of them
+    AnalysisScheduler three = Monitors(3, 0.2f, 0.5f);
+    for (int p = 0; p < 300; p++) Pass(three);
+    for (const auto& m : three.monitors) CHECK_EQ(m.dispatches, 200u);
+
+    // A monitor granted but with no new frame keeps its turn without holding up the others
+    AnalysisScheduler idle = Monitors(2, 0.1f, 0.1f);
+    int busyRuns = 0;
+    for (int p = 0; p < 100; p++) {
+        PlanAnalysisPass(idle);
+        if (IsAnalysisGranted(idle, 1)) {
+            MarkAnalysisDispatched(idle, 1);
+            busyRuns++;
+        }
+    }
+    CHECK(busyRuns >= 50);
+    CHECK_EQ(idle.monitors[0].waited, idle.monitors[0].interval + 99);
+}
+
+// A dispatch costing more than the whole budget still runs, alone on its adapter
+static void OverBudgetAlone() {
+    AnalysisScheduler s = Monitors(3, 0.05f, 0.1f);
+    ReportAnalysisCost(s, 1, 20.0f);        // First report replaces, later ones smooth
+    CHECK_NEAR(s.monitors[1].costMs, 0.05 * 0.75 + 20.0 * 0.25, 1e-5);
+    s.monitors[1].costMs = 1.0f;
+
+    for (int p = 0; p < 90; p++) Pass(s);
+    for (const auto& m : s.monitors) CHECK(m.dispatches >= 30);
+    CHECK(s.overBudget >= 30);
+
+    // Never alongside another on the same adapter
+    AnalysisScheduler t = Monitors(3, 0.05f, 0.1f);
+    t.monitors[1].costMs = 1.0f;
+    int shared = 0;
+    for (int p = 0; p < 90; p++) {
+        std::vector<int> granted = Pass(t);
+        for (int i : granted) shared += i == 1 && granted.size() > 1;
+    }
+    CHECK_EQ(shared, 0);
+}
+
+// Budgets are per adapter
+static void AdaptersIndependent() {
+    AnalysisScheduler s = Monitors(4, 0.2f, 0.2f, 2);
+    CHECK_EQ(PlanAnalysisPass(s), 2);
+    CHECK(IsAnalysisGranted(s, 0));
+    CHECK(IsAnalysisGranted(s, 1));
+
+    // A higher group appearing later grows the per-adapter totals
+    AnalysisSchedSlot(s, 7).group = 5;
+    PlanAnalysisPass(s);
+    s.monitors[7].active = true;
+    CHECK(PlanAnalysisPass(s) >= 1);
+    CHECK(IsAnalysisGranted(s, 7));
+    CHECK(s.spent.size() >= 6u);
+}
+
+// Monitors only run once they've waited their interval
+static void Interval() {
+    AnalysisScheduler s = Monitors(1, 0.1f, 0.5f);
+    s.monitors[0].interval = 3;
+    s.monitors[0].waited = 0;
+    int runs = 0;
+    for (int p = 0; p < 30; p++) runs += (int)Pass(s).size();
+    CHECK_EQ(runs, 10);
+}
+
+static void Adaptation() {
+    AnalysisScheduler s;
+    AnalysisSchedSlot(s, 0).active = true;
+    AnalysisSignature sig;
+    sig.avgNits = 100.0f;
+    sig.peakNits = 400.0f;
+
+    ReportAnalysisResult(s, 0, sig);            // Nothing to compare with yet
+    CHECK_EQ(s.monitors[0].interval, ANALYSIS_INTERVAL_START);
+    ReportAnalysisResult(s, 0, sig);
+    CHECK_EQ(s.monitors[0].interval, ANALYSIS_INTERVAL_START + ANALYSIS_INTERVAL_START / 4);
+
+    // Static content lengthens to the maximum
+    for (int i = 0; i < 30; i++) ReportAnalysisResult(s, 0, sig);
+    CHECK_EQ(s.monitors[0].interval, ANALYSIS_INTERVAL_MAX);
+
+    // Below the threshold still counts as static
+    sig.avgNits = 104.0f;
+    ReportAnalysisResult(s, 0, sig);
+    CHECK_EQ(s.monitors[0].interval, ANALYSIS_INTERVAL_MAX);
+
+    // A change cuts to a quarter, down to the minimum
+    sig.avgNits = 200.0f;
+    ReportAnalysisResult(s, 0, sig);
+    CHECK_EQ(s.monitors[0].interval, ANALYSIS_INTERVAL_MAX / 4);
+    for (int i = 0; i < 5; i++) {
+        sig.wideShare = sig.wideShare > 0.0f ? 0.0f : 0.2f;     // Gamut share alone moves it
+        ReportAnalysisResult(s, 0, sig);
+    }
+    CHECK_EQ(s.monitors[0].interval, ANALYSIS_INTERVAL_MIN);
+
+    // Near-black noise is measured against 1 nit, not against itself
+    AnalysisScheduler dark;
+    AnalysisSchedSlot(dark, 0).active = true;
+    AnalysisSignature black;
+    black.avgNits = 0.01f;
+    ReportAnalysisResult(dark, 0, black);
+    black.avgNits = 0.03f;
+    ReportAnalysisResult(dark, 0, black);
+    CHECK(dark.monitors[0].interval > ANALYSIS_INTERVAL_START);
+}
+
+static void Activation() {
+    AnalysisScheduler s;
+    AnalysisSchedSlot(s, 2);
+    CHECK_EQ(s.monitors.size(), 3u);
+    CHECK_EQ(PlanAnalysisPass(s), 0);           // Inactive slots are never granted
+    s.monitors[2].active = true;
+    CHECK_EQ(PlanAnalysisPass(s), 1);           // Due the moment it's enabled
+    CHECK(IsAnalysisGranted(s, 2));
+
+    // Out-of-range indices are ignored
+    CHECK(!IsAnalysisGranted(s, 9));
+    CHECK(!IsAnalysisGranted(s, -1));
+    MarkAnalysisDispatched(s, 9);
+    ReportAnalysisCost(s, -1, 1.0f);
+    ReportAnalysisCost(s, 2, std::nanf(""));
+    CHECK_EQ(s.monitors[2].costMs, 0.0f);
+    ReportAnalysisResult(s, 9, AnalysisSignature());
+
+    AnalysisScheduler empty;
+    CHECK_EQ(PlanAnalysisPass(empty), 0);
+}
+
+int main() {
+    RUN_TEST(BudgetDefers);
+    RUN_TEST(CursorFairness);
+    RUN_TEST(OverBudgetAlone);
+    RUN_TEST(AdaptersIndependent);
+    RUN_TEST(Interval);
+    RUN_TEST(Adaptation);
+    RUN_TEST(Activation);
+    return CheckExitCode();
+}
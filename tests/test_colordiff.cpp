@@ -0,0 +1,238 @@
+// DesktopLUT - tests/test_colordiff.cpp
+// Color difference: CIEDE2000 against the Sharma, Wu and Dalal test data and a double-precision
+// reference, Delta E 76 and ITP against their formulas, batch tails, the conversions into
+// CIELAB / ICtCp, summaries
+
+#include "check.h"
+#include "colordiff.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// G. Sharma, W. Wu, E. N. Dalal, "The CIEDE2000 color-difference formula: implementation notes,
+// supplementary test data, and mathematical observations" (2005): L1 a1 b1, L2 a2 b2, Delta E 00
+static const double SHARMA[34][7] = {
+    { 50.0000, 2.6772, -79.7751, 50.0000, 0.0000, -82.7485, 2.0425 },
+    { 50.0000, 3.1571, -77.2803, 50.0000, 0.0000, -82.7485, 2.8615 },
+    { 50.0000, 2.8361, -74.0200, 50.0000, 0.0000, -82.7485, 3.4412 },
+    { 50.0000, -1.3802, -84.2814, 50.0000, 0.0000, -82.7485, 1.0000 },
+    { 50.0000, -1.1848, -84.8006, 50.0000, 0.0000, -82.7485, 1.0000 },
+    { 50.0000, -0.9009, -85.5211, 50.0000, 0.0000, -82.7485, 1.0000 },
+    { 50.0000, 0.0000, 0.0000, 50.0000, -1.0000, 2.0000, 2.3669 },
+    { 50.0000, -1.0000, 2.0000, 50.0000, 0.0000, 0.0000, 2.3669 },
+    { 50.0000, 2.4900, -0.0010, 50.0000, -2.4900, 0.0009, 7.1792 },
+    { 50.0000, 2.4900, -0.0010, 50.0000, -2.4900, 0.0010, 7.1792 },
+    { 50.0000, 2.4900, -0.0010, 50.0000, -2.4900, 0.0011, 7.2195 },
+    { 50.0000, 2.4900, -0.0010, 50.0000, -2.4900, 0.0012, 7.2195 },
+    { 50.0000, -0.0010, 2.4900, 50.0000, 0.0009, -2.4900, 4.8045 },
+    { 50.0000, -0.0010, 2.4900, 50.0000, 0.0010, -2.4900, 4.8045 },
+    { 50.0000, -0.0010, 2.4900, 50.0000, 0.0011, -2.4900, 4.7461 },
+    { 50.0000, 2.5000, 0.0000, 50.0000, 0.0000, -2.5000, 4.3065 },
+    { 50.0000, 2.5000, 0.0000, 73.0000, 25.0000, -18.0000, 27.1492 },
+    { 50.0000, 2.5000, 0.0000, 61.0000, -5.0000, 29.0000, 22.8977 },
+    { 50.0000, 2.5000, 0.0000, 56.0000, -27.0000, -3.0000, 31.9030 },
+    { 50.0000, 2.5000, 0.0000, 58.0000, 24.0000, 15.0000, 19.4535 },
+    { 50.0000, 2.5000, 0.0000, 50.0000, 3.1736, 0.5854, 1.0000 },
+    { 50.0000, 2.5000, 0.0000, 50.0000, 3.2972, 0.0000, 1.0000 },
+    { 50.0000, 2.5000, 0.0000, 50.0000, 1.8634, 0.5757, 1.0000 },
+    { 50.0000, 2.5000, 0.0000, 50.0000, 3.2592, 0.3350, 1.0000 },
+    { 60.2574, -34.0099, 36.2677, 60.4626, -34.1751, 39.4387, 1.2644 },
+    { 63.0109, -31.0961, -5.8663, 62.8187, -29.7946, -4.0864, 1.2630 },
+    { 61.2901, 3.7196, -5.3901, 61.4292, 2.2480, -4.9620, 1.8731 },
+    { 35.0831, -44.1164, 3.7933, 35.0232, -40.0716, 1.5901, 1.8645 },
+    { 22.7233, 20.0904, -46.6940, 23.0331, 14.9730, -42.5619, 2.0373 },
+    { 36.4612, 47.8580, 18.3852, 36.2715, 50.5065, 21.2231, 1.4146 },
+    { 90.8027, -2.0831, 1.4410, 91.1528, -1.6435, 0.0447, 1.4441 },
+    { 90.9257, -0.5406, -0.9208, 88.6381, -0.8985, -0.7239, 1.5381 },
+    { 6.7747, -0.2908, -2.4247, 5.8714, -0.0985, -2.2286, 0.6377 },
+    { 2.0776, 0.0795, -1.1350, 0.9033, -0.0636, -0.5514, 0.9082 },
+};
+
+// CIEDE2000 as written in the paper, in double precision with the usual trigonometry
+static double ReferenceDeltaE2000(double L1, double a1, double b1, double L2, double a2, double b2) {
+    const double pi = 3.14159265358979323846, rad = pi / 180.0;
+    double C1 = std::hypot(a1, b1), C2 = std::hypot(a2, b2);
+    double Cbar7 = std::pow((C1 + C2) / 2.0, 7.0);
+    double G = 0.5 * (1.0 - std::sqrt(Cbar7 / (Cbar7 + std::pow(25.0, 7.0))));
+    double a1p = (1.0 + G) * a1, a2p = (1.0 + G) * a2;
+    double C1p = std::hypot(a1p, b1), C2p = std::hypot(a2p, b2);
+    auto hue = [&](double b, double a) {
+        if (a == 0.0 && b == 0.0) return 0.0;
+        double h = std::atan2(b, a) / rad;
+        return h < 0.0 ? h + 360.0 : h;
+    };
+    double h1 = hue(b1, a1p), h2 = hue(b2, a2p);
+
+    double dL = L2 - L1, dC = C2p - C1p, dh = 0.0;
+    if (C1p * C2p != 0.0) {
+        dh = h2 - h1;
+        if (dh > 180.0) dh -= 360.0;
+        else if (dh < -180.0) dh += 360.0;
+    }
+    double dH = 2.0 * std::sqrt(C1p * C2p) * std::sin(dh * rad / 2.0);
+
+    double Lbar = (L1 + L2) / 2.0, Cbarp = (C1p + C2p) / 2.0, hbar;
+    if (C1p * C2p == 0.0) hbar = h1 + h2;
+    else if (std::fabs(h1 - h2) <= 180.0) hbar = (h1 + h2) / 2.0;
+    else if (h1 + h2 < 360.0) hbar = (h1 + h2 + 360.0) / 2.0;
+    else hbar = (h1 + h2 - 360.0) / 2.0;
+    double T = 1.0 - 0.17 * std::cos((hbar - 30.0) * rad) + 0.24 * std::cos(2.0 * hbar * rad) +
+               0.32 * std::cos((3.0 * hbar + 6.0) * rad) - 0.20 * std::cos((4.0 * hbar - 63.0) * rad);
+    double dTheta = 30.0 * std::exp(-std::pow((hbar - 275.0) / 25.0, 2.0));
+    double Cbarp7 = std::pow(Cbarp, 7.0);
+    double RC = 2.0 * std::sqrt(Cbarp7 / (Cbarp7 + std::pow(25.0, 7.0)));
+    double SL = 1.0 + 0.015 * (Lbar - 50.0) * (Lbar - 50.0) / std::sqrt(20.0 + (Lbar - 50.0) * (Lbar - 50.0));
+    double SC = 1.0 + 0.045 * Cbarp, SH = 1.0 + 0.015 * Cbarp * T;
+    double RT = -std::sin(2.0 * dTheta * rad) * RC;
+    return std::sqrt(std::pow(dL / SL, 2.0) + std::pow(dC / SC, 2.0) + std::pow(dH / SH, 2.0) +
+                     RT * (dC / SC) * (dH / SH));
+}
+
+// Pairs as two SoA batches
+struct Pairs {
+    std::vector<float> a[3], b[3];
+    void Add(double L1, double a1, double b1, double L2, double a2, double b2) {
+        a[0].push_back((float)L1); a[1].push_back((float)a1); a[2].push_back((float)b1);
+        b[0].push_back((float)L2); b[1].push_back((float)a2); b[2].push_back((float)b2);
+    }
+    size_t Count() const { return a[0].size(); }
+    ColorBatch A() const { return { a[0].data(), a[1].data(), a[2].data() }; }
+    ColorBatch B() const { return { b[0].data(), b[1].data(), b[2].data() }; }
+};
+
+static void SharmaData() {
+    Pairs pairs;
+    for (const auto& row : SHARMA) pairs.Add(row[0], row[1], row[2], row[3], row[4], row[5]);
+    std::vector<float> out(pairs.Count());
+    DeltaE2000(pairs.A(), pairs.B(), pairs.Count(), out.data());
+    for (size_t i = 0; i < pairs.Count(); i++) {
+        CHECK_NEAR(out[i], SHARMA[i][6], 1e-4);
+        // The reference reproduces the published values, so it can judge the random pairs below
+        CHECK_NEAR(ReferenceDeltaE2000(SHARMA[i][0], SHARMA[i][1], SHARMA[i][2], SHARMA[i][3], SHARMA[i][4],
+                                       SHARMA[i][5]), SHARMA[i][6], 5e-5);
+    }
+
+    // Symmetric in its arguments
+    std::vector<float> swapped(pairs.Count());
+    DeltaE2000(pairs.B(), pairs.A(), pairs.Count(), swapped.data());
+    for (size_t i = 0; i < pairs.Count(); i++) CHECK_NEAR(swapped[i], out[i], 1e-4);
+}
+
+// Random pairs, including near neighbours, nearly opposite hues and neutrals, against the
+// reference. Exactly opposite hues are left out: the mean hue jumps by 180 degrees there, so
+// float rounding alone picks the branch.
+static void RandomAgainstReference() {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> chroma(-128.0f, 128.0f), lightness(0.0f, 100.0f);
+    Pairs pairs;
+    for (int i = 0; i < 20000; i++) {
+        float a1 = chroma(rng), b1 = chroma(rng), a2 = chroma(rng), b2 = chroma(rng);
+        switch (i % 4) {
+        case 1: a2 = a1 * 1.01f + 0.3f; b2 = b1 * 0.99f; break;     // Close
+        case 2:                                                     // Nearly opposite hue
+            a2 = -a1 * 0.9994f + b1 * 0.0349f;
+            b2 = -b1 * 0.9994f - a1 * 0.0349f;
+            break;
+        case 3: a1 = 0.0f; b1 = 0.0f; break;                        // Neutral
+        }
+        pairs.Add(lightness(rng), a1, b1, lightness(rng), a2, b2);
+    }
+    std::vector<float> out(pairs.Count());
+    DeltaE2000(pairs.A(), pairs.B(), pairs.Count(), out.data());
+    int outside = 0;
+    for (size_t i = 0; i < pairs.Count(); i++) {
+        double ref = ReferenceDeltaE2000(pairs.a[0][i], pairs.a[1][i], pairs.a[2][i], pairs.b[0][i], pairs.b[1][i],
+                                         pairs.b[2][i]);
+        if (std::fabs(out[i] - ref) > 1e-4 * (std::max)(1.0, ref)) outside++;
+    }
+    CHECK_EQ(outside, 0);
+}
+
+static void DeltaE76AndITP() {
+    Pairs pairs;
+    pairs.Add(50.0, 0.0, 0.0, 50.0, 3.0, 4.0);
+    pairs.Add(20.0, -10.0, 5.0, 30.0, -10.0, 5.0);
+    pairs.Add(0.1, 0.02, -0.01, 0.1, 0.02, -0.01);
+    std::vector<float> out(3);
+    DeltaE76(pairs.A(), pairs.B(), 3, out.data());
+    CHECK_NEAR(out[0], 5.0, 1e-5);
+    CHECK_NEAR(out[1], 10.0, 1e-5);
+    CHECK_EQ(out[2], 0.0f);
+
+    // ITP reads the pairs as I, Ct, Cp: 720 * sqrt(dI^2 + (dCt / 2)^2 + dCp^2)
+    DeltaEITP(pairs.A(), pairs.B(), 3, out.data());
+    CHECK_NEAR(out[0], 720.0 * std::sqrt(1.5 * 1.5 + 16.0), 1e-2);
+    CHECK_NEAR(out[1], 7200.0, 1e-2);
+    CHECK_EQ(out[2], 0.0f);
+}
+
+// Counts that aren't a multiple of the vector width give the same values as a full batch, and
+// nothing past `count` is written
+static void BatchTails() {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> u(-60.0f, 60.0f);
+    Pairs pairs;
+    for (int i = 0; i < 11; i++) pairs.Add(u(rng) + 50.0f, u(rng), u(rng), u(rng) + 50.0f, u(rng), u(rng));
+    std::vector<float> full(11);
+    DeltaE2000(pairs.A(), pairs.B(), 11, full.data());
+    int wrong = 0;
+    for (size_t count = 0; count <= 11; count++) {
+        std::vector<float> out(12, -1.0f);
+        DeltaE2000(pairs.A(), pairs.B(), count, out.data());
+        for (size_t i = 0; i < count; i++) wrong += out[i] != full[i];
+        for (size_t i = count; i < out.size(); i++) wrong += out[i] != -1.0f;
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+static void Summary() {
+    const float values[] = { 0.5f, 2.0f, 1.5f, 0.0f };
+    DeltaEStats s = SummarizeDeltaE(values, 4);
+    CHECK_EQ(s.count, 4u);
+    CHECK_EQ(s.max, 2.0f);
+    CHECK_NEAR(s.mean, 1.0, 1e-6);
+    s = SummarizeDeltaE(values, 0);
+    CHECK_EQ(s.count, 0u);
+    CHECK_EQ(s.max, 0.0f);
+    CHECK_EQ(s.mean, 0.0f);
+}
+
+static void Conversions() {
+    // Gamma 2.2 display RGB: white, black, mid gray and a primary
+    float r[] = { 1.0f, 0.0f, 0.5f, 1.0f }, g[] = { 1.0f, 0.0f, 0.5f, 0.0f }, b[] = { 1.0f, 0.0f, 0.5f, 0.0f };
+    float L[4], A[4], B[4];
+    DisplayRGBToLab({ r, g, b }, 4, L, A, B);
+    CHECK_NEAR(L[0], 100.0, 1e-3);
+    CHECK_NEAR(A[0], 0.0, 1e-3);
+    CHECK_NEAR(B[0], 0.0, 1e-3);
+    CHECK_NEAR(L[1], 0.0, 1e-4);
+    CHECK_NEAR(L[2], 116.0 * std::cbrt(std::pow(0.5, 2.2)) - 16.0, 1e-3);
+    CHECK_NEAR(A[2], 0.0, 1e-3);
+    CHECK_NEAR(L[3], 53.24, 0.02);          // BT.709 red
+    CHECK_NEAR(A[3], 80.09, 0.05);
+    CHECK_NEAR(B[3], 67.20, 0.05);
+
+    // PQ: black and neutrals have no chroma, I rises with the signal
+    float pq[] = { 0.0f, 0.5081f, 0.7518f, 1.0f };
+    float I[4], Ct[4], Cp[4];
+    PQRGBToICtCp({ pq, pq, pq }, 4, I, Ct, Cp);
+    for (int i = 0; i < 4; i++) {
+        CHECK_NEAR(Ct[i], 0.0, 1e-4);
+        CHECK_NEAR(Cp[i], 0.0, 1e-4);
+    }
+    CHECK(I[0] < 1e-3f);
+    CHECK(I[1] < I[2] && I[2] < I[3]);
+    CHECK_NEAR(I[3], 1.0, 2e-3);            // 10000 nits
+}
+
+int main() {
+    RUN_TEST(SharmaData);
+    RUN_TEST(RandomAgainstReference);
+    RUN_TEST(DeltaE76AndITP);
+    RUN_TEST(BatchTails);
+    RUN_TEST(Summary);
+    RUN_TEST(Conversions);
+    return CheckExitCode();
+}
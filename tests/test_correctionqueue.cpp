@@ -0,0 +1,163 @@
+// DesktopLUT - tests/test_correctionqueue.cpp
+// Color correction compiler bookkeeping: submissions coalesce, stale results never replace newer ones
+
+#include "check.h"
+#include "correctionqueue.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static void SubmissionsCoalesce() {
+    CorrectionQueue q;
+    int a = CorrectionQueueSubmit(q, 0, false);
+    CHECK_EQ(CorrectionQueueSubmit(q, 0, false), a);
+    CHECK_EQ(CorrectionQueueSubmit(q, 0, false), a);
+    CHECK_EQ(q.coalesced, 2u);
+
+    // Three submissions, one compile of the newest
+    CHECK_EQ(CorrectionQueueTake(q), a);
+    CHECK_EQ(q.slots[a].version, 3u);
+    CHECK_EQ(CorrectionQueueTake(q), -1);
+}
+
+static void SlotsPerMonitorAndMode() {
+    CorrectionQueue q;
+    int sdr0 = CorrectionQueueSubmit(q, 0, false);
+    int hdr0 = CorrectionQueueSubmit(q, 0, true);
+    int sdr1 = CorrectionQueueSubmit(q, 1, false);
+    CHECK(sdr0 != hdr0 && hdr0 != sdr1 && sdr0 != sdr1);
+    CHECK_EQ(q.coalesced, 0u);
+
+    // Resubmitting the first moves it behind the others (oldest pending submission first)
+    CorrectionQueueSubmit(q, 0, false);
+    CHECK_EQ(CorrectionQueueTake(q), hdr0);
+    CHECK_EQ(CorrectionQueueTake(q), sdr1);
+    CHECK_EQ(CorrectionQueueTake(q), sdr0);
+    CHECK_EQ(CorrectionQueueTake(q), -1);
+
+    // Reset drops slots but versions keep increasing
+    uint64_t last = q.lastVersion;
+    CorrectionQueueReset(q);
+    CHECK(q.slots.empty());
+    int again = CorrectionQueueSubmit(q, 0, false);
+    CHECK(q.slots[again].version > last);
+}
+
+static void ResultSupersededWhileCompiling() {
+    CorrectionQueue q;
+    int slot = CorrectionQueueSubmit(q, 2, true);
+    CHECK_EQ(CorrectionQueueTake(q), slot);
+    uint64_t compiling = q.slots[slot].version;
+
+    // Nothing newer yet: publish
+    CHECK(!CorrectionQueueSuperseded(q, slot, compiling));
+
+    // The user moves a slider while the compile runs: the old result is dropped, the new one compiled
+    CorrectionQueueSubmit(q, 2, true);
+    CHECK(CorrectionQueueSuperseded(q, slot, compiling));
+    CHECK_EQ(q.superseded, 1u);
+    CHECK_EQ(CorrectionQueueTake(q), slot);
+    CHECK(!CorrectionQueueSuperseded(q, slot, q.slots[slot].version));
+
+    // A slot that vanished (queue reset mid-compile) never publishes
+    CorrectionQueueReset(q);
+    CHECK(CorrectionQueueSuperseded(q, slot, compiling));
+}
+
+static void StaleResultAfterNewerIsRejected() {
+    CorrectionPublished p;
+    CHECK(AcceptCorrectionResult(p, 0, false, 5));
+    CHECK(AcceptCorrectionResult(p, 0, true, 3));       // Other mode: independent
+    CHECK(AcceptCorrectionResult(p, 1, false, 4));      // Other monitor: independent
+
+    // The render thread has drained version 5 from the mailbox; version 4 arriving late must not land
+    CHECK(!AcceptCorrectionResult(p, 0, false, 4));
+    CHECK(!AcceptCorrectionResult(p, 0, false, 5));     // Nor a duplicate
+    CHECK_EQ(p.rejected, 2u);
+    CHECK(AcceptCorrectionResult(p, 0, false, 6));
+}
+
+// The compiler's threading: a GUI thread submitting bursts, one worker compiling slowly. Every
+// published version must be newer than the last for its key, the final one must be the last
+// submission, and bursts must coalesce into far fewer compiles.
+static void BurstsCoalesceUnderLoad() {
+    std::mutex slotMutex, mailboxMutex;
+    std::condition_variable cv;
+    CorrectionQueue q;
+    CorrectionPublished published;
+    bool running = true;
+    int compiles = 0;
+    uint64_t lastPublished[2] = { 0, 0 };
+    bool ordered = true;
+
+    std::thread worker([&] {
+        std::unique_lock<std::mutex> lock(slotMutex);
+        while (true) {
+            int slot = -1;
+            cv.wait(lock, [&] { return !running || (slot = CorrectionQueueTake(q)) >= 0; });
+            if (!running) break;
+            int monitor = q.slots[slot].monitorIndex;
+            bool isHDR = q.slots[slot].isHDR;
+            uint64_t version = q.slots[slot].version;
+
+            lock.unlock();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));   // The compile
+            lock.lock();
+            compiles++;
+            if (CorrectionQueueSuperseded(q, slot, version)) continue;
+
+            std::lock_guard<std::mutex> mailbox(mailboxMutex);
+            if (AcceptCorrectionResult(published, monitor, isHDR, version)) {
+                if (version <= lastPublished[isHDR]) ordered = false;
+                lastPublished[isHDR] = version;
+            }
+        }
+    });
+
+    const int SUBMISSIONS = 2000;
+    uint64_t lastSubmitted[2] = { 0, 0 };
+    for (int i = 0; i < SUBMISSIONS; i++) {
+        {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            bool isHDR = (i % 3) == 0;
+            int slot = CorrectionQueueSubmit(q, 0, isHDR);
+            lastSubmitted[isHDR] = q.slots[slot].version;
+        }
+        cv.notify_one();
+        if (i % 100 == 99) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Let the worker drain, then stop it
+    for (int wait = 0; wait < 2000; wait++) {
+        {
+            std::lock_guard<std::mutex> lock(slotMutex);
+            std::lock_guard<std::mutex> mailbox(mailboxMutex);
+            if (lastPublished[0] == lastSubmitted[0] && lastPublished[1] == lastSubmitted[1]) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    {
+        std::lock_guard<std::mutex> lock(slotMutex);
+        running = false;
+    }
+    cv.notify_one();
+    worker.join();
+
+    CHECK(ordered);
+    CHECK_EQ(lastPublished[0], lastSubmitted[0]);
+    CHECK_EQ(lastPublished[1], lastSubmitted[1]);
+    CHECK(compiles < SUBMISSIONS / 2);
+    CHECK_EQ(q.submitted, (uint64_t)SUBMISSIONS);
+}
+
+int main() {
+    RUN_TEST(SubmissionsCoalesce);
+    RUN_TEST(SlotsPerMonitorAndMode);
+    RUN_TEST(ResultSupersededWhileCompiling);
+    RUN_TEST(StaleResultAfterNewerIsRejected);
+    RUN_TEST(BurstsCoalesceUnderLoad);
+    return CheckExitCode();
+}
@@ -0,0 +1,128 @@
+// DesktopLUT - tests/test_devicegroup.cpp
+// Grouping monitors onto per-adapter devices by LUID
+
+#include "check.h"
+#include "devicegroup.h"
+
+#include <vector>
+
+// Stand-ins for HMONITOR values
+static const void* Monitor(int n) {
+    static char monitors[16];
+    return &monitors[n];
+}
+
+static AdapterTopology Adapter(uint32_t low, int32_t high, std::vector<const void*> outputs, bool software = false) {
+    AdapterTopology a;
+    a.id.lowPart = low;
+    a.id.highPart = high;
+    a.software = software;
+    a.outputs = std::move(outputs);
+    return a;
+}
+
+static void SingleAdapter() {
+    std::vector<AdapterTopology> adapters = { Adapter(0x1000, 0, { Monitor(0), Monitor(1), Monitor(2) }) };
+    DeviceGroupPlan plan;
+    CHECK(PlanDeviceGroups(adapters, { Monitor(2), Monitor(0), Monitor(1) }, plan));
+    CHECK_EQ(plan.groupAdapter.size(), 1u);
+    CHECK_EQ(plan.groupAdapter[0], 0);
+    for (int m = 0; m < 3; m++) {
+        CHECK_EQ(plan.monitorGroup[m], 0);
+        CHECK(!plan.monitorFallback[m]);
+    }
+}
+
+static void TwoAdaptersGroupInFirstUseOrder() {
+    // iGPU enumerated first but the first monitor is on the dGPU
+    std::vector<AdapterTopology> adapters = {
+        Adapter(0x1000, 0, { Monitor(2) }),
+        Adapter(0x2000, 0, { Monitor(0), Monitor(1) }),
+    };
+    DeviceGroupPlan plan;
+    CHECK(PlanDeviceGroups(adapters, { Monitor(0), Monitor(1), Monitor(2) }, plan));
+    CHECK_EQ(plan.groupAdapter.size(), 2u);
+    CHECK_EQ(plan.groupAdapter[0], 1);      // dGPU: first used
+    CHECK_EQ(plan.groupAdapter[1], 0);
+    CHECK_EQ(plan.monitorGroup[0], 0);
+    CHECK_EQ(plan.monitorGroup[1], 0);
+    CHECK_EQ(plan.monitorGroup[2], 1);
+}
+
+static void DuplicateLuidCollapses() {
+    // The same GPU listed twice (e.g. once per DXGI factory pass); outputs reported on the second listing
+    std::vector<AdapterTopology> adapters = {
+        Adapter(0x1000, 1, { Monitor(0) }),
+        Adapter(0x2000, 0, { Monitor(1) }),
+        Adapter(0x1000, 1, { Monitor(2) }),
+    };
+    DeviceGroupPlan plan;
+    CHECK(PlanDeviceGroups(adapters, { Monitor(0), Monitor(1), Monitor(2) }, plan));
+    CHECK_EQ(plan.groupAdapter.size(), 2u);
+    CHECK_EQ(plan.monitorGroup[0], plan.monitorGroup[2]);
+    CHECK_EQ(plan.groupAdapter[plan.monitorGroup[2]], 0);   // Earliest listing
+    CHECK(plan.monitorGroup[1] != plan.monitorGroup[0]);
+}
+
+static void HighPartDistinguishesLuids() {
+    std::vector<AdapterTopology> adapters = {
+        Adapter(0x1000, 0, { Monitor(0) }),
+        Adapter(0x1000, 1, { Monitor(1) }),
+    };
+    DeviceGroupPlan plan;
+    CHECK(PlanDeviceGroups(adapters, { Monitor(0), Monitor(1) }, plan));
+    CHECK_EQ(plan.groupAdapter.size(), 2u);
+    CHECK(plan.monitorGroup[0] != plan.monitorGroup[1]);
+}
+
+static void IdleAdaptersGetNoGroup() {
+    std::vector<AdapterTopology> adapters = {
+        Adapter(0x1000, 0, {}),
+        Adapter(0x2000, 0, { Monitor(0) }),
+        Adapter(0x3000, 0, {}),
+    };
+    DeviceGroupPlan plan;
+    CHECK(PlanDeviceGroups(adapters, { Monitor(0) }, plan));
+    CHECK_EQ(plan.groupAdapter.size(), 1u);
+    CHECK_EQ(plan.groupAdapter[0], 1);
+}
+
+static void UnclaimedMonitorFallsBackToHardware() {
+    // Basic Render Driver first, then a GPU; a monitor no adapter reports (e.g. mid hot-plug)
+    std::vector<AdapterTopology> adapters = {
+        Adapter(0x0001, 0, {}, true),
+        Adapter(0x2000, 0, { Monitor(0) }),
+    };
+    DeviceGroupPlan plan;
+    CHECK(PlanDeviceGroups(adapters, { Monitor(5), Monitor(0) }, plan));
+    CHECK(plan.monitorFallback[0]);
+    CHECK(!plan.monitorFallback[1]);
+    CHECK_EQ(plan.groupAdapter.size(), 1u);           // Fallback shares the GPU's group
+    CHECK_EQ(plan.groupAdapter[0], 1);
+    CHECK_EQ(plan.monitorGroup[0], plan.monitorGroup[1]);
+
+    // Software only: the first adapter it is
+    std::vector<AdapterTopology> warp = { Adapter(0x0001, 0, {}, true) };
+    CHECK(PlanDeviceGroups(warp, { Monitor(3) }, plan));
+    CHECK_EQ(plan.groupAdapter[0], 0);
+    CHECK(plan.monitorFallback[0]);
+}
+
+static void NoAdapters() {
+    DeviceGroupPlan plan;
+    plan.groupAdapter = { 7 };
+    CHECK(!PlanDeviceGroups({}, { Monitor(0) }, plan));
+    CHECK(plan.groupAdapter.empty());
+    CHECK_EQ(plan.monitorGroup[0], -1);
+}
+
+int main() {
+    RUN_TEST(SingleAdapter);
+    RUN_TEST(TwoAdaptersGroupInFirstUseOrder);
+    RUN_TEST(DuplicateLuidCollapses);
+    RUN_TEST(HighPartDistinguishesLuids);
+    RUN_TEST(IdleAdaptersGetNoGroup);
+    RUN_TEST(UnclaimedMonitorFallsBackToHardware);
+    RUN_TEST(NoAdapters);
+    return CheckExitCode();
+}
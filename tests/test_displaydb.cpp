@@ -0,0 +1,247 @@
+// DesktopLUT - tests/test_displaydb.cpp
+// Display identity database: EDID hashing, the text file, device path index, settings section plans
+
+#include "check.h"
+#include "displaydb.h"
+
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+static std::vector<uint8_t> MakeEdid(uint8_t serial) {
+    static const uint8_t header[8] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+    std::vector<uint8_t> edid(128, 0);
+    memcpy(edid.data(), header, 8);
+    edid[8] = 0x10;
+    edid[9] = 0xAC;     // Manufacturer DEL
+    edid[12] = serial;
+    for (int i = 25; i < 35; i++) edid[i] = (uint8_t)(0x40 + i);
+    return edid;
+}
+
+static DisplayRecord MakeRecord(uint64_t hash, const char* devicePath, bool primaries) {
+    DisplayRecord r;
+    r.edidHash = hash;
+    r.name = "DELL U2723QE";
+    r.devicePath = devicePath;
+    if (primaries) {
+        const float p[8] = { 0.680f, 0.320f, 0.265f, 0.690f, 0.150f, 0.060f, 0.3127f, 0.3290f };
+        memcpy(r.primaries, p, sizeof(p));
+        r.primariesValid = ComputeRgbToXYZ(r.primaries, r.rgbToXYZ);
+    }
+    r.minLuminance = 0.05f;
+    r.maxLuminance = 603.7f;
+    r.maxFullFrameLuminance = 401.25f;
+    r.hdrCapable = true;
+    r.refreshMilliHz = 59940;
+    r.lastIndex = 1;
+    return r;
+}
+
+static bool SameRecord(const DisplayRecord& a, const DisplayRecord& b) {
+    return a.edidHash == b.edidHash && a.name == b.name && a.devicePath == b.devicePath &&
+           a.primariesValid == b.primariesValid && memcmp(a.primaries, b.primaries, sizeof(a.primaries)) == 0 &&
+           memcmp(a.rgbToXYZ, b.rgbToXYZ, sizeof(a.rgbToXYZ)) == 0 && a.minLuminance == b.minLuminance &&
+           a.maxLuminance == b.maxLuminance && a.maxFullFrameLuminance == b.maxFullFrameLuminance &&
+           a.hdrCapable == b.hdrCapable && a.refreshMilliHz == b.refreshMilliHz && a.lastIndex == b.lastIndex;
+}
+
+// FNV-1a 64: the hash is persisted (database keys, INI section names), so it must never change
+static void EdidHashStable() {
+    const uint8_t a = 'a';
+    CHECK_EQ(HashEDID(nullptr, 0), 0xcbf29ce484222325ULL);
+    CHECK_EQ(HashEDID(&a, 1), 0xaf63dc4c8601ec8cULL);
+
+    std::vector<uint8_t> edid = MakeEdid(1);
+    uint64_t hash = HashEDID(edid.data(), edid.size());
+    CHECK(hash != 0);
+    CHECK_EQ(HashEDID(edid.data(), edid.size()), hash);
+    std::vector<uint8_t> copy = edid;
+    CHECK_EQ(HashEDID(copy.data(), copy.size()), hash);
+
+    // Same model, other serial; and an extension block: different displays
+    std::vector<uint8_t> other = MakeEdid(2);
+    CHECK(HashEDID(other.data(), other.size()) != hash);
+    std::vector<uint8_t> extended = edid;
+    extended.resize(256, 0x02);
+    CHECK(HashEDID(extended.data(), extended.size()) != hash);
+}
+
+static void RgbToXYZ() {
+    const float srgb[8] = { 0.64f, 0.33f, 0.30f, 0.60f, 0.15f, 0.06f, 0.3127f, 0.3290f };
+    float m[9];
+    CHECK(ComputeRgbToXYZ(srgb, m));
+    const float expected[9] = { 0.4124f, 0.3576f, 0.1805f, 0.2126f, 0.7152f, 0.0722f, 0.0193f, 0.1192f, 0.9505f };
+    for (int i = 0; i < 9; i++) CHECK_NEAR(m[i], expected[i], 2e-4);
+
+    const float degenerate[8] = { 0.64f, 0.33f, 0.64f, 0.33f, 0.15f, 0.06f, 0.3127f, 0.3290f };
+    CHECK(!ComputeRgbToXYZ(degenerate, m));
+    const float zeroY[8] = { 0.64f, 0.0f, 0.30f, 0.60f, 0.15f, 0.06f, 0.3127f, 0.3290f };
+    CHECK(!ComputeRgbToXYZ(zeroY, m));
+}
+
+static void SerializeRoundTrip() {
+    DisplayDatabase db;
+    UpdateDisplay(db, MakeRecord(0x0123456789abcdefULL, "\\\\?\\display#del4242#5&1a2b3c&0&uid4352#{e6f07b5f}", true));
+    DisplayRecord plain = MakeRecord(0xfedcba9876543210ULL, "", false);
+    plain.name = "Generic PnP Monitor";
+    plain.hdrCapable = false;
+    plain.lastIndex = -1;
+    UpdateDisplay(db, plain);
+    CHECK(db.dirty);
+
+    std::string text = SerializeDisplayDatabase(db);
+    DisplayDatabase parsed;
+    CHECK(ParseDisplayDatabase(text, parsed));
+    CHECK(!parsed.dirty);
+    CHECK_EQ(parsed.records.size(), 2u);
+    for (const auto& [hash, record] : db.records) {
+        const DisplayRecord* r = FindDisplay(parsed, hash);
+        CHECK(r != nullptr);
+        if (r) CHECK(SameRecord(*r, record));
+    }
+
+    // Device path index rebuilt; records without a path aren't indexed
+    CHECK_EQ(FindDisplayByDevicePath(parsed, "\\\\?\\display#del4242#5&1a2b3c&0&uid4352#{e6f07b5f}"),
+             0x0123456789abcdefULL);
+    CHECK_EQ(parsed.byDevicePath.size(), 1u);
+
+    // Deterministic: serializing the parsed copy gives the same text
+    CHECK(SerializeDisplayDatabase(parsed) == text);
+
+    // Through the file (temp + rename)
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "desktoplut_test_displays.db";
+    CHECK(SaveDisplayDatabase(path.wstring(), db));
+    CHECK(!db.dirty);
+    DisplayDatabase loaded;
+    CHECK(LoadDisplayDatabase(path.wstring(), loaded));
+    CHECK_EQ(loaded.records.size(), 2u);
+    std::filesystem::remove(path);
+
+    // A missing file is a first run
+    CHECK(LoadDisplayDatabase(path.wstring(), loaded));
+    CHECK(loaded.records.empty());
+}
+
+static void MalformedInput() {
+    DisplayDatabase db;
+    UpdateDisplay(db, MakeRecord(0x42, "path", true));
+
+    // No header, or a version from a newer build: rejected, contents cleared
+    CHECK(!ParseDisplayDatabase("", db));
+    CHECK(db.records.empty());
+    CHECK(!ParseDisplayDatabase("[0000000000000042]\nName=x\n", db));
+    CHECK(!ParseDisplayDatabase("# DesktopLUT display database v99\n", db));
+    CHECK(ParseDisplayDatabase("# DesktopLUT display database v1\n", db));
+    CHECK(db.records.empty());
+
+    // Bad lines are skipped, the rest is kept
+    const char* text =
+        "# DesktopLUT display database v1\r\n"
+        "Name=before any section\r\n"
+        "[0000000000000000]\r\n"            // Hash 0 is reserved
+        "Name=zero\r\n"
+        "[12345]\r\n"                       // Too short
+        "Name=short\r\n"
+        "[00000000000000zz]\r\n"            // Not hex
+        "[00000000000000aa]\r\n"
+        "Name=kept\r\n"
+        "no equals sign\r\n"
+        "Primaries=0.64,0.33,0.30\r\n"      // Too few values
+        "Luminance=0.1,abc,300\r\n"         // Not a number: keeps defaults
+        "RefreshMilliHz=60000\r\n"
+        "FutureKey=ignored\r\n"
+        "# comment\r\n"
+        "[00000000000000bb]\r\n"
+        "Primaries=0.64,0.33,0.30,0.60,0.15,0.06,0.3127,0.3290\r\n";   // No matrix: derived on load
+    CHECK(ParseDisplayDatabase(text, db));
+    CHECK_EQ(db.records.size(), 2u);
+    const DisplayRecord* kept = FindDisplay(db, 0xaa);
+    CHECK(kept != nullptr);
+    if (kept) {
+        CHECK(kept->name == "kept");
+        CHECK(!kept->primariesValid);
+        CHECK_EQ(kept->maxLuminance, 0.0f);
+        CHECK_EQ(kept->refreshMilliHz, 60000u);
+    }
+    const DisplayRecord* derived = FindDisplay(db, 0xbb);
+    CHECK(derived != nullptr);
+    if (derived) {
+        CHECK(derived->primariesValid);
+        CHECK_NEAR(derived->rgbToXYZ[4], 0.7152f, 2e-4);
+    }
+}
+
+// Path index follows moves; a different display behind a known path takes it over
+static void DevicePathIndex() {
+    DisplayDatabase db;
+    UpdateDisplay(db, MakeRecord(0x11, "port-a", true));
+    db.dirty = false;
+
+    // Unchanged record: nothing to save
+    UpdateDisplay(db, MakeRecord(0x11, "port-a", true));
+    CHECK(!db.dirty);
+    // Hash 0 is "unknown" and never stored
+    UpdateDisplay(db, MakeRecord(0, "port-z", true));
+    CHECK(FindDisplay(db, 0) == nullptr);
+    CHECK(!db.dirty);
+
+    // Same display on another port
+    UpdateDisplay(db, MakeRecord(0x11, "port-b", true));
+    CHECK(db.dirty);
+    CHECK_EQ(FindDisplayByDevicePath(db, "port-a"), 0u);
+    CHECK_EQ(FindDisplayByDevicePath(db, "port-b"), 0x11u);
+
+    // Another display swapped onto port-b: the old record loses the path, and reindexing after
+    // a save/load round trip agrees
+    UpdateDisplay(db, MakeRecord(0x22, "port-b", true));
+    CHECK_EQ(FindDisplayByDevicePath(db, "port-b"), 0x22u);
+    CHECK(FindDisplay(db, 0x11)->devicePath.empty());
+    DisplayDatabase reloaded;
+    CHECK(ParseDisplayDatabase(SerializeDisplayDatabase(db), reloaded));
+    CHECK_EQ(FindDisplayByDevicePath(reloaded, "port-b"), 0x22u);
+    CHECK_EQ(reloaded.byDevicePath.size(), 1u);
+}
+
+// First run after the upgrade moves [Monitor<i>] into [Display.<hash>]; later runs never
+// read legacy sections for identified displays again
+static void MigrationPlan() {
+    std::vector<uint64_t> hashes = { 0xa1, 0, 0xa1, 0xb2 };
+    std::unordered_set<std::wstring> legacyOnly = { L"monitor0", L"monitor1", L"monitor2", L"general" };
+    std::vector<MonitorSectionPlan> plans = PlanMonitorSections(hashes, legacyOnly);
+    CHECK_EQ(plans.size(), 4u);
+
+    CHECK(plans[0].loadFrom == L"Monitor0");
+    CHECK(plans[0].saveTo == L"Display.00000000000000a1");
+    CHECK(plans[0].migrateLegacy);
+
+    // No EDID, and the second of two identical EDIDs: index-based, nothing to migrate
+    CHECK(plans[1].loadFrom == L"Monitor1" && plans[1].saveTo == L"Monitor1");
+    CHECK(!plans[1].migrateLegacy);
+    CHECK(plans[2].loadFrom == L"Monitor2" && plans[2].saveTo == L"Monitor2");
+    CHECK(!plans[2].migrateLegacy);
+
+    // Identified, but no legacy section to migrate from
+    CHECK(plans[3].loadFrom == L"Display.00000000000000b2");
+    CHECK(!plans[3].migrateLegacy);
+
+    // Once a display section exists the legacy ones are stale: no migration
+    std::unordered_set<std::wstring> upgraded = { L"monitor0", L"monitor3", L"display.00000000000000a1" };
+    plans = PlanMonitorSections({ 0xa1, 0xc3, 0, 0xb2 }, upgraded);
+    CHECK(plans[0].loadFrom == L"Display.00000000000000a1" && !plans[0].migrateLegacy);
+    CHECK(plans[1].loadFrom == L"Display.00000000000000c3" && !plans[1].migrateLegacy);
+    CHECK(plans[3].loadFrom == L"Display.00000000000000b2" && !plans[3].migrateLegacy);
+
+    CHECK(PlanMonitorSections({}, legacyOnly).empty());
+}
+
+int main() {
+    RUN_TEST(EdidHashStable);
+    RUN_TEST(RgbToXYZ);
+    RUN_TEST(SerializeRoundTrip);
+    RUN_TEST(MalformedInput);
+    RUN_TEST(DevicePathIndex);
+    RUN_TEST(MigrationPlan);
+    return CheckExitCode();
+}
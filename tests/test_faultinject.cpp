@@ -0,0 +1,281 @@
+// DesktopLUT - tests/test_faultinject.cpp
+// Fault scripts: parsing and errors, rule schedules, seeded probabilities, the duplication
+// backoff, and the recovery simulator on single faults
+
+#include "check.h"
+#include "faultinject.h"
+
+#include <fstream>
+#include <sstream>
+
+static bool Parses(const char* text, FaultScript& script) {
+    std::string error;
+    bool ok = ParseFaultScript(text, script, error);
+    if (!ok) fprintf(stderr, "    unexpected error: %s\n", error.c_str());
+    return ok;
+}
+
+// Error message for a script that must not parse ("" if it parsed)
+static std::string ParseError(const char* text) {
+    FaultScript script;
+    std::string error;
+    return ParseFaultScript(text, script, error) ? std::string() : error;
+}
+
+static void ParseRules() {
+    FaultScript s;
+    CHECK(Parses("# comment only\n\n   \nseed 42\n"
+                 "acquire error p=0.001   # trailing comment\n"
+                 "present error hr=device_removed after=100000 limit=1\n"
+                 "duplicate error hr=0x80070005 every=2 until=40\n"
+                 "acquire hang ms=6000\n"
+                 "frame format format=10\n"
+                 "device delay ms=25\n", s));
+    CHECK_EQ(s.seed, 42u);
+    CHECK_EQ(s.rules.size(), 6u);
+    if (s.rules.size() != 6) return;
+
+    CHECK_EQ(s.rules[0].site, FAULT_SITE_ACQUIRE);
+    CHECK_EQ(s.rules[0].kind, FAULT_ERROR);
+    CHECK_EQ(s.rules[0].hr, FAULT_HR_ACCESS_LOST);             // The site's usual failure
+    CHECK_NEAR(s.rules[0].probability, 0.001, 1e-12);
+    CHECK_EQ(s.rules[1].hr, FAULT_HR_DEVICE_REMOVED);
+    CHECK_EQ(s.rules[1].after, 100000u);
+    CHECK_EQ(s.rules[1].limit, 1u);
+    CHECK_EQ(s.rules[2].hr, FAULT_HR_ACCESS_DENIED);            // Hex
+    CHECK_EQ(s.rules[2].every, 2u);
+    CHECK_EQ(s.rules[2].until, 40u);
+    CHECK_EQ(s.rules[3].kind, FAULT_HANG);
+    CHECK_EQ(s.rules[3].ms, 6000u);
+    CHECK_EQ(s.rules[4].site, FAULT_SITE_FRAME);
+    CHECK_EQ(s.rules[4].format, 10u);
+    CHECK_EQ(s.rules[5].site, FAULT_SITE_DEVICE);
+    CHECK_EQ(s.rules[5].hr, FAULT_HR_DEVICE_REMOVED);
+
+    // Reparsing starts from an empty script
+    CHECK(Parses("present error\n", s));
+    CHECK_EQ(s.rules.size(), 1u);
+    CHECK_EQ(s.seed, 1u);
+}
+
+static void ParseErrors() {
+    CHECK(ParseError("acquire error\nfoo error\n") == "line 2: unknown site 'foo'");
+    CHECK(ParseError("acquire\n") == "line 1: unknown fault ''");
+    CHECK(ParseError("acquire crash\n") == "line 1: unknown fault 'crash'");
+    CHECK(ParseError("acquire format\n") != "");                // Format faults are frame only
+    CHECK(ParseError("frame error\n") != "");
+    CHECK(ParseError("acquire delay\n") == "line 1: delay needs ms=");
+    CHECK(ParseError("\n\nacquire hang hr=device_hung\n") == "line 3: hang needs ms=");
+    CHECK(ParseError("seed x\n") == "line 1: bad seed 'x'");
+    CHECK(ParseError("seed\n") != "");
+
+    const char* badOptions[] = {
+        "acquire error p=2", "acquire error p=-0.1", "acquire error p=", "acquire error p=0.5x",
+        "acquire error hr=bogus", "acquire error hr=0x1FFFFFFFF", "acquire error hr=",
+        "acquire error every=0", "acquire error after=-1", "acquire error limit=-5",
+        "acquire error after=12abc", "acquire error after", "acquire error speed=3",
+        "acquire delay ms=4294967296", "acquire error limit=99999999999",
+        "acquire error after=99999999999999999999999",
+    };
+    for (const char* text : badOptions) {
+        std::string error = ParseError(text);
+        CHECK(error.rfind("line 1: bad option '", 0) == 0);
+        if (error.rfind("line 1: bad option '", 0) != 0) fprintf(stderr, "    accepted: %s\n", text);
+    }
+}
+
+// The example shipped in tools/ parses
+static void ExampleScript() {
+    std::string path = __FILE__;
+    path = path.substr(0, path.find_last_of("/\\") + 1) + "../tools/fault_script_example.txt";
+    std::ifstream file(path);
+    CHECK(file.good());
+    std::stringstream text;
+    text << file.rdbuf();
+    FaultScript s;
+    std::string error;
+    CHECK(ParseFaultScript(text.str(), s, error));
+    CHECK_EQ(s.seed, 42u);
+    CHECK_EQ(s.rules.size(), 9u);
+}
+
+static int Fires(FaultInjector& f, FaultSite site, int calls, std::string* pattern = nullptr) {
+    int fired = 0;
+    for (int i = 0; i < calls; i++) {
+        bool hit = NextFault(f, site).kind != FAULT_NONE;
+        fired += hit;
+        if (pattern) *pattern += hit ? '1' : '0';
+    }
+    return fired;
+}
+
+static void Schedules() {
+    FaultScript s;
+    FaultInjector f;
+    std::string pattern;
+
+    // Calls 4, 6 then the limit
+    CHECK(Parses("present error after=3 every=2 limit=2\n", s));
+    ResetFaultInjector(f, s);
+    Fires(f, FAULT_SITE_PRESENT, 10, &pattern);
+    CHECK(pattern == "0001010000");
+
+    // Calls 3..5
+    pattern.clear();
+    CHECK(Parses("acquire error after=2 until=5\n", s));
+    ResetFaultInjector(f, s);
+    Fires(f, FAULT_SITE_ACQUIRE, 8, &pattern);
+    CHECK(pattern == "00111000");
+
+    // Sites are counted separately
+    CHECK_EQ(Fires(f, FAULT_SITE_PRESENT, 5), 0);
+    CHECK_EQ(f.calls[FAULT_SITE_ACQUIRE], 8u);
+    CHECK_EQ(f.calls[FAULT_SITE_PRESENT], 5u);
+    CHECK_EQ(f.injected[FAULT_SITE_ACQUIRE], 3u);
+
+    // First matching rule wins; an exhausted rule lets the next one through
+    CHECK(Parses("acquire error hr=wait_timeout limit=2\nacquire delay ms=5\n", s));
+    ResetFaultInjector(f, s);
+    FaultDecision d = NextFault(f, FAULT_SITE_ACQUIRE);
+    CHECK_EQ(d.kind, FAULT_ERROR);
+    CHECK_EQ(d.hr, FAULT_HR_WAIT_TIMEOUT);
+    CHECK_EQ(d.rule, 0);
+    NextFault(f, FAULT_SITE_ACQUIRE);
+    d = NextFault(f, FAULT_SITE_ACQUIRE);
+    CHECK_EQ(d.kind, FAULT_DELAY);
+    CHECK_EQ(d.ms, 5u);
+    CHECK_EQ(d.rule, 1);
+    CHECK(FaultLabel(FAULT_SITE_ACQUIRE, d) == "acquire delay");
+
+    // Reset clears the counters
+    ResetFaultInjector(f, s);
+    CHECK_EQ(NextFault(f, FAULT_SITE_ACQUIRE).rule, 0);
+}
+
+static void Probability() {
+    FaultScript s;
+    CHECK(Parses("seed 7\nacquire error p=0.1\n", s));
+    FaultInjector f;
+    ResetFaultInjector(f, s);
+    std::string first;
+    int fired = Fires(f, FAULT_SITE_ACQUIRE, 20000, &first);
+    CHECK(fired > 1800 && fired < 2200);
+
+    // Same seed, same sequence; another seed, another one
+    std::string again;
+    ResetFaultInjector(f, s);
+    Fires(f, FAULT_SITE_ACQUIRE, 20000, &again);
+    CHECK(first == again);
+    s.seed = 8;
+    std::string other;
+    ResetFaultInjector(f, s);
+    Fires(f, FAULT_SITE_ACQUIRE, 20000, &other);
+    CHECK(first != other);
+
+    // seed 0 still draws (xorshift state is kept non-zero)
+    s.seed = 0;
+    ResetFaultInjector(f, s);
+    fired = Fires(f, FAULT_SITE_ACQUIRE, 20000);
+    CHECK(fired > 1800 && fired < 2200);
+}
+
+static void Names() {
+    CHECK(FaultHrName(FAULT_HR_ACCESS_LOST) == "access_lost");
+    CHECK(FaultHrName(0x80004005) == "0x80004005");
+    CHECK(std::string(FaultSiteName(FAULT_SITE_SWAPCHAIN)) == "swapchain");
+    CHECK(std::string(FaultSiteName(FAULT_SITE_COUNT)) == "unknown");
+    FaultDecision d;
+    d.kind = FAULT_FORMAT;
+    d.format = 10;
+    CHECK(FaultLabel(FAULT_SITE_FRAME, d) == "frame format 10");
+    d.kind = FAULT_HANG;
+    d.hr = FAULT_HR_DEVICE_HUNG;
+    CHECK(FaultLabel(FAULT_SITE_PRESENT, d) == "present hang device_hung");
+}
+
+static void Backoff() {
+    const BackoffPolicy& p = DUPLICATION_BACKOFF;
+    CHECK_EQ(BackoffDelayMs(p, 0), 50);
+    CHECK_EQ(BackoffDelayMs(p, 1), 50);
+    CHECK_EQ(BackoffDelayMs(p, 2), 100);
+    CHECK_EQ(BackoffDelayMs(p, 7), 3200);
+    CHECK_EQ(BackoffDelayMs(p, 8), 5000);                   // Capped
+    CHECK_EQ(BackoffDelayMs(p, 1000000), 5000);             // No shift overflow
+    BackoffPolicy few = { 10, 100000, 2 };
+    CHECK_EQ(BackoffDelayMs(few, 10), 40);                  // Doublings capped
+}
+
+static FaultSimReport Simulate(const char* text, double durationMs = 60000.0) {
+    FaultScript s;
+    CHECK(Parses(text, s));
+    FaultSimConfig c;
+    c.durationMs = durationMs;
+    return SimulateFaults(s, c);
+}
+
+static void SimulateCleanRun() {
+    FaultSimReport r = Simulate("");
+    CHECK(r.types.empty());
+    CHECK_EQ(r.framesLost, 0u);
+    CHECK(r.framesPresented >= 3600 && r.framesPresented <= 3601);     // 60 s at 60 Hz
+}
+
+static void SimulateSingleFaults() {
+    // Duplication loss: one retry after the first backoff step
+    FaultSimReport r = Simulate("acquire error after=600 limit=1\n");
+    CHECK_EQ(r.types.size(), 1u);
+    if (r.types.size() == 1) {
+        const FaultTypeStats& t = r.types[0];
+        CHECK(t.name == "acquire error access_lost");
+        CHECK_EQ(t.faults, 1u);
+        CHECK_EQ(t.recovered, 1u);
+        CHECK_EQ(t.retries, 1u);
+        CHECK_NEAR(t.maxRecoverMs, 50.0 + 15.0 + 1000.0 / 60.0, 1e-6);   // Backoff + reinit + one frame
+        CHECK_EQ(t.framesLost, 4u);                                       // 81.7 ms ~ 5 refreshes, one of them shown
+        CHECK_EQ(r.framesLost, 4u);
+    }
+
+    // Secure desktop: denied retries back off 50, 100, 200 ms before the fourth succeeds
+    r = Simulate("acquire error after=600 limit=1\nduplicate error limit=3\n");
+    if (r.types.size() == 1) {
+        CHECK_EQ(r.types[0].retries, 4u);
+        CHECK_NEAR(r.types[0].maxRecoverMs, 50.0 + 100.0 + 200.0 + 400.0 + 4 * 15.0 + 1000.0 / 60.0, 1e-6);
+    }
+
+    // Device loss at Present: the settle wait and manifest replay
+    r = Simulate("present error hr=device_removed after=600 limit=1\n");
+    CHECK_EQ(r.types.size(), 1u);
+    if (r.types.size() == 1) {
+        CHECK_EQ(r.types[0].recovered, 1u);
+        CHECK(r.types[0].maxRecoverMs > 2100.0);
+        CHECK(r.types[0].maxRecoverMs < 2100.0 + 1000.0 + 50.0);   // Plus at most one health check interval
+    }
+
+    // Missed frames don't reinit anything
+    r = Simulate("acquire error hr=wait_timeout after=600 limit=1\n");
+    if (r.types.size() == 1) {
+        CHECK_EQ(r.types[0].retries, 0u);
+        CHECK_EQ(r.types[0].recovered, 1u);
+    }
+
+    // A hang past the watchdog is reported as a trip
+    r = Simulate("acquire hang ms=6000 after=600 limit=1\n");
+    if (r.types.size() == 1) CHECK_EQ(r.types[0].watchdogTrips, 1u);
+
+    std::string table = FormatFaultReport(r);
+    CHECK(table.find("acquire hang access_lost") != std::string::npos);
+    CHECK(table.find("frames presented") != std::string::npos);
+}
+
+int main() {
+    RUN_TEST(ParseRules);
+    RUN_TEST(ParseErrors);
+    RUN_TEST(ExampleScript);
+    RUN_TEST(Schedules);
+    RUN_TEST(Probability);
+    RUN_TEST(Names);
+    RUN_TEST(Backoff);
+    RUN_TEST(SimulateCleanRun);
+    RUN_TEST(SimulateSingleFaults);
+    return CheckExitCode();
+}
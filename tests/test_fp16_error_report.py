@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+"""
+Checks the half-precision emulation in tools/fp16_error_report.py and that the shader's FP16
+stages stay within the report's default budget.
+
+Usage (ctest runs this when Python 3 is found):
+    python test_fp16_error_report.py
+"""
+
+import math
+import os
+import subprocess
+import sys
+import unittest
+
+TOOLS = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tools")
+sys.path.insert(0, TOOLS)
+import fp16_error_report as fp16  # noqa: E402
+
+ULP_AT_ONE = 2.0 ** -10
+
+class ToHalfTest(unittest.TestCase):
+    def setUp(self):
+        fp16.FLUSH_DENORMALS = True
+
+    def test_exact_values(self):
+        for v in (0.0, 1.0, -2.5, 0.5, 1024.0, 65504.0, 2.0 ** -14):
+            self.assertEqual(fp16.to_half(v), v)
+
+    def test_round_to_nearest_even(self):
+        self.assertEqual(fp16.to_half(1.0 + ULP_AT_ONE * 0.5), 1.0)                      # Tie, even below
+        self.assertEqual(fp16.to_half(1.0 + ULP_AT_ONE * 1.5), 1.0 + 2 * ULP_AT_ONE)     # Tie, even above
+        self.assertEqual(fp16.to_half(1.0 + ULP_AT_ONE * 0.51), 1.0 + ULP_AT_ONE)
+        self.assertEqual(fp16.to_half(0.1), 0.0999755859375)
+
+    def test_overflow(self):
+        self.assertEqual(fp16.to_half(65519.0), 65504.0)      # Rounds down to the max half
+        self.assertEqual(fp16.to_half(65520.0), math.inf)
+        self.assertEqual(fp16.to_half(-1e9), -math.inf)
+        self.assertTrue(math.isnan(fp16.to_half(math.nan)))
+
+    def test_denormals(self):
+        tiny = 2.0 ** -15
+        self.assertEqual(fp16.to_half(tiny), 0.0)
+        self.assertEqual(math.copysign(1.0, fp16.to_half(-tiny)), -1.0)    # Flushed to -0
+        fp16.FLUSH_DENORMALS = False
+        self.assertEqual(fp16.to_half(tiny), tiny)
+        self.assertEqual(fp16.to_half(2.0 ** -24), 2.0 ** -24)
+        self.assertEqual(fp16.to_half(2.0 ** -26), 0.0)
+
+class HalfArithmeticTest(unittest.TestCase):
+    def setUp(self):
+        fp16.FLUSH_DENORMALS = True
+
+    def test_each_operation_rounds(self):
+        one = fp16.Half(1.0)
+        small = fp16.Half(ULP_AT_ONE * 0.5)
+        self.assertEqual(float(one + small), 1.0)
+        self.assertEqual(float((one + small) + small), 1.0)        # Doesn't accumulate
+        self.assertEqual(float(one + (small + small)), 1.0 + ULP_AT_ONE)
+        self.assertEqual(float(fp16.Half(1.0) / 3.0), fp16.to_half(1.0 / 3.0))
+        self.assertEqual(float(fp16.Half(300.0) * 300.0), math.inf)
+
+    def test_literals_convert(self):
+        self.assertEqual(float(fp16.Half(0.0) + 0.1), 0.0999755859375)
+        self.assertEqual(float(fp16.f(0.1, True)), 0.0999755859375)
+        self.assertEqual(fp16.f(0.1, False), 0.1)
+
+    def test_intrinsics(self):
+        self.assertEqual(float(fp16.h_pow(fp16.Half(0.0), fp16.Half(2.2))), 0.0)
+        self.assertEqual(float(fp16.h_pow(fp16.Half(-0.5), fp16.Half(2.2))), 0.0)
+        self.assertAlmostEqual(float(fp16.h_pow(fp16.Half(0.5), fp16.Half(2.0))), 0.25, delta=ULP_AT_ONE)
+        self.assertEqual(float(fp16.h_sqrt(fp16.Half(-1.0))), 0.0)
+        self.assertEqual(float(fp16.h_saturate(fp16.Half(1.5))), 1.0)
+        self.assertEqual(float(fp16.h_saturate(fp16.Half(-0.5))), 0.0)
+
+class StageTest(unittest.TestCase):
+    def setUp(self):
+        fp16.FLUSH_DENORMALS = True
+
+    def test_lut_interpolation_on_identity_lut(self):
+        # Both interpolators reproduce the input exactly in full precision and to a
+        # couple of half ULPs when emulated
+        size = 17
+        saved = (fp16.LUT_SIZE, fp16.LUT)
+        fp16.LUT_SIZE = size
+        fp16.LUT = {(r, g, b): (r / (size - 1.0), g / (size - 1.0), b / (size - 1.0))
+                    for r in range(size) for g in range(size) for b in range(size)}
+        try:
+            for rgb in ([0.3, 0.7, 0.1], [0.0, 0.0, 0.0], [1.0, 0.5, 0.25], [0.9, 0.1, 0.95]):
+                for stage in (fp16.stage_lut_trilinear, fp16.stage_lut_tetrahedral):
+                    ref = stage(list(rgb), False)
+                    emu = stage([fp16.Half(c) for c in rgb], True)
+                    for c in range(3):
+                        self.assertAlmostEqual(ref[c], rgb[c], places=9)
+                        self.assertLess(abs(float(emu[c]) - rgb[c]), 3 * ULP_AT_ONE)
+        finally:
+            fp16.LUT_SIZE, fp16.LUT = saved
+
+    def test_fp16_stages_match_shader(self):
+        # The FP16 column must follow the lut_half typedefs in src/shader.h
+        fp16_stages = {name for name, fn, half in fp16.STAGES if half}
+        self.assertEqual(fp16_stages, {"lut_trilinear", "lut_tetrahedral"})
+
+class ReportTest(unittest.TestCase):
+    def run_report(self, *args):
+        return subprocess.run([sys.executable, os.path.join(TOOLS, "fp16_error_report.py"), *args],
+                              capture_output=True, text=True)
+
+    def test_default_budget_passes(self):
+        result = self.run_report()
+        self.assertEqual(result.returncode, 0, result.stdout + result.stderr)
+        self.assertIn("lut_tetrahedral  FP16", result.stdout)
+
+    def test_tight_budget_fails(self):
+        result = self.run_report("--budget", "0.1", "--lut-size", "17")
+        self.assertEqual(result.returncode, 1)
+        self.assertIn("<-- runs in FP16", result.stdout)
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,201 @@
+// DesktopLUT - tests/test_gamut.cpp
+// Gamut boundary table against the display RGB cube, neutral clamping, sampling, compression, sharing
+
+#include "check.h"
+#include "gamut.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+static const float PI = 3.14159265358979f;
+static const float IDENTITY[9] = { 1, 0, 0, 0, 1, 0, 0, 0, 1 };
+
+// Rec.2020 source -> Display P3 (D65) display, as the primaries correction builds it for HDR
+static const float REC2020_TO_P3[9] = {
+    1.3435783f, -0.2821797f, -0.0613986f,
+   -0.0652975f,  1.0757879f, -0.0104905f,
+    0.0028218f, -0.0195985f,  1.0167767f
+};
+
+static bool InGamut(const float* matrix, bool isHDR, float I, float ct, float cp, float tolerance) {
+    float ictcp[3] = { I, ct, cp };
+    float src[3];
+    ICtCpToSource(ictcp, isHDR, src);
+    for (int r = 0; r < 3; r++) {
+        float d = matrix[r * 3] * src[0] + matrix[r * 3 + 1] * src[1] + matrix[r * 3 + 2] * src[2];
+        if (d < -tolerance || d > 1.0f + tolerance) return false;
+    }
+    return true;
+}
+
+static float RowIntensity(const GamutBoundaryData& gbd, int row) {
+    return (row + 0.5f) / GAMUT_LIGHTNESS_STEPS * gbd.maxIntensity;
+}
+
+static float ColumnHue(int col) {
+    return (col + 0.5f) / GAMUT_HUE_STEPS * 2.0f * PI;
+}
+
+// Each cell's chroma is on the boundary: just inside is in gamut, just outside is not
+static int CountBoundaryErrors(const float* matrix, bool isHDR, const GamutBoundaryData& gbd) {
+    int errors = 0;
+    for (int row = 0; row < GAMUT_LIGHTNESS_STEPS; row++) {
+        float I = RowIntensity(gbd, row);
+        for (int col = 0; col < GAMUT_HUE_STEPS; col++) {
+            float c = gbd.maxChroma[row * GAMUT_HUE_STEPS + col];
+            float h = ColumnHue(col);
+            if (!InGamut(matrix, isHDR, I, c * 0.999f * cosf(h), c * 0.999f * sinf(h), 2e-4f)) errors++;
+            if (c < 0.59f && InGamut(matrix, isHDR, I, (c * 1.01f + 1e-4f) * cosf(h), (c * 1.01f + 1e-4f) * sinf(h), 0.0f)) errors++;
+        }
+    }
+    return errors;
+}
+
+static void BoundaryIdentitySDR() {
+    GamutBoundaryData gbd;
+    BuildGamutBoundary(IDENTITY, false, gbd);
+    CHECK(gbd.version != 0);
+    CHECK(gbd.maxIntensity > 0.5f && gbd.maxIntensity < 0.52f);   // PQ of 100 nits
+    CHECK_EQ(CountBoundaryErrors(IDENTITY, false, gbd), 0);
+    for (float c : gbd.maxChroma) CHECK(c > 0.0f && c < 0.6f);
+}
+
+static void BoundaryP3FromRec2020() {
+    GamutBoundaryData p3, full;
+    BuildGamutBoundary(REC2020_TO_P3, true, p3);
+    BuildGamutBoundary(IDENTITY, true, full);
+    CHECK_EQ(CountBoundaryErrors(REC2020_TO_P3, true, p3), 0);
+    CHECK(p3.version != full.version);
+
+    // P3 is smaller than Rec.2020: narrower overall, clearly so in many cells
+    double sumP3 = 0.0, sumFull = 0.0;
+    int narrower = 0;
+    for (int i = 0; i < GAMUT_LIGHTNESS_STEPS * GAMUT_HUE_STEPS; i++) {
+        sumP3 += p3.maxChroma[i];
+        sumFull += full.maxChroma[i];
+        if (p3.maxChroma[i] < full.maxChroma[i] * 0.9f) narrower++;
+    }
+    CHECK(sumP3 < sumFull * 0.95);
+    CHECK(narrower > GAMUT_HUE_STEPS * 4);
+}
+
+static void NeutralOutOfGamutClampsLightness() {
+    // Red gain of 2: white itself is out of gamut above 50% linear, but colors with less red
+    // are still reachable there
+    float gain[9] = { 2.0f, 0, 0, 0, 1, 0, 0, 0, 1 };
+    GamutBoundaryData gbd;
+    BuildGamutBoundary(gain, false, gbd);
+
+    int top = GAMUT_LIGHTNESS_STEPS - 1;
+    CHECK(!InGamut(gain, false, RowIntensity(gbd, top), 0.0f, 0.0f, 0.0f));
+    float topMax = 0.0f;
+    for (int col = 0; col < GAMUT_HUE_STEPS; col++) {
+        topMax = (std::max)(topMax, gbd.maxChroma[top * GAMUT_HUE_STEPS + col]);
+    }
+    CHECK(topMax > 0.01f);
+
+    // Clamped rows repeat the cross-section at the ceiling, and that cross-section is in gamut there
+    int firstClamped = -1;
+    for (int row = 0; row < GAMUT_LIGHTNESS_STEPS && firstClamped < 0; row++) {
+        if (!InGamut(gain, false, RowIntensity(gbd, row), 0.0f, 0.0f, 0.0f)) firstClamped = row;
+    }
+    CHECK(firstClamped > 0 && firstClamped < top);
+    for (int col = 0; col < GAMUT_HUE_STEPS; col++) {
+        CHECK_EQ(gbd.maxChroma[firstClamped * GAMUT_HUE_STEPS + col], gbd.maxChroma[top * GAMUT_HUE_STEPS + col]);
+    }
+
+    // Rows below the ceiling are still exact boundaries at their own lightness
+    int unclampedErrors = 0;
+    for (int row = 0; row < firstClamped; row++) {
+        float I = RowIntensity(gbd, row);
+        for (int col = 0; col < GAMUT_HUE_STEPS; col++) {
+            float c = gbd.maxChroma[row * GAMUT_HUE_STEPS + col] * 0.999f;
+            if (!InGamut(gain, false, I, c * cosf(ColumnHue(col)), c * sinf(ColumnHue(col)), 2e-4f)) unclampedErrors++;
+        }
+    }
+    CHECK_EQ(unclampedErrors, 0);
+}
+
+static void SamplingMatchesCells() {
+    GamutBoundaryData gbd;
+    BuildGamutBoundary(REC2020_TO_P3, true, gbd);
+    for (int row = 0; row < GAMUT_LIGHTNESS_STEPS; row += 7) {
+        for (int col = 0; col < GAMUT_HUE_STEPS; col += 5) {
+            CHECK_NEAR(SampleGamutBoundary(gbd, RowIntensity(gbd, row), ColumnHue(col)),
+                       gbd.maxChroma[row * GAMUT_HUE_STEPS + col], 1e-5);
+        }
+    }
+    // Hue wraps: just below 2pi blends the last and first columns like just above 0 does
+    float I = RowIntensity(gbd, 10);
+    CHECK_NEAR(SampleGamutBoundary(gbd, I, 2.0f * PI - 1e-4f), SampleGamutBoundary(gbd, I, 1e-4f), 1e-3);
+    // Lightness clamps at both ends
+    CHECK_EQ(SampleGamutBoundary(gbd, -1.0f, ColumnHue(3)), gbd.maxChroma[3]);
+    CHECK_EQ(SampleGamutBoundary(gbd, 2.0f, ColumnHue(3)), gbd.maxChroma[(GAMUT_LIGHTNESS_STEPS - 1) * GAMUT_HUE_STEPS + 3]);
+}
+
+static void CompressionKeepsHueAndLightness() {
+    GamutBoundaryData gbd;
+    BuildGamutBoundary(REC2020_TO_P3, true, gbd);
+    float I = RowIntensity(gbd, 12), hue = ColumnHue(20);
+    float cMax = SampleGamutBoundary(gbd, I, hue);
+
+    // Inside the knee: untouched
+    float inside[3] = { I, 0.5f * cMax * cosf(hue), 0.5f * cMax * sinf(hue) };
+    float before[3] = { inside[0], inside[1], inside[2] };
+    GamutCompressICtCp(gbd, inside);
+    CHECK_EQ(inside[1], before[1]);
+    CHECK_EQ(inside[2], before[2]);
+
+    // Far outside: pulled below the boundary, same intensity and hue, monotonic in input chroma
+    float last = 0.0f;
+    for (float scale : { 0.9f, 1.0f, 1.5f, 3.0f }) {
+        float c[3] = { I, scale * cMax * cosf(hue), scale * cMax * sinf(hue) };
+        GamutCompressICtCp(gbd, c);
+        float chroma = sqrtf(c[1] * c[1] + c[2] * c[2]);
+        CHECK(chroma < cMax);
+        CHECK(chroma > last);
+        CHECK_EQ(c[0], I);
+        CHECK_NEAR(atan2f(c[2], c[1]), hue > PI ? hue - 2.0f * PI : hue, 1e-4);
+        last = chroma;
+    }
+}
+
+static void TablesAreShared() {
+    GamutBoundaryRef a = AcquireGamutBoundary(REC2020_TO_P3, true);
+    GamutBoundaryRef b = AcquireGamutBoundary(REC2020_TO_P3, true);
+    GamutBoundaryRef sdr = AcquireGamutBoundary(REC2020_TO_P3, false);
+    CHECK(a && a == b);
+    CHECK(sdr && sdr != a);
+    CHECK(sdr->version != a->version);
+
+    // Concurrent requests for a new matrix all end up with one table
+    float other[9] = { 0.9f, 0.1f, 0, 0, 1, 0, 0, 0.05f, 0.95f };
+    GamutBoundaryRef results[4];
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&results, &other, t] { results[t] = AcquireGamutBoundary(other, false); });
+    }
+    for (auto& t : threads) t.join();
+    GamutBoundaryRef later = AcquireGamutBoundary(other, false);
+    for (const auto& r : results) CHECK(r && r == later);
+
+    // Evicted tables stay alive for their holders
+    for (int i = 0; i < GAMUT_CACHE_SIZE; i++) {
+        float m[9] = { 1.0f - 0.01f * i, 0, 0, 0, 1, 0, 0, 0, 1 };
+        AcquireGamutBoundary(m, false);
+    }
+    CHECK(a->version != 0);
+    CHECK(AcquireGamutBoundary(REC2020_TO_P3, true) != a);
+}
+
+int main() {
+    RUN_TEST(BoundaryIdentitySDR);
+    RUN_TEST(BoundaryP3FromRec2020);
+    RUN_TEST(NeutralOutOfGamutClampsLightness);
+    RUN_TEST(SamplingMatchesCells);
+    RUN_TEST(CompressionKeepsHueAndLightness);
+    RUN_TEST(TablesAreShared);
+    return CheckExitCode();
+}
@@ -0,0 +1,257 @@
+// DesktopLUT - tests/test_gpumanifest.cpp
+// GPU resource manifest: wave planning, broken dependencies, group batching, required vs.
+// optional failures, threaded replay
+
+#include "check.h"
+#include "gpumanifest.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+static int Add(ResourceManifest& m, const char* name, std::vector<int> deps = {}, int group = -1, bool required = true) {
+    ManifestEntry e;
+    e.name = name;
+    e.deps = std::move(deps);
+    e.group = group;
+    e.required = required;
+    return AddManifestEntry(m, std::move(e));
+}
+
+static int WaveOf(const std::vector<std::vector<int>>& waves, int entry) {
+    for (size_t w = 0; w < waves.size(); w++) {
+        for (int i : waves[w]) {
+            if (i == entry) return (int)w;
+        }
+    }
+    return -1;
+}
+
+// Fake device: counts creations and releases per entry, fails the entries in `failing`, and
+// loads initial data through the entry's load hook the way CreateManifestObject does
+struct FakeDevice {
+    explicit FakeDevice(const ResourceManifest& m) : manifest(m), created(m.entries.size()), released(m.entries.size()) {}
+
+    const ResourceManifest& manifest;
+    std::vector<std::atomic<int>> created;
+    std::vector<std::atomic<int>> released;
+    std::vector<int> failing;
+
+    bool Create(int i) {
+        const ManifestEntry& e = manifest.entries[i];
+        ManifestBlob source = e.load ? e.load() : e.source;
+        if (e.load && !source) return false;
+        for (int f : failing) {
+            if (f == i) return false;
+        }
+        created[i]++;
+        return true;
+    }
+
+    void Release(int i) { released[i]++; }
+
+    ManifestReplayResult Replay(const std::vector<std::vector<int>>& waves, int threads) {
+        return ReplayManifest(manifest, waves, [this](int i) { return Create(i); },
+                              [this](int i) { Release(i); }, threads);
+    }
+};
+
+static void WavesFollowDependencies() {
+    ResourceManifest m;
+    int texture = Add(m, "texture");
+    int vs = Add(m, "vs");
+    int srv = Add(m, "srv", { texture });
+    int sampler = Add(m, "sampler");
+    int late = Add(m, "late", { srv, vs });
+    int early = Add(m, "early", { late });       // Depends on a later manifest entry
+    CHECK_EQ(FindManifestEntry(m, "srv"), srv);
+    CHECK_EQ(FindManifestEntry(m, "missing"), -1);
+
+    std::vector<std::vector<int>> waves;
+    std::vector<int> unplaced;
+    CHECK(PlanManifestWaves(m, waves, unplaced));
+    CHECK(unplaced.empty());
+    CHECK_EQ(waves.size(), 4u);
+    CHECK_EQ(WaveOf(waves, texture), 0);
+    CHECK_EQ(WaveOf(waves, vs), 0);
+    CHECK_EQ(WaveOf(waves, sampler), 0);
+    CHECK_EQ(WaveOf(waves, srv), 1);
+    CHECK_EQ(WaveOf(waves, late), 2);
+    CHECK_EQ(WaveOf(waves, early), 3);
+
+    // Manifest order within a wave
+    CHECK(waves[0] == std::vector<int>({ texture, vs, sampler }));
+
+    // Every dependency sits in an earlier wave
+    for (size_t i = 0; i < m.entries.size(); i++) {
+        for (int dep : m.entries[i].deps) CHECK(WaveOf(waves, dep) < WaveOf(waves, (int)i));
+    }
+
+    ResourceManifest empty;
+    CHECK(PlanManifestWaves(empty, waves, unplaced));
+    CHECK(waves.empty());
+}
+
+// Out-of-range and self dependencies, a cycle, and what hangs off them: left out and reported,
+// the rest still planned and created
+static void BrokenDependenciesDropped() {
+    ResourceManifest m;
+    int ok = Add(m, "ok");
+    int missing = Add(m, "missing", { 42 }, -1, false);
+    int self = Add(m, "self", { 2 }, -1, false);
+    int a = Add(m, "cycle_a", { 4 }, -1, false);
+    int b = Add(m, "cycle_b", { a }, -1, false);
+    int behind = Add(m, "behind_cycle", { b }, -1, false);
+    int after = Add(m, "after_ok", { ok });
+    int negative = Add(m, "negative", { -1 }, 7, false);
+    int groupMate = Add(m, "group_mate", {}, 7, false);   // Same group as a broken entry
+
+    std::vector<std::vector<int>> waves;
+    std::vector<int> unplaced;
+    CHECK(!PlanManifestWaves(m, waves, unplaced));
+    CHECK(unplaced == std::vector<int>({ missing, self, a, b, behind, negative }));
+    CHECK_EQ(WaveOf(waves, ok), 0);
+    CHECK_EQ(WaveOf(waves, after), 1);
+    CHECK_EQ(WaveOf(waves, groupMate), 0);
+
+    FakeDevice device(m);
+    ManifestReplayResult r = device.Replay(waves, 4);
+    CHECK(r.ok);    // All broken entries are optional
+    CHECK(r.status[ok] == MANIFEST_CREATED);
+    CHECK(r.status[after] == MANIFEST_CREATED);
+    for (int i : unplaced) CHECK(r.status[i] == MANIFEST_SKIPPED);
+    CHECK(r.status[groupMate] == MANIFEST_SKIPPED);
+    CHECK_EQ(device.created[groupMate].load(), 0);
+    CHECK_EQ(r.created, 2);
+    CHECK_EQ(r.skipped, 7);
+
+    // A required entry on a cycle fails the replay before anything is created
+    ResourceManifest cyclic;
+    Add(cyclic, "first");
+    int x = Add(cyclic, "x", { 2 });
+    Add(cyclic, "y", { x });
+    CHECK(!PlanManifestWaves(cyclic, waves, unplaced));
+    CHECK_EQ(unplaced.size(), 2u);
+    FakeDevice cyclicDevice(cyclic);
+    r = cyclicDevice.Replay(waves, 2);
+    CHECK(!r.ok);
+    CHECK_EQ(r.created, 0);
+    CHECK_EQ(r.skipped, 3);
+    CHECK_EQ(cyclicDevice.created[0].load(), 0);
+}
+
+// A group is all-or-nothing: a failing member releases the created ones (even in earlier waves)
+// and skips the pending ones; entries depending on a dropped member go too
+static void GroupsBatched() {
+    ResourceManifest m;
+    int cb = Add(m, "peak_cb", {}, 1, false);
+    int texture = Add(m, "peak_texture", {}, 1, false);
+    int uav = Add(m, "peak_uav", { texture }, 1, false);
+    int shader = Add(m, "peak_cs", { cb }, 1, false);
+    int user = Add(m, "uses_peak_cb", { cb }, -1, false);
+    int other = Add(m, "scopes_cs", {}, 2, false);
+    int otherCb = Add(m, "scopes_cb", { other }, 2, false);
+
+    std::vector<std::vector<int>> waves;
+    std::vector<int> unplaced;
+    CHECK(PlanManifestWaves(m, waves, unplaced));
+
+    FakeDevice device(m);
+    device.failing = { uav };
+    ManifestReplayResult r = device.Replay(waves, 3);
+    CHECK(r.ok);
+    CHECK(r.status[uav] == MANIFEST_FAILED);
+    for (int i : { cb, texture, shader, user }) {
+        CHECK(r.status[i] == MANIFEST_SKIPPED);
+        CHECK_EQ(device.released[i].load(), device.created[i].load());   // Nothing left behind
+    }
+    CHECK_EQ(device.released[cb].load(), 1);
+    CHECK(r.status[other] == MANIFEST_CREATED);
+    CHECK(r.status[otherCb] == MANIFEST_CREATED);
+    CHECK_EQ(device.released[other].load(), 0);
+    CHECK_EQ(r.failed, 1);
+    CHECK_EQ(r.created, 2);
+}
+
+static ManifestBlob Bytes(size_t size) {
+    return std::make_shared<const std::vector<uint8_t>>(size, (uint8_t)0x3c);
+}
+
+// load() producing nothing fails the entry: a required one stops the replay after its wave,
+// an optional one just drops out
+static void FailingLoad() {
+    for (bool required : { false, true }) {
+        ResourceManifest m;
+        int shader = Add(m, "main_ps");
+        m.entries[shader].source = Bytes(64);
+        int lut = Add(m, "lut_texture", {}, -1, required);
+        m.entries[lut].load = [] { return ManifestBlob(); };
+        int good = Add(m, "good_lut_texture");
+        std::atomic<int> loads{ 0 };
+        m.entries[good].load = [&loads] {
+            loads++;
+            return Bytes(128);
+        };
+        int srv = Add(m, "lut_srv", { lut }, -1, required);
+        int nextWave = Add(m, "next_wave", { good });
+
+        std::vector<std::vector<int>> waves;
+        std::vector<int> unplaced;
+        CHECK(PlanManifestWaves(m, waves, unplaced));
+        FakeDevice device(m);
+        ManifestReplayResult r = device.Replay(waves, 2);
+
+        CHECK_EQ(r.ok, !required);
+        CHECK(r.status[lut] == MANIFEST_FAILED);
+        CHECK(r.status[srv] == MANIFEST_SKIPPED);
+        CHECK(r.status[shader] == MANIFEST_CREATED);
+        CHECK(r.status[good] == MANIFEST_CREATED);
+        CHECK_EQ(loads.load(), 1);
+        // Required: nothing after the failing wave runs (the caller releases what was created)
+        CHECK(r.status[nextWave] == (required ? MANIFEST_SKIPPED : MANIFEST_CREATED));
+        CHECK_EQ(device.created[nextWave].load(), required ? 0 : 1);
+    }
+}
+
+// Wide waves on many threads: every entry created exactly once, never before its dependencies
+static void ThreadedCreatesOnce() {
+    ResourceManifest m;
+    const int WIDTH = 64;
+    for (int i = 0; i < WIDTH; i++) Add(m, "base");
+    for (int i = 0; i < WIDTH; i++) Add(m, "view", { i, (i + 1) % WIDTH });
+    for (int i = 0; i < WIDTH; i++) Add(m, "pass", { WIDTH + i, WIDTH + (i + 7) % WIDTH }, i % 8);
+
+    std::vector<std::vector<int>> waves;
+    std::vector<int> unplaced;
+    CHECK(PlanManifestWaves(m, waves, unplaced));
+    CHECK_EQ(waves.size(), 3u);
+
+    for (int threads : { 1, 4, 16 }) {
+        std::vector<std::atomic<int>> created(m.entries.size());
+        std::atomic<int> orderViolations{ 0 };
+        ManifestReplayResult r = ReplayManifest(m, waves,
+            [&](int i) {
+                for (int dep : m.entries[i].deps) {
+                    if (created[dep].load() != 1) orderViolations++;
+                }
+                created[i]++;
+                return true;
+            },
+            [](int) {}, threads);
+        CHECK(r.ok);
+        CHECK_EQ(r.created, 3 * WIDTH);
+        CHECK_EQ(orderViolations.load(), 0);
+        for (auto& c : created) CHECK_EQ(c.load(), 1);
+    }
+}
+
+int main() {
+    RUN_TEST(WavesFollowDependencies);
+    RUN_TEST(BrokenDependenciesDropped);
+    RUN_TEST(GroupsBatched);
+    RUN_TEST(FailingLoad);
+    RUN_TEST(ThreadedCreatesOnce);
+    return CheckExitCode();
+}
@@ -0,0 +1,86 @@
+// DesktopLUT - tests/test_half.cpp
+// Float to half conversion: exact values, round-to-nearest-even ties, denormals, overflow, NaN,
+// and every half value and rounding midpoint checked exhaustively
+
+#include "check.h"
+#include "half.h"
+
+#include <cmath>
+#include <limits>
+
+// Value of a finite half (0x7C00 as 65536: the midpoint above the largest half rounds to it)
+static double HalfValue(uint16_t h) {
+    int exponent = (h >> 10) & 0x1F;
+    int mantissa = h & 0x3FF;
+    double v = exponent == 0 ? std::ldexp((double)mantissa, -24) : std::ldexp((double)(mantissa | 0x400), exponent - 25);
+    return (h & 0x8000) ? -v : v;
+}
+
+static void ExactValues() {
+    CHECK_EQ(FloatToHalf(0.0f), 0x0000);
+    CHECK_EQ(FloatToHalf(-0.0f), 0x8000);
+    CHECK_EQ(FloatToHalf(1.0f), 0x3C00);
+    CHECK_EQ(FloatToHalf(-2.0f), 0xC000);
+    CHECK_EQ(FloatToHalf(0.5f), 0x3800);
+    CHECK_EQ(FloatToHalf(65504.0f), 0x7BFF);
+    CHECK_EQ(FloatToHalf(std::ldexp(1.0f, -14)), 0x0400);     // Smallest normal
+    CHECK_EQ(FloatToHalf(std::ldexp(1.0f, -24)), 0x0001);     // Smallest denormal
+}
+
+static void NearestEven() {
+    CHECK_EQ(FloatToHalf(1.0f + std::ldexp(1.0f, -11)), 0x3C00);        // Tie, even below
+    CHECK_EQ(FloatToHalf(1.0f + 3 * std::ldexp(1.0f, -11)), 0x3C02);    // Tie, even above
+    CHECK_EQ(FloatToHalf(std::nextafter(1.0f + std::ldexp(1.0f, -11), 2.0f)), 0x3C01);
+    CHECK_EQ(FloatToHalf(0.1f), 0x2E66);
+    CHECK_EQ(FloatToHalf(1.0f / 3.0f), 0x3555);
+}
+
+static void Denormals() {
+    CHECK_EQ(FloatToHalf(std::ldexp(1.0f, -15)), 0x0200);
+    CHECK_EQ(FloatToHalf(-std::ldexp(1.0f, -15)), 0x8200);
+    CHECK_EQ(FloatToHalf(std::ldexp(1.0f, -25)), 0x0000);                             // Tie to zero
+    CHECK_EQ(FloatToHalf(std::nextafter(std::ldexp(1.0f, -25), 1.0f)), 0x0001);       // Sticky bit
+    CHECK_EQ(FloatToHalf(3 * std::ldexp(1.0f, -25)), 0x0002);                         // Tie, even above
+    CHECK_EQ(FloatToHalf(std::ldexp(1.0f, -26)), 0x0000);
+    CHECK_EQ(FloatToHalf(std::numeric_limits<float>::denorm_min()), 0x0000);
+    CHECK_EQ(FloatToHalf(std::nextafter(std::ldexp(1.0f, -14), 0.0f)), 0x0400);       // Rounds up to normal
+}
+
+static void OverflowAndNaN() {
+    CHECK_EQ(FloatToHalf(65519.0f), 0x7BFF);
+    CHECK_EQ(FloatToHalf(65520.0f), 0x7C00);
+    CHECK_EQ(FloatToHalf(-1e9f), 0xFC00);
+    CHECK_EQ(FloatToHalf(std::numeric_limits<float>::max()), 0x7C00);
+    CHECK_EQ(FloatToHalf(std::numeric_limits<float>::infinity()), 0x7C00);
+    CHECK_EQ(FloatToHalf(-std::numeric_limits<float>::infinity()), 0xFC00);
+    uint16_t nan = FloatToHalf(std::numeric_limits<float>::quiet_NaN());
+    CHECK_EQ(nan & 0x7C00, 0x7C00);
+    CHECK((nan & 0x3FF) != 0);
+}
+
+// Every finite half converts back to itself; the midpoint to the next one rounds to the even
+// of the two and the floats either side of it to the nearer one; negatives mirror positives
+static void Exhaustive() {
+    int wrong = 0;
+    for (uint32_t h = 0; h < 0x7C00; h++) {
+        float value = (float)HalfValue((uint16_t)h);
+        if (FloatToHalf(value) != h) wrong++;
+        if (FloatToHalf(-value) != (h | 0x8000)) wrong++;
+
+        float mid = (float)((HalfValue((uint16_t)h) + HalfValue((uint16_t)(h + 1))) / 2.0);
+        uint32_t even = (h & 1) ? h + 1 : h;
+        if (FloatToHalf(mid) != even) wrong++;
+        if (FloatToHalf(std::nextafter(mid, 0.0f)) != h) wrong++;
+        if (FloatToHalf(std::nextafter(mid, 1e30f)) != h + 1) wrong++;
+    }
+    CHECK_EQ(wrong, 0);
+}
+
+int main() {
+    RUN_TEST(ExactValues);
+    RUN_TEST(NearestEven);
+    RUN_TEST(Denormals);
+    RUN_TEST(OverflowAndNaN);
+    RUN_TEST(Exhaustive);
+    return CheckExitCode();
+}
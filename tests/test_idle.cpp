@@ -0,0 +1,118 @@
+// DesktopLUT - tests/test_idle.cpp
+// Idle tiers, acquire timeouts, health-check cadence and the render watchdog
+
+#include "check.h"
+#include "idle.h"
+
+using Clock = std::chrono::steady_clock;
+using std::chrono::milliseconds;
+
+static const int WATCHDOG_MS = 5000;   // WATCHDOG_TIMEOUT_SECONDS in types.h
+
+static Clock::time_point At(int ms) {
+    return Clock::time_point(milliseconds(1000000 + ms));
+}
+
+static void TiersFollowTimeSinceLastFrame() {
+    IdleTracker t;
+    CHECK(IdleUpdate(t, At(0), true) == IdleState::Active);          // First pass starts the clock
+    CHECK(IdleUpdate(t, At(IDLE_ENTER_MS - 1), true) == IdleState::Active);
+    CHECK(IdleUpdate(t, At(IDLE_ENTER_MS), true) == IdleState::Idle);
+    CHECK(IdleUpdate(t, At(DEEP_IDLE_ENTER_MS), true) == IdleState::DeepIdle);
+    CHECK_EQ(t.transitions, 2u);
+
+    // A new frame snaps straight back, without passing through Idle
+    IdleOnFrame(t, At(DEEP_IDLE_ENTER_MS + 10));
+    CHECK(t.state == IdleState::Active);
+    CHECK(IdleUpdate(t, At(DEEP_IDLE_ENTER_MS + 20), true) == IdleState::Active);
+    CHECK_EQ(t.transitions, 3u);
+}
+
+static void DisabledStaysActive() {
+    IdleTracker t;
+    IdleUpdate(t, At(0), false);
+    CHECK(IdleUpdate(t, At(DEEP_IDLE_ENTER_MS * 2), false) == IdleState::Active);
+    CHECK_EQ(t.transitions, 0u);
+    // Re-enabling judges the same elapsed time
+    CHECK(IdleUpdate(t, At(DEEP_IDLE_ENTER_MS * 2), true) == IdleState::DeepIdle);
+}
+
+static void AcquireTimeouts() {
+    // Active: one refresh; idle tiers: the pass budget split across monitors, never below a refresh
+    CHECK_EQ(IdleAcquireTimeoutMs(IdleState::Active, 16, 1), 16);
+    CHECK_EQ(IdleAcquireTimeoutMs(IdleState::Idle, 16, 1), IDLE_ACQUIRE_BUDGET_MS);
+    CHECK_EQ(IdleAcquireTimeoutMs(IdleState::Idle, 16, 2), IDLE_ACQUIRE_BUDGET_MS / 2);
+    CHECK_EQ(IdleAcquireTimeoutMs(IdleState::DeepIdle, 16, 4), DEEP_IDLE_ACQUIRE_BUDGET_MS / 4);
+    CHECK_EQ(IdleAcquireTimeoutMs(IdleState::DeepIdle, 41, 8), 41);
+    CHECK_EQ(IdleAcquireTimeoutMs(IdleState::Idle, 16, 0), IDLE_ACQUIRE_BUDGET_MS);
+    CHECK(IdleUseCompositorWait(IdleState::Active));
+    CHECK(!IdleUseCompositorWait(IdleState::Idle));
+    CHECK(!IdleUseCompositorWait(IdleState::DeepIdle));
+}
+
+static void WakeupRate() {
+    IdleTracker t;
+    for (int ms = 0; ms <= IDLE_WAKEUP_WINDOW_MS; ms += 10) IdleOnWakeup(t, At(ms));
+    CHECK_EQ(t.totalWakeups, 101u);
+    CHECK_NEAR(t.wakeupsPerSecond, 100.0f, 0.5f);
+}
+
+static void HealthChecksStayBelowWatchdog() {
+    // A stuck loop must be caught within the timeout plus one check, in every tier
+    for (IdleState s : { IdleState::Active, IdleState::Idle, IdleState::DeepIdle }) {
+        CHECK(IdleHealthCheckIntervalMs(s) < WATCHDOG_MS);
+        Clock::time_point last = At(0);
+        CHECK(!IdleHealthCheckDue(last, At(IdleHealthCheckIntervalMs(s) - 1), s));
+        CHECK(IdleHealthCheckDue(last, At(IdleHealthCheckIntervalMs(s)), s));
+        CHECK(last == At(IdleHealthCheckIntervalMs(s)));
+    }
+}
+
+// Simulated render loop: `timeouts` = AcquireNextFrame keeps timing out (static desktop, duplication
+// alive), which refreshes the watchdog like RenderMonitor does; otherwise nothing makes progress.
+// Returns the time the watchdog tripped, or -1.
+static int SimulateStaticDesktop(bool timeouts, int durationMs) {
+    IdleTracker t;
+    Clock::time_point lastProgress = At(0);
+    Clock::time_point lastCheck = At(0);
+    IdleOnFrame(t, At(0));
+    int ms = 0;
+    while (ms < durationMs) {
+        IdleState state = IdleUpdate(t, At(ms), true);
+        if (IdleHealthCheckDue(lastCheck, At(ms), state) && WatchdogExpired(lastProgress, At(ms), WATCHDOG_MS)) {
+            return ms;
+        }
+        ms += IdleAcquireTimeoutMs(state, 16, 1);
+        IdleOnWakeup(t, At(ms));
+        if (timeouts) lastProgress = At(ms);
+    }
+    return -1;
+}
+
+static void StaticDesktopNeverTripsWatchdog() {
+    // 60 seconds static: the tiers reach DeepIdle, every acquire times out, no trip
+    CHECK_EQ(SimulateStaticDesktop(true, 60000), -1);
+}
+
+static void StuckLoopTripsWatchdog() {
+    int tripped = SimulateStaticDesktop(false, 60000);
+    CHECK(tripped > WATCHDOG_MS);
+    CHECK(tripped <= WATCHDOG_MS + IdleHealthCheckIntervalMs(IdleState::Idle) + DEEP_IDLE_ACQUIRE_BUDGET_MS);
+}
+
+static void WatchdogBoundary() {
+    CHECK(!WatchdogExpired(At(0), At(WATCHDOG_MS), WATCHDOG_MS));
+    CHECK(WatchdogExpired(At(0), At(WATCHDOG_MS + 1), WATCHDOG_MS));
+}
+
+int main() {
+    RUN_TEST(TiersFollowTimeSinceLastFrame);
+    RUN_TEST(DisabledStaysActive);
+    RUN_TEST(AcquireTimeouts);
+    RUN_TEST(WakeupRate);
+    RUN_TEST(HealthChecksStayBelowWatchdog);
+    RUN_TEST(StaticDesktopNeverTripsWatchdog);
+    RUN_TEST(StuckLoopTripsWatchdog);
+    RUN_TEST(WatchdogBoundary);
+    return CheckExitCode();
+}
@@ -0,0 +1,287 @@
+// DesktopLUT - tests/test_lutingest.cpp
+// LUT text parsing: the line grammar, the streaming ingest and the chunk-parallel parser giving
+// the same texels and the same line-numbered errors as each other, whatever the thread count;
+// the retained RGB copy
+
+#include "check.h"
+#include "half.h"
+#include "lutingest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// A .cube with header keywords, CRLF line ends, a blank line and comments inside the body
+// (65^3 is ~2.7MB: about ten chunks)
+static std::string MakeCube(int n) {
+    std::string s = "# comment\nTITLE \"test\"\nDOMAIN_MIN 0 0 0\nLUT_3D_SIZE " + std::to_string(n) + "\r\n\n";
+    char line[96];
+    for (int b = 0; b < n; b++) {
+        for (int g = 0; g < n; g++) {
+            for (int r = 0; r < n; r++) {
+                snprintf(line, sizeof(line), "%.6f %.6f %.6f\r\n", r / (n - 1.0) * 0.97 + 0.01, g / (n - 1.0) * 0.98,
+                         b / (n - 1.0));
+                s += line;
+                if (r == 3 && g == 5) s += "# comment in the body\n";
+            }
+        }
+    }
+    return s;
+}
+
+// Start offset of each line (1-based line N starts at starts[N - 1])
+static std::vector<size_t> LineStarts(const std::string& text) {
+    std::vector<size_t> starts = { 0 };
+    for (size_t i = 0; i < text.size(); i++) {
+        if (text[i] == '\n') starts.push_back(i + 1);
+    }
+    return starts;
+}
+
+struct Parsed {
+    bool ok = false;
+    std::string error;
+    std::vector<uint16_t> texels;
+    std::vector<int> slices;        // Order they were handed over
+};
+
+static Parsed Serial(const std::string& text, bool isCube = true) {
+    Parsed p;
+    int size = 0;
+    LutIngestSink sink;
+    sink.begin = [&](int lutSize) {
+        size = lutSize;
+        p.texels.assign((size_t)size * size * size * 4, 0);
+        return true;
+    };
+    sink.slice = [&](int z, const uint16_t* texels) {
+        memcpy(&p.texels[(size_t)z * size * size * 4], texels, (size_t)size * size * 4 * sizeof(uint16_t));
+        p.slices.push_back(z);
+        return true;
+    };
+    LutIngestStats stats;
+    p.ok = IngestLUT(text.data(), text.size(), isCube, LUT_INGEST_SLOTS, sink, stats, p.error);
+    return p;
+}
+
+static Parsed Chunked(const std::string& text, int threads, bool isCube = true, LutParseStats* statsOut = nullptr) {
+    Parsed p;
+    LutText lut;
+    if (!ScanLUTHeader(text.data(), text.size(), isCube, lut, p.error)) return p;
+    p.texels.assign((size_t)lut.lutSize * lut.lutSize * lut.lutSize * 4, 0);
+    LutParseStats stats;
+    p.ok = ParseLUTBodyHalf(lut, threads, p.texels.data(), [&](int z) {
+        p.slices.push_back(z);
+        return true;
+    }, stats, p.error);
+    if (statsOut) *statsOut = stats;
+    return p;
+}
+
+static bool InOrder(const std::vector<int>& slices, int count) {
+    if ((int)slices.size() != count) return false;
+    for (int i = 0; i < count; i++) {
+        if (slices[i] != i) return false;
+    }
+    return true;
+}
+
+static void LineGrammar() {
+    float rgb[3];
+    LutLineParser cube = MakeLutLineParser(true);
+    const char* lines[] = { "TITLE \"x\"", "# 1 2 3", "", "   ", "DOMAIN_MAX 1 1 1" };
+    for (const char* line : lines) CHECK_EQ(ParseLUTLine(cube, line, line + strlen(line), rgb), LUT_LINE_SKIP);
+
+    const char* size = "LUT_3D_SIZE 33";
+    CHECK_EQ(ParseLUTLine(cube, size, size + strlen(size), rgb), LUT_LINE_SIZE);
+    CHECK_EQ(cube.lutSize, 33);
+    const char* big = "LUT_3D_SIZE 129";
+    CHECK_EQ(ParseLUTLine(cube, big, big + strlen(big), rgb), LUT_LINE_BAD_SIZE);
+
+    const char* entry = "  0.25 -0.5\t1e-3\r";
+    CHECK_EQ(ParseLUTLine(cube, entry, entry + strlen(entry), rgb), LUT_LINE_ENTRY);
+    CHECK_EQ(rgb[0], 0.25f);
+    CHECK_EQ(rgb[1], -0.5f);
+    CHECK_EQ(rgb[2], 1e-3f);
+    const char* two = "0.25 0.5";
+    CHECK_EQ(ParseLUTLine(cube, two, two + strlen(two), rgb), LUT_LINE_MALFORMED);
+
+    // eeColor: fixed size, 0-65535 values normalized
+    LutLineParser ee = MakeLutLineParser(false);
+    CHECK_EQ(ee.lutSize, LUT_EECOLOR_SIZE);
+    const char* wide = "65535 0 32767.5";
+    CHECK_EQ(ParseLUTLine(ee, wide, wide + strlen(wide), rgb), LUT_LINE_ENTRY);
+    CHECK_EQ(rgb[0], 1.0f);
+    CHECK_NEAR(rgb[2], 0.5, 1e-6);
+
+    CHECK(IsCubePath(L"C:\\luts\\Film.CUBE"));
+    CHECK(!IsCubePath(L"C:\\luts\\eecolor.txt"));
+}
+
+// Both parsers produce the same texels, slices in z order, for any thread count
+static void ChunkedMatchesSerial() {
+    std::string text = MakeCube(65);
+    Parsed serial = Serial(text);
+    CHECK(serial.ok);
+    CHECK(InOrder(serial.slices, 65));
+    for (int threads : { 1, 2, 3, 8 }) {
+        LutParseStats stats;
+        Parsed chunked = Chunked(text, threads, true, &stats);
+        CHECK(chunked.ok);
+        CHECK(chunked.texels == serial.texels);
+        CHECK(InOrder(chunked.slices, 65));
+        if (threads > 1) CHECK(stats.chunks > 1);
+    }
+
+    // Entry (r, g, b) at red-fastest index, alpha 1.0
+    size_t index = ((size_t)7 * 65 + 5) * 65 + 3;
+    CHECK_EQ(serial.texels[index * 4 + 0], FloatToHalf((float)(3 / 64.0 * 0.97 + 0.01)));
+    CHECK_EQ(serial.texels[index * 4 + 1], FloatToHalf((float)(5 / 64.0 * 0.98)));
+    CHECK_EQ(serial.texels[index * 4 + 2], FloatToHalf((float)(7 / 64.0)));
+    CHECK_EQ(serial.texels[index * 4 + 3], 0x3C00);
+
+    // The FP32 body parse holds the values the FP16 ones were rounded from
+    LutText lut;
+    std::string error;
+    CHECK(ScanLUTHeader(text.data(), text.size(), true, lut, error));
+    CHECK_EQ(lut.bodyLine, 6u);
+    std::vector<float> rgba((size_t)65 * 65 * 65 * 4);
+    LutParseStats stats;
+    CHECK(ParseLUTBody(lut, 4, rgba.data(), stats, error));
+    int mismatched = 0;
+    for (size_t i = 0; i < rgba.size(); i++) mismatched += FloatToHalf(rgba[i]) != serial.texels[i];
+    CHECK_EQ(mismatched, 0);
+}
+
+static void EEColor() {
+    std::string text;
+    char line[64];
+    for (int i = 0; i < LUT_EECOLOR_SIZE * LUT_EECOLOR_SIZE * LUT_EECOLOR_SIZE; i++) {
+        snprintf(line, sizeof(line), "%d %d %d\n", i % 65536, (i * 7) % 65536, 1000);
+        text += line;
+    }
+    Parsed serial = Serial(text, false);
+    Parsed chunked = Chunked(text, 4, false);
+    CHECK(serial.ok);
+    CHECK(chunked.ok);
+    CHECK(chunked.texels == serial.texels);
+    CHECK_EQ(serial.texels[2], FloatToHalf(1000.0f / 65535.0f));
+}
+
+// A line with two numbers put at line N: both report line N, whichever chunk holds it
+static void MalformedLineNumbers() {
+    std::string text = MakeCube(65);
+    std::vector<size_t> starts = LineStarts(text);
+    for (size_t n : { (size_t)6, (size_t)1000, starts.size() / 2, starts.size() - 3 }) {
+        std::string bad = text;
+        bad.insert(starts[n - 1], "0.5 0.5\n");
+        std::string expected = "Line " + std::to_string(n) + ": expected three numbers";
+        Parsed serial = Serial(bad);
+        CHECK(!serial.ok);
+        CHECK(serial.error == expected);
+        for (int threads : { 1, 4 }) {
+            Parsed chunked = Chunked(bad, threads);
+            CHECK(!chunked.ok);
+            CHECK(chunked.error == expected);
+        }
+    }
+
+    // Errors in several chunks: the earliest line wins
+    std::string bad = text;
+    bad.insert(starts[starts.size() - 10], "1 2\n");
+    bad.insert(starts[starts.size() / 3], "1 2\n");
+    Parsed chunked = Chunked(bad, 8);
+    CHECK(chunked.error == "Line " + std::to_string(starts.size() / 3 + 1) + ": expected three numbers");
+    CHECK(chunked.error == Serial(bad).error);
+}
+
+// Count and header errors: the same message from both parsers
+static void SameErrors() {
+    std::string text = MakeCube(17);
+    std::string cases[] = {
+        text + "0 0 0\n1 1 1\n",                         // One entry too many
+        text.substr(0, text.size() - 2 * 28),            // Last two entry lines missing
+        text + "LUT_3D_SIZE 4\n",                        // Size repeated in the body
+        "LUT_3D_SIZE 2\nLUT_3D_SIZE 2\n",                // Repeated in the header
+        "0 0 0\n",                                       // Entries before any size
+        "TITLE x\n",                                     // No size at all
+        "LUT_3D_SIZE 1\n0 0 0\n",                        // Size out of range
+    };
+    const char* expected[] = {
+        "Line 4936: more than 4913 entries",
+        "LUT error: Expected 4913 entries, got 4911",
+        "Line 4936: repeated LUT_3D_SIZE",
+        "Line 2: repeated LUT_3D_SIZE",
+        "Line 1: LUT data before LUT_3D_SIZE",
+        "Missing LUT_3D_SIZE",
+        "Invalid LUT size: 1 (must be 2-128)",
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        Parsed serial = Serial(cases[i]);
+        Parsed chunked = Chunked(cases[i], 4);
+        CHECK(!serial.ok);
+        CHECK(!chunked.ok);
+        CHECK(serial.error == chunked.error);
+        CHECK(serial.error == expected[i]);
+    }
+}
+
+// A sink or slice callback that fails stops the parse; slices before it were delivered
+static void SinkFailure() {
+    std::string text = MakeCube(33);
+    LutText lut;
+    std::string error;
+    CHECK(ScanLUTHeader(text.data(), text.size(), true, lut, error));
+    std::vector<uint16_t> texels((size_t)33 * 33 * 33 * 4);
+    LutParseStats stats;
+    int handed = 0;
+    CHECK(!ParseLUTBodyHalf(lut, 4, texels.data(), [&](int z) {
+        handed++;
+        return z < 5;
+    }, stats, error));
+    CHECK(error == "LUT upload failed at slice 5");
+    CHECK_EQ(handed, 6);
+
+    LutIngestSink sink;
+    sink.begin = [](int) { return true; };
+    sink.slice = [](int z, const uint16_t*) { return z < 3; };
+    LutIngestStats ingest;
+    CHECK(!IngestLUT(text.data(), text.size(), true, LUT_INGEST_SLOTS, sink, ingest, error));
+    CHECK(error == "LUT upload failed at slice 3");
+    CHECK_EQ(ingest.slices, 3);
+
+    sink.begin = [](int) { return false; };
+    CHECK(!IngestLUT(text.data(), text.size(), true, LUT_INGEST_SLOTS, sink, ingest, error));
+    CHECK(error == "LUT upload could not start");
+    CHECK_EQ(ingest.slices, 0);
+}
+
+// The retained RGB copy expands back to exactly the parsed texels
+static void RetainedRoundTrip() {
+    std::string text = MakeCube(17);
+    LutText lut;
+    std::string error;
+    CHECK(ScanLUTHeader(text.data(), text.size(), true, lut, error));
+    size_t count = (size_t)17 * 17 * 17;
+    std::vector<uint16_t> texels(count * 4);
+    LutParseStats stats;
+    CHECK(ParseLUTBodyHalf(lut, 1, texels.data(), nullptr, stats, error));
+
+    std::vector<uint16_t> rgb(count * 3);
+    PackLUTRGB(texels.data(), count, rgb.data());
+    CHECK_EQ(rgb[3], texels[4]);
+    std::vector<uint16_t> expanded(count * 4, 0);
+    ExpandLUTRGB(rgb.data(), count, expanded.data());
+    CHECK(expanded == texels);
+}
+
+int main() {
+    RUN_TEST(LineGrammar);
+    RUN_TEST(ChunkedMatchesSerial);
+    RUN_TEST(EEColor);
+    RUN_TEST(MalformedLineNumbers);
+    RUN_TEST(SameErrors);
+    RUN_TEST(SinkFailure);
+    RUN_TEST(RetainedRoundTrip);
+    return CheckExitCode();
+}
@@ -0,0 +1,197 @@
+// DesktopLUT - tests/test_lutstack.cpp
+// LUT stacks: stack spec parsing, the composed LUT against sequential application, identical
+// compositions whatever the thread count, trilinear and tetrahedral agreeing on identity LUTs
+
+#include "check.h"
+#include "lutstack.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+// n^3 RGBA, red fastest, from a per-node function of the node's 0-1 coordinates
+template <typename F>
+static std::vector<float> MakeLUT(int n, F node) {
+    std::vector<float> rgba((size_t)n * n * n * 4);
+    float* dst = rgba.data();
+    for (int b = 0; b < n; b++) {
+        for (int g = 0; g < n; g++) {
+            for (int r = 0; r < n; r++, dst += 4) {
+                float in[3] = { r / (n - 1.0f), g / (n - 1.0f), b / (n - 1.0f) };
+                node(in, dst);
+                dst[3] = 1.0f;
+            }
+        }
+    }
+    return rgba;
+}
+
+static std::vector<float> Identity(int n) {
+    return MakeLUT(n, [](const float in[3], float out[3]) {
+        out[0] = in[0];
+        out[1] = in[1];
+        out[2] = in[2];
+    });
+}
+
+// Per-channel curve with some crosstalk: a print-proof-like first member
+static std::vector<float> Curve(int n) {
+    return MakeLUT(n, [](const float in[3], float out[3]) {
+        out[0] = std::pow(in[0], 1.3f) * 0.9f + in[1] * 0.05f;
+        out[1] = std::pow(in[1], 0.8f) * 0.95f + in[2] * 0.03f;
+        out[2] = std::sqrt(in[2]) * 0.85f + in[0] * 0.1f;
+    });
+}
+
+// Saturation boost around luma, a calibration-like second member on a coarser grid
+static std::vector<float> Saturation(int n) {
+    return MakeLUT(n, [](const float in[3], float out[3]) {
+        float y = 0.2126f * in[0] + 0.7152f * in[1] + 0.0722f * in[2];
+        for (int c = 0; c < 3; c++) out[c] = y + (in[c] - y) * 1.2f;
+    });
+}
+
+static void SplitSpec() {
+    CHECK(SplitLUTStack(L"print.cube|calibration.cube") == std::vector<std::wstring>({ L"print.cube", L"calibration.cube" }));
+    CHECK(IsLUTStack(L"print.cube|calibration.cube"));
+
+    // Spaces around members are trimmed, spaces inside a path kept, empty members dropped
+    CHECK(SplitLUTStack(L" my print.cube |\tcal.txt\t") == std::vector<std::wstring>({ L"my print.cube", L"cal.txt" }));
+    CHECK(SplitLUTStack(L"a.cube|| |b.cube|") == std::vector<std::wstring>({ L"a.cube", L"b.cube" }));
+    CHECK(IsLUTStack(L"a.cube|| |b.cube|"));
+    CHECK_EQ(SplitLUTStack(L"a.cube|b.cube|c.cube|d.cube|e.cube").size(), 5u);   // The limit is the loader's
+
+    // Empty lists
+    CHECK(SplitLUTStack(L"").empty());
+    CHECK(SplitLUTStack(L"|").empty());
+    CHECK(SplitLUTStack(L" | \t| ").empty());
+    CHECK(!IsLUTStack(L""));
+    CHECK(!IsLUTStack(L" | "));
+
+    // A single member is a plain path, with or without separators
+    CHECK(SplitLUTStack(L"C:\\LUTs\\only.cube") == std::vector<std::wstring>({ L"C:\\LUTs\\only.cube" }));
+    CHECK(!IsLUTStack(L"C:\\LUTs\\only.cube"));
+    CHECK(SplitLUTStack(L"only.cube|") == std::vector<std::wstring>({ L"only.cube" }));
+    CHECK(!IsLUTStack(L"only.cube|"));
+    CHECK(!IsLUTStack(L"| only.cube |"));
+}
+
+// Every composed node holds what the members give one after another at that node
+static void ComposedMatchesSequentialAtNodes() {
+    std::vector<float> curve = Curve(17);
+    std::vector<float> saturation = Saturation(9);
+    LutStackMember members[2] = { { curve.data(), 17 }, { saturation.data(), 9 } };
+
+    for (LutInterp interp : { LUT_INTERP_TRILINEAR, LUT_INTERP_TETRAHEDRAL }) {
+        const int n = 17;
+        std::vector<float> composed((size_t)n * n * n * 4);
+        LutStackStats stats;
+        ComposeLUTStack(members, 2, n, interp, 2, composed.data(), stats);
+        LutStackMember lut = { composed.data(), n };
+
+        float worst = 0.0f;
+        for (int b = 0; b < n; b++) {
+            for (int g = 0; g < n; g++) {
+                for (int r = 0; r < n; r++) {
+                    float in[3] = { r / (n - 1.0f), g / (n - 1.0f), b / (n - 1.0f) };
+                    float direct[3], sequential[3];
+                    SampleLUT(lut, interp, in, direct);
+                    ApplyLUTStack(members, 2, interp, in, sequential);
+                    for (int c = 0; c < 3; c++) worst = std::fmax(worst, std::fabs(direct[c] - sequential[c]));
+                    CHECK_EQ(composed[(((size_t)b * n + g) * n + r) * 4 + 3], 1.0f);
+                }
+            }
+        }
+        CHECK(worst < 1e-5f);
+
+        // Between the nodes the chain isn't one grid's interpolation: a small, nonzero error
+        LutStackSamples samples;
+        MeasureLUTStack(members, 2, lut, interp, 2, samples, stats);
+        CHECK_EQ(stats.samples, LUT_STACK_ERROR_SAMPLES);
+        CHECK(stats.maxError > 0.0f);
+        CHECK(stats.maxError < 0.02f);
+        CHECK(stats.meanError <= stats.maxError);
+    }
+
+    // No members: the identity
+    float in[3] = { 0.25f, 0.5f, 0.75f };
+    float out[3];
+    ApplyLUTStack(members, 0, LUT_INTERP_TRILINEAR, in, out);
+    CHECK(out[0] == in[0] && out[1] == in[1] && out[2] == in[2]);
+}
+
+// The thread split changes which thread computes a slice, never a bit of the result
+static void SameResultAnyThreads() {
+    std::vector<float> curve = Curve(33);
+    std::vector<float> saturation = Saturation(17);
+    LutStackMember members[2] = { { curve.data(), 33 }, { saturation.data(), 17 } };
+    const int n = 33;
+
+    for (LutInterp interp : { LUT_INTERP_TRILINEAR, LUT_INTERP_TETRAHEDRAL }) {
+        std::vector<float> reference((size_t)n * n * n * 4);
+        LutStackStats referenceStats;
+        ComposeLUTStack(members, 2, n, interp, 1, reference.data(), referenceStats);
+        CHECK_EQ(referenceStats.threads, 1);
+        LutStackSamples referenceSamples;
+        MeasureLUTStack(members, 2, { reference.data(), n }, interp, 1, referenceSamples, referenceStats);
+
+        for (int threads : { 2, 3, 8, 64, 0 }) {
+            std::vector<float> composed(reference.size());
+            LutStackStats stats;
+            ComposeLUTStack(members, 2, n, interp, threads, composed.data(), stats);
+            CHECK(stats.threads >= 1 && stats.threads <= n);
+            CHECK(memcmp(composed.data(), reference.data(), reference.size() * sizeof(float)) == 0);
+
+            LutStackSamples samples;
+            MeasureLUTStack(members, 2, { composed.data(), n }, interp, threads, samples, stats);
+            CHECK_EQ(stats.maxError, referenceStats.maxError);
+            CHECK_EQ(stats.meanError, referenceStats.meanError);
+            for (int c = 0; c < 3; c++) CHECK(samples.composed[c] == referenceSamples.composed[c]);
+        }
+    }
+}
+
+// On an identity LUT both interpolations reduce to the same per-channel lerp, bit for bit
+static void IdentityInterpolationsAgree() {
+    for (int n : { 2, 17, 33, 65 }) {
+        std::vector<float> identity = Identity(n);
+        LutStackMember lut = { identity.data(), n };
+
+        uint32_t state = 0x12345678u;
+        auto next = [&]() {
+            state ^= state << 13; state ^= state >> 17; state ^= state << 5;
+            return (float)(state >> 8) * (1.0f / 16777216.0f) * 1.2f - 0.1f;   // Some out of range
+        };
+        for (int i = 0; i < 20000; i++) {
+            float in[3] = { next(), next(), next() };
+            if (i % 7 == 0) in[1] = in[0];                    // Ties between the fractions
+            if (i % 11 == 0) in[2] = in[0];
+            float trilinear[3], tetrahedral[3];
+            SampleLUT(lut, LUT_INTERP_TRILINEAR, in, trilinear);
+            SampleLUT(lut, LUT_INTERP_TETRAHEDRAL, in, tetrahedral);
+            for (int c = 0; c < 3; c++) {
+                CHECK_EQ(trilinear[c], tetrahedral[c]);
+                float expected = in[c] > 0.0f ? (in[c] < 1.0f ? in[c] : 1.0f) : 0.0f;
+                CHECK_NEAR(trilinear[c], expected, 1e-6f);
+            }
+        }
+
+        // Stacks of identities compose to the identity either way
+        std::vector<float> other = Identity(9);
+        LutStackMember members[2] = { lut, { other.data(), 9 } };
+        std::vector<float> trilinear((size_t)n * n * n * 4);
+        std::vector<float> tetrahedral(trilinear.size());
+        LutStackStats stats;
+        ComposeLUTStack(members, 2, n, LUT_INTERP_TRILINEAR, 2, trilinear.data(), stats);
+        ComposeLUTStack(members, 2, n, LUT_INTERP_TETRAHEDRAL, 2, tetrahedral.data(), stats);
+        CHECK(trilinear == tetrahedral);
+    }
+}
+
+int main() {
+    RUN_TEST(SplitSpec);
+    RUN_TEST(ComposedMatchesSequentialAtNodes);
+    RUN_TEST(SameResultAnyThreads);
+    RUN_TEST(IdentityInterpolationsAgree);
+    return CheckExitCode();
+}
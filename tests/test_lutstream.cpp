@@ -0,0 +1,480 @@
+// DesktopLUT - tests/test_lutstream.cpp
+// Live LUT streaming: framing, payload and region validation, the pending-update store, the
+// Unix-domain socket transport
+
+#include "netsocket.h"
+#ifdef _WIN32
+#include <afunix.h>
+#else
+#include <sys/un.h>
+#endif
+
+#include "check.h"
+#include "lutstream.h"
+#include "lutstreamsock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static LutStreamMessage FullLut(int size, uint32_t sequence) {
+    LutStreamMessage msg;
+    msg.type = LutStreamType::LutFull;
+    msg.sequence = sequence;
+    msg.monitorIndex = 1;
+    msg.isHDR = true;
+    msg.lutSize = size;
+    for (int i = 0; i < size * size * size * 3; i++) msg.values.push_back((float)i / (size * size * size * 3));
+    return msg;
+}
+
+static LutStreamMessage Region(int size, int x, int y, int z, int w, int h, int d, float value) {
+    LutStreamMessage msg;
+    msg.type = LutStreamType::LutRegion;
+    msg.monitorIndex = 1;
+    msg.isHDR = true;
+    msg.lutSize = size;
+    int box[6] = { x, y, z, w, h, d };
+    std::copy(box, box + 6, msg.region);
+    msg.values.assign((size_t)w * h * d * 3, value);
+    return msg;
+}
+
+static std::vector<uint8_t> Encode(const LutStreamMessage& msg) {
+    std::vector<uint8_t> out;
+    LutStreamEncode(msg, out);
+    return out;
+}
+
+static void Patch32(std::vector<uint8_t>& bytes, size_t offset, uint32_t v) {
+    memcpy(bytes.data() + offset, &v, 4);
+}
+
+// Decode a single framed message in one feed
+static LutStreamStatus DecodeOne(const std::vector<uint8_t>& bytes, LutStreamMessage& msg) {
+    LutStreamParser p;
+    LutStreamFeed(p, bytes.data(), bytes.size());
+    LutStreamStatus status = LutStreamStatus::Ok;
+    LutStreamResult r = LutStreamNext(p, msg, status);
+    CHECK(r == LutStreamResult::Message);
+    return status;
+}
+
+static void RoundTripByteByByte() {
+    LutStreamMessage matrix;
+    matrix.type = LutStreamType::Matrix;
+    matrix.sequence = 7;
+    matrix.monitorIndex = 2;
+    matrix.values = { 1.1f, -0.1f, 0, 0, 1, 0, 0, 0.05f, 0.95f };
+    LutStreamMessage gray;
+    gray.type = LutStreamType::Grayscale;
+    gray.sequence = 8;
+    gray.values = { 0.0f, 0.26f, 0.49f, 0.76f, 1.0f };
+
+    std::vector<uint8_t> stream = Encode(FullLut(3, 5));
+    LutStreamEncode(Region(3, 1, 0, 2, 2, 3, 1, 0.5f), stream);
+    LutStreamEncode(matrix, stream);
+    LutStreamEncode(gray, stream);
+
+    LutStreamParser p;
+    std::vector<LutStreamMessage> decoded;
+    LutStreamMessage msg;
+    LutStreamStatus status;
+    for (uint8_t b : stream) {
+        LutStreamFeed(p, &b, 1);
+        LutStreamResult r;
+        while ((r = LutStreamNext(p, msg, status)) == LutStreamResult::Message) {
+            CHECK(status == LutStreamStatus::Ok);
+            decoded.push_back(msg);
+        }
+        CHECK(r == LutStreamResult::NeedMore);
+    }
+    CHECK_EQ(decoded.size(), 4u);
+    if (decoded.size() != 4) return;
+
+    CHECK(decoded[0].type == LutStreamType::LutFull);
+    CHECK_EQ(decoded[0].sequence, 5u);
+    CHECK_EQ(decoded[0].monitorIndex, 1);
+    CHECK(decoded[0].isHDR);
+    CHECK_EQ(decoded[0].lutSize, 3);
+    CHECK(decoded[0].values == FullLut(3, 5).values);
+
+    CHECK(decoded[1].type == LutStreamType::LutRegion);
+    int expected[6] = { 1, 0, 2, 2, 3, 1 };
+    for (int i = 0; i < 6; i++) CHECK_EQ(decoded[1].region[i], expected[i]);
+    CHECK_EQ(decoded[1].values.size(), 18u);
+
+    CHECK(decoded[2].type == LutStreamType::Matrix);
+    CHECK_EQ(decoded[2].monitorIndex, 2);
+    CHECK(!decoded[2].isHDR);
+    CHECK(decoded[2].values == matrix.values);
+
+    CHECK(decoded[3].type == LutStreamType::Grayscale);
+    CHECK(decoded[3].values == gray.values);
+}
+
+static void FramingErrors() {
+    LutStreamMessage msg;
+    LutStreamStatus status;
+
+    std::vector<uint8_t> bytes = Encode(FullLut(2, 1));
+    bytes[0] = 'X';
+    LutStreamParser p;
+    LutStreamFeed(p, bytes.data(), bytes.size());
+    CHECK(LutStreamNext(p, msg, status) == LutStreamResult::FramingError);
+    CHECK(status == LutStreamStatus::BadMagic);
+
+    bytes = Encode(FullLut(2, 9));
+    bytes[4] = 2;   // Version
+    LutStreamParser p2;
+    LutStreamFeed(p2, bytes.data(), bytes.size());
+    CHECK(LutStreamNext(p2, msg, status) == LutStreamResult::FramingError);
+    CHECK(status == LutStreamStatus::BadVersion);
+    CHECK_EQ(msg.sequence, 9u);     // Echoed in the Ack
+
+    // Declared size past the largest legal payload: rejected from the header alone
+    bytes = Encode(FullLut(2, 1));
+    bytes.resize(LUT_STREAM_HEADER_SIZE);
+    Patch32(bytes, 12, (uint32_t)LUT_STREAM_MAX_PAYLOAD + 1);
+    LutStreamParser p3;
+    LutStreamFeed(p3, bytes.data(), bytes.size());
+    CHECK(LutStreamNext(p3, msg, status) == LutStreamResult::FramingError);
+    CHECK(status == LutStreamStatus::PayloadTooLarge);
+
+    // Short header: wait
+    LutStreamParser p4;
+    LutStreamFeed(p4, bytes.data(), LUT_STREAM_HEADER_SIZE - 1);
+    CHECK(LutStreamNext(p4, msg, status) == LutStreamResult::NeedMore);
+}
+
+static void PayloadValidation() {
+    LutStreamMessage msg;
+
+    // Unknown and server-only types
+    std::vector<uint8_t> bytes = Encode(FullLut(2, 1));
+    bytes[6] = 9;
+    CHECK(DecodeOne(bytes, msg) == LutStreamStatus::BadType);
+    bytes[6] = (uint8_t)LutStreamType::Ack;
+    CHECK(DecodeOne(bytes, msg) == LutStreamStatus::BadType);
+
+    // LUT size out of range
+    CHECK(DecodeOne(Encode(FullLut(1, 1)), msg) == LutStreamStatus::BadSize);
+    bytes = Encode(FullLut(2, 1));
+    Patch32(bytes, LUT_STREAM_HEADER_SIZE + LUT_STREAM_TARGET_SIZE, LUT_STREAM_MAX_SIZE + 1);
+    CHECK(DecodeOne(bytes, msg) == LutStreamStatus::BadSize);
+
+    // Payload size disagreeing with the LUT size
+    LutStreamMessage shortLut = FullLut(3, 1);
+    shortLut.values.pop_back();
+    CHECK(DecodeOne(Encode(shortLut), msg) == LutStreamStatus::BadLength);
+
+    // Non-finite and out-of-range values
+    LutStreamMessage bad = FullLut(2, 1);
+    bad.values[4] = std::numeric_limits<float>::quiet_NaN();
+    CHECK(DecodeOne(Encode(bad), msg) == LutStreamStatus::BadValue);
+    bad.values[4] = LUT_STREAM_MAX_VALUE * 2.0f;
+    CHECK(DecodeOne(Encode(bad), msg) == LutStreamStatus::BadValue);
+    bad.values[4] = -1.0f;                          // Negative LUT outputs are fine (HDR)
+    CHECK(DecodeOne(Encode(bad), msg) == LutStreamStatus::Ok);
+
+    // Grayscale: 2..32 points, non-negative
+    LutStreamMessage gray;
+    gray.type = LutStreamType::Grayscale;
+    gray.values = { 0.5f };
+    CHECK(DecodeOne(Encode(gray), msg) == LutStreamStatus::BadSize);
+    gray.values.assign(LUT_STREAM_MAX_GRAYSCALE_POINTS + 1, 0.5f);
+    CHECK(DecodeOne(Encode(gray), msg) == LutStreamStatus::BadSize);
+    gray.values = { 0.0f, -0.1f, 1.0f };
+    CHECK(DecodeOne(Encode(gray), msg) == LutStreamStatus::BadValue);
+
+    // Matrix must be exactly 9 floats
+    LutStreamMessage matrix;
+    matrix.type = LutStreamType::Matrix;
+    matrix.values.assign(8, 0.0f);
+    CHECK(DecodeOne(Encode(matrix), msg) == LutStreamStatus::BadLength);
+
+    // Target truncated
+    bytes = Encode(matrix);
+    bytes.resize(LUT_STREAM_HEADER_SIZE + 4);
+    Patch32(bytes, 12, 4);
+    CHECK(DecodeOne(bytes, msg) == LutStreamStatus::BadLength);
+}
+
+static void RegionValidation() {
+    LutStreamMessage msg;
+    CHECK(DecodeOne(Encode(Region(4, 0, 0, 0, 4, 4, 4, 0.1f)), msg) == LutStreamStatus::Ok);
+    CHECK(DecodeOne(Encode(Region(4, 3, 3, 3, 1, 1, 1, 0.1f)), msg) == LutStreamStatus::Ok);
+    CHECK(DecodeOne(Encode(Region(4, 3, 0, 0, 2, 1, 1, 0.1f)), msg) == LutStreamStatus::BadRegion);   // Past the end
+    CHECK(DecodeOne(Encode(Region(4, 0, 0, 4, 1, 1, 1, 0.1f)), msg) == LutStreamStatus::BadRegion);
+    CHECK(DecodeOne(Encode(Region(4, 0, 0, 0, 1, 0, 1, 0.1f)), msg) == LutStreamStatus::BadRegion);   // Empty
+
+    // An offset near 2^32 must not wrap around the bounds check
+    std::vector<uint8_t> bytes = Encode(Region(4, 1, 0, 0, 2, 1, 1, 0.1f));
+    size_t boxAt = LUT_STREAM_HEADER_SIZE + LUT_STREAM_TARGET_SIZE + 4;
+    Patch32(bytes, boxAt, 0xFFFFFFFFu);
+    CHECK(DecodeOne(bytes, msg) == LutStreamStatus::BadRegion);
+
+    // Extents whose product overflows 32 bits: caught by the region check before the length one
+    bytes = Encode(Region(4, 0, 0, 0, 1, 1, 1, 0.1f));
+    Patch32(bytes, boxAt + 12, 0x10000u);
+    Patch32(bytes, boxAt + 16, 0x10000u);
+    CHECK(DecodeOne(bytes, msg) == LutStreamStatus::BadRegion);
+
+    // Region data length must match the box
+    LutStreamMessage shortRegion = Region(4, 0, 0, 0, 2, 2, 2, 0.1f);
+    shortRegion.values.resize(shortRegion.values.size() - 3);
+    CHECK(DecodeOne(Encode(shortRegion), msg) == LutStreamStatus::BadLength);
+}
+
+// A bad message is skipped; the next one in the stream still decodes
+static void StreamContinuesAfterMessageError() {
+    LutStreamMessage bad = FullLut(2, 1);
+    bad.values[0] = INFINITY;
+    std::vector<uint8_t> stream = Encode(bad);
+    LutStreamEncode(FullLut(2, 2), stream);
+
+    LutStreamParser p;
+    LutStreamFeed(p, stream.data(), stream.size());
+    LutStreamMessage msg;
+    LutStreamStatus status;
+    CHECK(LutStreamNext(p, msg, status) == LutStreamResult::Message);
+    CHECK(status == LutStreamStatus::BadValue);
+    CHECK_EQ(msg.sequence, 1u);
+    CHECK(LutStreamNext(p, msg, status) == LutStreamResult::Message);
+    CHECK(status == LutStreamStatus::Ok);
+    CHECK_EQ(msg.sequence, 2u);
+    CHECK(LutStreamNext(p, msg, status) == LutStreamResult::NeedMore);
+}
+
+static void AckEncoding() {
+    std::vector<uint8_t> ack;
+    LutStreamEncodeAck(42, LutStreamStatus::BadRegion, ack);
+    CHECK_EQ(ack.size(), LUT_STREAM_HEADER_SIZE + 4);
+    uint32_t magic, sequence, size;
+    uint16_t type, status;
+    memcpy(&magic, ack.data(), 4);
+    memcpy(&type, ack.data() + 6, 2);
+    memcpy(&sequence, ack.data() + 8, 4);
+    memcpy(&size, ack.data() + 12, 4);
+    memcpy(&status, ack.data() + 16, 2);
+    CHECK_EQ(magic, LUT_STREAM_MAGIC);
+    CHECK(type == (uint16_t)LutStreamType::Ack);
+    CHECK_EQ(sequence, 42u);
+    CHECK_EQ(size, 4u);
+    CHECK(status == (uint16_t)LutStreamStatus::BadRegion);
+    CHECK(strcmp(LutStreamStatusName(LutStreamStatus::BadRegion), "region outside LUT") == 0);
+}
+
+// The parser's buffer is compacted as messages are consumed
+static void ParserBufferBounded() {
+    std::vector<uint8_t> one = Encode(FullLut(4, 1));
+    LutStreamParser p;
+    LutStreamMessage msg;
+    LutStreamStatus status;
+    for (int i = 0; i < 1000; i++) {
+        LutStreamFeed(p, one.data(), one.size());
+        CHECK(LutStreamNext(p, msg, status) == LutStreamResult::Message);
+    }
+    CHECK(p.buffer.size() <= one.size() * 2);
+}
+
+static void StoreMergesAndUploads() {
+    LiveLutStore store;
+    LiveLutUpload up;
+
+    // A region before any full LUT has nothing to patch
+    CHECK(LiveLutMerge(store, Region(4, 0, 0, 0, 1, 1, 1, 0.5f)) == LutStreamStatus::NoBaseLut);
+
+    // First full LUT: new texture, whole volume in RGBA
+    LutStreamMessage full = FullLut(4, 1);
+    CHECK(LiveLutMerge(store, full) == LutStreamStatus::Ok);
+    CHECK_EQ(store.targets.size(), 1u);
+    LiveLutTarget& t = store.targets[0];
+    CHECK(LiveLutTakeUpload(t, up));
+    CHECK(up.recreate);
+    CHECK_EQ(up.rgba.size(), 4u * 4 * 4 * 4);
+    CHECK_EQ(up.rgba[5 * 4 + 1], full.values[5 * 3 + 1]);
+    CHECK_EQ(up.rgba[5 * 4 + 3], 1.0f);
+    CHECK(!LiveLutTakeUpload(t, up));
+
+    // Two regions: the upload covers their union, with the new values inside and old ones around
+    CHECK(LiveLutMerge(store, Region(4, 0, 1, 1, 1, 1, 1, 0.25f)) == LutStreamStatus::Ok);
+    CHECK(LiveLutMerge(store, Region(4, 2, 2, 1, 2, 1, 2, 0.75f)) == LutStreamStatus::Ok);
+    CHECK(LiveLutTakeUpload(t, up));
+    CHECK(!up.recreate);
+    int expectedMin[3] = { 0, 1, 1 }, expectedMax[3] = { 4, 3, 3 };
+    for (int a = 0; a < 3; a++) {
+        CHECK_EQ(up.boxMin[a], expectedMin[a]);
+        CHECK_EQ(up.boxMax[a], expectedMax[a]);
+    }
+    CHECK_EQ(up.rgba.size(), 4u * 2 * 2 * 4);
+    auto at = [&up](int x, int y, int z) { return &up.rgba[(((size_t)(z - 1) * 2 + (y - 1)) * 4 + x) * 4]; };
+    CHECK_EQ(at(0, 1, 1)[0], 0.25f);
+    CHECK_EQ(at(3, 2, 2)[2], 0.75f);
+    CHECK_EQ(at(1, 1, 1)[0], full.values[((1 * 4 + 1) * 4 + 1) * 3]);   // Untouched texel in the box
+
+    // Wrong size for the current LUT; then a new size recreates
+    CHECK(LiveLutMerge(store, Region(8, 0, 0, 0, 1, 1, 1, 0.5f)) == LutStreamStatus::NoBaseLut);
+    CHECK(LiveLutMerge(store, FullLut(8, 3)) == LutStreamStatus::Ok);
+    CHECK(LiveLutTakeUpload(store.targets[0], up));
+    CHECK(up.recreate);
+    CHECK_EQ(up.lutSize, 8);
+
+    // Other modes and monitors are separate targets; matrix / curve updates just flag dirty
+    LutStreamMessage matrix;
+    matrix.type = LutStreamType::Matrix;
+    matrix.monitorIndex = 1;
+    matrix.isHDR = false;
+    matrix.values = { 1, 0, 0, 0, 1, 0, 0, 0, 0.5f };
+    CHECK(LiveLutMerge(store, matrix) == LutStreamStatus::Ok);
+    CHECK_EQ(store.targets.size(), 2u);
+    CHECK(store.targets[1].matrixDirty);
+    CHECK_EQ(store.targets[1].matrix[8], 0.5f);
+    CHECK(!LiveLutTakeUpload(store.targets[1], up));
+}
+
+// ============================================================================
+// Socket transport
+// ============================================================================
+
+static SOCKET ConnectSocket(const std::string& path) {
+    SOCKET s = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    if (connect(s, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
+        closesocket(s);
+        return INVALID_SOCKET;
+    }
+    NetSetTimeouts(s, 5000, 5000);
+    return s;
+}
+
+static void SendBytes(SOCKET s, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        int sent = (int)send(s, (const char*)data, (int)size, NET_SEND_FLAGS);
+        if (sent <= 0) return;
+        data += sent;
+        size -= (size_t)sent;
+    }
+}
+
+// Read one Ack; false if the server closed (or timed out) first
+static bool ReadAck(SOCKET s, uint32_t& sequence, LutStreamStatus& status) {
+    uint8_t ack[LUT_STREAM_HEADER_SIZE + 4];
+    size_t received = 0;
+    while (received < sizeof(ack)) {
+        int n = (int)recv(s, (char*)ack + received, (int)(sizeof(ack) - received), 0);
+        if (n <= 0) return false;
+        received += (size_t)n;
+    }
+    uint16_t type, code;
+    memcpy(&type, ack + 6, 2);
+    memcpy(&sequence, ack + 8, 4);
+    memcpy(&code, ack + 16, 2);
+    status = (LutStreamStatus)code;
+    return type == (uint16_t)LutStreamType::Ack;
+}
+
+// A client on the socket: a full LUT whose header arrives on its own, a region patch, then a
+// malformed frame that gets its Ack and drops the connection
+static void SocketTransport() {
+    std::string path = (std::filesystem::temp_directory_path() / "desktoplut_test_lutstream.sock").string();
+    std::mutex storeMutex;
+    LiveLutStore store;
+    bool started = StartLutStreamSocket(path, [&](const LutStreamMessage& msg) {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        return LiveLutMerge(store, msg);
+    });
+    CHECK(started);
+    if (!started) return;
+
+    SOCKET s = ConnectSocket(path);
+    CHECK(s != INVALID_SOCKET);
+    if (s == INVALID_SOCKET) {
+        StopLutStreamSocket();
+        return;
+    }
+    uint32_t sequence = 0;
+    LutStreamStatus status = LutStreamStatus::BadMagic;
+
+    // Header first, payload later: the server waits for the whole frame
+    LutStreamMessage full = FullLut(5, 11);
+    std::vector<uint8_t> bytes = Encode(full);
+    SendBytes(s, bytes.data(), LUT_STREAM_HEADER_SIZE);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    SendBytes(s, bytes.data() + LUT_STREAM_HEADER_SIZE, bytes.size() - LUT_STREAM_HEADER_SIZE);
+    CHECK(ReadAck(s, sequence, status));
+    CHECK_EQ(sequence, 11u);
+    CHECK(status == LutStreamStatus::Ok);
+
+    LutStreamMessage region = Region(5, 1, 2, 3, 2, 2, 1, 0.5f);
+    region.sequence = 12;
+    bytes = Encode(region);
+    SendBytes(s, bytes.data(), bytes.size());
+    CHECK(ReadAck(s, sequence, status));
+    CHECK_EQ(sequence, 12u);
+    CHECK(status == LutStreamStatus::Ok);
+
+    // Both merged into the store the handler owns
+    {
+        std::lock_guard<std::mutex> lock(storeMutex);
+        CHECK_EQ(store.targets.size(), 1u);
+        if (store.targets.size() == 1) {
+            const LiveLutTarget& t = store.targets[0];
+            CHECK_EQ(t.lutSize, 5);
+            CHECK_EQ(t.rgba[(((size_t)3 * 5 + 2) * 5 + 1) * 4], 0.5f);
+            CHECK_EQ(t.rgba[0 + 1], full.values[1]);
+        }
+    }
+
+    // Bad magic: framing error Ack (sequence 0), then the server closes
+    bytes = Encode(FullLut(2, 13));
+    Patch32(bytes, 0, 0x12345678);
+    SendBytes(s, bytes.data(), bytes.size());
+    CHECK(ReadAck(s, sequence, status));
+    CHECK_EQ(sequence, 0u);
+    CHECK(status == LutStreamStatus::BadMagic);
+    CHECK(!ReadAck(s, sequence, status));
+    closesocket(s);
+
+    // The next client is served from a fresh parser
+    s = ConnectSocket(path);
+    CHECK(s != INVALID_SOCKET);
+    bytes = Encode(Region(5, 0, 0, 0, 1, 1, 1, 0.25f));
+    SendBytes(s, bytes.data(), bytes.size());
+    CHECK(ReadAck(s, sequence, status));
+    CHECK(status == LutStreamStatus::Ok);
+
+    // Stopping with a connected, idle client returns within the poll interval
+    Clock::time_point start = Clock::now();
+    StopLutStreamSocket();
+    double stopMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    CHECK(stopMs < 4.0 * LUT_SOCKET_POLL_MS);
+    closesocket(s);
+    CHECK(!std::filesystem::exists(path));
+}
+
+int main() {
+    RUN_TEST(RoundTripByteByByte);
+    RUN_TEST(FramingErrors);
+    RUN_TEST(PayloadValidation);
+    RUN_TEST(RegionValidation);
+    RUN_TEST(StreamContinuesAfterMessageError);
+    RUN_TEST(AckEncoding);
+    RUN_TEST(ParserBufferBounded);
+    RUN_TEST(StoreMergesAndUploads);
+    if (!NetStartup()) return 1;
+    RUN_TEST(SocketTransport);
+    NetCleanup();
+    return CheckExitCode();
+}
@@ -0,0 +1,138 @@
+// DesktopLUT - tests/test_metrics.cpp
+// Metrics registry updates and the Prometheus text serializer
+
+#include "check.h"
+#include "metrics.h"
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+static bool Contains(const std::string& text, const char* line) {
+    return text.find(line) != std::string::npos;
+}
+
+static void HistogramBuckets() {
+    MetricsRegistry r;
+    MonitorMetrics* m = MetricsAttachMonitor(r, 0);
+    MetricHistogram& h = m->frameTimeMs;
+    MetricObserve(h, 4.2);       // On a bound: that bucket (le is inclusive)
+    MetricObserve(h, 4.3);
+    MetricObserve(h, 16.7);
+    MetricObserve(h, 5000.0);    // Past the last bound: +Inf
+    CHECK_EQ(h.buckets[0].load(), 1u);
+    CHECK_EQ(h.buckets[1].load(), 1u);
+    CHECK_EQ(h.buckets[4].load(), 1u);
+    CHECK_EQ(h.buckets[h.boundCount].load(), 1u);
+    CHECK_NEAR(h.sum.load(), 4.2 + 4.3 + 16.7 + 5000.0, 1e-9);
+}
+
+static void SerializesActiveMonitorsOnly() {
+    MetricsRegistry r;
+    MonitorMetrics* m0 = MetricsAttachMonitor(r, 0);
+    MonitorMetrics* m3 = MetricsAttachMonitor(r, 3);
+    MetricInc(m0->framesRendered, 5);
+    MetricInc(m3->framesRendered);
+    MetricSet(m3->peakNits, 812.5);
+    MetricInc(r.tdrRecoveries);
+
+    std::string out;
+    SerializeMetrics(r, out);
+    CHECK(Contains(out, "desktoplut_monitors_active 2\n"));
+    CHECK(Contains(out, "# TYPE desktoplut_frames_rendered_total counter\n"));
+    CHECK(Contains(out, "desktoplut_frames_rendered_total{monitor=\"0\"} 5\n"));
+    CHECK(Contains(out, "desktoplut_frames_rendered_total{monitor=\"3\"} 1\n"));
+    CHECK(!Contains(out, "monitor=\"1\""));
+    CHECK(Contains(out, "desktoplut_peak_nits{monitor=\"3\"} 812.5\n"));
+    CHECK(Contains(out, "desktoplut_tdr_recoveries_total 1\n"));
+
+    // Detached monitors stop being exported; display indices past the table go to an unexported sink
+    MetricsDetachMonitor(m3);
+    MonitorMetrics* far = MetricsAttachMonitor(r, METRICS_MAX_MONITORS + 2);
+    CHECK(far == &r.unattached);
+    MetricInc(far->framesRendered, 100);
+    SerializeMetrics(r, out);
+    CHECK(Contains(out, "desktoplut_monitors_active 1\n"));
+    CHECK(!Contains(out, "monitor=\"3\""));
+    CHECK(!Contains(out, " 100\n"));
+}
+
+static void HistogramText() {
+    MetricsRegistry r;
+    MonitorMetrics* m = MetricsAttachMonitor(r, 2);
+    MetricObserve(m->frameTimeMs, 3.0);
+    MetricObserve(m->frameTimeMs, 16.0);
+    MetricObserve(m->frameTimeMs, 2000.0);
+    MetricObserve(r.lutLoadMs, 12.0);
+
+    std::string out;
+    SerializeMetrics(r, out);
+    // Cumulative, labelled buckets
+    CHECK(Contains(out, "desktoplut_frame_time_ms_bucket{monitor=\"2\",le=\"4.2\"} 1\n"));
+    CHECK(Contains(out, "desktoplut_frame_time_ms_bucket{monitor=\"2\",le=\"16.8\"} 2\n"));
+    CHECK(Contains(out, "desktoplut_frame_time_ms_bucket{monitor=\"2\",le=\"1000\"} 2\n"));
+    CHECK(Contains(out, "desktoplut_frame_time_ms_bucket{monitor=\"2\",le=\"+Inf\"} 3\n"));
+    CHECK(Contains(out, "desktoplut_frame_time_ms_sum{monitor=\"2\"} 2019\n"));
+    CHECK(Contains(out, "desktoplut_frame_time_ms_count{monitor=\"2\"} 3\n"));
+    // Unlabelled histogram
+    CHECK(Contains(out, "desktoplut_lut_load_ms_bucket{le=\"5\"} 0\n"));
+    CHECK(Contains(out, "desktoplut_lut_load_ms_bucket{le=\"25\"} 1\n"));
+    CHECK(Contains(out, "desktoplut_lut_load_ms_count 1\n"));
+
+    // Every sample line is "name[{labels}] value"
+    int malformed = 0;
+    size_t start = 0;
+    while (start < out.size()) {
+        size_t end = out.find('\n', start);
+        std::string line = out.substr(start, end - start);
+        start = end + 1;
+        if (line.empty() || line[0] == '#') continue;
+        size_t space = line.rfind(' ');
+        size_t brace = line.find('{');
+        if (space == std::string::npos || space + 1 >= line.size()) malformed++;
+        if (brace != std::string::npos && line.find('}') != space - 1) malformed++;
+    }
+    CHECK_EQ(malformed, 0);
+}
+
+static void ConcurrentUpdates() {
+    MetricsRegistry r;
+    MonitorMetrics* m = MetricsAttachMonitor(r, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([m, &r] {
+            for (int i = 0; i < 10000; i++) {
+                MetricInc(m->framesRendered);
+                MetricObserve(m->frameTimeMs, 16.0);
+                MetricInc(r.watchdogTrips);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    CHECK_EQ(m->framesRendered.value.load(), 40000u);
+    CHECK_EQ(r.watchdogTrips.value.load(), 40000u);
+    CHECK_EQ(m->frameTimeMs.buckets[4].load(), 40000u);
+    CHECK_NEAR(m->frameTimeMs.sum.load(), 640000.0, 1e-6);
+}
+
+static void SerializeReusesCapacity() {
+    MetricsRegistry r;
+    for (int i = 0; i < 8; i++) MetricsAttachMonitor(r, i);
+    std::string out;
+    SerializeMetrics(r, out);
+    size_t capacity = out.capacity();
+    const char* data = out.data();
+    SerializeMetrics(r, out);
+    CHECK_EQ(out.capacity(), capacity);
+    CHECK(out.data() == data);
+}
+
+int main() {
+    RUN_TEST(HistogramBuckets);
+    RUN_TEST(SerializesActiveMonitorsOnly);
+    RUN_TEST(HistogramText);
+    RUN_TEST(ConcurrentUpdates);
+    RUN_TEST(SerializeReusesCapacity);
+    return CheckExitCode();
+}
@@ -0,0 +1,137 @@
+// DesktopLUT - tests/test_metricsserver.cpp
+// Metrics endpoint over a loopback client: responses, and stopping with stalled clients connected
+
+#include "netsocket.h"
+
+#include "check.h"
+#include "metrics.h"
+#include "metricsserver.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+// Ephemeral-range ports; the first free one is used
+static const int PORTS[] = { 49731, 49757, 50123, 51871 };
+static int g_port = 0;
+
+static MetricsRegistry g_registry;
+
+static bool StartOnFreePort() {
+    for (int port : PORTS) {
+        if (StartMetricsServer(port, g_registry)) {
+            g_port = port;
+            return true;
+        }
+    }
+    return false;
+}
+
+static SOCKET Connect() {
+    SOCKET s = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons((uint16_t)g_port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(s, (sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR) {
+        closesocket(s);
+        return INVALID_SOCKET;
+    }
+    NetSetTimeouts(s, 5000, 5000);
+    return s;
+}
+
+// Send a request, read until the server closes
+static std::string Request(const char* request) {
+    SOCKET s = Connect();
+    if (s == INVALID_SOCKET) return "";
+    send(s, request, (int)strlen(request), NET_SEND_FLAGS);
+    std::string response;
+    char buf[4096];
+    int n;
+    while ((n = (int)recv(s, buf, sizeof(buf), 0)) > 0) response.append(buf, n);
+    closesocket(s);
+    return response;
+}
+
+static void ServesMetrics() {
+    MonitorMetrics* m = MetricsAttachMonitor(g_registry, 1);
+    MetricInc(m->framesRendered, 42);
+
+    std::string r = Request("GET /metrics HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n");
+    CHECK(r.rfind("HTTP/1.0 200 OK\r\n", 0) == 0);
+    CHECK(r.find("desktoplut_frames_rendered_total{monitor=\"1\"} 42\n") != std::string::npos);
+
+    // Content-Length matches the body
+    size_t headerEnd = r.find("\r\n\r\n");
+    size_t lengthAt = r.find("Content-Length: ");
+    CHECK(headerEnd != std::string::npos && lengthAt != std::string::npos);
+    if (headerEnd != std::string::npos && lengthAt != std::string::npos) {
+        CHECK_EQ(strtoull(r.c_str() + lengthAt + 16, nullptr, 10), r.size() - headerEnd - 4);
+    }
+
+    // Counter updates show up in the next scrape
+    MetricInc(m->framesRendered);
+    r = Request("GET / HTTP/1.0\r\n\r\n");
+    CHECK(r.find("desktoplut_frames_rendered_total{monitor=\"1\"} 43\n") != std::string::npos);
+}
+
+static void HeadAndOtherMethods() {
+    std::string head = Request("HEAD /metrics HTTP/1.1\r\n\r\n");
+    CHECK(head.rfind("HTTP/1.0 200 OK\r\n", 0) == 0);
+    CHECK(head.size() == head.find("\r\n\r\n") + 4);    // Headers only
+
+    std::string post = Request("POST /metrics HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+    CHECK(post.rfind("HTTP/1.0 405", 0) == 0);
+}
+
+// A client that connects and never sends holds the server thread in recv; stopping must not wait on it
+static void StopWithStalledClient() {
+    SOCKET idle = Connect();
+    CHECK(idle != INVALID_SOCKET);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));     // Let the server accept it
+
+    Clock::time_point start = Clock::now();
+    StopMetricsServer();
+    double stopMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    CHECK(stopMs < 1500.0);
+    if (idle != INVALID_SOCKET) closesocket(idle);
+
+    // Restartable afterwards
+    CHECK(StartOnFreePort());
+    CHECK(Request("GET / HTTP/1.0\r\n\r\n").rfind("HTTP/1.0 200", 0) == 0);
+}
+
+// A client that sends its request but never reads the response or closes: the send timeout
+// (or the stop flag) releases the server
+static void StopWithNonReadingClient() {
+    for (int i = 0; i < METRICS_MAX_MONITORS; i++) MetricsAttachMonitor(g_registry, i);
+    SOCKET reader = Connect();
+    CHECK(reader != INVALID_SOCKET);
+    const char* get = "GET / HTTP/1.0\r\n\r\n";
+    send(reader, get, (int)strlen(get), NET_SEND_FLAGS);
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    Clock::time_point start = Clock::now();
+    StopMetricsServer();
+    double stopMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    CHECK(stopMs < 1500.0);
+    if (reader != INVALID_SOCKET) closesocket(reader);
+}
+
+int main() {
+    if (!NetStartup()) return 1;
+    CHECK(StartOnFreePort());
+    RUN_TEST(ServesMetrics);
+    RUN_TEST(HeadAndOtherMethods);
+    RUN_TEST(StopWithStalledClient);
+    RUN_TEST(StopWithNonReadingClient);
+    StopMetricsServer();
+    NetCleanup();
+    return CheckExitCode();
+}
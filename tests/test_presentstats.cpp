@@ -0,0 +1,166 @@
+// DesktopLUT - tests/test_presentstats.cpp
+// Present statistics on synthetic present/vblank histories: every present in a batch classified
+
+#include "check.h"
+#include "presentstats.h"
+
+// 62.5 Hz so vblank times are exact: vblank k at k * 16 ms
+static const double PERIOD = 16.0;
+
+// refreshBase is the vblank at time 0 (counters needn't start there)
+static PresentStatsSample Sample(uint32_t presentCount, uint32_t presentRefresh, uint32_t syncRefresh, uint32_t refreshBase = 0) {
+    return PresentStatsSample{ presentCount, presentRefresh, syncRefresh, (double)(int32_t)(syncRefresh - refreshBase) * PERIOD };
+}
+
+static uint64_t BucketTotal(const PresentAccounting& acc) {
+    uint64_t total = 0;
+    for (uint64_t b : acc.latencyBuckets) total += b;
+    return total;
+}
+
+// One present per refresh, each shown two vblanks after it was issued
+static void SteadyStream(uint32_t firstId, uint32_t firstRefresh) {
+    PresentAccounting acc;
+    PresentStatsOnPresent(acc, firstId, 2.0);
+    PresentStatsOnSample(acc, Sample(firstId, firstRefresh + 2, firstRefresh + 2, firstRefresh), PERIOD);
+    for (uint32_t i = 1; i <= 100; i++) {
+        PresentStatsOnPresent(acc, firstId + i, 16.0 * i + 2.0);
+        PresentStatsOnSample(acc, Sample(firstId + i, firstRefresh + i + 2, firstRefresh + i + 2, firstRefresh), PERIOD);
+    }
+    CHECK_EQ(acc.displayed, 100u);
+    CHECK_EQ(acc.late, 0u);
+    CHECK_EQ(acc.duplicates, 0u);
+    CHECK_EQ(acc.latencyBuckets[1], 100u);
+    float avgMs, maxMs;
+    PresentStatsLatency(acc, avgMs, maxMs);
+    CHECK_NEAR(avgMs, 30.0, 1e-3);
+    CHECK_NEAR(maxMs, 30.0, 1e-3);
+}
+
+static void SteadyOnTime() {
+    SteadyStream(1, 0);
+    SteadyStream(0xFFFFFFC0u, 0xFFFFFFD0u);   // Both counters wrap mid-stream
+}
+
+// The display stalls with four presents queued; one sample then reports the newest
+static void BackedUpQueueAllLate() {
+    PresentAccounting acc;
+    PresentStatsOnPresent(acc, 1, 2.0);
+    PresentStatsOnSample(acc, Sample(1, 2, 2), PERIOD);
+    for (uint32_t i = 2; i <= 5; i++) {
+        PresentStatsOnPresent(acc, i, 16.0 * (i - 1) + 2.0);
+        PresentStatsOnSample(acc, Sample(1, 2, i + 1), PERIOD);   // Nothing new shown yet
+    }
+    // Shown on vblanks 9, 10, 11, 12: each waited behind the one before
+    PresentStatsOnSample(acc, Sample(5, 12, 13), PERIOD);
+
+    CHECK_EQ(acc.displayed, 4u);
+    CHECK_EQ(acc.late, 4u);
+    CHECK_EQ(acc.duplicates, 0u);
+    CHECK_EQ(acc.latencyBuckets[3], 4u);
+    CHECK_EQ(acc.missedRefreshes, 24u);    // 126 ms = 7.875 refreshes each, 5.875 over budget
+    float avgMs, maxMs;
+    PresentStatsLatency(acc, avgMs, maxMs);
+    CHECK_NEAR(avgMs, 126.0, 1e-3);
+}
+
+// A batch whose newest present was on time leaves its predecessors where the budget puts them
+static void OnTimeBatch() {
+    PresentAccounting acc;
+    PresentStatsOnPresent(acc, 1, 2.0);
+    PresentStatsOnSample(acc, Sample(1, 2, 2), PERIOD);
+    PresentStatsOnPresent(acc, 2, 18.0);
+    PresentStatsOnPresent(acc, 3, 34.0);
+    PresentStatsOnSample(acc, Sample(3, 4, 4), PERIOD);
+    CHECK_EQ(acc.displayed, 2u);
+    CHECK_EQ(acc.late, 0u);
+    CHECK_EQ(acc.latencyBuckets[1], 2u);
+
+    // Predecessor issued long before: placed on its own vblank, not the one before the newest
+    PresentStatsOnPresent(acc, 4, 50.0);
+    PresentStatsOnPresent(acc, 5, 130.0);
+    PresentStatsOnSample(acc, Sample(5, 10, 10), PERIOD);
+    CHECK_EQ(acc.displayed, 4u);
+    CHECK_EQ(acc.late, 0u);
+    float avgMs, maxMs;
+    PresentStatsLatency(acc, avgMs, maxMs);
+    CHECK_NEAR(maxMs, 30.0, 1e-3);
+}
+
+// A late present among on-time ones: it and everything queued before it in the batch is late
+static void LateTailOfBatch() {
+    PresentAccounting acc;
+    PresentStatsOnPresent(acc, 1, 2.0);
+    PresentStatsOnSample(acc, Sample(1, 2, 2), PERIOD);
+    PresentStatsOnPresent(acc, 2, 18.0);
+    PresentStatsOnPresent(acc, 3, 34.0);
+    PresentStatsOnPresent(acc, 4, 50.0);
+    // Newest shown on vblank 8 (78 ms, ~4.9 refreshes); 3 and 2 on 7 and 6
+    PresentStatsOnSample(acc, Sample(4, 8, 9), PERIOD);
+    CHECK_EQ(acc.displayed, 3u);
+    CHECK_EQ(acc.late, 3u);
+    CHECK_EQ(acc.missedRefreshes, 9u);
+}
+
+// More presents than refreshes: the excess was overwritten unseen, the rest classified
+static void DuplicatesInBatch() {
+    PresentAccounting acc;
+    PresentStatsOnPresent(acc, 1, 2.0);
+    PresentStatsOnSample(acc, Sample(1, 2, 2), PERIOD);
+    for (uint32_t i = 2; i <= 5; i++) PresentStatsOnPresent(acc, i, 16.0 + 2.0 * i);
+    PresentStatsOnSample(acc, Sample(5, 4, 4), PERIOD);
+    CHECK_EQ(acc.duplicates, 2u);
+    CHECK_EQ(acc.displayed, 2u);
+    CHECK_EQ(acc.late, 0u);
+    CHECK_EQ(acc.latencyCount, 2);
+    CHECK_EQ(BucketTotal(acc), 2u);
+
+    // Same-vblank report of a newer present counts once
+    PresentStatsOnPresent(acc, 6, 40.0);
+    PresentStatsOnSample(acc, Sample(6, 4, 4), PERIOD);
+    CHECK_EQ(acc.displayed, 3u);
+}
+
+// A batch longer than the history: only the presents still remembered are classified
+static void BatchLongerThanHistory() {
+    PresentAccounting acc;
+    PresentStatsOnPresent(acc, 1, 2.0);
+    PresentStatsOnSample(acc, Sample(1, 2, 2), PERIOD);
+    for (uint32_t i = 2; i <= 101; i++) PresentStatsOnPresent(acc, i, 16.0 * (i - 1) + 2.0);
+    PresentStatsOnSample(acc, Sample(101, 102, 102), PERIOD);
+    CHECK_EQ(acc.displayed, 100u);
+    CHECK_EQ(acc.late, 0u);
+    CHECK_EQ(BucketTotal(acc), (uint64_t)PRESENT_HISTORY_SIZE);
+    CHECK_EQ(acc.latencyBuckets[1], (uint64_t)PRESENT_HISTORY_SIZE);
+}
+
+static void ResetRebaselines() {
+    PresentAccounting acc;
+    PresentStatsOnPresent(acc, 1, 2.0);
+    PresentStatsOnSample(acc, Sample(1, 2, 2), PERIOD);
+    PresentStatsOnPresent(acc, 2, 18.0);
+    PresentStatsReset(acc);
+    PresentStatsOnSample(acc, Sample(2, 40, 40), PERIOD);   // Baseline only, however far it jumped
+    CHECK_EQ(acc.displayed, 0u);
+    CHECK_EQ(acc.late, 0u);
+    PresentStatsOnPresent(acc, 3, 16.0 * 39 + 2.0);
+    PresentStatsOnSample(acc, Sample(3, 41, 41), PERIOD);
+    CHECK_EQ(acc.displayed, 1u);
+    CHECK_EQ(acc.late, 0u);
+
+    // No refresh period yet: ignored entirely
+    PresentStatsOnPresent(acc, 4, 16.0 * 40 + 2.0);
+    PresentStatsOnSample(acc, Sample(4, 42, 42), 0.0);
+    CHECK_EQ(acc.displayed, 1u);
+}
+
+int main() {
+    RUN_TEST(SteadyOnTime);
+    RUN_TEST(BackedUpQueueAllLate);
+    RUN_TEST(OnTimeBatch);
+    RUN_TEST(LateTailOfBatch);
+    RUN_TEST(DuplicatesInBatch);
+    RUN_TEST(BatchLongerThanHistory);
+    RUN_TEST(ResetRebaselines);
+    return CheckExitCode();
+}
@@ -0,0 +1,100 @@
+#!/usr/bin/env python3
+"""
+Checks tools/query_analysis.py against a ring written by the C++ writer.
+
+Usage (ctest runs this when Python 3 is found):
+    python test_query_analysis.py path/to/test_analysisring
+
+test_analysisring --write <file> appends 13 records to an 8-record ring, so the reader must
+return records 5..12 oldest first. Record n: monitor n % 2, HDR when n is odd, peak 100 + 10n nits,
+average 20 + n nits, clip-white share n / 10000, timestamps 500 ms apart.
+"""
+
+import os
+import subprocess
+import sys
+import tempfile
+import unittest
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "tools"))
+import query_analysis  # noqa: E402
+
+WRITER = None
+BASE_MS = 1792195200000
+
+class QueryAnalysisTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.dir = tempfile.TemporaryDirectory()
+        cls.ring = os.path.join(cls.dir.name, "sample.ring")
+        subprocess.run([WRITER, "--write", cls.ring], check=True)
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.dir.cleanup()
+
+    def query(self, *args):
+        script = os.path.join(os.path.dirname(query_analysis.__file__), "query_analysis.py")
+        return subprocess.run([sys.executable, script, self.ring, *args], capture_output=True, text=True)
+
+    def test_records_oldest_first_after_wrap(self):
+        records = query_analysis.read_records(self.ring)
+        self.assertEqual([r["time_ms"] for r in records], [BASE_MS + n * 500 for n in range(5, 13)])
+        for n, r in zip(range(5, 13), records):
+            self.assertEqual(r["monitor"], n % 2)
+            self.assertEqual(r["hdr"], n % 2 == 1)
+            self.assertAlmostEqual(r["peak_nits"], 100.0 + 10 * n, places=3)
+            self.assertAlmostEqual(r["avg_nits"], 20.0 + n, places=3)
+            self.assertAlmostEqual(r["frame_max_ms"], 20.0 + n, places=3)
+            self.assertAlmostEqual(r["fps"], 60.0, places=3)
+            self.assertAlmostEqual(r["shares"][0], 0.9)
+            self.assertAlmostEqual(r["shares"][5], n / 10000.0)
+            self.assertAlmostEqual(r["histogram"][0], 0.8)
+
+    def test_rejects_other_files(self):
+        bad = os.path.join(self.dir.name, "bad.ring")
+        with open(bad, "wb") as f:
+            f.write(b"\0" * 128)
+        with self.assertRaises(ValueError):
+            query_analysis.read_records(bad)
+        result = subprocess.run([sys.executable, os.path.join(os.path.dirname(query_analysis.__file__),
+                                 "query_analysis.py"), bad], capture_output=True, text=True)
+        self.assertEqual(result.returncode, 2)
+
+    def test_summary(self):
+        result = self.query()
+        self.assertEqual(result.returncode, 0, result.stderr)
+        self.assertIn("Records:   8", result.stdout)
+        self.assertIn("MaxCLL:    220 nits   MaxFALL: 32.0 nits", result.stdout)
+        self.assertIn("HDR:       50.0% of samples", result.stdout)
+
+    def test_filters(self):
+        # Monitor 1 = odd records 5, 7, 9, 11
+        result = self.query("--monitor", "1", "--csv")
+        self.assertEqual(result.returncode, 0, result.stderr)
+        rows = result.stdout.strip().splitlines()[1:]
+        self.assertEqual([row.split(",")[3] for row in rows], ["150.0", "170.0", "190.0", "210.0"])
+
+        # Last 1.5 s before the newest record: records 9..12
+        result = self.query("--last", "1.5s", "--csv")
+        self.assertEqual(len(result.stdout.strip().splitlines()) - 1, 4)
+
+        result = self.query("--monitor", "5")
+        self.assertEqual(result.returncode, 1)
+
+    def test_helpers(self):
+        self.assertEqual(query_analysis.parse_duration("90s"), 90000)
+        self.assertEqual(query_analysis.parse_duration("2h"), 7200000)
+        self.assertEqual(query_analysis.parse_duration("1.5"), 1500)
+        values = list(range(1, 101))
+        self.assertEqual(query_analysis.percentile(values, 50), 50)
+        self.assertEqual(query_analysis.percentile(values, 99), 99)
+        self.assertEqual(query_analysis.percentile(values, 99.9), 100)
+        self.assertEqual(query_analysis.percentile([], 50), 0.0)
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print(__doc__, file=sys.stderr)
+        sys.exit(2)
+    WRITER = sys.argv.pop(1)
+    unittest.main()
@@ -0,0 +1,300 @@
+// DesktopLUT - tests/test_readback.cpp
+// Readback rings against a mock GPU whose copies finish a set number of frames after they are
+// queued: latency, ordering, idle polls, dropped requests, busy polls, map failures, release
+
+#include "check.h"
+#include "readback.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+// Staging resources are ints; a copy lands `gpuDelay` frames after it was queued
+struct MockGpu {
+    ReadbackManager* m = nullptr;
+    uint64_t gpuDelay = 0;
+    std::map<void*, uint64_t> doneAt;
+    bool failCreate = false;
+    bool failMap = false;
+    int created = 0;
+    int released = 0;
+    int mapped = 0;
+    int unmapped = 0;
+    std::vector<ReadbackDesc> descs;
+
+    void Attach(ReadbackManager& manager) {
+        m = &manager;
+        m->ops.create = [this](const ReadbackDesc& desc) -> void* {
+            if (failCreate) return nullptr;
+            created++;
+            descs.push_back(desc);
+            return new int(0);
+        };
+        m->ops.release = [this](void* staging) {
+            released++;
+            delete static_cast<int*>(staging);
+        };
+        m->ops.copy = [this](void* staging, void* source) {
+            *static_cast<int*>(staging) = *static_cast<int*>(source);
+            doneAt[staging] = m->frame + gpuDelay;
+        };
+        m->ops.map = [this](void* staging, const void** data) {
+            if (failMap) return READBACK_MAP_FAILED;
+            if (m->frame < doneAt[staging]) return READBACK_MAP_BUSY;
+            mapped++;
+            *data = staging;
+            return READBACK_MAP_READY;
+        };
+        m->ops.unmap = [this](void*) { unmapped++; };
+    }
+};
+
+struct Delivery {
+    int value;
+    uint64_t frame;      // Frame the copy was queued on
+    uint64_t at;         // Frame it was delivered on
+};
+
+static int AddRing(ReadbackManager& m, std::vector<Delivery>& out, int slots = 2, uint32_t latency = 2) {
+    ReadbackDesc desc;
+    desc.bytes = 64;
+    return AddReadbackRing(m, "test", desc, slots, latency, [&m, &out](const void* data, uint64_t frame) {
+        out.push_back({ *static_cast<const int*>(data), frame, m.frame });
+    });
+}
+
+// A request on frame 0 is delivered on the poll of frame `latency` when the GPU is quick
+static void DeliveredAfterLatency() {
+    for (uint32_t latency : { 0u, 1u, 2u, 3u }) {
+        ReadbackManager m;
+        MockGpu gpu;
+        gpu.Attach(m);
+        std::vector<Delivery> got;
+        int ring = AddRing(m, got, 2, latency);
+        int value = 7;
+        CHECK(RequestReadback(m, ring, &value));
+        CHECK_EQ(PendingReadbacks(m, ring), 1);
+        for (int f = 0; f < 6; f++) {
+            PollReadbacks(m);
+            AdvanceReadbackFrame(m);
+        }
+        CHECK_EQ(got.size(), 1u);
+        if (got.size() == 1) {
+            CHECK_EQ(got[0].value, 7);
+            CHECK_EQ(got[0].frame, 0u);
+            CHECK_EQ(got[0].at, (uint64_t)latency);
+        }
+        CHECK_EQ(m.rings[ring].busyPolls, 0u);
+        CHECK_EQ(gpu.unmapped, gpu.mapped);
+        ReleaseReadbacks(m);
+    }
+}
+
+// A steady request stream against slow and fast GPUs: oldest first, each copy's own data,
+// no more staging than slots, and busy copies polled again instead of waited on
+static void SteadyStream() {
+    for (uint64_t gpuDelay : { 0u, 2u, 4u }) {
+        ReadbackManager m;
+        MockGpu gpu;
+        gpu.gpuDelay = gpuDelay;
+        gpu.Attach(m);
+        std::vector<Delivery> got;
+        int ring = AddRing(m, got, 2, 2);
+        int source = 0;
+        for (int f = 0; f < 60; f++) {
+            if (f % 3 == 0) {
+                source = f;
+                RequestReadback(m, ring, &source);
+            }
+            PollReadbacks(m);
+            AdvanceReadbackFrame(m);
+        }
+        const ReadbackRing& r = m.rings[ring];
+        CHECK_EQ(r.requested, 20u);
+        CHECK_EQ(r.delivered + r.dropped + (uint64_t)PendingReadbacks(m, ring), r.requested);
+        CHECK(gpu.created <= 2);
+        int misordered = 0;
+        for (size_t i = 0; i < got.size(); i++) {
+            if (got[i].value != (int)got[i].frame) misordered++;
+            if (i > 0 && got[i].frame <= got[i - 1].frame) misordered++;
+            if (got[i].at < got[i].frame + (std::max)((uint64_t)2, gpuDelay)) misordered++;
+        }
+        CHECK_EQ(misordered, 0);
+        if (gpuDelay <= 2) {
+            CHECK_EQ(r.dropped, 0u);
+            CHECK_EQ(r.busyPolls, 0u);
+        } else {
+            CHECK(r.busyPolls > 0);
+        }
+
+        ReleaseReadbacks(m);
+        CHECK_EQ(gpu.released, gpu.created);
+        CHECK_EQ(PendingReadbacks(m, ring), 0);
+    }
+}
+
+// Static desktop: no frames advance, idle polls still deliver once the GPU is done (never waiting)
+static void IdlePollsDeliver() {
+    ReadbackManager m;
+    MockGpu gpu;
+    gpu.Attach(m);
+    std::vector<Delivery> got;
+    int ring = AddRing(m, got, 2, 2);
+    int a = 1, b = 2;
+    RequestReadback(m, ring, &a);
+    RequestReadback(m, ring, &b);
+    PollReadbacks(m);
+    CHECK_EQ(got.size(), 0u);     // Frame polls keep the latency
+
+    PollIdleReadbacks(m);
+    CHECK_EQ(got.size(), 2u);
+    if (got.size() == 2) {
+        CHECK_EQ(got[0].value, 1);
+        CHECK_EQ(got[1].value, 2);
+    }
+    CHECK_EQ(PendingReadbacks(m, ring), 0);
+
+    // Copy still in flight: counted as a busy poll and retried on the next idle pass
+    gpu.gpuDelay = 3;
+    RequestReadback(m, ring, &a);
+    PollIdleReadbacks(m);
+    CHECK_EQ(got.size(), 2u);
+    CHECK_EQ(m.rings[ring].busyPolls, 1u);
+    CHECK_EQ(PendingReadbacks(m, ring), 1);
+    for (auto& done : gpu.doneAt) done.second = 0;
+    PollIdleReadbacks(m);
+    CHECK_EQ(got.size(), 3u);
+    CHECK_EQ(PendingReadbacks(m, ring), 0);
+    ReleaseReadbacks(m);
+}
+
+static void FullRingDrops() {
+    ReadbackManager m;
+    MockGpu gpu;
+    gpu.Attach(m);
+    std::vector<Delivery> got;
+    int ring = AddRing(m, got, 2, 2);
+    int value = 1;
+    CHECK(RequestReadback(m, ring, &value));
+    CHECK(RequestReadback(m, ring, &value));
+    CHECK(!RequestReadback(m, ring, &value));
+    CHECK_EQ(m.rings[ring].dropped, 1u);
+    CHECK_EQ(m.rings[ring].requested, 3u);
+    CHECK_EQ(gpu.created, 2);
+
+    // Both slots free up together once old enough; the next request reuses staging
+    m.frame += 2;
+    PollReadbacks(m);
+    CHECK_EQ(got.size(), 2u);
+    CHECK(RequestReadback(m, ring, &value));
+    CHECK_EQ(gpu.created, 2);
+    ReleaseReadbacks(m);
+}
+
+// Rings are independent: a busy copy in one doesn't hold up another
+static void IndependentRings() {
+    ReadbackManager m;
+    MockGpu gpu;
+    gpu.Attach(m);
+    std::vector<Delivery> slow, fast;
+    int slowRing = AddRing(m, slow, 1, 4);
+    int fastRing = AddRing(m, fast, 3, 1);
+    int a = 10, b = 20;
+    RequestReadback(m, slowRing, &a);
+    RequestReadback(m, fastRing, &b);
+    AdvanceReadbackFrame(m);
+    PollReadbacks(m);
+    CHECK_EQ(fast.size(), 1u);
+    CHECK_EQ(slow.size(), 0u);
+    m.frame = 4;
+    PollReadbacks(m);
+    CHECK_EQ(slow.size(), 1u);
+    if (slow.size() == 1) CHECK_EQ(slow[0].value, 10);
+    ReleaseReadbacks(m);
+}
+
+static void Failures() {
+    ReadbackManager m;
+    MockGpu gpu;
+    gpu.Attach(m);
+    std::vector<Delivery> got;
+    int ring = AddRing(m, got, 2, 2);
+    int value = 3;
+
+    // Staging creation failure: counted, nothing queued
+    gpu.failCreate = true;
+    CHECK(!RequestReadback(m, ring, &value));
+    CHECK_EQ(m.rings[ring].failed, 1u);
+    CHECK_EQ(PendingReadbacks(m, ring), 0);
+    gpu.failCreate = false;
+
+    // Map failure frees the slot without delivering or unmapping
+    RequestReadback(m, ring, &value);
+    RequestReadback(m, ring, &value);
+    gpu.failMap = true;
+    m.frame += 5;
+    PollReadbacks(m);
+    CHECK_EQ(PendingReadbacks(m, ring), 0);
+    CHECK_EQ(m.rings[ring].failed, 3u);
+    CHECK_EQ(got.size(), 0u);
+    CHECK_EQ(gpu.unmapped, 0);
+
+    // Bad arguments
+    CHECK(!RequestReadback(m, ring, nullptr));
+    CHECK(!RequestReadback(m, 5, &value));
+    CHECK(!RequestReadback(m, -1, &value));
+    CHECK_EQ(PendingReadbacks(m, 5), 0);
+    ReleaseReadbacks(m);
+}
+
+// Device loss: in-flight copies are abandoned, staging recreated on the next request
+static void ReleaseAndRecreate() {
+    ReadbackManager m;
+    MockGpu gpu;
+    gpu.Attach(m);
+    std::vector<Delivery> got;
+    ReadbackDesc texture;
+    texture.width = 16;
+    texture.height = 8;
+    texture.format = 10;
+    int ring = AddReadbackRing(m, "texture", texture, 2, 2, [&got](const void* data, uint64_t frame) {
+        got.push_back({ *static_cast<const int*>(data), frame, 0 });
+    });
+    int value = 5;
+    RequestReadback(m, ring, &value);
+    ReleaseReadbacks(m);
+    CHECK_EQ(gpu.released, 1);
+    CHECK_EQ(PendingReadbacks(m, ring), 0);
+    m.frame += 10;
+    PollReadbacks(m);
+    CHECK_EQ(got.size(), 0u);
+
+    CHECK(RequestReadback(m, ring, &value));
+    CHECK_EQ(gpu.created, 2);
+    CHECK_EQ(gpu.descs.back().width, 16u);
+    CHECK_EQ(gpu.descs.back().format, 10u);
+    ReleaseReadbacks(m);
+    ReleaseReadbacks(m);                    // Idempotent
+    CHECK_EQ(gpu.released, 2);
+
+    // Zero slots still gets one
+    int one = AddReadbackRing(m, "one", texture, 0, 1, nullptr);
+    CHECK_EQ(m.rings[one].slots.size(), 1u);
+    CHECK(RequestReadback(m, one, &value));
+    m.frame += 1;
+    PollReadbacks(m);                       // No callback: still completes
+    CHECK_EQ(m.rings[one].delivered, 1u);
+    ReleaseReadbacks(m);
+}
+
+int main() {
+    RUN_TEST(DeliveredAfterLatency);
+    RUN_TEST(SteadyStream);
+    RUN_TEST(IdlePollsDeliver);
+    RUN_TEST(FullRingDrops);
+    RUN_TEST(IndependentRings);
+    RUN_TEST(Failures);
+    RUN_TEST(ReleaseAndRecreate);
+    return CheckExitCode();
+}
@@ -0,0 +1,182 @@
+// DesktopLUT - tests/test_scopes.cpp
+// Scope binning: sample grids, waveform / vectorscope / CIE bin placement, out-of-range input, normalization
+
+#include "check.h"
+#include "scopes.h"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+static uint32_t WaveformBin(int row, int col) { return SCOPE_WAVEFORM_OFFSET + row * SCOPE_WAVEFORM_WIDTH + col; }
+static uint32_t VectorBin(int row, int col) { return SCOPE_VECTOR_OFFSET + row * SCOPE_VECTOR_SIZE + col; }
+static uint32_t CIEBin(int row, int col) { return SCOPE_CIE_OFFSET + row * SCOPE_CIE_SIZE + col; }
+
+static uint64_t Total(const std::vector<uint32_t>& bins, int offset, int count) {
+    uint64_t total = 0;
+    for (int i = offset; i < offset + count; i++) total += bins[i];
+    return total;
+}
+
+// One pixel into fresh bins
+static std::vector<uint32_t> BinOne(float r, float g, float b, uint32_t px = 0, uint32_t width = 1920, bool isHDR = false) {
+    std::vector<uint32_t> bins(SCOPE_BIN_COUNT, 0);
+    ScopeBinPixel(r, g, b, px, width, isHDR, bins.data());
+    return bins;
+}
+
+static void SampleGrid() {
+    ScopeGrid g = ScopeSampleGrid(3840, 2160);
+    CHECK_EQ(g.x, 241u);     // sqrt(32768 * 16/9)
+    CHECK_EQ(g.y, 135u);     // sqrt(32768 * 9/16)
+    CHECK(g.x * g.y <= SCOPE_TARGET_SAMPLES);
+
+    g = ScopeSampleGrid(2160, 3840);    // Portrait: swapped
+    CHECK_EQ(g.x, 135u);
+    CHECK_EQ(g.y, 241u);
+
+    // Never more than one sample per pixel
+    g = ScopeSampleGrid(64, 32);
+    CHECK_EQ(g.x, 64u);
+    CHECK_EQ(g.y, 32u);
+    g = ScopeSampleGrid(100000, 1);
+    CHECK_EQ(g.y, 1u);
+    CHECK(g.x <= 100000u);
+
+    g = ScopeSampleGrid(0, 1080);
+    CHECK_EQ(g.x, 1u);
+    CHECK_EQ(g.y, 1u);
+}
+
+static void WaveformPlacement() {
+    // Row 0 = full scale, columns follow frame x
+    CHECK_EQ(BinOne(1.0f, 1.0f, 1.0f)[WaveformBin(0, 0)], 1u);
+    CHECK_EQ(BinOne(0.0f, 0.0f, 0.0f)[WaveformBin(SCOPE_WAVEFORM_HEIGHT - 1, 0)], 1u);
+    CHECK_EQ(BinOne(0.5f, 0.5f, 0.5f, 1919)[WaveformBin(31, SCOPE_WAVEFORM_WIDTH - 1)], 1u);
+    CHECK_EQ(BinOne(0.5f, 0.5f, 0.5f, 960)[WaveformBin(31, SCOPE_WAVEFORM_WIDTH / 2)], 1u);
+
+    // HDR: PQ scale, 80 nits (scRGB 1.0) ~ 0.486 -> row 32; 10000 nits at the top
+    CHECK_EQ(BinOne(1.0f, 1.0f, 1.0f, 0, 1920, true)[WaveformBin(32, 0)], 1u);
+    CHECK_EQ(BinOne(125.0f, 125.0f, 125.0f, 0, 1920, true)[WaveformBin(0, 0)], 1u);
+}
+
+static void VectorscopePlacement() {
+    // Neutrals at the center, whatever the level
+    int center = SCOPE_VECTOR_SIZE / 2;
+    CHECK_EQ(BinOne(0.0f, 0.0f, 0.0f)[VectorBin(center - 1, center)], 1u);
+    CHECK_EQ(BinOne(0.7f, 0.7f, 0.7f)[VectorBin(center - 1, center)], 1u);
+    CHECK_EQ(BinOne(4.0f, 4.0f, 4.0f, 0, 1920, true)[VectorBin(center - 1, center)], 1u);
+
+    // Full blue reaches Cb = +0.5 (right edge), full red Cr = +0.5 (top edge)
+    std::vector<uint32_t> blue = BinOne(0.0f, 0.0f, 1.0f);
+    CHECK_EQ(blue[VectorBin(34, SCOPE_VECTOR_SIZE - 1)], 1u);     // Cr = -0.0722 / 1.5748
+    std::vector<uint32_t> red = BinOne(1.0f, 0.0f, 0.0f);
+    CHECK_EQ(red[VectorBin(0, 24)], 1u);                           // Cb = -0.2126 / 1.8556
+    // Green: both negative, lower left quadrant
+    std::vector<uint32_t> green = BinOne(0.0f, 1.0f, 0.0f);
+    uint64_t lowerLeft = 0;
+    for (int row = center; row < SCOPE_VECTOR_SIZE; row++)
+        for (int col = 0; col < center; col++) lowerLeft += green[VectorBin(row, col)];
+    CHECK_EQ(lowerLeft, 1u);
+}
+
+static void CIEPlacement() {
+    // D65 white: x 0.3127, y 0.3290
+    CHECK_EQ(BinOne(1.0f, 1.0f, 1.0f)[CIEBin(63 - 23, 25)], 1u);
+    // Chromaticity doesn't depend on level (above the floor)
+    CHECK_EQ(BinOne(0.2f, 0.2f, 0.2f)[CIEBin(63 - 23, 25)], 1u);
+    CHECK_EQ(BinOne(8.0f, 8.0f, 8.0f, 0, 1920, true)[CIEBin(63 - 23, 25)], 1u);
+
+    // Black and near-black carry no chromaticity
+    CHECK_EQ(Total(BinOne(0.0f, 0.0f, 0.0f), SCOPE_CIE_OFFSET, SCOPE_CIE_SIZE * SCOPE_CIE_SIZE), 0u);
+    CHECK_EQ(Total(BinOne(0.0005f, 0.0f, 0.0f, 0, 1920, true), SCOPE_CIE_OFFSET, SCOPE_CIE_SIZE * SCOPE_CIE_SIZE), 0u);
+
+    // scRGB negatives reach past the 709 green primary (y 0.60): this one is y ~0.647
+    std::vector<uint32_t> wide = BinOne(-0.1f, 1.0f, -0.05f, 0, 1920, true);
+    int rowAbove709Green = SCOPE_CIE_SIZE - 1 - (int)(0.60f / SCOPE_CIE_MAX_Y * SCOPE_CIE_SIZE);
+    uint64_t above = 0;
+    for (int row = 0; row < rowAbove709Green; row++)
+        for (int col = 0; col < SCOPE_CIE_SIZE; col++) above += wide[CIEBin(row, col)];
+    CHECK_EQ(above, 1u);
+}
+
+// Garbage input lands in edge bins; nothing is written outside the buffer
+static void OutOfRangeInput() {
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float values[][3] = {
+        { nan, nan, nan }, { inf, inf, inf }, { -inf, -inf, -inf }, { 1e30f, -1e30f, 0.0f },
+        { -5.0f, 2.0f, 40.0f }, { nan, 1.0f, 0.0f }, { 2.0f, 2.0f, 2.0f },
+    };
+    const int guard = 64;
+    std::vector<uint32_t> bins(SCOPE_BIN_COUNT + guard, 0);
+    int n = 0;
+    for (bool isHDR : { false, true }) {
+        for (const auto& v : values) {
+            ScopeBinPixel(v[0], v[1], v[2], 0, 16, isHDR, bins.data());
+            ScopeBinPixel(v[0], v[1], v[2], 15, 16, isHDR, bins.data());
+            n += 2;
+        }
+    }
+    CHECK_EQ(Total(bins, SCOPE_WAVEFORM_OFFSET, SCOPE_WAVEFORM_WIDTH * SCOPE_WAVEFORM_HEIGHT), (uint64_t)n);
+    CHECK_EQ(Total(bins, SCOPE_VECTOR_OFFSET, SCOPE_VECTOR_SIZE * SCOPE_VECTOR_SIZE), (uint64_t)n);
+    CHECK(Total(bins, SCOPE_CIE_OFFSET, SCOPE_CIE_SIZE * SCOPE_CIE_SIZE) <= (uint64_t)n);
+    CHECK_EQ(Total(bins, SCOPE_BIN_COUNT, guard), 0u);
+}
+
+static void AccumulateFrame() {
+    // Mid-grey frame with padded rows; the padding is NaN and must never be sampled
+    const uint32_t width = 1920, height = 1080;
+    const size_t stride = (size_t)width * 4 + 64;
+    std::vector<float> frame(stride * height, std::numeric_limits<float>::quiet_NaN());
+    for (uint32_t y = 0; y < height; y++)
+        for (uint32_t x = 0; x < width * 4; x++) frame[y * stride + x] = 0.5f;
+
+    std::vector<uint32_t> bins(SCOPE_BIN_COUNT, 0);
+    AccumulateScopes(frame.data(), width, height, stride, false, bins.data());
+    ScopeGrid g = ScopeSampleGrid(width, height);
+    uint64_t samples = (uint64_t)g.x * g.y;
+    CHECK_EQ(Total(bins, SCOPE_WAVEFORM_OFFSET, SCOPE_WAVEFORM_WIDTH * SCOPE_WAVEFORM_HEIGHT), samples);
+    // All on row 31, spread over every column
+    uint64_t row31 = 0;
+    int emptyColumns = 0;
+    for (int col = 0; col < SCOPE_WAVEFORM_WIDTH; col++) {
+        row31 += bins[WaveformBin(31, col)];
+        if (bins[WaveformBin(31, col)] == 0) emptyColumns++;
+    }
+    CHECK_EQ(row31, samples);
+    CHECK_EQ(emptyColumns, 0);
+    CHECK_EQ(bins[VectorBin(31, 32)], (uint32_t)samples);
+
+    // Accumulates rather than clearing
+    AccumulateScopes(frame.data(), width, height, stride, false, bins.data());
+    CHECK_EQ(bins[VectorBin(31, 32)], (uint32_t)(2 * samples));
+}
+
+static void Normalize() {
+    uint32_t bins[6] = { 0, 1, 10, 100, 1000, 0 };
+    uint8_t out[6];
+    NormalizeScopeBins(bins, 6, out);
+    CHECK_EQ(out[0], 0);
+    CHECK_EQ(out[5], 0);
+    CHECK_EQ(out[4], 255);
+    CHECK(out[1] >= 24);                       // Single hits stay visible
+    CHECK(out[1] < out[2] && out[2] < out[3] && out[3] < out[4]);
+    CHECK_NEAR(out[3], 255.0 * log(101.0) / log(1001.0), 1.0);
+
+    uint32_t empty[4] = {};
+    uint8_t outEmpty[4] = { 7, 7, 7, 7 };
+    NormalizeScopeBins(empty, 4, outEmpty);
+    CHECK(outEmpty[0] == 0 && outEmpty[3] == 0);
+}
+
+int main() {
+    RUN_TEST(SampleGrid);
+    RUN_TEST(WaveformPlacement);
+    RUN_TEST(VectorscopePlacement);
+    RUN_TEST(CIEPlacement);
+    RUN_TEST(OutOfRangeInput);
+    RUN_TEST(AccumulateFrame);
+    RUN_TEST(Normalize);
+    return CheckExitCode();
+}
@@ -0,0 +1,212 @@
+// DesktopLUT - tests/test_tiledpass.cpp
+// Tiled main pass: tile grids, partial edge tiles, per-tile records and their reduction against
+// whole-frame statistics, gamut classes, peak smoothing
+
+#include "check.h"
+#include "tiledpass.h"
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+static float Bits(uint32_t u) {
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+struct Frame {
+    uint32_t width, height;
+    size_t stride;                  // Floats per row
+    std::vector<float> rgba;
+
+    Frame(uint32_t w, uint32_t h, size_t padding = 0)
+        : width(w), height(h), stride((size_t)w * 4 + padding), rgba(stride * h, 0.0f) {}
+    float* At(uint32_t x, uint32_t y) { return rgba.data() + y * stride + (size_t)x * 4; }
+    void Set(uint32_t x, uint32_t y, float r, float g, float b) {
+        float* p = At(x, y);
+        p[0] = r; p[1] = g; p[2] = b; p[3] = 1.0f;
+    }
+};
+
+static float Nits(const float* p) { return (0.2126f * p[0] + 0.7152f * p[1] + 0.0722f * p[2]) * 80.0f; }
+
+static std::vector<uint32_t> TileRecords(Frame& f, uint32_t tileSize, bool isHDR, bool collectAnalysis) {
+    TileGrid grid = MainPassTileGrid(f.width, f.height, tileSize);
+    std::vector<uint32_t> records((size_t)grid.Count() * TILE_STAT_UINTS, 0xCDCDCDCDu);
+    ComputeTileStats(f.rgba.data(), f.width, f.height, f.stride, tileSize, isHDR, collectAnalysis, records.data());
+    return records;
+}
+
+static void Grid() {
+    TileGrid g = MainPassTileGrid(1920, 1080);
+    CHECK_EQ(g.x, 120u);
+    CHECK_EQ(g.y, 68u);            // 67.5: partial bottom row
+    g = MainPassTileGrid(1920, 1080, 8);
+    CHECK_EQ(g.x, 240u);
+    CHECK_EQ(g.y, 135u);
+    g = MainPassTileGrid(3840, 2160);
+    CHECK_EQ(g.Count(), 240u * 135u);
+    g = MainPassTileGrid(1, 1);
+    CHECK_EQ(g.Count(), 1u);
+    g = MainPassTileGrid(17, 16);
+    CHECK_EQ(g.x, 2u);
+    CHECK_EQ(g.y, 1u);
+    CHECK_EQ(MainPassTileGrid(1920, 1080, 0).Count(), 0u);
+    CHECK_EQ(MainPassTileGrid(0, 1080).Count(), 0u);
+}
+
+static void EveryPixelOnce() {
+    const uint32_t sizes[][2] = { { 37, 21 }, { 16, 16 }, { 1, 50 }, { 64, 3 } };
+    for (const auto& s : sizes) {
+        for (uint32_t tile : { 8u, 16u }) {
+            std::vector<int> visits(s[0] * s[1], 0);
+            int badTile = 0;
+            ForEachTilePixel(s[0], s[1], tile, [&](uint32_t tx, uint32_t ty, uint32_t x, uint32_t y) {
+                visits[y * s[0] + x]++;
+                if (tx != x / tile || ty != y / tile) badTile++;
+            });
+            int wrong = 0;
+            for (int v : visits) wrong += v != 1;
+            CHECK_EQ(wrong, 0);
+            CHECK_EQ(badTile, 0);
+        }
+    }
+}
+
+// Edge tiles only count the pixels inside the frame; the padding threads change nothing
+static void PartialTiles() {
+    Frame f(20, 18, 8);
+    for (uint32_t y = 0; y < f.height; y++)
+        for (uint32_t x = 0; x < f.width; x++) f.Set(x, y, 0.5f, 0.5f, 0.5f);
+    // Row padding holds a bright value that must never be read
+    for (uint32_t y = 0; y < f.height; y++)
+        for (size_t i = (size_t)f.width * 4; i < f.stride; i++) f.rgba[y * f.stride + i] = 1000.0f;
+    f.Set(19, 17, 0.75f, 0.75f, 0.75f);     // Corner pixel, in the 4x2 bottom-right tile
+
+    std::vector<uint32_t> records = TileRecords(f, 16, true, true);
+    const uint32_t* corner = records.data() + 3 * TILE_STAT_UINTS;
+    CHECK_EQ(corner[TILE_STAT_PIXELS], 8u);
+    CHECK_NEAR(Bits(corner[TILE_STAT_PEAK]), 60.0, 1e-3);
+    CHECK_NEAR(Bits(corner[TILE_STAT_MIN]), 40.0, 1e-3);
+    CHECK_NEAR(Bits(corner[TILE_STAT_SUM]), 7 * 40.0 + 60.0, 1e-3);
+    CHECK_EQ(records[0 * TILE_STAT_UINTS + TILE_STAT_PIXELS], 256u);
+    CHECK_EQ(records[1 * TILE_STAT_UINTS + TILE_STAT_PIXELS], 4u * 16u);
+    CHECK_EQ(records[2 * TILE_STAT_UINTS + TILE_STAT_PIXELS], 16u * 2u);
+}
+
+// Reduced records against statistics computed directly over the frame, including a
+// grid larger than the reduction group (threads fold several tiles each)
+static void ReductionMatchesFrame() {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> level(-0.05f, 12.0f);
+    for (uint32_t tile : { 8u, 16u }) {
+        Frame f(333, 219);
+        for (uint32_t y = 0; y < f.height; y++)
+            for (uint32_t x = 0; x < f.width; x++) f.Set(x, y, level(rng), level(rng), level(rng));
+        f.Set(300, 200, 100.0f, 100.0f, 100.0f);    // 8000 nits, in a tile past the first 256
+
+        TileGrid grid = MainPassTileGrid(f.width, f.height, tile);
+        CHECK(grid.Count() > TILE_REDUCE_THREADS);
+        std::vector<uint32_t> records = TileRecords(f, tile, true, true);
+        uint32_t analysis[TILE_STAT_UINTS] = {};
+        float peak = ReduceTileStats(records.data(), grid.Count(), true, analysis);
+
+        float minNits = 1e9f, minNonZero = 1e9f;
+        double sum = 0.0;
+        for (uint32_t y = 0; y < f.height; y++) {
+            for (uint32_t x = 0; x < f.width; x++) {
+                float n = Nits(f.At(x, y));
+                minNits = (std::min)(minNits, n);
+                if (n > 0.1f) minNonZero = (std::min)(minNonZero, n);
+                sum += n;
+            }
+        }
+        uint32_t pixels = f.width * f.height;
+        CHECK_NEAR(peak, 8000.0, 1e-2);
+        CHECK_EQ(Bits(analysis[TILE_STAT_PEAK]), peak);
+        CHECK_EQ(Bits(analysis[TILE_STAT_MIN]), minNits);
+        CHECK_EQ(Bits(analysis[TILE_STAT_MIN_NON_ZERO]), minNonZero);
+        CHECK_NEAR(Bits(analysis[TILE_STAT_SUM]), sum, sum * 1e-4);
+        CHECK_EQ(analysis[TILE_STAT_PIXELS], pixels);
+        uint32_t classes = analysis[TILE_STAT_REC709] + analysis[TILE_STAT_P3_ONLY] +
+                           analysis[TILE_STAT_REC2020_ONLY] + analysis[TILE_STAT_OUT_OF_GAMUT];
+        CHECK_EQ(classes, pixels);
+        uint32_t histogram = 0;
+        for (int b = 0; b < 5; b++) histogram += analysis[TILE_STAT_HISTOGRAM + b];
+        CHECK_EQ(histogram, pixels);
+        CHECK(analysis[TILE_STAT_HISTOGRAM + 4] >= 1);      // The 8000-nit pixel
+    }
+}
+
+// Frames that don't collect analysis only write and reduce the peak
+static void PeakOnly() {
+    Frame f(40, 40);
+    f.Set(39, 0, 2.0f, 2.0f, 2.0f);
+    f.Set(0, 39, -3.0f, -3.0f, -3.0f);          // Negative luminance never lowers the peak below 0
+    std::vector<uint32_t> records = TileRecords(f, 16, true, false);
+    CHECK_NEAR(Bits(records[2 * TILE_STAT_UINTS + TILE_STAT_PEAK]), 160.0, 1e-3);
+    CHECK_EQ(Bits(records[6 * TILE_STAT_UINTS + TILE_STAT_PEAK]), 0.0f);
+    CHECK_EQ(records[TILE_STAT_PIXELS], 0xCDCDCDCDu);
+
+    uint32_t analysis[TILE_STAT_UINTS];
+    memset(analysis, 0xAB, sizeof(analysis));
+    CHECK_NEAR(ReduceTileStats(records.data(), 9, false, analysis), 160.0, 1e-3);
+    CHECK_EQ(analysis[TILE_STAT_PEAK], 0xABABABABu);
+    CHECK_NEAR(ReduceTileStats(records.data(), 9, false, nullptr), 160.0, 1e-3);
+    CHECK_EQ(ReduceTileStats(records.data(), 0, false, nullptr), 0.0f);
+}
+
+static void GamutAndClipping() {
+    // HDR: Rec.709 white, P3 red, Rec.2020 red and an impossible color, in scRGB
+    Frame hdr(4, 1);
+    hdr.Set(0, 0, 1.0f, 1.0f, 1.0f);
+    hdr.Set(1, 0, 1.2249f, -0.0421f, -0.0196f);
+    hdr.Set(2, 0, 1.6605f, -0.1246f, -0.0182f);
+    hdr.Set(3, 0, -1.0f, 1.0f, -1.0f);
+    std::vector<uint32_t> records = TileRecords(hdr, 16, true, true);
+    CHECK_EQ(records[TILE_STAT_REC709], 1u);
+    CHECK_EQ(records[TILE_STAT_P3_ONLY], 1u);
+    CHECK_EQ(records[TILE_STAT_REC2020_ONLY], 1u);
+    CHECK_EQ(records[TILE_STAT_OUT_OF_GAMUT], 1u);
+    CHECK_EQ(records[TILE_STAT_CLIP_BLACK] + records[TILE_STAT_CLIP_WHITE], 0u);
+
+    // SDR: everything is Rec.709; clipping counted, no histogram
+    Frame sdr(4, 1);
+    sdr.Set(0, 0, 0.0f, 0.0f, 0.0f);
+    sdr.Set(1, 0, 1.0f, 1.0f, 1.0f);
+    sdr.Set(2, 0, 1.0f, 1.0f, 0.5f);
+    sdr.Set(3, 0, 0.5f, 0.5f, 0.5f);
+    records = TileRecords(sdr, 8, false, true);
+    CHECK_EQ(records[TILE_STAT_REC709], 4u);
+    CHECK_EQ(records[TILE_STAT_CLIP_BLACK], 1u);
+    CHECK_EQ(records[TILE_STAT_CLIP_WHITE], 1u);
+    CHECK_EQ(records[TILE_STAT_HISTOGRAM], 0u);
+    CHECK_NEAR(Bits(records[TILE_STAT_MIN_NON_ZERO]), 0.5 * 80.0, 1e-3);
+}
+
+static void Smoothing() {
+    const PeakSmoothing& p = DEFAULT_PEAK_SMOOTHING;
+    CHECK_EQ(SmoothPeak(0.0f, 640.0f, p), 640.0f);           // First frame takes the peak
+    CHECK_NEAR(SmoothPeak(100.0f, 200.0f, p), 130.0, 1e-4);  // Exponential rise
+    CHECK_EQ(SmoothPeak(100.0f, 1000.0f, p), 200.0f);        // Slew-limited rise
+    CHECK_NEAR(SmoothPeak(1000.0f, 900.0f, p), 995.0, 1e-3); // Slower fall
+    CHECK_EQ(SmoothPeak(1000.0f, 0.0f, p), 950.0f);          // Slew-limited fall
+    CHECK_EQ(SmoothPeak(9990.0f, 20000.0f, p), 10000.0f);
+
+    float peak = 100.0f;
+    for (int i = 0; i < 200; i++) peak = SmoothPeak(peak, 1000.0f, p);
+    CHECK_NEAR(peak, 1000.0, 0.5);
+}
+
+int main() {
+    RUN_TEST(Grid);
+    RUN_TEST(EveryPixelOnce);
+    RUN_TEST(PartialTiles);
+    RUN_TEST(ReductionMatchesFrame);
+    RUN_TEST(PeakOnly);
+    RUN_TEST(GamutAndClipping);
+    RUN_TEST(Smoothing);
+    return CheckExitCode();
+}
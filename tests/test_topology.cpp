@@ -0,0 +1,209 @@
+// DesktopLUT - tests/test_topology.cpp
+// Topology planning on scripted display sequences (unplug, replug, reorder, mode / HDR changes,
+// resume, adapter moves, identical twin displays) and the settle debounce
+
+#include "check.h"
+#include "topology.h"
+
+static TopologyDisplay Display(uint64_t id, uintptr_t handle, int32_t x, int32_t width, bool hdr = false,
+                               uint32_t adapter = 1) {
+    TopologyDisplay d;
+    d.id = id;
+    d.handle = handle;
+    d.x = x;
+    d.width = width;
+    d.height = 1080;
+    d.hdr = hdr;
+    d.adapter.lowPart = adapter;
+    return d;
+}
+
+static const uint64_t A = 0xA1, B = 0xB2, C = 0xC3, UNCONFIGURED = 0xD4;
+static const std::vector<uint64_t> CONFIGURED = { A, B, C };
+
+static std::vector<TopologyDisplay> TwoDisplays() {
+    return { Display(A, 1, 0, 1920), Display(B, 2, 1920, 2560) };
+}
+
+static void Unchanged() {
+    std::vector<TopologyDisplay> running = TwoDisplays();
+    CHECK(PlanTopology(running, running, CONFIGURED, false).empty());
+    CHECK(PlanTopology({}, {}, CONFIGURED, false).empty());
+}
+
+static void UnplugAndReplug() {
+    std::vector<TopologyDisplay> running = TwoDisplays();
+    std::vector<TopologyStep> plan = PlanTopology(running, { Display(B, 2, 1920, 2560) }, CONFIGURED, false);
+    CHECK_EQ(plan.size(), 1u);
+    if (plan.size() == 1) {
+        CHECK_EQ(plan[0].id, A);
+        CHECK_EQ(plan[0].running, 0);
+        CHECK_EQ(plan[0].current, -1);
+        CHECK_EQ(plan[0].actions, (uint32_t)TOPOLOGY_REMOVE);
+    }
+
+    // Back with a new HMONITOR: attached, B untouched
+    plan = PlanTopology({ Display(B, 2, 1920, 2560) }, { Display(A, 5, 0, 1920), Display(B, 2, 1920, 2560) },
+                        CONFIGURED, false);
+    CHECK_EQ(plan.size(), 1u);
+    if (plan.size() == 1) {
+        CHECK_EQ(plan[0].id, A);
+        CHECK_EQ(plan[0].running, -1);
+        CHECK_EQ(plan[0].current, 0);
+        CHECK_EQ(plan[0].actions, (uint32_t)TOPOLOGY_ADD);
+    }
+}
+
+static void OnlyConfiguredAdded() {
+    std::vector<TopologyDisplay> running = TwoDisplays();
+    std::vector<TopologyDisplay> current = TwoDisplays();
+    current.push_back(Display(UNCONFIGURED, 3, 4480, 1920));
+    CHECK(PlanTopology(running, current, CONFIGURED, false).empty());
+    current.push_back(Display(C, 4, 6400, 1920));
+    std::vector<TopologyStep> plan = PlanTopology(running, current, CONFIGURED, false);
+    CHECK_EQ(plan.size(), 1u);
+    if (plan.size() == 1) CHECK_EQ(plan[0].current, 3);
+}
+
+// Windows rebuilds the monitor list in a new order with new handles: displays pair up by id
+static void Reorder() {
+    std::vector<TopologyStep> plan = PlanTopology(TwoDisplays(),
+        { Display(B, 7, 0, 2560), Display(A, 8, 2560, 1920) }, CONFIGURED, false);
+    CHECK_EQ(plan.size(), 2u);
+    for (const TopologyStep& s : plan) {
+        CHECK_EQ(s.actions, (uint32_t)(TOPOLOGY_REBIND | TOPOLOGY_MOVE | TOPOLOGY_REDUPLICATE));
+        CHECK_EQ(s.current, s.id == A ? 1 : 0);
+        CHECK_EQ(s.running, s.id == A ? 0 : 1);
+    }
+}
+
+static void ModeAndHDR() {
+    std::vector<TopologyStep> plan = PlanTopology(TwoDisplays(),
+        { Display(A, 1, 0, 1280), Display(B, 2, 1920, 2560, true) }, CONFIGURED, false);
+    CHECK_EQ(plan.size(), 2u);
+    if (plan.size() == 2) {
+        CHECK_EQ(plan[0].actions, (uint32_t)(TOPOLOGY_RESIZE | TOPOLOGY_REDUPLICATE));
+        CHECK_EQ(plan[1].actions, (uint32_t)(TOPOLOGY_HDR | TOPOLOGY_REDUPLICATE));
+    }
+
+    // Position only: the window moves, capture keeps going
+    plan = PlanTopology(TwoDisplays(), { Display(A, 1, 0, 1920), Display(B, 2, 3840, 2560) }, CONFIGURED, false);
+    CHECK_EQ(plan.size(), 1u);
+    if (plan.size() == 1) CHECK_EQ(plan[0].actions, (uint32_t)TOPOLOGY_MOVE);
+}
+
+static void Resume() {
+    std::vector<TopologyDisplay> running = TwoDisplays();
+    std::vector<TopologyStep> plan = PlanTopology(running, running, CONFIGURED, true);
+    CHECK_EQ(plan.size(), 2u);
+    for (const TopologyStep& s : plan) CHECK_EQ(s.actions, (uint32_t)TOPOLOGY_REDUPLICATE);
+
+    // A display that didn't come back from sleep is removed, not reduplicated
+    plan = PlanTopology(running, { Display(A, 1, 0, 1920) }, CONFIGURED, true);
+    CHECK_EQ(plan.size(), 2u);
+    if (plan.size() == 2) {
+        CHECK_EQ(plan[0].actions, (uint32_t)TOPOLOGY_REMOVE);
+        CHECK_EQ(plan[0].id, B);
+        CHECK_EQ(plan[1].actions, (uint32_t)TOPOLOGY_REDUPLICATE);
+    }
+}
+
+// Moving to another adapter is a remove then an add (new device group), in that order
+static void AdapterMove() {
+    std::vector<TopologyStep> plan = PlanTopology(TwoDisplays(),
+        { Display(A, 1, 0, 1920), Display(B, 2, 1920, 2560, false, 2) }, CONFIGURED, false);
+    CHECK_EQ(plan.size(), 2u);
+    if (plan.size() == 2) {
+        CHECK_EQ(plan[0].actions, (uint32_t)TOPOLOGY_REMOVE);
+        CHECK_EQ(plan[0].running, 1);
+        CHECK_EQ(plan[1].actions, (uint32_t)TOPOLOGY_ADD);
+        CHECK_EQ(plan[1].current, 1);
+    }
+
+    // highPart counts too
+    TopologyDisplay moved = Display(A, 1, 0, 1920);
+    moved.adapter.highPart = 1;
+    plan = PlanTopology({ Display(A, 1, 0, 1920) }, { moved }, CONFIGURED, false);
+    CHECK_EQ(plan.size(), 2u);
+}
+
+// Plan order: removes, updates, adds, whatever the list order
+static void StepOrder() {
+    std::vector<TopologyDisplay> running = { Display(A, 1, 0, 1920), Display(B, 2, 1920, 2560) };
+    std::vector<TopologyDisplay> current = { Display(C, 9, 0, 1920), Display(B, 2, 1920, 2560, true) };
+    std::vector<TopologyStep> plan = PlanTopology(running, current, CONFIGURED, false);
+    CHECK_EQ(plan.size(), 3u);
+    if (plan.size() == 3) {
+        CHECK_EQ(plan[0].actions, (uint32_t)TOPOLOGY_REMOVE);
+        CHECK_EQ(plan[1].actions, (uint32_t)(TOPOLOGY_HDR | TOPOLOGY_REDUPLICATE));
+        CHECK_EQ(plan[2].actions, (uint32_t)TOPOLOGY_ADD);
+        CHECK_EQ(plan[2].id, C);
+    }
+}
+
+// Two identical displays share an EDID hash: handles tell them apart while they last
+static void IdenticalTwins() {
+    const uint64_t E = 0xE5;
+    std::vector<TopologyDisplay> twins = { Display(E, 1, 0, 1920), Display(E, 2, 1920, 1920) };
+
+    // The second one unplugged: only it goes, the first keeps rendering untouched
+    std::vector<TopologyStep> plan = PlanTopology(twins, { Display(E, 1, 0, 1920) }, { E }, false);
+    CHECK_EQ(plan.size(), 1u);
+    if (plan.size() == 1) {
+        CHECK_EQ(plan[0].running, 1);
+        CHECK_EQ(plan[0].actions, (uint32_t)TOPOLOGY_REMOVE);
+    }
+    // The first one unplugged
+    plan = PlanTopology(twins, { Display(E, 2, 1920, 1920) }, { E }, false);
+    CHECK_EQ(plan.size(), 1u);
+    if (plan.size() == 1) CHECK_EQ(plan[0].running, 0);
+
+    // All handles new: paired in list order, each rebound in place
+    plan = PlanTopology(twins, { Display(E, 7, 0, 1920), Display(E, 8, 1920, 1920) }, { E }, false);
+    CHECK_EQ(plan.size(), 2u);
+    for (const TopologyStep& s : plan) {
+        CHECK_EQ(s.running, s.current);
+        CHECK_EQ(s.actions, (uint32_t)(TOPOLOGY_REBIND | TOPOLOGY_REDUPLICATE));
+    }
+}
+
+static void Format() {
+    CHECK(FormatTopologyActions(0) == "none");
+    CHECK(FormatTopologyActions(TOPOLOGY_REMOVE) == "remove");
+    CHECK(FormatTopologyActions(TOPOLOGY_MOVE | TOPOLOGY_RESIZE | TOPOLOGY_REDUPLICATE) == "move+resize+reduplicate");
+}
+
+static void Settle() {
+    TopologySettle settle;
+    bool resumed = false;
+    CHECK(!TopologySettled(settle, 10000, TOPOLOGY_SETTLE_MS, resumed));    // Nothing pending
+
+    // A burst: settles once, 500 ms after its last event, remembering the wake
+    NoteTopologyEvent(settle, 0, false);
+    NoteTopologyEvent(settle, 300, true);
+    NoteTopologyEvent(settle, 400, false);
+    CHECK(!TopologySettled(settle, 800, TOPOLOGY_SETTLE_MS, resumed));
+    CHECK(TopologySettled(settle, 900, TOPOLOGY_SETTLE_MS, resumed));
+    CHECK(resumed);
+    CHECK(!TopologySettled(settle, 2000, TOPOLOGY_SETTLE_MS, resumed));
+
+    // The next burst starts clean
+    NoteTopologyEvent(settle, 3000, false);
+    CHECK(TopologySettled(settle, 3500, TOPOLOGY_SETTLE_MS, resumed));
+    CHECK(!resumed);
+}
+
+int main() {
+    RUN_TEST(Unchanged);
+    RUN_TEST(UnplugAndReplug);
+    RUN_TEST(OnlyConfiguredAdded);
+    RUN_TEST(Reorder);
+    RUN_TEST(ModeAndHDR);
+    RUN_TEST(Resume);
+    RUN_TEST(AdapterMove);
+    RUN_TEST(StepOrder);
+    RUN_TEST(IdenticalTwins);
+    RUN_TEST(Format);
+    RUN_TEST(Settle);
+    return CheckExitCode();
+}
@@ -0,0 +1,206 @@
+// DesktopLUT - tests/test_whitelist.cpp
+// Whitelist entry parsing, name / glob / path matching and the per-process path cache
+
+#include "check.h"
+#include "whitelist.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+static CompiledWhitelist Compile(const wchar_t* raw) {
+    std::vector<std::wstring> entries;
+    ParseWhitelistEntries(raw, entries);
+    CompiledWhitelist wl;
+    CompileWhitelist(entries, wl);
+    return wl;
+}
+
+static void ParseNormalizes() {
+    std::vector<std::wstring> entries;
+    ParseWhitelistEntries(L" MPV.EXE ; vlc,, C:\\Games\\Steam\\ ;*Player*.exe\t", entries);
+    CHECK_EQ(entries.size(), 4u);
+    CHECK(entries[0] == L"mpv");                    // .exe stripped from plain names
+    CHECK(entries[1] == L"vlc");
+    CHECK(entries[2] == L"c:/games/steam/");        // Backslashes folded, path kept literal
+    CHECK(entries[3] == L"*player*");
+}
+
+static void ExactNames() {
+    CompiledWhitelist wl = Compile(L"mpv, mpc-hc64.exe");
+    CHECK(MatchWhitelist(wl, L"mpv.exe", nullptr));
+    CHECK(MatchWhitelist(wl, L"mpv", nullptr));
+    CHECK(MatchWhitelist(wl, L"MPC-HC64.EXE", nullptr));
+    CHECK(!MatchWhitelist(wl, L"mpv2.exe", nullptr));
+    CHECK(!MatchWhitelist(wl, L"mp.exe", nullptr));
+    CHECK(!MatchWhitelist(wl, L"mpv.exe.bak", nullptr));
+    CHECK(!wl.needsFullPath());
+}
+
+static void NameGlobs() {
+    CompiledWhitelist wl = Compile(L"*player*, game??, obs*, *-win64-shipping");
+    CHECK(MatchWhitelist(wl, L"PotPlayerMini64.exe", nullptr));
+    CHECK(MatchWhitelist(wl, L"player.exe", nullptr));
+    CHECK(MatchWhitelist(wl, L"game42.exe", nullptr));
+    CHECK(!MatchWhitelist(wl, L"game4.exe", nullptr));       // '?' is exactly one char
+    CHECK(!MatchWhitelist(wl, L"game420.exe", nullptr));
+    CHECK(MatchWhitelist(wl, L"obs64.exe", nullptr));
+    CHECK(!MatchWhitelist(wl, L"xobs64.exe", nullptr));      // Anchored at the start
+    CHECK(MatchWhitelist(wl, L"Stray-Win64-Shipping.exe", nullptr));
+    CHECK(!MatchWhitelist(wl, L"Stray-Win64-Shipping2.exe", nullptr));
+    CHECK(!MatchWhitelist(wl, L"explorer.exe", nullptr));
+}
+
+static void KeylessGlobs() {
+    // No literal to index on: checked directly
+    CHECK(MatchWhitelist(Compile(L"*"), L"anything.exe", nullptr));
+    CompiledWhitelist threeChars = Compile(L"???");
+    CHECK(MatchWhitelist(threeChars, L"abc.exe", nullptr));
+    CHECK(!MatchWhitelist(threeChars, L"abcd.exe", nullptr));
+}
+
+static void PathEntries() {
+    CompiledWhitelist wl = Compile(L"steamapps/common/*/, C:\\Emulators\\");
+    CHECK(wl.needsFullPath());
+    CHECK(!MatchWhitelist(wl, L"game.exe", nullptr));        // No path, no path match
+    CHECK(MatchWhitelist(wl, L"game.exe", L"D:\\SteamLibrary\\SteamApps\\Common\\Game\\game.exe"));
+    CHECK(!MatchWhitelist(wl, L"game.exe", L"D:\\SteamLibrary\\steamapps\\downloading\\game.exe"));
+    CHECK(MatchWhitelist(wl, L"rpcs3.exe", L"c:/emulators/rpcs3/rpcs3.exe"));
+    CHECK(!MatchWhitelist(wl, L"rpcs3.exe", L"C:\\Program Files\\Emulators\\rpcs3.exe"));
+}
+
+static void CaseFolding() {
+    CompiledWhitelist wl = Compile(L"MadVR*, Steam/");
+    CHECK(MatchWhitelist(wl, L"madvr64.exe", nullptr));
+    CHECK(MatchWhitelist(wl, L"MADVR.EXE", nullptr));
+    CHECK(WhitelistNameEquals(L"Game.EXE", L"game"));
+    CHECK(WhitelistNameEquals(L"game", L"GAME.exe"));
+    CHECK(!WhitelistNameEquals(L"game", L"games"));
+    CHECK(MatchWhitelist(wl, L"x.exe", L"C:\\Program Files (x86)\\STEAM\\x.exe"));
+}
+
+// Straightforward recursive glob match - the reference the automaton is compared against
+static bool ReferenceGlob(const wchar_t* p, const wchar_t* s) {
+    if (!*p) return !*s;
+    if (*p == L'*') return ReferenceGlob(p + 1, s) || (*s && ReferenceGlob(p, s + 1));
+    return *s && (*p == L'?' || *p == *s) && ReferenceGlob(p + 1, s + 1);
+}
+
+static void AutomatonMatchesReference() {
+    // Small alphabet so keys overlap and share fail links
+    std::mt19937 rng(1234);
+    auto randomString = [&rng](int maxLen, bool wild) {
+        static const wchar_t plain[] = L"abc";
+        static const wchar_t wildChars[] = L"abc*?";
+        std::wstring out;
+        int len = (int)(rng() % (maxLen + 1));
+        for (int i = 0; i < len; i++) out += wild ? wildChars[rng() % 5] : plain[rng() % 3];
+        return out;
+    };
+
+    int mismatches = 0;
+    for (int round = 0; round < 200; round++) {
+        std::vector<std::wstring> patterns;
+        for (int i = 0; i < 12; i++) {
+            std::wstring p = randomString(6, true);
+            if (p.find_first_of(L"*?") == std::wstring::npos) p += L'*';   // Keep it a glob
+            patterns.push_back(p);
+        }
+        CompiledWhitelist wl;
+        CompileWhitelist(patterns, wl);
+        CHECK_EQ(wl.nameGlobs.size(), patterns.size());
+
+        for (int t = 0; t < 50; t++) {
+            std::wstring name = randomString(10, false) + L"a";   // Never empty (".exe" alone isn't stripped)
+            bool expected = false;
+            for (const auto& p : patterns) expected = expected || ReferenceGlob(p.c_str(), name.c_str());
+            if (MatchWhitelist(wl, (name + L".exe").c_str(), nullptr) != expected) mismatches++;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+// Fake process table for the cache: pid -> path, counting queries
+struct FakeProcesses {
+    std::vector<std::wstring> paths;
+    int queries = 0;
+
+    WhitelistPathQuery Query() {
+        return [this](uint32_t pid, wchar_t* buf, size_t size) -> const wchar_t* {
+            queries++;
+            if (pid >= paths.size() || paths[pid].empty() || paths[pid].size() >= size) return nullptr;
+            paths[pid].copy(buf, paths[pid].size());
+            buf[paths[pid].size()] = 0;
+            return buf;
+        };
+    }
+};
+
+static void ProcessCacheQueriesOncePerProcess() {
+    CompiledWhitelist wl = Compile(L"mpv, steamapps/common/");
+    WhitelistProcessCache cache;
+    FakeProcesses fake;
+    fake.paths = { L"", L"C:\\Windows\\explorer.exe", L"D:\\steamapps\\common\\Game\\game.exe", L"" };
+    WhitelistPathQuery query = fake.Query();
+
+    auto scan = [&](const std::vector<WhitelistProcess>& processes) {
+        int hits = 0;
+        BeginWhitelistScan(cache);
+        for (const auto& p : processes) hits += MatchWhitelistProcess(wl, cache, p, query) ? 1 : 0;
+        EndWhitelistScan(cache);
+        return hits;
+    };
+
+    std::vector<WhitelistProcess> snapshot = {
+        { 1, 0, L"explorer.exe" }, { 2, 1, L"game.exe" }, { 3, 1, L"protected.exe" }, { 4, 1, L"mpv.exe" },
+    };
+    CHECK_EQ(scan(snapshot), 2);
+    CHECK_EQ(fake.queries, 3);               // mpv matched by name, never queried
+
+    // Later polls answer from the cache, including the process whose query failed
+    CHECK_EQ(scan(snapshot), 2);
+    CHECK_EQ(scan(snapshot), 2);
+    CHECK_EQ(fake.queries, 3);
+    CHECK_EQ(cache.pathQueries, 3u);
+
+    // Pid 2 exits and is reused by a different image: dropped, then queried as a new process
+    snapshot.erase(snapshot.begin() + 1);
+    CHECK_EQ(scan(snapshot), 1);
+    CHECK_EQ(cache.entries.size(), 2u);
+    snapshot.push_back({ 2, 1, L"other.exe" });
+    fake.paths[2] = L"C:\\Tools\\other.exe";
+    CHECK_EQ(scan(snapshot), 1);
+    CHECK_EQ(fake.queries, 4);
+
+    // Reused without a scan in between (same pid, different parent): still requeried
+    snapshot.back() = { 2, 7, L"other.exe" };
+    fake.paths[2] = L"E:\\steamapps\\common\\X\\other.exe";
+    CHECK_EQ(scan(snapshot), 2);
+    CHECK_EQ(fake.queries, 5);
+}
+
+static void NameOnlyWhitelistNeverQueries() {
+    CompiledWhitelist wl = Compile(L"mpv, *player*");
+    WhitelistProcessCache cache;
+    FakeProcesses fake;
+    WhitelistPathQuery query = fake.Query();
+    BeginWhitelistScan(cache);
+    CHECK(MatchWhitelistProcess(wl, cache, { 10, 1, L"PotPlayer.exe" }, query));
+    CHECK(!MatchWhitelistProcess(wl, cache, { 11, 1, L"explorer.exe" }, query));
+    EndWhitelistScan(cache);
+    CHECK_EQ(fake.queries, 0);
+    CHECK(cache.entries.empty());
+}
+
+int main() {
+    RUN_TEST(ParseNormalizes);
+    RUN_TEST(ExactNames);
+    RUN_TEST(NameGlobs);
+    RUN_TEST(KeylessGlobs);
+    RUN_TEST(PathEntries);
+    RUN_TEST(CaseFolding);
+    RUN_TEST(AutomatonMatchesReference);
+    RUN_TEST(ProcessCacheQueriesOncePerProcess);
+    RUN_TEST(NameOnlyWhitelistNeverQueries);
+    return CheckExitCode();
+}
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""
+Compares DesktopLUT CPU benchmark results against a stored baseline and flags regressions.
+
+Produce results with:
+    DesktopLUT.exe --benchmark current.json
+    build-bench/desktoplut_bench current.json      (portable fixtures only, any OS)
+
+Usage:
+    python compare_benchmarks.py baseline.json current.json
+    python compare_benchmarks.py baseline.json current.json --threshold 15
+
+Exits with status 1 if any benchmark's median is slower than the baseline by more than
+the threshold (percent), 2 if the files can't be compared.
+"""
+
+import argparse
+import json
+import sys
+
+def load_results(path):
+    """Load a results file, returning (metadata, {name: benchmark})."""
+    with open(path, encoding="utf-8") as f:
+        data = json.load(f)
+    benchmarks = {b["name"]: b for b in data.get("benchmarks", [])}
+    return data, benchmarks
+
+def format_ns(ns):
+    if ns >= 1e6:
+        return f"{ns / 1e6:.2f} ms"
+    if ns >= 1e3:
+        return f"{ns / 1e3:.2f} us"
+    return f"{ns:.1f} ns"
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare DesktopLUT benchmark results against a baseline")
+    parser.add_argument('baseline', help='Baseline results JSON')
+    parser.add_argument('current', help='Current results JSON')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='Regression threshold in percent of the baseline median (default 10)')
+    args = parser.parse_args()
+
+    base_meta, base = load_results(args.baseline)
+    cur_meta, cur = load_results(args.current)
+
+    if base_meta.get("schema") != cur_meta.get("schema"):
+        print(f"Error: schema {base_meta.get('schema')} vs {cur_meta.get('schema')} - fixtures changed, "
+              "record a new baseline", file=sys.stderr)
+        sys.exit(2)
+    if base_meta.get("build") != cur_meta.get("build"):
+        print(f"Warning: comparing {base_meta.get('build')} baseline against {cur_meta.get('build')} build",
+              file=sys.stderr)
+
+    regressions = []
+    print(f"{'benchmark':<36} {'baseline':>12} {'current':>12} {'change':>9}")
+    for name in sorted(set(base) | set(cur)):
+        if name not in cur:
+            print(f"{name:<36} {format_ns(base[name]['median_ns']):>12} {'missing':>12}")
+            continue
+        if name not in base:
+            print(f"{name:<36} {'new':>12} {format_ns(cur[name]['median_ns']):>12}")
+            continue
+
+        before = base[name]["median_ns"]
+        after = cur[name]["median_ns"]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+
+        # A regression must also clear the current run's own noise (fastest sample)
+        flag = ""
+        if change > args.threshold and cur[name]["min_ns"] > before * (1.0 + args.threshold / 100.0):
+            flag = "  REGRESSION"
+            regressions.append(name)
+        elif change < -args.threshold:
+            flag = "  faster"
+        print(f"{name:<36} {format_ns(before):>12} {format_ns(after):>12} {change:>+8.1f}%{flag}")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) over {args.threshold:.0f}%: {', '.join(regressions)}")
+        sys.exit(1)
+    print(f"\nNo regressions over {args.threshold:.0f}%")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,306 @@
+#!/usr/bin/env python3
+"""
+Emulates the half-precision (HALF_PRECISION) variant of the SDR pixel pipeline and reports,
+per stage, the worst error against full-precision math in 10-bit output code values.
+
+Every arithmetic result of a stage that runs in min16float is rounded to IEEE half
+(round-to-nearest-even), transcendentals included (pow = exp2(y * log2(x)) with each step
+rounded), cbuffer values are converted to half before use, and half denormals are flushed
+to zero unless --denormals is given (D3D lets min-precision hardware flush them).
+Inputs are the exhaustive 10-bit ramps of gray, the primaries and the secondaries.
+
+Usage:
+    python fp16_error_report.py
+    python fp16_error_report.py --budget 0.5 --lut-size 65
+    python fp16_error_report.py --denormals
+
+Exits with status 1 if a stage the shader runs in half precision (FP16 column, kept in
+step with the lut_half typedefs in src/shader.h) exceeds the budget, or if the combined
+chain does. Stages marked FP32 are reported so they can be revisited.
+"""
+
+import argparse
+import math
+import struct
+import sys
+
+CODES = 1023.0
+FLUSH_DENORMALS = True
+HALF_MIN_NORMAL = 2.0 ** -14
+
+def to_half(x):
+    """Round a Python float to the nearest IEEE half value."""
+    if math.isnan(x) or math.isinf(x):
+        return x
+    try:
+        h = struct.unpack("<e", struct.pack("<e", x))[0]
+    except OverflowError:
+        return math.copysign(math.inf, x)
+    if FLUSH_DENORMALS and abs(h) < HALF_MIN_NORMAL:
+        return math.copysign(0.0, h)
+    return h
+
+class Half:
+    """A min16float value: every operation rounds its result to half."""
+    __slots__ = ("v",)
+
+    def __init__(self, v):
+        self.v = to_half(v.v if isinstance(v, Half) else float(v))
+
+    @staticmethod
+    def _val(x):
+        return x.v if isinstance(x, Half) else to_half(float(x))
+
+    def __add__(self, o): return Half(self.v + Half._val(o))
+    def __radd__(self, o): return Half(Half._val(o) + self.v)
+    def __sub__(self, o): return Half(self.v - Half._val(o))
+    def __rsub__(self, o): return Half(Half._val(o) - self.v)
+    def __mul__(self, o): return Half(self.v * Half._val(o))
+    def __rmul__(self, o): return Half(Half._val(o) * self.v)
+    def __truediv__(self, o): return Half(_div(self.v, Half._val(o)))
+    def __rtruediv__(self, o): return Half(_div(Half._val(o), self.v))
+    def __neg__(self): return Half(-self.v)
+    def __lt__(self, o): return self.v < Half._val(o)
+    def __le__(self, o): return self.v <= Half._val(o)
+    def __gt__(self, o): return self.v > Half._val(o)
+    def __ge__(self, o): return self.v >= Half._val(o)
+    def __float__(self): return self.v
+
+def _div(a, b):
+    if b == 0.0:
+        return math.copysign(math.inf, a) if a != 0.0 else 0.0
+    return a / b
+
+# HLSL intrinsics over float (reference) or Half (emulated) scalars
+
+def f(x, half):
+    """Literal/cbuffer value in the stage's precision."""
+    return Half(x) if half else float(x)
+
+def h_pow(x, y):
+    if isinstance(x, Half):
+        if x.v <= 0.0:
+            return Half(0.0)
+        l = Half(math.log2(x.v))
+        return Half(2.0 ** (l * y).v)
+    return 0.0 if x <= 0.0 else x ** y
+
+def h_sqrt(x):
+    return Half(math.sqrt(max(x.v, 0.0))) if isinstance(x, Half) else math.sqrt(max(x, 0.0))
+
+def h_floor(x):
+    return Half(math.floor(x.v)) if isinstance(x, Half) else float(math.floor(x))
+
+def h_max(a, b):
+    return a if a >= b else b
+
+def h_min(a, b):
+    return a if a <= b else b
+
+def h_saturate(x):
+    return h_min(h_max(x, 0.0), 1.0)
+
+def dot(a, b):
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]
+
+LUMA = (0.2126, 0.7152, 0.0722)
+
+# Stage models: same operations as Part 2, 4 and 6 of g_psSource
+
+# Panel correction of a wide-gamut display showing sRGB content (sRGB -> P3 with a slight
+# white point shift), representative of what ApplyPrimariesMatrix receives
+PRIMARIES = ((0.8225, 0.1774, 0.0001), (0.0332, 0.9669, -0.0001), (0.0171, 0.0724, 0.9105))
+
+def stage_primaries(rgb, half):
+    lin = [h_pow(h_max(c, f(0.0, half)), f(2.2, half)) for c in rgb]
+    mat = [[f(m, half) for m in row] for row in PRIMARIES]
+    lin = [h_max(dot(row, lin), f(0.0, half)) for row in mat]
+    return [h_saturate(h_pow(c, f(1.0 / 2.2, half))) for c in lin]
+
+def grayscale_curve(points):
+    """Measured-looking correction curve: Y targets on the sqrt distribution with a small wobble."""
+    curve = []
+    for i in range(points):
+        s = i / (points - 1.0)
+        curve.append(max(0.0, s * s * (1.0 + 0.04 * math.sin(s * math.pi * 3.0) * (1.0 - s))))
+    curve[-1] = 1.0
+    return curve
+
+GRAYSCALE = grayscale_curve(32)
+
+def stage_grayscale(rgb, half):
+    luma = [f(w, half) for w in LUMA]
+    Y = dot(rgb, luma)
+    n = len(GRAYSCALE)
+    idx = h_sqrt(h_saturate(Y)) * f(n - 1.0, half)
+    i0 = int(float(h_floor(idx)))
+    i1 = min(i0 + 1, n - 1)
+    v0 = f(GRAYSCALE[i0], half)
+    v1 = f(GRAYSCALE[i1], half)
+    t = idx - h_floor(idx)
+    s0 = h_sqrt(h_max(v0, f(0.0, half)))
+    s1 = h_sqrt(h_max(v1, f(0.0, half)))
+    corrected_s = s0 + (s1 - s0) * t
+    corrected_y = corrected_s * corrected_s
+    if Y < f(1e-6, half):
+        return rgb
+    scale = corrected_y / Y
+    return [c * scale for c in rgb]
+
+def stage_gamma24(rgb, half):
+    luma = [f(w, half) for w in LUMA]
+    Y = dot(rgb, luma)
+    if Y < f(1e-6, half):
+        return rgb
+    corrected_y = h_pow(h_max(Y, f(0.0, half)), f(1.090909, half))
+    scale = corrected_y / Y
+    return [c * scale for c in rgb]
+
+def make_lut(size):
+    """Display correction LUT (gamma trim plus crosstalk), texels stored as FP16 like lut.cpp."""
+    lut = {}
+    for b in range(size):
+        for g in range(size):
+            for r in range(size):
+                rgb = (r / (size - 1.0), g / (size - 1.0), b / (size - 1.0))
+                out = (0.96 * rgb[0] ** 1.06 + 0.03 * rgb[1] + 0.01 * rgb[2],
+                       0.02 * rgb[0] + 0.97 * rgb[1] ** 1.04 + 0.01 * rgb[2],
+                       0.01 * rgb[0] + 0.02 * rgb[1] + 0.97 * rgb[2] ** 1.08)
+                lut[(r, g, b)] = tuple(to_half(min(max(c, 0.0), 1.0)) for c in out)
+    return lut
+
+LUT_SIZE = 33
+LUT = None
+
+def lut_fetch(i, j, k):
+    n = LUT_SIZE - 1
+    return LUT[(min(max(i, 0), n), min(max(j, 0), n), min(max(k, 0), n))]
+
+def stage_lut_trilinear(rgb, half):
+    # Only the coordinate math runs in the shader; the sampler filters in full precision
+    size = f(LUT_SIZE, half)
+    uv = [(h_saturate(c) * (size - f(1.0, half)) + f(0.5, half)) / size for c in rgb]
+    p = [float(u) * LUT_SIZE - 0.5 for u in uv]
+    base = [math.floor(x) for x in p]
+    t = [x - b for x, b in zip(p, base)]
+    out = [0.0, 0.0, 0.0]
+    for dk in (0, 1):
+        for dj in (0, 1):
+            for di in (0, 1):
+                w = ((t[0] if di else 1 - t[0]) * (t[1] if dj else 1 - t[1]) * (t[2] if dk else 1 - t[2]))
+                texel = lut_fetch(base[0] + di, base[1] + dj, base[2] + dk)
+                for c in range(3):
+                    out[c] += w * texel[c]
+    return [f(c, half) for c in out]
+
+def stage_lut_tetrahedral(rgb, half):
+    size = f(LUT_SIZE, half)
+    scaled = [h_saturate(c) * (size - f(1.0, half)) for c in rgb]
+    base = [h_floor(s) for s in scaled]
+    fr = [s - b for s, b in zip(scaled, base)]
+    i, j, k = (int(float(b)) for b in base)
+
+    def tex(di, dj, dk):
+        return [f(c, half) for c in lut_fetch(i + di, j + dj, k + dk)]
+
+    c000, c111 = tex(0, 0, 0), tex(1, 1, 1)
+    r, g, b = fr
+    # (first corner, second corner, weights in order) per tetrahedron, as in SampleLUTTetrahedral
+    if r >= g:
+        if g >= b:
+            ca, cb, w = tex(1, 0, 0), tex(1, 1, 0), (r, g, b)
+        elif r >= b:
+            ca, cb, w = tex(1, 0, 0), tex(1, 0, 1), (r, b, g)
+        else:
+            ca, cb, w = tex(0, 0, 1), tex(1, 0, 1), (b, r, g)
+    else:
+        if b >= g:
+            ca, cb, w = tex(0, 0, 1), tex(0, 1, 1), (b, g, r)
+        elif r >= b:
+            ca, cb, w = tex(0, 1, 0), tex(1, 1, 0), (g, r, b)
+        else:
+            ca, cb, w = tex(0, 1, 0), tex(0, 1, 1), (g, b, r)
+    return [c000[c] + (ca[c] - c000[c]) * w[0] + (cb[c] - ca[c]) * w[1] + (c111[c] - cb[c]) * w[2]
+            for c in range(3)]
+
+def stage_dither(rgb, half):
+    # Worst case noise sample (0 or 1 from the blue noise texture)
+    out = []
+    for c in rgb:
+        noise = f(1.0 if float(c) < 0.5 else 0.0, half)
+        out.append(c + (noise - f(0.5, half)) / f(1024.0, half))
+    return out
+
+# name, model, runs in FP16 in the shader (keep in step with src/shader.h)
+# dither fits numerically but stays FP32: half steps near white (1/2048) would quantize the
+# +-1/2048 noise to three levels, and it's a single add
+STAGES = [
+    ("primaries", stage_primaries, False),
+    ("grayscale", stage_grayscale, False),
+    ("gamma24", stage_gamma24, False),
+    ("lut_trilinear", stage_lut_trilinear, True),
+    ("lut_tetrahedral", stage_lut_tetrahedral, True),
+    ("dither", stage_dither, False),
+]
+
+RAMPS = [
+    ("gray", (1, 1, 1)), ("red", (1, 0, 0)), ("green", (0, 1, 0)), ("blue", (0, 0, 1)),
+    ("cyan", (0, 1, 1)), ("magenta", (1, 0, 1)), ("yellow", (1, 1, 0)),
+]
+
+def ramp_inputs():
+    for name, mask in RAMPS:
+        for code in range(1024):
+            v = code / CODES
+            yield name, code, [v * m for m in mask]
+
+def measure(fns_and_half):
+    """Worst |emulated - reference| over all ramps, in output codes: (error, ramp, code)."""
+    worst = (0.0, "", 0)
+    for name, code, rgb in ramp_inputs():
+        ref = list(rgb)
+        emu = list(rgb)
+        for fn, half in fns_and_half:
+            ref = fn(ref, False)
+            emu = fn([Half(float(c)) for c in emu], True) if half else fn([float(c) for c in emu], False)
+        err = max(abs(float(e) - r) for e, r in zip(emu, ref)) * CODES
+        if err > worst[0]:
+            worst = (err, name, code)
+    return worst
+
+def main():
+    global FLUSH_DENORMALS, LUT_SIZE, LUT
+    parser = argparse.ArgumentParser(description="Emulated FP16 error report for the SDR pixel pipeline")
+    parser.add_argument('--budget', type=float, default=1.0,
+                        help='Max error in 10-bit code values for an FP16 stage (default 1.0)')
+    parser.add_argument('--lut-size', type=int, default=33, help='Synthetic LUT size (default 33)')
+    parser.add_argument('--denormals', action='store_true', help='Keep half denormals instead of flushing')
+    args = parser.parse_args()
+
+    FLUSH_DENORMALS = not args.denormals
+    LUT_SIZE = args.lut_size
+    LUT = make_lut(LUT_SIZE)
+
+    failed = False
+    print(f"Budget {args.budget:.2f} codes (10-bit), LUT {LUT_SIZE}^3, denormals "
+          f"{'kept' if args.denormals else 'flushed'}")
+    print(f"{'stage':<16} {'shader':<6} {'max err':>8}   worst input   verdict")
+    for name, fn, fp16 in STAGES:
+        err, ramp, code = measure([(fn, True)])
+        ok = err < args.budget
+        verdict = "fits FP16" if ok else "needs FP32"
+        if fp16 and not ok:
+            failed = True
+            verdict += "  <-- runs in FP16"
+        print(f"{name:<16} {'FP16' if fp16 else 'FP32':<6} {err:8.3f}   {ramp:>7} {code:4d}   {verdict}")
+
+    # Full SDR chain as the shader runs it (LUT interpolation per the tetrahedral worst case)
+    chain = [(fn, fp16) for name, fn, fp16 in STAGES if name != "lut_trilinear"]
+    err, ramp, code = measure(chain)
+    ok = err < args.budget
+    failed = failed or not ok
+    print(f"{'chain':<16} {'mixed':<6} {err:8.3f}   {ramp:>7} {code:4d}   {'ok' if ok else 'over budget'}")
+    sys.exit(1 if failed else 0)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+"""
+Summarizes a DesktopLUT analysis recording (DesktopLUT-analysis.ring, written when
+AnalysisRecording=1) over a time range: MaxCLL/MaxFALL, percentiles and gamut usage.
+
+Usage:
+    python query_analysis.py DesktopLUT-analysis.ring
+    python query_analysis.py DesktopLUT-analysis.ring --last 2h --monitor 0
+    python query_analysis.py DesktopLUT-analysis.ring --from 2026-10-17T20:00 --to 2026-10-17T22:15
+    python query_analysis.py DesktopLUT-analysis.ring --last 30m --csv > session.csv
+
+The file can be read while DesktopLUT is recording. Layout matches src/analysisring.h.
+"""
+
+import argparse
+import datetime
+import math
+import struct
+import sys
+
+RING_MAGIC = 0x53544C44  # "DLTS"
+RING_VERSION = 1
+HEADER = struct.Struct("<IIIIQ40x")
+RECORD = struct.Struct("<QBBH7f6H5HH")
+RECORD_HDR = 0x01
+SHARE_SCALE = 10000.0
+
+SHARE_NAMES = ["Rec.709", "P3 only", "Rec.2020 only", "Out of gamut", "Clip black", "Clip white"]
+HISTOGRAM_NAMES = ["0-203", "203-1k", "1k-2k", "2k-4k", "4k+"]
+
+def read_records(path):
+    """Return records in append order (oldest first) as dicts."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if len(data) < HEADER.size:
+        raise ValueError("file too small for a ring header")
+    magic, version, record_size, capacity, write_count = HEADER.unpack_from(data, 0)
+    if magic != RING_MAGIC:
+        raise ValueError("not a DesktopLUT analysis recording")
+    if version != RING_VERSION or record_size != RECORD.size:
+        raise ValueError(f"unsupported recording version {version} (record size {record_size})")
+
+    first = max(0, write_count - capacity)
+    records = []
+    for n in range(first, write_count):
+        offset = HEADER.size + (n % capacity) * RECORD.size
+        if offset + RECORD.size > len(data):
+            break
+        v = RECORD.unpack_from(data, offset)
+        records.append({
+            "time_ms": v[0],
+            "monitor": v[1],
+            "hdr": bool(v[2] & RECORD_HDR),
+            "peak_nits": v[4],
+            "avg_nits": v[5],
+            "min_nonzero_nits": v[6],
+            "detected_peak_nits": v[7],
+            "frame_avg_ms": v[8],
+            "frame_max_ms": v[9],
+            "fps": v[10],
+            "shares": [s / SHARE_SCALE for s in v[11:17]],
+            "histogram": [s / SHARE_SCALE for s in v[17:22]],
+        })
+    return records
+
+def parse_duration(text):
+    """'90s', '30m', '2h', '1d' -> milliseconds."""
+    units = {"s": 1000, "m": 60000, "h": 3600000, "d": 86400000}
+    if text and text[-1] in units:
+        return int(float(text[:-1]) * units[text[-1]])
+    return int(float(text) * 1000)
+
+def parse_time(text):
+    """ISO local time -> UTC epoch milliseconds."""
+    return int(datetime.datetime.fromisoformat(text).timestamp() * 1000)
+
+def percentile(sorted_values, p):
+    """Nearest-rank percentile of an ascending list."""
+    if not sorted_values:
+        return 0.0
+    rank = max(1, int(math.ceil(p / 100.0 * len(sorted_values) - 1e-9)))
+    return sorted_values[min(rank, len(sorted_values)) - 1]
+
+def format_time(ms):
+    return datetime.datetime.fromtimestamp(ms / 1000.0).strftime("%Y-%m-%d %H:%M:%S")
+
+def summarize(records):
+    peaks = sorted(r["peak_nits"] for r in records)
+    avgs = sorted(r["avg_nits"] for r in records)
+    frame_ms = sorted(r["frame_avg_ms"] for r in records if r["frame_avg_ms"] > 0)
+    count = len(records)
+
+    print(f"Records:   {count}  ({format_time(records[0]['time_ms'])} .. {format_time(records[-1]['time_ms'])})")
+    hdr = sum(1 for r in records if r["hdr"])
+    print(f"HDR:       {hdr * 100.0 / count:.1f}% of samples")
+    print(f"MaxCLL:    {peaks[-1]:.0f} nits   MaxFALL: {avgs[-1]:.1f} nits")
+    print("Percentiles         p50       p90       p99     p99.9")
+    print("  peak nits   " + "".join(f"{percentile(peaks, p):10.1f}" for p in (50, 90, 99, 99.9)))
+    print("  avg nits    " + "".join(f"{percentile(avgs, p):10.1f}" for p in (50, 90, 99, 99.9)))
+    if frame_ms:
+        print("  frame ms    " + "".join(f"{percentile(frame_ms, p):10.2f}" for p in (50, 90, 99, 99.9)))
+
+    print("Gamut usage (mean share of pixels)")
+    for i, name in enumerate(SHARE_NAMES):
+        mean = sum(r["shares"][i] for r in records) / count
+        print(f"  {name:<14} {mean * 100.0:6.2f}%")
+    print("Luminance histogram (mean share of pixels)")
+    for i, name in enumerate(HISTOGRAM_NAMES):
+        mean = sum(r["histogram"][i] for r in records) / count
+        print(f"  {name:<14} {mean * 100.0:6.2f}%")
+
+def write_csv(records):
+    print("time,monitor,hdr,peak_nits,avg_nits,min_nonzero_nits,detected_peak_nits,frame_avg_ms,frame_max_ms,fps,"
+          + ",".join(n.lower().replace(" ", "_").replace(".", "") for n in SHARE_NAMES))
+    for r in records:
+        print(f"{format_time(r['time_ms'])},{r['monitor']},{int(r['hdr'])},{r['peak_nits']:.1f},{r['avg_nits']:.2f},"
+              f"{r['min_nonzero_nits']:.3f},{r['detected_peak_nits']:.1f},{r['frame_avg_ms']:.2f},"
+              f"{r['frame_max_ms']:.2f},{r['fps']:.1f}," + ",".join(f"{s:.4f}" for s in r["shares"]))
+
+def main():
+    parser = argparse.ArgumentParser(description="Summarize a DesktopLUT analysis recording")
+    parser.add_argument('file', help='Ring file (DesktopLUT-analysis.ring next to DesktopLUT.exe)')
+    parser.add_argument('--from', dest='start', metavar='TIME', help='Start time (ISO, local)')
+    parser.add_argument('--to', dest='end', metavar='TIME', help='End time (ISO, local)')
+    parser.add_argument('--last', metavar='DURATION', help='Only the last DURATION (e.g. 90s, 30m, 2h)')
+    parser.add_argument('--monitor', type=int, help='Only this monitor index')
+    parser.add_argument('--csv', action='store_true', help='Dump matching records as CSV instead')
+    args = parser.parse_args()
+
+    try:
+        records = read_records(args.file)
+    except (OSError, ValueError) as e:
+        print(f"Error: {e}", file=sys.stderr)
+        sys.exit(2)
+
+    if args.monitor is not None:
+        records = [r for r in records if r["monitor"] == args.monitor]
+    if args.last and records:
+        cutoff = records[-1]["time_ms"] - parse_duration(args.last)
+        records = [r for r in records if r["time_ms"] >= cutoff]
+    if args.start:
+        start = parse_time(args.start)
+        records = [r for r in records if r["time_ms"] >= start]
+    if args.end:
+        end = parse_time(args.end)
+        records = [r for r in records if r["time_ms"] < end]
+
+    if not records:
+        print("No records in range", file=sys.stderr)
+        sys.exit(1)
+
+    if args.csv:
+        write_csv(records)
+    else:
+        summarize(records)
+
+if __name__ == "__main__":
+    main()